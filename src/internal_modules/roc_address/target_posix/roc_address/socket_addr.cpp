@@ -149,6 +149,24 @@ bool SocketAddr::get_host(char* buf, size_t bufsz) const {
     return true;
 }
 
+core::hashsum_t SocketAddr::hash() const {
+    switch (saddr_family_()) {
+    case AF_INET:
+        return core::hashsum_int((uint64_t(saddr_.addr4.sin_addr.s_addr) << 16)
+                                 | uint64_t(saddr_.addr4.sin_port));
+
+    case AF_INET6:
+        return core::hashsum_mem(saddr_.addr6.sin6_addr.s6_addr,
+                                 sizeof(saddr_.addr6.sin6_addr.s6_addr))
+            ^ core::hashsum_int((uint32_t)saddr_.addr6.sin6_port);
+
+    default:
+        break;
+    }
+
+    return 0;
+}
+
 bool SocketAddr::operator==(const SocketAddr& other) const {
     if (saddr_family_() != other.saddr_family_()) {
         return false;
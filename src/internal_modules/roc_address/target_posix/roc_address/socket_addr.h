@@ -16,6 +16,7 @@
 #include <sys/socket.h>
 
 #include "roc_address/addr_family.h"
+#include "roc_core/hashsum.h"
 #include "roc_core/stddefs.h"
 
 namespace roc {
@@ -66,6 +67,11 @@ public:
     //! Get maximum allowed sockaddr struct length.
     socklen_t max_slen() const;
 
+    //! Compute address hash.
+    //! @remarks
+    //!  Equal addresses (as defined by operator==) have equal hashes.
+    core::hashsum_t hash() const;
+
     //! Compare addresses.
     bool operator==(const SocketAddr& other) const;
 
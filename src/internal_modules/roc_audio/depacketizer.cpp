@@ -42,6 +42,7 @@ Depacketizer::Depacketizer(packet::IReader& reader,
     , missing_samples_(0)
     , packet_samples_(0)
     , rate_limiter_(LogInterval)
+    , n_dropped_packets_(0)
     , first_packet_(true)
     , beep_(beep) {
     roc_log(LogDebug, "depacketizer: initializing: n_channels=%lu",
@@ -59,6 +60,10 @@ packet::timestamp_t Depacketizer::timestamp() const {
     return timestamp_;
 }
 
+size_t Depacketizer::n_dropped_packets() const {
+    return n_dropped_packets_;
+}
+
 bool Depacketizer::read(Frame& frame) {
     read_frame_(frame);
 
@@ -194,6 +199,7 @@ void Depacketizer::update_packet_(FrameInfo& info) {
                 n_dropped);
 
         info.n_dropped_packets += n_dropped;
+        n_dropped_packets_ += n_dropped;
     }
 
     if (!packet_) {
@@ -52,6 +52,9 @@ public:
     //!  started() should return true
     packet::timestamp_t timestamp() const;
 
+    //! Get number of late packets dropped so far.
+    size_t n_dropped_packets() const;
+
 private:
     struct FrameInfo {
         // Number of samples decoded from packets into the frame.
@@ -95,6 +98,8 @@ private:
 
     core::RateLimiter rate_limiter_;
 
+    size_t n_dropped_packets_;
+
     bool first_packet_;
     bool beep_;
 };
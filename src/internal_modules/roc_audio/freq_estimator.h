@@ -56,12 +56,18 @@ public:
     //! Compute new value of frequency coefficient.
     void update(packet::timestamp_t current_latency);
 
+    //! Change target latency.
+    //! @remarks
+    //!  Large changes cause large jumps of frequency coefficient; to move
+    //!  smoothly to a new target, it should be changed by small steps.
+    void set_target_latency(packet::timestamp_t target_latency);
+
 private:
     bool run_decimators_(packet::timestamp_t current, float& filtered);
     float run_controller_(float current);
 
     const FreqEstimatorConfig config_;
-    const float target_; // Target latency.
+    float target_; // Target latency.
 
     float dec1_casc_buff_[fe_decim_len];
     size_t dec1_ind_;
@@ -19,6 +19,37 @@
 namespace roc {
 namespace audio {
 
+//! Resampling period.
+//! @remarks
+//!  Describes how a resampler with fixed scaling can be restarted in the
+//!  middle of a stream and still produce the same output as if it was
+//!  running from the beginning. All values are in samples per channel.
+struct ResamplerPeriod {
+    //! Number of input samples after which resampler returns to the same phase.
+    //! Restarting resampler at multiple of this value keeps output samples aligned.
+    size_t in_period;
+
+    //! Number of output samples produced from in_period input samples.
+    size_t out_period;
+
+    //! Number of output samples that differ after restart.
+    //! The restarted resampler doesn't know preceding input samples, so its
+    //! first output samples should be discarded.
+    size_t warmup;
+
+    //! Number of input samples by which output lags behind input.
+    //! Output samples are popped only after this number of input samples
+    //! following them is pushed.
+    size_t lookahead;
+
+    ResamplerPeriod()
+        : in_period(0)
+        , out_period(0)
+        , warmup(0)
+        , lookahead(0) {
+    }
+};
+
 //! Audio writer interface.
 class IResampler {
 public:
@@ -49,6 +80,12 @@ public:
     //!  the input ring buffer. In this case the caller should provide resampler
     //!  with more input samples using begin_push_input() and end_push_input().
     virtual size_t pop_output(Frame& out) = 0;
+
+    //! Get resampling period for current scaling.
+    //! @remarks
+    //!  Returns false if resampling can't be restarted without changing
+    //!  the output, or if the period is larger than @p max_in_period.
+    virtual bool get_period(size_t max_in_period, ResamplerPeriod& period) const = 0;
 };
 
 } // namespace audio
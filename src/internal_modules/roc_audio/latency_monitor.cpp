@@ -9,6 +9,7 @@
 #include "roc_audio/latency_monitor.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
 
 namespace roc {
 namespace audio {
@@ -17,11 +18,29 @@ namespace {
 
 const core::nanoseconds_t LogInterval = 5 * core::Second;
 
+// Adaptive target latency starts decreasing only when desired latency is
+// lower than current target by this fraction of current target, to avoid
+// oscillation around the boundary. Once started, it decreases down to
+// desired latency.
+const double AdaptiveHysteresis = 0.05;
+
+// Latency at which playback starts. Start latency below minimum latency would
+// shut down the session immediately, so it is raised to minimum latency.
+core::nanoseconds_t initial_latency(const LatencyMonitorConfig& config,
+                                    core::nanoseconds_t target_latency) {
+    if (config.start_latency <= 0) {
+        return target_latency;
+    }
+    return std::max(config.start_latency, config.min_latency);
+}
+
 } // namespace
 
 LatencyMonitor::LatencyMonitor(const packet::SortedQueue& queue,
                                const Depacketizer& depacketizer,
                                ResamplerReader* resampler,
+                               const packet::JitterMeter* jitter_meter,
+                               const packet::QueueingDelayMeter* delay_meter,
                                const LatencyMonitorConfig& config,
                                core::nanoseconds_t target_latency,
                                const audio::SampleSpec& input_sample_spec,
@@ -30,20 +49,41 @@ LatencyMonitor::LatencyMonitor(const packet::SortedQueue& queue,
     : queue_(queue)
     , depacketizer_(depacketizer)
     , resampler_(resampler)
+    , jitter_meter_(jitter_meter)
+    , delay_meter_(delay_meter)
     , fe_(fe_config,
-          (packet::timestamp_t)input_sample_spec.ns_2_rtp_timestamp(target_latency))
+          (packet::timestamp_t)input_sample_spec.ns_2_rtp_timestamp(
+              initial_latency(config, target_latency)))
     , rate_limiter_(LogInterval)
     , update_interval_((packet::timestamp_t)input_sample_spec.ns_2_rtp_timestamp(
           config.fe_update_interval))
     , update_pos_(0)
     , has_update_pos_(false)
-    , target_latency_(
-          (packet::timestamp_t)input_sample_spec.ns_2_rtp_timestamp(target_latency))
+    , latency_(0)
+    , scaling_(1.0f)
+    , target_latency_((packet::timestamp_t)input_sample_spec.ns_2_rtp_timestamp(
+          initial_latency(config, target_latency)))
     , min_latency_(input_sample_spec.ns_2_rtp_timestamp(config.min_latency))
     , max_latency_(input_sample_spec.ns_2_rtp_timestamp(config.max_latency))
     , max_scaling_delta_(config.max_scaling_delta)
+    , curr_target_(0)
+    , final_target_(
+          (packet::timestamp_t)input_sample_spec.ns_2_rtp_timestamp(target_latency))
+    , ramp_step_(0)
+    , ramping_(false)
+    , adaptive_latency_(config.adaptive_latency)
+    , min_target_latency_(
+          (packet::timestamp_t)input_sample_spec.ns_2_rtp_timestamp(
+              config.min_target_latency))
+    , max_target_latency_(
+          (packet::timestamp_t)input_sample_spec.ns_2_rtp_timestamp(
+              config.max_target_latency))
+    , jitter_factor_(config.jitter_factor)
+    , decreasing_(false)
     , input_sample_spec_(input_sample_spec)
     , output_sample_spec_(output_sample_spec)
+    , init_ts_(core::timestamp(core::ClockMonotonic))
+    , first_audio_ts_(0)
     , valid_(false) {
     roc_log(LogDebug,
             "latency monitor: initializing:"
@@ -70,6 +110,97 @@ LatencyMonitor::LatencyMonitor(const packet::SortedQueue& queue,
         return;
     }
 
+    if (adaptive_latency_) {
+        if (!resampler_) {
+            roc_log(LogError,
+                    "latency monitor: adaptive latency requires resampling to be"
+                    " enabled");
+            return;
+        }
+
+        if (config.min_target_latency <= 0
+            || config.min_target_latency > config.max_target_latency
+            || jitter_factor_ <= 0) {
+            roc_log(LogError,
+                    "latency monitor: invalid config:"
+                    " min_target_latency=%ldns max_target_latency=%ldns"
+                    " jitter_factor=%.3f",
+                    (long)config.min_target_latency, (long)config.max_target_latency,
+                    (double)jitter_factor_);
+            return;
+        }
+
+        if ((packet::timestamp_diff_t)min_target_latency_ < min_latency_
+            || (packet::timestamp_diff_t)max_target_latency_ > max_latency_) {
+            roc_log(LogDebug,
+                    "latency monitor: clamping adaptive latency range to allowed"
+                    " latency range");
+
+            if ((packet::timestamp_diff_t)min_target_latency_ < min_latency_) {
+                min_target_latency_ = (packet::timestamp_t)min_latency_;
+            }
+            if ((packet::timestamp_diff_t)max_target_latency_ > max_latency_) {
+                max_target_latency_ = (packet::timestamp_t)max_latency_;
+            }
+        }
+
+        roc_log(LogDebug,
+                "latency monitor: adaptive latency enabled:"
+                " min_target=%.3fms max_target=%.3fms jitter_factor=%.3f",
+                (double)input_sample_spec_.rtp_timestamp_2_ns(
+                    (packet::timestamp_diff_t)min_target_latency_)
+                    / core::Millisecond,
+                (double)input_sample_spec_.rtp_timestamp_2_ns(
+                    (packet::timestamp_diff_t)max_target_latency_)
+                    / core::Millisecond,
+                (double)jitter_factor_);
+    }
+
+    if (config.start_latency != 0) {
+        if (!resampler_) {
+            roc_log(LogError,
+                    "latency monitor: fast start requires resampling to be enabled");
+            return;
+        }
+
+        if (config.start_latency < 0 || config.start_latency > target_latency
+            || config.start_ramp < 0) {
+            roc_log(LogError,
+                    "latency monitor: invalid config:"
+                    " start_latency=%ldns start_ramp=%ldns target_latency=%ldns",
+                    (long)config.start_latency, (long)config.start_ramp,
+                    (long)target_latency);
+            return;
+        }
+
+        if (config.start_latency < config.min_latency) {
+            roc_log(LogDebug,
+                    "latency monitor: clamping start latency to min latency:"
+                    " start_latency=%ldns min_latency=%ldns",
+                    (long)config.start_latency, (long)config.min_latency);
+        }
+
+        const double ramp_len =
+            (double)input_sample_spec.ns_2_rtp_timestamp(config.start_ramp);
+        const double max_step = (double)update_interval_ * (double)max_scaling_delta_;
+
+        ramp_step_ = max_step;
+        if (ramp_len > 0) {
+            ramp_step_ = std::min(max_step,
+                                  (double)(final_target_ - target_latency_)
+                                      * (double)update_interval_ / ramp_len);
+        }
+        ramping_ = target_latency_ < final_target_;
+
+        roc_log(LogDebug,
+                "latency monitor: fast start enabled:"
+                " start_latency=%.3fms ramp_step=%.3f",
+                (double)initial_latency(config, target_latency) / core::Millisecond,
+                ramp_step_);
+    }
+
+    curr_target_ = (double)target_latency_;
+
     if (resampler_) {
         if (!init_resampler_(input_sample_spec.sample_rate(),
                              output_sample_spec.sample_rate())) {
@@ -100,6 +231,12 @@ bool LatencyMonitor::update(packet::timestamp_t pos) {
         return true;
     }
 
+    if (first_audio_ts_ == 0) {
+        report_first_audio_();
+    }
+
+    latency_ = latency;
+
     if (!check_latency_(latency)) {
         return false;
     }
@@ -118,6 +255,40 @@ bool LatencyMonitor::update(packet::timestamp_t pos) {
     return true;
 }
 
+core::nanoseconds_t LatencyMonitor::latency() const {
+    return input_sample_spec_.rtp_timestamp_2_ns(latency_);
+}
+
+float LatencyMonitor::scaling() const {
+    return scaling_;
+}
+
+core::nanoseconds_t LatencyMonitor::jitter() const {
+    if (!jitter_meter_) {
+        return 0;
+    }
+    return jitter_meter_->jitter();
+}
+
+core::nanoseconds_t LatencyMonitor::queueing_delay() const {
+    if (!delay_meter_) {
+        return 0;
+    }
+    return delay_meter_->queueing_delay();
+}
+
+core::nanoseconds_t LatencyMonitor::target_latency() const {
+    return input_sample_spec_.rtp_timestamp_2_ns(
+        (packet::timestamp_diff_t)target_latency_);
+}
+
+core::nanoseconds_t LatencyMonitor::time_to_first_audio() const {
+    if (first_audio_ts_ == 0) {
+        return 0;
+    }
+    return first_audio_ts_ - init_ts_;
+}
+
 bool LatencyMonitor::get_latency_(packet::timestamp_diff_t& latency) const {
     if (!depacketizer_.started()) {
         return false;
@@ -205,6 +376,11 @@ bool LatencyMonitor::update_resampler_(packet::timestamp_t pos,
     }
 
     while (pos >= update_pos_) {
+        if (ramping_) {
+            ramp_target_latency_();
+        } else if (adaptive_latency_) {
+            adapt_target_latency_();
+        }
         fe_.update(latency);
         update_pos_ += update_interval_;
     }
@@ -215,7 +391,8 @@ bool LatencyMonitor::update_resampler_(packet::timestamp_t pos,
     if (rate_limiter_.allow()) {
         roc_log(LogDebug,
                 "latency monitor:"
-                " latency=%lu(%.3fms) target=%lu(%.3fms) fe=%.5f trim_fe=%.5f",
+                " latency=%lu(%.3fms) target=%lu(%.3fms) fe=%.5f trim_fe=%.5f"
+                " jitter=%.3fms qdelay=%.3fms",
                 (unsigned long)latency,
                 (double)input_sample_spec_.rtp_timestamp_2_ns(
                     (packet::timestamp_diff_t)latency)
@@ -224,9 +401,13 @@ bool LatencyMonitor::update_resampler_(packet::timestamp_t pos,
                 (double)input_sample_spec_.rtp_timestamp_2_ns(
                     (packet::timestamp_diff_t)target_latency_)
                     / core::Millisecond,
-                (double)freq_coeff, (double)trimmed_coeff);
+                (double)freq_coeff, (double)trimmed_coeff,
+                (double)jitter() / core::Millisecond,
+                (double)queueing_delay() / core::Millisecond);
     }
 
+    scaling_ = trimmed_coeff;
+
     if (!resampler_->set_scaling(trimmed_coeff)) {
         roc_log(LogDebug,
                 "latency monitor: scaling factor out of bounds: fe=%.5f trim_fe=%.5f",
@@ -237,16 +418,103 @@ bool LatencyMonitor::update_resampler_(packet::timestamp_t pos,
     return true;
 }
 
+// Increases target latency after fast start, from start latency up to
+// session target latency, by a constant step per update. The step is never
+// larger than the resampler is able to compensate.
+void LatencyMonitor::ramp_target_latency_() {
+    double target = curr_target_ + ramp_step_;
+
+    if (target >= (double)final_target_) {
+        target = (double)final_target_;
+        ramping_ = false;
+
+        roc_log(LogDebug, "latency monitor: fast start ramp finished: target=%.3fms",
+                (double)input_sample_spec_.rtp_timestamp_2_ns(
+                    (packet::timestamp_diff_t)final_target_)
+                    / core::Millisecond);
+    }
+
+    set_target_latency_(target);
+}
+
+// Moves target latency towards the value derived from the measured jitter
+// and loss bursts. The target is changed by at most update_interval_ scaled by
+// max_scaling_delta_ per update, i.e. not faster than the resampler is able
+// to compensate, so that the change is inaudible.
+void LatencyMonitor::adapt_target_latency_() {
+    if (!jitter_meter_) {
+        return;
+    }
+
+    const core::nanoseconds_t desired_ns =
+        (core::nanoseconds_t)(jitter_meter_->jitter() * (double)jitter_factor_)
+        + jitter_meter_->loss_burst();
+
+    double desired = (double)input_sample_spec_.ns_2_rtp_timestamp(desired_ns);
+
+    if (desired < (double)min_target_latency_) {
+        desired = (double)min_target_latency_;
+    }
+    if (desired > (double)max_target_latency_) {
+        desired = (double)max_target_latency_;
+    }
+
+    const double max_step = (double)update_interval_ * (double)max_scaling_delta_;
+
+    if (desired > curr_target_) {
+        decreasing_ = false;
+        set_target_latency_(curr_target_ + std::min(desired - curr_target_, max_step));
+        return;
+    }
+
+    if (!decreasing_ && desired < curr_target_ * (1.0 - AdaptiveHysteresis)) {
+        decreasing_ = true;
+    }
+
+    if (decreasing_) {
+        set_target_latency_(curr_target_ - std::min(curr_target_ - desired, max_step));
+
+        if (curr_target_ <= desired) {
+            decreasing_ = false;
+        }
+    }
+}
+
+void LatencyMonitor::set_target_latency_(double target) {
+    curr_target_ = target;
+
+    const packet::timestamp_t new_target = (packet::timestamp_t)curr_target_;
+
+    if (new_target != target_latency_) {
+        target_latency_ = new_target;
+        fe_.set_target_latency(target_latency_);
+    }
+}
+
+void LatencyMonitor::report_first_audio_() {
+    first_audio_ts_ = core::timestamp(core::ClockMonotonic);
+    if (first_audio_ts_ == 0) {
+        first_audio_ts_ = 1;
+    }
+
+    roc_log(LogInfo, "latency monitor: playback started: time_to_first_audio=%.3fms",
+            (double)(first_audio_ts_ - init_ts_) / core::Millisecond);
+}
+
 void LatencyMonitor::report_latency_(packet::timestamp_diff_t latency) {
     if (rate_limiter_.allow()) {
-        roc_log(LogDebug, "latency monitor: latency=%ld(%.3fms) target=%lu(%.3fms)",
+        roc_log(LogDebug,
+                "latency monitor: latency=%ld(%.3fms) target=%lu(%.3fms)"
+                " jitter=%.3fms qdelay=%.3fms",
                 (long)latency,
                 (double)input_sample_spec_.rtp_timestamp_2_ns(latency)
                     / core::Millisecond,
                 (unsigned long)target_latency_,
                 (double)input_sample_spec_.rtp_timestamp_2_ns(
                     (packet::timestamp_diff_t)target_latency_)
-                    / core::Millisecond);
+                    / core::Millisecond,
+                (double)jitter() / core::Millisecond,
+                (double)queueing_delay() / core::Millisecond);
     }
 }
 
@@ -19,6 +19,8 @@
 #include "roc_core/noncopyable.h"
 #include "roc_core/rate_limiter.h"
 #include "roc_core/time.h"
+#include "roc_packet/jitter_meter.h"
+#include "roc_packet/queueing_delay_meter.h"
 #include "roc_packet/sorted_queue.h"
 #include "roc_packet/units.h"
 
@@ -44,11 +46,48 @@ struct LatencyMonitorConfig {
     //! For example, 0.01 allows freq_coeff values in range [0.99; 1.01].
     float max_scaling_delta;
 
+    //! Enable adaptive target latency.
+    //! If enabled, target latency is continuously adjusted to the measured
+    //! network jitter and loss bursts, within the range defined by
+    //! min_target_latency and max_target_latency.
+    //! Requires resampler.
+    bool adaptive_latency;
+
+    //! Minimum target latency for adaptive mode, nanoseconds.
+    core::nanoseconds_t min_target_latency;
+
+    //! Maximum target latency for adaptive mode, nanoseconds.
+    core::nanoseconds_t max_target_latency;
+
+    //! Jitter multiplier for adaptive mode.
+    //! Desired target latency is computed as jitter multiplied by this factor
+    //! plus recent loss burst duration.
+    float jitter_factor;
+
+    //! Initial target latency for fast start, nanoseconds.
+    //! If non-zero, playback starts when this amount of audio is buffered,
+    //! and then target latency is gradually increased up to the session
+    //! target latency during start_ramp. Should be lower than the session
+    //! target latency. If lower than min_latency, min_latency is used
+    //! instead. Requires resampler.
+    core::nanoseconds_t start_latency;
+
+    //! Duration of fast start ramp, nanoseconds.
+    //! Target latency is never increased faster than max_scaling_delta
+    //! allows, so the actual ramp may be longer.
+    core::nanoseconds_t start_ramp;
+
     LatencyMonitorConfig()
         : fe_update_interval(5 * core::Millisecond)
         , min_latency(0)
         , max_latency(0)
-        , max_scaling_delta(0.005f) {
+        , max_scaling_delta(0.005f)
+        , adaptive_latency(false)
+        , min_target_latency(20 * core::Millisecond)
+        , max_target_latency(200 * core::Millisecond)
+        , jitter_factor(4.0f)
+        , start_latency(0)
+        , start_ramp(5 * core::Second) {
     }
 };
 
@@ -58,6 +97,10 @@ struct LatencyMonitorConfig {
 //!  - trims scaling factor to the allowed range
 //!  - updates resampler scaling
 //!  - shutdowns session if the latency goes out of bounds
+//!  - reports measured network jitter and queueing delay
+//!  - adjusts target latency to network conditions, if enabled
+//!  - ramps target latency up after fast start, if enabled
+//!  - measures time to first audio
 class LatencyMonitor : public core::NonCopyable<> {
 public:
     //! Constructor.
@@ -65,13 +108,17 @@ public:
     //! @b Parameters
     //!  - @p queue and @p depacketizer are used to calculate the latency
     //!  - @p resampler is used to set the scaling factor, may be null
+    //!  - @p jitter_meter and @p delay_meter are used to report network jitter
+    //!    and queueing delay, may be null
     //!  - @p config defines various miscellaneous parameters
-    //!  - @p target_latency defines FreqEstimator target latency, in samples
+    //!  - @p target_latency defines FreqEstimator target latency
     //!  - @p input_sample_spec is the sample spec of the input packets
     //!  - @p output_sample_spec is the sample spec of the output frames
     LatencyMonitor(const packet::SortedQueue& queue,
                    const Depacketizer& depacketizer,
                    ResamplerReader* resampler,
+                   const packet::JitterMeter* jitter_meter,
+                   const packet::QueueingDelayMeter* delay_meter,
                    const LatencyMonitorConfig& config,
                    core::nanoseconds_t target_latency,
                    const audio::SampleSpec& input_sample_spec,
@@ -86,6 +133,37 @@ public:
     //!  false if the session should be terminated.
     bool update(packet::timestamp_t time);
 
+    //! Get last measured latency, nanoseconds.
+    //! @remarks
+    //!  Returns zero if latency is not measured yet.
+    core::nanoseconds_t latency() const;
+
+    //! Get current resampler scaling factor.
+    //! @remarks
+    //!  Returns 1 if resampler is not used.
+    float scaling() const;
+
+    //! Get measured interarrival jitter, nanoseconds.
+    //! @remarks
+    //!  Returns zero if jitter is not measured.
+    core::nanoseconds_t jitter() const;
+
+    //! Get measured queueing delay, nanoseconds.
+    //! @remarks
+    //!  Returns zero if queueing delay is not measured.
+    core::nanoseconds_t queueing_delay() const;
+
+    //! Get current target latency, nanoseconds.
+    //! @remarks
+    //!  Constant unless fast start or adaptive latency is enabled.
+    core::nanoseconds_t target_latency() const;
+
+    //! Get time to first audio, nanoseconds.
+    //! @remarks
+    //!  Time passed since monitor creation until the session started
+    //!  producing audio. Returns zero if the playback is not started yet.
+    core::nanoseconds_t time_to_first_audio() const;
+
 private:
     bool get_latency_(packet::timestamp_diff_t& latency) const;
     bool check_latency_(packet::timestamp_diff_t latency) const;
@@ -94,12 +172,19 @@ private:
 
     bool init_resampler_(size_t input_sample_rate, size_t output_sample_rate);
     bool update_resampler_(packet::timestamp_t time, packet::timestamp_t latency);
+    void ramp_target_latency_();
+    void adapt_target_latency_();
+    void set_target_latency_(double target);
+
+    void report_first_audio_();
 
     void report_latency_(packet::timestamp_diff_t latency);
 
     const packet::SortedQueue& queue_;
     const Depacketizer& depacketizer_;
     ResamplerReader* resampler_;
+    const packet::JitterMeter* jitter_meter_;
+    const packet::QueueingDelayMeter* delay_meter_;
     FreqEstimator fe_;
 
     core::RateLimiter rate_limiter_;
@@ -108,15 +193,33 @@ private:
     packet::timestamp_t update_pos_;
     bool has_update_pos_;
 
-    const packet::timestamp_t target_latency_;
+    packet::timestamp_diff_t latency_;
+    float scaling_;
+
+    packet::timestamp_t target_latency_;
     const packet::timestamp_diff_t min_latency_;
     const packet::timestamp_diff_t max_latency_;
 
     const float max_scaling_delta_;
 
+    double curr_target_;
+
+    const packet::timestamp_t final_target_;
+    double ramp_step_;
+    bool ramping_;
+
+    const bool adaptive_latency_;
+    packet::timestamp_t min_target_latency_;
+    packet::timestamp_t max_target_latency_;
+    const float jitter_factor_;
+    bool decreasing_;
+
     const audio::SampleSpec input_sample_spec_;
     const audio::SampleSpec output_sample_spec_;
 
+    const core::nanoseconds_t init_ts_;
+    core::nanoseconds_t first_audio_ts_;
+
     bool valid_;
 };
 
@@ -30,8 +30,11 @@ sample_t clamp(const sample_t x) {
 
 Mixer::Mixer(core::BufferFactory<sample_t>& buffer_factory,
              core::nanoseconds_t frame_length,
-             const audio::SampleSpec& sample_spec)
-    : valid_(false) {
+             const audio::SampleSpec& sample_spec,
+             MixerWorkerPool* worker_pool)
+    : buffer_factory_(buffer_factory)
+    , worker_pool_(worker_pool)
+    , valid_(false) {
     size_t frame_size = sample_spec.ns_2_samples_overall(frame_length);
     roc_log(LogDebug, "mixer: initializing: frame_size=%lu", (unsigned long)frame_size);
 
@@ -107,6 +110,12 @@ void Mixer::read_(sample_t* data, size_t size, unsigned& flags) {
     roc_panic_if(!data);
     roc_panic_if(size == 0);
 
+    if (worker_pool_ && readers_.size() > 1) {
+        if (read_parallel_(data, size, flags)) {
+            return;
+        }
+    }
+
     memset(data, 0, size * sizeof(sample_t));
 
     for (IFrameReader* rp = readers_.front(); rp; rp = readers_.nextof(*rp)) {
@@ -125,5 +134,57 @@ void Mixer::read_(sample_t* data, size_t size, unsigned& flags) {
     }
 }
 
+bool Mixer::read_parallel_(sample_t* data, size_t size, unsigned& flags) {
+    const size_t n_tasks = readers_.size();
+
+    if (!worker_pool_->reserve(n_tasks)) {
+        roc_log(LogError, "mixer: can't allocate worker tasks, reading sequentially");
+        return false;
+    }
+
+    size_t n = 0;
+
+    for (IFrameReader* rp = readers_.front(); rp; rp = readers_.nextof(*rp), n++) {
+        MixerWorkerPool::Task& task = worker_pool_->task(n);
+
+        if (!task.buffer) {
+            task.buffer = buffer_factory_.new_buffer();
+            if (!task.buffer || task.buffer.capacity() < size) {
+                roc_log(LogError,
+                        "mixer: can't allocate task buffer, reading sequentially");
+                task.buffer = core::Slice<sample_t>();
+                return false;
+            }
+        }
+
+        task.reader = rp;
+        task.buffer.reslice(0, size);
+    }
+
+    worker_pool_->run(n_tasks);
+
+    memset(data, 0, size * sizeof(sample_t));
+
+    for (n = 0; n < n_tasks; n++) {
+        MixerWorkerPool::Task& task = worker_pool_->task(n);
+
+        task.reader = NULL;
+
+        if (!task.result) {
+            continue;
+        }
+
+        const sample_t* task_data = task.buffer.data();
+
+        for (size_t i = 0; i < size; i++) {
+            data[i] = clamp(data[i] + task_data[i]);
+        }
+
+        flags |= task.flags;
+    }
+
+    return true;
+}
+
 } // namespace audio
 } // namespace roc
@@ -13,6 +13,7 @@
 #define ROC_AUDIO_MIXER_H_
 
 #include "roc_audio/iframe_reader.h"
+#include "roc_audio/mixer_worker_pool.h"
 #include "roc_audio/sample.h"
 #include "roc_audio/sample_spec.h"
 #include "roc_core/buffer_factory.h"
@@ -38,6 +39,10 @@ namespace audio {
 //! @code
 //!  5, 7, 9, ...
 //! @endcode
+//!
+//! If a worker pool is provided, inputs are read in parallel, each into its own
+//! buffer, and then mixed in the order in which they were added. The output is
+//! the same as when inputs are read sequentially.
 class Mixer : public IFrameReader, public core::NonCopyable<> {
 public:
     //! Initialize.
@@ -47,9 +52,12 @@ public:
     //!  - @p frame_length defines the temporary buffer length used to
     //!    read from, in nanoseconds
     //!  - @p sample_spec defines the sample spec taken from the audio signal
+    //!  - @p worker_pool is used to read inputs in parallel; if NULL, inputs
+    //!    are read sequentially on the calling thread
     Mixer(core::BufferFactory<sample_t>& buffer_factory,
           core::nanoseconds_t frame_length,
-          const audio::SampleSpec& sample_spec);
+          const audio::SampleSpec& sample_spec,
+          MixerWorkerPool* worker_pool = NULL);
 
     //! Check if the mixer was succefully constructed.
     bool valid() const;
@@ -68,6 +76,10 @@ public:
 
 private:
     void read_(sample_t* out_data, size_t out_sz, unsigned& flags);
+    bool read_parallel_(sample_t* out_data, size_t out_sz, unsigned& flags);
+
+    core::BufferFactory<sample_t>& buffer_factory_;
+    MixerWorkerPool* worker_pool_;
 
     core::List<IFrameReader, core::NoOwnership> readers_;
     core::Slice<sample_t> temp_buf_;
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_audio/mixer_worker_pool.h"
+#include "roc_audio/frame.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace audio {
+
+MixerWorkerPool::Worker::Worker(MixerWorkerPool& pool)
+    : pool_(pool) {
+}
+
+void MixerWorkerPool::Worker::run() {
+    pool_.worker_loop_();
+}
+
+MixerWorkerPool::MixerWorkerPool(core::IAllocator& allocator, size_t num_workers)
+    : tasks_(allocator)
+    , work_cond_(mutex_)
+    , done_cond_(mutex_)
+    , n_tasks_(0)
+    , next_task_(0)
+    , n_pending_(0)
+    , stop_(false)
+    , n_workers_(0)
+    , valid_(false) {
+    roc_log(LogDebug, "mixer worker pool: initializing: num_workers=%lu",
+            (unsigned long)num_workers);
+
+    if (num_workers == 0 || num_workers > MaxWorkers) {
+        roc_log(LogError,
+                "mixer worker pool: invalid number of workers:"
+                " num_workers=%lu max_workers=%lu",
+                (unsigned long)num_workers, (unsigned long)MaxWorkers);
+        return;
+    }
+
+    for (; n_workers_ < num_workers; n_workers_++) {
+        workers_[n_workers_].reset(new (workers_[n_workers_]) Worker(*this));
+
+        if (!workers_[n_workers_]->start()) {
+            roc_log(LogError, "mixer worker pool: can't start worker thread");
+            workers_[n_workers_].reset();
+            return;
+        }
+    }
+
+    valid_ = true;
+}
+
+MixerWorkerPool::~MixerWorkerPool() {
+    {
+        core::Mutex::Lock lock(mutex_);
+
+        roc_panic_if_msg(n_pending_ != 0,
+                         "mixer worker pool: attempt to destroy pool while running");
+
+        stop_ = true;
+        work_cond_.broadcast();
+    }
+
+    for (size_t n = 0; n < n_workers_; n++) {
+        workers_[n]->join();
+        workers_[n].reset();
+    }
+}
+
+bool MixerWorkerPool::valid() const {
+    return valid_;
+}
+
+size_t MixerWorkerPool::num_workers() const {
+    return n_workers_;
+}
+
+bool MixerWorkerPool::reserve(size_t n_tasks) {
+    roc_panic_if(!valid_);
+
+    if (tasks_.size() >= n_tasks) {
+        return true;
+    }
+
+    return tasks_.resize(n_tasks);
+}
+
+MixerWorkerPool::Task& MixerWorkerPool::task(size_t index) {
+    roc_panic_if(!valid_);
+
+    return tasks_[index];
+}
+
+void MixerWorkerPool::run(size_t n_tasks) {
+    roc_panic_if(!valid_);
+
+    roc_panic_if_msg(n_tasks > tasks_.size(),
+                     "mixer worker pool: attempt to run more tasks than reserved:"
+                     " n_tasks=%lu n_reserved=%lu",
+                     (unsigned long)n_tasks, (unsigned long)tasks_.size());
+
+    if (n_tasks == 0) {
+        return;
+    }
+
+    mutex_.lock();
+
+    n_tasks_ = n_tasks;
+    next_task_ = 0;
+    n_pending_ = n_tasks;
+
+    work_cond_.broadcast();
+
+    // Calling thread processes tasks too, instead of just waiting for workers.
+    while (next_task_ < n_tasks_) {
+        Task& task = tasks_[next_task_++];
+
+        mutex_.unlock();
+        process_task_(task);
+        mutex_.lock();
+
+        n_pending_--;
+    }
+
+    while (n_pending_ != 0) {
+        done_cond_.wait();
+    }
+
+    n_tasks_ = 0;
+    next_task_ = 0;
+
+    mutex_.unlock();
+}
+
+void MixerWorkerPool::worker_loop_() {
+    mutex_.lock();
+
+    for (;;) {
+        while (!stop_ && next_task_ >= n_tasks_) {
+            work_cond_.wait();
+        }
+
+        if (stop_) {
+            break;
+        }
+
+        Task& task = tasks_[next_task_++];
+
+        mutex_.unlock();
+        process_task_(task);
+        mutex_.lock();
+
+        if (--n_pending_ == 0) {
+            done_cond_.signal();
+        }
+    }
+
+    mutex_.unlock();
+}
+
+void MixerWorkerPool::process_task_(Task& task) {
+    roc_panic_if(!task.reader);
+
+    Frame frame(task.buffer.data(), task.buffer.size());
+
+    task.result = task.reader->read(frame);
+    task.flags = frame.flags();
+}
+
+} // namespace audio
+} // namespace roc
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_audio/mixer_worker_pool.h
+//! @brief Mixer worker pool.
+
+#ifndef ROC_AUDIO_MIXER_WORKER_POOL_H_
+#define ROC_AUDIO_MIXER_WORKER_POOL_H_
+
+#include "roc_audio/iframe_reader.h"
+#include "roc_audio/sample.h"
+#include "roc_core/array.h"
+#include "roc_core/cond.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/optional.h"
+#include "roc_core/slice.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/thread.h"
+
+namespace roc {
+namespace audio {
+
+//! Mixer worker pool.
+//!
+//! Reads frames from multiple mixer inputs in parallel. Used by Mixer to
+//! distribute reading of receiver sessions among several CPU cores.
+//!
+//! run() is synchronous: it hands tasks to worker threads, processes tasks
+//! on the calling thread as well, and returns when all tasks are completed.
+//! Hence, frame processing still happens within the caller's read() call
+//! and its timing is not affected by the pool.
+class MixerWorkerPool : public core::NonCopyable<> {
+public:
+    //! Read task.
+    struct Task {
+        //! Reader to read from.
+        IFrameReader* reader;
+
+        //! Buffer to read samples into.
+        //! @remarks
+        //!  Kept between runs to avoid buffer allocation on every frame.
+        core::Slice<sample_t> buffer;
+
+        //! Flags of the read frame.
+        unsigned flags;
+
+        //! Result of reader's read().
+        bool result;
+
+        Task()
+            : reader(NULL)
+            , flags(0)
+            , result(false) {
+        }
+    };
+
+    //! Maximum number of worker threads.
+    enum { MaxWorkers = 32 };
+
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p allocator is used to allocate tasks array
+    //!  - @p num_workers defines number of worker threads; the calling thread
+    //!    is used in addition to them
+    MixerWorkerPool(core::IAllocator& allocator, size_t num_workers);
+
+    //! Stop and join worker threads.
+    ~MixerWorkerPool();
+
+    //! Check if the pool was succefully constructed.
+    bool valid() const;
+
+    //! Get number of worker threads.
+    size_t num_workers() const;
+
+    //! Ensure that at least @p n_tasks tasks are available.
+    //! @returns
+    //!  false if allocation failed.
+    bool reserve(size_t n_tasks);
+
+    //! Get task by index.
+    //! @pre
+    //!  @p index should be less than the value passed to reserve().
+    Task& task(size_t index);
+
+    //! Run first @p n_tasks tasks and wait until they are completed.
+    void run(size_t n_tasks);
+
+private:
+    class Worker : public core::Thread {
+    public:
+        Worker(MixerWorkerPool& pool);
+
+    private:
+        virtual void run();
+
+        MixerWorkerPool& pool_;
+    };
+
+    void worker_loop_();
+    static void process_task_(Task& task);
+
+    core::Array<Task> tasks_;
+
+    core::Mutex mutex_;
+    core::Cond work_cond_;
+    core::Cond done_cond_;
+
+    size_t n_tasks_;
+    size_t next_task_;
+    size_t n_pending_;
+    bool stop_;
+
+    core::Optional<Worker> workers_[MaxWorkers];
+    size_t n_workers_;
+
+    bool valid_;
+};
+
+} // namespace audio
+} // namespace roc
+
+#endif // ROC_AUDIO_MIXER_WORKER_POOL_H_
@@ -70,6 +70,16 @@ inline size_t calc_bits(size_t n) {
     return c;
 }
 
+// Returns greatest common divisor.
+inline uint64_t calc_gcd(uint64_t a, uint64_t b) {
+    while (b != 0) {
+        const uint64_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
 inline size_t get_window_size(ResamplerProfile profile) {
     switch (profile) {
     case ResamplerProfile_Low:
@@ -278,6 +288,40 @@ size_t BuiltinResampler::pop_output(Frame& out) {
     return out_pos;
 }
 
+bool BuiltinResampler::get_period(size_t max_in_period, ResamplerPeriod& period) const {
+    // Output positions are rounded to integer when they're closer than epsilon,
+    // which makes phase dependent on the whole history.
+    if (qt_epsilon_ != 0) {
+        return false;
+    }
+
+    const uint64_t dt = float_to_fixedpoint(scaling_);
+    if (dt == 0 || frame_size_ch_ == 0) {
+        return false;
+    }
+
+    // Output sample positions are exact multiples of dt in fixed point, and input
+    // is pushed by frames. Both become aligned again after k frames, where k*F
+    // is the least common multiple of F and dt.
+    const uint64_t qt_frame = (uint64_t)frame_size_ch_ << FRACT_BIT_COUNT;
+    const uint64_t n_frames = dt / calc_gcd(qt_frame, dt);
+
+    if (n_frames > max_in_period / frame_size_ch_) {
+        return false;
+    }
+
+    period.in_period = (size_t)n_frames * frame_size_ch_;
+    period.out_period = (size_t)(n_frames * qt_frame / dt);
+    // Window never crosses neighbour frames, so restarted resampler produces
+    // the same samples from the very beginning.
+    period.warmup = 0;
+    // Sample is computed when the next frame is pushed, and popped before
+    // the frame after it.
+    period.lookahead = frame_size_ch_ * 2;
+
+    return true;
+}
+
 bool BuiltinResampler::alloc_frames_(core::BufferFactory<sample_t>& buffer_factory) {
     for (size_t n = 0; n < ROC_ARRAY_SIZE(frames_); n++) {
         frames_[n] = buffer_factory.new_buffer();
@@ -90,6 +90,19 @@ void ResamplerWriter::write(Frame& frame) {
     }
 }
 
+void ResamplerWriter::flush() {
+    roc_panic_if_not(valid());
+
+    if (output_pos_ == 0) {
+        return;
+    }
+
+    Frame out_frame(output_.data(), output_pos_);
+    writer_.write(out_frame);
+
+    output_pos_ = 0;
+}
+
 size_t ResamplerWriter::push_input_(Frame& frame, size_t frame_pos) {
     if (input_pos_ == 0) {
         input_ = resampler_.begin_push_input();
@@ -46,6 +46,13 @@ public:
     //! Read audio frame.
     virtual void write(Frame&);
 
+    //! Write pending output samples.
+    //! @remarks
+    //!  Output is normally written by frames of fixed size. When the stream
+    //!  ends, the last frame may be incomplete; this method writes it as a
+    //!  shorter frame.
+    void flush();
+
 private:
     size_t push_input_(Frame& frame, size_t frame_pos);
 
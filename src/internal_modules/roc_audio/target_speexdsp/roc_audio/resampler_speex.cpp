@@ -40,6 +40,15 @@ inline int get_quality(ResamplerProfile profile) {
     roc_panic("speex resampler: unexpected profile");
 }
 
+inline spx_uint32_t calc_gcd(spx_uint32_t a, spx_uint32_t b) {
+    while (b != 0) {
+        const spx_uint32_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
 } // namespace
 
 SpeexResampler::SpeexResampler(core::IAllocator&,
@@ -179,6 +188,46 @@ size_t SpeexResampler::pop_output(Frame& out) {
     return (size_t)out_frame_pos;
 }
 
+bool SpeexResampler::get_period(size_t max_in_period, ResamplerPeriod& period) const {
+    if (!speex_state_) {
+        return false;
+    }
+
+    // Ratio is kept by speex reduced to lowest terms.
+    spx_uint32_t ratio_num = 0;
+    spx_uint32_t ratio_den = 0;
+    speex_resampler_get_ratio(speex_state_, &ratio_num, &ratio_den);
+
+    if (ratio_num == 0 || ratio_den == 0) {
+        return false;
+    }
+
+    // Filter phase returns to zero after every ratio_num input samples, and
+    // input is consumed by frames, so the period is their least common multiple.
+    const size_t frame_size_ch = in_frame_size_ / num_ch_;
+    const size_t n_ratios = frame_size_ch / calc_gcd(ratio_num, (spx_uint32_t)frame_size_ch);
+
+    if (n_ratios > max_in_period / ratio_num) {
+        return false;
+    }
+
+    const int in_latency = speex_resampler_get_input_latency(speex_state_);
+    const int out_latency = speex_resampler_get_output_latency(speex_state_);
+
+    if (in_latency < 0 || out_latency < 0) {
+        return false;
+    }
+
+    period.in_period = n_ratios * ratio_num;
+    period.out_period = n_ratios * ratio_den;
+    // Filter memory is initially filled with zeros, so output samples remain
+    // affected until the whole filter length of input is processed.
+    period.warmup = (size_t)out_latency * 2 + 2;
+    period.lookahead = (size_t)in_latency * 2 + frame_size_ch;
+
+    return true;
+}
+
 void SpeexResampler::report_stats_() {
     if (!speex_state_) {
         return;
@@ -58,6 +58,9 @@ public:
     //! Read samples from input frame and fill output frame.
     virtual size_t pop_output(Frame& out);
 
+    //! Get resampling period for current scaling.
+    virtual bool get_period(size_t max_in_period, ResamplerPeriod& period) const;
+
 private:
     void report_stats_();
 
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_core/slab_allocator.h"
+#include "roc_core/align_ops.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace core {
+
+SlabAllocator::SlabAllocator(IAllocator& allocator, bool poison)
+    : allocator_(allocator)
+    , n_large_allocations_(0) {
+    for (size_t n = 0; n < NumClasses; n++) {
+        pools_[n].reset(new (pools_[n]) SlabPool(
+            allocator, (size_t(1) << (n + MinClassBits)), poison, 0, MaxSlabSize));
+    }
+}
+
+SlabAllocator::~SlabAllocator() {
+    if (n_large_allocations_ != 0) {
+        roc_panic("slab allocator: detected leak: n_large=%d", (int)n_large_allocations_);
+    }
+}
+
+size_t SlabAllocator::num_large_allocations() const {
+    return (size_t)n_large_allocations_;
+}
+
+void* SlabAllocator::allocate(size_t size) {
+    const size_t full_size = header_size_() + size;
+    const size_t size_class = size_class_(full_size);
+
+    void* memory;
+
+    if (size_class == LargeClass) {
+        memory = allocator_.allocate(full_size);
+        if (memory) {
+            n_large_allocations_++;
+        }
+    } else {
+        memory = pools_[size_class]->allocate();
+    }
+
+    if (!memory) {
+        return NULL;
+    }
+
+    *(size_t*)memory = size_class;
+
+    return (char*)memory + header_size_();
+}
+
+void SlabAllocator::deallocate(void* ptr) {
+    if (ptr == NULL) {
+        roc_panic("slab allocator: deallocating null pointer");
+    }
+
+    void* memory = (char*)ptr - header_size_();
+
+    const size_t size_class = *(size_t*)memory;
+
+    if (size_class == LargeClass) {
+        allocator_.deallocate(memory);
+        n_large_allocations_--;
+    } else {
+        roc_panic_if_msg(size_class >= NumClasses,
+                         "slab allocator: corrupted block header: size_class=%lu",
+                         (unsigned long)size_class);
+
+        pools_[size_class]->deallocate(memory);
+    }
+}
+
+size_t SlabAllocator::size_class_(size_t size) {
+    for (size_t n = 0; n < NumClasses; n++) {
+        if (size <= (size_t(1) << (n + MinClassBits))) {
+            return n;
+        }
+    }
+
+    return LargeClass;
+}
+
+size_t SlabAllocator::header_size_() {
+    return AlignOps::max_alignment();
+}
+
+} // namespace core
+} // namespace roc
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_core/slab_allocator.h
+//! @brief Slab allocator.
+
+#ifndef ROC_CORE_SLAB_ALLOCATOR_H_
+#define ROC_CORE_SLAB_ALLOCATOR_H_
+
+#include "roc_core/atomic.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/optional.h"
+#include "roc_core/slab_pool.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace core {
+
+//! Slab allocator.
+//!
+//! General-purpose allocator on top of a set of slab pools, one pool per
+//! power-of-two size class. Deallocated blocks are kept in the pools and
+//! reused by subsequent allocations of the same size class, so once a given
+//! set of objects was allocated and deallocated, allocating it again doesn't
+//! touch the underlying allocator.
+//!
+//! Blocks larger than the largest size class are allocated directly from
+//! the underlying allocator.
+//!
+//! Memory is returned to the underlying allocator only in destructor.
+//! The returned memory is always maximum aligned. Thread-safe.
+class SlabAllocator : public IAllocator, public NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p allocator is used to allocate slabs and large blocks
+    //!  - @p poison enables memory poisoning for debugging
+    SlabAllocator(IAllocator& allocator, bool poison);
+
+    //! Deinitialize.
+    //! @remarks
+    //!  All blocks should be deallocated before destroying allocator.
+    ~SlabAllocator();
+
+    //! Get number of blocks allocated directly from underlying allocator.
+    //! @remarks
+    //!  Includes only blocks which are larger than the largest size class.
+    size_t num_large_allocations() const;
+
+    //! Allocate memory.
+    virtual void* allocate(size_t size);
+
+    //! Deallocate previously allocated memory.
+    virtual void deallocate(void*);
+
+private:
+    enum {
+        // smallest size class is 2^MinClassBits bytes
+        MinClassBits = 4,
+
+        // largest size class is 2^MaxClassBits bytes
+        MaxClassBits = 20,
+
+        // number of size classes
+        NumClasses = MaxClassBits - MinClassBits + 1,
+
+        // class index for blocks allocated from underlying allocator
+        LargeClass = NumClasses,
+
+        // maximum slab size for a pool
+        MaxSlabSize = 64 * 1024
+    };
+
+    static size_t size_class_(size_t size);
+    static size_t header_size_();
+
+    IAllocator& allocator_;
+
+    Optional<SlabPool> pools_[NumClasses];
+
+    Atomic<int> n_large_allocations_;
+};
+
+} // namespace core
+} // namespace roc
+
+#endif // ROC_CORE_SLAB_ALLOCATOR_H_
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/block_interleaver.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace fec {
+
+BlockInterleaver::BlockInterleaver(const BlockInterleaverConfig& config,
+                                   packet::IWriter& writer,
+                                   core::IAllocator& allocator)
+    : writer_(writer)
+    , span_(config.span)
+    , packets_(allocator)
+    , stride_(0)
+    , group_sbn_(0)
+    , group_index_(0)
+    , started_(false)
+    , valid_(false) {
+    if (span_ == 0 || span_ > MaxSpan) {
+        roc_log(LogError, "fec block interleaver: invalid span: value=%lu min=1 max=%lu",
+                (unsigned long)span_, (unsigned long)MaxSpan);
+        return;
+    }
+
+    roc_log(LogDebug, "fec block interleaver: initializing: span=%lu",
+            (unsigned long)span_);
+
+    valid_ = true;
+}
+
+bool BlockInterleaver::valid() const {
+    return valid_;
+}
+
+size_t BlockInterleaver::span() const {
+    roc_panic_if_not(valid());
+
+    return span_;
+}
+
+size_t BlockInterleaver::max_delay(size_t n_source_packets) const {
+    roc_panic_if_not(valid());
+
+    return span_ * n_source_packets;
+}
+
+size_t BlockInterleaver::max_blocks() const {
+    roc_panic_if_not(valid());
+
+    return span_ * 2;
+}
+
+void BlockInterleaver::write(const packet::PacketPtr& pp) {
+    roc_panic_if_not(valid());
+
+    if (!pp) {
+        roc_panic("fec block interleaver: unexpected null packet");
+    }
+
+    if (!store_(pp)) {
+        writer_.write(pp);
+        return;
+    }
+
+    while (is_group_complete_()) {
+        send_group_();
+    }
+}
+
+void BlockInterleaver::flush() {
+    roc_panic_if_not(valid());
+
+    flush_all_();
+}
+
+bool BlockInterleaver::store_(const packet::PacketPtr& pp) {
+    const packet::FEC* fec = pp->fec();
+    if (!fec) {
+        return false;
+    }
+
+    if (fec->block_length == 0 || fec->encoding_symbol_id >= fec->block_length) {
+        return false;
+    }
+
+    if (fec->block_length > stride_) {
+        // buffered blocks use previous layout, send them before relayout
+        flush_all_();
+        started_ = false;
+
+        if (!resize_stride_(fec->block_length)) {
+            return false;
+        }
+    }
+
+    if (started_) {
+        const packet::blknum_diff_t dist =
+            packet::blknum_diff(fec->source_block_number, group_sbn_);
+
+        if (dist >= 0 && (size_t)dist >= span_ * 3) {
+            roc_log(LogDebug,
+                    "fec block interleaver: source block number jump, restarting:"
+                    " group_sbn=%lu pkt_sbn=%lu",
+                    (unsigned long)group_sbn_,
+                    (unsigned long)fec->source_block_number);
+            flush_all_();
+            started_ = false;
+        }
+    }
+
+    if (!started_) {
+        group_sbn_ = fec->source_block_number;
+        started_ = true;
+    }
+
+    packet::blknum_diff_t dist =
+        packet::blknum_diff(fec->source_block_number, group_sbn_);
+
+    // block of a group which was already sent
+    if (dist < 0) {
+        return false;
+    }
+
+    // block of a group following the next one, make room for it
+    while ((size_t)dist >= span_ * 2) {
+        send_group_();
+        dist -= (packet::blknum_diff_t)span_;
+    }
+
+    const size_t index = block_index_((size_t)dist);
+
+    packet::PacketPtr& slot = packets_[index * stride_ + fec->encoding_symbol_id];
+    if (slot) {
+        return false;
+    }
+
+    BlockState& block = blocks_[index];
+    if (block.n_packets == 0) {
+        block.blen = fec->block_length;
+    }
+
+    slot = pp;
+    block.n_packets++;
+
+    return true;
+}
+
+bool BlockInterleaver::is_group_complete_() const {
+    for (size_t pos = 0; pos < span_; pos++) {
+        const BlockState& block = blocks_[block_index_(pos)];
+
+        if (block.n_packets == 0 || block.n_packets < block.blen) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void BlockInterleaver::send_group_() {
+    for (size_t esi = 0; esi < stride_; esi++) {
+        for (size_t pos = 0; pos < span_; pos++) {
+            packet::PacketPtr& pp = packets_[block_index_(pos) * stride_ + esi];
+            if (!pp) {
+                continue;
+            }
+
+            writer_.write(pp);
+            pp = NULL;
+        }
+    }
+
+    for (size_t pos = 0; pos < span_; pos++) {
+        blocks_[block_index_(pos)] = BlockState();
+    }
+
+    group_sbn_ = packet::blknum_t(group_sbn_ + span_);
+    group_index_ = (group_index_ + span_) % (span_ * 2);
+}
+
+void BlockInterleaver::flush_all_() {
+    // current group, then next group
+    send_group_();
+    send_group_();
+}
+
+bool BlockInterleaver::resize_stride_(size_t blen) {
+    if (!packets_.resize(span_ * 2 * blen)) {
+        roc_log(LogError,
+                "fec block interleaver: can't allocate packet array: span=%lu blen=%lu",
+                (unsigned long)span_, (unsigned long)blen);
+        return false;
+    }
+
+    roc_log(LogDebug, "fec block interleaver: update block length: old=%lu new=%lu",
+            (unsigned long)stride_, (unsigned long)blen);
+
+    stride_ = blen;
+
+    return true;
+}
+
+size_t BlockInterleaver::block_index_(size_t group_pos) const {
+    return (group_index_ + group_pos) % (span_ * 2);
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/block_interleaver.h
+//! @brief FEC block interleaver.
+
+#ifndef ROC_FEC_BLOCK_INTERLEAVER_H_
+#define ROC_FEC_BLOCK_INTERLEAVER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet.h"
+#include "roc_packet/units.h"
+
+namespace roc {
+namespace fec {
+
+//! FEC block interleaver parameters.
+struct BlockInterleaverConfig {
+    //! Interleave packets of consecutive FEC blocks.
+    bool enabled;
+
+    //! Number of FEC blocks which packets are interleaved with each other.
+    //! @remarks
+    //!  A loss burst of up to span * K packets costs every block at most
+    //!  K packets. Interleaving delays packets by up to span blocks.
+    size_t span;
+
+    BlockInterleaverConfig()
+        : enabled(false)
+        , span(4) {
+    }
+};
+
+//! FEC block interleaver.
+//!
+//! Unlike packet::Interleaver, which shuffles packets within a fixed window
+//! regardless of FEC layout, this interleaver is aware of FEC blocks. It
+//! accumulates a group of span consecutive blocks produced by fec::Writer,
+//! and when all packets of the group are written, sends them column by
+//! column: packets with ESI 0 from every block, then packets with ESI 1,
+//! and so on. Adjacent packets on the wire thus always belong to different
+//! blocks, and a loss burst is spread evenly over the blocks of the group.
+//!
+//! Packets of the next group are buffered separately, so that repair packets
+//! of a block may be written after source packets of following blocks, like
+//! fec::Writer does in asynchronous mode.
+//!
+//! Packets without FEC payload ID and packets from blocks which were already
+//! sent are passed through immediately.
+class BlockInterleaver : public packet::IWriter, public core::NonCopyable<> {
+public:
+    //! Maximum allowed span.
+    enum { MaxSpan = 32 };
+
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p config defines interleaving parameters
+    //!  - @p writer is used to write reordered packets
+    //!  - @p allocator is used to initialize packet array
+    BlockInterleaver(const BlockInterleaverConfig& config,
+                     packet::IWriter& writer,
+                     core::IAllocator& allocator);
+
+    //! Check if object is successfully constructed.
+    bool valid() const;
+
+    //! Get number of blocks in a group.
+    size_t span() const;
+
+    //! Get maximum delay introduced by interleaver, in packets.
+    //! @remarks
+    //!  First packet of a group is delayed until all source packets of
+    //!  the group are written, i.e. by span blocks of @p n_source_packets.
+    //!  Repair packets are produced at the end of a block and don't
+    //!  increase the delay.
+    size_t max_delay(size_t n_source_packets) const;
+
+    //! Get maximum number of blocks buffered by interleaver.
+    //! @remarks
+    //!  Packets of the current group and of the next one may be buffered.
+    size_t max_blocks() const;
+
+    //! Write packet.
+    //! @remarks
+    //!  Packet is buffered until its group is complete or pushed out by
+    //!  following groups.
+    virtual void write(const packet::PacketPtr& pp);
+
+    //! Send all buffered packets to output writer.
+    void flush();
+
+private:
+    struct BlockState {
+        size_t blen;
+        size_t n_packets;
+
+        BlockState()
+            : blen(0)
+            , n_packets(0) {
+        }
+    };
+
+    bool store_(const packet::PacketPtr& pp);
+
+    bool is_group_complete_() const;
+    void send_group_();
+    void flush_all_();
+
+    bool resize_stride_(size_t blen);
+
+    size_t block_index_(size_t group_pos) const;
+
+    packet::IWriter& writer_;
+
+    const size_t span_;
+
+    // Packets of current and next groups, block_index * stride_ + esi.
+    core::Array<packet::PacketPtr> packets_;
+    BlockState blocks_[MaxSpan * 2];
+
+    // Maximum block length of buffered blocks.
+    size_t stride_;
+
+    // First block of current group, and its index in blocks_.
+    packet::blknum_t group_sbn_;
+    size_t group_index_;
+
+    bool started_;
+    bool valid_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_BLOCK_INTERLEAVER_H_
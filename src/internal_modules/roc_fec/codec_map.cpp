@@ -11,13 +11,12 @@
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/scoped_ptr.h"
+#include "roc_fec/ldpc_decoder.h"
+#include "roc_fec/ldpc_encoder.h"
+#include "roc_fec/rs8m_decoder.h"
+#include "roc_fec/rs8m_encoder.h"
 #include "roc_packet/fec_scheme_to_str.h"
 
-#ifdef ROC_TARGET_OPENFEC
-#include "roc_fec/openfec_decoder.h"
-#include "roc_fec/openfec_encoder.h"
-#endif // ROC_TARGET_OPENFEC
-
 namespace roc {
 namespace fec {
 
@@ -39,19 +38,22 @@ ROC_ATTR_UNUSED I* ctor_func(const CodecConfig& config,
 
 CodecMap::CodecMap()
     : n_codecs_(0) {
-#ifdef ROC_TARGET_OPENFEC
     {
         Codec codec;
-        codec.encoder_ctor = ctor_func<IBlockEncoder, OpenfecEncoder>;
-        codec.decoder_ctor = ctor_func<IBlockDecoder, OpenfecDecoder>;
+        codec.encoder_ctor = ctor_func<IBlockEncoder, Rs8mEncoder>;
+        codec.decoder_ctor = ctor_func<IBlockDecoder, Rs8mDecoder>;
 
         codec.scheme = packet::FEC_ReedSolomon_M8;
         add_codec_(codec);
+    }
+    {
+        Codec codec;
+        codec.encoder_ctor = ctor_func<IBlockEncoder, LdpcEncoder>;
+        codec.decoder_ctor = ctor_func<IBlockDecoder, LdpcDecoder>;
 
         codec.scheme = packet::FEC_LDPC_Staircase;
         add_codec_(codec);
     }
-#endif // ROC_TARGET_OPENFEC
 }
 
 bool CodecMap::is_supported(packet::FecScheme scheme) const {
@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/gf256.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ROC_FEC_GF256_X86
+#include <immintrin.h>
+#elif defined(__GNUC__) && defined(__aarch64__)
+#define ROC_FEC_GF256_NEON
+#include <arm_neon.h>
+#endif
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+// x^8 + x^4 + x^3 + x^2 + 1
+const unsigned PrimitivePoly = 0x11d;
+
+void add_generic(uint8_t* dst, const uint8_t* src, size_t size) {
+    size_t i = 0;
+
+    for (; i + 8 <= size; i += 8) {
+        uint64_t d, s;
+        memcpy(&d, dst + i, 8);
+        memcpy(&s, src + i, 8);
+        d ^= s;
+        memcpy(dst + i, &d, 8);
+    }
+
+    for (; i < size; i++) {
+        dst[i] ^= src[i];
+    }
+}
+
+void mul_add_generic(uint8_t* dst,
+                     const uint8_t* src,
+                     const uint8_t* mul_row,
+                     const uint8_t*,
+                     size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        dst[i] ^= mul_row[src[i]];
+    }
+}
+
+#if defined(ROC_FEC_GF256_X86)
+
+__attribute__((target("sse2"))) void
+add_sse2(uint8_t* dst, const uint8_t* src, size_t size) {
+    size_t i = 0;
+
+    for (; i + 16 <= size; i += 16) {
+        const __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        const __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(d, s));
+    }
+
+    add_generic(dst + i, src + i, size - i);
+}
+
+__attribute__((target("avx2"))) void
+add_avx2(uint8_t* dst, const uint8_t* src, size_t size) {
+    size_t i = 0;
+
+    for (; i + 32 <= size; i += 32) {
+        const __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        const __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_xor_si256(d, s));
+    }
+
+    add_sse2(dst + i, src + i, size - i);
+}
+
+__attribute__((target("ssse3"))) void mul_add_ssse3(uint8_t* dst,
+                                                    const uint8_t* src,
+                                                    const uint8_t* mul_row,
+                                                    const uint8_t* nibble_tables,
+                                                    size_t size) {
+    const __m128i lo_table = _mm_loadu_si128((const __m128i*)nibble_tables);
+    const __m128i hi_table = _mm_loadu_si128((const __m128i*)(nibble_tables + 16));
+    const __m128i mask = _mm_set1_epi8(0x0f);
+
+    size_t i = 0;
+
+    for (; i + 16 <= size; i += 16) {
+        const __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        const __m128i lo = _mm_and_si128(s, mask);
+        const __m128i hi = _mm_and_si128(_mm_srli_epi64(s, 4), mask);
+
+        const __m128i p = _mm_xor_si128(_mm_shuffle_epi8(lo_table, lo),
+                                        _mm_shuffle_epi8(hi_table, hi));
+
+        const __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(d, p));
+    }
+
+    mul_add_generic(dst + i, src + i, mul_row, nibble_tables, size - i);
+}
+
+__attribute__((target("avx2"))) void mul_add_avx2(uint8_t* dst,
+                                                  const uint8_t* src,
+                                                  const uint8_t* mul_row,
+                                                  const uint8_t* nibble_tables,
+                                                  size_t size) {
+    const __m128i lo_table_128 = _mm_loadu_si128((const __m128i*)nibble_tables);
+    const __m128i hi_table_128 = _mm_loadu_si128((const __m128i*)(nibble_tables + 16));
+
+    // vpshufb works within 128-bit lanes, so tables are duplicated in both lanes
+    const __m256i lo_table =
+        _mm256_inserti128_si256(_mm256_castsi128_si256(lo_table_128), lo_table_128, 1);
+    const __m256i hi_table =
+        _mm256_inserti128_si256(_mm256_castsi128_si256(hi_table_128), hi_table_128, 1);
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+
+    size_t i = 0;
+
+    for (; i + 32 <= size; i += 32) {
+        const __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        const __m256i lo = _mm256_and_si256(s, mask);
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi64(s, 4), mask);
+
+        const __m256i p = _mm256_xor_si256(_mm256_shuffle_epi8(lo_table, lo),
+                                           _mm256_shuffle_epi8(hi_table, hi));
+
+        const __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_xor_si256(d, p));
+    }
+
+    mul_add_ssse3(dst + i, src + i, mul_row, nibble_tables, size - i);
+}
+
+#endif // ROC_FEC_GF256_X86
+
+#if defined(ROC_FEC_GF256_NEON)
+
+void add_neon(uint8_t* dst, const uint8_t* src, size_t size) {
+    size_t i = 0;
+
+    for (; i + 16 <= size; i += 16) {
+        vst1q_u8(dst + i, veorq_u8(vld1q_u8(dst + i), vld1q_u8(src + i)));
+    }
+
+    add_generic(dst + i, src + i, size - i);
+}
+
+void mul_add_neon(uint8_t* dst,
+                  const uint8_t* src,
+                  const uint8_t* mul_row,
+                  const uint8_t* nibble_tables,
+                  size_t size) {
+    const uint8x16_t lo_table = vld1q_u8(nibble_tables);
+    const uint8x16_t hi_table = vld1q_u8(nibble_tables + 16);
+    const uint8x16_t mask = vdupq_n_u8(0x0f);
+
+    size_t i = 0;
+
+    for (; i + 16 <= size; i += 16) {
+        const uint8x16_t s = vld1q_u8(src + i);
+        const uint8x16_t lo = vandq_u8(s, mask);
+        const uint8x16_t hi = vshrq_n_u8(s, 4);
+
+        const uint8x16_t p =
+            veorq_u8(vqtbl1q_u8(lo_table, lo), vqtbl1q_u8(hi_table, hi));
+
+        vst1q_u8(dst + i, veorq_u8(vld1q_u8(dst + i), p));
+    }
+
+    mul_add_generic(dst + i, src + i, mul_row, nibble_tables, size - i);
+}
+
+#endif // ROC_FEC_GF256_NEON
+
+} // namespace
+
+Gf256::Gf256()
+    : add_func_(NULL)
+    , mul_add_func_(NULL)
+    , impl_name_(NULL) {
+    init_tables_();
+    init_impl_();
+
+    roc_log(LogDebug, "gf256: initialized: impl=%s", impl_name_);
+}
+
+void Gf256::add(uint8_t* dst, const uint8_t* src, size_t size) const {
+    roc_panic_if(!dst || !src);
+
+    add_func_(dst, src, size);
+}
+
+void Gf256::mul_add(uint8_t* dst, const uint8_t* src, uint8_t coef, size_t size) const {
+    roc_panic_if(!dst || !src);
+
+    if (coef == 0) {
+        return;
+    }
+
+    mul_add_func_(dst, src, mul_table_[coef], nibble_tables_[coef], size);
+}
+
+const char* Gf256::impl_name() const {
+    return impl_name_;
+}
+
+void Gf256::init_tables_() {
+    unsigned x = 1;
+    for (size_t n = 0; n < 255; n++) {
+        exp_table_[n] = (uint8_t)x;
+        log_table_[x] = (uint8_t)n;
+
+        x <<= 1;
+        if (x & 0x100) {
+            x ^= PrimitivePoly;
+        }
+    }
+    log_table_[0] = 0;
+
+    for (size_t a = 0; a < 256; a++) {
+        for (size_t b = 0; b < 256; b++) {
+            if (a == 0 || b == 0) {
+                mul_table_[a][b] = 0;
+            } else {
+                mul_table_[a][b] = exp_table_[(log_table_[a] + log_table_[b]) % 255];
+            }
+        }
+    }
+
+    inv_table_[0] = 0;
+    for (size_t a = 1; a < 256; a++) {
+        inv_table_[a] = exp_table_[(255 - log_table_[a]) % 255];
+    }
+
+    for (size_t c = 0; c < 256; c++) {
+        for (size_t n = 0; n < 16; n++) {
+            nibble_tables_[c][n] = mul_table_[c][n];
+            nibble_tables_[c][n + 16] = mul_table_[c][n << 4];
+        }
+    }
+}
+
+void Gf256::init_impl_() {
+    add_func_ = add_generic;
+    mul_add_func_ = mul_add_generic;
+    impl_name_ = "generic";
+
+#if defined(ROC_FEC_GF256_X86)
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2")) {
+        add_func_ = add_avx2;
+        mul_add_func_ = mul_add_avx2;
+        impl_name_ = "avx2";
+    } else if (__builtin_cpu_supports("ssse3")) {
+        add_func_ = add_sse2;
+        mul_add_func_ = mul_add_ssse3;
+        impl_name_ = "ssse3";
+    }
+#elif defined(ROC_FEC_GF256_NEON)
+    add_func_ = add_neon;
+    mul_add_func_ = mul_add_neon;
+    impl_name_ = "neon";
+#endif
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/gf256.h
+//! @brief GF(2^8) arithmetic.
+
+#ifndef ROC_FEC_GF256_H_
+#define ROC_FEC_GF256_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/singleton.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace fec {
+
+//! GF(2^8) arithmetic.
+//!
+//! Uses primitive polynomial x^8 + x^4 + x^3 + x^2 + 1 and generator 2,
+//! the same as Reed-Solomon codec in OpenFEC, so that the codes built on top
+//! of it are compatible.
+//!
+//! Operations on memory regions are vectorized using shuffle instructions:
+//! every byte is split into two nibbles, and product of each nibble and the
+//! coefficient is looked up in a 16-entry table. Addition is a plain XOR
+//! using the widest available loads. Implementation is selected at run
+//! time among AVX2, SSSE3, NEON, and portable code.
+class Gf256 : public core::NonCopyable<> {
+public:
+    //! Get instance.
+    static Gf256& instance() {
+        return core::Singleton<Gf256>::instance();
+    }
+
+    //! Multiply two elements.
+    uint8_t mul(uint8_t a, uint8_t b) const {
+        return mul_table_[a][b];
+    }
+
+    //! Get multiplicative inverse of non-zero element.
+    uint8_t inv(uint8_t a) const {
+        return inv_table_[a];
+    }
+
+    //! Raise generator to given power.
+    uint8_t exp(size_t power) const {
+        return exp_table_[power % 255];
+    }
+
+    //! Add region to another region.
+    //! @remarks
+    //!  Computes dst[i] ^= src[i] for every i in [0; size).
+    void add(uint8_t* dst, const uint8_t* src, size_t size) const;
+
+    //! Multiply region by coefficient and add to another region.
+    //! @remarks
+    //!  Computes dst[i] ^= coef * src[i] for every i in [0; size).
+    void mul_add(uint8_t* dst, const uint8_t* src, uint8_t coef, size_t size) const;
+
+    //! Get name of the used implementation.
+    const char* impl_name() const;
+
+private:
+    friend class core::Singleton<Gf256>;
+
+    typedef void (*add_func_t)(uint8_t* dst, const uint8_t* src, size_t size);
+
+    typedef void (*mul_add_func_t)(uint8_t* dst,
+                                   const uint8_t* src,
+                                   const uint8_t* mul_row,
+                                   const uint8_t* nibble_tables,
+                                   size_t size);
+
+    Gf256();
+
+    void init_tables_();
+    void init_impl_();
+
+    uint8_t exp_table_[255];
+    uint8_t log_table_[256];
+    uint8_t inv_table_[256];
+    uint8_t mul_table_[256][256];
+
+    // For every coefficient, 16 products with low nibbles followed by
+    // 16 products with high nibbles.
+    uint8_t nibble_tables_[256][32];
+
+    add_func_t add_func_;
+    mul_add_func_t mul_add_func_;
+    const char* impl_name_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_GF256_H_
@@ -82,8 +82,9 @@ public:
     }
 
     //! Set encoding symbol ID.
-    void set_esi(uint16_t val) {
-        esi_ = core::hton16u(val);
+    void set_esi(uint32_t val) {
+        roc_panic_if((val >> 16) != 0);
+        esi_ = core::hton16u((uint16_t)val);
     }
 
     //! Get source block length.
@@ -158,8 +159,9 @@ public:
     }
 
     //! Set encoding symbol ID.
-    void set_esi(uint16_t val) {
-        esi_ = core::hton16u(val);
+    void set_esi(uint32_t val) {
+        roc_panic_if((val >> 16) != 0);
+        esi_ = core::hton16u((uint16_t)val);
     }
 
     //! Get source block length.
@@ -235,7 +237,7 @@ public:
     }
 
     //! Set encoding symbol ID.
-    void set_esi(uint16_t val) {
+    void set_esi(uint32_t val) {
         roc_panic_if((val >> 8) != 0);
         esi_ = (uint8_t)val;
     }
@@ -260,6 +262,152 @@ public:
     }
 } ROC_ATTR_PACKED_END;
 
+//! RLC Source FEC Payload ID.
+//!
+//! @code
+//!    0                   1                   2                   3
+//!    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |                   Encoding Symbol ID (ESI)                    |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! @endcode
+//!
+//! @remarks
+//!  Sliding window scheme has no source blocks, so source block number
+//!  and length are always zero.
+ROC_ATTR_PACKED_BEGIN class RLC_Source_PayloadID {
+private:
+    //! Encoding symbol ID.
+    uint32_t esi_;
+
+public:
+    //! Get FEC scheme to which these packets belong to.
+    static packet::FecScheme fec_scheme() {
+        return packet::FEC_RLC;
+    }
+
+    //! Clear header.
+    void clear() {
+        memset(this, 0, sizeof(*this));
+    }
+
+    //! Get source block number.
+    uint16_t sbn() const {
+        return 0;
+    }
+
+    //! Set source block number.
+    void set_sbn(uint16_t) {
+    }
+
+    //! Get encoding symbol ID.
+    uint32_t esi() const {
+        return core::ntoh32u(esi_);
+    }
+
+    //! Set encoding symbol ID.
+    void set_esi(uint32_t val) {
+        esi_ = core::hton32u(val);
+    }
+
+    //! Get source block length.
+    uint16_t k() const {
+        return 0;
+    }
+
+    //! Set source block length.
+    void set_k(uint16_t) {
+    }
+
+    //! Get number encoding symbols.
+    uint16_t n() const {
+        return 0;
+    }
+
+    //! Set number encoding symbols.
+    void set_n(uint16_t) {
+    }
+} ROC_ATTR_PACKED_END;
+
+//! RLC Repair FEC Payload ID.
+//!
+//! @code
+//!    0                   1                   2                   3
+//!    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |          Repair Key           |  DT   | Num Source Symbols (k)|
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//!   |              First Source Symbol ESI in window                |
+//!   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//! @endcode
+//!
+//! @remarks
+//!  Repair key is exposed as source block number, and the number of source
+//!  symbols in the encoding window is exposed as source block length.
+//!  Only dense codes are used, so density threshold (DT) is always 15.
+ROC_ATTR_PACKED_BEGIN class RLC_Repair_PayloadID {
+private:
+    //! Repair key.
+    uint16_t key_;
+
+    //! Density threshold and number of source symbols.
+    uint16_t dt_nss_;
+
+    //! First source symbol ESI.
+    uint32_t esi_;
+
+public:
+    //! Get FEC scheme to which these packets belong to.
+    static packet::FecScheme fec_scheme() {
+        return packet::FEC_RLC;
+    }
+
+    //! Clear header.
+    void clear() {
+        memset(this, 0, sizeof(*this));
+    }
+
+    //! Get repair key.
+    uint16_t sbn() const {
+        return core::ntoh16u(key_);
+    }
+
+    //! Set repair key.
+    void set_sbn(uint16_t val) {
+        key_ = core::hton16u(val);
+    }
+
+    //! Get first source symbol ESI.
+    uint32_t esi() const {
+        return core::ntoh32u(esi_);
+    }
+
+    //! Set first source symbol ESI.
+    void set_esi(uint32_t val) {
+        esi_ = core::hton32u(val);
+    }
+
+    //! Get number of source symbols in window.
+    uint16_t k() const {
+        return core::ntoh16u(dt_nss_) & 0xfff;
+    }
+
+    //! Set number of source symbols in window.
+    void set_k(uint16_t val) {
+        roc_panic_if((val >> 12) != 0);
+        dt_nss_ = core::hton16u(uint16_t(0xf000 | val));
+    }
+
+    //! Get number encoding symbols.
+    uint16_t n() const {
+        return 0;
+    }
+
+    //! Set number encoding symbols.
+    void set_n(uint16_t) {
+    }
+} ROC_ATTR_PACKED_END;
+
 } // namespace fec
 } // namespace roc
 
@@ -35,6 +35,10 @@ public:
 
     //! Store source or repair packet buffer for current block.
     //!
+    //! @remarks
+    //!  Every index may be set only once. It may be set after the packet
+    //!  was already restored by repair(), e.g. if it arrived late.
+    //!
     //! @pre
     //!  This method may be called only between begin() and end() calls.
     virtual void set(size_t index, const core::Slice<uint8_t>& buffer) = 0;
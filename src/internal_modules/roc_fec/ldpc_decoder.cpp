@@ -0,0 +1,466 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/ldpc_decoder.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace fec {
+
+LdpcDecoder::LdpcDecoder(const CodecConfig& config,
+                         core::BufferFactory<uint8_t>& buffer_factory,
+                         core::IAllocator& allocator)
+    : sblen_(0)
+    , rblen_(0)
+    , payload_size_(0)
+    , max_index_(0)
+    , seed_((uint32_t)config.ldpc_prng_seed)
+    , n1_(config.ldpc_N1)
+    , gf_(Gf256::instance())
+    , matrix_cache_((uint32_t)config.ldpc_prng_seed, config.ldpc_N1, allocator)
+    , matrix_(NULL)
+    , buffer_factory_(buffer_factory)
+    , buff_tab_(allocator)
+    , recv_tab_(allocator)
+    , row_unknown_(allocator)
+    , row_queue_(allocator)
+    , row_queue_size_(0)
+    , n_known_(0)
+    , n_known_source_(0)
+    , elim_cols_(allocator)
+    , elim_col_index_(allocator)
+    , elim_rows_(allocator)
+    , elim_matrix_(allocator)
+    , elim_data_(allocator)
+    , has_new_packets_(false)
+    , status_(allocator)
+    , valid_(false) {
+    if (config.scheme != packet::FEC_LDPC_Staircase) {
+        roc_panic("ldpc decoder: unexpected fec scheme");
+    }
+
+    if (config.ldpc_prng_seed <= 0 || config.ldpc_prng_seed == 0x7FFFFFFF
+        || config.ldpc_N1 == 0) {
+        roc_log(LogError, "ldpc decoder: unsupported parameters: prng_seed=%ld n1=%d",
+                (long)config.ldpc_prng_seed, (int)config.ldpc_N1);
+        return;
+    }
+
+    roc_log(LogDebug, "ldpc decoder: initializing: prng_seed=%ld n1=%d impl=%s",
+            (long)config.ldpc_prng_seed, (int)config.ldpc_N1, gf_.impl_name());
+
+    valid_ = true;
+}
+
+LdpcDecoder::~LdpcDecoder() {
+}
+
+bool LdpcDecoder::valid() const {
+    return valid_;
+}
+
+size_t LdpcDecoder::max_block_length() const {
+    roc_panic_if_not(valid());
+
+    return MaxBlockLength;
+}
+
+bool LdpcDecoder::begin(size_t sblen, size_t rblen, size_t payload_size) {
+    roc_panic_if_not(valid());
+
+    if (sblen == 0 || rblen < n1_ || sblen + rblen > MaxBlockLength) {
+        roc_log(LogError,
+                "ldpc decoder: invalid block size: sblen=%lu rblen=%lu n1=%lu max=%lu",
+                (unsigned long)sblen, (unsigned long)rblen, (unsigned long)n1_,
+                (unsigned long)MaxBlockLength);
+        return false;
+    }
+
+    matrix_ = matrix_cache_.get(sblen, rblen);
+    if (!matrix_) {
+        sblen_ = 0;
+        rblen_ = 0;
+        return false;
+    }
+
+    if (!resize_tabs_(sblen + rblen)) {
+        return false;
+    }
+
+    sblen_ = sblen;
+    rblen_ = rblen;
+    payload_size_ = payload_size;
+    max_index_ = 0;
+
+    for (size_t r = 0; r < rblen; r++) {
+        row_unknown_[r] = matrix_->row_size(r);
+    }
+
+    row_queue_size_ = 0;
+
+    n_known_ = 0;
+    n_known_source_ = 0;
+
+    return true;
+}
+
+void LdpcDecoder::set(size_t index, const core::Slice<uint8_t>& buffer) {
+    roc_panic_if_not(valid());
+
+    if (index >= sblen_ + rblen_) {
+        roc_panic("ldpc decoder: index out of bounds: index=%lu size=%lu",
+                  (unsigned long)index, (unsigned long)(sblen_ + rblen_));
+    }
+
+    if (!buffer) {
+        roc_panic("ldpc decoder: null buffer");
+    }
+
+    if (buffer.size() == 0 || buffer.size() != payload_size_) {
+        roc_panic("ldpc decoder: invalid payload size: cur=%lu new=%lu",
+                  (unsigned long)payload_size_, (unsigned long)buffer.size());
+    }
+
+    if (recv_tab_[index]) {
+        roc_panic("ldpc decoder: can't overwrite buffer: index=%lu",
+                  (unsigned long)index);
+    }
+
+    if (max_index_ < index) {
+        max_index_ = index;
+    }
+
+    recv_tab_[index] = true;
+
+    if (buff_tab_[index]) {
+        // packet was already repaired, prefer received one
+        buff_tab_[index] = buffer;
+        return;
+    }
+
+    has_new_packets_ = true;
+
+    add_symbol_(index, buffer);
+    peel_();
+}
+
+core::Slice<uint8_t> LdpcDecoder::repair(size_t index) {
+    roc_panic_if_not(valid());
+
+    if (index >= sblen_ + rblen_) {
+        roc_panic("ldpc decoder: index out of bounds: index=%lu size=%lu",
+                  (unsigned long)index, (unsigned long)(sblen_ + rblen_));
+    }
+
+    if (!buff_tab_[index] && index < sblen_ && has_new_packets_) {
+        has_new_packets_ = false;
+        eliminate_();
+    }
+
+    return buff_tab_[index];
+}
+
+void LdpcDecoder::end() {
+    roc_panic_if_not(valid());
+
+    if (sblen_ != 0) {
+        report_();
+    }
+
+    reset_tabs_();
+
+    has_new_packets_ = false;
+}
+
+bool LdpcDecoder::resize_tabs_(size_t size) {
+    if (!buff_tab_.resize(size)) {
+        return false;
+    }
+    if (!recv_tab_.resize(size)) {
+        return false;
+    }
+    if (!row_unknown_.resize(matrix_->num_repair())) {
+        return false;
+    }
+    if (!row_queue_.resize(matrix_->num_repair())) {
+        return false;
+    }
+    if (!status_.resize(size + 2)) {
+        return false;
+    }
+
+    return true;
+}
+
+void LdpcDecoder::reset_tabs_() {
+    for (size_t i = 0; i < buff_tab_.size(); ++i) {
+        buff_tab_[i] = core::Slice<uint8_t>();
+        recv_tab_[i] = false;
+    }
+}
+
+void LdpcDecoder::add_symbol_(size_t index, const core::Slice<uint8_t>& buffer) {
+    buff_tab_[index] = buffer;
+
+    n_known_++;
+    if (index < sblen_) {
+        n_known_source_++;
+    }
+
+    const size_t* rows = matrix_->col(index);
+    const size_t n_rows = matrix_->col_size(index);
+
+    // every row reaches one unknown symbol at most once,
+    // so the queue never overflows
+    for (size_t n = 0; n < n_rows; n++) {
+        if (--row_unknown_[rows[n]] == 1) {
+            row_queue_[row_queue_size_++] = rows[n];
+        }
+    }
+}
+
+void LdpcDecoder::peel_() {
+    // repair symbols are restored only while they can help
+    // to restore source symbols
+    while (row_queue_size_ != 0 && n_known_source_ < sblen_) {
+        const size_t row = row_queue_[--row_queue_size_];
+
+        if (row_unknown_[row] == 1) {
+            solve_row_(row);
+        }
+    }
+}
+
+void LdpcDecoder::solve_row_(size_t row) {
+    const size_t* cols = matrix_->row(row);
+    const size_t n_cols = matrix_->row_size(row);
+
+    size_t unknown = 0;
+    while (buff_tab_[cols[unknown]]) {
+        unknown++;
+    }
+
+    core::Slice<uint8_t> buffer = make_buffer_();
+    if (!buffer) {
+        return;
+    }
+
+    memset(buffer.data(), 0, payload_size_);
+
+    for (size_t n = 0; n < n_cols; n++) {
+        if (n != unknown) {
+            gf_.add(buffer.data(), buff_tab_[cols[n]].data(), payload_size_);
+        }
+    }
+
+    roc_log(LogTrace, "ldpc decoder: repaired packet: index=%lu row=%lu",
+            (unsigned long)cols[unknown], (unsigned long)row);
+
+    add_symbol_(cols[unknown], buffer);
+}
+
+// Gauss-Jordan elimination over rows that still have unknown symbols;
+// restores source symbols that are uniquely determined
+void LdpcDecoder::eliminate_() {
+    const size_t n_unknown = sblen_ + rblen_ - n_known_;
+
+    if (n_known_source_ == sblen_ || n_unknown > rblen_) {
+        return;
+    }
+
+    if (n_unknown > MaxEliminationSize) {
+        roc_log(LogDebug, "ldpc decoder: too many unknown symbols: n=%lu max=%lu",
+                (unsigned long)n_unknown, (unsigned long)MaxEliminationSize);
+        return;
+    }
+
+    if (!elim_cols_.resize(n_unknown) || !elim_col_index_.resize(sblen_ + rblen_)
+        || !elim_rows_.resize(rblen_)) {
+        roc_log(LogError, "ldpc decoder: can't allocate elimination state");
+        return;
+    }
+
+    size_t n_cols = 0;
+    for (size_t c = 0; c < sblen_ + rblen_; c++) {
+        if (!buff_tab_[c]) {
+            elim_col_index_[c] = n_cols;
+            elim_cols_[n_cols++] = c;
+        }
+    }
+
+    size_t n_rows = 0;
+    for (size_t r = 0; r < rblen_; r++) {
+        if (row_unknown_[r] != 0) {
+            elim_rows_[n_rows++] = r;
+        }
+    }
+
+    const size_t n_words = (n_cols + 63) / 64;
+
+    if (!elim_matrix_.resize(n_rows * n_words)
+        || !elim_data_.resize(n_rows * payload_size_)) {
+        roc_log(LogError, "ldpc decoder: can't allocate elimination state");
+        return;
+    }
+
+    // build system of equations: unknown symbols of every row
+    // are equal to XOR of known symbols of the row
+    for (size_t i = 0; i < n_rows; i++) {
+        uint64_t* bits = &elim_matrix_[i * n_words];
+        uint8_t* data = &elim_data_[i * payload_size_];
+
+        memset(bits, 0, n_words * sizeof(uint64_t));
+        memset(data, 0, payload_size_);
+
+        const size_t* cols = matrix_->row(elim_rows_[i]);
+        const size_t row_size = matrix_->row_size(elim_rows_[i]);
+
+        for (size_t n = 0; n < row_size; n++) {
+            if (buff_tab_[cols[n]]) {
+                gf_.add(data, buff_tab_[cols[n]].data(), payload_size_);
+            } else {
+                const size_t bit = elim_col_index_[cols[n]];
+                bits[bit / 64] |= (uint64_t)1 << (bit % 64);
+            }
+        }
+
+        // from now on, used as permutation of rows
+        elim_rows_[i] = i;
+    }
+
+    size_t rank = 0;
+
+    for (size_t c = 0; c < n_cols && rank < n_rows; c++) {
+        const size_t word = c / 64;
+        const uint64_t mask = (uint64_t)1 << (c % 64);
+
+        size_t pivot = rank;
+        while (pivot < n_rows
+               && !(elim_matrix_[elim_rows_[pivot] * n_words + word] & mask)) {
+            pivot++;
+        }
+        if (pivot == n_rows) {
+            continue;
+        }
+
+        const size_t tmp = elim_rows_[pivot];
+        elim_rows_[pivot] = elim_rows_[rank];
+        elim_rows_[rank] = tmp;
+
+        const uint64_t* p_bits = &elim_matrix_[tmp * n_words];
+        const uint8_t* p_data = &elim_data_[tmp * payload_size_];
+
+        for (size_t i = 0; i < n_rows; i++) {
+            if (i == rank) {
+                continue;
+            }
+
+            uint64_t* bits = &elim_matrix_[elim_rows_[i] * n_words];
+            if (!(bits[word] & mask)) {
+                continue;
+            }
+
+            for (size_t w = 0; w < n_words; w++) {
+                bits[w] ^= p_bits[w];
+            }
+            gf_.add(&elim_data_[elim_rows_[i] * payload_size_], p_data, payload_size_);
+        }
+
+        rank++;
+    }
+
+    // rows with single unknown symbol give its value
+    for (size_t i = 0; i < rank; i++) {
+        const uint64_t* bits = &elim_matrix_[elim_rows_[i] * n_words];
+
+        size_t n_bits = 0, bit = 0;
+        for (size_t c = 0; c < n_cols && n_bits < 2; c++) {
+            if (bits[c / 64] & ((uint64_t)1 << (c % 64))) {
+                bit = c;
+                n_bits++;
+            }
+        }
+
+        if (n_bits != 1 || elim_cols_[bit] >= sblen_) {
+            continue;
+        }
+
+        core::Slice<uint8_t> buffer = make_buffer_();
+        if (!buffer) {
+            continue;
+        }
+
+        memcpy(buffer.data(), &elim_data_[elim_rows_[i] * payload_size_], payload_size_);
+
+        add_symbol_(elim_cols_[bit], buffer);
+    }
+}
+
+core::Slice<uint8_t> LdpcDecoder::make_buffer_() {
+    core::Slice<uint8_t> buffer = buffer_factory_.new_buffer();
+
+    if (!buffer) {
+        roc_log(LogError, "ldpc decoder: can't allocate buffer");
+        return core::Slice<uint8_t>();
+    }
+
+    if (buffer.capacity() < payload_size_) {
+        roc_log(LogError, "ldpc decoder: packet size too large: size=%lu max=%lu",
+                (unsigned long)payload_size_, (unsigned long)buffer.capacity());
+        return core::Slice<uint8_t>();
+    }
+
+    buffer.reslice(0, payload_size_);
+
+    return buffer;
+}
+
+void LdpcDecoder::report_() {
+    size_t n_lost = 0, n_repaired = 0;
+
+    size_t tab_size = max_index_ + 1;
+    if (tab_size < sblen_) {
+        tab_size = sblen_;
+    }
+
+    // source and repair packets are separated by space
+    status_[sblen_] = ' ';
+    status_[tab_size > sblen_ ? tab_size + 1 : tab_size] = '\0';
+
+    for (size_t i = 0; i < tab_size; ++i) {
+        char* status = (i < sblen_ ? &status_[i] : &status_[i + 1]);
+
+        if (buff_tab_[i]) {
+            if (recv_tab_[i]) {
+                *status = '.';
+            } else {
+                *status = 'r';
+                n_repaired++;
+                n_lost++;
+            }
+        } else {
+            if (i < sblen_) {
+                *status = 'X';
+            } else {
+                *status = 'x';
+            }
+            n_lost++;
+        }
+    }
+
+    if (n_lost == 0) {
+        return;
+    }
+
+    roc_log(LogDebug, "ldpc decoder: repaired %u/%u/%u %s", (unsigned)n_repaired,
+            (unsigned)n_lost, (unsigned)buff_tab_.size(), &status_[0]);
+}
+
+} // namespace fec
+} // namespace roc
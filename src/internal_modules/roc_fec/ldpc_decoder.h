@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/ldpc_decoder.h
+//! @brief Native LDPC-Staircase decoder.
+
+#ifndef ROC_FEC_LDPC_DECODER_H_
+#define ROC_FEC_LDPC_DECODER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/buffer_factory.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/slice.h"
+#include "roc_fec/codec_config.h"
+#include "roc_fec/gf256.h"
+#include "roc_fec/iblock_decoder.h"
+#include "roc_fec/ldpc_matrix.h"
+#include "roc_fec/ldpc_matrix_cache.h"
+
+namespace roc {
+namespace fec {
+
+//! Native LDPC-Staircase decoder.
+//!
+//! Compatible with LDPC-Staircase codec in OpenFEC.
+//!
+//! Uses iterative (peeling) decoding: when all symbols of a parity check
+//! except one are known, the remaining symbol is XOR of the others. This
+//! is done incrementally in set(), so that the work is spread over the
+//! block instead of being done when the block ends.
+//!
+//! If iterative decoding gets stuck, repair() falls back to Gaussian
+//! elimination over the remaining unknown symbols, like OpenFEC does.
+class LdpcDecoder : public IBlockDecoder, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    explicit LdpcDecoder(const CodecConfig& config,
+                         core::BufferFactory<uint8_t>& buffer_factory,
+                         core::IAllocator& allocator);
+
+    virtual ~LdpcDecoder();
+
+    //! Check if object is successfully constructed.
+    bool valid() const;
+
+    //! Get the maximum number of encoding symbols for the scheme being used.
+    virtual size_t max_block_length() const;
+
+    //! Start block.
+    //!
+    //! @remarks
+    //!  Performs an initial setup for a block. Should be called before
+    //!  any operations for the block.
+    virtual bool begin(size_t sblen, size_t rblen, size_t payload_size);
+
+    //! Store source or repair packet buffer for current block.
+    virtual void set(size_t index, const core::Slice<uint8_t>& buffer);
+
+    //! Repair source packet buffer.
+    virtual core::Slice<uint8_t> repair(size_t index);
+
+    //! Finish block.
+    //!
+    //! @remarks
+    //!  Cleanups the resources allocated for the block. Should be called after
+    //!  all operations for the block.
+    virtual void end();
+
+private:
+    enum { MaxBlockLength = 50000 };
+
+    // maximum number of unknown symbols for Gaussian elimination
+    enum { MaxEliminationSize = 1024 };
+
+    bool resize_tabs_(size_t size);
+    void reset_tabs_();
+
+    void add_symbol_(size_t index, const core::Slice<uint8_t>& buffer);
+    void peel_();
+    void solve_row_(size_t row);
+
+    void eliminate_();
+
+    core::Slice<uint8_t> make_buffer_();
+
+    void report_();
+
+    size_t sblen_;
+    size_t rblen_;
+    size_t payload_size_;
+    size_t max_index_;
+
+    const uint32_t seed_;
+    const size_t n1_;
+
+    Gf256& gf_;
+    LdpcMatrixCache matrix_cache_;
+    const LdpcMatrix* matrix_;
+
+    core::BufferFactory<uint8_t>& buffer_factory_;
+
+    // received and repaired source and repair packets
+    core::Array<core::Slice<uint8_t> > buff_tab_;
+
+    // true if packet is received, false if it's is lost or repaired
+    core::Array<bool> recv_tab_;
+
+    // number of unknown symbols in every row
+    core::Array<size_t> row_unknown_;
+
+    // rows with exactly one unknown symbol
+    core::Array<size_t> row_queue_;
+    size_t row_queue_size_;
+
+    // number of received and repaired symbols
+    size_t n_known_;
+    size_t n_known_source_;
+
+    // state of Gaussian elimination
+    core::Array<size_t> elim_cols_;
+    core::Array<size_t> elim_col_index_;
+    core::Array<size_t> elim_rows_;
+    core::Array<uint64_t> elim_matrix_;
+    core::Array<uint8_t> elim_data_;
+
+    bool has_new_packets_;
+
+    // for debug logging
+    core::Array<char> status_;
+
+    bool valid_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_LDPC_DECODER_H_
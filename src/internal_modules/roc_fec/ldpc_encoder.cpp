@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/ldpc_encoder.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace fec {
+
+LdpcEncoder::LdpcEncoder(const CodecConfig& config,
+                         core::BufferFactory<uint8_t>&,
+                         core::IAllocator& allocator)
+    : sblen_(0)
+    , rblen_(0)
+    , payload_size_(0)
+    , seed_((uint32_t)config.ldpc_prng_seed)
+    , n1_(config.ldpc_N1)
+    , gf_(Gf256::instance())
+    , matrix_cache_((uint32_t)config.ldpc_prng_seed, config.ldpc_N1, allocator)
+    , matrix_(NULL)
+    , buff_tab_(allocator)
+    , valid_(false) {
+    if (config.scheme != packet::FEC_LDPC_Staircase) {
+        roc_panic("ldpc encoder: unexpected fec scheme");
+    }
+
+    if (config.ldpc_prng_seed <= 0 || config.ldpc_prng_seed == 0x7FFFFFFF
+        || config.ldpc_N1 == 0) {
+        roc_log(LogError, "ldpc encoder: unsupported parameters: prng_seed=%ld n1=%d",
+                (long)config.ldpc_prng_seed, (int)config.ldpc_N1);
+        return;
+    }
+
+    roc_log(LogDebug, "ldpc encoder: initializing: prng_seed=%ld n1=%d impl=%s",
+            (long)config.ldpc_prng_seed, (int)config.ldpc_N1, gf_.impl_name());
+
+    valid_ = true;
+}
+
+LdpcEncoder::~LdpcEncoder() {
+}
+
+bool LdpcEncoder::valid() const {
+    return valid_;
+}
+
+size_t LdpcEncoder::alignment() const {
+    return Alignment;
+}
+
+size_t LdpcEncoder::max_block_length() const {
+    roc_panic_if_not(valid());
+
+    return MaxBlockLength;
+}
+
+bool LdpcEncoder::begin(size_t sblen, size_t rblen, size_t payload_size) {
+    roc_panic_if_not(valid());
+
+    if (sblen == 0 || rblen < n1_ || sblen + rblen > MaxBlockLength) {
+        roc_log(LogError,
+                "ldpc encoder: invalid block size: sblen=%lu rblen=%lu n1=%lu max=%lu",
+                (unsigned long)sblen, (unsigned long)rblen, (unsigned long)n1_,
+                (unsigned long)MaxBlockLength);
+        return false;
+    }
+
+    payload_size_ = payload_size;
+
+    if (sblen_ == sblen && rblen_ == rblen) {
+        return true;
+    }
+
+    sblen_ = 0;
+    rblen_ = 0;
+
+    if (!buff_tab_.resize(sblen + rblen)) {
+        return false;
+    }
+
+    matrix_ = matrix_cache_.get(sblen, rblen);
+    if (!matrix_) {
+        return false;
+    }
+
+    sblen_ = sblen;
+    rblen_ = rblen;
+
+    return true;
+}
+
+void LdpcEncoder::set(size_t index, const core::Slice<uint8_t>& buffer) {
+    roc_panic_if_not(valid());
+
+    if (index >= sblen_ + rblen_) {
+        roc_panic("ldpc encoder: can't write more than %lu data buffers",
+                  (unsigned long)(sblen_ + rblen_));
+    }
+
+    if (!buffer) {
+        roc_panic("ldpc encoder: null buffer");
+    }
+
+    if (buffer.size() == 0 || buffer.size() != payload_size_) {
+        roc_panic("ldpc encoder: invalid payload size: cur=%lu new=%lu",
+                  (unsigned long)payload_size_, (unsigned long)buffer.size());
+    }
+
+    if ((uintptr_t)buffer.data() % Alignment != 0) {
+        roc_panic("ldpc encoder: buffer data should be %d-byte aligned: index=%lu",
+                  (int)Alignment, (unsigned long)index);
+    }
+
+    buff_tab_[index] = buffer;
+}
+
+void LdpcEncoder::fill() {
+    roc_panic_if_not(valid());
+
+    for (size_t i = 0; i < sblen_ + rblen_; i++) {
+        if (!buff_tab_[i]) {
+            roc_panic("ldpc encoder: buffer not set: index=%lu", (unsigned long)i);
+        }
+    }
+
+    // row r: XOR of source symbols in row and repair symbols r-1 and r is zero
+    for (size_t r = 0; r < rblen_; r++) {
+        uint8_t* repair = buff_tab_[sblen_ + r].data();
+
+        if (r == 0) {
+            memset(repair, 0, payload_size_);
+        } else {
+            memcpy(repair, buff_tab_[sblen_ + r - 1].data(), payload_size_);
+        }
+
+        const size_t* cols = matrix_->row(r);
+        const size_t n_cols = matrix_->row_size(r);
+
+        for (size_t n = 0; n < n_cols && cols[n] < sblen_; n++) {
+            gf_.add(repair, buff_tab_[cols[n]].data(), payload_size_);
+        }
+    }
+}
+
+void LdpcEncoder::end() {
+    roc_panic_if_not(valid());
+
+    for (size_t i = 0; i < buff_tab_.size(); ++i) {
+        buff_tab_[i] = core::Slice<uint8_t>();
+    }
+}
+
+} // namespace fec
+} // namespace roc
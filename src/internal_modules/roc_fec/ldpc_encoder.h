@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/ldpc_encoder.h
+//! @brief Native LDPC-Staircase encoder.
+
+#ifndef ROC_FEC_LDPC_ENCODER_H_
+#define ROC_FEC_LDPC_ENCODER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/buffer_factory.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/slice.h"
+#include "roc_fec/codec_config.h"
+#include "roc_fec/gf256.h"
+#include "roc_fec/iblock_encoder.h"
+#include "roc_fec/ldpc_matrix.h"
+#include "roc_fec/ldpc_matrix_cache.h"
+
+namespace roc {
+namespace fec {
+
+//! Native LDPC-Staircase encoder.
+//!
+//! Produces the same repair packets as LDPC-Staircase codec in OpenFEC.
+//! Every repair packet is XOR of a few source packets and the previous
+//! repair packet.
+class LdpcEncoder : public IBlockEncoder, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    explicit LdpcEncoder(const CodecConfig& config,
+                         core::BufferFactory<uint8_t>& buffer_factory,
+                         core::IAllocator& allocator);
+
+    virtual ~LdpcEncoder();
+
+    //! Check if object is successfully constructed.
+    bool valid() const;
+
+    //! Get buffer alignment requirement.
+    virtual size_t alignment() const;
+
+    //! Get the maximum number of encoding symbols for the scheme being used.
+    virtual size_t max_block_length() const;
+
+    //! Start block.
+    //!
+    //! @remarks
+    //!  Performs an initial setup for a block. Should be called before
+    //!  any operations for the block.
+    virtual bool begin(size_t sblen, size_t rblen, size_t payload_size);
+
+    //! Store packet data for current block.
+    virtual void set(size_t index, const core::Slice<uint8_t>& buffer);
+
+    //! Fill repair packets.
+    virtual void fill();
+
+    //! Finish block.
+    //!
+    //! @remarks
+    //!  Cleanups the resources allocated for the block. Should be called after
+    //!  all operations for the block.
+    virtual void end();
+
+private:
+    enum { Alignment = 8 };
+
+    enum { MaxBlockLength = 50000 };
+
+    size_t sblen_;
+    size_t rblen_;
+    size_t payload_size_;
+
+    const uint32_t seed_;
+    const size_t n1_;
+
+    Gf256& gf_;
+    LdpcMatrixCache matrix_cache_;
+    const LdpcMatrix* matrix_;
+
+    core::Array<core::Slice<uint8_t> > buff_tab_;
+
+    bool valid_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_LDPC_ENCODER_H_
@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/ldpc_matrix.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace fec {
+
+LdpcMatrix::LdpcMatrix(core::IAllocator& allocator)
+    : n_source_(0)
+    , n_repair_(0)
+    , n1_(0)
+    , rand_state_(0)
+    , source_rows_(allocator)
+    , source_rows_count_(allocator)
+    , extra_cols_(allocator)
+    , extra_cols_count_(allocator)
+    , choices_(allocator)
+    , row_offsets_(allocator)
+    , row_entries_(allocator)
+    , col_offsets_(allocator)
+    , col_entries_(allocator) {
+}
+
+bool LdpcMatrix::generate(size_t n_source, size_t n_repair, uint32_t seed, size_t n1) {
+    if (n_source == 0 || n1 == 0 || n1 > n_repair) {
+        roc_panic("ldpc matrix: invalid parameters: n_source=%lu n_repair=%lu n1=%lu",
+                  (unsigned long)n_source, (unsigned long)n_repair, (unsigned long)n1);
+    }
+
+    if (seed == 0 || seed >= 0x7FFFFFFF) {
+        roc_panic("ldpc matrix: invalid seed: seed=%lu", (unsigned long)seed);
+    }
+
+    n_source_ = 0;
+    n_repair_ = 0;
+
+    if (!source_rows_.resize(n_source * n1) || !source_rows_count_.resize(n_source)
+        || !extra_cols_.resize(n_repair * MaxExtraPerRow)
+        || !extra_cols_count_.resize(n_repair) || !choices_.resize(n_source * n1)
+        || !row_offsets_.resize(n_repair + 1)) {
+        return false;
+    }
+
+    n_source_ = n_source;
+    n_repair_ = n_repair;
+    n1_ = n1;
+
+    rand_state_ = seed;
+
+    for (size_t j = 0; j < n_source; j++) {
+        source_rows_count_[j] = 0;
+    }
+    for (size_t i = 0; i < n_repair; i++) {
+        extra_cols_count_[i] = 0;
+    }
+
+    const size_t n_choices = n_source * n1;
+
+    // list of all possible choices, to guarantee homogeneous distribution of "1s"
+    for (size_t h = 0; h < n_choices; h++) {
+        choices_[h] = h % n_repair;
+    }
+
+    // N1 "1s" per source column
+    size_t t = 0;
+
+    for (size_t j = 0; j < n_source; j++) {
+        for (size_t h = 0; h < n1; h++) {
+            // check that valid choices remain
+            size_t i = t;
+            while (i < n_choices && has_entry_(choices_[i], j)) {
+                i++;
+            }
+
+            if (i < n_choices) {
+                do {
+                    i = t + rand_((uint32_t)(n_choices - t));
+                } while (has_entry_(choices_[i], j));
+
+                add_entry_(choices_[i], j);
+
+                // replace with choice that was never taken
+                choices_[i] = choices_[t];
+                t++;
+            } else {
+                // no valid choices left, choose randomly
+                do {
+                    i = rand_((uint32_t)n_repair);
+                } while (has_entry_(i, j));
+
+                add_entry_(i, j);
+            }
+        }
+    }
+
+    // count "1s" in rows
+    for (size_t i = 0; i < n_repair; i++) {
+        row_offsets_[i] = 0;
+    }
+    for (size_t n = 0; n < n_choices; n++) {
+        row_offsets_[source_rows_[n]]++;
+    }
+
+    // add "1s" to rows with less than two "1s";
+    // needed when code rate is smaller than 2/(2+N1)
+    for (size_t i = 0; i < n_repair; i++) {
+        if (row_offsets_[i] == 0) {
+            add_entry_(i, rand_((uint32_t)n_source));
+            row_offsets_[i]++;
+        }
+        // with single source symbol, second "1" can't be added
+        if (row_offsets_[i] == 1 && n_source > 1) {
+            size_t j;
+            do {
+                j = rand_((uint32_t)n_source);
+            } while (has_entry_(i, j));
+
+            add_entry_(i, j);
+            row_offsets_[i]++;
+        }
+    }
+
+    if (!build_lists_()) {
+        n_source_ = 0;
+        n_repair_ = 0;
+        return false;
+    }
+
+    roc_log(LogTrace, "ldpc matrix: generated: n_source=%lu n_repair=%lu n1=%lu",
+            (unsigned long)n_source, (unsigned long)n_repair, (unsigned long)n1);
+
+    return true;
+}
+
+bool LdpcMatrix::has_entry_(size_t row, size_t col) const {
+    const size_t* rows = &source_rows_[col * n1_];
+    for (size_t n = 0; n < source_rows_count_[col]; n++) {
+        if (rows[n] == row) {
+            return true;
+        }
+    }
+
+    const size_t* cols = &extra_cols_[row * MaxExtraPerRow];
+    for (size_t n = 0; n < extra_cols_count_[row]; n++) {
+        if (cols[n] == col) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void LdpcMatrix::add_entry_(size_t row, size_t col) {
+    // every column gets exactly N1 "1s" first, and then extra "1s" are
+    // added to rows
+    if (source_rows_count_[col] < n1_) {
+        source_rows_[col * n1_ + source_rows_count_[col]++] = row;
+        return;
+    }
+
+    roc_panic_if(extra_cols_count_[row] == MaxExtraPerRow);
+    extra_cols_[row * MaxExtraPerRow + extra_cols_count_[row]++] = col;
+}
+
+bool LdpcMatrix::build_lists_() {
+    const size_t n_cols = n_source_ + n_repair_;
+
+    // rows: source columns, then staircase
+    size_t n_entries = 0;
+    for (size_t i = 0; i < n_repair_; i++) {
+        const size_t row_size = row_offsets_[i] + (i > 0 ? 2 : 1);
+        row_offsets_[i] = n_entries;
+        n_entries += row_size;
+    }
+    row_offsets_[n_repair_] = n_entries;
+
+    if (!row_entries_.resize(n_entries) || !col_offsets_.resize(n_cols + 1)
+        || !col_entries_.resize(n_entries)) {
+        return false;
+    }
+
+    // use offsets as insertion positions, then shift them back
+    for (size_t j = 0; j < n_source_; j++) {
+        for (size_t n = 0; n < n1_; n++) {
+            const size_t i = source_rows_[j * n1_ + n];
+            row_entries_[row_offsets_[i]++] = j;
+        }
+    }
+    for (size_t i = 0; i < n_repair_; i++) {
+        for (size_t n = 0; n < extra_cols_count_[i]; n++) {
+            row_entries_[row_offsets_[i]++] = extra_cols_[i * MaxExtraPerRow + n];
+        }
+        if (i > 0) {
+            row_entries_[row_offsets_[i]++] = n_source_ + i - 1;
+        }
+        row_entries_[row_offsets_[i]++] = n_source_ + i;
+    }
+    for (size_t i = n_repair_; i > 0; i--) {
+        row_offsets_[i] = row_offsets_[i - 1];
+    }
+    row_offsets_[0] = 0;
+
+    // columns: transpose rows
+    for (size_t j = 0; j <= n_cols; j++) {
+        col_offsets_[j] = 0;
+    }
+    for (size_t n = 0; n < n_entries; n++) {
+        col_offsets_[row_entries_[n] + 1]++;
+    }
+    for (size_t j = 0; j < n_cols; j++) {
+        col_offsets_[j + 1] += col_offsets_[j];
+    }
+    for (size_t i = 0; i < n_repair_; i++) {
+        for (size_t n = row_offsets_[i]; n < row_offsets_[i + 1]; n++) {
+            col_entries_[col_offsets_[row_entries_[n]]++] = i;
+        }
+    }
+    for (size_t j = n_cols; j > 0; j--) {
+        col_offsets_[j] = col_offsets_[j - 1];
+    }
+    col_offsets_[0] = 0;
+
+    return true;
+}
+
+// Park-Miller "minimal standard" generator, as defined in RFC 5170
+uint32_t LdpcMatrix::rand_(uint32_t max_val) {
+    uint32_t lo = 16807 * (rand_state_ & 0xFFFF);
+    const uint32_t hi = 16807 * (rand_state_ >> 16);
+
+    lo += (hi & 0x7FFF) << 16;
+    lo += hi >> 15;
+
+    if (lo > 0x7FFFFFFF) {
+        lo -= 0x7FFFFFFF;
+    }
+
+    rand_state_ = lo;
+
+    return (uint32_t)((double)rand_state_ * (double)max_val / (double)0x7FFFFFFF);
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/ldpc_matrix.h
+//! @brief LDPC-Staircase parity check matrix.
+
+#ifndef ROC_FEC_LDPC_MATRIX_H_
+#define ROC_FEC_LDPC_MATRIX_H_
+
+#include "roc_core/array.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace fec {
+
+//! LDPC-Staircase parity check matrix.
+//!
+//! Generated as described in RFC 5170, using the same pseudo-random number
+//! generator, so that the matrix is the same as in OpenFEC for the same
+//! seed and N1 parameters.
+//!
+//! Matrix has one row per repair symbol and one column per encoding symbol.
+//! Left part (source symbols) has N1 "1s" per column; right part (repair
+//! symbols) is a staircase: row i has "1s" in columns k+i and k+i-1.
+//!
+//! Both rows and columns are stored as lists of indices of non-zero
+//! elements. In every row, source columns go first.
+class LdpcMatrix : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    explicit LdpcMatrix(core::IAllocator& allocator);
+
+    //! Generate matrix.
+    //! @remarks
+    //!  @p n_source and @p n_repair define number of source and repair symbols.
+    //!  @p seed should be in range [1; 0x7FFFFFFE], @p n1 should be positive
+    //!  and not greater than @p n_repair.
+    //! @returns
+    //!  false if allocation failed.
+    bool generate(size_t n_source, size_t n_repair, uint32_t seed, size_t n1);
+
+    //! Get number of source symbols.
+    size_t num_source() const {
+        return n_source_;
+    }
+
+    //! Get number of repair symbols.
+    size_t num_repair() const {
+        return n_repair_;
+    }
+
+    //! Get number of non-zero elements in row.
+    size_t row_size(size_t row) const {
+        return row_offsets_[row + 1] - row_offsets_[row];
+    }
+
+    //! Get column indices of non-zero elements in row.
+    const size_t* row(size_t row) const {
+        return &row_entries_[row_offsets_[row]];
+    }
+
+    //! Get number of non-zero elements in column.
+    size_t col_size(size_t col) const {
+        return col_offsets_[col + 1] - col_offsets_[col];
+    }
+
+    //! Get row indices of non-zero elements in column.
+    const size_t* col(size_t col) const {
+        return &col_entries_[col_offsets_[col]];
+    }
+
+private:
+    enum { MaxExtraPerRow = 2 };
+
+    bool has_entry_(size_t row, size_t col) const;
+    void add_entry_(size_t row, size_t col);
+
+    bool build_lists_();
+
+    uint32_t rand_(uint32_t max_val);
+
+    size_t n_source_;
+    size_t n_repair_;
+    size_t n1_;
+
+    uint32_t rand_state_;
+
+    // source part, by columns: n1 rows per column
+    core::Array<size_t> source_rows_;
+    core::Array<size_t> source_rows_count_;
+
+    // source part, extra entries added to rows with less than two "1s"
+    core::Array<size_t> extra_cols_;
+    core::Array<size_t> extra_cols_count_;
+
+    // list of choices for homogeneous distribution of "1s"
+    core::Array<size_t> choices_;
+
+    core::Array<size_t> row_offsets_;
+    core::Array<size_t> row_entries_;
+
+    core::Array<size_t> col_offsets_;
+    core::Array<size_t> col_entries_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_LDPC_MATRIX_H_
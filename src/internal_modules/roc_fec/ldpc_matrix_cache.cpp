@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/ldpc_matrix_cache.h"
+#include "roc_core/log.h"
+
+namespace roc {
+namespace fec {
+
+LdpcMatrixCache::LdpcMatrixCache(uint32_t seed, size_t n1, core::IAllocator& allocator)
+    : seed_(seed)
+    , n1_(n1)
+    , allocator_(allocator)
+    , pos_(0)
+    , n_generated_(0) {
+}
+
+const LdpcMatrix* LdpcMatrixCache::get(size_t n_source, size_t n_repair) {
+    for (size_t n = 0; n < MaxMatrices; n++) {
+        if (matrices_[n] && matrices_[n]->num_source() == n_source
+            && matrices_[n]->num_repair() == n_repair) {
+            return matrices_[n].get();
+        }
+    }
+
+    core::Optional<LdpcMatrix>& entry = matrices_[pos_];
+    pos_ = (pos_ + 1) % MaxMatrices;
+
+    if (!entry) {
+        entry.reset(new (entry) LdpcMatrix(allocator_));
+    }
+
+    if (!entry->generate(n_source, n_repair, seed_, n1_)) {
+        roc_log(LogError,
+                "ldpc matrix cache: can't generate matrix: n_source=%lu n_repair=%lu",
+                (unsigned long)n_source, (unsigned long)n_repair);
+        entry.reset();
+        return NULL;
+    }
+
+    n_generated_++;
+
+    return entry.get();
+}
+
+size_t LdpcMatrixCache::num_generated() const {
+    return n_generated_;
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/ldpc_matrix_cache.h
+//! @brief Cache of LDPC-Staircase matrices.
+
+#ifndef ROC_FEC_LDPC_MATRIX_CACHE_H_
+#define ROC_FEC_LDPC_MATRIX_CACHE_H_
+
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/optional.h"
+#include "roc_core/stddefs.h"
+#include "roc_fec/ldpc_matrix.h"
+
+namespace roc {
+namespace fec {
+
+//! Cache of LDPC-Staircase matrices.
+//!
+//! Matrix depends on block size, PRNG seed and N1 parameter. Seed and N1
+//! are fixed for a codec instance, so matrices are keyed by number of source
+//! and repair symbols. A few recently used matrices are kept, so that when
+//! block size switches between a few values, e.g. when redundancy is
+//! adjusted, matrices are not generated again.
+class LdpcMatrixCache : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    LdpcMatrixCache(uint32_t seed, size_t n1, core::IAllocator& allocator);
+
+    //! Get matrix for given block size.
+    //! @remarks
+    //!  Generates matrix if it's not cached. Returned matrix is valid until
+    //!  next call.
+    //! @returns
+    //!  NULL if allocation failed.
+    const LdpcMatrix* get(size_t n_source, size_t n_repair);
+
+    //! Get number of generated matrices.
+    size_t num_generated() const;
+
+private:
+    enum { MaxMatrices = 4 };
+
+    const uint32_t seed_;
+    const size_t n1_;
+
+    core::IAllocator& allocator_;
+
+    core::Optional<LdpcMatrix> matrices_[MaxMatrices];
+    size_t pos_;
+
+    size_t n_generated_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_LDPC_MATRIX_CACHE_H_
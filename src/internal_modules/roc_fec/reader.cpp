@@ -35,6 +35,8 @@ Reader::Reader(const ReaderConfig& config,
     , alive_(true)
     , started_(false)
     , can_repair_(false)
+    , decoding_(false)
+    , n_decoder_packets_(0)
     , next_packet_(0)
     , cur_sbn_(0)
     , payload_size_(0)
@@ -42,11 +44,17 @@ Reader::Reader(const ReaderConfig& config,
     , repair_block_resized_(false)
     , payload_resized_(false)
     , n_packets_(0)
+    , n_restored_packets_(0)
     , max_sbn_jump_(config.max_sbn_jump)
+    , incremental_decoding_(config.incremental_decoding)
     , fec_scheme_(fec_scheme) {
     valid_ = true;
 }
 
+Reader::~Reader() {
+    end_decoding_();
+}
+
 bool Reader::valid() const {
     return valid_;
 }
@@ -59,6 +67,10 @@ bool Reader::alive() const {
     return alive_;
 }
 
+size_t Reader::n_restored_packets() const {
+    return n_restored_packets_;
+}
+
 packet::PacketPtr Reader::read() {
     roc_panic_if_not(valid());
     if (!alive_) {
@@ -127,7 +139,9 @@ packet::PacketPtr Reader::get_next_packet_() {
         }
 
         if (!pp) {
-            try_repair_();
+            if (!incremental_decoding_) {
+                try_repair_();
+            }
 
             size_t pos;
             for (pos = next_packet_; pos < source_block_.size(); pos++) {
@@ -160,6 +174,8 @@ packet::PacketPtr Reader::get_next_packet_() {
 void Reader::next_block_() {
     roc_log(LogTrace, "fec reader: next block: sbn=%lu", (unsigned long)cur_sbn_);
 
+    end_decoding_();
+
     for (size_t n = 0; n < source_block_.size(); n++) {
         source_block_[n] = NULL;
     }
@@ -229,12 +245,99 @@ void Reader::try_repair_() {
         }
 
         source_block_[n] = pp;
+        n_restored_packets_++;
     }
 
     decoder_.end();
     can_repair_ = false;
 }
 
+void Reader::begin_decoding_() {
+    if (decoding_) {
+        return;
+    }
+
+    if (!source_block_resized_ || !repair_block_resized_ || !payload_resized_) {
+        return;
+    }
+
+    if (!decoder_.begin(source_block_.size(), repair_block_.size(), payload_size_)) {
+        roc_log(LogDebug,
+                "fec reader: can't begin decoder block, shutting down:"
+                " sbl=%lu rbl=%lu payload_size=%lu",
+                (unsigned long)source_block_.size(), (unsigned long)repair_block_.size(),
+                (unsigned long)payload_size_);
+        alive_ = false;
+        return;
+    }
+
+    decoding_ = true;
+    n_decoder_packets_ = 0;
+
+    // pass packets received before block sizes became known,
+    // following packets are passed when they're added to block
+    for (size_t n = 0; n < source_block_.size(); n++) {
+        if (!source_block_[n]) {
+            continue;
+        }
+        decoder_.set(n, source_block_[n]->fec()->payload);
+        n_decoder_packets_++;
+    }
+
+    for (size_t n = 0; n < repair_block_.size(); n++) {
+        if (!repair_block_[n]) {
+            continue;
+        }
+        decoder_.set(source_block_.size() + n, repair_block_[n]->fec()->payload);
+        n_decoder_packets_++;
+    }
+}
+
+void Reader::end_decoding_() {
+    if (!decoding_) {
+        return;
+    }
+
+    decoder_.end();
+
+    decoding_ = false;
+    n_decoder_packets_ = 0;
+}
+
+void Reader::decode_incrementally_() {
+    begin_decoding_();
+
+    if (!decoding_ || !can_repair_) {
+        return;
+    }
+
+    // no codec can restore anything with fewer packets than block length
+    if (n_decoder_packets_ < source_block_.size()) {
+        return;
+    }
+
+    for (size_t n = next_packet_; n < source_block_.size(); n++) {
+        if (source_block_[n]) {
+            continue;
+        }
+
+        core::Slice<uint8_t> buffer = decoder_.repair(n);
+        if (!buffer) {
+            continue;
+        }
+
+        packet::PacketPtr pp = parse_repaired_packet_(buffer);
+        if (!pp) {
+            continue;
+        }
+
+        source_block_[n] = pp;
+        n_restored_packets_++;
+    }
+
+    can_repair_ = false;
+}
+
 packet::PacketPtr Reader::parse_repaired_packet_(const core::Slice<uint8_t>& buffer) {
     packet::PacketPtr pp = packet_factory_.new_packet();
     if (!pp) {
@@ -280,6 +383,10 @@ void Reader::fetch_packets_() {
 void Reader::fill_block_() {
     fill_source_block_();
     fill_repair_block_();
+
+    if (incremental_decoding_ && alive_) {
+        decode_incrementally_();
+    }
 }
 
 void Reader::fill_source_block_() {
@@ -338,6 +445,11 @@ void Reader::fill_source_block_() {
             can_repair_ = true;
             source_block_[p_num] = pp;
             n_added++;
+
+            if (decoding_) {
+                decoder_.set(p_num, fec.payload);
+                n_decoder_packets_++;
+            }
         }
     }
 
@@ -404,6 +516,11 @@ void Reader::fill_repair_block_() {
             can_repair_ = true;
             repair_block_[p_num] = pp;
             n_added++;
+
+            if (decoding_) {
+                decoder_.set(source_block_.size() + p_num, fec.payload);
+                n_decoder_packets_++;
+            }
         }
     }
 
@@ -31,8 +31,19 @@ struct ReaderConfig {
     //! Maximum allowed source block number jump.
     size_t max_sbn_jump;
 
+    //! Feed packets to decoder as soon as they are fetched.
+    //! @remarks
+    //!  If disabled, decoding of a block is performed when reader reaches
+    //!  a lost packet. If enabled, decoder session is kept open during the
+    //!  whole block, every packet is passed to decoder when it's fetched,
+    //!  and decoding is triggered as soon as enough packets are received.
+    //!  This spreads decoding work across reads and makes restored packets
+    //!  available earlier.
+    bool incremental_decoding;
+
     ReaderConfig()
-        : max_sbn_jump(100) {
+        : max_sbn_jump(100)
+        , incremental_decoding(false) {
     }
 };
 
@@ -57,6 +68,8 @@ public:
            packet::PacketFactory& packet_factory,
            core::IAllocator& allocator);
 
+    virtual ~Reader();
+
     //! Check if object is successfully constructed.
     bool valid() const;
 
@@ -71,6 +84,9 @@ public:
     //!  When a packet loss is detected, try to restore it from repair packets.
     virtual packet::PacketPtr read();
 
+    //! Get number of packets restored from repair packets so far.
+    size_t n_restored_packets() const;
+
 private:
     packet::PacketPtr read_();
 
@@ -80,6 +96,10 @@ private:
     void next_block_();
     void try_repair_();
 
+    void begin_decoding_();
+    void end_decoding_();
+    void decode_incrementally_();
+
     packet::PacketPtr parse_repaired_packet_(const core::Slice<uint8_t>& buffer);
 
     void fetch_packets_();
@@ -126,6 +146,9 @@ private:
     bool started_;
     bool can_repair_;
 
+    bool decoding_;
+    size_t n_decoder_packets_;
+
     size_t next_packet_;
     packet::blknum_t cur_sbn_;
 
@@ -136,8 +159,10 @@ private:
     bool payload_resized_;
 
     unsigned n_packets_;
+    size_t n_restored_packets_;
 
     const size_t max_sbn_jump_;
+    const bool incremental_decoding_;
     const packet::FecScheme fec_scheme_;
 };
 
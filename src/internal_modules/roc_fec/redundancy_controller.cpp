@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/redundancy_controller.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+// Higher loss rates can't be handled by block codes anyway.
+const float MaxLossRate = 0.5f;
+
+} // namespace
+
+RedundancyController::RedundancyController(const RedundancyConfig& config,
+                                           size_t n_source_packets,
+                                           size_t n_repair_packets)
+    : config_(config)
+    , n_source_packets_(n_source_packets)
+    , loss_rate_(0)
+    , n_repair_packets_(n_repair_packets)
+    , has_report_(false)
+    , report_cum_loss_(0)
+    , report_last_seqnum_(0)
+    , valid_(false) {
+    if (n_source_packets_ == 0) {
+        roc_log(LogError, "fec redundancy controller: number of source packets is zero");
+        return;
+    }
+
+    if (config_.min_repair_packets > config_.max_repair_packets) {
+        roc_log(LogError,
+                "fec redundancy controller: invalid repair packets range:"
+                " min=%lu max=%lu",
+                (unsigned long)config_.min_repair_packets,
+                (unsigned long)config_.max_repair_packets);
+        return;
+    }
+
+    if (config_.loss_margin < 0 || !(config_.loss_rise_factor > 0)
+        || config_.loss_rise_factor > 1 || !(config_.loss_fall_factor > 0)
+        || config_.loss_fall_factor > 1) {
+        roc_log(LogError,
+                "fec redundancy controller: invalid parameters:"
+                " loss_margin=%.3f loss_rise_factor=%.3f loss_fall_factor=%.3f",
+                (double)config_.loss_margin, (double)config_.loss_rise_factor,
+                (double)config_.loss_fall_factor);
+        return;
+    }
+
+    if (n_repair_packets_ < config_.min_repair_packets) {
+        n_repair_packets_ = config_.min_repair_packets;
+    }
+    if (n_repair_packets_ > config_.max_repair_packets) {
+        n_repair_packets_ = config_.max_repair_packets;
+    }
+
+    roc_log(LogDebug,
+            "fec redundancy controller: initializing:"
+            " sblen=%lu rblen=%lu min_rblen=%lu max_rblen=%lu",
+            (unsigned long)n_source_packets_, (unsigned long)n_repair_packets_,
+            (unsigned long)config_.min_repair_packets,
+            (unsigned long)config_.max_repair_packets);
+
+    valid_ = true;
+}
+
+bool RedundancyController::valid() const {
+    return valid_;
+}
+
+float RedundancyController::loss_rate() const {
+    roc_panic_if_not(valid());
+
+    return loss_rate_;
+}
+
+size_t RedundancyController::n_repair_packets() const {
+    roc_panic_if_not(valid());
+
+    return n_repair_packets_;
+}
+
+bool RedundancyController::update(float fract_loss) {
+    roc_panic_if_not(valid());
+
+    if (!(fract_loss > 0)) {
+        fract_loss = 0;
+    }
+    if (fract_loss > MaxLossRate) {
+        fract_loss = MaxLossRate;
+    }
+
+    const float factor =
+        fract_loss > loss_rate_ ? config_.loss_rise_factor : config_.loss_fall_factor;
+
+    loss_rate_ += (fract_loss - loss_rate_) * factor;
+
+    const size_t n_repair = compute_n_repair_();
+
+    if (n_repair == n_repair_packets_) {
+        return false;
+    }
+
+    roc_log(LogDebug,
+            "fec redundancy controller: update repair packets:"
+            " reported_loss=%.4f smoothed_loss=%.4f old_rblen=%lu new_rblen=%lu",
+            (double)fract_loss, (double)loss_rate_, (unsigned long)n_repair_packets_,
+            (unsigned long)n_repair);
+
+    n_repair_packets_ = n_repair;
+
+    return true;
+}
+
+bool RedundancyController::update(float fract_loss,
+                                  int64_t cum_loss,
+                                  uint32_t ext_last_seqnum) {
+    roc_panic_if_not(valid());
+
+    float loss = fract_loss;
+
+    if (has_report_) {
+        // sequence numbers are compared modulo 2^32, as in RFC 3550
+        const int64_t n_expected = (int32_t)(ext_last_seqnum - report_last_seqnum_);
+        const int64_t n_lost = cum_loss - report_cum_loss_;
+
+        if (n_expected > 0 && n_lost >= 0) {
+            loss = n_lost < n_expected ? float(n_lost) / float(n_expected) : 1;
+        } else if (n_expected == 0 && n_lost == 0) {
+            // nothing was received since previous report
+            return false;
+        }
+    }
+
+    has_report_ = true;
+    report_cum_loss_ = cum_loss;
+    report_last_seqnum_ = ext_last_seqnum;
+
+    return update(loss);
+}
+
+size_t RedundancyController::compute_n_repair_() const {
+    // With loss rate L, a block of S source and R repair packets loses
+    // L * (S + R) packets on average, so R = L * S / (1 - L) repair
+    // packets are needed to cover the average loss.
+    const float expected_loss =
+        config_.loss_margin * loss_rate_ * (float)n_source_packets_ / (1 - loss_rate_);
+
+    const float max_extra =
+        (float)(config_.max_repair_packets - config_.min_repair_packets);
+
+    if (expected_loss >= max_extra) {
+        return config_.max_repair_packets;
+    }
+
+    // round to nearest, so that slowly decaying loss rate eventually
+    // brings redundancy back to minimum
+    return config_.min_repair_packets + (size_t)(expected_loss + 0.5f);
+}
+
+} // namespace fec
+} // namespace roc
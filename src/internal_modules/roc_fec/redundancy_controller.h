@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/redundancy_controller.h
+//! @brief FEC redundancy controller.
+
+#ifndef ROC_FEC_REDUNDANCY_CONTROLLER_H_
+#define ROC_FEC_REDUNDANCY_CONTROLLER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace fec {
+
+//! FEC redundancy controller parameters.
+struct RedundancyConfig {
+    //! Adjust number of repair packets according to reported losses.
+    bool enabled;
+
+    //! Minimum number of repair packets per block.
+    size_t min_repair_packets;
+
+    //! Maximum number of repair packets per block.
+    size_t max_repair_packets;
+
+    //! Multiplier for expected number of lost packets per block.
+    //! @remarks
+    //!  Values above 1 provide headroom for loss bursts and for loss rate
+    //!  fluctuations between reports.
+    float loss_margin;
+
+    //! Smoothing factor applied when reported loss rate grows, in (0; 1].
+    float loss_rise_factor;
+
+    //! Smoothing factor applied when reported loss rate drops, in (0; 1].
+    float loss_fall_factor;
+
+    RedundancyConfig()
+        : enabled(false)
+        , min_repair_packets(2)
+        , max_repair_packets(40)
+        , loss_margin(2.0f)
+        , loss_rise_factor(0.5f)
+        , loss_fall_factor(0.1f) {
+    }
+};
+
+//! FEC redundancy controller.
+//!
+//! Computes number of repair packets per block from loss rate reported
+//! by receivers. Reported loss rate is smoothed asymmetrically: increases
+//! are followed quickly, so that redundancy grows as soon as the link
+//! degrades or a loss burst is reported, and decreases are followed
+//! slowly, so that redundancy is not dropped after a few good reports
+//! between bursts.
+class RedundancyController : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p config defines controller parameters
+    //!  - @p n_source_packets defines number of source packets per block
+    //!  - @p n_repair_packets defines initial number of repair packets per block
+    RedundancyController(const RedundancyConfig& config,
+                         size_t n_source_packets,
+                         size_t n_repair_packets);
+
+    //! Check if object is successfully constructed.
+    bool valid() const;
+
+    //! Get smoothed loss rate.
+    float loss_rate() const;
+
+    //! Get current number of repair packets per block.
+    size_t n_repair_packets() const;
+
+    //! Update controller with reported fraction of lost packets.
+    //! @returns
+    //!  true if number of repair packets was changed.
+    bool update(float fract_loss);
+
+    //! Update controller with reception report.
+    //!
+    //! @b Parameters
+    //!  - @p fract_loss defines fraction of packets lost since previous report
+    //!  - @p cum_loss defines cumulative number of lost packets
+    //!  - @p ext_last_seqnum defines extended highest sequence number received
+    //!
+    //! @remarks
+    //!  Loss rate is computed from the growth of cumulative loss and of
+    //!  highest sequence number since previous report passed here. Unlike
+    //!  reported fraction, it's not quantized and accounts losses from
+    //!  reports that were lost themselves. Reported fraction is used for
+    //!  the first report and when counters went backwards, e.g. when the
+    //!  receiver restarted or the reports came from different receivers.
+    //!
+    //! @returns
+    //!  true if number of repair packets was changed.
+    bool update(float fract_loss, int64_t cum_loss, uint32_t ext_last_seqnum);
+
+private:
+    size_t compute_n_repair_() const;
+
+    const RedundancyConfig config_;
+    const size_t n_source_packets_;
+
+    float loss_rate_;
+    size_t n_repair_packets_;
+
+    bool has_report_;
+    int64_t report_cum_loss_;
+    uint32_t report_last_seqnum_;
+
+    bool valid_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_REDUNDANCY_CONTROLLER_H_
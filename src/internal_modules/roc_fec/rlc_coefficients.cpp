@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/rlc_coefficients.h"
+#include "roc_core/panic.h"
+#include "roc_fec/tinymt32.h"
+
+namespace roc {
+namespace fec {
+
+void rlc_coefficients(uint16_t repair_key, uint8_t* coefs, size_t n_coefs) {
+    roc_panic_if(!coefs);
+
+    Tinymt32 rand(repair_key);
+
+    for (size_t n = 0; n < n_coefs; n++) {
+        do {
+            coefs[n] = (uint8_t)(rand.next() & 0xff);
+        } while (coefs[n] == 0);
+    }
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/rlc_coefficients.h
+//! @brief RLC coding coefficients.
+
+#ifndef ROC_FEC_RLC_COEFFICIENTS_H_
+#define ROC_FEC_RLC_COEFFICIENTS_H_
+
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace fec {
+
+//! Maximum number of source packets in RLC encoding window.
+const size_t RlcMaxWindowLength = 256;
+
+//! Generate RLC coding coefficients.
+//! @remarks
+//!  Fills @p coefs with @p n_coefs non-zero GF(2^8) elements derived from
+//!  @p repair_key, as specified in RFC 8681 for dense codes (DT=15).
+//!  The i-th coefficient corresponds to the i-th source packet of the
+//!  encoding window.
+void rlc_coefficients(uint16_t repair_key, uint8_t* coefs, size_t n_coefs);
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_RLC_COEFFICIENTS_H_
@@ -0,0 +1,599 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/rlc_reader.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_fec/gf256.h"
+#include "roc_fec/rlc_coefficients.h"
+#include "roc_packet/fec_scheme_to_str.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+int32_t esi_diff(uint32_t a, uint32_t b) {
+    return int32_t(a - b);
+}
+
+} // namespace
+
+RlcReader::RlcReader(packet::FecScheme fec_scheme,
+                     packet::IReader& source_reader,
+                     packet::IReader& repair_reader,
+                     packet::IParser& parser,
+                     packet::PacketFactory& packet_factory,
+                     core::BufferFactory<uint8_t>& buffer_factory,
+                     core::IAllocator& allocator)
+    : source_reader_(source_reader)
+    , repair_reader_(repair_reader)
+    , parser_(parser)
+    , packet_factory_(packet_factory)
+    , buffer_factory_(buffer_factory)
+    , source_queue_(0)
+    , history_(allocator)
+    , repair_packets_(allocator)
+    , matrix_(allocator)
+    , rhs_(allocator)
+    , pivots_(allocator)
+    , coefs_(allocator)
+    , first_col_esi_(0)
+    , n_cols_(0)
+    , payload_size_(0)
+    , next_esi_(0)
+    , valid_(false)
+    , alive_(true)
+    , started_(false)
+    , has_new_packets_(false)
+    , n_restored_packets_(0)
+    , fec_scheme_(fec_scheme) {
+    if (!history_.resize(HistoryLength) || !repair_packets_.grow(MaxRepairPackets)
+        || !rhs_.grow(MaxRepairPackets) || !pivots_.grow(MaxRepairPackets)
+        || !coefs_.resize(RlcMaxWindowLength)) {
+        roc_log(LogError, "rlc reader: can't allocate history");
+        return;
+    }
+    valid_ = true;
+}
+
+bool RlcReader::valid() const {
+    return valid_;
+}
+
+bool RlcReader::started() const {
+    return started_;
+}
+
+bool RlcReader::alive() const {
+    return alive_;
+}
+
+size_t RlcReader::n_restored_packets() const {
+    return n_restored_packets_;
+}
+
+packet::PacketPtr RlcReader::read() {
+    roc_panic_if_not(valid());
+    if (!alive_) {
+        return NULL;
+    }
+    packet::PacketPtr pp = read_();
+    // check if alive_ has changed
+    return (alive_ ? pp : NULL);
+}
+
+packet::PacketPtr RlcReader::read_() {
+    fetch_packets_();
+
+    if (!started_) {
+        packet::PacketPtr pp = source_queue_.head();
+        if (!pp) {
+            return NULL;
+        }
+
+        next_esi_ = (uint32_t)pp->fec()->encoding_symbol_id;
+        started_ = true;
+
+        roc_log(LogDebug, "rlc reader: got first packet, start decoding: esi=%lu",
+                (unsigned long)next_esi_);
+    }
+
+    fill_history_();
+    drop_repair_packets_();
+
+    Symbol* sym = find_symbol_(next_esi_);
+
+    if (!sym) {
+        try_repair_();
+        sym = find_symbol_(next_esi_);
+    }
+
+    if (!sym) {
+        if (!skip_lost_packet_()) {
+            return NULL;
+        }
+        sym = find_symbol_(next_esi_);
+        roc_panic_if(!sym);
+    }
+
+    next_esi_++;
+
+    if (sym->packet->flags() & packet::Packet::FlagRestored) {
+        n_restored_packets_++;
+    }
+
+    return sym->packet;
+}
+
+void RlcReader::fetch_packets_() {
+    for (;;) {
+        if (packet::PacketPtr pp = source_reader_.read()) {
+            if (!validate_fec_packet_(pp)) {
+                return;
+            }
+            source_queue_.write(pp);
+        } else {
+            break;
+        }
+    }
+
+    for (;;) {
+        if (packet::PacketPtr pp = repair_reader_.read()) {
+            if (!validate_fec_packet_(pp)) {
+                return;
+            }
+            add_repair_packet_(pp);
+        } else {
+            break;
+        }
+    }
+}
+
+void RlcReader::fill_history_() {
+    for (;;) {
+        packet::PacketPtr pp = source_queue_.head();
+        if (!pp) {
+            break;
+        }
+
+        const uint32_t esi = (uint32_t)pp->fec()->encoding_symbol_id;
+
+        if (!validate_esi_sequence_(esi)) {
+            break;
+        }
+
+        if (!in_history_(esi)) {
+            if (esi_diff(esi, next_esi_) > 0) {
+                // too far ahead, keep in queue until history moves forward
+                break;
+            }
+
+            roc_log(LogTrace, "rlc reader: dropping late source packet: esi=%lu",
+                    (unsigned long)esi);
+            (void)source_queue_.read();
+            continue;
+        }
+
+        (void)source_queue_.read();
+
+        if (find_symbol_(esi)) {
+            roc_log(LogTrace,
+                    "rlc reader: dropping duplicate or already restored packet:"
+                    " esi=%lu",
+                    (unsigned long)esi);
+            continue;
+        }
+
+        put_symbol_(esi, pp, pp->fec()->payload);
+        has_new_packets_ = true;
+    }
+}
+
+void RlcReader::drop_repair_packets_() {
+    size_t n_kept = 0;
+
+    for (size_t n = 0; n < repair_packets_.size(); n++) {
+        const packet::FEC& fec = *repair_packets_[n]->fec();
+
+        const uint32_t end_esi =
+            uint32_t(fec.encoding_symbol_id + fec.source_block_length);
+
+        // all source packets of the window were already returned
+        if (esi_diff(end_esi, next_esi_) <= 0) {
+            continue;
+        }
+
+        repair_packets_[n_kept++] = repair_packets_[n];
+    }
+
+    if (!repair_packets_.resize(n_kept)) {
+        roc_panic("rlc reader: can't shrink repair packets array");
+    }
+}
+
+bool RlcReader::skip_lost_packet_() {
+    uint32_t esi = next_esi_ + 1;
+
+    for (; in_history_(esi); esi++) {
+        if (find_symbol_(esi)) {
+            break;
+        }
+    }
+
+    if (!in_history_(esi)) {
+        packet::PacketPtr pp = source_queue_.head();
+        if (!pp) {
+            return false;
+        }
+
+        esi = (uint32_t)pp->fec()->encoding_symbol_id;
+    }
+
+    roc_log(LogDebug, "rlc reader: can't repair packet, skipping: esi=%lu n_lost=%lu",
+            (unsigned long)next_esi_, (unsigned long)uint32_t(esi - next_esi_));
+
+    next_esi_ = esi;
+    fill_history_();
+
+    return true;
+}
+
+void RlcReader::try_repair_() {
+    if (!has_new_packets_) {
+        return;
+    }
+    has_new_packets_ = false;
+
+    if (add_equations_()) {
+        eliminate_();
+        restore_symbols_();
+    }
+
+    if (!rhs_.resize(0) || !pivots_.resize(0)) {
+        roc_panic("rlc reader: can't shrink linear system");
+    }
+}
+
+bool RlcReader::add_equations_() {
+    const packet::FEC* first_fec = NULL;
+
+    uint32_t min_esi = 0, max_esi = 0;
+
+    // find range of source packets covered by usable repair packets
+    for (size_t n = 0; n < repair_packets_.size(); n++) {
+        const packet::FEC& fec = *repair_packets_[n]->fec();
+
+        const uint32_t first_esi = (uint32_t)fec.encoding_symbol_id;
+        const uint32_t last_esi = uint32_t(first_esi + fec.source_block_length - 1);
+
+        if (!in_history_(first_esi) || !in_history_(last_esi)) {
+            continue;
+        }
+
+        if (!first_fec) {
+            first_fec = &fec;
+            min_esi = first_esi;
+            max_esi = last_esi;
+        } else {
+            if (esi_diff(first_esi, min_esi) < 0) {
+                min_esi = first_esi;
+            }
+            if (esi_diff(last_esi, max_esi) > 0) {
+                max_esi = last_esi;
+            }
+        }
+    }
+
+    if (!first_fec || esi_diff(next_esi_, min_esi) < 0
+        || esi_diff(next_esi_, max_esi) > 0) {
+        return false;
+    }
+
+    first_col_esi_ = min_esi;
+    n_cols_ = size_t(uint32_t(max_esi - min_esi)) + 1;
+    payload_size_ = first_fec->payload.size();
+
+    if (!matrix_.resize(repair_packets_.size() * n_cols_)) {
+        roc_log(LogError, "rlc reader: can't allocate matrix");
+        return false;
+    }
+
+    for (size_t n = 0; n < repair_packets_.size(); n++) {
+        if (!add_equation_(*repair_packets_[n]->fec())) {
+            return false;
+        }
+    }
+
+    return rhs_.size() != 0;
+}
+
+bool RlcReader::add_equation_(const packet::FEC& fec) {
+    const uint32_t first_esi = (uint32_t)fec.encoding_symbol_id;
+    const size_t nss = fec.source_block_length;
+
+    if (!in_history_(first_esi) || !in_history_(uint32_t(first_esi + nss - 1))) {
+        return true;
+    }
+
+    if (fec.payload.size() != payload_size_) {
+        return true;
+    }
+
+    size_t n_unknown = 0;
+
+    for (size_t i = 0; i < nss; i++) {
+        const Symbol* sym = find_symbol_(uint32_t(first_esi + i));
+        if (!sym) {
+            n_unknown++;
+        } else if (sym->payload.size() != payload_size_) {
+            return true;
+        }
+    }
+
+    if (n_unknown == 0) {
+        return true;
+    }
+
+    core::Slice<uint8_t> rhs = make_buffer_(payload_size_);
+    if (!rhs) {
+        return false;
+    }
+
+    memcpy(rhs.data(), fec.payload.data(), payload_size_);
+
+    uint8_t* row = matrix_.data() + rhs_.size() * n_cols_;
+    memset(row, 0, n_cols_);
+
+    rlc_coefficients(fec.source_block_number, coefs_.data(), nss);
+
+    const Gf256& gf = Gf256::instance();
+
+    // move known source packets to the right side of the equation
+    for (size_t i = 0; i < nss; i++) {
+        const uint32_t esi = uint32_t(first_esi + i);
+
+        if (const Symbol* sym = find_symbol_(esi)) {
+            gf.mul_add(rhs.data(), sym->payload.data(), coefs_[i], payload_size_);
+        } else {
+            row[uint32_t(esi - first_col_esi_)] = coefs_[i];
+        }
+    }
+
+    rhs_.push_back(rhs);
+
+    return true;
+}
+
+void RlcReader::eliminate_() {
+    const Gf256& gf = Gf256::instance();
+
+    const size_t n_rows = rhs_.size();
+
+    for (size_t col = 0; col < n_cols_ && pivots_.size() < n_rows; col++) {
+        const size_t prow = pivots_.size();
+
+        size_t row = prow;
+        for (; row < n_rows; row++) {
+            if (matrix_[row * n_cols_ + col] != 0) {
+                break;
+            }
+        }
+
+        if (row == n_rows) {
+            continue;
+        }
+
+        uint8_t* pivot = matrix_.data() + prow * n_cols_;
+
+        if (row != prow) {
+            uint8_t* other = matrix_.data() + row * n_cols_;
+            for (size_t j = col; j < n_cols_; j++) {
+                const uint8_t tmp = pivot[j];
+                pivot[j] = other[j];
+                other[j] = tmp;
+            }
+
+            const core::Slice<uint8_t> tmp = rhs_[prow];
+            rhs_[prow] = rhs_[row];
+            rhs_[row] = tmp;
+        }
+
+        const uint8_t inv = gf.inv(pivot[col]);
+
+        for (size_t j = col; j < n_cols_; j++) {
+            pivot[j] = gf.mul(pivot[j], inv);
+        }
+
+        // x + (inv + 1) * x = inv * x, so this scales the region in place
+        gf.mul_add(rhs_[prow].data(), rhs_[prow].data(), uint8_t(inv ^ 1),
+                   payload_size_);
+
+        for (size_t r = 0; r < n_rows; r++) {
+            uint8_t* other = matrix_.data() + r * n_cols_;
+
+            const uint8_t coef = other[col];
+            if (r == prow || coef == 0) {
+                continue;
+            }
+
+            for (size_t j = col; j < n_cols_; j++) {
+                other[j] ^= gf.mul(coef, pivot[j]);
+            }
+
+            gf.mul_add(rhs_[r].data(), rhs_[prow].data(), coef, payload_size_);
+        }
+
+        pivots_.push_back(col);
+    }
+}
+
+void RlcReader::restore_symbols_() {
+    for (size_t row = 0; row < pivots_.size(); row++) {
+        const size_t col = pivots_[row];
+        const uint8_t* coefs = matrix_.data() + row * n_cols_;
+
+        // source packet is restored if no other unknowns are left in its row
+        size_t j = col + 1;
+        for (; j < n_cols_; j++) {
+            if (coefs[j] != 0) {
+                break;
+            }
+        }
+
+        if (j != n_cols_) {
+            continue;
+        }
+
+        const uint32_t esi = uint32_t(first_col_esi_ + col);
+
+        packet::PacketPtr pp = parse_repaired_packet_(rhs_[row]);
+        if (!pp) {
+            continue;
+        }
+
+        roc_log(LogTrace, "rlc reader: restored packet: esi=%lu", (unsigned long)esi);
+
+        put_symbol_(esi, pp, rhs_[row]);
+    }
+}
+
+packet::PacketPtr RlcReader::parse_repaired_packet_(const core::Slice<uint8_t>& buffer) {
+    packet::PacketPtr pp = packet_factory_.new_packet();
+    if (!pp) {
+        roc_log(LogError, "rlc reader: can't allocate packet");
+        return NULL;
+    }
+
+    if (!parser_.parse(*pp, buffer)) {
+        roc_log(LogDebug, "rlc reader: can't parse repaired packet");
+        return NULL;
+    }
+
+    pp->set_data(buffer);
+    pp->add_flags(packet::Packet::FlagRestored);
+
+    return pp;
+}
+
+core::Slice<uint8_t> RlcReader::make_buffer_(size_t payload_size) {
+    core::Slice<uint8_t> buffer = buffer_factory_.new_buffer();
+
+    if (!buffer) {
+        roc_log(LogError, "rlc reader: can't allocate buffer");
+        return core::Slice<uint8_t>();
+    }
+
+    if (buffer.capacity() < payload_size) {
+        roc_log(LogError, "rlc reader: packet size too large: size=%lu max=%lu",
+                (unsigned long)payload_size, (unsigned long)buffer.capacity());
+        return core::Slice<uint8_t>();
+    }
+
+    buffer.reslice(0, payload_size);
+
+    return buffer;
+}
+
+void RlcReader::add_repair_packet_(const packet::PacketPtr& pp) {
+    const packet::FEC& fec = *pp->fec();
+
+    if (fec.source_block_length == 0 || fec.source_block_length > RlcMaxWindowLength
+        || fec.payload.size() == 0) {
+        roc_log(LogTrace, "rlc reader: dropping invalid repair packet: nss=%lu size=%lu",
+                (unsigned long)fec.source_block_length,
+                (unsigned long)fec.payload.size());
+        return;
+    }
+
+    if (repair_packets_.size() == MaxRepairPackets) {
+        // drop oldest repair packet
+        for (size_t n = 1; n < repair_packets_.size(); n++) {
+            repair_packets_[n - 1] = repair_packets_[n];
+        }
+        if (!repair_packets_.resize(repair_packets_.size() - 1)) {
+            roc_panic("rlc reader: can't shrink repair packets array");
+        }
+    }
+
+    repair_packets_.push_back(pp);
+    has_new_packets_ = true;
+}
+
+bool RlcReader::validate_fec_packet_(const packet::PacketPtr& pp) {
+    const packet::FEC* fec = pp->fec();
+
+    if (!fec) {
+        roc_panic("rlc reader: unexpected non-fec packet");
+    }
+
+    if (fec->fec_scheme != fec_scheme_) {
+        roc_log(LogDebug,
+                "rlc reader: unexpected packet fec scheme, shutting down:"
+                " packet_scheme=%s session_scheme=%s",
+                packet::fec_scheme_to_str(fec->fec_scheme),
+                packet::fec_scheme_to_str(fec_scheme_));
+        return (alive_ = false);
+    }
+
+    return true;
+}
+
+bool RlcReader::validate_esi_sequence_(uint32_t esi) {
+    int32_t dist = esi_diff(esi, next_esi_);
+
+    if (dist < 0) {
+        dist = -dist;
+    }
+
+    if (dist > MaxEsiJump) {
+        roc_log(LogDebug,
+                "rlc reader: too long encoding symbol id jump, shutting down:"
+                " cur_esi=%lu pkt_esi=%lu dist=%lu max=%lu",
+                (unsigned long)next_esi_, (unsigned long)esi, (unsigned long)dist,
+                (unsigned long)MaxEsiJump);
+        return (alive_ = false);
+    }
+
+    return true;
+}
+
+RlcReader::Symbol* RlcReader::find_symbol_(uint32_t esi) {
+    if (!in_history_(esi)) {
+        return NULL;
+    }
+
+    Symbol& sym = history_[esi % HistoryLength];
+
+    if (!sym.packet || sym.esi != esi) {
+        return NULL;
+    }
+
+    return &sym;
+}
+
+void RlcReader::put_symbol_(uint32_t esi,
+                            const packet::PacketPtr& pp,
+                            const core::Slice<uint8_t>& payload) {
+    roc_panic_if(!in_history_(esi));
+
+    Symbol& sym = history_[esi % HistoryLength];
+
+    sym.esi = esi;
+    sym.packet = pp;
+    sym.payload = payload;
+}
+
+bool RlcReader::in_history_(uint32_t esi) const {
+    const uint32_t history_begin = uint32_t(next_esi_ - RlcMaxWindowLength);
+
+    return uint32_t(esi - history_begin) < HistoryLength;
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/rlc_reader.h
+//! @brief Sliding window RLC FEC reader.
+
+#ifndef ROC_FEC_RLC_READER_H_
+#define ROC_FEC_RLC_READER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/buffer_factory.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/slice.h"
+#include "roc_packet/iparser.h"
+#include "roc_packet/ireader.h"
+#include "roc_packet/packet.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_packet/sorted_queue.h"
+
+namespace roc {
+namespace fec {
+
+//! Sliding window RLC FEC reader.
+//!
+//! Counterpart of RlcWriter. Source packets are returned in order of their
+//! encoding symbol IDs. When the next source packet is missing, the reader
+//! builds a linear system from the repair packets whose encoding windows
+//! cover it, and solves it using Gauss-Jordan elimination over GF(2^8).
+//! If the packet can't be restored, it is skipped as soon as a following
+//! source packet is available.
+//!
+//! Since repair packets cover only a window of the last source packets,
+//! a loss can be repaired after a window length, not after a whole block.
+class RlcReader : public packet::IReader, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p source_reader specifies input queue with data packets;
+    //!  - @p repair_reader specifies input queue with FEC packets;
+    //!  - @p parser specifies packet parser for restored packets.
+    //!  - @p packet_factory is used to allocate restored packets
+    //!  - @p buffer_factory is used to allocate buffers for restored packets
+    //!  - @p allocator is used to initialize internal arrays
+    RlcReader(packet::FecScheme fec_scheme,
+              packet::IReader& source_reader,
+              packet::IReader& repair_reader,
+              packet::IParser& parser,
+              packet::PacketFactory& packet_factory,
+              core::BufferFactory<uint8_t>& buffer_factory,
+              core::IAllocator& allocator);
+
+    //! Check if object is successfully constructed.
+    bool valid() const;
+
+    //! Did reader receive first source packet?
+    bool started() const;
+
+    //! Is reader alive?
+    bool alive() const;
+
+    //! Read packet.
+    //! @remarks
+    //!  When a packet loss is detected, try to restore it from repair packets.
+    virtual packet::PacketPtr read();
+
+    //! Get number of packets restored from repair packets so far.
+    size_t n_restored_packets() const;
+
+private:
+    // Number of source packets kept in memory. Covers encoding windows
+    // of repair packets preceding the next packet, and source packets
+    // that arrived ahead of it.
+    enum { HistoryLength = 1024 };
+
+    // Maximum number of repair packets kept in memory.
+    enum { MaxRepairPackets = 256 };
+
+    // Maximum allowed jump of encoding symbol ID.
+    enum { MaxEsiJump = 16 * HistoryLength };
+
+    struct Symbol {
+        uint32_t esi;
+        packet::PacketPtr packet;
+        core::Slice<uint8_t> payload;
+    };
+
+    packet::PacketPtr read_();
+
+    void fetch_packets_();
+    void fill_history_();
+    void drop_repair_packets_();
+
+    bool skip_lost_packet_();
+
+    void try_repair_();
+    bool add_equations_();
+    bool add_equation_(const packet::FEC& fec);
+    void eliminate_();
+    void restore_symbols_();
+
+    packet::PacketPtr parse_repaired_packet_(const core::Slice<uint8_t>& buffer);
+    core::Slice<uint8_t> make_buffer_(size_t payload_size);
+
+    void add_repair_packet_(const packet::PacketPtr&);
+
+    bool validate_fec_packet_(const packet::PacketPtr&);
+    bool validate_esi_sequence_(uint32_t esi);
+
+    Symbol* find_symbol_(uint32_t esi);
+    void put_symbol_(uint32_t esi,
+                     const packet::PacketPtr& pp,
+                     const core::Slice<uint8_t>& payload);
+
+    bool in_history_(uint32_t esi) const;
+
+    packet::IReader& source_reader_;
+    packet::IReader& repair_reader_;
+    packet::IParser& parser_;
+    packet::PacketFactory& packet_factory_;
+    core::BufferFactory<uint8_t>& buffer_factory_;
+
+    packet::SortedQueue source_queue_;
+
+    // ring buffer of source packets, indexed by esi
+    core::Array<Symbol> history_;
+
+    core::Array<packet::PacketPtr> repair_packets_;
+
+    // linear system built during repair; there is a row per repair packet
+    // and a column per source packet in range [first_col_esi_; +n_cols_)
+    core::Array<uint8_t> matrix_;
+    core::Array<core::Slice<uint8_t> > rhs_;
+    core::Array<size_t> pivots_;
+    core::Array<uint8_t> coefs_;
+    uint32_t first_col_esi_;
+    size_t n_cols_;
+    size_t payload_size_;
+
+    uint32_t next_esi_;
+
+    bool valid_;
+    bool alive_;
+    bool started_;
+    bool has_new_packets_;
+
+    size_t n_restored_packets_;
+
+    const packet::FecScheme fec_scheme_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_RLC_READER_H_
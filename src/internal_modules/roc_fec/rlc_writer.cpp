@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/rlc_writer.h"
+#include "roc_core/fast_random.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_fec/gf256.h"
+#include "roc_fec/rlc_coefficients.h"
+#include "roc_packet/fec_scheme_to_str.h"
+
+namespace roc {
+namespace fec {
+
+RlcWriter::RlcWriter(const WriterConfig& config,
+                     packet::FecScheme fec_scheme,
+                     packet::IWriter& writer,
+                     packet::IComposer& source_composer,
+                     packet::IComposer& repair_composer,
+                     packet::PacketFactory& packet_factory,
+                     core::BufferFactory<uint8_t>& buffer_factory,
+                     core::IAllocator& allocator)
+    : writer_(writer)
+    , source_composer_(source_composer)
+    , repair_composer_(repair_composer)
+    , packet_factory_(packet_factory)
+    , buffer_factory_(buffer_factory)
+    , window_(allocator)
+    , window_head_(0)
+    , window_size_(0)
+    , coefs_(allocator)
+    , window_len_(0)
+    , n_repair_(0)
+    , repair_credit_(0)
+    , payload_size_(0)
+    , fec_scheme_(fec_scheme)
+    , valid_(false) {
+    next_esi_ = (uint32_t)core::fast_random(0, uint32_t(-1));
+    next_repair_key_ = (packet::blknum_t)core::fast_random(0, packet::blknum_t(-1));
+
+    if (!window_.resize(RlcMaxWindowLength) || !coefs_.resize(RlcMaxWindowLength)) {
+        roc_log(LogError, "rlc writer: can't allocate window");
+        return;
+    }
+
+    if (!resize(config.n_source_packets, config.n_repair_packets)) {
+        return;
+    }
+
+    valid_ = true;
+}
+
+bool RlcWriter::valid() const {
+    return valid_;
+}
+
+bool RlcWriter::resize(size_t window_len, size_t n_repair) {
+    if (window_len_ == window_len && n_repair_ == n_repair) {
+        return true;
+    }
+
+    if (window_len == 0) {
+        roc_log(LogError, "rlc writer: resize: window length can't be zero");
+        return false;
+    }
+
+    if (window_len > RlcMaxWindowLength) {
+        roc_log(LogDebug,
+                "rlc writer: can't update window length, maximum value exceeded:"
+                " cur_wl=%lu new_wl=%lu max_wl=%lu",
+                (unsigned long)window_len_, (unsigned long)window_len,
+                (unsigned long)RlcMaxWindowLength);
+        return false;
+    }
+
+    roc_log(LogDebug,
+            "rlc writer: update window size:"
+            " cur_wl=%lu cur_nr=%lu new_wl=%lu new_nr=%lu",
+            (unsigned long)window_len_, (unsigned long)n_repair_,
+            (unsigned long)window_len, (unsigned long)n_repair);
+
+    // drop oldest packets that don't fit into new window
+    while (window_size_ > window_len) {
+        window_[window_head_] = core::Slice<uint8_t>();
+        window_head_ = (window_head_ + 1) % RlcMaxWindowLength;
+        window_size_--;
+    }
+
+    window_len_ = window_len;
+    n_repair_ = n_repair;
+    repair_credit_ = 0;
+
+    return true;
+}
+
+void RlcWriter::write(const packet::PacketPtr& pp) {
+    roc_panic_if_not(valid());
+    roc_panic_if_not(pp);
+
+    validate_fec_packet_(pp);
+
+    const size_t payload_size = pp->fec()->payload.size();
+
+    if (payload_size != payload_size_) {
+        reset_window_(payload_size);
+    }
+
+    write_source_packet_(pp);
+
+    repair_credit_ += n_repair_;
+
+    while (repair_credit_ >= window_len_) {
+        repair_credit_ -= window_len_;
+        write_repair_packet_();
+    }
+}
+
+void RlcWriter::write_source_packet_(const packet::PacketPtr& pp) {
+    packet::FEC& fec = *pp->fec();
+
+    fec.encoding_symbol_id = next_esi_;
+    fec.source_block_number = 0;
+    fec.source_block_length = 0;
+    fec.block_length = 0;
+
+    pp->add_flags(packet::Packet::FlagComposed);
+
+    if (!source_composer_.compose(*pp)) {
+        roc_panic("rlc writer: can't compose source packet");
+    }
+
+    push_window_(fec.payload);
+    next_esi_++;
+
+    writer_.write(pp);
+}
+
+void RlcWriter::write_repair_packet_() {
+    packet::PacketPtr rp = make_repair_packet_();
+    if (!rp) {
+        return;
+    }
+
+    encode_repair_packet_(rp);
+
+    rp->add_flags(packet::Packet::FlagComposed);
+
+    if (!repair_composer_.compose(*rp)) {
+        roc_panic("rlc writer: can't compose repair packet");
+    }
+
+    writer_.write(rp);
+}
+
+packet::PacketPtr RlcWriter::make_repair_packet_() {
+    packet::PacketPtr packet = packet_factory_.new_packet();
+    if (!packet) {
+        roc_log(LogError, "rlc writer: can't allocate packet");
+        return NULL;
+    }
+
+    core::Slice<uint8_t> data = buffer_factory_.new_buffer();
+    if (!data) {
+        roc_log(LogError, "rlc writer: can't allocate buffer");
+        return NULL;
+    }
+
+    if (!repair_composer_.align(data, 0, Alignment)) {
+        roc_log(LogError, "rlc writer: can't align packet buffer");
+        return NULL;
+    }
+
+    if (!repair_composer_.prepare(*packet, data, payload_size_)) {
+        roc_log(LogError, "rlc writer: can't prepare packet");
+        return NULL;
+    }
+
+    if (!packet->fec()) {
+        roc_log(LogError, "rlc writer: unexpected non-fec packet");
+        return NULL;
+    }
+
+    packet->set_data(data);
+
+    validate_fec_packet_(packet);
+
+    return packet;
+}
+
+void RlcWriter::encode_repair_packet_(const packet::PacketPtr& rp) {
+    packet::FEC& fec = *rp->fec();
+
+    const packet::blknum_t repair_key = next_repair_key_++;
+
+    fec.encoding_symbol_id = uint32_t(next_esi_ - window_size_);
+    fec.source_block_number = repair_key;
+    fec.source_block_length = window_size_;
+    fec.block_length = 0;
+
+    rlc_coefficients(repair_key, coefs_.data(), window_size_);
+
+    uint8_t* payload = fec.payload.data();
+    memset(payload, 0, payload_size_);
+
+    const Gf256& gf = Gf256::instance();
+
+    for (size_t n = 0; n < window_size_; n++) {
+        const core::Slice<uint8_t>& src =
+            window_[(window_head_ + n) % RlcMaxWindowLength];
+
+        gf.mul_add(payload, src.data(), coefs_[n], payload_size_);
+    }
+
+    roc_log(LogTrace, "rlc writer: repair packet: key=%lu first_esi=%lu nss=%lu",
+            (unsigned long)repair_key, (unsigned long)fec.encoding_symbol_id,
+            (unsigned long)window_size_);
+}
+
+void RlcWriter::push_window_(const core::Slice<uint8_t>& payload) {
+    if (window_size_ == window_len_) {
+        window_[window_head_] = core::Slice<uint8_t>();
+        window_head_ = (window_head_ + 1) % RlcMaxWindowLength;
+        window_size_--;
+    }
+
+    window_[(window_head_ + window_size_) % RlcMaxWindowLength] = payload;
+    window_size_++;
+}
+
+void RlcWriter::reset_window_(size_t payload_size) {
+    if (payload_size_ != 0) {
+        roc_log(LogDebug,
+                "rlc writer: payload size changed, restarting window:"
+                " old_size=%lu new_size=%lu",
+                (unsigned long)payload_size_, (unsigned long)payload_size);
+    }
+
+    while (window_size_ > 0) {
+        window_[window_head_] = core::Slice<uint8_t>();
+        window_head_ = (window_head_ + 1) % RlcMaxWindowLength;
+        window_size_--;
+    }
+
+    payload_size_ = payload_size;
+    repair_credit_ = 0;
+}
+
+void RlcWriter::validate_fec_packet_(const packet::PacketPtr& pp) {
+    const packet::FEC* fec = pp->fec();
+
+    if (!fec) {
+        roc_panic("rlc writer: unexpected non-fec packet");
+    }
+
+    if (fec->fec_scheme != fec_scheme_) {
+        roc_panic("rlc writer: unexpected packet fec scheme:"
+                  " packet_scheme=%s session_scheme=%s",
+                  packet::fec_scheme_to_str(fec->fec_scheme),
+                  packet::fec_scheme_to_str(fec_scheme_));
+    }
+}
+
+} // namespace fec
+} // namespace roc
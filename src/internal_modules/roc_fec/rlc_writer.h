@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/rlc_writer.h
+//! @brief Sliding window RLC FEC writer.
+
+#ifndef ROC_FEC_RLC_WRITER_H_
+#define ROC_FEC_RLC_WRITER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/buffer_factory.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/slice.h"
+#include "roc_fec/writer.h"
+#include "roc_packet/icomposer.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet.h"
+#include "roc_packet/packet_factory.h"
+
+namespace roc {
+namespace fec {
+
+//! Sliding window RLC FEC writer.
+//!
+//! Implements Random Linear Codes over GF(2^8) as described in RFC 8681.
+//! Instead of splitting the stream into blocks, every repair packet is a
+//! random linear combination of the last source packets (encoding window),
+//! so a lost packet can be repaired as soon as a repair packet covering it
+//! arrives, without waiting for the whole block.
+//!
+//! Window length is defined by WriterConfig::n_source_packets, and
+//! WriterConfig::n_repair_packets repair packets are produced per every
+//! n_source_packets source packets, giving the same overhead as the block
+//! writer with the same configuration.
+class RlcWriter : public packet::IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p config contains window length and repair rate
+    //!  - @p writer is used to write source and repair packets
+    //!  - @p source_composer is used to format source packets
+    //!  - @p repair_composer is used to format repair packets
+    //!  - @p packet_factory is used to allocate repair packets
+    //!  - @p buffer_factory is used to allocate buffers for repair packets
+    //!  - @p allocator is used to initialize a window array
+    RlcWriter(const WriterConfig& config,
+              packet::FecScheme fec_scheme,
+              packet::IWriter& writer,
+              packet::IComposer& source_composer,
+              packet::IComposer& repair_composer,
+              packet::PacketFactory& packet_factory,
+              core::BufferFactory<uint8_t>& buffer_factory,
+              core::IAllocator& allocator);
+
+    //! Check if object is successfully constructed.
+    bool valid() const;
+
+    //! Set window length and number of repair packets per window length.
+    bool resize(size_t window_len, size_t n_repair);
+
+    //! Write packet.
+    //! @remarks
+    //!  - writes the given source packet to the output writer
+    //!  - generates repair packets and also writes them to the output writer
+    virtual void write(const packet::PacketPtr&);
+
+private:
+    enum { Alignment = 8 };
+
+    void write_source_packet_(const packet::PacketPtr&);
+    void write_repair_packet_();
+
+    packet::PacketPtr make_repair_packet_();
+    void encode_repair_packet_(const packet::PacketPtr&);
+
+    void push_window_(const core::Slice<uint8_t>& payload);
+    void reset_window_(size_t payload_size);
+
+    void validate_fec_packet_(const packet::PacketPtr&);
+
+    packet::IWriter& writer_;
+
+    packet::IComposer& source_composer_;
+    packet::IComposer& repair_composer_;
+
+    packet::PacketFactory& packet_factory_;
+    core::BufferFactory<uint8_t>& buffer_factory_;
+
+    // ring buffer with payloads of last source packets
+    core::Array<core::Slice<uint8_t> > window_;
+    size_t window_head_;
+    size_t window_size_;
+
+    core::Array<uint8_t> coefs_;
+
+    size_t window_len_;
+    size_t n_repair_;
+
+    // accumulated repair rate, a repair packet is produced every time
+    // it reaches window length
+    size_t repair_credit_;
+
+    size_t payload_size_;
+
+    uint32_t next_esi_;
+    packet::blknum_t next_repair_key_;
+
+    const packet::FecScheme fec_scheme_;
+
+    bool valid_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_RLC_WRITER_H_
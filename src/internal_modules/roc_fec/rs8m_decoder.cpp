@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/rs8m_decoder.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace fec {
+
+Rs8mDecoder::Rs8mDecoder(const CodecConfig& config,
+                         core::BufferFactory<uint8_t>& buffer_factory,
+                         core::IAllocator& allocator)
+    : sblen_(0)
+    , rblen_(0)
+    , payload_size_(0)
+    , max_index_(0)
+    , gf_(Gf256::instance())
+    , matrix_builder_(allocator)
+    , buffer_factory_(buffer_factory)
+    , buff_tab_(allocator)
+    , recv_tab_(allocator)
+    , indices_(allocator)
+    , cache_pos_(0)
+    , status_(allocator)
+    , has_new_packets_(false)
+    , valid_(false) {
+    if (config.scheme != packet::FEC_ReedSolomon_M8) {
+        roc_panic("rs8m decoder: unexpected fec scheme");
+    }
+
+    if (config.rs_m != 8) {
+        roc_log(LogError, "rs8m decoder: unsupported parameters: m=%u",
+                (unsigned)config.rs_m);
+        return;
+    }
+
+    for (size_t n = 0; n < MaxCachedMatrices; n++) {
+        cache_[n].reset(new (cache_[n]) DecodingMatrix(allocator));
+    }
+
+    roc_log(LogDebug, "rs8m decoder: initializing: impl=%s", gf_.impl_name());
+
+    valid_ = true;
+}
+
+Rs8mDecoder::~Rs8mDecoder() {
+}
+
+bool Rs8mDecoder::valid() const {
+    return valid_;
+}
+
+size_t Rs8mDecoder::max_block_length() const {
+    roc_panic_if_not(valid());
+
+    return Rs8mMatrix::MaxBlockLength;
+}
+
+bool Rs8mDecoder::begin(size_t sblen, size_t rblen, size_t payload_size) {
+    roc_panic_if_not(valid());
+
+    if (sblen == 0 || sblen + rblen > Rs8mMatrix::MaxBlockLength) {
+        roc_log(LogError, "rs8m decoder: invalid block size: sblen=%lu rblen=%lu max=%lu",
+                (unsigned long)sblen, (unsigned long)rblen,
+                (unsigned long)Rs8mMatrix::MaxBlockLength);
+        return false;
+    }
+
+    if (!resize_tabs_(sblen + rblen)) {
+        return false;
+    }
+
+    sblen_ = sblen;
+    rblen_ = rblen;
+    payload_size_ = payload_size;
+    max_index_ = 0;
+
+    return true;
+}
+
+void Rs8mDecoder::set(size_t index, const core::Slice<uint8_t>& buffer) {
+    roc_panic_if_not(valid());
+
+    if (index >= sblen_ + rblen_) {
+        roc_panic("rs8m decoder: index out of bounds: index=%lu size=%lu",
+                  (unsigned long)index, (unsigned long)(sblen_ + rblen_));
+    }
+
+    if (!buffer) {
+        roc_panic("rs8m decoder: null buffer");
+    }
+
+    if (buffer.size() == 0 || buffer.size() != payload_size_) {
+        roc_panic("rs8m decoder: invalid payload size: cur=%lu new=%lu",
+                  (unsigned long)payload_size_, (unsigned long)buffer.size());
+    }
+
+    if (recv_tab_[index]) {
+        roc_panic("rs8m decoder: can't overwrite buffer: index=%lu",
+                  (unsigned long)index);
+    }
+
+    if (max_index_ < index) {
+        max_index_ = index;
+    }
+
+    recv_tab_[index] = true;
+
+    if (buff_tab_[index]) {
+        // packet was already repaired, prefer received one
+        buff_tab_[index] = buffer;
+        return;
+    }
+
+    has_new_packets_ = true;
+
+    buff_tab_[index] = buffer;
+}
+
+core::Slice<uint8_t> Rs8mDecoder::repair(size_t index) {
+    roc_panic_if_not(valid());
+
+    if (index >= sblen_ + rblen_) {
+        roc_panic("rs8m decoder: index out of bounds: index=%lu size=%lu",
+                  (unsigned long)index, (unsigned long)(sblen_ + rblen_));
+    }
+
+    // repair packets are never restored, like in OpenFEC
+    if (!buff_tab_[index] && index < sblen_) {
+        decode_();
+    }
+
+    return buff_tab_[index];
+}
+
+void Rs8mDecoder::end() {
+    roc_panic_if_not(valid());
+
+    if (sblen_ != 0) {
+        report_();
+    }
+
+    reset_tabs_();
+
+    has_new_packets_ = false;
+}
+
+bool Rs8mDecoder::resize_tabs_(size_t size) {
+    if (!buff_tab_.resize(size)) {
+        return false;
+    }
+    if (!recv_tab_.resize(size)) {
+        return false;
+    }
+    if (!indices_.resize(size)) {
+        return false;
+    }
+    if (!status_.resize(size + 2)) {
+        return false;
+    }
+
+    return true;
+}
+
+void Rs8mDecoder::reset_tabs_() {
+    for (size_t i = 0; i < buff_tab_.size(); ++i) {
+        buff_tab_[i] = core::Slice<uint8_t>();
+        recv_tab_[i] = false;
+    }
+}
+
+// restores all missing source packets at once
+void Rs8mDecoder::decode_() {
+    if (!has_new_packets_) {
+        return;
+    }
+
+    has_new_packets_ = false;
+
+    // use source packets first, since they are cheaper to handle
+    size_t n_indices = 0;
+    size_t n_missing = 0;
+
+    for (size_t i = 0; i < sblen_; i++) {
+        if (buff_tab_[i]) {
+            indices_[n_indices++] = (uint8_t)i;
+        } else {
+            n_missing++;
+        }
+    }
+
+    if (n_missing == 0) {
+        return;
+    }
+
+    for (size_t i = sblen_; i < sblen_ + rblen_ && n_indices < sblen_; i++) {
+        if (buff_tab_[i]) {
+            indices_[n_indices++] = (uint8_t)i;
+        }
+    }
+
+    if (n_indices < sblen_) {
+        return;
+    }
+
+    const uint8_t* matrix = get_matrix_();
+    if (!matrix) {
+        return;
+    }
+
+    for (size_t s = 0; s < sblen_; s++) {
+        if (buff_tab_[s]) {
+            continue;
+        }
+
+        core::Slice<uint8_t> buffer = make_buffer_();
+        if (!buffer) {
+            continue;
+        }
+
+        memset(buffer.data(), 0, payload_size_);
+
+        const uint8_t* coefs = matrix + s * sblen_;
+        for (size_t n = 0; n < sblen_; n++) {
+            gf_.mul_add(buffer.data(), buff_tab_[indices_[n]].data(), coefs[n],
+                        payload_size_);
+        }
+
+        buff_tab_[s] = buffer;
+    }
+}
+
+const uint8_t* Rs8mDecoder::get_matrix_() {
+    for (size_t n = 0; n < MaxCachedMatrices; n++) {
+        DecodingMatrix& entry = *cache_[n];
+
+        if (entry.sblen == sblen_
+            && memcmp(entry.indices.data(), indices_.data(), sblen_) == 0) {
+            return entry.matrix.data();
+        }
+    }
+
+    DecodingMatrix& entry = *cache_[cache_pos_];
+    cache_pos_ = (cache_pos_ + 1) % MaxCachedMatrices;
+
+    entry.sblen = 0;
+
+    if (!entry.indices.resize(sblen_)) {
+        roc_log(LogError, "rs8m decoder: can't allocate decoding matrix");
+        return NULL;
+    }
+
+    if (!matrix_builder_.build_decoder(sblen_, indices_.data(), entry.matrix)) {
+        roc_log(LogError, "rs8m decoder: can't allocate decoding matrix");
+        return NULL;
+    }
+
+    memcpy(entry.indices.data(), indices_.data(), sblen_);
+    entry.sblen = sblen_;
+
+    return entry.matrix.data();
+}
+
+core::Slice<uint8_t> Rs8mDecoder::make_buffer_() {
+    core::Slice<uint8_t> buffer = buffer_factory_.new_buffer();
+
+    if (!buffer) {
+        roc_log(LogError, "rs8m decoder: can't allocate buffer");
+        return core::Slice<uint8_t>();
+    }
+
+    if (buffer.capacity() < payload_size_) {
+        roc_log(LogError, "rs8m decoder: packet size too large: size=%lu max=%lu",
+                (unsigned long)payload_size_, (unsigned long)buffer.capacity());
+        return core::Slice<uint8_t>();
+    }
+
+    buffer.reslice(0, payload_size_);
+
+    return buffer;
+}
+
+void Rs8mDecoder::report_() {
+    size_t n_lost = 0, n_repaired = 0;
+
+    size_t tab_size = max_index_ + 1;
+    if (tab_size < sblen_) {
+        tab_size = sblen_;
+    }
+
+    // source and repair packets are separated by space
+    status_[sblen_] = ' ';
+    status_[tab_size > sblen_ ? tab_size + 1 : tab_size] = '\0';
+
+    for (size_t i = 0; i < tab_size; ++i) {
+        char* status = (i < sblen_ ? &status_[i] : &status_[i + 1]);
+
+        if (buff_tab_[i]) {
+            if (recv_tab_[i]) {
+                *status = '.';
+            } else {
+                *status = 'r';
+                n_repaired++;
+                n_lost++;
+            }
+        } else {
+            if (i < sblen_) {
+                *status = 'X';
+            } else {
+                *status = 'x';
+            }
+            n_lost++;
+        }
+    }
+
+    if (n_lost == 0) {
+        return;
+    }
+
+    roc_log(LogDebug, "rs8m decoder: repaired %u/%u/%u %s", (unsigned)n_repaired,
+            (unsigned)n_lost, (unsigned)buff_tab_.size(), &status_[0]);
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/rs8m_decoder.h
+//! @brief Native Reed-Solomon GF(2^8) decoder.
+
+#ifndef ROC_FEC_RS8M_DECODER_H_
+#define ROC_FEC_RS8M_DECODER_H_
+
+#include "roc_core/array.h"
+#include "roc_core/buffer_factory.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/optional.h"
+#include "roc_core/slice.h"
+#include "roc_fec/codec_config.h"
+#include "roc_fec/gf256.h"
+#include "roc_fec/iblock_decoder.h"
+#include "roc_fec/rs8m_matrix.h"
+
+namespace roc {
+namespace fec {
+
+//! Native Reed-Solomon GF(2^8) decoder.
+//!
+//! Compatible with Reed-Solomon codec in OpenFEC.
+//!
+//! Decoding matrix depends only on block size and the set of received
+//! packets. Since loss patterns tend to repeat, a few recently used
+//! decoding matrices are cached.
+class Rs8mDecoder : public IBlockDecoder, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    explicit Rs8mDecoder(const CodecConfig& config,
+                         core::BufferFactory<uint8_t>& buffer_factory,
+                         core::IAllocator& allocator);
+
+    virtual ~Rs8mDecoder();
+
+    //! Check if object is successfully constructed.
+    bool valid() const;
+
+    //! Get the maximum number of encoding symbols for the scheme being used.
+    virtual size_t max_block_length() const;
+
+    //! Start block.
+    //!
+    //! @remarks
+    //!  Performs an initial setup for a block. Should be called before
+    //!  any operations for the block.
+    virtual bool begin(size_t sblen, size_t rblen, size_t payload_size);
+
+    //! Store source or repair packet buffer for current block.
+    virtual void set(size_t index, const core::Slice<uint8_t>& buffer);
+
+    //! Repair source packet buffer.
+    virtual core::Slice<uint8_t> repair(size_t index);
+
+    //! Finish block.
+    //!
+    //! @remarks
+    //!  Cleanups the resources allocated for the block. Should be called after
+    //!  all operations for the block.
+    virtual void end();
+
+private:
+    enum { MaxCachedMatrices = 4 };
+
+    struct DecodingMatrix {
+        size_t sblen;
+        core::Array<uint8_t> indices;
+        core::Array<uint8_t> matrix;
+
+        DecodingMatrix(core::IAllocator& allocator)
+            : sblen(0)
+            , indices(allocator)
+            , matrix(allocator) {
+        }
+    };
+
+    bool resize_tabs_(size_t size);
+    void reset_tabs_();
+
+    void decode_();
+    const uint8_t* get_matrix_();
+    core::Slice<uint8_t> make_buffer_();
+
+    void report_();
+
+    size_t sblen_;
+    size_t rblen_;
+    size_t payload_size_;
+    size_t max_index_;
+
+    Gf256& gf_;
+    Rs8mMatrix matrix_builder_;
+
+    core::BufferFactory<uint8_t>& buffer_factory_;
+
+    // received and repaired source and repair packets
+    core::Array<core::Slice<uint8_t> > buff_tab_;
+
+    // true if packet is received, false if it's is lost or repaired
+    core::Array<bool> recv_tab_;
+
+    // indices of packets used for decoding
+    core::Array<uint8_t> indices_;
+
+    core::Optional<DecodingMatrix> cache_[MaxCachedMatrices];
+    size_t cache_pos_;
+
+    // for debug logging
+    core::Array<char> status_;
+
+    bool has_new_packets_;
+
+    bool valid_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_RS8M_DECODER_H_
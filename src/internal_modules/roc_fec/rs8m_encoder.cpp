@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/rs8m_encoder.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace fec {
+
+Rs8mEncoder::Rs8mEncoder(const CodecConfig& config,
+                         core::BufferFactory<uint8_t>&,
+                         core::IAllocator& allocator)
+    : sblen_(0)
+    , rblen_(0)
+    , payload_size_(0)
+    , gf_(Gf256::instance())
+    , matrix_(allocator)
+    , generator_(NULL)
+    , cache_pos_(0)
+    , buff_tab_(allocator)
+    , valid_(false) {
+    if (config.scheme != packet::FEC_ReedSolomon_M8) {
+        roc_panic("rs8m encoder: unexpected fec scheme");
+    }
+
+    if (config.rs_m != 8) {
+        roc_log(LogError, "rs8m encoder: unsupported parameters: m=%u",
+                (unsigned)config.rs_m);
+        return;
+    }
+
+    for (size_t n = 0; n < MaxCachedMatrices; n++) {
+        cache_[n].reset(new (cache_[n]) GeneratorMatrix(allocator));
+    }
+
+    roc_log(LogDebug, "rs8m encoder: initializing: impl=%s", gf_.impl_name());
+
+    valid_ = true;
+}
+
+Rs8mEncoder::~Rs8mEncoder() {
+}
+
+bool Rs8mEncoder::valid() const {
+    return valid_;
+}
+
+size_t Rs8mEncoder::alignment() const {
+    return Alignment;
+}
+
+size_t Rs8mEncoder::max_block_length() const {
+    roc_panic_if_not(valid());
+
+    return Rs8mMatrix::MaxBlockLength;
+}
+
+bool Rs8mEncoder::begin(size_t sblen, size_t rblen, size_t payload_size) {
+    roc_panic_if_not(valid());
+
+    if (sblen == 0 || sblen + rblen > Rs8mMatrix::MaxBlockLength) {
+        roc_log(LogError, "rs8m encoder: invalid block size: sblen=%lu rblen=%lu max=%lu",
+                (unsigned long)sblen, (unsigned long)rblen,
+                (unsigned long)Rs8mMatrix::MaxBlockLength);
+        return false;
+    }
+
+    payload_size_ = payload_size;
+
+    if (sblen_ == sblen && rblen_ == rblen) {
+        return true;
+    }
+
+    sblen_ = 0;
+    rblen_ = 0;
+
+    if (!buff_tab_.resize(sblen + rblen)) {
+        return false;
+    }
+
+    if (!update_generator_(sblen, rblen)) {
+        return false;
+    }
+
+    sblen_ = sblen;
+    rblen_ = rblen;
+
+    return true;
+}
+
+void Rs8mEncoder::set(size_t index, const core::Slice<uint8_t>& buffer) {
+    roc_panic_if_not(valid());
+
+    if (index >= sblen_ + rblen_) {
+        roc_panic("rs8m encoder: can't write more than %lu data buffers",
+                  (unsigned long)(sblen_ + rblen_));
+    }
+
+    if (!buffer) {
+        roc_panic("rs8m encoder: null buffer");
+    }
+
+    if (buffer.size() == 0 || buffer.size() != payload_size_) {
+        roc_panic("rs8m encoder: invalid payload size: cur=%lu new=%lu",
+                  (unsigned long)payload_size_, (unsigned long)buffer.size());
+    }
+
+    if ((uintptr_t)buffer.data() % Alignment != 0) {
+        roc_panic("rs8m encoder: buffer data should be %d-byte aligned: index=%lu",
+                  (int)Alignment, (unsigned long)index);
+    }
+
+    buff_tab_[index] = buffer;
+}
+
+void Rs8mEncoder::fill() {
+    roc_panic_if_not(valid());
+
+    for (size_t i = 0; i < sblen_ + rblen_; i++) {
+        if (!buff_tab_[i]) {
+            roc_panic("rs8m encoder: buffer not set: index=%lu", (unsigned long)i);
+        }
+    }
+
+    for (size_t r = 0; r < rblen_; r++) {
+        uint8_t* repair = buff_tab_[sblen_ + r].data();
+        const uint8_t* coefs = generator_ + r * sblen_;
+
+        memset(repair, 0, payload_size_);
+
+        for (size_t s = 0; s < sblen_; s++) {
+            gf_.mul_add(repair, buff_tab_[s].data(), coefs[s], payload_size_);
+        }
+    }
+}
+
+void Rs8mEncoder::end() {
+    roc_panic_if_not(valid());
+
+    for (size_t i = 0; i < buff_tab_.size(); ++i) {
+        buff_tab_[i] = core::Slice<uint8_t>();
+    }
+}
+
+bool Rs8mEncoder::update_generator_(size_t sblen, size_t rblen) {
+    for (size_t n = 0; n < MaxCachedMatrices; n++) {
+        GeneratorMatrix& entry = *cache_[n];
+
+        if (entry.sblen == sblen && entry.rblen == rblen) {
+            generator_ = entry.matrix.data();
+            return true;
+        }
+    }
+
+    GeneratorMatrix& entry = *cache_[cache_pos_];
+    cache_pos_ = (cache_pos_ + 1) % MaxCachedMatrices;
+
+    entry.sblen = 0;
+    entry.rblen = 0;
+
+    generator_ = NULL;
+
+    if (!matrix_.build_generator(sblen, sblen, rblen, entry.matrix)) {
+        roc_log(LogError, "rs8m encoder: can't allocate generator matrix");
+        return false;
+    }
+
+    entry.sblen = sblen;
+    entry.rblen = rblen;
+
+    generator_ = entry.matrix.data();
+
+    return true;
+}
+
+} // namespace fec
+} // namespace roc
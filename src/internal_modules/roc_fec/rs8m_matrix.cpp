@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/rs8m_matrix.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace fec {
+
+Rs8mMatrix::Rs8mMatrix(core::IAllocator& allocator)
+    : gf_(Gf256::instance())
+    , k_(0)
+    , inv_top_(allocator)
+    , scratch_(allocator)
+    , row_(allocator) {
+}
+
+bool Rs8mMatrix::build_generator(size_t k,
+                                 size_t first_row,
+                                 size_t n_rows,
+                                 core::Array<uint8_t>& result) {
+    if (first_row + n_rows > MaxBlockLength) {
+        roc_panic("rs8m matrix: row out of bounds: first_row=%lu n_rows=%lu max=%lu",
+                  (unsigned long)first_row, (unsigned long)n_rows,
+                  (unsigned long)MaxBlockLength);
+    }
+
+    if (!prepare_(k)) {
+        return false;
+    }
+
+    if (!result.resize(n_rows * k)) {
+        return false;
+    }
+
+    for (size_t n = 0; n < n_rows; n++) {
+        generator_row_(first_row + n, &result[n * k]);
+    }
+
+    return true;
+}
+
+bool Rs8mMatrix::build_decoder(size_t k,
+                               const uint8_t* indices,
+                               core::Array<uint8_t>& result) {
+    roc_panic_if(!indices);
+
+    if (!prepare_(k)) {
+        return false;
+    }
+
+    if (!result.resize(k * k)) {
+        return false;
+    }
+
+    for (size_t n = 0; n < k; n++) {
+        generator_row_(indices[n], &scratch_[n * k]);
+    }
+
+    if (!invert_(scratch_.data(), result.data(), k)) {
+        roc_panic("rs8m matrix: decoding matrix is singular: k=%lu", (unsigned long)k);
+    }
+
+    return true;
+}
+
+bool Rs8mMatrix::prepare_(size_t k) {
+    if (k == 0 || k > MaxBlockLength) {
+        roc_panic("rs8m matrix: invalid number of source symbols: k=%lu max=%lu",
+                  (unsigned long)k, (unsigned long)MaxBlockLength);
+    }
+
+    if (k_ == k) {
+        return true;
+    }
+
+    k_ = 0;
+
+    if (!inv_top_.resize(k * k) || !scratch_.resize(k * k) || !row_.resize(k)) {
+        return false;
+    }
+
+    // top k x k part of Vandermonde matrix:
+    // first row is [1 0 ... 0], row r > 0 is [a^0 a^(r-1) a^(2(r-1)) ...]
+    for (size_t r = 0; r < k; r++) {
+        for (size_t c = 0; c < k; c++) {
+            if (r == 0) {
+                scratch_[r * k + c] = (c == 0 ? 1 : 0);
+            } else {
+                scratch_[r * k + c] = gf_.exp((r - 1) * c);
+            }
+        }
+    }
+
+    if (!invert_(scratch_.data(), inv_top_.data(), k)) {
+        roc_panic("rs8m matrix: vandermonde matrix is singular: k=%lu",
+                  (unsigned long)k);
+    }
+
+    k_ = k;
+
+    roc_log(LogTrace, "rs8m matrix: computed generator: k=%lu", (unsigned long)k);
+
+    return true;
+}
+
+void Rs8mMatrix::generator_row_(size_t row, uint8_t* result) {
+    const size_t k = k_;
+
+    memset(result, 0, k);
+
+    if (row < k) {
+        result[row] = 1;
+        return;
+    }
+
+    // multiply Vandermonde row by inverse of top part
+    for (size_t c = 0; c < k; c++) {
+        row_[c] = gf_.exp((row - 1) * c);
+    }
+
+    for (size_t n = 0; n < k; n++) {
+        gf_.mul_add(result, &inv_top_[n * k], row_[n], k);
+    }
+}
+
+// Gauss-Jordan elimination; destroys input matrix
+bool Rs8mMatrix::invert_(uint8_t* matrix, uint8_t* result, size_t k) {
+    memset(result, 0, k * k);
+    for (size_t n = 0; n < k; n++) {
+        result[n * k + n] = 1;
+    }
+
+    for (size_t col = 0; col < k; col++) {
+        size_t pivot = col;
+        while (pivot < k && matrix[pivot * k + col] == 0) {
+            pivot++;
+        }
+        if (pivot == k) {
+            return false;
+        }
+
+        uint8_t* m_row = matrix + col * k;
+        uint8_t* r_row = result + col * k;
+
+        if (pivot != col) {
+            uint8_t* m_pivot = matrix + pivot * k;
+            uint8_t* r_pivot = result + pivot * k;
+
+            for (size_t c = 0; c < k; c++) {
+                uint8_t tmp = m_row[c];
+                m_row[c] = m_pivot[c];
+                m_pivot[c] = tmp;
+
+                tmp = r_row[c];
+                r_row[c] = r_pivot[c];
+                r_pivot[c] = tmp;
+            }
+        }
+
+        const uint8_t coef = gf_.inv(m_row[col]);
+        if (coef != 1) {
+            for (size_t c = 0; c < k; c++) {
+                m_row[c] = gf_.mul(m_row[c], coef);
+                r_row[c] = gf_.mul(r_row[c], coef);
+            }
+        }
+
+        // in GF(2^8), subtraction is the same as addition
+        for (size_t r = 0; r < k; r++) {
+            if (r == col) {
+                continue;
+            }
+            const uint8_t factor = matrix[r * k + col];
+            if (factor == 0) {
+                continue;
+            }
+            gf_.mul_add(matrix + r * k, m_row, factor, k);
+            gf_.mul_add(result + r * k, r_row, factor, k);
+        }
+    }
+
+    return true;
+}
+
+} // namespace fec
+} // namespace roc
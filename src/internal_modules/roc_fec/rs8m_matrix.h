@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/rs8m_matrix.h
+//! @brief Reed-Solomon GF(2^8) coding matrices.
+
+#ifndef ROC_FEC_RS8M_MATRIX_H_
+#define ROC_FEC_RS8M_MATRIX_H_
+
+#include "roc_core/array.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_fec/gf256.h"
+
+namespace roc {
+namespace fec {
+
+//! Reed-Solomon GF(2^8) coding matrices.
+//!
+//! Builds the same systematic generator matrix as Reed-Solomon codec in
+//! OpenFEC (which is derived from L. Rizzo's implementation): rows of a
+//! Vandermonde matrix, multiplied by the inverse of its top square part.
+//! Row i of the generator defines encoding symbol with index i; first
+//! k rows form identity matrix.
+//!
+//! All matrices are k columns wide and stored row by row.
+class Rs8mMatrix : public core::NonCopyable<> {
+public:
+    //! Maximum number of encoding symbols.
+    enum { MaxBlockLength = 255 };
+
+    //! Initialize.
+    explicit Rs8mMatrix(core::IAllocator& allocator);
+
+    //! Build generator rows.
+    //! @remarks
+    //!  Fills @p result with @p n_rows rows of generator matrix for @p k source
+    //!  symbols, starting from @p first_row.
+    //! @returns
+    //!  false if allocation failed.
+    bool build_generator(size_t k,
+                         size_t first_row,
+                         size_t n_rows,
+                         core::Array<uint8_t>& result);
+
+    //! Build decoding matrix.
+    //! @remarks
+    //!  @p indices contains @p k distinct indices of received encoding symbols.
+    //!  Fills @p result with matrix that restores source symbols from the
+    //!  received symbols, taken in the order of @p indices.
+    //! @returns
+    //!  false if allocation failed.
+    bool build_decoder(size_t k, const uint8_t* indices, core::Array<uint8_t>& result);
+
+private:
+    bool prepare_(size_t k);
+    void generator_row_(size_t row, uint8_t* result);
+
+    bool invert_(uint8_t* matrix, uint8_t* result, size_t k);
+
+    Gf256& gf_;
+
+    // k for which inv_top_ is computed
+    size_t k_;
+
+    // inverse of top k x k part of Vandermonde matrix
+    core::Array<uint8_t> inv_top_;
+
+    core::Array<uint8_t> scratch_;
+    core::Array<uint8_t> row_;
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_RS8M_MATRIX_H_
@@ -95,7 +95,6 @@ bool OpenfecDecoder::begin(size_t sblen, size_t rblen, size_t payload_size) {
     max_index_ = 0;
 
     update_session_params_(sblen, rblen, payload_size);
-    reset_session_();
 
     return true;
 }
@@ -117,29 +116,36 @@ void OpenfecDecoder::set(size_t index, const core::Slice<uint8_t>& buffer) {
                   (unsigned long)payload_size_, (unsigned long)buffer.size());
     }
 
-    if (buff_tab_[index]) {
+    if (recv_tab_[index]) {
         roc_panic("openfec decoder: can't overwrite buffer: index=%lu",
                   (unsigned long)index);
     }
 
+    if (buff_tab_[index] || data_tab_[index]) {
+        // packet was already repaired; repaired buffer is registered in
+        // session and has the same contents, so just keep it
+        recv_tab_[index] = true;
+        if (max_index_ < index) {
+            max_index_ = index;
+        }
+        return;
+    }
+
     has_new_packets_ = true;
 
     buff_tab_[index] = buffer;
     data_tab_[index] = buffer.data();
     recv_tab_[index] = true;
 
-    // register new packet and try to repair more packets
-    roc_log(LogTrace, "openfec decoder: of_decode_with_new_symbol(): index=%lu",
-            (unsigned long)index);
-
-    if (of_decode_with_new_symbol(of_sess_, data_tab_[index], (unsigned int)index)
-        != OF_STATUS_OK) {
-        roc_panic("openfec decoder: can't add packet to OF session");
-    }
-
     if (max_index_ < index) {
         max_index_ = index;
     }
+
+    // if session is not created yet, packet will be registered
+    // when session is created
+    if (of_sess_ != NULL) {
+        add_symbol_(index);
+    }
 }
 
 core::Slice<uint8_t> OpenfecDecoder::repair(size_t index) {
@@ -154,8 +160,11 @@ core::Slice<uint8_t> OpenfecDecoder::repair(size_t index) {
 }
 
 void OpenfecDecoder::end() {
-    if (of_sess_ != NULL) {
+    if (sblen_ != 0) {
         report_();
+    }
+
+    if (of_sess_ != NULL) {
         destroy_session_();
     }
 
@@ -199,12 +208,14 @@ bool OpenfecDecoder::resize_tabs_(size_t size) {
 }
 
 void OpenfecDecoder::update_() {
-    roc_panic_if(of_sess_ == NULL);
-
     if (!has_new_packets_) {
         return;
     }
 
+    if (of_sess_ == NULL) {
+        start_session_();
+    }
+
     decode_();
 
     roc_log(LogTrace, "openfec decoder: of_get_source_symbols_tab()");
@@ -269,6 +280,29 @@ bool OpenfecDecoder::is_optimal_() const {
     return codec_id_ == OF_CODEC_REED_SOLOMON_GF_2_M_STABLE;
 }
 
+// session is created when first lost packet is requested, so that
+// blocks without losses don't create it at all
+void OpenfecDecoder::start_session_() {
+    reset_session_();
+
+    for (size_t i = 0; i < sblen_ + rblen_; i++) {
+        if (recv_tab_[i]) {
+            add_symbol_(i);
+        }
+    }
+}
+
+// register new packet and try to repair more packets
+void OpenfecDecoder::add_symbol_(size_t index) {
+    roc_log(LogTrace, "openfec decoder: of_decode_with_new_symbol(): index=%lu",
+            (unsigned long)index);
+
+    if (of_decode_with_new_symbol(of_sess_, data_tab_[index], (unsigned int)index)
+        != OF_STATUS_OK) {
+        roc_panic("openfec decoder: can't add packet to OF session");
+    }
+}
+
 void OpenfecDecoder::reset_session_() {
     if (of_sess_ != NULL) {
         of_release_codec_instance(of_sess_);
@@ -37,6 +37,11 @@ namespace roc {
 namespace fec {
 
 //! Decoder implementation using OpenFEC library.
+//!
+//! OpenFEC codec instance accumulates decoding state and can't be reset
+//! in place, so a new instance is needed for every block. The instance is
+//! created lazily, when a lost packet is requested for the first time in
+//! a block, so that blocks without losses don't pay for codec creation.
 class OpenfecDecoder : public IBlockDecoder, public core::NonCopyable<> {
 public:
     //! Initialize.
@@ -84,6 +89,8 @@ private:
     bool has_n_packets_(size_t n_packets) const;
     bool is_optimal_() const;
 
+    void start_session_();
+    void add_symbol_(size_t index);
     void reset_session_();
     void destroy_session_();
 
@@ -20,6 +20,7 @@ OpenfecEncoder::OpenfecEncoder(const CodecConfig& config,
     , rblen_(0)
     , payload_size_(0)
     , of_sess_(NULL)
+    , cache_pos_(0)
     , buff_tab_(allocator)
     , data_tab_(allocator)
     , valid_(false) {
@@ -48,14 +49,23 @@ OpenfecEncoder::OpenfecEncoder(const CodecConfig& config,
         roc_panic("openfec encoder: unexpected fec scheme");
     }
 
+    for (size_t n = 0; n < MaxCachedSessions; n++) {
+        cache_[n].sess = NULL;
+        cache_[n].sblen = 0;
+        cache_[n].rblen = 0;
+        cache_[n].payload_size = 0;
+    }
+
     of_verbosity = 0;
 
     valid_ = true;
 }
 
 OpenfecEncoder::~OpenfecEncoder() {
-    if (of_sess_) {
-        of_release_codec_instance(of_sess_);
+    for (size_t n = 0; n < MaxCachedSessions; n++) {
+        if (cache_[n].sess) {
+            of_release_codec_instance(cache_[n].sess);
+        }
     }
 }
 
@@ -84,13 +94,12 @@ bool OpenfecEncoder::begin(size_t sblen, size_t rblen, size_t payload_size) {
         return false;
     }
 
+    of_sess_ = get_session_(sblen, rblen, payload_size);
+
     sblen_ = sblen;
     rblen_ = rblen;
     payload_size_ = payload_size;
 
-    update_session_params_(sblen, rblen, payload_size);
-    reset_session_();
-
     return true;
 }
 
@@ -163,21 +172,52 @@ void OpenfecEncoder::update_session_params_(size_t sblen,
     of_sess_params_->encoding_symbol_length = (uint32_t)payload_size;
 }
 
-void OpenfecEncoder::reset_session_() {
-    if (of_sess_ != NULL) {
+of_session_t*
+OpenfecEncoder::get_session_(size_t sblen, size_t rblen, size_t payload_size) {
+    for (size_t n = 0; n < MaxCachedSessions; n++) {
+        const CachedSession& entry = cache_[n];
+
+        if (entry.sess && entry.sblen == sblen && entry.rblen == rblen
+            && entry.payload_size == payload_size) {
+            roc_log(LogTrace,
+                    "openfec encoder: reusing cached session:"
+                    " sblen=%lu rblen=%lu payload_size=%lu",
+                    (unsigned long)sblen, (unsigned long)rblen,
+                    (unsigned long)payload_size);
+            return entry.sess;
+        }
+    }
+
+    CachedSession& entry = cache_[cache_pos_];
+    cache_pos_ = (cache_pos_ + 1) % MaxCachedSessions;
+
+    if (entry.sess != NULL) {
         roc_log(LogTrace, "openfec encoder: of_release_codec_instance()");
 
-        of_release_codec_instance(of_sess_);
-        of_sess_ = NULL;
+        of_release_codec_instance(entry.sess);
+        entry.sess = NULL;
     }
 
+    update_session_params_(sblen, rblen, payload_size);
+
+    entry.sess = create_session_();
+    entry.sblen = sblen;
+    entry.rblen = rblen;
+    entry.payload_size = payload_size;
+
+    return entry.sess;
+}
+
+of_session_t* OpenfecEncoder::create_session_() {
+    of_session_t* sess = NULL;
+
     roc_log(LogTrace, "openfec encoder: of_create_codec_instance()");
 
-    if (OF_STATUS_OK != of_create_codec_instance(&of_sess_, codec_id_, OF_ENCODER, 0)) {
+    if (OF_STATUS_OK != of_create_codec_instance(&sess, codec_id_, OF_ENCODER, 0)) {
         roc_panic("openfec encoder: of_create_codec_instance() failed");
     }
 
-    roc_panic_if(of_sess_ == NULL);
+    roc_panic_if(sess == NULL);
 
     roc_log(
         LogTrace,
@@ -186,9 +226,11 @@ void OpenfecEncoder::reset_session_() {
         (unsigned long)of_sess_params_->nb_repair_symbols,
         (unsigned long)of_sess_params_->encoding_symbol_length);
 
-    if (OF_STATUS_OK != of_set_fec_parameters(of_sess_, of_sess_params_)) {
+    if (OF_STATUS_OK != of_set_fec_parameters(sess, of_sess_params_)) {
         roc_panic("openfec encoder: of_set_fec_parameters() failed");
     }
+
+    return sess;
 }
 
 } // namespace fec
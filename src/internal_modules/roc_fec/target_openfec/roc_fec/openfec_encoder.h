@@ -37,6 +37,12 @@ namespace roc {
 namespace fec {
 
 //! Encoder implementation using OpenFEC library.
+//!
+//! OpenFEC codec instance is bound to block size and payload size, and its
+//! creation involves heap allocation and, for some codecs, building of the
+//! encoding matrix. Encoding is stateless between blocks, so a few recently
+//! used codec instances are cached and reused when block or payload size
+//! switches back and forth.
 class OpenfecEncoder : public IBlockEncoder, public core::NonCopyable<> {
 public:
     //! Initialize.
@@ -76,12 +82,22 @@ public:
     virtual void end();
 
 private:
+    enum { Alignment = 8 };
+
+    enum { MaxCachedSessions = 4 };
+
+    struct CachedSession {
+        of_session_t* sess;
+        size_t sblen;
+        size_t rblen;
+        size_t payload_size;
+    };
+
     bool resize_tabs_(size_t size);
-    void reset_session_();
+    of_session_t* get_session_(size_t sblen, size_t rblen, size_t payload_size);
+    of_session_t* create_session_();
     void update_session_params_(size_t sblen, size_t rblen, size_t payload_size);
 
-    enum { Alignment = 8 };
-
     size_t sblen_;
     size_t rblen_;
 
@@ -90,6 +106,9 @@ private:
     of_session_t* of_sess_;
     of_parameters_t* of_sess_params_;
 
+    CachedSession cache_[MaxCachedSessions];
+    size_t cache_pos_;
+
     of_codec_id_t codec_id_;
     union {
         of_ldpc_parameters ldpc_params_;
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_fec/tinymt32.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+const uint32_t Mat1 = 0x8f7011ee;
+const uint32_t Mat2 = 0xfc78ff1f;
+const uint32_t TMat = 0x3793fdff;
+
+const uint32_t Mask = 0x7fffffff;
+
+const int Sh0 = 1;
+const int Sh1 = 10;
+const int Sh8 = 8;
+
+const int MinLoop = 8;
+const int PreLoop = 8;
+
+// Returns all ones if lowest bit is set, and zero otherwise.
+inline uint32_t lsb_mask(uint32_t v) {
+    return uint32_t(0) - (v & 1);
+}
+
+} // namespace
+
+Tinymt32::Tinymt32(uint32_t seed) {
+    status_[0] = seed;
+    status_[1] = Mat1;
+    status_[2] = Mat2;
+    status_[3] = TMat;
+
+    for (int i = 1; i < MinLoop; i++) {
+        const uint32_t prev = status_[(i - 1) & 3];
+        status_[i & 3] ^= uint32_t(i) + uint32_t(1812433253) * (prev ^ (prev >> 30));
+    }
+
+    // period certification
+    if ((status_[0] & Mask) == 0 && status_[1] == 0 && status_[2] == 0
+        && status_[3] == 0) {
+        status_[0] = 'T';
+        status_[1] = 'I';
+        status_[2] = 'N';
+        status_[3] = 'Y';
+    }
+
+    for (int i = 0; i < PreLoop; i++) {
+        next_state_();
+    }
+}
+
+uint32_t Tinymt32::next() {
+    next_state_();
+    return temper_();
+}
+
+void Tinymt32::next_state_() {
+    uint32_t y = status_[3];
+    uint32_t x = (status_[0] & Mask) ^ status_[1] ^ status_[2];
+
+    x ^= (x << Sh0);
+    y ^= (y >> Sh0) ^ x;
+
+    status_[0] = status_[1];
+    status_[1] = status_[2];
+    status_[2] = x ^ (y << Sh1);
+    status_[3] = y;
+
+    status_[1] ^= lsb_mask(y) & Mat1;
+    status_[2] ^= lsb_mask(y) & Mat2;
+}
+
+uint32_t Tinymt32::temper_() const {
+    uint32_t t0 = status_[3];
+    const uint32_t t1 = status_[0] + (status_[2] >> Sh8);
+
+    t0 ^= t1;
+    t0 ^= lsb_mask(t1) & TMat;
+
+    return t0;
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_fec/tinymt32.h
+//! @brief TinyMT32 pseudo-random number generator.
+
+#ifndef ROC_FEC_TINYMT32_H_
+#define ROC_FEC_TINYMT32_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace fec {
+
+//! TinyMT32 pseudo-random number generator.
+//!
+//! Implemented as specified in RFC 8680, with parameters fixed by the RFC,
+//! so that the same seed produces the same sequence on every peer.
+class Tinymt32 : public core::NonCopyable<> {
+public:
+    //! Initialize generator with given seed.
+    explicit Tinymt32(uint32_t seed);
+
+    //! Generate next 32-bit number.
+    uint32_t next();
+
+private:
+    void next_state_();
+    uint32_t temper_() const;
+
+    uint32_t status_[4];
+};
+
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_TINYMT32_H_
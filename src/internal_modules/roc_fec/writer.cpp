@@ -36,9 +36,22 @@ Writer::Writer(const WriterConfig& config,
     , packet_factory_(packet_factory)
     , buffer_factory_(buffer_factory)
     , repair_block_(allocator)
+    , repair_slots_(allocator)
+    , n_slot_blocks_(1 + config.n_held_blocks)
+    , cur_slot_block_(0)
+    , n_allocated_packets_(0)
+    , n_allocated_buffers_(0)
     , first_packet_(true)
     , cur_packet_(0)
     , fec_scheme_(fec_scheme)
+    , async_(config.async_encoding)
+    , n_async_blocks_(0)
+    , emit_index_(0)
+    , submit_index_(0)
+    , run_index_(0)
+    , work_cond_(mutex_)
+    , done_cond_(mutex_)
+    , stop_(false)
     , valid_(false)
     , alive_(true) {
     cur_sbn_ = (packet::blknum_t)core::fast_random(0, packet::blknum_t(-1));
@@ -46,9 +59,28 @@ Writer::Writer(const WriterConfig& config,
     if (!resize(config.n_source_packets, config.n_repair_packets)) {
         return;
     }
+    if (async_ && !init_async_(config, allocator)) {
+        return;
+    }
     valid_ = true;
 }
 
+Writer::~Writer() {
+    if (!worker_) {
+        return;
+    }
+
+    {
+        core::Mutex::Lock lock(mutex_);
+
+        stop_ = true;
+        work_cond_.broadcast();
+    }
+
+    worker_->join();
+    worker_.reset();
+}
+
 bool Writer::valid() const {
     return valid_;
 }
@@ -57,6 +89,14 @@ bool Writer::alive() const {
     return alive_;
 }
 
+size_t Writer::n_allocated_packets() const {
+    return n_allocated_packets_;
+}
+
+size_t Writer::n_allocated_buffers() const {
+    return n_allocated_buffers_;
+}
+
 bool Writer::resize(size_t sblen, size_t rblen) {
     if (next_sblen_ == sblen && next_rblen_ == rblen) {
         return true;
@@ -99,6 +139,15 @@ void Writer::write(const packet::PacketPtr& pp) {
         return;
     }
 
+    if (async_) {
+        // write repair packets of blocks encoded since previous call
+        while (emit_async_block_(false)) {
+        }
+        if (!alive_) {
+            return;
+        }
+    }
+
     validate_fec_packet_(pp);
 
     if (first_packet_) {
@@ -125,6 +174,34 @@ void Writer::write(const packet::PacketPtr& pp) {
     }
 }
 
+void Writer::refresh() {
+    roc_panic_if_not(valid());
+
+    if (!async_) {
+        return;
+    }
+
+    while (emit_async_block_(false)) {
+    }
+}
+
+void Writer::flush() {
+    roc_panic_if_not(valid());
+
+    if (!async_) {
+        return;
+    }
+
+    while (emit_async_block_(true)) {
+    }
+}
+
+bool Writer::has_pending_blocks() const {
+    roc_panic_if_not(valid());
+
+    return emit_index_ != submit_index_;
+}
+
 bool Writer::begin_block_(const packet::PacketPtr& pp) {
     if (!apply_sizes_(next_sblen_, next_rblen_, pp->fec()->payload.size())) {
         return false;
@@ -135,6 +212,10 @@ bool Writer::begin_block_(const packet::PacketPtr& pp) {
             (unsigned long)cur_sbn_, (unsigned long)cur_sblen_, (unsigned long)cur_rblen_,
             (unsigned long)cur_payload_size_);
 
+    if (async_) {
+        return begin_async_block_();
+    }
+
     if (!encoder_.begin(cur_sblen_, cur_rblen_, cur_payload_size_)) {
         roc_log(LogError,
                 "fec writer: can't begin encoder block, shutting down:"
@@ -148,9 +229,15 @@ bool Writer::begin_block_(const packet::PacketPtr& pp) {
 
 void Writer::end_block_() {
     make_repair_packets_();
+
+    if (async_) {
+        submit_async_block_();
+        return;
+    }
+
     encode_repair_packets_();
-    compose_repair_packets_();
-    write_repair_packets_();
+    compose_repair_packets_(repair_block_);
+    write_repair_packets_(repair_block_);
 
     encoder_.end();
 }
@@ -159,6 +246,7 @@ void Writer::next_block_() {
     cur_block_repair_sn_ += (packet::seqnum_t)cur_rblen_;
     cur_sbn_++;
     cur_packet_ = 0;
+    cur_slot_block_ = (cur_slot_block_ + 1) % n_slot_blocks_;
 }
 
 bool Writer::apply_sizes_(size_t sblen, size_t rblen, size_t payload_size) {
@@ -177,6 +265,18 @@ bool Writer::apply_sizes_(size_t sblen, size_t rblen, size_t payload_size) {
         }
     }
 
+    if (repair_slots_.size() != rblen * n_slot_blocks_) {
+        // slots are bound to packet positions, so they're invalidated
+        // when rblen changes
+        if (!repair_slots_.resize(0) || !repair_slots_.resize(rblen * n_slot_blocks_)) {
+            roc_log(LogError,
+                    "fec writer: can't allocate repair slots memory, shutting down:"
+                    " rbl=%lu n_blocks=%lu",
+                    (unsigned long)rblen, (unsigned long)n_slot_blocks_);
+            return (alive_ = false);
+        }
+    }
+
     cur_sblen_ = sblen;
     cur_rblen_ = rblen;
     cur_payload_size_ = payload_size;
@@ -185,7 +285,11 @@ bool Writer::apply_sizes_(size_t sblen, size_t rblen, size_t payload_size) {
 }
 
 void Writer::write_source_packet_(const packet::PacketPtr& pp) {
-    encoder_.set(cur_packet_, pp->fec()->payload);
+    if (async_) {
+        async_block_(submit_index_).source_payloads[cur_packet_] = pp->fec()->payload;
+    } else {
+        encoder_.set(cur_packet_, pp->fec()->payload);
+    }
 
     pp->add_flags(packet::Packet::FlagComposed);
     fill_packet_fec_fields_(pp, (packet::seqnum_t)cur_packet_);
@@ -208,18 +312,18 @@ void Writer::make_repair_packets_() {
 }
 
 packet::PacketPtr Writer::make_repair_packet_(packet::seqnum_t pack_n) {
-    packet::PacketPtr packet = packet_factory_.new_packet();
+    RepairSlot& slot = repair_slots_[cur_slot_block_ * cur_rblen_ + pack_n];
+
+    packet::PacketPtr packet = recycle_repair_packet_(slot);
     if (!packet) {
-        roc_log(LogError, "fec writer: can't allocate packet");
-        return NULL;
+        packet = new_repair_packet_(slot);
     }
-
-    core::Slice<uint8_t> data = buffer_factory_.new_buffer();
-    if (!data) {
-        roc_log(LogError, "fec writer: can't allocate buffer");
+    if (!packet) {
         return NULL;
     }
 
+    core::Slice<uint8_t> data(slot.buffer);
+
     if (!repair_composer_.align(data, 0, encoder_.alignment())) {
         roc_log(LogError, "fec writer: can't align packet buffer");
         return NULL;
@@ -243,6 +347,65 @@ packet::PacketPtr Writer::make_repair_packet_(packet::seqnum_t pack_n) {
     return packet;
 }
 
+packet::PacketPtr Writer::recycle_repair_packet_(RepairSlot& slot) {
+    if (!slot.packet) {
+        return NULL;
+    }
+
+    // packet may be reused only if the slot holds the only reference to it
+    if (slot.packet->getref() != 1) {
+        slot.packet = NULL;
+        slot.buffer = NULL;
+        return NULL;
+    }
+
+    // drop slices referring to the buffer
+    slot.packet->reset();
+
+    // buffer may be still shared with packets of other destinations
+    if (slot.buffer->getref() != 1) {
+        slot.buffer = new_repair_buffer_();
+        if (!slot.buffer) {
+            slot.packet = NULL;
+            return NULL;
+        }
+    }
+
+    return slot.packet;
+}
+
+packet::PacketPtr Writer::new_repair_packet_(RepairSlot& slot) {
+    packet::PacketPtr packet = packet_factory_.new_packet();
+    if (!packet) {
+        roc_log(LogError, "fec writer: can't allocate packet");
+        return NULL;
+    }
+
+    core::SharedPtr<core::Buffer<uint8_t> > buffer = new_repair_buffer_();
+    if (!buffer) {
+        return NULL;
+    }
+
+    n_allocated_packets_++;
+
+    slot.packet = packet;
+    slot.buffer = buffer;
+
+    return packet;
+}
+
+core::SharedPtr<core::Buffer<uint8_t> > Writer::new_repair_buffer_() {
+    core::SharedPtr<core::Buffer<uint8_t> > buffer = buffer_factory_.new_buffer();
+    if (!buffer) {
+        roc_log(LogError, "fec writer: can't allocate buffer");
+        return NULL;
+    }
+
+    n_allocated_buffers_++;
+
+    return buffer;
+}
+
 void Writer::encode_repair_packets_() {
     for (size_t i = 0; i < cur_rblen_; i++) {
         packet::PacketPtr rp = repair_block_[i];
@@ -253,9 +416,9 @@ void Writer::encode_repair_packets_() {
     encoder_.fill();
 }
 
-void Writer::compose_repair_packets_() {
-    for (size_t i = 0; i < cur_rblen_; i++) {
-        packet::PacketPtr rp = repair_block_[i];
+void Writer::compose_repair_packets_(core::Array<packet::PacketPtr>& repair_block) {
+    for (size_t i = 0; i < repair_block.size(); i++) {
+        packet::PacketPtr rp = repair_block[i];
         if (!rp) {
             continue;
         }
@@ -268,12 +431,12 @@ void Writer::compose_repair_packets_() {
     }
 }
 
-void Writer::write_repair_packets_() {
-    for (size_t i = 0; i < cur_rblen_; i++) {
-        packet::PacketPtr rp = repair_block_[i];
+void Writer::write_repair_packets_(core::Array<packet::PacketPtr>& repair_block) {
+    for (size_t i = 0; i < repair_block.size(); i++) {
+        packet::PacketPtr rp = repair_block[i];
         if (rp) {
-            writer_.write(repair_block_[i]);
-            repair_block_[i] = NULL;
+            writer_.write(repair_block[i]);
+            repair_block[i] = NULL;
         }
     }
 }
@@ -318,5 +481,191 @@ bool Writer::validate_source_packet_(const packet::PacketPtr& pp) {
     return true;
 }
 
+Writer::Worker::Worker(Writer& writer)
+    : writer_(writer) {
+}
+
+void Writer::Worker::run() {
+    writer_.worker_loop_();
+}
+
+bool Writer::init_async_(const WriterConfig& config, core::IAllocator& allocator) {
+    if (config.max_async_blocks == 0 || config.max_async_blocks > MaxAsyncBlocks) {
+        roc_log(LogError,
+                "fec writer: invalid number of async blocks: value=%lu min=1 max=%lu",
+                (unsigned long)config.max_async_blocks, (unsigned long)MaxAsyncBlocks);
+        return false;
+    }
+
+    // Besides blocks being encoded, one block is being filled.
+    n_async_blocks_ = config.max_async_blocks + 1;
+
+    // Repair packets of every block in flight need their own slots.
+    n_slot_blocks_ = n_async_blocks_ + config.n_held_blocks;
+
+    for (size_t n = 0; n < n_async_blocks_; n++) {
+        async_blocks_[n].reset(new (async_blocks_[n]) AsyncBlock(allocator));
+    }
+
+    roc_log(LogDebug, "fec writer: initializing async encoding: max_async_blocks=%lu",
+            (unsigned long)config.max_async_blocks);
+
+    worker_.reset(new (worker_) Worker(*this));
+
+    if (!worker_->start()) {
+        roc_log(LogError, "fec writer: can't start worker thread");
+        worker_.reset();
+        return false;
+    }
+
+    return true;
+}
+
+bool Writer::begin_async_block_() {
+    // limit number of blocks being encoded, waiting for the oldest one
+    while (submit_index_ - emit_index_ >= n_async_blocks_ - 1) {
+        emit_async_block_(true);
+    }
+
+    if (!alive_) {
+        return false;
+    }
+
+    AsyncBlock& block = async_block_(submit_index_);
+
+    roc_panic_if_not(block.state == AsyncFree);
+
+    if (!block.source_payloads.resize(cur_sblen_)
+        || !block.repair_payloads.resize(cur_rblen_)
+        || !block.repair_block.resize(cur_rblen_)) {
+        roc_log(LogError,
+                "fec writer: can't allocate async block memory, shutting down:"
+                " sblen=%lu rblen=%lu",
+                (unsigned long)cur_sblen_, (unsigned long)cur_rblen_);
+        return (alive_ = false);
+    }
+
+    block.sblen = cur_sblen_;
+    block.rblen = cur_rblen_;
+    block.payload_size = cur_payload_size_;
+    block.failed = false;
+
+    return true;
+}
+
+void Writer::submit_async_block_() {
+    AsyncBlock& block = async_block_(submit_index_);
+
+    for (size_t i = 0; i < cur_rblen_; i++) {
+        if (repair_block_[i]) {
+            block.repair_payloads[i] = repair_block_[i]->fec()->payload;
+        }
+        block.repair_block[i] = repair_block_[i];
+        repair_block_[i] = NULL;
+    }
+
+    core::Mutex::Lock lock(mutex_);
+
+    block.state = AsyncPending;
+    submit_index_++;
+
+    work_cond_.signal();
+}
+
+bool Writer::emit_async_block_(bool wait) {
+    if (emit_index_ == submit_index_) {
+        return false;
+    }
+
+    AsyncBlock& block = async_block_(emit_index_);
+
+    {
+        core::Mutex::Lock lock(mutex_);
+
+        if (!wait && block.state != AsyncDone) {
+            return false;
+        }
+
+        while (block.state != AsyncDone) {
+            done_cond_.wait();
+        }
+    }
+
+    if (block.failed) {
+        roc_log(LogError,
+                "fec writer: can't begin encoder block, shutting down:"
+                " sblen=%lu rblen=%lu",
+                (unsigned long)block.sblen, (unsigned long)block.rblen);
+        alive_ = false;
+    }
+
+    if (alive_) {
+        compose_repair_packets_(block.repair_block);
+        write_repair_packets_(block.repair_block);
+    }
+
+    for (size_t i = 0; i < block.sblen; i++) {
+        block.source_payloads[i] = core::Slice<uint8_t>();
+    }
+    for (size_t i = 0; i < block.rblen; i++) {
+        block.repair_payloads[i] = core::Slice<uint8_t>();
+        block.repair_block[i] = NULL;
+    }
+
+    block.state = AsyncFree;
+    emit_index_++;
+
+    return true;
+}
+
+void Writer::worker_loop_() {
+    mutex_.lock();
+
+    for (;;) {
+        while (!stop_ && run_index_ >= submit_index_) {
+            work_cond_.wait();
+        }
+
+        if (stop_) {
+            break;
+        }
+
+        AsyncBlock& block = async_block_(run_index_++);
+
+        mutex_.unlock();
+        encode_async_block_(block);
+        mutex_.lock();
+
+        block.state = AsyncDone;
+        done_cond_.broadcast();
+    }
+
+    mutex_.unlock();
+}
+
+void Writer::encode_async_block_(AsyncBlock& block) {
+    if (!encoder_.begin(block.sblen, block.rblen, block.payload_size)) {
+        block.failed = true;
+        return;
+    }
+
+    for (size_t i = 0; i < block.sblen; i++) {
+        encoder_.set(i, block.source_payloads[i]);
+    }
+
+    for (size_t i = 0; i < block.rblen; i++) {
+        if (block.repair_payloads[i]) {
+            encoder_.set(block.sblen + i, block.repair_payloads[i]);
+        }
+    }
+
+    encoder_.fill();
+    encoder_.end();
+}
+
+Writer::AsyncBlock& Writer::async_block_(size_t index) {
+    return *async_blocks_[index % n_async_blocks_];
+}
+
 } // namespace fec
 } // namespace roc
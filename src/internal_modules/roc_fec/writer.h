@@ -14,9 +14,13 @@
 
 #include "roc_core/array.h"
 #include "roc_core/buffer_factory.h"
+#include "roc_core/cond.h"
 #include "roc_core/iallocator.h"
+#include "roc_core/mutex.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/optional.h"
 #include "roc_core/slice.h"
+#include "roc_core/thread.h"
 #include "roc_fec/iblock_encoder.h"
 #include "roc_packet/icomposer.h"
 #include "roc_packet/iwriter.h"
@@ -34,15 +38,51 @@ struct WriterConfig {
     //! Number of FEC packets in block.
     size_t n_repair_packets;
 
+    //! Encode repair packets on a background thread.
+    //! @remarks
+    //!  If enabled, source packets are written immediately, and repair
+    //!  packets of a block are written by one of the following write()
+    //!  calls, when background encoding of the block is finished.
+    bool async_encoding;
+
+    //! Maximum number of blocks being encoded in background.
+    //! @remarks
+    //!  Used only if async_encoding is enabled. When the limit is reached,
+    //!  write() blocks until encoding of the oldest block is finished.
+    size_t max_async_blocks;
+
+    //! Number of blocks which packets may be held by writers following
+    //! FEC writer, e.g. by block interleaver.
+    //! @remarks
+    //!  Repair packets of that many previous blocks are not expected to be
+    //!  released yet and get their own recycling slots.
+    size_t n_held_blocks;
+
     WriterConfig()
         : n_source_packets(20)
-        , n_repair_packets(10) {
+        , n_repair_packets(10)
+        , async_encoding(false)
+        , max_async_blocks(2)
+        , n_held_blocks(0) {
     }
 };
 
 //! FEC writer.
+//!
+//! Repair packets and their buffers are recycled from block to block: when
+//! all other references to a repair packet and its buffer are released, the
+//! packet is reset and reused for the same position in a later block. If only
+//! the buffer is still in use, the packet is reused with a new buffer. The
+//! encoder writes repair symbols directly into packet payloads.
+//!
+//! In asynchronous mode, the encoder is used exclusively by a background
+//! thread. Repair packets are still allocated, composed, and written on
+//! the calling thread, in block order.
 class Writer : public packet::IWriter, public core::NonCopyable<> {
 public:
+    //! Maximum allowed number of blocks being encoded in background.
+    enum { MaxAsyncBlocks = 16 };
+
     //! Initialize.
     //!
     //! @b Parameters
@@ -64,12 +104,27 @@ public:
            core::BufferFactory<uint8_t>& buffer_factory,
            core::IAllocator& allocator);
 
+    //! Stop background thread, if any.
+    //! @remarks
+    //!  Repair packets of blocks that are still being encoded are dropped.
+    virtual ~Writer();
+
     //! Check if object is successfully constructed.
     bool valid() const;
 
     //! Check if writer is still working.
     bool alive() const;
 
+    //! Get number of repair packets allocated so far.
+    //! @remarks
+    //!  Doesn't grow when repair packets are recycled.
+    size_t n_allocated_packets() const;
+
+    //! Get number of repair buffers allocated so far.
+    //! @remarks
+    //!  Doesn't grow when repair buffers are recycled.
+    size_t n_allocated_buffers() const;
+
     //! Set number of source packets per block.
     bool resize(size_t sblen, size_t rblen);
 
@@ -79,7 +134,85 @@ public:
     //!  - generates repair packets and also writes them to the output writer
     virtual void write(const packet::PacketPtr&);
 
+    //! Write repair packets of blocks which are already encoded.
+    //! @remarks
+    //!  In asynchronous mode, writes repair packets of blocks for which
+    //!  background encoding is finished, without waiting for other blocks.
+    //!  Should be called periodically, so that repair packets aren't held
+    //!  until next write() when the stream is slow or stopped.
+    //!  In synchronous mode, does nothing.
+    void refresh();
+
+    //! Write repair packets of all complete blocks.
+    //! @remarks
+    //!  In asynchronous mode, waits until background encoding of all
+    //!  complete blocks is finished and writes their repair packets.
+    //!  Should be called when the stream is stopped or paused.
+    //!  In synchronous mode, does nothing.
+    void flush();
+
+    //! Check if there are complete blocks which repair packets are not
+    //! written yet.
+    //! @remarks
+    //!  Always false in synchronous mode.
+    bool has_pending_blocks() const;
+
 private:
+    enum AsyncState { AsyncFree, AsyncPending, AsyncDone };
+
+    struct AsyncBlock {
+        // payloads are captured by caller thread and are the only thing
+        // touched by worker thread; packets themselves may be modified
+        // concurrently by downstream writers
+        core::Array<core::Slice<uint8_t> > source_payloads;
+        core::Array<core::Slice<uint8_t> > repair_payloads;
+        core::Array<packet::PacketPtr> repair_block;
+
+        size_t sblen;
+        size_t rblen;
+        size_t payload_size;
+
+        AsyncState state;
+        bool failed;
+
+        AsyncBlock(core::IAllocator& allocator)
+            : source_payloads(allocator)
+            , repair_payloads(allocator)
+            , repair_block(allocator)
+            , sblen(0)
+            , rblen(0)
+            , payload_size(0)
+            , state(AsyncFree)
+            , failed(false) {
+        }
+    };
+
+    struct RepairSlot {
+        packet::PacketPtr packet;
+        core::SharedPtr<core::Buffer<uint8_t> > buffer;
+    };
+
+    class Worker : public core::Thread {
+    public:
+        Worker(Writer& writer);
+
+    private:
+        virtual void run();
+
+        Writer& writer_;
+    };
+
+    bool init_async_(const WriterConfig& config, core::IAllocator& allocator);
+
+    bool begin_async_block_();
+    void submit_async_block_();
+    bool emit_async_block_(bool wait);
+
+    void worker_loop_();
+    void encode_async_block_(AsyncBlock& block);
+
+    AsyncBlock& async_block_(size_t index);
+
     bool begin_block_(const packet::PacketPtr& pp);
     void end_block_();
     void next_block_();
@@ -89,9 +222,12 @@ private:
     void write_source_packet_(const packet::PacketPtr&);
     void make_repair_packets_();
     packet::PacketPtr make_repair_packet_(packet::seqnum_t n);
+    packet::PacketPtr recycle_repair_packet_(RepairSlot& slot);
+    packet::PacketPtr new_repair_packet_(RepairSlot& slot);
+    core::SharedPtr<core::Buffer<uint8_t> > new_repair_buffer_();
     void encode_repair_packets_();
-    void compose_repair_packets_();
-    void write_repair_packets_();
+    void compose_repair_packets_(core::Array<packet::PacketPtr>& repair_block);
+    void write_repair_packets_(core::Array<packet::PacketPtr>& repair_block);
     void fill_packet_fec_fields_(const packet::PacketPtr& packet, packet::seqnum_t n);
 
     void validate_fec_packet_(const packet::PacketPtr&);
@@ -116,6 +252,14 @@ private:
 
     core::Array<packet::PacketPtr> repair_block_;
 
+    // repair packets of last blocks, for reuse in next blocks
+    core::Array<RepairSlot> repair_slots_;
+    size_t n_slot_blocks_;
+    size_t cur_slot_block_;
+
+    size_t n_allocated_packets_;
+    size_t n_allocated_buffers_;
+
     bool first_packet_;
 
     packet::blknum_t cur_sbn_;
@@ -125,6 +269,25 @@ private:
 
     const packet::FecScheme fec_scheme_;
 
+    const bool async_;
+
+    core::Optional<AsyncBlock> async_blocks_[MaxAsyncBlocks + 1];
+    size_t n_async_blocks_;
+
+    // first block which repair packets weren't written yet
+    size_t emit_index_;
+    // first block that wasn't handed to worker yet
+    size_t submit_index_;
+    // first block that wasn't taken by worker yet
+    size_t run_index_;
+
+    core::Mutex mutex_;
+    core::Cond work_cond_;
+    core::Cond done_cond_;
+    bool stop_;
+
+    core::Optional<Worker> worker_;
+
     bool valid_;
     bool alive_;
 };
@@ -24,7 +24,17 @@ enum IOError {
     IOErr_StreamEnd = -2,
 
     //! Failure.
-    IOErr_Failure = -3
+    IOErr_Failure = -3,
+
+    //! Remote peer refused datagram.
+    //! Reported by connected datagram sockets after receiving ICMP
+    //! port unreachable error.
+    IOErr_Refused = -4,
+
+    //! Remote host or network is unreachable.
+    //! Reported by connected datagram sockets after receiving ICMP
+    //! host or network unreachable error.
+    IOErr_Unreachable = -5
 };
 
 } // namespace netio
@@ -91,6 +91,49 @@ NetworkLoop::Tasks::RemovePort::RemovePort(PortHandle handle) {
     port_ = (BasicPort*)handle;
 }
 
+NetworkLoop::Tasks::QueryUdpSenderPort::QueryUdpSenderPort(PortHandle handle) {
+    func_ = &NetworkLoop::task_query_udp_sender_;
+    if (!handle) {
+        roc_panic("network loop: handle is null");
+    }
+    port_ = (BasicPort*)handle;
+}
+
+const UdpSenderConnectStats&
+NetworkLoop::Tasks::QueryUdpSenderPort::get_connect_stats() const {
+    roc_panic_if_not(success());
+    return connect_stats_;
+}
+
+const UdpSenderPacingStats&
+NetworkLoop::Tasks::QueryUdpSenderPort::get_pacing_stats() const {
+    roc_panic_if_not(success());
+    return pacing_stats_;
+}
+
+NetworkLoop::Tasks::QueryUdpReceiverPort::QueryUdpReceiverPort(PortHandle handle) {
+    func_ = &NetworkLoop::task_query_udp_receiver_;
+    if (!handle) {
+        roc_panic("network loop: handle is null");
+    }
+    port_ = (BasicPort*)handle;
+}
+
+const UdpReceiverBusyPollStats&
+NetworkLoop::Tasks::QueryUdpReceiverPort::get_busy_poll_stats() const {
+    roc_panic_if_not(success());
+    return busy_poll_stats_;
+}
+
+NetworkLoop::Tasks::DisableUdpSenderConnect::DisableUdpSenderConnect(
+    PortHandle handle) {
+    func_ = &NetworkLoop::task_disable_udp_sender_connect_;
+    if (!handle) {
+        roc_panic("network loop: handle is null");
+    }
+    port_ = (BasicPort*)handle;
+}
+
 NetworkLoop::Tasks::ResolveEndpointAddress::ResolveEndpointAddress(
     const address::EndpointUri& endpoint_uri) {
     func_ = &NetworkLoop::task_resolve_endpoint_address_;
@@ -570,6 +613,40 @@ void NetworkLoop::task_remove_port_(NetworkTask& base_task) {
     }
 }
 
+void NetworkLoop::task_query_udp_sender_(NetworkTask& base_task) {
+    Tasks::QueryUdpSenderPort& task = (Tasks::QueryUdpSenderPort&)base_task;
+
+    UdpSenderPort& port = (UdpSenderPort&)*task.port_;
+
+    task.connect_stats_ = port.connect_stats();
+    task.pacing_stats_ = port.pacing_stats();
+
+    task.success_ = true;
+    task.state_ = NetworkTask::StateFinishing;
+}
+
+void NetworkLoop::task_query_udp_receiver_(NetworkTask& base_task) {
+    Tasks::QueryUdpReceiverPort& task = (Tasks::QueryUdpReceiverPort&)base_task;
+
+    UdpReceiverPort& port = (UdpReceiverPort&)*task.port_;
+
+    task.busy_poll_stats_ = port.busy_poll_stats();
+
+    task.success_ = true;
+    task.state_ = NetworkTask::StateFinishing;
+}
+
+void NetworkLoop::task_disable_udp_sender_connect_(NetworkTask& base_task) {
+    Tasks::DisableUdpSenderConnect& task = (Tasks::DisableUdpSenderConnect&)base_task;
+
+    UdpSenderPort& port = (UdpSenderPort&)*task.port_;
+
+    port.disable_connect();
+
+    task.success_ = true;
+    task.state_ = NetworkTask::StateFinishing;
+}
+
 void NetworkLoop::task_resolve_endpoint_address_(NetworkTask& base_task) {
     Tasks::ResolveEndpointAddress& task = (Tasks::ResolveEndpointAddress&)base_task;
 
@@ -161,6 +161,65 @@ public:
             friend class NetworkLoop;
         };
 
+        //! Query UDP sender port statistics.
+        class QueryUdpSenderPort : public NetworkTask {
+        public:
+            //! Set task parameters.
+            //! @pre
+            //!  @p handle should be returned by AddUdpSenderPort.
+            QueryUdpSenderPort(PortHandle handle);
+
+            //! Get connection statistics.
+            //! @pre
+            //!  Should be called only if success() is true.
+            const UdpSenderConnectStats& get_connect_stats() const;
+
+            //! Get pacing statistics.
+            //! @pre
+            //!  Should be called only if success() is true.
+            const UdpSenderPacingStats& get_pacing_stats() const;
+
+        private:
+            friend class NetworkLoop;
+
+            UdpSenderConnectStats connect_stats_;
+            UdpSenderPacingStats pacing_stats_;
+        };
+
+        //! Query UDP receiver port statistics.
+        class QueryUdpReceiverPort : public NetworkTask {
+        public:
+            //! Set task parameters.
+            //! @pre
+            //!  @p handle should be returned by AddUdpReceiverPort.
+            QueryUdpReceiverPort(PortHandle handle);
+
+            //! Get busy polling statistics.
+            //! @pre
+            //!  Should be called only if success() is true.
+            const UdpReceiverBusyPollStats& get_busy_poll_stats() const;
+
+        private:
+            friend class NetworkLoop;
+
+            UdpReceiverBusyPollStats busy_poll_stats_;
+        };
+
+        //! Disable connecting UDP sender port to remote address.
+        //! @remarks
+        //!  Used when port is shared by several destinations, e.g. source
+        //!  and repair endpoints, so it can't be connected to one of them.
+        class DisableUdpSenderConnect : public NetworkTask {
+        public:
+            //! Set task parameters.
+            //! @pre
+            //!  @p handle should be returned by AddUdpSenderPort.
+            DisableUdpSenderConnect(PortHandle handle);
+
+        private:
+            friend class NetworkLoop;
+        };
+
         //! Resolve endpoint address.
         class ResolveEndpointAddress : public NetworkTask {
         public:
@@ -240,6 +299,9 @@ private:
     void task_add_udp_receiver_(NetworkTask&);
     void task_add_udp_sender_(NetworkTask&);
     void task_remove_port_(NetworkTask&);
+    void task_query_udp_sender_(NetworkTask&);
+    void task_query_udp_receiver_(NetworkTask&);
+    void task_disable_udp_sender_connect_(NetworkTask&);
     void task_add_tcp_server_(NetworkTask&);
     void task_add_tcp_client_(NetworkTask&);
     void task_resolve_endpoint_address_(NetworkTask&);
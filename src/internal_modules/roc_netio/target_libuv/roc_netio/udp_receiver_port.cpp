@@ -8,6 +8,7 @@
 
 #include "roc_netio/udp_receiver_port.h"
 #include "roc_address/socket_addr_to_str.h"
+#include "roc_core/cpu_instructions.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
 #include "roc_core/shared_ptr.h"
@@ -16,6 +17,13 @@
 namespace roc {
 namespace netio {
 
+namespace {
+
+const core::nanoseconds_t BusyPollLogInterval = 20 * core::Second;
+const core::nanoseconds_t BusyPollErrorLogInterval = 5 * core::Second;
+
+} // namespace
+
 UdpReceiverPort::UdpReceiverPort(const UdpReceiverConfig& config,
                                  packet::IWriter& writer,
                                  uv_loop_t& event_loop,
@@ -34,7 +42,15 @@ UdpReceiverPort::UdpReceiverPort(const UdpReceiverConfig& config,
     , closed_(false)
     , packet_factory_(packet_factory)
     , buffer_factory_(buffer_factory)
-    , packet_counter_(0) {
+    , packet_counter_(0)
+    , fd_(SocketInvalid)
+    , kernel_timestamps_(false)
+    , busy_started_(false)
+    , busy_stop_(0)
+    , busy_stats_pub_(UdpReceiverBusyPollStats())
+    , busy_rate_limiter_(BusyPollLogInterval)
+    , busy_n_errors_(0)
+    , busy_error_limiter_(BusyPollErrorLogInterval) {
     BasicPort::update_descriptor();
 }
 
@@ -97,21 +113,48 @@ bool UdpReceiverPort::open() {
         return false;
     }
 
+    uv_os_fd_t fd;
+    if (int err = uv_fileno((uv_handle_t*)&handle_, &fd)) {
+        roc_log(LogError, "udp receiver: %s: uv_fileno(): [%s] %s", descriptor(),
+                uv_err_name(err), uv_strerror(err));
+        return false;
+    }
+
+    fd_ = (SocketHandle)fd;
+
     if (config_.multicast_interface[0]) {
         if (!join_multicast_group_()) {
             return false;
         }
     }
 
-    if (int err = uv_udp_recv_start(&handle_, alloc_cb_, recv_cb_)) {
-        roc_log(LogError, "udp receiver: %s: uv_udp_recv_start(): [%s] %s", descriptor(),
-                uv_err_name(err), uv_strerror(err));
-        return false;
+    if (config_.kernel_timestamps) {
+        kernel_timestamps_ = socket_set_recv_timestamps(fd_);
+        if (!kernel_timestamps_) {
+            roc_log(LogDebug,
+                    "udp receiver: %s: kernel timestamps not available,"
+                    " falling back to user-space timestamps",
+                    descriptor());
+        }
     }
 
-    recv_started_ = true;
+    // must be updated before starting busy polling thread, which uses descriptor
     update_descriptor();
 
+    if (config_.busy_polling) {
+        if (!start_busy_polling_()) {
+            return false;
+        }
+    } else {
+        if (int err = uv_udp_recv_start(&handle_, alloc_cb_, recv_cb_)) {
+            roc_log(LogError, "udp receiver: %s: uv_udp_recv_start(): [%s] %s",
+                    descriptor(), uv_err_name(err), uv_strerror(err));
+            return false;
+        }
+
+        recv_started_ = true;
+    }
+
     roc_log(LogDebug, "udp receiver: %s: opened port", descriptor());
 
     return true;
@@ -136,6 +179,10 @@ AsyncOperationStatus UdpReceiverPort::async_close(ICloseHandler& handler,
 
     roc_log(LogDebug, "udp receiver: %s: initiating asynchronous close", descriptor());
 
+    if (busy_started_) {
+        stop_busy_polling_();
+    }
+
     if (recv_started_) {
         if (int err = uv_udp_recv_stop(&handle_)) {
             roc_log(LogError, "udp receiver: %s: uv_udp_recv_stop(): [%s] %s",
@@ -155,6 +202,10 @@ AsyncOperationStatus UdpReceiverPort::async_close(ICloseHandler& handler,
     return AsyncOp_Started;
 }
 
+UdpReceiverBusyPollStats UdpReceiverPort::busy_poll_stats() const {
+    return busy_stats_pub_.wait_load();
+}
+
 void UdpReceiverPort::close_cb_(uv_handle_t* handle) {
     roc_panic_if_not(handle);
 
@@ -264,32 +315,273 @@ void UdpReceiverPort::recv_cb_(uv_udp_t* handle,
         return;
     }
 
-    self.packet_counter_++;
+    core::nanoseconds_t receive_timestamp = 0;
+    if (!self.kernel_timestamps_
+        || !socket_get_recv_timestamp(self.fd_, receive_timestamp)) {
+        receive_timestamp = core::timestamp(core::ClockUnix);
+    }
+
+    self.handle_packet_(bp, (size_t)nread, src_addr, receive_timestamp);
+}
+
+bool UdpReceiverPort::start_busy_polling_() {
+    if (config_.socket_busy_poll_duration > 0) {
+        if (!socket_set_busy_poll(fd_, config_.socket_busy_poll_duration)) {
+            roc_log(LogInfo,
+                    "udp receiver: %s: can't enable SO_BUSY_POLL,"
+                    " continuing without it",
+                    descriptor());
+        }
+    }
+
+    busy_stop_ = 0;
+
+    if (!core::Thread::start()) {
+        roc_log(LogError, "udp receiver: %s: can't start busy polling thread",
+                descriptor());
+        return false;
+    }
+
+    busy_started_ = true;
+
+    roc_log(LogDebug,
+            "udp receiver: %s: started busy polling thread:"
+            " spin_duration=%.3fms park_timeout=%.3fms socket_busy_poll=%.3fms",
+            descriptor(), (double)config_.busy_polling_spin_duration / core::Millisecond,
+            (double)config_.busy_polling_park_timeout / core::Millisecond,
+            (double)config_.socket_busy_poll_duration / core::Millisecond);
+
+    return true;
+}
+
+void UdpReceiverPort::stop_busy_polling_() {
+    roc_log(LogDebug, "udp receiver: %s: stopping busy polling thread", descriptor());
+
+    busy_stop_ = 1;
+    core::Thread::join();
+
+    busy_started_ = false;
+    busy_buffer_ = NULL;
+
+    busy_rate_limiter_.allow();
+    report_busy_poll_stats_();
+}
+
+void UdpReceiverPort::run() {
+    roc_log(LogDebug, "udp receiver: %s: entering busy polling loop", descriptor());
+
+    // Time when we started spinning on empty socket, or zero if we're
+    // not spinning, i.e. the last read was successful or we were just unparked.
+    core::nanoseconds_t spin_start = 0;
+    bool unparked = false;
+
+    // Delay before next read after an error, or zero if last read didn't fail.
+    core::nanoseconds_t error_backoff = 0;
+
+    while (!busy_stop_) {
+        core::nanoseconds_t delivery_delay = 0;
+
+        const BusyReadStatus status = try_busy_read_(delivery_delay);
+
+        if (status == BusyRead_Error) {
+            // Persistent errors would otherwise make us spin on the failing
+            // socket or allocator, so sleep with growing delay.
+            error_backoff = busy_error_backoff_(error_backoff);
+            core::sleep_for(core::ClockMonotonic, error_backoff);
+
+            spin_start = 0;
+            unparked = false;
+
+            continue;
+        }
+
+        error_backoff = 0;
+
+        if (status == BusyRead_Packet) {
+            busy_stats_.n_packets++;
+
+            if (unparked) {
+                busy_stats_.n_parked_packets++;
+                busy_stats_.parked_delivery_delay += delivery_delay;
+            } else if (spin_start != 0) {
+                busy_stats_.n_spin_packets++;
+                busy_stats_.spin_delivery_delay += delivery_delay;
+                busy_stats_.spin_time +=
+                    core::timestamp(core::ClockMonotonic) - spin_start;
+            }
+
+            spin_start = 0;
+            unparked = false;
+
+            busy_stats_pub_.exclusive_store(busy_stats_);
+            report_busy_poll_stats_();
+
+            continue;
+        }
+
+        const core::nanoseconds_t now = core::timestamp(core::ClockMonotonic);
+
+        if (spin_start == 0) {
+            spin_start = now;
+        }
+
+        if (now - spin_start < config_.busy_polling_spin_duration) {
+            core::cpu_relax();
+            continue;
+        }
+
+        busy_stats_.n_parks++;
+        busy_stats_.spin_time += now - spin_start;
+        busy_stats_pub_.exclusive_store(busy_stats_);
+
+        // Park until socket becomes readable. Timeout is needed to periodically
+        // check busy_stop_ flag.
+        socket_wait_readable(fd_, config_.busy_polling_park_timeout);
+
+        spin_start = 0;
+        unparked = true;
+    }
+
+    roc_log(LogDebug, "udp receiver: %s: exiting busy polling loop", descriptor());
+}
+
+UdpReceiverPort::BusyReadStatus
+UdpReceiverPort::try_busy_read_(core::nanoseconds_t& delivery_delay) {
+    if (!busy_buffer_) {
+        busy_buffer_ = buffer_factory_.new_buffer();
+        if (!busy_buffer_) {
+            busy_n_errors_++;
+            if (busy_error_limiter_.allow()) {
+                roc_log(LogError, "udp receiver: %s: can't allocate buffer: n_errors=%lu",
+                        descriptor(), (unsigned long)busy_n_errors_);
+                busy_n_errors_ = 0;
+            }
+            return BusyRead_Error;
+        }
+    }
+
+    address::SocketAddr src_addr;
+    core::nanoseconds_t receive_timestamp = 0;
+
+    const ssize_t nread =
+        socket_try_recv_from(fd_, busy_buffer_->data(), busy_buffer_->size(), src_addr,
+                             kernel_timestamps_ ? &receive_timestamp : NULL);
+
+    if (nread == IOErr_WouldBlock) {
+        return BusyRead_Empty;
+    }
+
+    if (nread < 0) {
+        busy_n_errors_++;
+        if (busy_error_limiter_.allow()) {
+            roc_log(LogError,
+                    "udp receiver: %s: network error: num=%u dst=%s n_errors=%lu",
+                    descriptor(), packet_counter_,
+                    address::socket_addr_to_str(config_.bind_address).c_str(),
+                    (unsigned long)busy_n_errors_);
+            busy_n_errors_ = 0;
+        }
+        return BusyRead_Error;
+    }
+
+    if (nread == 0) {
+        roc_log(LogTrace, "udp receiver: %s: empty packet: num=%u src=%s dst=%s",
+                descriptor(), packet_counter_,
+                address::socket_addr_to_str(src_addr).c_str(),
+                address::socket_addr_to_str(config_.bind_address).c_str());
+        return BusyRead_Packet;
+    }
+
+    const core::nanoseconds_t now = core::timestamp(core::ClockUnix);
+
+    if (receive_timestamp != 0) {
+        delivery_delay = now - receive_timestamp;
+    } else {
+        receive_timestamp = now;
+    }
+
+    core::SharedPtr<core::Buffer<uint8_t> > bp = busy_buffer_;
+    busy_buffer_ = NULL;
+
+    handle_packet_(bp, (size_t)nread, src_addr, receive_timestamp);
+
+    return BusyRead_Packet;
+}
+
+core::nanoseconds_t
+UdpReceiverPort::busy_error_backoff_(core::nanoseconds_t prev_backoff) const {
+    // Start with spin duration, so that a single transient error (like ICMP
+    // error reported on socket) doesn't delay following packets much, and
+    // double it up to park timeout for errors that don't go away.
+    core::nanoseconds_t backoff = prev_backoff * 2;
+    if (backoff < config_.busy_polling_spin_duration) {
+        backoff = config_.busy_polling_spin_duration;
+    }
+    if (backoff > config_.busy_polling_park_timeout) {
+        backoff = config_.busy_polling_park_timeout;
+    }
+    if (backoff < core::Microsecond) {
+        backoff = core::Microsecond;
+    }
+    return backoff;
+}
+
+void UdpReceiverPort::report_busy_poll_stats_() {
+    if (!busy_rate_limiter_.allow()) {
+        return;
+    }
+
+    const double spin_ratio = busy_stats_.n_packets != 0
+        ? (double)busy_stats_.n_spin_packets / busy_stats_.n_packets
+        : 0.;
+
+    const double spin_delay = busy_stats_.n_spin_packets != 0
+        ? (double)busy_stats_.spin_delivery_delay / busy_stats_.n_spin_packets
+        : 0.;
+
+    const double parked_delay = busy_stats_.n_parked_packets != 0
+        ? (double)busy_stats_.parked_delivery_delay / busy_stats_.n_parked_packets
+        : 0.;
+
+    roc_log(LogDebug,
+            "udp receiver: %s: busy polling: total=%lu spin=%lu parked=%lu parks=%lu"
+            " spin_ratio=%.5f spin_time=%.3fms spin_delay=%.3fus parked_delay=%.3fus",
+            descriptor(), busy_stats_.n_packets, busy_stats_.n_spin_packets,
+            busy_stats_.n_parked_packets, busy_stats_.n_parks, spin_ratio,
+            (double)busy_stats_.spin_time / core::Millisecond,
+            spin_delay / core::Microsecond, parked_delay / core::Microsecond);
+}
+
+void UdpReceiverPort::handle_packet_(const core::SharedPtr<core::Buffer<uint8_t> >& bp,
+                                     size_t nread,
+                                     const address::SocketAddr& src_addr,
+                                     core::nanoseconds_t receive_timestamp) {
+    packet_counter_++;
 
     roc_log(LogTrace, "udp receiver: %s: received packet: num=%u src=%s dst=%s nread=%ld",
-            self.descriptor(), self.packet_counter_,
-            address::socket_addr_to_str(src_addr).c_str(),
-            address::socket_addr_to_str(self.config_.bind_address).c_str(), (long)nread);
+            descriptor(), packet_counter_, address::socket_addr_to_str(src_addr).c_str(),
+            address::socket_addr_to_str(config_.bind_address).c_str(), (long)nread);
 
-    if ((size_t)nread > bp->size()) {
+    if (nread > bp->size()) {
         roc_panic("udp receiver: %s: unexpected buffer size: got %ld, max %ld",
-                  self.descriptor(), (long)nread, (long)bp->size());
+                  descriptor(), (long)nread, (long)bp->size());
     }
 
-    packet::PacketPtr pp = self.packet_factory_.new_packet();
+    packet::PacketPtr pp = packet_factory_.new_packet();
     if (!pp) {
-        roc_log(LogError, "udp receiver: %s: can't allocate packet", self.descriptor());
+        roc_log(LogError, "udp receiver: %s: can't allocate packet", descriptor());
         return;
     }
 
     pp->add_flags(packet::Packet::FlagUDP);
 
     pp->udp()->src_addr = src_addr;
-    pp->udp()->dst_addr = self.config_.bind_address;
+    pp->udp()->dst_addr = config_.bind_address;
+    pp->udp()->receive_timestamp = receive_timestamp;
 
-    pp->set_data(core::Slice<uint8_t>(*bp, 0, (size_t)nread));
+    pp->set_data(core::Slice<uint8_t>(*bp, 0, nread));
 
-    self.writer_.write(pp);
+    writer_.write(pp);
 }
 
 bool UdpReceiverPort::join_multicast_group_() {
@@ -345,6 +637,10 @@ void UdpReceiverPort::format_descriptor(core::StringBuilder& b) {
     b.append_str(" bind=");
     b.append_str(address::socket_addr_to_str(config_.bind_address).c_str());
 
+    if (config_.busy_polling) {
+        b.append_str(" busypoll");
+    }
+
     b.append_str(">");
 }
 
@@ -15,12 +15,18 @@
 #include <uv.h>
 
 #include "roc_address/socket_addr.h"
+#include "roc_core/atomic.h"
 #include "roc_core/buffer_factory.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/list.h"
 #include "roc_core/list_node.h"
+#include "roc_core/rate_limiter.h"
+#include "roc_core/seqlock.h"
+#include "roc_core/thread.h"
+#include "roc_core/time.h"
 #include "roc_netio/basic_port.h"
 #include "roc_netio/iclose_handler.h"
+#include "roc_netio/socket_ops.h"
 #include "roc_packet/iwriter.h"
 #include "roc_packet/packet_factory.h"
 
@@ -43,14 +49,85 @@ struct UdpReceiverConfig {
     //! binding to non-ephemeral port.
     bool reuseaddr;
 
+    //! If set, receive packets on a dedicated thread that spins on non-blocking
+    //! reads instead of waiting for event loop wakeups.
+    //! Received packets are passed to the writer from that thread.
+    bool busy_polling;
+
+    //! How long busy polling thread spins on empty socket before parking.
+    //! After parking, the thread sleeps until socket becomes readable.
+    //! If zero, the thread parks immediately after each empty read.
+    core::nanoseconds_t busy_polling_spin_duration;
+
+    //! Maximum time busy polling thread stays parked before re-checking
+    //! whether it should exit. Bounds the time needed to close the port.
+    core::nanoseconds_t busy_polling_park_timeout;
+
+    //! If non-zero, enable SO_BUSY_POLL on the socket with given duration,
+    //! so that kernel polls device queue on empty reads. Ignored if not
+    //! supported by platform.
+    core::nanoseconds_t socket_busy_poll_duration;
+
+    //! If set, enable kernel receive timestamps on the socket.
+    //! Each received packet gets the time when it was received by the kernel.
+    //! If not set or not supported by platform, packets are timestamped by
+    //! the receiver port itself, when they are read from the socket.
+    bool kernel_timestamps;
+
     UdpReceiverConfig()
-        : reuseaddr(false) {
+        : reuseaddr(false)
+        , busy_polling(false)
+        , busy_polling_spin_duration(200 * core::Microsecond)
+        , busy_polling_park_timeout(100 * core::Millisecond)
+        , socket_busy_poll_duration(0)
+        , kernel_timestamps(true) {
         multicast_interface[0] = '\0';
     }
 };
 
+//! UDP receiver busy polling statistics.
+struct UdpReceiverBusyPollStats {
+    //! Total number of packets received by busy polling thread.
+    unsigned long n_packets;
+
+    //! Number of packets received while spinning after an empty read.
+    //! Each such packet would otherwise require an event loop wakeup.
+    unsigned long n_spin_packets;
+
+    //! Number of packets received right after thread was unparked.
+    unsigned long n_parked_packets;
+
+    //! Number of times the thread was parked.
+    unsigned long n_parks;
+
+    //! Total time spent spinning on empty socket.
+    core::nanoseconds_t spin_time;
+
+    //! Sum of delivery delays of packets received while spinning.
+    //! Delivery delay is the time between kernel receive timestamp and
+    //! the moment when the packet was read from socket.
+    //! Only packets with kernel timestamps are accounted.
+    core::nanoseconds_t spin_delivery_delay;
+
+    //! Sum of delivery delays of packets received after unparking.
+    core::nanoseconds_t parked_delivery_delay;
+
+    UdpReceiverBusyPollStats()
+        : n_packets(0)
+        , n_spin_packets(0)
+        , n_parked_packets(0)
+        , n_parks(0)
+        , spin_time(0)
+        , spin_delivery_delay(0)
+        , parked_delivery_delay(0) {
+    }
+};
+
 //! UDP receiver.
-class UdpReceiverPort : public BasicPort {
+//! @remarks
+//!  By default, receives packets on event loop thread. If busy polling is
+//!  enabled in config, starts a dedicated thread that receives packets.
+class UdpReceiverPort : public BasicPort, private core::Thread {
 public:
     //! Initialize.
     UdpReceiverPort(const UdpReceiverConfig& config,
@@ -72,11 +149,23 @@ public:
     //! Asynchronously close receiver.
     virtual AsyncOperationStatus async_close(ICloseHandler& handler, void* handler_arg);
 
+    //! Get busy polling statistics.
+    //! @remarks
+    //!  May be called from any thread.
+    //!  Returns zero statistics if busy polling is disabled.
+    UdpReceiverBusyPollStats busy_poll_stats() const;
+
 protected:
     //! Format descriptor.
     virtual void format_descriptor(core::StringBuilder& b);
 
 private:
+    enum BusyReadStatus {
+        BusyRead_Packet, // packet was read
+        BusyRead_Empty,  // socket has no packets
+        BusyRead_Error   // read failed
+    };
+
     static void close_cb_(uv_handle_t* handle);
     static void alloc_cb_(uv_handle_t* handle, size_t size, uv_buf_t* buf);
     static void recv_cb_(uv_udp_t* handle,
@@ -85,6 +174,19 @@ private:
                          const sockaddr* addr,
                          unsigned flags);
 
+    virtual void run();
+
+    bool start_busy_polling_();
+    void stop_busy_polling_();
+    BusyReadStatus try_busy_read_(core::nanoseconds_t& delivery_delay);
+    core::nanoseconds_t busy_error_backoff_(core::nanoseconds_t prev_backoff) const;
+    void report_busy_poll_stats_();
+
+    void handle_packet_(const core::SharedPtr<core::Buffer<uint8_t> >& bp,
+                        size_t nread,
+                        const address::SocketAddr& src_addr,
+                        core::nanoseconds_t receive_timestamp);
+
     bool join_multicast_group_();
     void leave_multicast_group_();
 
@@ -107,6 +209,22 @@ private:
     core::BufferFactory<uint8_t>& buffer_factory_;
 
     unsigned packet_counter_;
+
+    SocketHandle fd_;
+    bool kernel_timestamps_;
+
+    bool busy_started_;
+    core::Atomic<int> busy_stop_;
+
+    core::SharedPtr<core::Buffer<uint8_t> > busy_buffer_;
+
+    UdpReceiverBusyPollStats busy_stats_;
+    core::Seqlock<UdpReceiverBusyPollStats> busy_stats_pub_;
+    core::RateLimiter busy_rate_limiter_;
+
+    // Number of read errors since last error report.
+    size_t busy_n_errors_;
+    core::RateLimiter busy_error_limiter_;
 };
 
 } // namespace netio
@@ -11,6 +11,7 @@
 #include "roc_core/log.h"
 #include "roc_core/macro_helpers.h"
 #include "roc_core/panic.h"
+#include "roc_netio/io_error.h"
 #include "roc_netio/socket_ops.h"
 
 namespace roc {
@@ -20,6 +21,19 @@ namespace {
 
 const core::nanoseconds_t PacketLogInterval = 20 * core::Second;
 
+// Packets scheduled to be sent within this interval from now are sent
+// immediately. Timers have millisecond resolution, so without slack packets
+// would be sent up to a millisecond late.
+const core::nanoseconds_t PacingSlack = core::Millisecond / 2;
+
+// Number of consecutive packets to the same address after which
+// the socket is connected to that address.
+const size_t ConnectThreshold = 10;
+
+#if defined(UV_VERSION_HEX) && UV_VERSION_HEX >= 0x011b00
+#define ROC_NETIO_HAS_UDP_CONNECT
+#endif
+
 } // namespace
 
 UdpSenderPort::UdpSenderPort(const UdpSenderConfig& config,
@@ -32,18 +46,30 @@ UdpSenderPort::UdpSenderPort(const UdpSenderConfig& config,
     , loop_(event_loop)
     , write_sem_initialized_(false)
     , handle_initialized_(false)
+    , pacing_timer_initialized_(false)
     , pending_packets_(0)
     , sent_packets_(0)
     , sent_packets_blk_(0)
     , stopped_(true)
     , closed_(false)
     , fd_()
-    , rate_limiter_(PacketLogInterval) {
+    , rate_limiter_(PacketLogInterval)
+    , conn_state_(config.connect_enabled ? ConnState_Detecting : ConnState_Disabled)
+    , conn_established_(false)
+    , conn_candidate_count_(0)
+    , conn_n_connects_(0)
+    , conn_n_disconnects_(0)
+    , conn_n_refused_(0)
+    , conn_n_unreachable_(0)
+    , conn_rate_limiter_(PacketLogInterval)
+    , pacing_next_send_(0)
+    , pacing_stats_pub_(UdpSenderPacingStats())
+    , pacing_rate_limiter_(PacketLogInterval) {
     BasicPort::update_descriptor();
 }
 
 UdpSenderPort::~UdpSenderPort() {
-    if (handle_initialized_ || write_sem_initialized_) {
+    if (handle_initialized_ || write_sem_initialized_ || pacing_timer_initialized_) {
         roc_panic("udp sender: %s: sender was not fully closed before calling destructor",
                   descriptor());
     }
@@ -68,6 +94,17 @@ bool UdpSenderPort::open() {
     write_sem_.data = this;
     write_sem_initialized_ = true;
 
+    if (config_.pacing_interval > 0) {
+        if (int err = uv_timer_init(&loop_, &pacing_timer_)) {
+            roc_log(LogError, "udp sender: %s: uv_timer_init(): [%s] %s", descriptor(),
+                    uv_err_name(err), uv_strerror(err));
+            return false;
+        }
+
+        pacing_timer_.data = this;
+        pacing_timer_initialized_ = true;
+    }
+
     if (int err = uv_udp_init(&loop_, &handle_)) {
         roc_log(LogError, "udp sender: %s: uv_udp_init(): [%s] %s", descriptor(),
                 uv_err_name(err), uv_strerror(err));
@@ -124,6 +161,16 @@ bool UdpSenderPort::open() {
                   uv_err_name(fd_err), uv_strerror(fd_err));
     }
 
+#if !defined(ROC_NETIO_HAS_UDP_CONNECT)
+    if (config_.connect_enabled) {
+        roc_log(LogDebug,
+                "udp sender: %s: connected sockets are not supported by libuv version,"
+                " disabling",
+                descriptor());
+        conn_state_ = ConnState_Disabled;
+    }
+#endif
+
     stopped_ = false;
     update_descriptor();
 
@@ -176,10 +223,45 @@ void UdpSenderPort::write(const packet::PacketPtr& pp) {
     report_stats_();
 }
 
+UdpSenderPacingStats UdpSenderPort::pacing_stats() const {
+    return pacing_stats_pub_.wait_load();
+}
+
+UdpSenderConnectStats UdpSenderPort::connect_stats() const {
+    UdpSenderConnectStats stats;
+    stats.connected = (conn_state_ == ConnState_Connected);
+    stats.n_connects = (unsigned long)(int)conn_n_connects_;
+    stats.n_disconnects = (unsigned long)(int)conn_n_disconnects_;
+    stats.n_refused = (unsigned long)(int)conn_n_refused_;
+    stats.n_unreachable = (unsigned long)(int)conn_n_unreachable_;
+    return stats;
+}
+
+void UdpSenderPort::disable_connect() {
+    core::Mutex::Lock lock(conn_mutex_);
+
+    int state = conn_state_;
+
+    if (state == ConnState_Detecting) {
+        roc_log(LogDebug, "udp sender: %s: disabling connected mode", descriptor());
+        conn_state_ = ConnState_Disabled;
+        return;
+    }
+
+    if (state == ConnState_Connecting || state == ConnState_Connected) {
+        if (conn_state_.compare_exchange(state, ConnState_Disconnecting)) {
+            roc_log(LogDebug, "udp sender: %s: disabling connected mode", descriptor());
+        }
+    }
+}
+
 void UdpSenderPort::write_(const packet::PacketPtr& pp) {
+    detect_connection_(pp->udp()->dst_addr);
+
     const bool had_pending = (++pending_packets_ > 1);
 
-    if (!had_pending) {
+    // when pacing is enabled, all packets go through pacing queue
+    if (!had_pending && config_.pacing_interval == 0) {
         if (try_nonblocking_send_(pp)) {
             --pending_packets_;
             return;
@@ -201,11 +283,14 @@ void UdpSenderPort::close_cb_(uv_handle_t* handle) {
 
     if (handle == (uv_handle_t*)&self.handle_) {
         self.handle_initialized_ = false;
+    } else if (handle == (uv_handle_t*)&self.pacing_timer_) {
+        self.pacing_timer_initialized_ = false;
     } else {
         self.write_sem_initialized_ = false;
     }
 
-    if (self.handle_initialized_ || self.write_sem_initialized_) {
+    if (self.handle_initialized_ || self.write_sem_initialized_
+        || self.pacing_timer_initialized_) {
         return;
     }
 
@@ -227,34 +312,32 @@ void UdpSenderPort::write_sem_cb_(uv_async_t* handle) {
     // push_back() is currently in progress. In this case we can exit the loop
     // before processing all packets, but write() always calls uv_async_send()
     // after push_back(), so we'll wake up soon and process the rest packets.
-    while (packet::PacketPtr pp = self.queue_.try_pop_front_exclusive()) {
-        packet::UDP& udp = *pp->udp();
+    if (self.config_.pacing_interval > 0) {
+        unsigned long burst = 0;
 
-        const int packet_num = ++self.sent_packets_;
-        ++self.sent_packets_blk_;
+        while (packet::PacketPtr pp = self.queue_.try_pop_front_exclusive()) {
+            self.enqueue_paced_(pp);
+            burst++;
+        }
 
-        roc_log(LogTrace, "udp sender: %s: sending packet: num=%d src=%s dst=%s sz=%ld",
-                self.descriptor(), packet_num,
-                address::socket_addr_to_str(self.config_.bind_address).c_str(),
-                address::socket_addr_to_str(udp.dst_addr).c_str(),
-                (long)pp->data().size());
+        if (burst > self.pacing_stats_.max_input_burst) {
+            self.pacing_stats_.max_input_burst = burst;
+        }
 
-        uv_buf_t buf;
-        buf.base = (char*)pp->data().data();
-        buf.len = pp->data().size();
+        self.send_paced_();
+    } else {
+        while (packet::PacketPtr pp = self.queue_.try_pop_front_exclusive()) {
+            self.send_(pp);
+        }
+    }
+}
 
-        udp.request.data = &self;
+void UdpSenderPort::pacing_timer_cb_(uv_timer_t* handle) {
+    roc_panic_if_not(handle);
 
-        if (int err = uv_udp_send(&udp.request, &self.handle_, &buf, 1,
-                                  udp.dst_addr.saddr(), send_cb_)) {
-            roc_log(LogError, "udp sender: %s: uv_udp_send(): [%s] %s", self.descriptor(),
-                    uv_err_name(err), uv_strerror(err));
-            continue;
-        }
+    UdpSenderPort& self = *(UdpSenderPort*)handle->data;
 
-        // will be decremented in send_cb_()
-        pp->incref();
-    }
+    self.send_paced_();
 }
 
 void UdpSenderPort::send_cb_(uv_udp_send_t* req, int status) {
@@ -272,7 +355,11 @@ void UdpSenderPort::send_cb_(uv_udp_send_t* req, int status) {
     // decrement reference counter incremented in write_sem_cb_()
     pp->decref();
 
-    if (status < 0) {
+    if (status == UV_ECONNREFUSED) {
+        self.handle_send_error_(IOErr_Refused, pp);
+    } else if (status == UV_EHOSTUNREACH || status == UV_ENETUNREACH) {
+        self.handle_send_error_(IOErr_Unreachable, pp);
+    } else if (status < 0) {
         roc_log(LogError,
                 "udp sender: %s:"
                 " can't send packet: src=%s dst=%s sz=%ld: [%s] %s",
@@ -289,8 +376,125 @@ void UdpSenderPort::send_cb_(uv_udp_send_t* req, int status) {
     }
 }
 
+void UdpSenderPort::send_(const packet::PacketPtr& pp) {
+    sync_connection_();
+
+    packet::UDP& udp = *pp->udp();
+
+    const int packet_num = ++sent_packets_;
+    ++sent_packets_blk_;
+
+    roc_log(LogTrace, "udp sender: %s: sending packet: num=%d src=%s dst=%s sz=%ld",
+            descriptor(), packet_num,
+            address::socket_addr_to_str(config_.bind_address).c_str(),
+            address::socket_addr_to_str(udp.dst_addr).c_str(), (long)pp->data().size());
+
+    uv_buf_t buf;
+    buf.base = (char*)pp->data().data();
+    buf.len = pp->data().size();
+
+    udp.request.data = this;
+
+    // connected socket doesn't accept destination address
+    const sockaddr* dst_addr = conn_established_ ? NULL : udp.dst_addr.saddr();
+
+    if (int err = uv_udp_send(&udp.request, &handle_, &buf, 1, dst_addr, send_cb_)) {
+        roc_log(LogError, "udp sender: %s: uv_udp_send(): [%s] %s", descriptor(),
+                uv_err_name(err), uv_strerror(err));
+        return;
+    }
+
+    // will be decremented in send_cb_()
+    pp->incref();
+}
+
+void UdpSenderPort::enqueue_paced_(const packet::PacketPtr& pp) {
+    if (pacing_queue_.size() == 0) {
+        // If the queue was drained some time ago, the next packet may be sent
+        // immediately, but no earlier than one interval after the previous one.
+        const core::nanoseconds_t now = core::timestamp(core::ClockMonotonic);
+        if (pacing_next_send_ < now) {
+            pacing_next_send_ = now;
+        }
+    }
+
+    pacing_queue_.write(pp);
+
+    if (pacing_queue_.size() > pacing_stats_.max_queue_size) {
+        pacing_stats_.max_queue_size = (unsigned long)pacing_queue_.size();
+    }
+}
+
+void UdpSenderPort::send_paced_() {
+    const core::nanoseconds_t now = core::timestamp(core::ClockMonotonic);
+
+    unsigned long burst = 0;
+
+    while (pacing_queue_.size() != 0) {
+        if (pacing_next_send_ > now + PacingSlack) {
+            break;
+        }
+
+        packet::PacketPtr pp = pacing_queue_.read();
+        roc_panic_if_not(pp);
+
+        send_(pp);
+
+        const core::nanoseconds_t deviation = now > pacing_next_send_
+            ? now - pacing_next_send_
+            : pacing_next_send_ - now;
+
+        pacing_stats_.n_packets++;
+        pacing_stats_.total_deviation += deviation;
+        if (deviation > pacing_stats_.max_deviation) {
+            pacing_stats_.max_deviation = deviation;
+        }
+
+        pacing_next_send_ += config_.pacing_interval;
+        burst++;
+    }
+
+    if (burst > pacing_stats_.max_output_burst) {
+        pacing_stats_.max_output_burst = burst;
+    }
+
+    if (burst != 0) {
+        pacing_stats_pub_.exclusive_store(pacing_stats_);
+        report_pacing_stats_();
+    }
+
+    if (pacing_queue_.size() != 0) {
+        const core::nanoseconds_t delay = pacing_next_send_ - now;
+        const uint64_t delay_ms =
+            (uint64_t)((delay + core::Millisecond - 1) / core::Millisecond);
+
+        if (int err = uv_timer_start(&pacing_timer_, pacing_timer_cb_, delay_ms, 0)) {
+            roc_panic("udp sender: %s: uv_timer_start(): [%s] %s", descriptor(),
+                      uv_err_name(err), uv_strerror(err));
+        }
+    }
+}
+
+void UdpSenderPort::report_pacing_stats_() {
+    if (!pacing_rate_limiter_.allow()) {
+        return;
+    }
+
+    const double avg_deviation = pacing_stats_.n_packets != 0
+        ? (double)pacing_stats_.total_deviation / pacing_stats_.n_packets
+        : 0.;
+
+    roc_log(LogDebug,
+            "udp sender: %s: pacing: total=%lu max_in_burst=%lu max_out_burst=%lu"
+            " max_queue=%lu avg_dev=%.3fms max_dev=%.3fms",
+            descriptor(), pacing_stats_.n_packets, pacing_stats_.max_input_burst,
+            pacing_stats_.max_output_burst, pacing_stats_.max_queue_size,
+            avg_deviation / core::Millisecond,
+            (double)pacing_stats_.max_deviation / core::Millisecond);
+}
+
 bool UdpSenderPort::fully_closed_() const {
-    if (!handle_initialized_ && !write_sem_initialized_) {
+    if (!handle_initialized_ && !write_sem_initialized_ && !pacing_timer_initialized_) {
         return true;
     }
 
@@ -315,6 +519,10 @@ void UdpSenderPort::start_closing_() {
     if (write_sem_initialized_ && !uv_is_closing((uv_handle_t*)&write_sem_)) {
         uv_close((uv_handle_t*)&write_sem_, close_cb_);
     }
+
+    if (pacing_timer_initialized_ && !uv_is_closing((uv_handle_t*)&pacing_timer_)) {
+        uv_close((uv_handle_t*)&pacing_timer_, close_cb_);
+    }
 }
 
 bool UdpSenderPort::try_nonblocking_send_(const packet::PacketPtr& pp) {
@@ -323,8 +531,35 @@ bool UdpSenderPort::try_nonblocking_send_(const packet::PacketPtr& pp) {
     }
 
     const packet::UDP& udp = *pp->udp();
-    const bool success =
-        socket_try_send_to(fd_, pp->data().data(), pp->data().size(), udp.dst_addr);
+
+    ssize_t ret;
+
+    switch (conn_state_) {
+    case ConnState_Connected:
+        // detect_connection_() guarantees that packet destination matches
+        // connected address, otherwise state would be changed
+        ret = socket_try_send_dgram(fd_, pp->data().data(), pp->data().size());
+        break;
+
+    case ConnState_Detecting:
+    case ConnState_Disabled:
+        ret = socket_try_send_to(fd_, pp->data().data(), pp->data().size(),
+                                 udp.dst_addr);
+        break;
+
+    default:
+        // socket is being connected or disconnected by network loop
+        return false;
+    }
+
+    if (ret == IOErr_Refused || ret == IOErr_Unreachable) {
+        // error belongs to one of the previous packets, and this packet was not
+        // sent; it will be retried via network loop
+        handle_send_error_((IOError)ret, pp);
+        return false;
+    }
+
+    const bool success = (ret == (ssize_t)pp->data().size());
 
     if (success) {
         const int packet_num = ++sent_packets_;
@@ -350,8 +585,113 @@ void UdpSenderPort::report_stats_() {
     const double nb_ratio =
         sent_packets_nb != 0 ? (double)sent_packets_ / sent_packets_nb : 0.;
 
-    roc_log(LogDebug, "udp sender: %s: total=%u nb=%u nb_ratio=%.5f", descriptor(),
-            sent_packets, sent_packets_nb, nb_ratio);
+    roc_log(LogDebug,
+            "udp sender: %s: total=%u nb=%u nb_ratio=%.5f connected=%d refused=%d"
+            " unreachable=%d",
+            descriptor(), sent_packets, sent_packets_nb, nb_ratio,
+            (int)(conn_state_ == ConnState_Connected), (int)conn_n_refused_,
+            (int)conn_n_unreachable_);
+}
+
+void UdpSenderPort::detect_connection_(const address::SocketAddr& dst_addr) {
+    int state = conn_state_;
+
+    if (state == ConnState_Disabled || state == ConnState_Disconnecting) {
+        return;
+    }
+
+    if (state == ConnState_Connecting || state == ConnState_Connected) {
+        // conn_addr_ is not changed in these states
+        if (dst_addr == conn_addr_) {
+            return;
+        }
+
+        if (conn_state_.compare_exchange(state, ConnState_Disconnecting)) {
+            roc_log(LogDebug,
+                    "udp sender: %s: destination changed, switching to"
+                    " unconnected mode: old=%s new=%s",
+                    descriptor(), address::socket_addr_to_str(conn_addr_).c_str(),
+                    address::socket_addr_to_str(dst_addr).c_str());
+        }
+        return;
+    }
+
+    core::Mutex::Lock lock(conn_mutex_);
+
+    if (conn_state_ != ConnState_Detecting) {
+        return;
+    }
+
+    if (conn_candidate_count_ != 0 && !(dst_addr == conn_candidate_)) {
+        // packets are sent to multiple addresses
+        roc_log(LogDebug,
+                "udp sender: %s: multiple destinations, staying in unconnected mode",
+                descriptor());
+        conn_state_ = ConnState_Disabled;
+        return;
+    }
+
+    conn_candidate_ = dst_addr;
+    conn_candidate_count_++;
+
+    if (conn_candidate_count_ >= ConnectThreshold) {
+        conn_addr_ = dst_addr;
+        conn_state_ = ConnState_Connecting;
+    }
+}
+
+void UdpSenderPort::sync_connection_() {
+#if defined(ROC_NETIO_HAS_UDP_CONNECT)
+    if (conn_state_ == ConnState_Connecting) {
+        if (int err = uv_udp_connect(&handle_, conn_addr_.saddr())) {
+            roc_log(LogError, "udp sender: %s: uv_udp_connect(): [%s] %s", descriptor(),
+                    uv_err_name(err), uv_strerror(err));
+            conn_state_.compare_exchange(ConnState_Connecting, ConnState_Disabled);
+        } else {
+            conn_established_ = true;
+            ++conn_n_connects_;
+
+            roc_log(LogDebug, "udp sender: %s: connected socket to %s", descriptor(),
+                    address::socket_addr_to_str(conn_addr_).c_str());
+
+            conn_state_.compare_exchange(ConnState_Connecting, ConnState_Connected);
+        }
+    }
+
+    if (conn_state_ == ConnState_Disconnecting) {
+        if (conn_established_) {
+            if (int err = uv_udp_connect(&handle_, NULL)) {
+                roc_log(LogError, "udp sender: %s: uv_udp_connect(NULL): [%s] %s",
+                        descriptor(), uv_err_name(err), uv_strerror(err));
+            } else {
+                conn_established_ = false;
+                ++conn_n_disconnects_;
+
+                roc_log(LogDebug, "udp sender: %s: disconnected socket", descriptor());
+            }
+        }
+
+        conn_state_ = ConnState_Disabled;
+    }
+#endif
+}
+
+void UdpSenderPort::handle_send_error_(int err, const packet::PacketPtr& pp) {
+    if (err == IOErr_Refused) {
+        ++conn_n_refused_;
+    } else {
+        ++conn_n_unreachable_;
+    }
+
+    if (conn_rate_limiter_.allow()) {
+        roc_log(LogDebug,
+                "udp sender: %s: remote peer reported %s: dst=%s refused=%d"
+                " unreachable=%d",
+                descriptor(),
+                err == IOErr_Refused ? "port unreachable" : "host unreachable",
+                address::socket_addr_to_str(pp->udp()->dst_addr).c_str(),
+                (int)conn_n_refused_, (int)conn_n_unreachable_);
+    }
 }
 
 void UdpSenderPort::format_descriptor(core::StringBuilder& b) {
@@ -363,6 +703,12 @@ void UdpSenderPort::format_descriptor(core::StringBuilder& b) {
     b.append_str(" bind=");
     b.append_str(address::socket_addr_to_str(config_.bind_address).c_str());
 
+    if (config_.pacing_interval > 0) {
+        b.append_str(" pacing=");
+        b.append_uint((unsigned long)(config_.pacing_interval / core::Microsecond), 10);
+        b.append_str("us");
+    }
+
     b.append_str(">");
 }
 
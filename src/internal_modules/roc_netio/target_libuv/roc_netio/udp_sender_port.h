@@ -18,10 +18,14 @@
 #include "roc_core/atomic.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/mpsc_queue.h"
+#include "roc_core/mutex.h"
 #include "roc_core/rate_limiter.h"
+#include "roc_core/seqlock.h"
+#include "roc_core/time.h"
 #include "roc_netio/basic_port.h"
 #include "roc_netio/iclose_handler.h"
 #include "roc_packet/iwriter.h"
+#include "roc_packet/queue.h"
 
 namespace roc {
 namespace netio {
@@ -42,15 +46,99 @@ struct UdpSenderConfig {
     //! regular asynchronous write.
     bool non_blocking_enabled;
 
+    //! Minimum interval between consecutive packets, nanoseconds.
+    //! If non-zero, packets are not sent immediately, but are queued and
+    //! sent from network loop not more often than once per interval, so that
+    //! bursts of packets are spread evenly over time.
+    //! If zero, packets are sent as soon as possible.
+    //! Interval is fixed for the lifetime of the port; if packet rate may
+    //! change, it should correspond to the highest rate, otherwise pacing
+    //! queue grows.
+    core::nanoseconds_t pacing_interval;
+
+    //! If true, connect socket to remote address when all packets are sent
+    //! to the same address.
+    //! Connected socket doesn't perform route lookup for every packet and
+    //! reports ICMP errors from remote peer. If a packet to another address
+    //! is sent later, socket is disconnected and never connected again.
+    //! Sender peer disables connecting for ports shared by source and
+    //! repair interfaces.
+    bool connect_enabled;
+
     UdpSenderConfig()
         : reuseaddr(false)
-        , non_blocking_enabled(true) {
+        , non_blocking_enabled(true)
+        , pacing_interval(0)
+        , connect_enabled(true) {
     }
 
     //! Check two configs for equality.
     bool operator==(const UdpSenderConfig& other) const {
         return bind_address == other.bind_address
-            && non_blocking_enabled == other.non_blocking_enabled;
+            && non_blocking_enabled == other.non_blocking_enabled
+            && pacing_interval == other.pacing_interval
+            && connect_enabled == other.connect_enabled;
+    }
+};
+
+//! UDP sender connection statistics.
+struct UdpSenderConnectStats {
+    //! Whether socket is currently connected to remote address.
+    bool connected;
+
+    //! Number of times the socket was connected.
+    unsigned long n_connects;
+
+    //! Number of times the socket was disconnected because packets
+    //! were sent to another address.
+    unsigned long n_disconnects;
+
+    //! Number of packets for which remote peer reported that it refused
+    //! the datagram (ICMP port unreachable).
+    unsigned long n_refused;
+
+    //! Number of packets for which remote host or network was reported
+    //! unreachable (ICMP host or network unreachable).
+    unsigned long n_unreachable;
+
+    UdpSenderConnectStats()
+        : connected(false)
+        , n_connects(0)
+        , n_disconnects(0)
+        , n_refused(0)
+        , n_unreachable(0) {
+    }
+};
+
+//! UDP sender pacing statistics.
+struct UdpSenderPacingStats {
+    //! Total number of paced packets.
+    unsigned long n_packets;
+
+    //! Maximum number of packets that were passed to sender at once.
+    //! Shows the size of bursts produced by pipeline.
+    unsigned long max_input_burst;
+
+    //! Maximum number of packets that were sent at once.
+    //! Shows the size of bursts that reached network.
+    unsigned long max_output_burst;
+
+    //! Maximum number of packets waiting in pacing queue.
+    unsigned long max_queue_size;
+
+    //! Sum of absolute deviations of actual send times from scheduled ones.
+    core::nanoseconds_t total_deviation;
+
+    //! Maximum absolute deviation of actual send time from scheduled one.
+    core::nanoseconds_t max_deviation;
+
+    UdpSenderPacingStats()
+        : n_packets(0)
+        , max_input_burst(0)
+        , max_output_burst(0)
+        , max_queue_size(0)
+        , total_deviation(0)
+        , max_deviation(0) {
     }
 };
 
@@ -79,6 +167,23 @@ public:
     //!  May be called from any thread.
     virtual void write(const packet::PacketPtr&);
 
+    //! Get pacing statistics.
+    //! @remarks
+    //!  May be called from any thread.
+    //!  Returns zero statistics if pacing is disabled.
+    UdpSenderPacingStats pacing_stats() const;
+
+    //! Get connection statistics.
+    //! @remarks
+    //!  May be called from any thread.
+    UdpSenderConnectStats connect_stats() const;
+
+    //! Disable connecting socket to remote address.
+    //! @remarks
+    //!  May be called from any thread.
+    //!  If socket is already connected, it's disconnected by network loop.
+    void disable_connect();
+
 protected:
     //! Format descriptor.
     virtual void format_descriptor(core::StringBuilder& b);
@@ -87,8 +192,14 @@ private:
     static void close_cb_(uv_handle_t* handle);
     static void write_sem_cb_(uv_async_t* handle);
     static void send_cb_(uv_udp_send_t* req, int status);
+    static void pacing_timer_cb_(uv_timer_t* handle);
 
     void write_(const packet::PacketPtr&);
+    void send_(const packet::PacketPtr&);
+
+    void enqueue_paced_(const packet::PacketPtr&);
+    void send_paced_();
+    void report_pacing_stats_();
 
     bool fully_closed_() const;
     void start_closing_();
@@ -96,6 +207,10 @@ private:
     bool try_nonblocking_send_(const packet::PacketPtr& pp);
     void report_stats_();
 
+    void detect_connection_(const address::SocketAddr& dst_addr);
+    void sync_connection_();
+    void handle_send_error_(int err, const packet::PacketPtr& pp);
+
     UdpSenderConfig config_;
 
     ICloseHandler* close_handler_;
@@ -109,6 +224,9 @@ private:
     uv_udp_t handle_;
     bool handle_initialized_;
 
+    uv_timer_t pacing_timer_;
+    bool pacing_timer_initialized_;
+
     address::SocketAddr address_;
 
     core::MpscQueue<packet::Packet> queue_;
@@ -123,6 +241,39 @@ private:
     uv_os_fd_t fd_;
 
     core::RateLimiter rate_limiter_;
+
+    // Connection state is changed from Detecting to Connecting or Disabled,
+    // and from Connecting or Connected to Disconnecting by writer or by
+    // disable_connect(); and from Connecting to Connected and from
+    // Disconnecting to Disabled by network loop.
+    enum ConnectState {
+        ConnState_Detecting,
+        ConnState_Connecting,
+        ConnState_Connected,
+        ConnState_Disconnecting,
+        ConnState_Disabled
+    };
+
+    core::Atomic<int> conn_state_;
+    bool conn_established_;
+    core::Mutex conn_mutex_;
+    address::SocketAddr conn_addr_;
+    address::SocketAddr conn_candidate_;
+    size_t conn_candidate_count_;
+
+    core::Atomic<int> conn_n_connects_;
+    core::Atomic<int> conn_n_disconnects_;
+    core::Atomic<int> conn_n_refused_;
+    core::Atomic<int> conn_n_unreachable_;
+
+    core::RateLimiter conn_rate_limiter_;
+
+    packet::Queue pacing_queue_;
+    core::nanoseconds_t pacing_next_send_;
+
+    UdpSenderPacingStats pacing_stats_;
+    core::Seqlock<UdpSenderPacingStats> pacing_stats_pub_;
+    core::RateLimiter pacing_rate_limiter_;
 };
 
 } // namespace netio
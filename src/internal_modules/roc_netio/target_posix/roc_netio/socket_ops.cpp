@@ -10,12 +10,20 @@
 #include <fcntl.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
+#include <poll.h>
 #include <signal.h>
+#include <string.h>
 #include <sys/socket.h>
+#include <sys/time.h>
 #include <sys/types.h>
 #include <time.h>
 #include <unistd.h>
 
+#if defined(__linux__)
+#include <linux/sockios.h>
+#include <sys/ioctl.h>
+#endif
+
 #include "roc_core/errno_to_str.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
@@ -130,6 +138,35 @@ bool set_int_option(
     return true;
 }
 
+core::nanoseconds_t get_cmsg_timestamp(struct msghdr& msg) {
+    if (msg.msg_flags & MSG_CTRUNC) {
+        return 0;
+    }
+
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET) {
+            continue;
+        }
+#if defined(SCM_TIMESTAMPNS)
+        if (cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+            struct timespec ts;
+            memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            return ts.tv_sec * core::Second + ts.tv_nsec;
+        }
+#endif
+#if defined(SCM_TIMESTAMP)
+        if (cmsg->cmsg_type == SCM_TIMESTAMP) {
+            struct timeval tv;
+            memcpy(&tv, CMSG_DATA(cmsg), sizeof(tv));
+            return tv.tv_sec * core::Second + tv.tv_usec * core::Microsecond;
+        }
+#endif
+    }
+
+    return 0;
+}
+
 #if !defined(SOCK_CLOEXEC)
 
 // This function is used if SOCK_CLOEXEC is not available.
@@ -467,6 +504,144 @@ ssize_t socket_try_recv(SocketHandle sock, void* buf, size_t bufsz) {
     return ret;
 }
 
+ssize_t socket_try_recv_from(SocketHandle sock,
+                             void* buf,
+                             size_t bufsz,
+                             address::SocketAddr& remote_address,
+                             core::nanoseconds_t* recv_timestamp) {
+    roc_panic_if(sock < 0);
+    roc_panic_if(!buf);
+
+    struct iovec iov;
+    iov.iov_base = buf;
+    iov.iov_len = bufsz;
+
+    union {
+        struct cmsghdr align;
+        char data[CMSG_SPACE(sizeof(struct timespec))
+                  + CMSG_SPACE(sizeof(struct timeval))];
+    } control;
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_name = remote_address.saddr();
+    msg.msg_namelen = remote_address.max_slen();
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    if (recv_timestamp) {
+        msg.msg_control = control.data;
+        msg.msg_controllen = sizeof(control.data);
+    }
+
+    ssize_t ret;
+    while ((ret = recvmsg(sock, &msg, MSG_DONTWAIT)) == -1) {
+        roc_panic_if(is_malformed(errno));
+
+        if (errno != EINTR) {
+            break;
+        }
+    }
+
+    if (ret < 0 && is_ewouldblock(errno)) {
+        return IOErr_WouldBlock;
+    }
+
+    if (ret < 0) {
+        roc_log(LogError, "socket: recvmsg(): %s", core::errno_to_str().c_str());
+        return IOErr_Failure;
+    }
+
+    if (msg.msg_flags & MSG_TRUNC) {
+        roc_log(LogDebug, "socket: recvmsg(): datagram truncated: bufsz=%lu",
+                (unsigned long)bufsz);
+        return IOErr_Failure;
+    }
+
+    if (msg.msg_namelen != remote_address.slen()) {
+        roc_log(LogError, "socket: recvmsg(): unexpected len: got=%lu expected=%lu",
+                (unsigned long)msg.msg_namelen, (unsigned long)remote_address.slen());
+        return IOErr_Failure;
+    }
+
+    if (recv_timestamp) {
+        *recv_timestamp = get_cmsg_timestamp(msg);
+    }
+
+    return ret;
+}
+
+bool socket_set_recv_timestamps(SocketHandle sock) {
+    roc_panic_if(sock < 0);
+
+#if defined(SO_TIMESTAMPNS)
+    return set_int_option(sock, SOL_SOCKET, SO_TIMESTAMPNS, "SO_TIMESTAMPNS", 1);
+#elif defined(SO_TIMESTAMP)
+    return set_int_option(sock, SOL_SOCKET, SO_TIMESTAMP, "SO_TIMESTAMP", 1);
+#else
+    roc_log(LogDebug, "socket: receive timestamps are not supported on this platform");
+    return false;
+#endif
+}
+
+bool socket_get_recv_timestamp(SocketHandle sock, core::nanoseconds_t& recv_timestamp) {
+    roc_panic_if(sock < 0);
+
+#if defined(SIOCGSTAMPNS)
+    struct timespec ts;
+    if (ioctl(sock, SIOCGSTAMPNS, &ts) == -1) {
+        roc_panic_if(is_malformed(errno));
+        return false;
+    }
+    recv_timestamp = ts.tv_sec * core::Second + ts.tv_nsec;
+    return true;
+#else
+    (void)recv_timestamp;
+    return false;
+#endif
+}
+
+bool socket_wait_readable(SocketHandle sock, core::nanoseconds_t timeout) {
+    roc_panic_if(sock < 0);
+
+    struct pollfd pfd;
+    pfd.fd = sock;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    int timeout_ms = 0;
+    if (timeout > 0) {
+        timeout_ms = (int)((timeout + core::Millisecond - 1) / core::Millisecond);
+    }
+
+    int ret;
+    while ((ret = poll(&pfd, 1, timeout_ms)) == -1) {
+        if (errno != EINTR) {
+            break;
+        }
+    }
+
+    if (ret < 0) {
+        roc_log(LogError, "socket: poll(): %s", core::errno_to_str().c_str());
+        return false;
+    }
+
+    return ret > 0 && (pfd.revents & POLLIN);
+}
+
+bool socket_set_busy_poll(SocketHandle sock, core::nanoseconds_t duration) {
+    roc_panic_if(sock < 0);
+    roc_panic_if(duration <= 0);
+
+#if defined(SO_BUSY_POLL)
+    return set_int_option(sock, SOL_SOCKET, SO_BUSY_POLL, "SO_BUSY_POLL",
+                          (int)(duration / core::Microsecond));
+#else
+    roc_log(LogDebug, "socket: SO_BUSY_POLL is not supported on this platform");
+    return false;
+#endif
+}
+
 #if defined(SO_NOSIGPIPE) || defined(MSG_NOSIGNAL)
 
 // This version is used if either SO_NOSIGPIPE or MSG_NOSIGNAL is available
@@ -653,6 +828,47 @@ ssize_t socket_try_send_to(SocketHandle sock,
     return ret;
 }
 
+ssize_t socket_try_send_dgram(SocketHandle sock, const void* buf, size_t bufsz) {
+    roc_panic_if(sock < 0);
+    roc_panic_if(!buf);
+
+    ssize_t ret;
+    while ((ret = send(sock, buf, bufsz, MSG_DONTWAIT)) == -1) {
+        roc_panic_if(is_malformed(errno));
+
+        if (errno != EINTR) {
+            break;
+        }
+    }
+
+    if (ret < 0 && is_ewouldblock(errno)) {
+        return IOErr_WouldBlock;
+    }
+
+    if (ret < 0 && errno == ECONNREFUSED) {
+        return IOErr_Refused;
+    }
+
+    if (ret < 0 && (errno == EHOSTUNREACH || errno == ENETUNREACH)) {
+        return IOErr_Unreachable;
+    }
+
+    if (ret < 0) {
+        roc_log(LogError, "socket: send(): %s", core::errno_to_str().c_str());
+        return IOErr_Failure;
+    }
+
+    if ((size_t)ret != bufsz) {
+        roc_log(LogError,
+                "socket: send() processed less bytes than expected: "
+                "requested=%lu processed=%lu",
+                (unsigned long)bufsz, (unsigned long)ret);
+        return IOErr_Failure;
+    }
+
+    return ret;
+}
+
 bool socket_shutdown(SocketHandle sock) {
     roc_panic_if(sock < 0);
 
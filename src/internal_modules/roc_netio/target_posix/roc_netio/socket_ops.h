@@ -14,6 +14,7 @@
 
 #include "roc_address/socket_addr.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/time.h"
 #include "roc_netio/io_error.h"
 #include "roc_netio/socket_options.h"
 
@@ -65,6 +66,42 @@ bool socket_end_connect(SocketHandle sock);
 //! @returns number of bytes read (>= 0) or IOError (< 0).
 ssize_t socket_try_recv(SocketHandle sock, void* buf, size_t bufsz);
 
+//! Try to read datagram from socket without blocking.
+//! Sets @p remote_address to the source address of the datagram.
+//! If @p recv_timestamp is non-null, sets it to the kernel receive timestamp
+//! of the datagram (unix time), or to zero if timestamp is not available.
+//! @returns number of bytes read (>= 0) or IOError (< 0).
+ssize_t socket_try_recv_from(SocketHandle sock,
+                             void* buf,
+                             size_t bufsz,
+                             address::SocketAddr& remote_address,
+                             core::nanoseconds_t* recv_timestamp);
+
+//! Enable kernel receive timestamps on socket.
+//! @remarks
+//!  After enabling, kernel records arrival time of every datagram, which can
+//!  be retrieved using socket_try_recv_from() or socket_get_recv_timestamp().
+//! @returns false if timestamps are not supported or can't be enabled.
+bool socket_set_recv_timestamps(SocketHandle sock);
+
+//! Get kernel receive timestamp of the last datagram read from socket.
+//! @remarks
+//!  Timestamp is in unix time. Requires socket_set_recv_timestamps().
+//! @returns false if timestamp is not available.
+bool socket_get_recv_timestamp(SocketHandle sock, core::nanoseconds_t& recv_timestamp);
+
+//! Wait until socket becomes readable or timeout expires.
+//! @returns true if socket is readable and false if timeout expired or
+//! an error occurred.
+bool socket_wait_readable(SocketHandle sock, core::nanoseconds_t timeout);
+
+//! Enable kernel busy polling on socket.
+//! @remarks
+//!  When enabled, blocking and non-blocking reads on empty socket spin on
+//!  device queue for up to @p duration before returning.
+//! @returns false if the option is not supported or can't be set.
+bool socket_set_busy_poll(SocketHandle sock, core::nanoseconds_t duration);
+
 //! Try to write bytes to socket without blocking.
 //! @returns number of bytes written (>= 0) or IOError (< 0).
 ssize_t socket_try_send(SocketHandle sock, const void* buf, size_t bufsz);
@@ -76,6 +113,12 @@ ssize_t socket_try_send_to(SocketHandle sock,
                            size_t bufsz,
                            const address::SocketAddr& remote_address);
 
+//! Try to send datagram via connected socket, without blocking.
+//! @returns number of bytes written (>= 0) or IOError (< 0).
+//! Returns IOErr_Refused or IOErr_Unreachable if an ICMP error was
+//! received for previously sent datagrams.
+ssize_t socket_try_send_dgram(SocketHandle sock, const void* buf, size_t bufsz);
+
 //! Gracefully shutdown connection.
 bool socket_shutdown(SocketHandle sock);
 
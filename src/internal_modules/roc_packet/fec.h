@@ -28,7 +28,10 @@ enum FecScheme {
     FEC_ReedSolomon_M8,
 
     //! LDPC-Staircase.
-    FEC_LDPC_Staircase
+    FEC_LDPC_Staircase,
+
+    //! Sliding window Random Linear Codes over GF(2^8).
+    FEC_RLC
 };
 
 //! FECFRAME packet.
@@ -46,6 +49,10 @@ struct FEC {
     //!  Repair packets are numbered in range [k; k + n), where
     //!  k is a number of source packets per block (source_block_length)
     //!  n is a number of repair packets per block.
+    //!
+    //!  For sliding window schemes, source packets are numbered sequentially
+    //!  starting from a random number, and repair packets store the number
+    //!  of the first source packet in the encoding window.
     size_t encoding_symbol_id;
 
     //! Number of a source block in a packet stream.
@@ -54,12 +61,18 @@ struct FEC {
     //!  Source block is formed from the source packets.
     //!  Blocks are numbered sequentially starting from a random number.
     //!  Block number can wrap.
+    //!
+    //!  For sliding window schemes, there are no blocks, and repair packets
+    //!  store the repair key, from which coding coefficients are derived.
     blknum_t source_block_number;
 
     //! Number of source packets in the block to which this packet belongs to.
     //!
     //! @remarks
     //!  Different blocks can have different number of source packets.
+    //!
+    //!  For sliding window schemes, repair packets store the number of
+    //!  source packets in the encoding window.
     size_t source_block_length;
 
     //! Number of source packets and repair in the block to which this packet belongs to.
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_packet/jitter_meter.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+// Loss burst decays by 1/LossBurstDecay on every packet.
+const double LossBurstDecay = 1024;
+
+} // namespace
+
+JitterMeter::JitterMeter(IWriter& writer, const audio::SampleSpec& sample_spec)
+    : writer_(writer)
+    , sample_spec_(sample_spec)
+    , prev_source_(0)
+    , prev_seqnum_(0)
+    , prev_rtp_ts_(0)
+    , prev_receive_ts_(0)
+    , jitter_(0)
+    , loss_burst_(0)
+    , n_packets_(0)
+    , count_source_(0)
+    , base_seqnum_(0)
+    , ext_max_seqnum_(0)
+    , n_source_received_(0)
+    , n_received_(0)
+    , n_prev_lost_(0) {
+}
+
+void JitterMeter::write(const PacketPtr& packet) {
+    if (!packet) {
+        roc_panic("jitter meter: unexpected null packet");
+    }
+
+    if ((packet->flags() & Packet::FlagAudio) && packet->rtp()) {
+        count_(*packet);
+
+        if (packet->udp() && packet->udp()->receive_timestamp != 0) {
+            update_(*packet);
+        }
+    }
+
+    writer_.write(packet);
+}
+
+core::nanoseconds_t JitterMeter::jitter() const {
+    return (core::nanoseconds_t)jitter_;
+}
+
+core::nanoseconds_t JitterMeter::loss_burst() const {
+    return (core::nanoseconds_t)loss_burst_;
+}
+
+size_t JitterMeter::n_packets() const {
+    return n_packets_;
+}
+
+uint64_t JitterMeter::n_received_packets() const {
+    return n_received_;
+}
+
+uint64_t JitterMeter::n_lost_packets() const {
+    const int64_t n_expected = ext_max_seqnum_ - base_seqnum_ + 1;
+    const int64_t n_lost = n_expected - (int64_t)n_source_received_;
+
+    if (n_source_received_ == 0 || n_lost < 0) {
+        return n_prev_lost_;
+    }
+
+    return n_prev_lost_ + (uint64_t)n_lost;
+}
+
+uint64_t JitterMeter::ext_max_seqnum() const {
+    return (uint64_t)ext_max_seqnum_;
+}
+
+source_t JitterMeter::source() const {
+    return count_source_;
+}
+
+void JitterMeter::update_(const Packet& packet) {
+    const source_t source = packet.rtp()->source;
+    const seqnum_t seqnum = packet.rtp()->seqnum;
+    const timestamp_t rtp_ts = packet.rtp()->timestamp;
+    const core::nanoseconds_t receive_ts = packet.udp()->receive_timestamp;
+
+    if (n_packets_ != 0 && source == prev_source_) {
+        // D(i-1,i) = (Rj - Ri) - (Sj - Si), see RFC 3550, section 6.4.1.
+        // Differences are calculated in nanoseconds to avoid converting absolute
+        // receive time into RTP units.
+        const core::nanoseconds_t d = (receive_ts - prev_receive_ts_)
+            - sample_spec_.rtp_timestamp_2_ns(timestamp_diff(rtp_ts, prev_rtp_ts_));
+
+        const double abs_d = d < 0 ? -(double)d : (double)d;
+
+        jitter_ += (abs_d - jitter_) / 16.;
+
+        // If some packets between previous and this one are missing, estimate
+        // duration of missing audio assuming equal packet durations.
+        const seqnum_diff_t sn_dist = seqnum_diff(seqnum, prev_seqnum_);
+        if (sn_dist > 1) {
+            const core::nanoseconds_t dist =
+                sample_spec_.rtp_timestamp_2_ns(timestamp_diff(rtp_ts, prev_rtp_ts_));
+            const double burst = (double)dist * (sn_dist - 1) / sn_dist;
+
+            if (burst > loss_burst_) {
+                loss_burst_ = burst;
+            }
+        }
+
+        loss_burst_ -= loss_burst_ / LossBurstDecay;
+    } else if (n_packets_ != 0) {
+        roc_log(LogDebug, "jitter meter: source changed, resetting: old=%lu new=%lu",
+                (unsigned long)prev_source_, (unsigned long)source);
+        jitter_ = 0;
+        loss_burst_ = 0;
+        n_packets_ = 0;
+    }
+
+    prev_source_ = source;
+    prev_seqnum_ = seqnum;
+    prev_rtp_ts_ = rtp_ts;
+    prev_receive_ts_ = receive_ts;
+
+    n_packets_++;
+}
+
+void JitterMeter::count_(const Packet& packet) {
+    const source_t source = packet.rtp()->source;
+    const seqnum_t seqnum = packet.rtp()->seqnum;
+
+    if (n_source_received_ == 0 || source != count_source_) {
+        // Losses of previous source are kept in the total.
+        n_prev_lost_ = n_lost_packets();
+
+        count_source_ = source;
+        base_seqnum_ = seqnum;
+        ext_max_seqnum_ = seqnum;
+        n_source_received_ = 0;
+    } else {
+        // Extend seqnum to 64 bits to handle wrapping.
+        const seqnum_diff_t dist = seqnum_diff(seqnum, (seqnum_t)ext_max_seqnum_);
+        if (dist > 0) {
+            ext_max_seqnum_ += dist;
+        }
+    }
+
+    n_source_received_++;
+    n_received_++;
+}
+
+} // namespace packet
+} // namespace roc
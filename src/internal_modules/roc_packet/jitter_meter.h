@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/jitter_meter.h
+//! @brief Interarrival jitter meter.
+
+#ifndef ROC_PACKET_JITTER_METER_H_
+#define ROC_PACKET_JITTER_METER_H_
+
+#include "roc_audio/sample_spec.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/time.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/units.h"
+
+namespace roc {
+namespace packet {
+
+//! Interarrival jitter meter.
+//! @remarks
+//!  Calculates interarrival jitter of audio packets as defined in RFC 3550
+//!  (section 6.4.1), using packet receive timestamps and RTP timestamps.
+//!  Packets without receive timestamp are not accounted.
+//!  Additionally tracks duration of loss bursts, i.e. gaps in sequence numbers,
+//!  and counts lost packets as defined in RFC 3550 (appendix A.3).
+//!  All packets are passed to the underlying writer unchanged.
+class JitterMeter : public IWriter, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    //!
+    //! @b Parameters
+    //!  - @p writer is used to write packets
+    //!  - @p sample_spec is the specifications of incoming packets
+    JitterMeter(IWriter& writer, const audio::SampleSpec& sample_spec);
+
+    //! Write packet.
+    virtual void write(const PacketPtr& packet);
+
+    //! Get current jitter estimate, nanoseconds.
+    //! @remarks
+    //!  Returns zero until at least two packets were received.
+    core::nanoseconds_t jitter() const;
+
+    //! Get recent loss burst duration, nanoseconds.
+    //! @remarks
+    //!  Peak duration of audio lost in a row, with slow exponential decay.
+    //!  Returns zero if no losses were detected recently.
+    core::nanoseconds_t loss_burst() const;
+
+    //! Get number of packets accounted in jitter estimate.
+    size_t n_packets() const;
+
+    //! Get number of received audio packets.
+    //! @remarks
+    //!  Includes packets without receive timestamp.
+    uint64_t n_received_packets() const;
+
+    //! Get number of lost audio packets.
+    //! @remarks
+    //!  Difference between expected and received number of packets.
+    //!  Packets that arrive out of order are not counted as lost.
+    uint64_t n_lost_packets() const;
+
+    //! Get extended highest sequence number received.
+    //! @remarks
+    //!  Sequence number extended with the count of wraps, for packets of
+    //!  the current source. Returns zero until first packet is received.
+    uint64_t ext_max_seqnum() const;
+
+    //! Get source ID of packets which are currently counted.
+    //! @remarks
+    //!  Returns zero until first packet is received.
+    source_t source() const;
+
+private:
+    void update_(const Packet& packet);
+    void count_(const Packet& packet);
+
+    IWriter& writer_;
+
+    const audio::SampleSpec sample_spec_;
+
+    source_t prev_source_;
+    seqnum_t prev_seqnum_;
+    timestamp_t prev_rtp_ts_;
+    core::nanoseconds_t prev_receive_ts_;
+
+    double jitter_;
+    double loss_burst_;
+    size_t n_packets_;
+
+    source_t count_source_;
+    int64_t base_seqnum_;
+    int64_t ext_max_seqnum_;
+    uint64_t n_source_received_;
+    uint64_t n_received_;
+    uint64_t n_prev_lost_;
+};
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_JITTER_METER_H_
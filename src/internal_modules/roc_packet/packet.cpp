@@ -97,6 +97,21 @@ void Packet::set_data(const core::Slice<uint8_t>& d) {
     data_ = d;
 }
 
+void Packet::reset() {
+    if (getref() > 1) {
+        roc_panic("packet: can't reset shared packet: refcount=%ld", getref());
+    }
+
+    flags_ = 0;
+
+    udp_ = UDP();
+    rtp_ = RTP();
+    fec_ = FEC();
+    rtcp_ = RTCP();
+
+    data_ = core::Slice<uint8_t>();
+}
+
 source_t Packet::source() const {
     if (const RTP* r = rtp()) {
         return r->source;
@@ -91,6 +91,12 @@ public:
     //! Set packet data.
     void set_data(const core::Slice<uint8_t>& data);
 
+    //! Reset packet to its initial state.
+    //! @remarks
+    //!  Clears flags, headers, and data, so that the packet can be prepared
+    //!  and composed again. Should be called only by the sole owner of the packet.
+    void reset();
+
     //! Return packet stream identifier.
     //! @remarks
     //!  The returning value depends on packet type. For some packet types, may
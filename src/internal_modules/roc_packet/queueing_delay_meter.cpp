@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_packet/queueing_delay_meter.h"
+
+namespace roc {
+namespace packet {
+
+QueueingDelayMeter::QueueingDelayMeter(IReader& reader)
+    : reader_(reader)
+    , delay_(0)
+    , last_delay_(0)
+    , started_(false) {
+}
+
+PacketPtr QueueingDelayMeter::read() {
+    PacketPtr packet = reader_.read();
+    if (!packet) {
+        return NULL;
+    }
+
+    const UDP* udp = packet->udp();
+    if (!udp || udp->receive_timestamp == 0) {
+        return packet;
+    }
+
+    last_delay_ = core::timestamp(core::ClockUnix) - udp->receive_timestamp;
+    if (last_delay_ < 0) {
+        last_delay_ = 0;
+    }
+
+    if (!started_) {
+        delay_ = (double)last_delay_;
+        started_ = true;
+    } else {
+        // same smoothing as RFC 3550 jitter estimate
+        delay_ += ((double)last_delay_ - delay_) / 16.;
+    }
+
+    return packet;
+}
+
+core::nanoseconds_t QueueingDelayMeter::queueing_delay() const {
+    return (core::nanoseconds_t)delay_;
+}
+
+core::nanoseconds_t QueueingDelayMeter::last_queueing_delay() const {
+    return last_delay_;
+}
+
+} // namespace packet
+} // namespace roc
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/queueing_delay_meter.h
+//! @brief Queueing delay meter.
+
+#ifndef ROC_PACKET_QUEUEING_DELAY_METER_H_
+#define ROC_PACKET_QUEUEING_DELAY_METER_H_
+
+#include "roc_core/noncopyable.h"
+#include "roc_core/time.h"
+#include "roc_packet/ireader.h"
+
+namespace roc {
+namespace packet {
+
+//! Queueing delay meter.
+//! @remarks
+//!  Calculates how much time packets spend in the receiver between being
+//!  received from network and being read from this reader.
+//!  Packets without receive timestamp (e.g. restored by FEC) are not accounted.
+//!  All packets are passed from the underlying reader unchanged.
+class QueueingDelayMeter : public IReader, public core::NonCopyable<> {
+public:
+    //! Initialize.
+    explicit QueueingDelayMeter(IReader& reader);
+
+    //! Read packet.
+    virtual PacketPtr read();
+
+    //! Get smoothed queueing delay, nanoseconds.
+    //! @remarks
+    //!  Returns zero until at least one packet was read.
+    core::nanoseconds_t queueing_delay() const;
+
+    //! Get queueing delay of the last accounted packet, nanoseconds.
+    core::nanoseconds_t last_queueing_delay() const;
+
+private:
+    IReader& reader_;
+
+    double delay_;
+    core::nanoseconds_t last_delay_;
+    bool started_;
+};
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_QUEUEING_DELAY_METER_H_
@@ -17,6 +17,7 @@
 #include "roc_address/socket_addr.h"
 #include "roc_core/slice.h"
 #include "roc_core/stddefs.h"
+#include "roc_core/time.h"
 
 namespace roc {
 namespace packet {
@@ -29,8 +30,19 @@ struct UDP {
     //! Destination address.
     address::SocketAddr dst_addr;
 
+    //! Packet receive timestamp, unix time in nanoseconds.
+    //! @remarks
+    //!  Time when the packet was received by the kernel, if kernel timestamps
+    //!  are available, or by the receiver port otherwise. Zero if unknown.
+    core::nanoseconds_t receive_timestamp;
+
     //! Sender request state.
     uv_udp_send_t request;
+
+    //! Construct zero UDP packet.
+    UDP()
+        : receive_timestamp(0) {
+    }
 };
 
 } // namespace packet
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "roc_core/endian_ops.h"
+#include "roc_core/errno_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_packet/trace_reader.h"
+
+namespace roc {
+namespace packet {
+
+TraceReader::TraceReader()
+    : fd_(-1)
+    , data_(NULL)
+    , size_(0)
+    , offset_(0) {
+}
+
+TraceReader::~TraceReader() {
+    close();
+}
+
+bool TraceReader::open(const char* path) {
+    roc_panic_if(!path);
+
+    if (fd_ != -1) {
+        roc_panic("trace reader: can't open file twice");
+    }
+
+    fd_ = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd_ == -1) {
+        roc_log(LogError, "trace reader: open: %s: %s", path,
+                core::errno_to_str(errno).c_str());
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd_, &st) == -1) {
+        roc_log(LogError, "trace reader: fstat: %s: %s", path,
+                core::errno_to_str(errno).c_str());
+        close();
+        return false;
+    }
+
+    if ((size_t)st.st_size < sizeof(TraceFileHeader)) {
+        roc_log(LogError, "trace reader: file too short: %s", path);
+        close();
+        return false;
+    }
+
+    void* addr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (addr == MAP_FAILED) {
+        roc_log(LogError, "trace reader: mmap: %s: %s", path,
+                core::errno_to_str(errno).c_str());
+        close();
+        return false;
+    }
+
+    data_ = (const uint8_t*)addr;
+    size_ = (size_t)st.st_size;
+
+    TraceFileHeader hdr;
+    memcpy(&hdr, data_, sizeof(hdr));
+
+    if (memcmp(hdr.magic, TraceMagic, TraceMagicSize) != 0) {
+        roc_log(LogError, "trace reader: bad magic: %s", path);
+        close();
+        return false;
+    }
+
+    if (core::EndianOps::swap_native_le(hdr.version) != TraceVersion) {
+        roc_log(LogError, "trace reader: unsupported version: %s: version=%lu", path,
+                (unsigned long)core::EndianOps::swap_native_le(hdr.version));
+        close();
+        return false;
+    }
+
+    offset_ = sizeof(TraceFileHeader);
+
+    roc_log(LogDebug, "trace reader: opened %s: size=%lu", path, (unsigned long)size_);
+
+    return true;
+}
+
+void TraceReader::close() {
+    if (data_) {
+        if (munmap((void*)data_, size_) == -1) {
+            roc_log(LogError, "trace reader: munmap: %s",
+                    core::errno_to_str(errno).c_str());
+        }
+        data_ = NULL;
+        size_ = 0;
+        offset_ = 0;
+    }
+
+    if (fd_ != -1) {
+        if (::close(fd_) == -1) {
+            roc_log(LogError, "trace reader: close: %s",
+                    core::errno_to_str(errno).c_str());
+        }
+        fd_ = -1;
+    }
+}
+
+bool TraceReader::read(TraceRecord& record) {
+    if (!data_) {
+        return false;
+    }
+
+    if (size_ - offset_ < sizeof(TraceRecordHeader)) {
+        return false;
+    }
+
+    TraceRecordHeader hdr;
+    memcpy(&hdr, data_ + offset_, sizeof(hdr));
+
+    const size_t datagram_size = core::EndianOps::swap_native_le(hdr.size);
+
+    if (size_ - offset_ - sizeof(TraceRecordHeader) < datagram_size) {
+        roc_log(LogDebug, "trace reader: ignoring truncated record at offset %lu",
+                (unsigned long)offset_);
+        return false;
+    }
+
+    record.timestamp =
+        (core::nanoseconds_t)core::EndianOps::swap_native_le(hdr.timestamp);
+    record.iface = (address::Interface)hdr.iface;
+    record.data = data_ + offset_ + sizeof(TraceRecordHeader);
+    record.size = datagram_size;
+
+    record.src_addr.clear();
+
+    const uint16_t port = core::EndianOps::swap_native_le(hdr.port);
+
+    if (hdr.addr_family == 4) {
+        sockaddr_in sin;
+        memset(&sin, 0, sizeof(sin));
+        sin.sin_family = AF_INET;
+        sin.sin_port = htons(port);
+        memcpy(&sin.sin_addr, hdr.addr, sizeof(sin.sin_addr));
+        record.src_addr.set_host_port_saddr((const sockaddr*)&sin);
+    } else if (hdr.addr_family == 6) {
+        sockaddr_in6 sin6;
+        memset(&sin6, 0, sizeof(sin6));
+        sin6.sin6_family = AF_INET6;
+        sin6.sin6_port = htons(port);
+        memcpy(&sin6.sin6_addr, hdr.addr, sizeof(sin6.sin6_addr));
+        record.src_addr.set_host_port_saddr((const sockaddr*)&sin6);
+    }
+
+    const size_t record_size = trace_record_size(datagram_size);
+
+    offset_ += record_size < size_ - offset_ ? record_size : size_ - offset_;
+
+    return true;
+}
+
+void TraceReader::rewind() {
+    if (data_) {
+        offset_ = sizeof(TraceFileHeader);
+    }
+}
+
+} // namespace packet
+} // namespace roc
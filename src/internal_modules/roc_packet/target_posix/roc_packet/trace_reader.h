@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/target_posix/roc_packet/trace_reader.h
+//! @brief Packet trace reader.
+
+#ifndef ROC_PACKET_TRACE_READER_H_
+#define ROC_PACKET_TRACE_READER_H_
+
+#include "roc_address/interface.h"
+#include "roc_address/socket_addr.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_packet/trace_format.h"
+
+namespace roc {
+namespace packet {
+
+//! Packet trace record.
+struct TraceRecord {
+    //! Packet receive timestamp, unix time in nanoseconds.
+    core::nanoseconds_t timestamp;
+
+    //! Receiver interface which got the packet.
+    address::Interface iface;
+
+    //! Packet source address.
+    address::SocketAddr src_addr;
+
+    //! Datagram bytes.
+    //! @remarks
+    //!  Points into mapped file and remains valid until reader is closed.
+    const uint8_t* data;
+
+    //! Datagram size.
+    size_t size;
+
+    TraceRecord()
+        : timestamp(0)
+        , iface(address::Iface_Invalid)
+        , data(NULL)
+        , size(0) {
+    }
+};
+
+//! Packet trace reader.
+//!
+//! Maps trace file into memory and iterates its records without copying.
+//! See trace_format.h for file layout.
+class TraceReader : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    TraceReader();
+
+    //! Unmap and close file.
+    ~TraceReader();
+
+    //! Open and map file.
+    //! @remarks
+    //!  Fails if the file doesn't have a valid trace header.
+    bool open(const char* path);
+
+    //! Unmap and close file.
+    void close();
+
+    //! Read next record.
+    //! @returns
+    //!  false if there are no more records. Truncated last record is ignored.
+    bool read(TraceRecord& record);
+
+    //! Go back to the first record.
+    void rewind();
+
+private:
+    int fd_;
+    const uint8_t* data_;
+    size_t size_;
+    size_t offset_;
+};
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_TRACE_READER_H_
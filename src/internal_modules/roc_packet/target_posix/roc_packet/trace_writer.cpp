@@ -0,0 +1,304 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "roc_core/endian_ops.h"
+#include "roc_core/errno_to_str.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_packet/trace_writer.h"
+
+namespace roc {
+namespace packet {
+
+TraceWriter::TraceWriter()
+    : fd_(-1)
+    , buffer_size_(0)
+    , n_records_(0) {
+    path_[0] = '\0';
+}
+
+TraceWriter::~TraceWriter() {
+    close();
+}
+
+bool TraceWriter::open(const char* path) {
+    core::Mutex::Lock lock(mutex_);
+
+    roc_panic_if(!path);
+
+    if (fd_ != -1) {
+        roc_panic("trace writer: can't open file twice");
+    }
+
+    if (strlen(path) >= sizeof(path_)) {
+        roc_log(LogError, "trace writer: path too long: %s", path);
+        return false;
+    }
+    strcpy(path_, path);
+
+    fd_ = ::open(path_, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ == -1) {
+        roc_log(LogError, "trace writer: open: %s: %s", path_,
+                core::errno_to_str(errno).c_str());
+        return false;
+    }
+
+    if (!prepare_file_()) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    roc_log(LogDebug, "trace writer: opened %s", path_);
+
+    return true;
+}
+
+bool TraceWriter::write(core::nanoseconds_t timestamp,
+                        address::Interface iface,
+                        const address::SocketAddr& src_addr,
+                        const core::Slice<uint8_t>& data) {
+    core::Mutex::Lock lock(mutex_);
+
+    if (fd_ == -1) {
+        return false;
+    }
+
+    if (timestamp == 0) {
+        timestamp = core::timestamp(core::ClockUnix);
+    }
+
+    TraceRecordHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+
+    hdr.timestamp = core::EndianOps::swap_native_le((uint64_t)timestamp);
+    hdr.size = core::EndianOps::swap_native_le((uint32_t)data.size());
+    hdr.iface = (uint8_t)iface;
+
+    const sockaddr* sa = src_addr.saddr();
+
+    if (src_addr.has_host_port() && sa->sa_family == AF_INET) {
+        const sockaddr_in* sin = (const sockaddr_in*)sa;
+        hdr.addr_family = 4;
+        hdr.port = core::EndianOps::swap_native_le((uint16_t)src_addr.port());
+        memcpy(hdr.addr, &sin->sin_addr, sizeof(sin->sin_addr));
+    } else if (src_addr.has_host_port() && sa->sa_family == AF_INET6) {
+        const sockaddr_in6* sin6 = (const sockaddr_in6*)sa;
+        hdr.addr_family = 6;
+        hdr.port = core::EndianOps::swap_native_le((uint16_t)src_addr.port());
+        memcpy(hdr.addr, &sin6->sin6_addr, sizeof(sin6->sin6_addr));
+    }
+
+    const size_t record_size = trace_record_size(data.size());
+
+    if (buffer_size_ + record_size > BufferSize) {
+        if (!flush_()) {
+            return false;
+        }
+    }
+
+    if (record_size > BufferSize) {
+        // Too large to be buffered, write directly.
+        const uint8_t padding[TraceAlignment] = { 0 };
+
+        if (!write_all_(&hdr, sizeof(hdr)) || !write_all_(data.data(), data.size())
+            || !write_all_(padding, record_size - sizeof(hdr) - data.size())) {
+            return false;
+        }
+    } else {
+        uint8_t* ptr = buffer_ + buffer_size_;
+
+        memcpy(ptr, &hdr, sizeof(hdr));
+        if (data.size() != 0) {
+            memcpy(ptr + sizeof(hdr), data.data(), data.size());
+        }
+        memset(ptr + sizeof(hdr) + data.size(), 0,
+               record_size - sizeof(hdr) - data.size());
+
+        buffer_size_ += record_size;
+    }
+
+    n_records_++;
+
+    return true;
+}
+
+bool TraceWriter::flush() {
+    core::Mutex::Lock lock(mutex_);
+
+    if (fd_ == -1) {
+        return false;
+    }
+
+    return flush_();
+}
+
+bool TraceWriter::close() {
+    core::Mutex::Lock lock(mutex_);
+
+    if (fd_ == -1) {
+        return true;
+    }
+
+    bool ok = flush_();
+
+    if (::close(fd_) == -1) {
+        roc_log(LogError, "trace writer: close: %s: %s", path_,
+                core::errno_to_str(errno).c_str());
+        ok = false;
+    }
+
+    roc_log(LogDebug, "trace writer: closed %s: n_records=%lu", path_,
+            (unsigned long)n_records_);
+
+    fd_ = -1;
+
+    return ok;
+}
+
+size_t TraceWriter::num_records() const {
+    core::Mutex::Lock lock(mutex_);
+
+    return n_records_;
+}
+
+bool TraceWriter::prepare_file_() {
+    struct stat st;
+    if (fstat(fd_, &st) == -1) {
+        roc_log(LogError, "trace writer: fstat: %s: %s", path_,
+                core::errno_to_str(errno).c_str());
+        return false;
+    }
+
+    if (st.st_size == 0) {
+        return write_header_();
+    }
+
+    off_t valid_size = 0;
+    if (!scan_file_(st.st_size, valid_size)) {
+        return false;
+    }
+
+    // If previous writer was killed in the middle of a record, records appended
+    // after it would be lost for reader, so cut the incomplete record. If only
+    // padding is missing, it's restored, since ftruncate() fills it with zeros.
+    if (valid_size != st.st_size) {
+        roc_log(LogInfo,
+                "trace writer: fixing incomplete last record: %s:"
+                " file_size=%lu new_size=%lu",
+                path_, (unsigned long)st.st_size, (unsigned long)valid_size);
+
+        if (ftruncate(fd_, valid_size) == -1) {
+            roc_log(LogError, "trace writer: ftruncate: %s: %s", path_,
+                    core::errno_to_str(errno).c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TraceWriter::scan_file_(off_t file_size, off_t& valid_size) {
+    const int rd_fd = ::open(path_, O_RDONLY | O_CLOEXEC);
+    if (rd_fd == -1) {
+        roc_log(LogError, "trace writer: open: %s: %s", path_,
+                core::errno_to_str(errno).c_str());
+        return false;
+    }
+
+    TraceFileHeader hdr;
+    if (!read_at_(rd_fd, 0, &hdr, sizeof(hdr))
+        || memcmp(hdr.magic, TraceMagic, TraceMagicSize) != 0
+        || core::EndianOps::swap_native_le(hdr.version) != TraceVersion) {
+        roc_log(LogError, "trace writer: file exists and is not a compatible trace: %s",
+                path_);
+        ::close(rd_fd);
+        return false;
+    }
+
+    // Find end of last record which datagram is fully written.
+    off_t offset = sizeof(TraceFileHeader);
+
+    for (;;) {
+        TraceRecordHeader rec;
+        if (file_size - offset < (off_t)sizeof(rec)
+            || !read_at_(rd_fd, offset, &rec, sizeof(rec))) {
+            break;
+        }
+
+        const size_t datagram_size = core::EndianOps::swap_native_le(rec.size);
+        if (file_size - offset - (off_t)sizeof(rec) < (off_t)datagram_size) {
+            break;
+        }
+
+        offset += (off_t)trace_record_size(datagram_size);
+    }
+
+    ::close(rd_fd);
+
+    valid_size = offset;
+
+    return true;
+}
+
+bool TraceWriter::read_at_(int fd, off_t offset, void* data, size_t size) {
+    const ssize_t ret = ::pread(fd, data, size, offset);
+
+    return ret == (ssize_t)size;
+}
+
+bool TraceWriter::write_header_() {
+    TraceFileHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+
+    memcpy(hdr.magic, TraceMagic, TraceMagicSize);
+    hdr.version = core::EndianOps::swap_native_le((uint32_t)TraceVersion);
+
+    return write_all_(&hdr, sizeof(hdr));
+}
+
+bool TraceWriter::flush_() {
+    if (buffer_size_ == 0) {
+        return true;
+    }
+
+    const bool ok = write_all_(buffer_, buffer_size_);
+    buffer_size_ = 0;
+
+    return ok;
+}
+
+bool TraceWriter::write_all_(const void* data, size_t size) {
+    const uint8_t* ptr = (const uint8_t*)data;
+
+    while (size != 0) {
+        const ssize_t ret = ::write(fd_, ptr, size);
+        if (ret == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            roc_log(LogError, "trace writer: write: %s: %s", path_,
+                    core::errno_to_str(errno).c_str());
+            return false;
+        }
+        ptr += ret;
+        size -= (size_t)ret;
+    }
+
+    return true;
+}
+
+} // namespace packet
+} // namespace roc
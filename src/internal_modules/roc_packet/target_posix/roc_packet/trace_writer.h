@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/target_posix/roc_packet/trace_writer.h
+//! @brief Packet trace writer.
+
+#ifndef ROC_PACKET_TRACE_WRITER_H_
+#define ROC_PACKET_TRACE_WRITER_H_
+
+#include <limits.h>
+#include <sys/types.h>
+
+#include "roc_address/interface.h"
+#include "roc_address/socket_addr.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/slice.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_packet/trace_format.h"
+
+namespace roc {
+namespace packet {
+
+//! Packet trace writer.
+//!
+//! Appends datagrams with their arrival timestamps and source addresses
+//! to a trace file. See trace_format.h for file layout.
+//!
+//! Records are accumulated in an internal buffer and written to file when
+//! the buffer becomes full, on flush(), and on close(). Thread-safe.
+class TraceWriter : public core::NonCopyable<> {
+public:
+    //! Initialize.
+    TraceWriter();
+
+    //! Flush and close file.
+    ~TraceWriter();
+
+    //! Open file for appending.
+    //! @remarks
+    //!  Creates the file if it doesn't exist. Writes file header if the
+    //!  file is empty, or checks it otherwise. If the last record of existing
+    //!  file is incomplete, it is cut off before appending new records.
+    bool open(const char* path);
+
+    //! Append record.
+    //! @remarks
+    //!  @p timestamp is unix time in nanoseconds when the datagram was received.
+    //!  If it's zero, current time is used.
+    bool write(core::nanoseconds_t timestamp,
+               address::Interface iface,
+               const address::SocketAddr& src_addr,
+               const core::Slice<uint8_t>& data);
+
+    //! Write buffered records to file.
+    bool flush();
+
+    //! Flush and close file.
+    bool close();
+
+    //! Get number of records written.
+    size_t num_records() const;
+
+private:
+    enum { BufferSize = 64 * 1024 };
+
+    bool prepare_file_();
+    bool scan_file_(off_t file_size, off_t& valid_size);
+    static bool read_at_(int fd, off_t offset, void* data, size_t size);
+    bool write_header_();
+    bool flush_();
+    bool write_all_(const void* data, size_t size);
+
+    core::Mutex mutex_;
+
+    int fd_;
+    char path_[PATH_MAX];
+
+    uint8_t buffer_[BufferSize];
+    size_t buffer_size_;
+
+    size_t n_records_;
+};
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_TRACE_WRITER_H_
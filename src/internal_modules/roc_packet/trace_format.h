@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_packet/trace_format.h
+//! @brief Packet trace file format.
+
+#ifndef ROC_PACKET_TRACE_FORMAT_H_
+#define ROC_PACKET_TRACE_FORMAT_H_
+
+#include "roc_core/attributes.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace packet {
+
+//! Packet trace file format.
+//!
+//! Trace file consists of a file header followed by a sequence of records.
+//! Every record consists of a record header followed by raw datagram bytes,
+//! padded with zeros to a multiple of TraceAlignment bytes, so that all record
+//! headers are properly aligned when the file is mapped into memory.
+//!
+//! The file is append-only: records are only added to the end. If the last
+//! record is truncated, e.g. because the writer was killed, it is ignored
+//! by reader.
+//!
+//! All integers are stored in little-endian byte order.
+//! @code
+//!   file:   | TraceFileHeader | record | record | ...
+//!   record: | TraceRecordHeader | datagram | padding |
+//! @endcode
+enum {
+    //! Alignment of records in file.
+    TraceAlignment = 8,
+
+    //! Current format version.
+    TraceVersion = 1,
+
+    //! Size of trace magic string.
+    TraceMagicSize = 8
+};
+
+//! Trace magic string, placed at the beginning of file.
+const char TraceMagic[TraceMagicSize + 1] = "ROCTRACE";
+
+//! Trace file header.
+ROC_ATTR_PACKED_BEGIN struct TraceFileHeader {
+    //! Magic string, without terminating zero.
+    uint8_t magic[TraceMagicSize];
+
+    //! Format version.
+    uint32_t version;
+
+    //! Reserved, zero.
+    uint32_t reserved;
+} ROC_ATTR_PACKED_END;
+
+//! Trace record header.
+ROC_ATTR_PACKED_BEGIN struct TraceRecordHeader {
+    //! Packet receive timestamp, unix time in nanoseconds.
+    uint64_t timestamp;
+
+    //! Size of datagram following the header, in bytes.
+    uint32_t size;
+
+    //! Receiver interface (address::Interface) which got the packet.
+    uint8_t iface;
+
+    //! Source address family, 4 or 6.
+    uint8_t addr_family;
+
+    //! Source port.
+    uint16_t port;
+
+    //! Source IPv4 or IPv6 address, in network byte order.
+    uint8_t addr[16];
+} ROC_ATTR_PACKED_END;
+
+//! Get record size in file, including header and padding.
+inline size_t trace_record_size(size_t datagram_size) {
+    const size_t size = sizeof(TraceRecordHeader) + datagram_size;
+    return (size + TraceAlignment - 1) / TraceAlignment * TraceAlignment;
+}
+
+} // namespace packet
+} // namespace roc
+
+#endif // ROC_PACKET_TRACE_FORMAT_H_
@@ -164,6 +164,59 @@ bool Receiver::set_reuseaddr(size_t slot_index, address::Interface iface, bool e
     return true;
 }
 
+bool Receiver::set_busy_polling(size_t slot_index,
+                                address::Interface iface,
+                                core::nanoseconds_t spin_duration,
+                                core::nanoseconds_t socket_busy_poll_duration) {
+    core::Mutex::Lock lock(mutex_);
+
+    roc_panic_if_not(valid());
+
+    roc_panic_if(iface < 0);
+    roc_panic_if(iface >= (int)address::Iface_Max);
+
+    roc_log(LogDebug,
+            "receiver peer: enabling busy polling for %s interface of slot %lu:"
+            " spin_duration=%.3fms socket_busy_poll=%.3fms",
+            address::interface_to_str(iface), (unsigned long)slot_index,
+            (double)spin_duration / core::Millisecond,
+            (double)socket_busy_poll_duration / core::Millisecond);
+
+    if (spin_duration < 0 || socket_busy_poll_duration < 0) {
+        roc_log(LogError,
+                "receiver peer:"
+                " can't enable busy polling for %s interface of slot %lu:"
+                " durations should not be negative",
+                address::interface_to_str(iface), (unsigned long)slot_index);
+        return false;
+    }
+
+    Slot* slot = get_slot_(slot_index);
+    if (!slot) {
+        roc_log(LogError,
+                "receiver peer:"
+                " can't enable busy polling for %s interface of slot %lu:"
+                " can't create slot",
+                address::interface_to_str(iface), (unsigned long)slot_index);
+        return false;
+    }
+
+    if (slot->ports[iface].handle) {
+        roc_log(LogError,
+                "receiver peer:"
+                " can't enable busy polling for %s interface of slot %lu:"
+                " interface is already bound",
+                address::interface_to_str(iface), (unsigned long)slot_index);
+        return false;
+    }
+
+    slot->ports[iface].config.busy_polling = true;
+    slot->ports[iface].config.busy_polling_spin_duration = spin_duration;
+    slot->ports[iface].config.socket_busy_poll_duration = socket_busy_poll_duration;
+
+    return true;
+}
+
 bool Receiver::bind(size_t slot_index,
                     address::Interface iface,
                     address::EndpointUri& uri) {
@@ -262,6 +315,78 @@ bool Receiver::bind(size_t slot_index,
     return true;
 }
 
+bool Receiver::get_metrics(size_t slot_index,
+                           pipeline::ReceiverMetrics& recv_metrics,
+                           ReceiverPortMetrics& port_metrics,
+                           pipeline::ReceiverSessionMetricsFunc sess_metrics_func,
+                           size_t* sess_metrics_size,
+                           void* sess_metrics_arg) {
+    core::Mutex::Lock lock(mutex_);
+
+    roc_panic_if_not(valid());
+
+    if (slot_index >= slots_.size() || !slots_[slot_index].slot) {
+        roc_log(LogError,
+                "receiver peer:"
+                " can't get metrics of slot %lu:"
+                " slot doesn't exist",
+                (unsigned long)slot_index);
+        return false;
+    }
+
+    pipeline::ReceiverLoop::Tasks::QuerySlot task(
+        slots_[slot_index].slot, sess_metrics_func, sess_metrics_size, sess_metrics_arg);
+    if (!pipeline_.schedule_and_wait(task)) {
+        roc_log(LogError,
+                "receiver peer:"
+                " can't get metrics of slot %lu:"
+                " operation failed",
+                (unsigned long)slot_index);
+        return false;
+    }
+
+    recv_metrics = pipeline_.get_metrics();
+
+    port_metrics = ReceiverPortMetrics();
+
+    core::nanoseconds_t spin_delay = 0;
+    core::nanoseconds_t parked_delay = 0;
+
+    for (size_t p = 0; p < address::Iface_Max; p++) {
+        if (!slots_[slot_index].ports[p].handle) {
+            continue;
+        }
+
+        netio::NetworkLoop::Tasks::QueryUdpReceiverPort task(
+            slots_[slot_index].ports[p].handle);
+        if (!context().network_loop().schedule_and_wait(task)) {
+            roc_log(LogError, "receiver peer: can't query %s interface port",
+                    address::interface_to_str(address::Interface(p)));
+            continue;
+        }
+
+        const netio::UdpReceiverBusyPollStats& stats = task.get_busy_poll_stats();
+
+        port_metrics.busy_poll_packets += stats.n_packets;
+        port_metrics.busy_poll_spin_packets += stats.n_spin_packets;
+        port_metrics.busy_poll_parked_packets += stats.n_parked_packets;
+
+        spin_delay += stats.spin_delivery_delay;
+        parked_delay += stats.parked_delivery_delay;
+    }
+
+    if (port_metrics.busy_poll_spin_packets != 0) {
+        port_metrics.busy_poll_spin_delay =
+            spin_delay / (core::nanoseconds_t)port_metrics.busy_poll_spin_packets;
+    }
+    if (port_metrics.busy_poll_parked_packets != 0) {
+        port_metrics.busy_poll_parked_delay =
+            parked_delay / (core::nanoseconds_t)port_metrics.busy_poll_parked_packets;
+    }
+
+    return true;
+}
+
 sndio::ISource& Receiver::source() {
     return pipeline_.source();
 }
@@ -16,6 +16,8 @@
 #include "roc_address/interface.h"
 #include "roc_address/protocol.h"
 #include "roc_core/mutex.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
 #include "roc_ctl/control_loop.h"
 #include "roc_peer/basic_peer.h"
 #include "roc_peer/context.h"
@@ -26,6 +28,34 @@
 namespace roc {
 namespace peer {
 
+//! Metrics of receiver network ports.
+//! @remarks
+//!  Summed over UDP ports of a slot.
+struct ReceiverPortMetrics {
+    //! Number of packets received by busy polling threads.
+    uint64_t busy_poll_packets;
+
+    //! Number of packets received while spinning on empty socket.
+    uint64_t busy_poll_spin_packets;
+
+    //! Number of packets received right after busy polling thread was unparked.
+    uint64_t busy_poll_parked_packets;
+
+    //! Average delivery delay of packets received while spinning.
+    core::nanoseconds_t busy_poll_spin_delay;
+
+    //! Average delivery delay of packets received after unparking.
+    core::nanoseconds_t busy_poll_parked_delay;
+
+    ReceiverPortMetrics()
+        : busy_poll_packets(0)
+        , busy_poll_spin_packets(0)
+        , busy_poll_parked_packets(0)
+        , busy_poll_spin_delay(0)
+        , busy_poll_parked_delay(0) {
+    }
+};
+
 //! Receiver peer.
 class Receiver : public BasicPeer, private pipeline::IPipelineTaskScheduler {
 public:
@@ -44,9 +74,30 @@ public:
     //! Set reuseaddr option for given endpoint type.
     bool set_reuseaddr(size_t slot_index, address::Interface iface, bool enabled);
 
+    //! Enable busy polling for given endpoint type.
+    //! @remarks
+    //!  Packets are received on a dedicated thread that spins for @p spin_duration
+    //!  on empty socket before parking. If @p socket_busy_poll_duration is non-zero,
+    //!  SO_BUSY_POLL is enabled as well.
+    bool set_busy_polling(size_t slot_index,
+                          address::Interface iface,
+                          core::nanoseconds_t spin_duration,
+                          core::nanoseconds_t socket_busy_poll_duration);
+
     //! Bind peer to local endpoint.
     bool bind(size_t slot_index, address::Interface iface, address::EndpointUri& uri);
 
+    //! Get receiver metrics and metrics of ports and sessions of given slot.
+    //! @remarks
+    //!  Invokes @p sess_metrics_func for up to @p *sess_metrics_size sessions
+    //!  and sets @p *sess_metrics_size to the number of sessions in the slot.
+    bool get_metrics(size_t slot_index,
+                     pipeline::ReceiverMetrics& recv_metrics,
+                     ReceiverPortMetrics& port_metrics,
+                     pipeline::ReceiverSessionMetricsFunc sess_metrics_func,
+                     size_t* sess_metrics_size,
+                     void* sess_metrics_arg);
+
     //! Get receiver source.
     sndio::ISource& source();
 
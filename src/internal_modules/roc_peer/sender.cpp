@@ -30,6 +30,9 @@ Sender::Sender(Context& context, const pipeline::SenderConfig& pipeline_config)
     , valid_(false) {
     roc_log(LogDebug, "sender peer: initializing");
 
+    memset(pacing_intervals_, 0, sizeof(pacing_intervals_));
+    calc_pacing_intervals_(pipeline_config);
+
     memset(used_interfaces_, 0, sizeof(used_interfaces_));
     memset(used_protocols_, 0, sizeof(used_protocols_));
 
@@ -45,6 +48,11 @@ Sender::~Sender() {
 
     context().control_loop().wait(processing_task_);
 
+    // send packets buffered in pipeline while ports are still there
+    if (pipeline_.valid()) {
+        pipeline_.sink().pause();
+    }
+
     for (size_t s = 0; s < slots_.size(); s++) {
         if (!slots_[s].slot) {
             continue;
@@ -218,6 +226,21 @@ bool Sender::connect(size_t slot_index,
         return false;
     }
 
+    if (&port != &slot->ports[iface]) {
+        // shared port sends packets to several destinations, so it can't
+        // be connected to one of them
+        netio::NetworkLoop::Tasks::DisableUdpSenderConnect connect_task(port.handle);
+
+        if (!context().network_loop().schedule_and_wait(connect_task)) {
+            roc_log(LogError,
+                    "sender peer:"
+                    " can't connect %s interface of slot %lu:"
+                    " can't disable connected mode of shared port",
+                    address::interface_to_str(iface), (unsigned long)slot_index);
+            return false;
+        }
+    }
+
     pipeline::SenderLoop::Tasks::CreateEndpoint endpoint_task(slot->slot, iface,
                                                               uri.proto());
     if (!pipeline_.schedule_and_wait(endpoint_task)) {
@@ -281,6 +304,52 @@ bool Sender::is_ready() {
     return true;
 }
 
+void Sender::get_metrics(pipeline::SenderMetrics& send_metrics,
+                         SenderPortMetrics& port_metrics) {
+    core::Mutex::Lock lock(mutex_);
+
+    roc_panic_if_not(valid());
+
+    send_metrics = pipeline_.get_metrics();
+
+    port_metrics = SenderPortMetrics();
+
+    for (size_t s = 0; s < slots_.size(); s++) {
+        for (size_t p = 0; p < address::Iface_Max; p++) {
+            // shared ports are stored only once, so they're not counted twice
+            if (!slots_[s].ports[p].handle) {
+                continue;
+            }
+
+            netio::NetworkLoop::Tasks::QueryUdpSenderPort task(
+                slots_[s].ports[p].handle);
+            if (!context().network_loop().schedule_and_wait(task)) {
+                roc_log(LogError, "sender peer: can't query %s interface port",
+                        address::interface_to_str(address::Interface(p)));
+                continue;
+            }
+
+            const netio::UdpSenderConnectStats& stats = task.get_connect_stats();
+
+            if (stats.connected) {
+                port_metrics.num_connected_ports++;
+            }
+            port_metrics.packets_refused += stats.n_refused;
+            port_metrics.packets_unreachable += stats.n_unreachable;
+
+            const netio::UdpSenderPacingStats& pacing = task.get_pacing_stats();
+
+            port_metrics.packets_paced += pacing.n_packets;
+            if (pacing.max_queue_size > port_metrics.max_pacing_queue_size) {
+                port_metrics.max_pacing_queue_size = pacing.max_queue_size;
+            }
+            if (pacing.max_deviation > port_metrics.max_pacing_deviation) {
+                port_metrics.max_pacing_deviation = pacing.max_deviation;
+            }
+        }
+    }
+}
+
 sndio::ISink& Sender::sink() {
     roc_panic_if_not(valid());
 
@@ -322,6 +391,13 @@ Sender::Slot* Sender::get_slot_(size_t slot_index) {
             return NULL;
         }
         slots_[slot_index].slot = task.get_handle();
+
+        // Source and repair ports are paced independently, each at the rate of
+        // its own stream. Since their configs differ, they're not shared when
+        // pacing is enabled.
+        for (size_t i = 0; i < address::Iface_Max; i++) {
+            slots_[slot_index].ports[i].config.pacing_interval = pacing_intervals_[i];
+        }
     }
 
     return &slots_[slot_index];
@@ -335,7 +411,8 @@ Sender::Port& Sender::select_outgoing_port_(Slot& slot,
     // associate source and repair streams together, in case when no control and
     // signaling protocol is used, by source addresses. This technique is neither
     // standard nor universal, but in many cases it allows us to work even without
-    // protocols like RTCP or RTSP.
+    // protocols like RTCP or RTSP. Shared port is never connected to remote address,
+    // since it sends packets to multiple destinations.
     const bool share_interface_ports =
         (iface == address::Iface_AudioSource || iface == address::Iface_AudioRepair);
 
@@ -412,6 +489,56 @@ bool Sender::setup_outgoing_port_(Port& port,
     return true;
 }
 
+void Sender::calc_pacing_intervals_(const pipeline::SenderConfig& pipeline_config) {
+    if (!pipeline_config.pacing) {
+        return;
+    }
+
+    // On average, pipeline produces one source packet per packet length.
+    const core::nanoseconds_t source_interval = pipeline_config.packet_length;
+
+    pacing_intervals_[address::Iface_AudioSource] = calc_pacing_interval_(
+        address::Iface_AudioSource, source_interval, 1, 1);
+
+    // If FEC is enabled, it produces n_repair packets per n_source packets.
+    if (pipeline_config.fec_encoder.scheme != packet::FEC_None) {
+        size_t n_repair_packets = pipeline_config.fec_writer.n_repair_packets;
+
+        // Pacing interval is fixed when port is created, while redundancy
+        // controller may change n_repair at run time. Pace for the highest
+        // rate it may choose, otherwise pacing queue would grow without bound.
+        if (pipeline_config.fec_redundancy.enabled
+            && pipeline_config.fec_redundancy.max_repair_packets > n_repair_packets) {
+            n_repair_packets = pipeline_config.fec_redundancy.max_repair_packets;
+        }
+
+        pacing_intervals_[address::Iface_AudioRepair] = calc_pacing_interval_(
+            address::Iface_AudioRepair, source_interval,
+            pipeline_config.fec_writer.n_source_packets, n_repair_packets);
+    }
+}
+
+core::nanoseconds_t Sender::calc_pacing_interval_(address::Interface iface,
+                                                  core::nanoseconds_t source_interval,
+                                                  size_t n_source_packets,
+                                                  size_t n_packets) {
+    if (source_interval <= 0 || n_source_packets == 0 || n_packets == 0) {
+        return 0;
+    }
+
+    core::nanoseconds_t interval = source_interval
+        * (core::nanoseconds_t)n_source_packets / (core::nanoseconds_t)n_packets;
+
+    // Send slightly faster than packets are produced, so that pacing queue
+    // is drained even if pipeline clock is a bit faster than ours.
+    interval -= interval / 10;
+
+    roc_log(LogDebug, "sender peer: enabling packet pacing: iface=%s interval=%.3fms",
+            address::interface_to_str(iface), (double)interval / core::Millisecond);
+
+    return interval;
+}
+
 void Sender::schedule_task_processing(pipeline::PipelineLoop&,
                                       core::nanoseconds_t deadline) {
     context().control_loop().schedule_at(processing_task_, deadline, NULL);
@@ -17,6 +17,8 @@
 #include "roc_address/protocol.h"
 #include "roc_core/mutex.h"
 #include "roc_core/scoped_ptr.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
 #include "roc_packet/iwriter.h"
 #include "roc_peer/basic_peer.h"
 #include "roc_peer/context.h"
@@ -27,6 +29,39 @@
 namespace roc {
 namespace peer {
 
+//! Metrics of sender network ports.
+//! @remarks
+//!  Summed over UDP ports of all slots.
+struct SenderPortMetrics {
+    //! Number of ports which socket is connected to remote address.
+    size_t num_connected_ports;
+
+    //! Number of packets refused by remote peer (ICMP port unreachable).
+    uint64_t packets_refused;
+
+    //! Number of packets for which remote host or network was reported
+    //! unreachable.
+    uint64_t packets_unreachable;
+
+    //! Number of packets sent via pacing queue.
+    uint64_t packets_paced;
+
+    //! Maximum number of packets waiting in pacing queue of a port.
+    size_t max_pacing_queue_size;
+
+    //! Maximum deviation of actual packet send time from scheduled one.
+    core::nanoseconds_t max_pacing_deviation;
+
+    SenderPortMetrics()
+        : num_connected_ports(0)
+        , packets_refused(0)
+        , packets_unreachable(0)
+        , packets_paced(0)
+        , max_pacing_queue_size(0)
+        , max_pacing_deviation(0) {
+    }
+};
+
 //! Sender peer.
 class Sender : public BasicPeer, private pipeline::IPipelineTaskScheduler {
 public:
@@ -53,6 +88,10 @@ public:
     //! Check if all necessary bind and connect calls were made.
     bool is_ready();
 
+    //! Get sender metrics.
+    void get_metrics(pipeline::SenderMetrics& send_metrics,
+                     SenderPortMetrics& port_metrics);
+
     //! Get sender sink.y
     sndio::ISink& sink();
 
@@ -88,6 +127,12 @@ private:
                               address::Interface iface,
                               address::AddrFamily family);
 
+    void calc_pacing_intervals_(const pipeline::SenderConfig& pipeline_config);
+    static core::nanoseconds_t calc_pacing_interval_(address::Interface iface,
+                                                     core::nanoseconds_t source_interval,
+                                                     size_t n_source_packets,
+                                                     size_t n_packets);
+
     virtual void schedule_task_processing(pipeline::PipelineLoop&,
                                           core::nanoseconds_t delay);
     virtual void cancel_task_processing(pipeline::PipelineLoop&);
@@ -101,6 +146,8 @@ private:
 
     core::Array<Slot, 8> slots_;
 
+    core::nanoseconds_t pacing_intervals_[address::Iface_Max];
+
     bool used_interfaces_[address::Iface_Max];
     address::Protocol used_protocols_[address::Iface_Max];
 
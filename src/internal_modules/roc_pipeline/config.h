@@ -22,8 +22,10 @@
 #include "roc_audio/watchdog.h"
 #include "roc_core/stddefs.h"
 #include "roc_core/time.h"
+#include "roc_fec/block_interleaver.h"
 #include "roc_fec/codec_config.h"
 #include "roc_fec/reader.h"
+#include "roc_fec/redundancy_controller.h"
 #include "roc_fec/writer.h"
 #include "roc_packet/units.h"
 #include "roc_rtp/headers.h"
@@ -114,6 +116,16 @@ struct SenderConfig {
     //! FEC encoder parameters.
     fec::CodecConfig fec_encoder;
 
+    //! FEC redundancy controller parameters.
+    fec::RedundancyConfig fec_redundancy;
+
+    //! FEC block interleaver parameters.
+    //! @remarks
+    //!  If enabled, takes precedence over @c interleaving. Not supported
+    //!  with sliding window schemes. Added latency is reported by sink and
+    //!  should be passed to receiver via ReceiverSessionConfig.
+    fec::BlockInterleaverConfig fec_interleaver;
+
     //! Input sample spec
     audio::SampleSpec input_sample_spec;
 
@@ -132,6 +144,21 @@ struct SenderConfig {
     //! Interleave packets.
     bool interleaving;
 
+    //! Pace packets.
+    //! @remarks
+    //!  If set, outgoing packets are spread evenly over time instead of
+    //!  being sent in bursts, e.g. when FEC writer produces repair packets
+    //!  at the end of a block.
+    bool pacing;
+
+    //! Encode audio once for all slots.
+    //! @remarks
+    //!  If set, only the first slot runs packetizer, FEC writer, and
+    //!  interleaver, and the produced packets are sent to the endpoints of
+    //!  all slots. Packet buffers are shared between destinations instead of
+    //!  being copied. All slots should use the same protocols.
+    bool shared_encoding;
+
     //! Constrain receiver speed using a CPU timer according to the sample rate.
     bool timing;
 
@@ -153,6 +180,8 @@ struct SenderConfig {
         , payload_type(rtp::PayloadType_L16_Stereo)
         , resampling(false)
         , interleaving(false)
+        , pacing(false)
+        , shared_encoding(false)
         , timing(false)
         , poisoning(false)
         , profiling(false) {
@@ -169,6 +198,14 @@ struct ReceiverSessionConfig {
     //! Packet payload type.
     unsigned int payload_type;
 
+    //! Latency added by FEC block interleaving on sender, nanoseconds.
+    //! @remarks
+    //!  Should match latency reported by sender. Repair of a block is
+    //!  possible only when packets of all interleaved blocks are queued,
+    //!  so if non-zero, target latency should exceed this value, and
+    //!  playback is not started until this much packets is queued.
+    core::nanoseconds_t fec_interleaving_latency;
+
     //! FEC reader parameters.
     fec::ReaderConfig fec_reader;
 
@@ -196,6 +233,7 @@ struct ReceiverSessionConfig {
     ReceiverSessionConfig()
         : target_latency(DefaultLatency)
         , payload_type(0)
+        , fec_interleaving_latency(0)
         , freq_estimator_config()
         , resampler_backend(audio::ResamplerBackend_Default)
         , resampler_profile(audio::ResamplerProfile_Medium) {
@@ -232,6 +270,29 @@ struct ReceiverCommonConfig {
     //! Insert weird beeps instead of silence on packet loss.
     bool beeping;
 
+    //! Number of worker threads used to read sessions in parallel.
+    //! @remarks
+    //!  If zero, all sessions are read sequentially on the pipeline thread.
+    //!  Otherwise, the pipeline thread and the workers read sessions together,
+    //!  and the pipeline thread mixes the results when all sessions are read.
+    size_t session_workers;
+
+    //! Number of sessions to prewarm on startup.
+    //! @remarks
+    //!  Sessions are allocated from a per-slot arena which keeps memory of
+    //!  removed sessions for reuse. On startup, this number of sessions is created
+    //!  with default session parameters and removed, so that the arena and buffer
+    //!  pools are filled in advance and creating up to this number of concurrent
+    //!  sessions later doesn't cause heap allocations.
+    size_t prewarmed_sessions;
+
+    //! Path to packet trace file, or NULL.
+    //! @remarks
+    //!  If set, every datagram received by receiver endpoints is appended to
+    //!  this file together with its arrival timestamp and source address, before
+    //!  being parsed. The trace can be later fed back using roc-replay tool.
+    const char* packet_trace_path;
+
     ReceiverCommonConfig()
         : output_sample_spec(DefaultSampleRate, DefaultChannelMask)
         , internal_frame_length(DefaultInternalFrameLength)
@@ -239,7 +300,10 @@ struct ReceiverCommonConfig {
         , timing(false)
         , poisoning(false)
         , profiling(false)
-        , beeping(false) {
+        , beeping(false)
+        , session_workers(0)
+        , prewarmed_sessions(0)
+        , packet_trace_path(NULL) {
     }
 };
 
@@ -296,6 +360,30 @@ struct ConverterConfig {
     }
 };
 
+//! Parallel converter parameters.
+struct ParallelConverterConfig {
+    //! Number of worker threads.
+    //! @remarks
+    //!  If zero, conversion is performed sequentially.
+    size_t num_workers;
+
+    //! Duration of input chunks converted by each worker, in nanoseconds.
+    //! @remarks
+    //!  Rounded up to the resampling period.
+    core::nanoseconds_t chunk_length;
+
+    //! Maximum allowed duration of input chunks, in nanoseconds.
+    //! @remarks
+    //!  If the resampling period is longer, parallel conversion is not possible.
+    core::nanoseconds_t max_chunk_length;
+
+    ParallelConverterConfig()
+        : num_workers(0)
+        , chunk_length(10 * core::Second)
+        , max_chunk_length(10 * core::Minute) {
+    }
+};
+
 } // namespace pipeline
 } // namespace roc
 
@@ -135,5 +135,30 @@ void ConverterSink::write(audio::Frame& frame) {
     audio_writer_->write(frame);
 }
 
+bool ConverterSink::get_period(size_t max_in_period,
+                               audio::ResamplerPeriod& period) const {
+    roc_panic_if(!audio_writer_);
+
+    if (resampler_) {
+        return resampler_->get_period(max_in_period, period);
+    }
+
+    // Without resampler, every input sample maps to one output sample.
+    period.in_period = 1;
+    period.out_period = 1;
+    period.warmup = 0;
+    period.lookahead = 0;
+
+    return true;
+}
+
+void ConverterSink::flush() {
+    roc_panic_if(!valid());
+
+    if (resampler_writer_) {
+        resampler_writer_->flush();
+    }
+}
+
 } // namespace pipeline
 } // namespace roc
@@ -71,6 +71,20 @@ public:
     //! Write audio frame.
     virtual void write(audio::Frame& frame);
 
+    //! Get resampling period of the pipeline.
+    //! @remarks
+    //!  Tells at which input positions the pipeline can be started from scratch
+    //!  and still produce the same output. Returns false if the pipeline can't
+    //!  be restarted or the period exceeds @p max_in_period.
+    bool get_period(size_t max_in_period, audio::ResamplerPeriod& period) const;
+
+    //! Write pending output samples.
+    //! @remarks
+    //!  Resampler writes output by frames of fixed size, so the last incomplete
+    //!  frame is kept until more input is written. This method writes it as a
+    //!  shorter frame; it should be called after the last frame was written.
+    void flush();
+
 private:
     audio::NullWriter null_writer_;
 
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_pipeline/metrics.h
+//! @brief Pipeline metrics.
+
+#ifndef ROC_PIPELINE_METRICS_H_
+#define ROC_PIPELINE_METRICS_H_
+
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_pipeline/pipeline_loop.h"
+
+namespace roc {
+namespace pipeline {
+
+//! Metrics of receiver session.
+//! @remarks
+//!  Snapshot is taken by session after every frame.
+struct ReceiverSessionMetrics {
+    //! Current latency, i.e. length of session queue, in nanoseconds.
+    core::nanoseconds_t latency;
+
+    //! Target latency, in nanoseconds.
+    core::nanoseconds_t target_latency;
+
+    //! Current resampler scaling factor.
+    float scaling;
+
+    //! Interarrival jitter, in nanoseconds.
+    core::nanoseconds_t jitter;
+
+    //! Number of source packets received.
+    uint64_t packets_received;
+
+    //! Number of source packets lost in network.
+    uint64_t packets_lost;
+
+    //! Number of source packets dropped because they arrived too late.
+    uint64_t packets_late;
+
+    //! Number of source packets restored using FEC.
+    uint64_t packets_recovered;
+
+    //! Average time spent on reading one frame from session, in nanoseconds.
+    core::nanoseconds_t frame_processing_time;
+
+    //! Time from session creation until first audio packet was played,
+    //! in nanoseconds; zero if playback didn't start yet.
+    core::nanoseconds_t time_to_first_audio;
+
+    ReceiverSessionMetrics()
+        : latency(0)
+        , target_latency(0)
+        , scaling(1.0f)
+        , jitter(0)
+        , packets_received(0)
+        , packets_lost(0)
+        , packets_late(0)
+        , packets_recovered(0)
+        , frame_processing_time(0)
+        , time_to_first_audio(0) {
+    }
+};
+
+//! Receiver session metrics callback.
+//! @remarks
+//!  Invoked for every session with @p sess_index of the session and
+//!  @p sess_metrics_arg passed by caller.
+typedef void (*ReceiverSessionMetricsFunc)(const ReceiverSessionMetrics& sess_metrics,
+                                           size_t sess_index,
+                                           void* sess_metrics_arg);
+
+//! Metrics of receiver pipeline.
+struct ReceiverMetrics {
+    //! Number of active sessions.
+    size_t num_sessions;
+
+    //! Pipeline loop statistics.
+    PipelineLoop::Stats pipeline;
+
+    ReceiverMetrics()
+        : num_sessions(0) {
+    }
+};
+
+//! Metrics of sender pipeline.
+struct SenderMetrics {
+    //! Pipeline loop statistics.
+    PipelineLoop::Stats pipeline;
+
+    //! Latency added by sender, in nanoseconds.
+    //! @remarks
+    //!  Non-zero if FEC block interleaving is enabled. Receiver should
+    //!  use it as ReceiverSessionConfig::fec_interleaving_latency.
+    core::nanoseconds_t latency;
+
+    SenderMetrics()
+        : latency(0) {
+    }
+};
+
+} // namespace pipeline
+} // namespace roc
+
+#endif // ROC_PIPELINE_METRICS_H_
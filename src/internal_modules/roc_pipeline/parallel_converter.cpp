@@ -0,0 +1,500 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "roc_pipeline/parallel_converter.h"
+#include "roc_audio/frame.h"
+#include "roc_core/log.h"
+#include "roc_core/panic.h"
+#include "roc_pipeline/converter_sink.h"
+
+namespace roc {
+namespace pipeline {
+
+namespace {
+
+size_t round_up(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+} // namespace
+
+void ParallelConverter::Job::write(audio::Frame& frame) {
+    if (failed) {
+        return;
+    }
+
+    const size_t old_size = output.size();
+    const size_t new_size = old_size + frame.num_samples();
+
+    if (!output.grow_exp(new_size) || !output.resize(new_size)) {
+        failed = true;
+        return;
+    }
+
+    memcpy(output.data() + old_size, frame.samples(),
+           frame.num_samples() * sizeof(audio::sample_t));
+}
+
+ParallelConverter::Worker::Worker(ParallelConverter& converter)
+    : converter_(converter) {
+}
+
+void ParallelConverter::Worker::run() {
+    converter_.worker_loop_();
+}
+
+ParallelConverter::ParallelConverter(
+    const ConverterConfig& config,
+    const ParallelConverterConfig& parallel_config,
+    audio::IFrameWriter* output_writer,
+    core::BufferFactory<audio::sample_t>& buffer_factory,
+    core::IAllocator& allocator)
+    : config_(config)
+    , output_writer_(output_writer ? output_writer : &null_writer_)
+    , buffer_factory_(buffer_factory)
+    , allocator_(allocator)
+    , in_num_ch_(config.input_sample_spec.num_channels())
+    , out_num_ch_(config.output_sample_spec.num_channels())
+    , in_frame_size_(
+          config.input_sample_spec.ns_2_samples_per_chan(config.internal_frame_length))
+    , out_frame_size_(
+          config.output_sample_spec.ns_2_samples_per_chan(config.internal_frame_length))
+    , quantized_output_(config.resampling
+                        && config.input_sample_spec.sample_rate()
+                            != config.output_sample_spec.sample_rate())
+    , chunk_size_(0)
+    , overlap_size_(0)
+    , out_chunk_size_(0)
+    , n_jobs_(0)
+    , input_pos_(0)
+    , emit_index_(0)
+    , submit_index_(0)
+    , run_index_(0)
+    , open_index_(0)
+    , work_cond_(mutex_)
+    , done_cond_(mutex_)
+    , stop_(false)
+    , n_workers_(0)
+    , failed_(false)
+    , valid_(false) {
+    const size_t num_workers = parallel_config.num_workers;
+
+    if (num_workers == 0 || num_workers > MaxWorkers) {
+        roc_log(LogError,
+                "parallel converter: invalid number of workers:"
+                " num_workers=%lu max_workers=%lu",
+                (unsigned long)num_workers, (unsigned long)MaxWorkers);
+        return;
+    }
+
+    if (in_num_ch_ == 0 || out_num_ch_ == 0 || in_frame_size_ == 0
+        || out_frame_size_ == 0) {
+        roc_log(LogError, "parallel converter: invalid sample spec or frame length");
+        return;
+    }
+
+    if (!init_chunks_(parallel_config)) {
+        return;
+    }
+
+    // Besides chunks being converted, one chunk may be filled and another
+    // may receive the overlap at the same time.
+    n_jobs_ = num_workers + 2;
+
+    for (size_t n = 0; n < n_jobs_; n++) {
+        jobs_[n].reset(new (jobs_[n]) Job(allocator_));
+    }
+
+    roc_log(LogDebug,
+            "parallel converter: initializing:"
+            " num_workers=%lu chunk_size=%lu overlap_size=%lu"
+            " in_period=%lu out_period=%lu warmup=%lu",
+            (unsigned long)num_workers, (unsigned long)chunk_size_,
+            (unsigned long)overlap_size_, (unsigned long)period_.in_period,
+            (unsigned long)period_.out_period, (unsigned long)period_.warmup);
+
+    for (; n_workers_ < num_workers; n_workers_++) {
+        workers_[n_workers_].reset(new (workers_[n_workers_]) Worker(*this));
+
+        if (!workers_[n_workers_]->start()) {
+            roc_log(LogError, "parallel converter: can't start worker thread");
+            workers_[n_workers_].reset();
+            return;
+        }
+    }
+
+    valid_ = true;
+}
+
+ParallelConverter::~ParallelConverter() {
+    {
+        core::Mutex::Lock lock(mutex_);
+
+        stop_ = true;
+        work_cond_.broadcast();
+    }
+
+    for (size_t n = 0; n < n_workers_; n++) {
+        workers_[n]->join();
+        workers_[n].reset();
+    }
+}
+
+bool ParallelConverter::valid() const {
+    return valid_;
+}
+
+size_t ParallelConverter::num_workers() const {
+    return n_workers_;
+}
+
+size_t ParallelConverter::chunk_size() const {
+    return chunk_size_;
+}
+
+sndio::DeviceType ParallelConverter::type() const {
+    return sndio::DeviceType_Sink;
+}
+
+sndio::DeviceState ParallelConverter::state() const {
+    return sndio::DeviceState_Active;
+}
+
+void ParallelConverter::pause() {
+    // no-op
+}
+
+bool ParallelConverter::resume() {
+    return true;
+}
+
+bool ParallelConverter::restart() {
+    return true;
+}
+
+audio::SampleSpec ParallelConverter::sample_spec() const {
+    return config_.output_sample_spec;
+}
+
+core::nanoseconds_t ParallelConverter::latency() const {
+    return 0;
+}
+
+bool ParallelConverter::has_clock() const {
+    return false;
+}
+
+void ParallelConverter::write(audio::Frame& frame) {
+    roc_panic_if(!valid_);
+
+    roc_panic_if_msg(frame.num_samples() % in_num_ch_ != 0,
+                     "parallel converter: unexpected frame size: size=%lu num_ch=%lu",
+                     (unsigned long)frame.num_samples(), (unsigned long)in_num_ch_);
+
+    if (failed_) {
+        return;
+    }
+
+    const audio::sample_t* samples = frame.samples();
+    size_t n_samples = frame.num_samples() / in_num_ch_;
+
+    while (n_samples != 0) {
+        if (input_pos_ == job_start_(open_index_)) {
+            if (!open_job_()) {
+                failed_ = true;
+                return;
+            }
+        }
+
+        // Copy input up to the start of the next chunk or the end of
+        // the oldest filling chunk, whichever comes first.
+        size_t n_copy = n_samples;
+        n_copy = std::min(n_copy, job_start_(open_index_) - input_pos_);
+        n_copy = std::min(n_copy, job_end_(submit_index_) - input_pos_);
+
+        append_input_(samples, n_copy);
+
+        input_pos_ += n_copy;
+        samples += n_copy * in_num_ch_;
+        n_samples -= n_copy;
+
+        if (input_pos_ == job_end_(submit_index_)) {
+            submit_job_(false);
+        }
+
+        while (emit_job_(false)) {
+        }
+    }
+}
+
+bool ParallelConverter::flush() {
+    roc_panic_if(!valid_);
+
+    if (!failed_ && open_index_ != submit_index_) {
+        if (open_index_ - submit_index_ > 1) {
+            // Input ended within the overlap of two chunks. The older chunk
+            // already has all remaining input, so the newer one isn't needed.
+            open_index_--;
+            job_(open_index_).state = JobFree;
+        }
+
+        submit_job_(true);
+    }
+
+    while (emit_job_(true)) {
+    }
+
+    while (open_index_ != submit_index_) {
+        open_index_--;
+        job_(open_index_).state = JobFree;
+    }
+
+    return !failed_;
+}
+
+bool ParallelConverter::init_chunks_(const ParallelConverterConfig& parallel_config) {
+    const size_t max_chunk_size =
+        config_.input_sample_spec.ns_2_samples_per_chan(parallel_config.max_chunk_length);
+
+    {
+        ConverterSink probe(config_, NULL, buffer_factory_, allocator_);
+        if (!probe.valid()) {
+            roc_log(LogError, "parallel converter: can't create converter pipeline");
+            return false;
+        }
+
+        if (!probe.get_period(max_chunk_size, period_)) {
+            roc_log(LogInfo,
+                    "parallel converter: can't split input into chunks:"
+                    " resampling period is unknown or exceeds maximum chunk length:"
+                    " max_chunk_size=%lu",
+                    (unsigned long)max_chunk_size);
+            return false;
+        }
+    }
+
+    roc_panic_if(period_.in_period == 0 || period_.out_period == 0);
+
+    // Overlap should be long enough for every chunk to produce output up to the
+    // point where the next chunk finishes warm-up, with a margin of two frames
+    // for output lagging behind input.
+    const size_t in_rate = config_.input_sample_spec.sample_rate();
+    const size_t out_rate = config_.output_sample_spec.sample_rate();
+
+    const uint64_t warmup_input =
+        ((uint64_t)(period_.warmup + out_frame_size_ * 2) * in_rate + out_rate - 1)
+        / out_rate;
+
+    overlap_size_ =
+        round_up(period_.lookahead + (size_t)warmup_input + in_frame_size_ * 2,
+                 in_frame_size_);
+
+    // Chunks should start at multiples of the resampling period, and only two
+    // of them may overlap at the same time.
+    chunk_size_ = std::max(
+        config_.input_sample_spec.ns_2_samples_per_chan(parallel_config.chunk_length),
+        overlap_size_ * 2);
+    chunk_size_ = round_up(chunk_size_, period_.in_period);
+
+    out_chunk_size_ = chunk_size_ / period_.in_period * period_.out_period;
+
+    return true;
+}
+
+bool ParallelConverter::open_job_() {
+    if (open_index_ - emit_index_ == n_jobs_) {
+        // All slots are busy, wait until the oldest chunk is converted.
+        emit_job_(true);
+    }
+
+    Job& job = job_(open_index_);
+
+    roc_panic_if(job.state != JobFree);
+
+    job.index = open_index_;
+    job.last = false;
+    job.failed = false;
+
+    if (!job.output.resize(0) || !job.input.resize(0)
+        || !job.input.grow((chunk_size_ + overlap_size_) * in_num_ch_)) {
+        roc_log(LogError, "parallel converter: can't allocate chunk buffer");
+        return false;
+    }
+
+    job.state = JobFilling;
+    open_index_++;
+
+    return true;
+}
+
+void ParallelConverter::append_input_(const audio::sample_t* samples,
+                                      size_t n_samples) {
+    for (size_t index = submit_index_; index < open_index_; index++) {
+        Job& job = job_(index);
+
+        const size_t old_size = job.input.size();
+        const size_t new_size = old_size + n_samples * in_num_ch_;
+
+        // Doesn't allocate, capacity is reserved in open_job_().
+        if (!job.input.resize(new_size)) {
+            roc_panic("parallel converter: can't resize chunk buffer");
+        }
+
+        memcpy(job.input.data() + old_size, samples,
+               n_samples * in_num_ch_ * sizeof(audio::sample_t));
+    }
+}
+
+void ParallelConverter::submit_job_(bool last) {
+    Job& job = job_(submit_index_);
+
+    core::Mutex::Lock lock(mutex_);
+
+    job.last = last;
+    job.state = JobPending;
+    submit_index_++;
+
+    work_cond_.signal();
+}
+
+bool ParallelConverter::emit_job_(bool wait) {
+    if (emit_index_ == submit_index_) {
+        return false;
+    }
+
+    Job& job = job_(emit_index_);
+
+    {
+        core::Mutex::Lock lock(mutex_);
+
+        if (!wait && job.state != JobDone) {
+            return false;
+        }
+
+        while (job.state != JobDone) {
+            done_cond_.wait();
+        }
+    }
+
+    if (!failed_ && !write_output_(job)) {
+        failed_ = true;
+    }
+
+    job.state = JobFree;
+    emit_index_++;
+
+    return true;
+}
+
+bool ParallelConverter::write_output_(Job& job) {
+    if (job.failed) {
+        roc_log(LogError, "parallel converter: can't convert chunk: index=%lu",
+                (unsigned long)job.index);
+        return false;
+    }
+
+    // Position of the chunk output in the whole output stream.
+    const size_t job_pos = job.index * out_chunk_size_;
+    const size_t job_size = job.output.size() / out_num_ch_;
+
+    // First chunk is converted from the very beginning, as in sequential mode.
+    // Other chunks drop warm-up samples, which are taken from previous chunk.
+    const size_t begin = job.index == 0 ? 0 : period_.warmup;
+    size_t end = period_.warmup + out_chunk_size_;
+
+    if (job.last) {
+        // Sequential converter writes only complete output frames.
+        size_t total_size = job_pos + job_size;
+        if (quantized_output_) {
+            total_size = total_size / out_frame_size_ * out_frame_size_;
+        }
+        end = total_size - job_pos;
+    }
+
+    if (end < begin || end > job_size) {
+        roc_log(LogError,
+                "parallel converter: chunk produced unexpected number of samples:"
+                " index=%lu begin=%lu end=%lu produced=%lu",
+                (unsigned long)job.index, (unsigned long)begin, (unsigned long)end,
+                (unsigned long)job_size);
+        return false;
+    }
+
+    audio::sample_t* samples = job.output.data() + begin * out_num_ch_;
+    size_t n_samples = (end - begin) * out_num_ch_;
+
+    while (n_samples != 0) {
+        const size_t n_write = std::min(n_samples, out_frame_size_ * out_num_ch_);
+
+        audio::Frame frame(samples, n_write);
+        output_writer_->write(frame);
+
+        samples += n_write;
+        n_samples -= n_write;
+    }
+
+    return true;
+}
+
+void ParallelConverter::worker_loop_() {
+    mutex_.lock();
+
+    for (;;) {
+        while (!stop_ && run_index_ >= submit_index_) {
+            work_cond_.wait();
+        }
+
+        if (stop_) {
+            break;
+        }
+
+        Job& job = job_(run_index_++);
+
+        mutex_.unlock();
+        process_job_(job);
+        mutex_.lock();
+
+        job.state = JobDone;
+        done_cond_.broadcast();
+    }
+
+    mutex_.unlock();
+}
+
+void ParallelConverter::process_job_(Job& job) {
+    ConverterSink converter(config_, &job, buffer_factory_, allocator_);
+    if (!converter.valid()) {
+        job.failed = true;
+        return;
+    }
+
+    const size_t frame_size = in_frame_size_ * in_num_ch_;
+
+    for (size_t pos = 0; pos < job.input.size(); pos += frame_size) {
+        audio::Frame frame(job.input.data() + pos,
+                           std::min(frame_size, job.input.size() - pos));
+        converter.write(frame);
+    }
+
+    converter.flush();
+}
+
+ParallelConverter::Job& ParallelConverter::job_(size_t index) {
+    return *jobs_[index % n_jobs_];
+}
+
+size_t ParallelConverter::job_start_(size_t index) const {
+    return index * chunk_size_;
+}
+
+size_t ParallelConverter::job_end_(size_t index) const {
+    return index * chunk_size_ + chunk_size_ + overlap_size_;
+}
+
+} // namespace pipeline
+} // namespace roc
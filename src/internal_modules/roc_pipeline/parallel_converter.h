@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+//! @file roc_pipeline/parallel_converter.h
+//! @brief Parallel converter sink pipeline.
+
+#ifndef ROC_PIPELINE_PARALLEL_CONVERTER_H_
+#define ROC_PIPELINE_PARALLEL_CONVERTER_H_
+
+#include "roc_audio/iframe_writer.h"
+#include "roc_audio/iresampler.h"
+#include "roc_audio/null_writer.h"
+#include "roc_audio/sample.h"
+#include "roc_core/array.h"
+#include "roc_core/buffer_factory.h"
+#include "roc_core/cond.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/mutex.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/optional.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/thread.h"
+#include "roc_pipeline/config.h"
+#include "roc_sndio/isink.h"
+
+namespace roc {
+namespace pipeline {
+
+//! Parallel converter sink pipeline.
+//!
+//! Splits input stream into chunks and converts every chunk on a worker
+//! thread using its own ConverterSink. Outputs of the chunks are then
+//! written in order, so that the result is the same as if the whole stream
+//! was written to a single ConverterSink.
+//!
+//! To make it possible, chunks start at multiples of the resampling period,
+//! where resampler returns to the same phase, and every chunk also includes
+//! some input from the beginning of the next chunk (overlap). When chunk
+//! output is stitched, the first output samples of every chunk except the
+//! first one, which were affected by resampler warm-up, are discarded, and
+//! the corresponding samples are taken from the end of the previous chunk.
+//!
+//! If the resampling period is too long, parallel conversion is not possible
+//! and valid() returns false.
+//!
+//! @remarks
+//!  - input: frames
+//!  - output: frames
+class ParallelConverter : public sndio::ISink, public core::NonCopyable<> {
+public:
+    //! Maximum number of worker threads.
+    enum { MaxWorkers = 32 };
+
+    //! Initialize.
+    ParallelConverter(const ConverterConfig& config,
+                      const ParallelConverterConfig& parallel_config,
+                      audio::IFrameWriter* output_writer,
+                      core::BufferFactory<audio::sample_t>& buffer_factory,
+                      core::IAllocator& allocator);
+
+    //! Stop and join worker threads.
+    ~ParallelConverter();
+
+    //! Check if the pipeline was successfully constructed.
+    bool valid() const;
+
+    //! Get number of worker threads.
+    size_t num_workers() const;
+
+    //! Get duration of input chunks, in samples per channel.
+    size_t chunk_size() const;
+
+    //! Get device type.
+    virtual sndio::DeviceType type() const;
+
+    //! Get device state.
+    virtual sndio::DeviceState state() const;
+
+    //! Pause reading.
+    virtual void pause();
+
+    //! Resume paused reading.
+    virtual bool resume();
+
+    //! Restart reading from the beginning.
+    virtual bool restart();
+
+    //! Get sample specification of the sink.
+    virtual audio::SampleSpec sample_spec() const;
+
+    //! Get latency of the sink.
+    virtual core::nanoseconds_t latency() const;
+
+    //! Check if the sink has own clock.
+    virtual bool has_clock() const;
+
+    //! Write audio frame.
+    //! @remarks
+    //!  Input is accumulated until a chunk is complete. Complete chunks are
+    //!  handed to workers, and outputs of converted chunks are written to
+    //!  the output writer. Blocks if all chunk slots are busy.
+    virtual void write(audio::Frame& frame);
+
+    //! Convert remaining input and write all pending output.
+    //! @remarks
+    //!  Should be called after the last frame was written.
+    //! @returns
+    //!  false if conversion failed.
+    bool flush();
+
+private:
+    enum JobState { JobFree, JobFilling, JobPending, JobDone };
+
+    enum { MaxJobs = MaxWorkers + 2 };
+
+    struct Job : public audio::IFrameWriter {
+        core::Array<audio::sample_t> input;
+        core::Array<audio::sample_t> output;
+
+        size_t index;
+        JobState state;
+        bool last;
+        bool failed;
+
+        Job(core::IAllocator& allocator)
+            : input(allocator)
+            , output(allocator)
+            , index(0)
+            , state(JobFree)
+            , last(false)
+            , failed(false) {
+        }
+
+        // Collects output of the job's converter.
+        virtual void write(audio::Frame& frame);
+    };
+
+    class Worker : public core::Thread {
+    public:
+        Worker(ParallelConverter& converter);
+
+    private:
+        virtual void run();
+
+        ParallelConverter& converter_;
+    };
+
+    bool init_chunks_(const ParallelConverterConfig& parallel_config);
+
+    bool open_job_();
+    void append_input_(const audio::sample_t* samples, size_t n_samples);
+    void submit_job_(bool last);
+
+    bool emit_job_(bool wait);
+    bool write_output_(Job& job);
+
+    void worker_loop_();
+    void process_job_(Job& job);
+
+    Job& job_(size_t index);
+    size_t job_start_(size_t index) const;
+    size_t job_end_(size_t index) const;
+
+    const ConverterConfig config_;
+
+    audio::NullWriter null_writer_;
+    audio::IFrameWriter* output_writer_;
+
+    core::BufferFactory<audio::sample_t>& buffer_factory_;
+    core::IAllocator& allocator_;
+
+    size_t in_num_ch_;
+    size_t out_num_ch_;
+    size_t in_frame_size_;
+    size_t out_frame_size_;
+    bool quantized_output_;
+
+    audio::ResamplerPeriod period_;
+    size_t chunk_size_;
+    size_t overlap_size_;
+    size_t out_chunk_size_;
+
+    core::Optional<Job> jobs_[MaxJobs];
+    size_t n_jobs_;
+
+    // input position, in samples per channel
+    size_t input_pos_;
+
+    // first job that wasn't written to output yet
+    size_t emit_index_;
+    // first job that wasn't handed to workers yet
+    size_t submit_index_;
+    // first job that wasn't taken by workers yet
+    size_t run_index_;
+    // first job that wasn't opened yet
+    size_t open_index_;
+
+    core::Mutex mutex_;
+    core::Cond work_cond_;
+    core::Cond done_cond_;
+    bool stop_;
+
+    core::Optional<Worker> workers_[MaxWorkers];
+    size_t n_workers_;
+
+    bool failed_;
+    bool valid_;
+};
+
+} // namespace pipeline
+} // namespace roc
+
+#endif // ROC_PIPELINE_PARALLEL_CONVERTER_H_
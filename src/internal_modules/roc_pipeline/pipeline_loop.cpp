@@ -37,7 +37,8 @@ PipelineLoop::PipelineLoop(IPipelineTaskScheduler& scheduler,
     , subframe_tasks_deadline_(0)
     , samples_processed_(0)
     , enough_samples_to_process_tasks_(false)
-    , rate_limiter_(StatsReportInterval) {
+    , rate_limiter_(StatsReportInterval)
+    , published_stats_(Stats()) {
 }
 
 PipelineLoop::~PipelineLoop() {
@@ -51,6 +52,10 @@ const PipelineLoop::Stats& PipelineLoop::get_stats_ref() const {
     return stats_;
 }
 
+PipelineLoop::Stats PipelineLoop::get_stats() const {
+    return published_stats_.wait_load();
+}
+
 size_t PipelineLoop::num_pending_tasks() const {
     return (size_t)pending_tasks_;
 }
@@ -201,12 +206,17 @@ bool PipelineLoop::process_subframes_and_tasks(audio::Frame& frame) {
 bool PipelineLoop::process_subframes_and_tasks_simple_(audio::Frame& frame) {
     ++pending_frames_;
 
+    const core::nanoseconds_t frame_start_time = timestamp_imp();
+
     cancel_async_task_processing_();
 
     pipeline_mutex_.lock();
 
     const bool frame_res = process_subframe_imp(frame);
 
+    count_frame_(frame_start_time, frame.num_samples());
+    report_stats_();
+
     pipeline_mutex_.unlock();
 
     if (--pending_frames_ == 0 && pending_tasks_ != 0) {
@@ -259,6 +269,7 @@ bool PipelineLoop::process_subframes_and_tasks_precise_(audio::Frame& frame) {
         }
     }
 
+    count_frame_(frame_start_time, frame.num_samples());
     report_stats_();
 
     pipeline_mutex_.unlock();
@@ -414,31 +425,60 @@ bool PipelineLoop::interframe_task_processing_allowed_(
         || now >= (next_frame_deadline + no_task_proc_half_interval_);
 }
 
-void PipelineLoop::report_stats_() {
-    if (!rate_limiter_.would_allow()) {
-        return;
-    }
+void PipelineLoop::count_frame_(core::nanoseconds_t frame_start_time,
+                                size_t frame_size) {
+    const core::nanoseconds_t frame_duration =
+        sample_spec_.samples_overall_2_ns(frame_size);
 
-    if (!scheduler_mutex_.try_lock()) {
-        return;
+    stats_.frames_processed++;
+
+    if (timestamp_imp() - frame_start_time > frame_duration) {
+        stats_.frame_deadline_misses++;
     }
+}
 
-    if (rate_limiter_.allow()) {
-        roc_log(LogDebug,
+void PipelineLoop::report_stats_() {
+    // Task and frame counters are updated under pipeline mutex, which is held
+    // by caller, so they're published after every frame. Scheduler counters are
+    // updated under scheduler mutex, so they're refreshed only when stats are
+    // reported, to avoid contention with scheduler on every frame.
+    published_.task_processed_total = stats_.task_processed_total;
+    published_.task_processed_in_place = stats_.task_processed_in_place;
+    published_.task_processed_in_frame = stats_.task_processed_in_frame;
+    published_.preemptions = stats_.preemptions;
+    published_.frames_processed = stats_.frames_processed;
+    published_.frame_deadline_misses = stats_.frame_deadline_misses;
+
+    if (rate_limiter_.would_allow() && scheduler_mutex_.try_lock()) {
+        published_.scheduler_calls = stats_.scheduler_calls;
+        published_.scheduler_cancellations = stats_.scheduler_cancellations;
+
+        scheduler_mutex_.unlock();
+
+        if (rate_limiter_.allow()) {
+            roc_log(
+                LogDebug,
                 "pipeline loop:"
                 " tasks=%lu in_place=%.2f in_frame=%.2f preempts=%lu sched=%lu/%lu",
-                (unsigned long)stats_.task_processed_total,
-                stats_.task_processed_total
-                    ? double(stats_.task_processed_in_place) / stats_.task_processed_total
+                (unsigned long)published_.task_processed_total,
+                published_.task_processed_total
+                    ? double(published_.task_processed_in_place)
+                        / published_.task_processed_total
                     : 0.,
-                stats_.task_processed_total
-                    ? double(stats_.task_processed_in_frame) / stats_.task_processed_total
+                published_.task_processed_total
+                    ? double(published_.task_processed_in_frame)
+                        / published_.task_processed_total
                     : 0.,
-                (unsigned long)stats_.preemptions, (unsigned long)stats_.scheduler_calls,
-                (unsigned long)stats_.scheduler_cancellations);
+                (unsigned long)published_.preemptions,
+                (unsigned long)published_.scheduler_calls,
+                (unsigned long)published_.scheduler_cancellations);
+            roc_log(LogDebug, "pipeline loop: frames=%lu deadline_misses=%lu",
+                    (unsigned long)published_.frames_processed,
+                    (unsigned long)published_.frame_deadline_misses);
+        }
     }
 
-    scheduler_mutex_.unlock();
+    published_stats_.exclusive_store(published_);
 }
 
 } // namespace pipeline
@@ -202,7 +202,6 @@ public:
     //! Process some of the enqueued tasks, if any.
     void process_tasks();
 
-protected:
     //! Task processing statistics.
     struct Stats {
         //! Total number of tasks processed.
@@ -223,16 +222,31 @@ protected:
         //! Number of time when cancel_task_processing() was called.
         uint64_t scheduler_cancellations;
 
+        //! Total number of frames processed.
+        uint64_t frames_processed;
+
+        //! Number of frames which processing took longer than frame duration.
+        uint64_t frame_deadline_misses;
+
         Stats()
             : task_processed_total(0)
             , task_processed_in_place(0)
             , task_processed_in_frame(0)
             , preemptions(0)
             , scheduler_calls(0)
-            , scheduler_cancellations(0) {
+            , scheduler_cancellations(0)
+            , frames_processed(0)
+            , frame_deadline_misses(0) {
         }
     };
 
+    //! Get snapshot of task processing statistics.
+    //! @remarks
+    //!  Snapshot is published after every frame. Scheduler counters are
+    //!  refreshed less frequently. Lock-free, can be called from any thread.
+    Stats get_stats() const;
+
+protected:
     //! Initialization.
     PipelineLoop(IPipelineTaskScheduler& scheduler,
                  const TaskConfig& config,
@@ -285,6 +299,7 @@ private:
     bool
     interframe_task_processing_allowed_(core::nanoseconds_t next_frame_deadline) const;
 
+    void count_frame_(core::nanoseconds_t frame_start_time, size_t frame_size);
     void report_stats_();
 
     // configuration
@@ -333,6 +348,10 @@ private:
     // task processing statistics
     core::RateLimiter rate_limiter_;
     Stats stats_;
+
+    // task processing statistics published for concurrent readers
+    Stats published_;
+    core::Seqlock<Stats> published_stats_;
 };
 
 } // namespace pipeline
@@ -16,15 +16,19 @@
 namespace roc {
 namespace pipeline {
 
-ReceiverEndpoint::ReceiverEndpoint(address::Protocol proto,
+ReceiverEndpoint::ReceiverEndpoint(address::Interface iface,
+                                   address::Protocol proto,
                                    ReceiverState& receiver_state,
                                    ReceiverSessionGroup& session_group,
                                    const rtp::FormatMap& format_map,
+                                   packet::TraceWriter* trace_writer,
                                    core::IAllocator& allocator)
     : RefCounted(allocator)
+    , iface_(iface)
     , proto_(proto)
     , receiver_state_(receiver_state)
     , session_group_(session_group)
+    , trace_writer_(trace_writer)
     , parser_(NULL) {
     packet::IParser* parser = NULL;
 
@@ -32,6 +36,7 @@ ReceiverEndpoint::ReceiverEndpoint(address::Protocol proto,
     case address::Proto_RTP:
     case address::Proto_RTP_LDPC_Source:
     case address::Proto_RTP_RS8M_Source:
+    case address::Proto_RTP_RLC_Source:
         rtp_parser_.reset(new (rtp_parser_) rtp::Parser(format_map, NULL));
         if (!rtp_parser_) {
             return;
@@ -83,6 +88,26 @@ ReceiverEndpoint::ReceiverEndpoint(address::Protocol proto,
         }
         parser = fec_parser_.get();
         break;
+    case address::Proto_RTP_RLC_Source:
+        fec_parser_.reset(
+            new (allocator)
+                fec::Parser<fec::RLC_Source_PayloadID, fec::Source, fec::Footer>(parser),
+            allocator);
+        if (!fec_parser_) {
+            return;
+        }
+        parser = fec_parser_.get();
+        break;
+    case address::Proto_RLC_Repair:
+        fec_parser_.reset(
+            new (allocator)
+                fec::Parser<fec::RLC_Repair_PayloadID, fec::Repair, fec::Header>(parser),
+            allocator);
+        if (!fec_parser_) {
+            return;
+        }
+        parser = fec_parser_.get();
+        break;
     default:
         break;
     }
@@ -144,10 +169,24 @@ void ReceiverEndpoint::write(const packet::PacketPtr& packet) {
         roc_panic("receiver endpoint: packet is null");
     }
 
+    if (trace_writer_) {
+        trace_packet_(*packet);
+    }
+
     receiver_state_.add_pending_packets(+1);
 
     queue_.push_back(*packet);
 }
 
+void ReceiverEndpoint::trace_packet_(const packet::Packet& packet) {
+    const packet::UDP* udp = packet.udp();
+
+    if (!trace_writer_->write(udp ? udp->receive_timestamp : 0, iface_,
+                              udp ? udp->src_addr : address::SocketAddr(),
+                              packet.data())) {
+        roc_log(LogDebug, "receiver endpoint: can't write packet to trace");
+    }
+}
+
 } // namespace pipeline
 } // namespace roc
@@ -21,6 +21,7 @@
 #include "roc_core/scoped_ptr.h"
 #include "roc_packet/iparser.h"
 #include "roc_packet/iwriter.h"
+#include "roc_packet/trace_writer.h"
 #include "roc_pipeline/config.h"
 #include "roc_pipeline/receiver_session_group.h"
 #include "roc_pipeline/receiver_state.h"
@@ -44,10 +45,14 @@ class ReceiverEndpoint
 
 public:
     //! Initialize.
-    ReceiverEndpoint(address::Protocol proto,
+    //! @remarks
+    //!  If @p trace_writer is not NULL, every written packet is recorded to it.
+    ReceiverEndpoint(address::Interface iface,
+                     address::Protocol proto,
                      ReceiverState& receiver_state,
                      ReceiverSessionGroup& session_group,
                      const rtp::FormatMap& format_map,
+                     packet::TraceWriter* trace_writer,
                      core::IAllocator& allocator);
 
     //! Check if the port pipeline was succefully constructed.
@@ -69,11 +74,16 @@ public:
 private:
     virtual void write(const packet::PacketPtr& packet);
 
+    void trace_packet_(const packet::Packet& packet);
+
+    const address::Interface iface_;
     const address::Protocol proto_;
 
     ReceiverState& receiver_state_;
     ReceiverSessionGroup& session_group_;
 
+    packet::TraceWriter* trace_writer_;
+
     packet::IParser* parser_;
 
     core::Optional<rtp::Parser> rtp_parser_;
@@ -19,7 +19,10 @@ ReceiverLoop::Task::Task()
     , slot_(NULL)
     , iface_(address::Iface_Invalid)
     , proto_(address::Proto_None)
-    , writer_(NULL) {
+    , writer_(NULL)
+    , sess_metrics_func_(NULL)
+    , sess_metrics_size_(NULL)
+    , sess_metrics_arg_(NULL) {
 }
 
 ReceiverLoop::Tasks::CreateSlot::CreateSlot() {
@@ -64,6 +67,23 @@ ReceiverLoop::Tasks::DeleteEndpoint::DeleteEndpoint(SlotHandle slot,
     iface_ = iface;
 }
 
+ReceiverLoop::Tasks::QuerySlot::QuerySlot(SlotHandle slot,
+                                          ReceiverSessionMetricsFunc sess_metrics_func,
+                                          size_t* sess_metrics_size,
+                                          void* sess_metrics_arg) {
+    func_ = &ReceiverLoop::task_query_slot_;
+    if (!slot) {
+        roc_panic("receiver source: slot handle is null");
+    }
+    if (!sess_metrics_size) {
+        roc_panic("receiver source: metrics size is null");
+    }
+    slot_ = (ReceiverSlot*)slot;
+    sess_metrics_func_ = sess_metrics_func;
+    sess_metrics_size_ = sess_metrics_size;
+    sess_metrics_arg_ = sess_metrics_arg;
+}
+
 ReceiverLoop::ReceiverLoop(IPipelineTaskScheduler& scheduler,
                            const ReceiverConfig& config,
                            const rtp::FormatMap& format_map,
@@ -105,6 +125,16 @@ sndio::ISource& ReceiverLoop::source() {
     return *this;
 }
 
+ReceiverMetrics ReceiverLoop::get_metrics() const {
+    roc_panic_if(!valid());
+
+    ReceiverMetrics metrics;
+    metrics.num_sessions = source_.num_sessions();
+    metrics.pipeline = get_stats();
+
+    return metrics;
+}
+
 sndio::DeviceType ReceiverLoop::type() const {
     roc_panic_if(!valid());
 
@@ -231,5 +261,11 @@ bool ReceiverLoop::task_delete_endpoint_(Task& task) {
     return true;
 }
 
+bool ReceiverLoop::task_query_slot_(Task& task) {
+    task.slot_->get_metrics(task.sess_metrics_func_, task.sess_metrics_size_,
+                            task.sess_metrics_arg_);
+    return true;
+}
+
 } // namespace pipeline
 } // namespace roc
@@ -19,6 +19,7 @@
 #include "roc_core/stddefs.h"
 #include "roc_packet/packet_factory.h"
 #include "roc_pipeline/config.h"
+#include "roc_pipeline/metrics.h"
 #include "roc_pipeline/pipeline_loop.h"
 #include "roc_pipeline/receiver_source.h"
 #include "roc_sndio/isource.h"
@@ -61,6 +62,10 @@ public:
         address::Interface iface_; //!< Interface.
         address::Protocol proto_;  //!< Protocol.
         packet::IWriter* writer_;  //!< Packet writer.
+
+        ReceiverSessionMetricsFunc sess_metrics_func_; //!< Session metrics callback.
+        size_t* sess_metrics_size_;                    //!< Session metrics count.
+        void* sess_metrics_arg_;                       //!< Session metrics argument.
     };
 
     //! Subclasses for specific tasks.
@@ -99,6 +104,21 @@ public:
             //! Set task parameters.
             DeleteEndpoint(SlotHandle slot, address::Interface iface);
         };
+
+        //! Get metrics of sessions of the slot.
+        class QuerySlot : public Task {
+        public:
+            //! Set task parameters.
+            //! @remarks
+            //!  Invokes @p sess_metrics_func for up to @p *sess_metrics_size
+            //!  sessions and sets @p *sess_metrics_size to the number of sessions.
+            //!  Session metrics are written directly to caller's buffer, without
+            //!  intermediate allocations.
+            QuerySlot(SlotHandle slot,
+                      ReceiverSessionMetricsFunc sess_metrics_func,
+                      size_t* sess_metrics_size,
+                      void* sess_metrics_arg);
+        };
     };
 
     //! Initialize.
@@ -118,6 +138,11 @@ public:
     //!  Samples received from remote peers become available in this source.
     sndio::ISource& source();
 
+    //! Get receiver metrics.
+    //! @remarks
+    //!  Lock-free, can be called from any thread.
+    ReceiverMetrics get_metrics() const;
+
 private:
     // Methods of sndio::ISource
     virtual sndio::DeviceType type() const;
@@ -140,6 +165,7 @@ private:
     bool task_create_slot_(Task& task);
     bool task_create_endpoint_(Task& task);
     bool task_delete_endpoint_(Task& task);
+    bool task_query_slot_(Task& task);
 
     ReceiverSource source_;
 
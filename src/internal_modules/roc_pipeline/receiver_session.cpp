@@ -10,11 +10,19 @@
 #include "roc_audio/resampler_map.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/time.h"
 #include "roc_fec/codec_map.h"
 
 namespace roc {
 namespace pipeline {
 
+namespace {
+
+// smoothing factor of frame processing time average
+const double ProcessingTimeAlpha = 1. / 64;
+
+} // namespace
+
 ReceiverSession::ReceiverSession(
     const ReceiverSessionConfig& session_config,
     const ReceiverCommonConfig& common_config,
@@ -26,7 +34,12 @@ ReceiverSession::ReceiverSession(
     core::IAllocator& allocator)
     : RefCounted(allocator)
     , src_address_(src_address)
-    , audio_reader_(NULL) {
+    , audio_reader_(NULL)
+    , timing_reader_(*this)
+    , frame_processing_time_(0)
+    , metrics_(ReceiverSessionMetrics())
+    , report_received_(0)
+    , report_lost_(0) {
     const rtp::Format* format = format_map.format(session_config.payload_type);
     if (!format) {
         return;
@@ -37,6 +50,12 @@ ReceiverSession::ReceiverSession(
         return;
     }
 
+    jitter_meter_.reset(new (jitter_meter_)
+                            packet::JitterMeter(*queue_router_, format->sample_spec));
+    if (!jitter_meter_) {
+        return;
+    }
+
     source_queue_.reset(new (source_queue_) packet::SortedQueue(0));
     if (!source_queue_) {
         return;
@@ -69,8 +88,35 @@ ReceiverSession::ReceiverSession(
     }
     preader = populator_.get();
 
+    // With fast start, playback begins when start latency is buffered, and
+    // then LatencyMonitor grows the queue up to target latency.
+    core::nanoseconds_t initial_latency =
+        session_config.latency_monitor.start_latency > 0
+        ? std::max(session_config.latency_monitor.start_latency,
+                   session_config.latency_monitor.min_latency)
+        : session_config.target_latency;
+
+    // With FEC block interleaving, packets of a block are spread over the
+    // whole interleaving group, so the group should be fully queued before
+    // a lost packet reaches the FEC reader.
+    if (session_config.fec_interleaving_latency > 0) {
+        if (session_config.target_latency <= session_config.fec_interleaving_latency) {
+            roc_log(LogError,
+                    "receiver session: target latency should exceed fec interleaving"
+                    " latency: target_latency=%.3fms interleaving_latency=%.3fms",
+                    (double)session_config.target_latency / core::Millisecond,
+                    (double)session_config.fec_interleaving_latency
+                        / core::Millisecond);
+            return;
+        }
+
+        if (initial_latency < session_config.fec_interleaving_latency) {
+            initial_latency = session_config.fec_interleaving_latency;
+        }
+    }
+
     delayed_reader_.reset(new (delayed_reader_) packet::DelayedReader(
-        *preader, session_config.target_latency, format->sample_spec));
+        *preader, initial_latency, format->sample_spec));
     if (!delayed_reader_) {
         return;
     }
@@ -85,26 +131,37 @@ ReceiverSession::ReceiverSession(
             return;
         }
 
-        fec_decoder_.reset(
-            fec::CodecMap::instance().new_decoder(session_config.fec_decoder,
-                                                  byte_buffer_factory, allocator),
-            allocator);
-        if (!fec_decoder_) {
-            return;
-        }
-
         fec_parser_.reset(new (fec_parser_) rtp::Parser(format_map, NULL));
         if (!fec_parser_) {
             return;
         }
 
-        fec_reader_.reset(new (fec_reader_) fec::Reader(
-            session_config.fec_reader, session_config.fec_decoder.scheme, *fec_decoder_,
-            *preader, *repair_queue_, *fec_parser_, packet_factory, allocator));
-        if (!fec_reader_ || !fec_reader_->valid()) {
-            return;
+        if (session_config.fec_decoder.scheme == packet::FEC_RLC) {
+            rlc_reader_.reset(new (rlc_reader_) fec::RlcReader(
+                session_config.fec_decoder.scheme, *preader, *repair_queue_,
+                *fec_parser_, packet_factory, byte_buffer_factory, allocator));
+            if (!rlc_reader_ || !rlc_reader_->valid()) {
+                return;
+            }
+            preader = rlc_reader_.get();
+        } else {
+            fec_decoder_.reset(
+                fec::CodecMap::instance().new_decoder(session_config.fec_decoder,
+                                                      byte_buffer_factory, allocator),
+                allocator);
+            if (!fec_decoder_) {
+                return;
+            }
+
+            fec_reader_.reset(new (fec_reader_) fec::Reader(
+                session_config.fec_reader, session_config.fec_decoder.scheme,
+                *fec_decoder_, *preader, *repair_queue_, *fec_parser_, packet_factory,
+                allocator));
+            if (!fec_reader_ || !fec_reader_->valid()) {
+                return;
+            }
+            preader = fec_reader_.get();
         }
-        preader = fec_reader_.get();
 
         fec_validator_.reset(new (fec_validator_) rtp::Validator(
             *preader, session_config.rtp_validator, format->sample_spec));
@@ -114,6 +171,12 @@ ReceiverSession::ReceiverSession(
         preader = fec_validator_.get();
     }
 
+    delay_meter_.reset(new (delay_meter_) packet::QueueingDelayMeter(*preader));
+    if (!delay_meter_) {
+        return;
+    }
+    preader = delay_meter_.get();
+
     depacketizer_.reset(new (depacketizer_) audio::Depacketizer(
         *preader, *payload_decoder_, format->sample_spec, common_config.beeping));
     if (!depacketizer_) {
@@ -190,7 +253,8 @@ ReceiverSession::ReceiverSession(
     }
 
     latency_monitor_.reset(new (latency_monitor_) audio::LatencyMonitor(
-        *source_queue_, *depacketizer_, resampler_reader_.get(),
+        *source_queue_, *depacketizer_, resampler_reader_.get(), jitter_meter_.get(),
+        delay_meter_.get(),
         session_config.latency_monitor, session_config.target_latency,
         format->sample_spec, common_config.output_sample_spec,
         session_config.freq_estimator_config));
@@ -217,7 +281,7 @@ bool ReceiverSession::handle(const packet::PacketPtr& packet) {
         return false;
     }
 
-    queue_router_->write(packet);
+    jitter_meter_->write(packet);
     return true;
 }
 
@@ -236,6 +300,8 @@ bool ReceiverSession::advance(packet::timestamp_t timestamp) {
         }
     }
 
+    publish_metrics_();
+
     return true;
 }
 
@@ -249,7 +315,36 @@ bool ReceiverSession::reclock(packet::ntp_timestamp_t) {
 audio::IFrameReader& ReceiverSession::reader() {
     roc_panic_if(!valid());
 
-    return *audio_reader_;
+    return timing_reader_;
+}
+
+ReceiverSessionMetrics ReceiverSession::get_metrics() const {
+    return metrics_.wait_load();
+}
+
+rtcp::ReceptionMetrics ReceiverSession::get_reception_metrics() {
+    roc_panic_if(!valid());
+
+    const uint64_t n_received = jitter_meter_->n_received_packets();
+    const uint64_t n_lost = jitter_meter_->n_lost_packets();
+
+    const uint64_t interval_received = n_received - report_received_;
+    const uint64_t interval_lost = n_lost > report_lost_ ? n_lost - report_lost_ : 0;
+    const uint64_t interval_expected = interval_received + interval_lost;
+
+    report_received_ = n_received;
+    report_lost_ = n_lost;
+
+    rtcp::ReceptionMetrics metrics;
+    metrics.ssrc = jitter_meter_->source();
+    metrics.cum_loss = (int64_t)n_lost;
+    metrics.ext_last_seqnum = (uint32_t)jitter_meter_->ext_max_seqnum();
+
+    if (interval_expected != 0) {
+        metrics.fract_loss = float(interval_lost) / float(interval_expected);
+    }
+
+    return metrics;
 }
 
 void ReceiverSession::add_sending_metrics(const rtcp::SendingMetrics& metrics) {
@@ -262,5 +357,54 @@ void ReceiverSession::add_link_metrics(const rtcp::LinkMetrics& metrics) {
     (void)metrics;
 }
 
+ReceiverSession::TimingReader::TimingReader(ReceiverSession& session)
+    : session_(session) {
+}
+
+bool ReceiverSession::TimingReader::read(audio::Frame& frame) {
+    const core::nanoseconds_t start_time = core::timestamp(core::ClockMonotonic);
+
+    const bool ret = session_.audio_reader_->read(frame);
+
+    const double processing_time =
+        (double)(core::timestamp(core::ClockMonotonic) - start_time);
+
+    if (session_.frame_processing_time_ == 0) {
+        session_.frame_processing_time_ = processing_time;
+    } else {
+        session_.frame_processing_time_ +=
+            (processing_time - session_.frame_processing_time_) * ProcessingTimeAlpha;
+    }
+
+    return ret;
+}
+
+void ReceiverSession::publish_metrics_() {
+    ReceiverSessionMetrics metrics;
+
+    metrics.latency = latency_monitor_->latency();
+    metrics.target_latency = latency_monitor_->target_latency();
+    metrics.scaling = latency_monitor_->scaling();
+    metrics.time_to_first_audio = latency_monitor_->time_to_first_audio();
+
+    metrics.jitter = jitter_meter_->jitter();
+    metrics.packets_received = jitter_meter_->n_received_packets();
+    metrics.packets_lost = jitter_meter_->n_lost_packets();
+
+    metrics.packets_late = depacketizer_->n_dropped_packets();
+
+    if (fec_reader_) {
+        metrics.packets_recovered = fec_reader_->n_restored_packets();
+    }
+    if (rlc_reader_) {
+        metrics.packets_recovered = rlc_reader_->n_restored_packets();
+    }
+
+    metrics.frame_processing_time = (core::nanoseconds_t)frame_processing_time_;
+
+    // Only pipeline thread writes metrics, so there are no concurrent writers.
+    metrics_.exclusive_store(metrics);
+}
+
 } // namespace pipeline
 } // namespace roc
@@ -23,21 +23,28 @@
 #include "roc_audio/resampler_reader.h"
 #include "roc_audio/watchdog.h"
 #include "roc_core/buffer_factory.h"
+#include "roc_core/hashmap_node.h"
+#include "roc_core/hashsum.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/list_node.h"
 #include "roc_core/optional.h"
 #include "roc_core/ref_counted.h"
 #include "roc_core/scoped_ptr.h"
+#include "roc_core/seqlock.h"
 #include "roc_fec/iblock_decoder.h"
 #include "roc_fec/reader.h"
+#include "roc_fec/rlc_reader.h"
 #include "roc_packet/delayed_reader.h"
 #include "roc_packet/iparser.h"
 #include "roc_packet/ireader.h"
+#include "roc_packet/jitter_meter.h"
 #include "roc_packet/packet.h"
 #include "roc_packet/packet_factory.h"
+#include "roc_packet/queueing_delay_meter.h"
 #include "roc_packet/router.h"
 #include "roc_packet/sorted_queue.h"
 #include "roc_pipeline/config.h"
+#include "roc_pipeline/metrics.h"
 #include "roc_rtcp/metrics.h"
 #include "roc_rtp/format_map.h"
 #include "roc_rtp/parser.h"
@@ -52,9 +59,16 @@ namespace pipeline {
 //! Contains:
 //!  - a pipeline for processing packets from single sender and converting
 //!    them into audio frames
+//!
+//! Sessions are stored in a hashmap keyed by sender source address, which
+//! allows to route packets to sessions in constant time.
+//!
+//! Session metrics are published after every frame and can be retrieved
+//! from any thread while the session is alive.
 class ReceiverSession
     : public core::RefCounted<ReceiverSession, core::StandardAllocation>,
-      public core::ListNode {
+      public core::ListNode,
+      public core::HashmapNode {
     typedef core::RefCounted<ReceiverSession, core::StandardAllocation> RefCounted;
 
 public:
@@ -89,18 +103,61 @@ public:
     //! Get audio reader.
     audio::IFrameReader& reader();
 
+    //! Get snapshot of session metrics.
+    //! @remarks
+    //!  Thread-safe and lock-free.
+    ReceiverSessionMetrics get_metrics() const;
+
+    //! Get metrics to be reported to sender.
+    //! @remarks
+    //!  Loss fraction is computed since previous call, as defined in RFC 3550
+    //!  (appendix A.3), so this method should be called once per report.
+    rtcp::ReceptionMetrics get_reception_metrics();
+
     //! Handle metrics obtained from sender.
     void add_sending_metrics(const rtcp::SendingMetrics& metrics);
 
     //! Handle estimated link metrics.
     void add_link_metrics(const rtcp::LinkMetrics& metrics);
 
+    //! Get session key for hashmap.
+    //! @remarks
+    //!  Session owns all packets received from this address.
+    const address::SocketAddr& key() const {
+        return src_address_;
+    }
+
+    //! Compute hash of session key.
+    static core::hashsum_t key_hash(const address::SocketAddr& src_address) {
+        return src_address.hash();
+    }
+
+    //! Compare session keys.
+    static bool key_equal(const address::SocketAddr& src_address1,
+                          const address::SocketAddr& src_address2) {
+        return src_address1 == src_address2;
+    }
+
 private:
+    // Measures time spent on reading frames from session pipeline.
+    class TimingReader : public audio::IFrameReader {
+    public:
+        TimingReader(ReceiverSession& session);
+
+        virtual bool read(audio::Frame& frame);
+
+    private:
+        ReceiverSession& session_;
+    };
+
+    void publish_metrics_();
+
     const address::SocketAddr src_address_;
 
     audio::IFrameReader* audio_reader_;
 
     core::Optional<packet::Router> queue_router_;
+    core::Optional<packet::JitterMeter> jitter_meter_;
 
     core::Optional<packet::SortedQueue> source_queue_;
     core::Optional<packet::SortedQueue> repair_queue_;
@@ -115,8 +172,10 @@ private:
     core::Optional<rtp::Parser> fec_parser_;
     core::ScopedPtr<fec::IBlockDecoder> fec_decoder_;
     core::Optional<fec::Reader> fec_reader_;
+    core::Optional<fec::RlcReader> rlc_reader_;
     core::Optional<rtp::Validator> fec_validator_;
 
+    core::Optional<packet::QueueingDelayMeter> delay_meter_;
     core::Optional<audio::Depacketizer> depacketizer_;
 
     core::Optional<audio::ChannelMapperReader> channel_mapper_reader_;
@@ -128,6 +187,17 @@ private:
     core::Optional<audio::PoisonReader> session_poisoner_;
 
     core::Optional<audio::LatencyMonitor> latency_monitor_;
+
+    TimingReader timing_reader_;
+
+    // exponential moving average of frame reading time
+    double frame_processing_time_;
+
+    core::Seqlock<ReceiverSessionMetrics> metrics_;
+
+    // packet counters at the moment of previous reception report
+    uint64_t report_received_;
+    uint64_t report_lost_;
 };
 
 } // namespace pipeline
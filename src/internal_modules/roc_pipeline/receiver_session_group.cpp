@@ -9,6 +9,7 @@
 #include "roc_pipeline/receiver_session_group.h"
 #include "roc_address/socket_addr_to_str.h"
 #include "roc_core/log.h"
+#include "roc_core/panic.h"
 
 namespace roc {
 namespace pipeline {
@@ -23,13 +24,18 @@ ReceiverSessionGroup::ReceiverSessionGroup(
     core::BufferFactory<audio::sample_t>& sample_buffer_factory,
     core::IAllocator& allocator)
     : allocator_(allocator)
+    , session_arena_(allocator, receiver_config.common.poisoning)
     , packet_factory_(packet_factory)
     , byte_buffer_factory_(byte_buffer_factory)
     , sample_buffer_factory_(sample_buffer_factory)
     , format_map_(format_map)
     , mixer_(mixer)
     , receiver_state_(receiver_state)
-    , receiver_config_(receiver_config) {
+    , receiver_config_(receiver_config)
+    , session_map_(allocator) {
+    if (receiver_config_.common.prewarmed_sessions != 0) {
+        prewarm_sessions_();
+    }
 }
 
 void ReceiverSessionGroup::route_packet(const packet::PacketPtr& packet) {
@@ -71,6 +77,26 @@ size_t ReceiverSessionGroup::num_sessions() const {
     return sessions_.size();
 }
 
+void ReceiverSessionGroup::get_metrics(ReceiverSessionMetricsFunc sess_metrics_func,
+                                       size_t* sess_metrics_size,
+                                       void* sess_metrics_arg) const {
+    roc_panic_if(!sess_metrics_size);
+    roc_panic_if(!sess_metrics_func && *sess_metrics_size != 0);
+
+    size_t n_sess = 0;
+
+    core::SharedPtr<ReceiverSession> sess;
+
+    for (sess = sessions_.front(); sess; sess = sessions_.nextof(*sess)) {
+        if (n_sess < *sess_metrics_size) {
+            sess_metrics_func(sess->get_metrics(), n_sess, sess_metrics_arg);
+        }
+        n_sess++;
+    }
+
+    *sess_metrics_size = n_sess;
+}
+
 void ReceiverSessionGroup::on_update_source(packet::source_t ssrc, const char* cname) {
     // TODO
     (void)ssrc;
@@ -83,15 +109,23 @@ void ReceiverSessionGroup::on_remove_source(packet::source_t ssrc) {
 }
 
 size_t ReceiverSessionGroup::on_get_num_sources() {
-    // TODO
-    return 0;
+    return sessions_.size();
 }
 
 rtcp::ReceptionMetrics
 ReceiverSessionGroup::on_get_reception_metrics(size_t source_index) {
-    // TODO
-    (void)source_index;
-    return rtcp::ReceptionMetrics();
+    core::SharedPtr<ReceiverSession> sess = sessions_.front();
+
+    for (size_t n = 0; sess && n < source_index; n++) {
+        sess = sessions_.nextof(*sess);
+    }
+
+    if (!sess) {
+        roc_panic("session group: source index out of bounds: source_index=%lu",
+                  (unsigned long)source_index);
+    }
+
+    return sess->get_reception_metrics();
 }
 
 void ReceiverSessionGroup::on_add_sending_metrics(const rtcp::SendingMetrics& metrics) {
@@ -111,10 +145,11 @@ void ReceiverSessionGroup::on_add_link_metrics(const rtcp::LinkMetrics& metrics)
 }
 
 void ReceiverSessionGroup::route_transport_packet_(const packet::PacketPtr& packet) {
-    core::SharedPtr<ReceiverSession> sess;
+    if (packet->udp()) {
+        core::SharedPtr<ReceiverSession> sess =
+            session_map_.find(packet->udp()->src_addr);
 
-    for (sess = sessions_.front(); sess; sess = sessions_.nextof(*sess)) {
-        if (sess->handle(packet)) {
+        if (sess && sess->handle(packet)) {
             return;
         }
     }
@@ -173,15 +208,20 @@ void ReceiverSessionGroup::create_session_(const packet::PacketPtr& packet) {
             address::socket_addr_to_str(src_address).c_str(),
             address::socket_addr_to_str(dst_address).c_str());
 
-    core::SharedPtr<ReceiverSession> sess = new (allocator_) ReceiverSession(
+    core::SharedPtr<ReceiverSession> sess = new (session_arena_) ReceiverSession(
         sess_config, receiver_config_.common, src_address, format_map_, packet_factory_,
-        byte_buffer_factory_, sample_buffer_factory_, allocator_);
+        byte_buffer_factory_, sample_buffer_factory_, session_arena_);
 
     if (!sess || !sess->valid()) {
         roc_log(LogError, "session group: can't create session, initialization failed");
         return;
     }
 
+    if (!session_map_.grow()) {
+        roc_log(LogError, "session group: can't create session, allocation failed");
+        return;
+    }
+
     if (!sess->handle(packet)) {
         roc_log(LogError,
                 "session group: can't create session, can't handle first packet");
@@ -190,6 +230,7 @@ void ReceiverSessionGroup::create_session_(const packet::PacketPtr& packet) {
 
     mixer_.add_input(sess->reader());
     sessions_.push_back(*sess);
+    session_map_.insert(*sess);
 
     receiver_state_.add_sessions(+1);
 }
@@ -198,11 +239,55 @@ void ReceiverSessionGroup::remove_session_(ReceiverSession& sess) {
     roc_log(LogInfo, "session group: removing session");
 
     mixer_.remove_input(sess.reader());
+    session_map_.remove(sess);
     sessions_.remove(sess);
 
     receiver_state_.add_sessions(-1);
 }
 
+void ReceiverSessionGroup::prewarm_sessions_() {
+    const size_t n_sessions = receiver_config_.common.prewarmed_sessions;
+
+    roc_log(LogDebug, "session group: prewarming sessions: n_sessions=%lu",
+            (unsigned long)n_sessions);
+
+    core::List<ReceiverSession> prewarmed;
+
+    for (size_t n = 0; n < n_sessions; n++) {
+        address::SocketAddr src_address;
+        if (!src_address.set_host_port(address::Family_IPv4, "0.0.0.0", int(n + 1))) {
+            roc_panic("session group: can't set prewarmed session address");
+        }
+
+        core::SharedPtr<ReceiverSession> sess = new (session_arena_) ReceiverSession(
+            receiver_config_.default_session, receiver_config_.common, src_address,
+            format_map_, packet_factory_, byte_buffer_factory_, sample_buffer_factory_,
+            session_arena_);
+
+        if (!sess || !sess->valid()) {
+            roc_log(LogError,
+                    "session group: can't prewarm sessions, initialization failed");
+            break;
+        }
+
+        if (!session_map_.grow()) {
+            roc_log(LogError, "session group: can't prewarm sessions, allocation failed");
+            break;
+        }
+
+        session_map_.insert(*sess);
+        prewarmed.push_back(*sess);
+    }
+
+    // Memory of removed sessions stays in the arena and buffer pools and will be
+    // reused by real sessions.
+    core::SharedPtr<ReceiverSession> sess;
+    while ((sess = prewarmed.front())) {
+        session_map_.remove(*sess);
+        prewarmed.remove(*sess);
+    }
+}
+
 ReceiverSessionConfig
 ReceiverSessionGroup::make_session_config_(const packet::PacketPtr& packet) const {
     ReceiverSessionConfig config = receiver_config_.default_session;
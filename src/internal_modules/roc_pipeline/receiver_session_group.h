@@ -13,9 +13,12 @@
 #define ROC_PIPELINE_RECEIVER_SESSION_GROUP_H_
 
 #include "roc_audio/mixer.h"
+#include "roc_core/hashmap.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/list.h"
 #include "roc_core/noncopyable.h"
+#include "roc_core/slab_allocator.h"
+#include "roc_pipeline/metrics.h"
 #include "roc_pipeline/receiver_session.h"
 #include "roc_pipeline/receiver_state.h"
 #include "roc_rtcp/composer.h"
@@ -28,6 +31,7 @@ namespace pipeline {
 //!
 //! Contains:
 //!  - a set of related receiver sessions
+//!  - an arena from which sessions are allocated
 class ReceiverSessionGroup : public core::NonCopyable<>, private rtcp::IReceiverHooks {
 public:
     //! Initialize.
@@ -52,6 +56,14 @@ public:
     //! Get number of alive sessions.
     size_t num_sessions() const;
 
+    //! Get metrics of alive sessions.
+    //! @remarks
+    //!  Invokes @p sess_metrics_func for up to @p *sess_metrics_size sessions
+    //!  and sets @p *sess_metrics_size to the number of alive sessions.
+    void get_metrics(ReceiverSessionMetricsFunc sess_metrics_func,
+                     size_t* sess_metrics_size,
+                     void* sess_metrics_arg) const;
+
 private:
     // Implementation of rtcp::IReceiverHooks interface.
     // These methods are invoked by rtcp::Session.
@@ -70,9 +82,12 @@ private:
     void create_session_(const packet::PacketPtr& packet);
     void remove_session_(ReceiverSession& sess);
 
+    void prewarm_sessions_();
+
     ReceiverSessionConfig make_session_config_(const packet::PacketPtr& packet) const;
 
     core::IAllocator& allocator_;
+    core::SlabAllocator session_arena_;
 
     packet::PacketFactory& packet_factory_;
     core::BufferFactory<uint8_t>& byte_buffer_factory_;
@@ -89,6 +104,7 @@ private:
     core::Optional<rtcp::Session> rtcp_session_;
 
     core::List<ReceiverSession> sessions_;
+    core::Hashmap<ReceiverSession> session_map_;
 };
 
 } // namespace pipeline
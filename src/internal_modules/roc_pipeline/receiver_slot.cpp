@@ -20,9 +20,11 @@ ReceiverSlot::ReceiverSlot(const ReceiverConfig& receiver_config,
                            packet::PacketFactory& packet_factory,
                            core::BufferFactory<uint8_t>& byte_buffer_factory,
                            core::BufferFactory<audio::sample_t>& sample_buffer_factory,
+                           packet::TraceWriter* trace_writer,
                            core::IAllocator& allocator)
     : RefCounted(allocator)
     , format_map_(format_map)
+    , trace_writer_(trace_writer)
     , receiver_state_(receiver_state)
     , session_group_(receiver_config,
                      receiver_state,
@@ -104,6 +106,12 @@ size_t ReceiverSlot::num_sessions() const {
     return session_group_.num_sessions();
 }
 
+void ReceiverSlot::get_metrics(ReceiverSessionMetricsFunc sess_metrics_func,
+                               size_t* sess_metrics_size,
+                               void* sess_metrics_arg) const {
+    session_group_.get_metrics(sess_metrics_func, sess_metrics_size, sess_metrics_arg);
+}
+
 ReceiverEndpoint* ReceiverSlot::create_source_endpoint_(address::Protocol proto) {
     if (source_endpoint_) {
         roc_log(LogError, "receiver slot: audio source endpoint is already set");
@@ -121,7 +129,8 @@ ReceiverEndpoint* ReceiverSlot::create_source_endpoint_(address::Protocol proto)
     }
 
     source_endpoint_.reset(new (source_endpoint_) ReceiverEndpoint(
-        proto, receiver_state_, session_group_, format_map_, allocator()));
+        address::Iface_AudioSource, proto, receiver_state_, session_group_, format_map_,
+        trace_writer_, allocator()));
 
     if (!source_endpoint_ || !source_endpoint_->valid()) {
         roc_log(LogError, "receiver slot: can't create source endpoint");
@@ -149,7 +158,8 @@ ReceiverEndpoint* ReceiverSlot::create_repair_endpoint_(address::Protocol proto)
     }
 
     repair_endpoint_.reset(new (repair_endpoint_) ReceiverEndpoint(
-        proto, receiver_state_, session_group_, format_map_, allocator()));
+        address::Iface_AudioRepair, proto, receiver_state_, session_group_, format_map_,
+        trace_writer_, allocator()));
 
     if (!repair_endpoint_ || !repair_endpoint_->valid()) {
         roc_log(LogError, "receiver slot: can't create repair endpoint");
@@ -171,7 +181,8 @@ ReceiverEndpoint* ReceiverSlot::create_control_endpoint_(address::Protocol proto
     }
 
     control_endpoint_.reset(new (control_endpoint_) ReceiverEndpoint(
-        proto, receiver_state_, session_group_, format_map_, allocator()));
+        address::Iface_AudioControl, proto, receiver_state_, session_group_, format_map_,
+        trace_writer_, allocator()));
 
     if (!control_endpoint_ || !control_endpoint_->valid()) {
         roc_log(LogError, "receiver slot: can't create control endpoint");
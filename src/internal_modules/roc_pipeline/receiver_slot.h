@@ -20,6 +20,7 @@
 #include "roc_core/list_node.h"
 #include "roc_core/ref_counted.h"
 #include "roc_packet/packet_factory.h"
+#include "roc_pipeline/metrics.h"
 #include "roc_pipeline/receiver_endpoint.h"
 #include "roc_pipeline/receiver_session_group.h"
 #include "roc_pipeline/receiver_state.h"
@@ -46,6 +47,7 @@ public:
                  packet::PacketFactory& packet_factory,
                  core::BufferFactory<uint8_t>& byte_buffer_factory,
                  core::BufferFactory<audio::sample_t>& sample_buffer_factory,
+                 packet::TraceWriter* trace_writer,
                  core::IAllocator& allocator);
 
     //! Create endpoint.
@@ -63,12 +65,21 @@ public:
     //! Get number of alive sessions.
     size_t num_sessions() const;
 
+    //! Get metrics of alive sessions.
+    //! @remarks
+    //!  Invokes @p sess_metrics_func for up to @p *sess_metrics_size sessions
+    //!  and sets @p *sess_metrics_size to the number of alive sessions.
+    void get_metrics(ReceiverSessionMetricsFunc sess_metrics_func,
+                     size_t* sess_metrics_size,
+                     void* sess_metrics_arg) const;
+
 private:
     ReceiverEndpoint* create_source_endpoint_(address::Protocol proto);
     ReceiverEndpoint* create_repair_endpoint_(address::Protocol proto);
     ReceiverEndpoint* create_control_endpoint_(address::Protocol proto);
 
     const rtp::FormatMap& format_map_;
+    packet::TraceWriter* trace_writer_;
 
     ReceiverState& receiver_state_;
     ReceiverSessionGroup session_group_;
@@ -30,9 +30,24 @@ ReceiverSource::ReceiverSource(
     , audio_reader_(NULL)
     , config_(config)
     , timestamp_(0) {
-    mixer_.reset(new (mixer_) audio::Mixer(sample_buffer_factory,
-                                           config.common.internal_frame_length,
-                                           config.common.output_sample_spec));
+    if (config.common.packet_trace_path) {
+        trace_writer_.reset(new (trace_writer_) packet::TraceWriter());
+        if (!trace_writer_->open(config.common.packet_trace_path)) {
+            return;
+        }
+    }
+
+    if (config.common.session_workers != 0) {
+        mixer_pool_.reset(new (mixer_pool_) audio::MixerWorkerPool(
+            allocator, config.common.session_workers));
+        if (!mixer_pool_ || !mixer_pool_->valid()) {
+            return;
+        }
+    }
+
+    mixer_.reset(new (mixer_) audio::Mixer(
+        sample_buffer_factory, config.common.internal_frame_length,
+        config.common.output_sample_spec, mixer_pool_.get()));
     if (!mixer_ || !mixer_->valid()) {
         return;
     }
@@ -66,7 +81,8 @@ bool ReceiverSource::valid() const {
 ReceiverSlot* ReceiverSource::create_slot() {
     core::SharedPtr<ReceiverSlot> slot = new (allocator_)
         ReceiverSlot(config_, state_, *mixer_, format_map_, packet_factory_,
-                     byte_buffer_factory_, sample_buffer_factory_, allocator_);
+                     byte_buffer_factory_, sample_buffer_factory_, trace_writer_.get(),
+                     allocator_);
     if (!slot) {
         return NULL;
     }
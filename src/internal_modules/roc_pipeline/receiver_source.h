@@ -14,6 +14,7 @@
 
 #include "roc_audio/iframe_reader.h"
 #include "roc_audio/mixer.h"
+#include "roc_audio/mixer_worker_pool.h"
 #include "roc_audio/poison_reader.h"
 #include "roc_audio/profiling_reader.h"
 #include "roc_core/buffer_factory.h"
@@ -24,6 +25,7 @@
 #include "roc_packet/ireader.h"
 #include "roc_packet/iwriter.h"
 #include "roc_packet/packet_factory.h"
+#include "roc_packet/trace_writer.h"
 #include "roc_pipeline/config.h"
 #include "roc_pipeline/receiver_endpoint.h"
 #include "roc_pipeline/receiver_slot.h"
@@ -103,6 +105,9 @@ private:
     ReceiverState state_;
     core::List<ReceiverSlot> slots_;
 
+    core::Optional<packet::TraceWriter> trace_writer_;
+
+    core::Optional<audio::MixerWorkerPool> mixer_pool_;
     core::Optional<audio::Mixer> mixer_;
     core::Optional<audio::PoisonReader> poisoner_;
     core::Optional<audio::ProfilingReader> profiler_;
@@ -11,20 +11,27 @@
 #include "roc_core/panic.h"
 #include "roc_fec/composer.h"
 #include "roc_fec/headers.h"
+#include "roc_pipeline/sender_session.h"
 
 namespace roc {
 namespace pipeline {
 
-SenderEndpoint::SenderEndpoint(address::Protocol proto, core::IAllocator& allocator)
+SenderEndpoint::SenderEndpoint(address::Protocol proto,
+                               packet::PacketFactory& packet_factory,
+                               core::IAllocator& allocator)
     : proto_(proto)
+    , packet_factory_(packet_factory)
     , dst_writer_(NULL)
-    , composer_(NULL) {
+    , composer_(NULL)
+    , mirrors_(allocator)
+    , inbound_writer_(inbound_queue_) {
     packet::IComposer* composer = NULL;
 
     switch (proto) {
     case address::Proto_RTP:
     case address::Proto_RTP_LDPC_Source:
     case address::Proto_RTP_RS8M_Source:
+    case address::Proto_RTP_RLC_Source:
         rtp_composer_.reset(new (rtp_composer_) rtp::Composer(NULL));
         if (!rtp_composer_) {
             return;
@@ -78,6 +85,28 @@ SenderEndpoint::SenderEndpoint(address::Protocol proto, core::IAllocator& alloca
         }
         composer = fec_composer_.get();
         break;
+    case address::Proto_RTP_RLC_Source:
+        fec_composer_.reset(
+            new (allocator)
+                fec::Composer<fec::RLC_Source_PayloadID, fec::Source, fec::Footer>(
+                    composer),
+            allocator);
+        if (!fec_composer_) {
+            return;
+        }
+        composer = fec_composer_.get();
+        break;
+    case address::Proto_RLC_Repair:
+        fec_composer_.reset(
+            new (allocator)
+                fec::Composer<fec::RLC_Repair_PayloadID, fec::Repair, fec::Header>(
+                    composer),
+            allocator);
+        if (!fec_composer_) {
+            return;
+        }
+        composer = fec_composer_.get();
+        break;
     default:
         break;
     }
@@ -89,6 +118,11 @@ SenderEndpoint::SenderEndpoint(address::Protocol proto, core::IAllocator& alloca
             return;
         }
         composer = rtcp_composer_.get();
+
+        rtcp_parser_.reset(new (rtcp_parser_) rtcp::Parser());
+        if (!rtcp_parser_) {
+            return;
+        }
         break;
     default:
         break;
@@ -145,6 +179,61 @@ void SenderEndpoint::set_destination_address(const address::SocketAddr& addr) {
     dst_address_ = addr;
 }
 
+bool SenderEndpoint::add_mirror(SenderEndpoint& endpoint) {
+    roc_panic_if(!valid());
+
+    if (&endpoint == this) {
+        roc_panic("sender endpoint: attempt to add endpoint as its own mirror");
+    }
+
+    if (endpoint.proto() != proto_) {
+        roc_log(LogError,
+                "sender endpoint: mirror should use same protocol:"
+                " endpoint_proto=%s mirror_proto=%s",
+                address::proto_to_str(proto_), address::proto_to_str(endpoint.proto()));
+        return false;
+    }
+
+    if (!mirrors_.grow_exp(mirrors_.size() + 1)) {
+        roc_log(LogError, "sender endpoint: can't allocate mirror");
+        return false;
+    }
+
+    mirrors_.push_back(&endpoint);
+
+    return true;
+}
+
+packet::IWriter& SenderEndpoint::inbound_writer() {
+    roc_panic_if(!valid());
+
+    if (!rtcp_parser_) {
+        roc_panic("sender endpoint: inbound packets are not supported for protocol %s",
+                  address::proto_to_str(proto_));
+    }
+
+    return inbound_writer_;
+}
+
+void SenderEndpoint::pull_packets(SenderSession& session) {
+    roc_panic_if(!valid());
+
+    if (!rtcp_parser_) {
+        return;
+    }
+
+    // Using try_pop_front_exclusive() makes this method lock-free and wait-free.
+    // Packets that are being added currently will be pulled next time.
+    while (packet::PacketPtr packet = inbound_queue_.try_pop_front_exclusive()) {
+        if (!rtcp_parser_->parse(*packet, packet->data())) {
+            roc_log(LogDebug, "sender endpoint: can't parse inbound packet");
+            continue;
+        }
+
+        session.process_control_packet(packet);
+    }
+}
+
 void SenderEndpoint::write(const packet::PacketPtr& packet) {
     roc_panic_if(!valid());
 
@@ -153,7 +242,10 @@ void SenderEndpoint::write(const packet::PacketPtr& packet) {
     }
 
     if (dst_address_.has_host_port()) {
-        packet->add_flags(packet::Packet::FlagUDP);
+        if ((packet->flags() & packet::Packet::FlagUDP) == 0) {
+            // mirror packets already have UDP info copied from original
+            packet->add_flags(packet::Packet::FlagUDP);
+        }
         packet->udp()->dst_addr = dst_address_;
     }
 
@@ -164,8 +256,55 @@ void SenderEndpoint::write(const packet::PacketPtr& packet) {
         packet->add_flags(packet::Packet::FlagComposed);
     }
 
+    if (mirrors_.size() != 0) {
+        write_mirrors_(*packet);
+    }
+
     dst_writer_->write(packet);
 }
 
+void SenderEndpoint::write_mirrors_(const packet::Packet& packet) {
+    for (size_t n = 0; n < mirrors_.size(); n++) {
+        packet::PacketPtr pp = packet_factory_.new_packet();
+        if (!pp) {
+            roc_log(LogError, "sender endpoint: can't allocate packet for mirror");
+            continue;
+        }
+
+        // Mirror packet shares buffer with original packet, which is already
+        // composed, so mirror will only set its own destination address.
+        pp->add_flags(packet.flags());
+
+        if (packet.udp()) {
+            *pp->udp() = *packet.udp();
+        }
+        if (packet.rtp()) {
+            *pp->rtp() = *packet.rtp();
+        }
+        if (packet.fec()) {
+            *pp->fec() = *packet.fec();
+        }
+        if (packet.rtcp()) {
+            *pp->rtcp() = *packet.rtcp();
+        }
+
+        pp->set_data(packet.data());
+
+        mirrors_[n]->write(pp);
+    }
+}
+
+SenderEndpoint::InboundWriter::InboundWriter(core::MpscQueue<packet::Packet>& queue)
+    : queue_(queue) {
+}
+
+void SenderEndpoint::InboundWriter::write(const packet::PacketPtr& packet) {
+    if (!packet) {
+        roc_panic("sender endpoint: packet is null");
+    }
+
+    queue_.push_back(*packet);
+}
+
 } // namespace pipeline
 } // namespace roc
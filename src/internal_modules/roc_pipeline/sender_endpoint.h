@@ -12,28 +12,38 @@
 #ifndef ROC_PIPELINE_SENDER_ENDPOINT_H_
 #define ROC_PIPELINE_SENDER_ENDPOINT_H_
 
+#include "roc_core/array.h"
 #include "roc_core/iallocator.h"
+#include "roc_core/mpsc_queue.h"
 #include "roc_core/mutex.h"
 #include "roc_core/noncopyable.h"
 #include "roc_core/optional.h"
 #include "roc_core/scoped_ptr.h"
 #include "roc_packet/icomposer.h"
 #include "roc_packet/iwriter.h"
+#include "roc_packet/packet_factory.h"
 #include "roc_pipeline/config.h"
 #include "roc_rtcp/composer.h"
+#include "roc_rtcp/parser.h"
 #include "roc_rtp/composer.h"
 
 namespace roc {
 namespace pipeline {
 
+class SenderSession;
+
 //! Sender endpoint sub-pipeline.
 //!
 //! Contains:
 //!  - a pipeline for processing packets for single network endpoint
+//!  - optional list of mirror endpoints which receive the same packets
+//!  - for control endpoint, a queue of inbound packets from receivers
 class SenderEndpoint : public core::NonCopyable<>, private packet::IWriter {
 public:
     //! Initialize.
-    SenderEndpoint(address::Protocol proto, core::IAllocator& allocator);
+    SenderEndpoint(address::Protocol proto,
+                   packet::PacketFactory& packet_factory,
+                   core::IAllocator& allocator);
 
     //! Check if pipeline was succefully constructed.
     bool valid() const;
@@ -68,11 +78,46 @@ public:
     //!  the specified destination address.
     void set_destination_address(const address::SocketAddr&);
 
+    //! Add mirror endpoint.
+    //! @remarks
+    //!  Every packet written to this endpoint is also passed to the mirror
+    //!  endpoint. The packet is composed only once, and the mirror gets its
+    //!  own packet object referring to the same buffer, with its own
+    //!  destination address. Mirror should use the same protocol.
+    bool add_mirror(SenderEndpoint& endpoint);
+
+    //! Get inbound packet writer.
+    //! @remarks
+    //!  Packets passed to this writer will be pulled by endpoint pipeline and
+    //!  passed to sender session. Only control endpoint accepts inbound packets.
+    //!  This writer is thread-safe and lock-free.
+    //!  The writer is passed to netio thread.
+    packet::IWriter& inbound_writer();
+
+    //! Pull packets written to inbound writer.
+    //! @remarks
+    //!  Parses inbound packets and passes them to the given session.
+    void pull_packets(SenderSession& session);
+
 private:
+    class InboundWriter : public packet::IWriter, public core::NonCopyable<> {
+    public:
+        InboundWriter(core::MpscQueue<packet::Packet>& queue);
+
+        virtual void write(const packet::PacketPtr& packet);
+
+    private:
+        core::MpscQueue<packet::Packet>& queue_;
+    };
+
     virtual void write(const packet::PacketPtr& packet);
 
+    void write_mirrors_(const packet::Packet& packet);
+
     const address::Protocol proto_;
 
+    packet::PacketFactory& packet_factory_;
+
     packet::IWriter* dst_writer_;
     address::SocketAddr dst_address_;
 
@@ -81,6 +126,13 @@ private:
     core::Optional<rtp::Composer> rtp_composer_;
     core::ScopedPtr<packet::IComposer> fec_composer_;
     core::Optional<rtcp::Composer> rtcp_composer_;
+
+    core::Array<SenderEndpoint*, 4> mirrors_;
+
+    core::Optional<rtcp::Parser> rtcp_parser_;
+
+    core::MpscQueue<packet::Packet> inbound_queue_;
+    InboundWriter inbound_writer_;
 };
 
 } // namespace pipeline
@@ -98,6 +98,7 @@ SenderLoop::SenderLoop(IPipelineTaskScheduler& scheduler,
             sample_buffer_factory,
             allocator)
     , timestamp_(0)
+    , latency_(0)
     , valid_(false) {
     if (!sink_.valid()) {
         return;
@@ -123,6 +124,16 @@ sndio::ISink& SenderLoop::sink() {
     return *this;
 }
 
+SenderMetrics SenderLoop::get_metrics() const {
+    roc_panic_if_not(valid());
+
+    SenderMetrics metrics;
+    metrics.pipeline = get_stats();
+    metrics.latency = latency_.wait_load();
+
+    return metrics;
+}
+
 sndio::DeviceType SenderLoop::type() const {
     roc_panic_if(!valid());
 
@@ -235,7 +246,14 @@ bool SenderLoop::task_create_endpoint_(Task& task) {
     roc_panic_if(!task.slot_);
 
     task.endpoint_ = task.slot_->create_endpoint(task.iface_, task.proto_);
-    return (bool)task.endpoint_;
+    if (!task.endpoint_) {
+        return false;
+    }
+
+    // creating endpoints may enable FEC and interleaving
+    latency_.exclusive_store(sink_.latency());
+
+    return true;
 }
 
 bool SenderLoop::task_set_endpoint_destination_writer_(Task& task) {
@@ -15,8 +15,10 @@
 #include "roc_core/buffer_factory.h"
 #include "roc_core/iallocator.h"
 #include "roc_core/mutex.h"
+#include "roc_core/seqlock.h"
 #include "roc_core/ticker.h"
 #include "roc_pipeline/config.h"
+#include "roc_pipeline/metrics.h"
 #include "roc_pipeline/pipeline_loop.h"
 #include "roc_pipeline/sender_sink.h"
 #include "roc_sndio/isink.h"
@@ -135,6 +137,11 @@ public:
     //!  Samples written to the sink are sent to remote peers.
     sndio::ISink& sink();
 
+    //! Get sender metrics.
+    //! @remarks
+    //!  Lock-free, can be called from any thread.
+    SenderMetrics get_metrics() const;
+
 private:
     // Methods of sndio::ISink
     virtual sndio::DeviceType type() const;
@@ -166,6 +173,9 @@ private:
 
     core::Mutex sink_mutex_;
 
+    // Latency of sink, updated when endpoints are created.
+    core::Seqlock<core::nanoseconds_t> latency_;
+
     bool valid_;
 };
 
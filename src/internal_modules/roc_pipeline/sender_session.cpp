@@ -9,7 +9,9 @@
 #include "roc_pipeline/sender_session.h"
 #include "roc_core/log.h"
 #include "roc_core/panic.h"
+#include "roc_core/time.h"
 #include "roc_fec/codec_map.h"
+#include "roc_packet/fec_scheme_to_str.h"
 
 namespace roc {
 namespace pipeline {
@@ -26,6 +28,7 @@ SenderSession::SenderSession(const SenderConfig& config,
     , packet_factory_(packet_factory)
     , byte_buffer_factory_(byte_buffer_factory)
     , sample_buffer_factory_(sample_buffer_factory)
+    , control_endpoint_(NULL)
     , audio_writer_(NULL)
     , num_sources_(0) {
 }
@@ -63,7 +66,17 @@ bool SenderSession::create_transport_pipeline(SenderEndpoint* source_endpoint,
             return false;
         }
 
-        if (config_.interleaving) {
+        fec::WriterConfig writer_config = config_.fec_writer;
+
+        if (config_.fec_interleaver.enabled) {
+            if (!create_block_interleaver_(*pwriter)) {
+                return false;
+            }
+            pwriter = block_interleaver_.get();
+
+            // repair packets of buffered blocks can't be recycled yet
+            writer_config.n_held_blocks = block_interleaver_->max_blocks();
+        } else if (config_.interleaving) {
             interleaver_.reset(new (interleaver_) packet::Interleaver(
                 *pwriter, allocator_,
                 config_.fec_writer.n_source_packets
@@ -74,21 +87,38 @@ bool SenderSession::create_transport_pipeline(SenderEndpoint* source_endpoint,
             pwriter = interleaver_.get();
         }
 
-        fec_encoder_.reset(fec::CodecMap::instance().new_encoder(
-                               config_.fec_encoder, byte_buffer_factory_, allocator_),
-                           allocator_);
-        if (!fec_encoder_) {
-            return false;
+        if (config_.fec_encoder.scheme == packet::FEC_RLC) {
+            rlc_writer_.reset(new (rlc_writer_) fec::RlcWriter(
+                writer_config, config_.fec_encoder.scheme, *pwriter,
+                source_endpoint->composer(), repair_endpoint->composer(),
+                packet_factory_, byte_buffer_factory_, allocator_));
+            if (!rlc_writer_ || !rlc_writer_->valid()) {
+                return false;
+            }
+            pwriter = rlc_writer_.get();
+        } else {
+            fec_encoder_.reset(fec::CodecMap::instance().new_encoder(
+                                   config_.fec_encoder, byte_buffer_factory_, allocator_),
+                               allocator_);
+            if (!fec_encoder_) {
+                return false;
+            }
+
+            fec_writer_.reset(new (fec_writer_) fec::Writer(
+                writer_config, config_.fec_encoder.scheme, *fec_encoder_, *pwriter,
+                source_endpoint->composer(), repair_endpoint->composer(),
+                packet_factory_, byte_buffer_factory_, allocator_));
+            if (!fec_writer_ || !fec_writer_->valid()) {
+                return false;
+            }
+            pwriter = fec_writer_.get();
         }
 
-        fec_writer_.reset(new (fec_writer_) fec::Writer(
-            config_.fec_writer, config_.fec_encoder.scheme, *fec_encoder_, *pwriter,
-            source_endpoint->composer(), repair_endpoint->composer(), packet_factory_,
-            byte_buffer_factory_, allocator_));
-        if (!fec_writer_ || !fec_writer_->valid()) {
-            return false;
+        if (config_.fec_redundancy.enabled) {
+            if (!create_redundancy_controller_()) {
+                return false;
+            }
         }
-        pwriter = fec_writer_.get();
     }
 
     payload_encoder_.reset(format->new_encoder(allocator_), allocator_);
@@ -173,6 +203,8 @@ bool SenderSession::create_control_pipeline(SenderEndpoint* control_endpoint) {
         return false;
     }
 
+    control_endpoint_ = control_endpoint;
+
     return true;
 }
 
@@ -180,7 +212,22 @@ audio::IFrameWriter* SenderSession::writer() const {
     return audio_writer_;
 }
 
+core::nanoseconds_t SenderSession::latency() const {
+    if (block_interleaver_) {
+        return core::nanoseconds_t(
+                   block_interleaver_->max_delay(config_.fec_writer.n_source_packets))
+            * config_.packet_length;
+    }
+
+    return 0;
+}
+
 core::nanoseconds_t SenderSession::get_update_deadline() const {
+    if (fec_writer_ && fec_writer_->has_pending_blocks()) {
+        // repair packets may be ready, check them as soon as possible
+        return core::timestamp(core::ClockMonotonic);
+    }
+
     if (rtcp_session_) {
         return rtcp_session_->generation_deadline();
     }
@@ -189,11 +236,50 @@ core::nanoseconds_t SenderSession::get_update_deadline() const {
 }
 
 void SenderSession::update() {
+    if (control_endpoint_) {
+        control_endpoint_->pull_packets(*this);
+    }
+
+    if (fec_writer_) {
+        fec_writer_->refresh();
+    }
+
     if (rtcp_session_) {
         rtcp_session_->generate_packets();
     }
 }
 
+void SenderSession::flush() {
+    if (fec_writer_) {
+        fec_writer_->flush();
+    }
+
+    if (block_interleaver_) {
+        block_interleaver_->flush();
+    }
+
+    if (interleaver_) {
+        interleaver_->flush();
+    }
+}
+
+void SenderSession::process_control_packet(const packet::PacketPtr& packet) {
+    roc_panic_if(!packet);
+
+    if (!rtcp_session_) {
+        roc_log(LogDebug, "sender session: ignoring control packet, no control pipeline");
+        return;
+    }
+
+    if (!packet->rtcp()) {
+        roc_log(LogDebug, "sender session: ignoring non-rtcp control packet");
+        return;
+    }
+
+    // This will invoke rtcp::ISenderHooks methods implemented by us.
+    rtcp_session_->process_packet(packet);
+}
+
 size_t SenderSession::on_get_num_sources() {
     return num_sources_;
 }
@@ -224,8 +310,12 @@ SenderSession::on_get_sending_metrics(packet::ntp_timestamp_t report_time) {
 }
 
 void SenderSession::on_add_reception_metrics(const rtcp::ReceptionMetrics& metrics) {
-    // TODO
-    (void)metrics;
+    if (redundancy_controller_) {
+        if (redundancy_controller_->update(metrics.fract_loss, metrics.cum_loss,
+                                           metrics.ext_last_seqnum)) {
+            apply_redundancy_();
+        }
+    }
 }
 
 void SenderSession::on_add_link_metrics(const rtcp::LinkMetrics& metrics) {
@@ -233,5 +323,80 @@ void SenderSession::on_add_link_metrics(const rtcp::LinkMetrics& metrics) {
     (void)metrics;
 }
 
+bool SenderSession::create_block_interleaver_(packet::IWriter& writer) {
+    // sliding window codes have no block boundaries to interleave
+    if (config_.fec_encoder.scheme == packet::FEC_RLC) {
+        roc_log(LogError,
+                "sender session: fec block interleaving is not supported"
+                " with fec scheme %s",
+                packet::fec_scheme_to_str(config_.fec_encoder.scheme));
+        return false;
+    }
+
+    block_interleaver_.reset(new (block_interleaver_) fec::BlockInterleaver(
+        config_.fec_interleaver, writer, allocator_));
+    if (!block_interleaver_ || !block_interleaver_->valid()) {
+        return false;
+    }
+
+    roc_log(LogInfo,
+            "sender session: fec block interleaving adds latency:"
+            " span=%lu sblen=%lu latency=%.3fms",
+            (unsigned long)block_interleaver_->span(),
+            (unsigned long)config_.fec_writer.n_source_packets,
+            (double)latency() / core::Millisecond);
+
+    return true;
+}
+
+bool SenderSession::create_redundancy_controller_() {
+    fec::RedundancyConfig redundancy_config = config_.fec_redundancy;
+
+    // LDPC-Staircase requires at least N1 repair packets per block
+    if (config_.fec_encoder.scheme == packet::FEC_LDPC_Staircase) {
+        const size_t min_rblen = config_.fec_encoder.ldpc_N1;
+
+        if (redundancy_config.min_repair_packets < min_rblen) {
+            redundancy_config.min_repair_packets = min_rblen;
+        }
+        if (redundancy_config.max_repair_packets < min_rblen) {
+            redundancy_config.max_repair_packets = min_rblen;
+        }
+    }
+
+    redundancy_controller_.reset(new (redundancy_controller_) fec::RedundancyController(
+        redundancy_config, config_.fec_writer.n_source_packets,
+        config_.fec_writer.n_repair_packets));
+    if (!redundancy_controller_ || !redundancy_controller_->valid()) {
+        return false;
+    }
+
+    apply_redundancy_();
+
+    return true;
+}
+
+void SenderSession::apply_redundancy_() {
+    const size_t n_source = config_.fec_writer.n_source_packets;
+    const size_t n_repair = redundancy_controller_->n_repair_packets();
+
+    // new sizes are applied starting from next block
+    if (fec_writer_) {
+        if (!fec_writer_->resize(n_source, n_repair)) {
+            roc_log(LogDebug,
+                    "sender session: can't resize fec block: sblen=%lu rblen=%lu",
+                    (unsigned long)n_source, (unsigned long)n_repair);
+        }
+    }
+
+    if (rlc_writer_) {
+        if (!rlc_writer_->resize(n_source, n_repair)) {
+            roc_log(LogDebug,
+                    "sender session: can't resize fec window: window=%lu rblen=%lu",
+                    (unsigned long)n_source, (unsigned long)n_repair);
+        }
+    }
+}
+
 } // namespace pipeline
 } // namespace roc
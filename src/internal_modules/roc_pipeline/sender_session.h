@@ -24,7 +24,10 @@
 #include "roc_core/noncopyable.h"
 #include "roc_core/optional.h"
 #include "roc_core/scoped_ptr.h"
+#include "roc_fec/block_interleaver.h"
 #include "roc_fec/iblock_encoder.h"
+#include "roc_fec/redundancy_controller.h"
+#include "roc_fec/rlc_writer.h"
 #include "roc_fec/writer.h"
 #include "roc_packet/interleaver.h"
 #include "roc_packet/packet_factory.h"
@@ -63,12 +66,36 @@ public:
     //! Get audio writer.
     audio::IFrameWriter* writer() const;
 
+    //! Get latency added by session.
+    //! @remarks
+    //!  Non-zero if FEC block interleaving is enabled.
+    core::nanoseconds_t latency() const;
+
     //! Get deadline when the pipeline should be updated.
     core::nanoseconds_t get_update_deadline() const;
 
     //! Update pipeline.
+    //! @remarks
+    //!  Processes control packets received by control endpoint, generates
+    //!  control packets, and writes repair packets of FEC blocks which were
+    //!  encoded in background since last write.
     void update();
 
+    //! Write all packets buffered in pipeline.
+    //! @remarks
+    //!  Waits for background encoding of complete FEC blocks and writes
+    //!  their repair packets, then sends packets held by interleaver.
+    //!  Should be called when the stream is stopped or paused.
+    void flush();
+
+    //! Process control packet received from receiver.
+    //! @remarks
+    //!  Reception reports from receiver are passed to FEC redundancy
+    //!  controller, if it's enabled. Requires control sub-pipeline.
+    //!  Invoked by update() for packets written to inbound writer of
+    //!  control endpoint.
+    void process_control_packet(const packet::PacketPtr& packet);
+
 private:
     // Implementation of rtcp::ISenderHooks interface.
     // These methods are invoked by rtcp::Session.
@@ -79,6 +106,10 @@ private:
     virtual void on_add_reception_metrics(const rtcp::ReceptionMetrics& metrics);
     virtual void on_add_link_metrics(const rtcp::LinkMetrics& metrics);
 
+    bool create_block_interleaver_(packet::IWriter& writer);
+    bool create_redundancy_controller_();
+    void apply_redundancy_();
+
     core::IAllocator& allocator_;
 
     const SenderConfig& config_;
@@ -92,9 +123,12 @@ private:
     core::Optional<packet::Router> router_;
 
     core::Optional<packet::Interleaver> interleaver_;
+    core::Optional<fec::BlockInterleaver> block_interleaver_;
 
     core::ScopedPtr<fec::IBlockEncoder> fec_encoder_;
     core::Optional<fec::Writer> fec_writer_;
+    core::Optional<fec::RlcWriter> rlc_writer_;
+    core::Optional<fec::RedundancyController> redundancy_controller_;
 
     core::ScopedPtr<audio::IFrameEncoder> payload_encoder_;
     core::Optional<audio::Packetizer> packetizer_;
@@ -108,6 +142,8 @@ private:
     core::Optional<rtcp::Composer> rtcp_composer_;
     core::Optional<rtcp::Session> rtcp_session_;
 
+    SenderEndpoint* control_endpoint_;
+
     audio::IFrameWriter* audio_writer_;
 
     size_t num_sources_;
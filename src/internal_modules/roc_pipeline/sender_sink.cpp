@@ -62,9 +62,16 @@ SenderSlot* SenderSink::create_slot() {
 
     roc_log(LogInfo, "sender sink: adding slot");
 
+    // With shared encoding, only the first slot encodes audio, and other slots
+    // send packets produced by it.
+    SenderSlot* primary_slot = NULL;
+    if (config_.shared_encoding) {
+        primary_slot = slots_.front().get();
+    }
+
     core::SharedPtr<SenderSlot> slot = new (allocator_)
-        SenderSlot(config_, format_map_, fanout_, packet_factory_, byte_buffer_factory_,
-                   sample_buffer_factory_, allocator_);
+        SenderSlot(config_, format_map_, fanout_, primary_slot, packet_factory_,
+                   byte_buffer_factory_, sample_buffer_factory_, allocator_);
 
     if (!slot) {
         roc_log(LogError, "sender sink: can't allocate slot");
@@ -105,7 +112,15 @@ sndio::DeviceState SenderSink::state() const {
 }
 
 void SenderSink::pause() {
-    // no-op
+    // no more frames will be written for a while, so send packets
+    // that are still buffered in pipeline instead of holding them
+    core::SharedPtr<SenderSlot> slot;
+
+    for (slot = slots_.front(); slot; slot = slots_.nextof(*slot)) {
+        slot->flush();
+    }
+
+    invalidate_update_deadline_();
 }
 
 bool SenderSink::resume() {
@@ -121,7 +136,15 @@ audio::SampleSpec SenderSink::sample_spec() const {
 }
 
 core::nanoseconds_t SenderSink::latency() const {
-    return 0;
+    core::SharedPtr<SenderSlot> slot;
+
+    core::nanoseconds_t latency = 0;
+
+    for (slot = slots_.front(); slot; slot = slots_.nextof(*slot)) {
+        latency = std::max(latency, slot->latency());
+    }
+
+    return latency;
 }
 
 bool SenderSink::has_clock() const {
@@ -42,6 +42,9 @@ namespace pipeline {
 //!  - one or more sender slots
 //!  - fanout, to duplicate audio to all slots
 //!
+//! If shared encoding is enabled, audio is encoded only by the first slot,
+//! and packets are shared by reference with endpoints of other slots.
+//!
 //! Pipeline:
 //!  - input: frames
 //!  - output: packets
@@ -74,6 +77,9 @@ public:
     virtual sndio::DeviceState state() const;
 
     //! Pause reading.
+    //! @remarks
+    //!  Writes packets buffered in pipeline of every slot, e.g. repair
+    //!  packets of FEC blocks being encoded in background.
     virtual void pause();
 
     //! Resume paused reading.
@@ -17,6 +17,7 @@ namespace pipeline {
 SenderSlot::SenderSlot(const SenderConfig& config,
                        const rtp::FormatMap& format_map,
                        audio::Fanout& fanout,
+                       SenderSlot* primary_slot,
                        packet::PacketFactory& packet_factory,
                        core::BufferFactory<uint8_t>& byte_buffer_factory,
                        core::BufferFactory<audio::sample_t>& sample_buffer_factory,
@@ -24,6 +25,8 @@ SenderSlot::SenderSlot(const SenderConfig& config,
     : RefCounted(allocator)
     , config_(config)
     , fanout_(fanout)
+    , primary_slot_(primary_slot)
+    , packet_factory_(packet_factory)
     , session_(config,
                format_map,
                packet_factory,
@@ -66,6 +69,12 @@ SenderEndpoint* SenderSlot::create_endpoint(address::Interface iface,
     switch (iface) {
     case address::Iface_AudioSource:
     case address::Iface_AudioRepair:
+        if (primary_slot_) {
+            if (!attach_to_primary_(iface, *endpoint)) {
+                return NULL;
+            }
+            break;
+        }
         if (source_endpoint_
             && (repair_endpoint_ || config_.fec_encoder.scheme == packet::FEC_None)) {
             if (!session_.create_transport_pipeline(source_endpoint_.get(),
@@ -100,10 +109,20 @@ audio::IFrameWriter* SenderSlot::writer() {
 }
 
 bool SenderSlot::is_ready() const {
+    if (primary_slot_) {
+        return primary_slot_->is_ready() && source_endpoint_
+            && source_endpoint_->has_destination_writer()
+            && (!repair_endpoint_ || repair_endpoint_->has_destination_writer());
+    }
+
     return session_.writer() && source_endpoint_->has_destination_writer()
         && (!repair_endpoint_ || repair_endpoint_->has_destination_writer());
 }
 
+core::nanoseconds_t SenderSlot::latency() const {
+    return session_.latency();
+}
+
 core::nanoseconds_t SenderSlot::get_update_deadline() const {
     return session_.get_update_deadline();
 }
@@ -112,6 +131,10 @@ void SenderSlot::update() {
     session_.update();
 }
 
+void SenderSlot::flush() {
+    session_.flush();
+}
+
 SenderEndpoint* SenderSlot::create_source_endpoint_(address::Protocol proto) {
     if (source_endpoint_) {
         roc_log(LogError, "sender slot: audio source endpoint is already set");
@@ -133,7 +156,8 @@ SenderEndpoint* SenderSlot::create_source_endpoint_(address::Protocol proto) {
         return NULL;
     }
 
-    source_endpoint_.reset(new (source_endpoint_) SenderEndpoint(proto, allocator()));
+    source_endpoint_.reset(new (source_endpoint_)
+                            SenderEndpoint(proto, packet_factory_, allocator()));
     if (!source_endpoint_ || !source_endpoint_->valid()) {
         roc_log(LogError, "sender slot: can't create source endpoint");
         source_endpoint_.reset(NULL);
@@ -164,7 +188,8 @@ SenderEndpoint* SenderSlot::create_repair_endpoint_(address::Protocol proto) {
         return NULL;
     }
 
-    repair_endpoint_.reset(new (repair_endpoint_) SenderEndpoint(proto, allocator()));
+    repair_endpoint_.reset(new (repair_endpoint_)
+                            SenderEndpoint(proto, packet_factory_, allocator()));
     if (!repair_endpoint_ || !repair_endpoint_->valid()) {
         roc_log(LogError, "sender slot: can't create repair endpoint");
         repair_endpoint_.reset(NULL);
@@ -184,7 +209,8 @@ SenderEndpoint* SenderSlot::create_control_endpoint_(address::Protocol proto) {
         return NULL;
     }
 
-    control_endpoint_.reset(new (control_endpoint_) SenderEndpoint(proto, allocator()));
+    control_endpoint_.reset(new (control_endpoint_)
+                            SenderEndpoint(proto, packet_factory_, allocator()));
     if (!control_endpoint_ || !control_endpoint_->valid()) {
         roc_log(LogError, "sender slot: can't create control endpoint");
         control_endpoint_.reset(NULL);
@@ -194,5 +220,37 @@ SenderEndpoint* SenderSlot::create_control_endpoint_(address::Protocol proto) {
     return control_endpoint_.get();
 }
 
+bool SenderSlot::attach_to_primary_(address::Interface iface,
+                                    SenderEndpoint& endpoint) {
+    SenderEndpoint* primary_endpoint = NULL;
+
+    switch (iface) {
+    case address::Iface_AudioSource:
+        primary_endpoint = primary_slot_->source_endpoint_.get();
+        break;
+    case address::Iface_AudioRepair:
+        primary_endpoint = primary_slot_->repair_endpoint_.get();
+        break;
+    default:
+        break;
+    }
+
+    if (!primary_endpoint) {
+        roc_log(LogError,
+                "sender slot: can't share encoding: primary slot has no %s endpoint",
+                address::interface_to_str(iface));
+    } else if (primary_endpoint->add_mirror(endpoint)) {
+        return true;
+    }
+
+    if (iface == address::Iface_AudioSource) {
+        source_endpoint_.reset(NULL);
+    } else {
+        repair_endpoint_.reset(NULL);
+    }
+
+    return false;
+}
+
 } // namespace pipeline
 } // namespace roc
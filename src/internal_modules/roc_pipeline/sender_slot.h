@@ -33,6 +33,11 @@ namespace pipeline {
 //! Contains:
 //!  - one or more related sender endpoints, one per each type
 //!  - one session associated with those endpoints
+//!
+//! If the slot is created with a primary slot, it doesn't encode audio by
+//! itself; instead, its source and repair endpoints are attached as mirrors
+//! to the endpoints of the primary slot, so that packets encoded once by the
+//! primary slot are sent to the endpoints of both slots.
 class SenderSlot : public core::RefCounted<SenderSlot, core::StandardAllocation>,
                    public core::ListNode {
     typedef core::RefCounted<SenderSlot, core::StandardAllocation> RefCounted;
@@ -42,6 +47,7 @@ public:
     SenderSlot(const SenderConfig& config,
                const rtp::FormatMap& format_map,
                audio::Fanout& fanout,
+               SenderSlot* primary_slot,
                packet::PacketFactory& packet_factory,
                core::BufferFactory<uint8_t>& byte_buffer_factory,
                core::BufferFactory<audio::sample_t>& sample_buffer_factory,
@@ -57,21 +63,33 @@ public:
     //! Check if slot configuration is done.
     bool is_ready() const;
 
+    //! Get latency added by slot.
+    core::nanoseconds_t latency() const;
+
     //! Get deadline when the pipeline should be updated.
     core::nanoseconds_t get_update_deadline() const;
 
     //! Update pipeline.
     void update();
 
+    //! Write all packets buffered in pipeline.
+    void flush();
+
 private:
     SenderEndpoint* create_source_endpoint_(address::Protocol proto);
     SenderEndpoint* create_repair_endpoint_(address::Protocol proto);
     SenderEndpoint* create_control_endpoint_(address::Protocol proto);
 
+    bool attach_to_primary_(address::Interface iface, SenderEndpoint& endpoint);
+
     const SenderConfig& config_;
 
     audio::Fanout& fanout_;
 
+    SenderSlot* primary_slot_;
+
+    packet::PacketFactory& packet_factory_;
+
     core::Optional<SenderEndpoint> source_endpoint_;
     core::Optional<SenderEndpoint> repair_endpoint_;
     core::Optional<SenderEndpoint> control_endpoint_;
@@ -38,12 +38,23 @@ struct ReceptionMetrics {
     //! To which source there metrics apply.
     packet::source_t ssrc;
 
-    //! Fraction of lost packets.
+    //! Fraction of packets lost since previous report.
     float fract_loss;
 
+    //! Cumulative number of packets lost since the beginning of reception.
+    int64_t cum_loss;
+
+    //! Extended highest sequence number received.
+    //! @remarks
+    //!  Lower 16 bits contain the sequence number, higher bits contain the
+    //!  count of sequence number cycles.
+    uint32_t ext_last_seqnum;
+
     ReceptionMetrics()
         : ssrc(0)
-        , fract_loss(0) {
+        , fract_loss(0)
+        , cum_loss(0)
+        , ext_last_seqnum(0) {
     }
 };
 
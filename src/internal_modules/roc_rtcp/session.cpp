@@ -208,6 +208,8 @@ void Session::parse_reception_block_(const header::ReceptionReportBlock& blk) {
     ReceptionMetrics metrics;
     metrics.ssrc = blk.ssrc();
     metrics.fract_loss = blk.fract_loss();
+    metrics.cum_loss = blk.cumloss();
+    metrics.ext_last_seqnum = blk.last_seqnum();
 
     if (send_hooks_) {
         send_hooks_->on_add_reception_metrics(metrics);
@@ -354,6 +356,20 @@ Session::build_reception_block_(const ReceptionMetrics& metrics) {
 
     blk.set_ssrc(metrics.ssrc);
 
+    // fraction is stored in Q.8 format
+    blk.set_fract_loss((ssize_t)(metrics.fract_loss * 256 + 0.5f), 256);
+
+    // cumulative loss is stored as 24-bit signed integer
+    int64_t cum_loss = metrics.cum_loss;
+    if (cum_loss > 0x7FFFFF) {
+        cum_loss = 0x7FFFFF;
+    } else if (cum_loss < -0x800000) {
+        cum_loss = -0x800000;
+    }
+    blk.set_cumloss((int32_t)cum_loss);
+
+    blk.set_last_seqnum(metrics.ext_last_seqnum);
+
     return blk;
 }
 
@@ -213,6 +213,35 @@ typedef enum roc_protocol {
      */
     ROC_PROTO_LDPC_REPAIR = 33,
 
+    /** RTP source packet (RFC 3550) + FECFRAME RLC footer (RFC 8681).
+     *
+     * Interfaces:
+     *  - \ref ROC_INTERFACE_AUDIO_SOURCE
+     *
+     * Transports:
+     *  - UDP
+     *
+     * Audio encodings:
+     *  - similar to \ref ROC_PROTO_RTP
+     *
+     * FEC encodings:
+     *  - \ref ROC_FEC_ENCODING_RLC
+     */
+    ROC_PROTO_RTP_RLC_SOURCE = 34,
+
+    /** FEC repair packet + FECFRAME RLC header (RFC 8681).
+     *
+     * Interfaces:
+     *  - \ref ROC_INTERFACE_AUDIO_REPAIR
+     *
+     * Transports:
+     *  - UDP
+     *
+     * FEC encodings:
+     *  - \ref ROC_FEC_ENCODING_RLC
+     */
+    ROC_PROTO_RLC_REPAIR = 35,
+
     /** RTCP over UDP (RFC 3550).
      *
      * Interfaces:
@@ -248,7 +277,16 @@ typedef enum roc_fec_encoding {
      * Compatible with \ref ROC_PROTO_RTP_LDPC_SOURCE and \ref ROC_PROTO_LDPC_REPAIR
      * protocols for source and repair endpoints.
      */
-    ROC_FEC_ENCODING_LDPC_STAIRCASE = 2
+    ROC_FEC_ENCODING_LDPC_STAIRCASE = 2,
+
+    /** Sliding window Random Linear Codes FEC encoding (RFC 8681).
+     * Good for low latency: a lost packet can be repaired after the encoding
+     * window instead of the whole block. Source and repair block sizes define
+     * window length and number of repair packets per window length.
+     * Compatible with \ref ROC_PROTO_RTP_RLC_SOURCE and \ref ROC_PROTO_RLC_REPAIR
+     * protocols for source and repair endpoints.
+     */
+    ROC_FEC_ENCODING_RLC = 3
 } roc_fec_encoding;
 
 /** Packet encoding. */
@@ -456,6 +494,25 @@ typedef struct roc_sender_config {
      * If zero, default value is used.
      */
     unsigned int fec_block_repair_packets;
+
+    /** Enable packet pacing.
+     * If non-zero, the sender spreads packets evenly over time instead of sending
+     * them in bursts, e.g. when a FEC block is completed and all its repair packets
+     * are produced at once. This may reduce losses on Wi-Fi and rate-limited links,
+     * but also slightly increases latency.
+     */
+    unsigned int packet_pacing;
+
+    /** Number of FEC blocks which packets are interleaved with each other.
+     * If non-zero, the sender reorders packets of this many consecutive FEC blocks,
+     * so that a burst of lost packets is spread over several blocks and is more
+     * likely to be repaired. Takes precedence over \c packet_interleaving.
+     * Not supported with ROC_FEC_ENCODING_RLC.
+     * Increases latency; the added latency is reported in \c roc_sender_metrics
+     * and should be set as \c fec_interleaving_latency on receiver.
+     * If zero, FEC block interleaving is disabled.
+     */
+    unsigned int fec_interleaving_span;
 } roc_sender_config;
 
 /** Receiver configuration.
@@ -546,6 +603,23 @@ typedef struct roc_receiver_config {
      * \see broken_playback_timeout.
      */
     unsigned long long breakage_detection_window;
+
+    /** Latency added by FEC block interleaving on sender, in nanoseconds.
+     * Should match \c latency reported in \c roc_sender_metrics. FEC can repair
+     * a block only when packets of all interleaved blocks are received, so the
+     * session doesn't start playing until this much is accumulated, and the
+     * target latency should be larger than this value.
+     * If zero, sender is assumed to not use FEC block interleaving.
+     */
+    unsigned long long fec_interleaving_latency;
+
+    /** Enable incremental FEC decoding.
+     * If non-zero, every received packet is passed to FEC decoder as soon as it
+     * arrives, and lost packets are repaired as soon as enough packets of the block
+     * are received, instead of when playback reaches the first lost packet. This
+     * spreads decoding work over time and makes repaired packets available earlier.
+     */
+    unsigned int fec_incremental_decoding;
 } roc_receiver_config;
 
 #ifdef __cplusplus
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * \file roc/metrics.h
+ * \brief Metrics.
+ */
+
+#ifndef ROC_METRICS_H_
+#define ROC_METRICS_H_
+
+#include "roc/platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Metrics of a receiver session.
+ *
+ * Receiver creates a session for every sender connected to a slot. Metrics of the
+ * session are updated after every frame produced by the receiver.
+ *
+ * **Thread safety**
+ *
+ * Should not be used concurrently.
+ */
+typedef struct roc_session_metrics {
+    /** Current latency, in nanoseconds.
+     * Defines how much samples are currently buffered in the session queue.
+     */
+    unsigned long long latency;
+
+    /** Target latency, in nanoseconds.
+     * Receiver adjusts playback speed to keep latency close to this value.
+     */
+    unsigned long long target_latency;
+
+    /** Current resampler scaling factor.
+     * Values above 1.0 mean that the session is played faster to reduce latency,
+     * and values below 1.0 mean that it's played slower.
+     */
+    float scaling;
+
+    /** Interarrival jitter, in nanoseconds.
+     * Calculated as defined in RFC 3550.
+     */
+    unsigned long long jitter;
+
+    /** Number of source packets received. */
+    unsigned long long packets_received;
+
+    /** Number of source packets lost in network. */
+    unsigned long long packets_lost;
+
+    /** Number of source packets that arrived too late to be played. */
+    unsigned long long packets_late;
+
+    /** Number of lost source packets restored using FEC. */
+    unsigned long long packets_recovered;
+
+    /** Average time spent on producing one frame of the session, in nanoseconds. */
+    unsigned long long frame_processing_time;
+
+    /** Time from session creation until playback start, in nanoseconds.
+     * Zero if playback didn't start yet.
+     */
+    unsigned long long time_to_first_audio;
+} roc_session_metrics;
+
+/** Metrics of a receiver.
+ *
+ * **Thread safety**
+ *
+ * Should not be used concurrently.
+ */
+typedef struct roc_receiver_metrics {
+    /** Number of active sessions in all slots. */
+    unsigned int num_sessions;
+
+    /** Total number of frames produced by receiver. */
+    unsigned long long frames_processed;
+
+    /** Number of frames that took longer to produce than their duration.
+     * Non-zero value means that the receiver can't keep up with real time.
+     */
+    unsigned long long frame_deadline_misses;
+
+    /** Total number of pipeline tasks processed. */
+    unsigned long long tasks_processed;
+
+    /** Number of packets received by busy polling threads of the slot.
+     * Non-zero only if busy polling is enabled for receiver ports.
+     */
+    unsigned long long busy_poll_packets;
+
+    /** Number of packets received while busy polling thread was spinning.
+     * Each such packet would otherwise require an event loop wakeup.
+     */
+    unsigned long long busy_poll_spin_packets;
+
+    /** Number of packets received right after busy polling thread was unparked.
+     */
+    unsigned long long busy_poll_parked_packets;
+
+    /** Average delivery delay of packets received while spinning, in nanoseconds.
+     * Delivery delay is the time between kernel receive timestamp and the
+     * moment when the packet was read from socket.
+     */
+    unsigned long long busy_poll_spin_delay;
+
+    /** Average delivery delay of packets received after unparking, in nanoseconds.
+     */
+    unsigned long long busy_poll_parked_delay;
+} roc_receiver_metrics;
+
+/** Metrics of a sender.
+ *
+ * **Thread safety**
+ *
+ * Should not be used concurrently.
+ */
+typedef struct roc_sender_metrics {
+    /** Total number of frames consumed by sender. */
+    unsigned long long frames_processed;
+
+    /** Number of frames that took longer to process than their duration.
+     * Non-zero value means that the sender can't keep up with real time.
+     */
+    unsigned long long frame_deadline_misses;
+
+    /** Total number of pipeline tasks processed. */
+    unsigned long long tasks_processed;
+
+    /** Number of sender sockets connected to their remote address.
+     * Sender connects socket when all its packets go to the same address.
+     * Connected socket reports delivery errors from remote peer.
+     */
+    unsigned int connected_ports;
+
+    /** Number of packets refused by remote peer.
+     * Non-zero value usually means that nobody listens on the remote port.
+     * Counted only for connected sockets.
+     */
+    unsigned long long packets_refused;
+
+    /** Number of packets for which remote host or network was unreachable.
+     * Counted only for connected sockets.
+     */
+    unsigned long long packets_unreachable;
+
+    /** Number of packets sent via pacing queue.
+     * Non-zero only if \c packet_pacing is enabled in sender config.
+     */
+    unsigned long long packets_paced;
+
+    /** Maximum number of packets waiting in pacing queue of a socket.
+     * Growing value means that packets are produced faster than paced.
+     */
+    unsigned int max_pacing_queue;
+
+    /** Maximum deviation of packet send time from scheduled one, in nanoseconds.
+     */
+    unsigned long long max_pacing_deviation;
+
+    /** Latency added by sender, in nanoseconds.
+     * Non-zero if FEC block interleaving is enabled. Receiver should set
+     * \c fec_interleaving_latency in its config to this value.
+     */
+    unsigned long long latency;
+} roc_sender_metrics;
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* ROC_METRICS_H_ */
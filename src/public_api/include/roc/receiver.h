@@ -18,6 +18,7 @@
 #include "roc/context.h"
 #include "roc/endpoint.h"
 #include "roc/frame.h"
+#include "roc/metrics.h"
 #include "roc/platform.h"
 
 #ifdef __cplusplus
@@ -335,6 +336,38 @@ ROC_API int roc_receiver_bind(roc_receiver* receiver,
  */
 ROC_API int roc_receiver_read(roc_receiver* receiver, roc_frame* frame);
 
+/** Query receiver metrics.
+ *
+ * Reports metrics of the whole receiver, and metrics of every session (connected
+ * sender) of the given slot.
+ *
+ * Session metrics are written to \p sess_metrics array, which should have room for
+ * \p *sess_metrics_size elements. After the call, \p *sess_metrics_size is set to the
+ * number of sessions in the slot; if it's larger than the array size, only the first
+ * sessions are reported, and the user may repeat the call with a larger array.
+ *
+ * **Parameters**
+ *  - \p receiver should point to an opened receiver
+ *  - \p slot specifies the slot identifier
+ *  - \p recv_metrics should point to a metrics struct to be filled
+ *  - \p sess_metrics should point to an array of session metrics, or be NULL if
+ *    \p *sess_metrics_size is zero
+ *  - \p sess_metrics_size should point to the array size
+ *
+ * **Returns**
+ *  - returns zero if the metrics were successfully retrieved
+ *  - returns a negative value if the arguments are invalid
+ *  - returns a negative value if the slot doesn't exist
+ *
+ * **Ownership**
+ *  - doesn't take or share the ownership of the provided buffers
+ */
+ROC_API int roc_receiver_query(roc_receiver* receiver,
+                               roc_slot slot,
+                               roc_receiver_metrics* recv_metrics,
+                               roc_session_metrics* sess_metrics,
+                               size_t* sess_metrics_size);
+
 /** Close the receiver.
  *
  * Deinitializes and deallocates the receiver, and detaches it from the context. The user
@@ -11,6 +11,7 @@
 #include "roc_audio/resampler_profile.h"
 #include "roc_core/attributes.h"
 #include "roc_core/log.h"
+#include "roc_fec/block_interleaver.h"
 
 namespace roc {
 namespace api {
@@ -67,6 +68,7 @@ bool sender_config_from_user(pipeline::SenderConfig& out, const roc_sender_confi
     }
 
     out.interleaving = in.packet_interleaving;
+    out.pacing = in.packet_pacing;
     out.timing = (in.clock_source == ROC_CLOCK_INTERNAL);
 
     out.resampling = (in.resampler_profile != ROC_RESAMPLER_PROFILE_DISABLE);
@@ -115,6 +117,9 @@ bool sender_config_from_user(pipeline::SenderConfig& out, const roc_sender_confi
     case ROC_FEC_ENCODING_LDPC_STAIRCASE:
         out.fec_encoder.scheme = packet::FEC_LDPC_Staircase;
         break;
+    case ROC_FEC_ENCODING_RLC:
+        out.fec_encoder.scheme = packet::FEC_RLC;
+        break;
     default:
         roc_log(LogError, "bad configuration: invalid fec_scheme");
         return false;
@@ -125,6 +130,25 @@ bool sender_config_from_user(pipeline::SenderConfig& out, const roc_sender_confi
         out.fec_writer.n_repair_packets = in.fec_block_repair_packets;
     }
 
+    if (in.fec_interleaving_span != 0) {
+        if (in.fec_interleaving_span > fec::BlockInterleaver::MaxSpan) {
+            roc_log(LogError,
+                    "bad configuration: invalid fec_interleaving_span, should be <= %lu",
+                    (unsigned long)fec::BlockInterleaver::MaxSpan);
+            return false;
+        }
+
+        if (out.fec_encoder.scheme == packet::FEC_RLC) {
+            roc_log(LogError,
+                    "bad configuration:"
+                    " fec_interleaving_span is not supported with RLC encoding");
+            return false;
+        }
+
+        out.fec_interleaver.enabled = true;
+        out.fec_interleaver.span = in.fec_interleaving_span;
+    }
+
     return true;
 }
 
@@ -234,6 +258,13 @@ bool receiver_config_from_user(pipeline::ReceiverConfig& out,
             (core::nanoseconds_t)in.breakage_detection_window;
     }
 
+    if (in.fec_interleaving_latency != 0) {
+        out.default_session.fec_interleaving_latency =
+            (core::nanoseconds_t)in.fec_interleaving_latency;
+    }
+
+    out.default_session.fec_reader.incremental_decoding = in.fec_incremental_decoding;
+
     return true;
 }
 
@@ -287,6 +318,14 @@ bool proto_from_user(address::Protocol& out, const roc_protocol& in) {
         out = address::Proto_LDPC_Repair;
         return true;
 
+    case ROC_PROTO_RTP_RLC_SOURCE:
+        out = address::Proto_RTP_RLC_Source;
+        return true;
+
+    case ROC_PROTO_RLC_REPAIR:
+        out = address::Proto_RLC_Repair;
+        return true;
+
     case ROC_PROTO_RTCP:
         out = address::Proto_RTCP;
         return true;
@@ -325,6 +364,14 @@ bool proto_to_user(roc_protocol& out, address::Protocol in) {
         out = ROC_PROTO_LDPC_REPAIR;
         return true;
 
+    case address::Proto_RTP_RLC_Source:
+        out = ROC_PROTO_RTP_RLC_SOURCE;
+        return true;
+
+    case address::Proto_RLC_Repair:
+        out = ROC_PROTO_RLC_REPAIR;
+        return true;
+
     case address::Proto_RTCP:
         out = ROC_PROTO_RTCP;
         return true;
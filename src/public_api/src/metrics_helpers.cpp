@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "metrics_helpers.h"
+
+namespace roc {
+namespace api {
+
+namespace {
+
+unsigned long long duration_to_user(core::nanoseconds_t duration) {
+    return duration > 0 ? (unsigned long long)duration : 0;
+}
+
+} // namespace
+
+void receiver_metrics_to_user(roc_receiver_metrics& out,
+                              const pipeline::ReceiverMetrics& in,
+                              const peer::ReceiverPortMetrics& port_in) {
+    out.num_sessions = (unsigned int)in.num_sessions;
+    out.frames_processed = (unsigned long long)in.pipeline.frames_processed;
+    out.frame_deadline_misses = (unsigned long long)in.pipeline.frame_deadline_misses;
+    out.tasks_processed = (unsigned long long)in.pipeline.task_processed_total;
+    out.busy_poll_packets = (unsigned long long)port_in.busy_poll_packets;
+    out.busy_poll_spin_packets = (unsigned long long)port_in.busy_poll_spin_packets;
+    out.busy_poll_parked_packets = (unsigned long long)port_in.busy_poll_parked_packets;
+    out.busy_poll_spin_delay = duration_to_user(port_in.busy_poll_spin_delay);
+    out.busy_poll_parked_delay = duration_to_user(port_in.busy_poll_parked_delay);
+}
+
+void session_metrics_to_user(const pipeline::ReceiverSessionMetrics& in,
+                             size_t sess_index,
+                             void* sess_metrics_arg) {
+    roc_session_metrics& out = ((roc_session_metrics*)sess_metrics_arg)[sess_index];
+
+    out.latency = duration_to_user(in.latency);
+    out.target_latency = duration_to_user(in.target_latency);
+    out.scaling = in.scaling;
+    out.jitter = duration_to_user(in.jitter);
+    out.packets_received = (unsigned long long)in.packets_received;
+    out.packets_lost = (unsigned long long)in.packets_lost;
+    out.packets_late = (unsigned long long)in.packets_late;
+    out.packets_recovered = (unsigned long long)in.packets_recovered;
+    out.frame_processing_time = duration_to_user(in.frame_processing_time);
+    out.time_to_first_audio = duration_to_user(in.time_to_first_audio);
+}
+
+void sender_metrics_to_user(roc_sender_metrics& out,
+                            const pipeline::SenderMetrics& in,
+                            const peer::SenderPortMetrics& port_in) {
+    out.frames_processed = (unsigned long long)in.pipeline.frames_processed;
+    out.frame_deadline_misses = (unsigned long long)in.pipeline.frame_deadline_misses;
+    out.tasks_processed = (unsigned long long)in.pipeline.task_processed_total;
+    out.connected_ports = (unsigned int)port_in.num_connected_ports;
+    out.packets_refused = (unsigned long long)port_in.packets_refused;
+    out.packets_unreachable = (unsigned long long)port_in.packets_unreachable;
+    out.packets_paced = (unsigned long long)port_in.packets_paced;
+    out.max_pacing_queue = (unsigned int)port_in.max_pacing_queue_size;
+    out.max_pacing_deviation = duration_to_user(port_in.max_pacing_deviation);
+    out.latency = duration_to_user(in.latency);
+}
+
+} // namespace api
+} // namespace roc
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ROC_PUBLIC_API_METRICS_HELPERS_H_
+#define ROC_PUBLIC_API_METRICS_HELPERS_H_
+
+#include "roc/metrics.h"
+
+#include "roc_peer/receiver.h"
+#include "roc_peer/sender.h"
+#include "roc_pipeline/metrics.h"
+
+namespace roc {
+namespace api {
+
+void receiver_metrics_to_user(roc_receiver_metrics& out,
+                              const pipeline::ReceiverMetrics& in,
+                              const peer::ReceiverPortMetrics& port_in);
+
+// Matches pipeline::ReceiverSessionMetricsFunc.
+// sess_metrics_arg should point to array of roc_session_metrics.
+void session_metrics_to_user(const pipeline::ReceiverSessionMetrics& sess_metrics,
+                             size_t sess_index,
+                             void* sess_metrics_arg);
+
+void sender_metrics_to_user(roc_sender_metrics& out,
+                            const pipeline::SenderMetrics& in,
+                            const peer::SenderPortMetrics& port_in);
+
+} // namespace api
+} // namespace roc
+
+#endif // ROC_PUBLIC_API_METRICS_HELPERS_H_
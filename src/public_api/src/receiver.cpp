@@ -9,6 +9,7 @@
 #include "roc/receiver.h"
 
 #include "config_helpers.h"
+#include "metrics_helpers.h"
 
 #include "roc_core/log.h"
 #include "roc_core/scoped_ptr.h"
@@ -208,6 +209,52 @@ int roc_receiver_read(roc_receiver* receiver, roc_frame* frame) {
     return 0;
 }
 
+int roc_receiver_query(roc_receiver* receiver,
+                       roc_slot slot,
+                       roc_receiver_metrics* recv_metrics,
+                       roc_session_metrics* sess_metrics,
+                       size_t* sess_metrics_size) {
+    if (!receiver) {
+        roc_log(LogError, "roc_receiver_query(): invalid arguments: receiver is null");
+        return -1;
+    }
+
+    peer::Receiver* imp_receiver = (peer::Receiver*)receiver;
+
+    if (!recv_metrics) {
+        roc_log(LogError,
+                "roc_receiver_query(): invalid arguments: receiver metrics is null");
+        return -1;
+    }
+
+    if (!sess_metrics_size) {
+        roc_log(LogError,
+                "roc_receiver_query(): invalid arguments: session metrics size is null");
+        return -1;
+    }
+
+    if (!sess_metrics && *sess_metrics_size != 0) {
+        roc_log(LogError,
+                "roc_receiver_query(): invalid arguments: session metrics is null");
+        return -1;
+    }
+
+    pipeline::ReceiverMetrics imp_recv_metrics;
+    peer::ReceiverPortMetrics imp_port_metrics;
+
+    // session metrics are written directly to user array
+    if (!imp_receiver->get_metrics(slot, imp_recv_metrics, imp_port_metrics,
+                                   api::session_metrics_to_user, sess_metrics_size,
+                                   sess_metrics)) {
+        roc_log(LogError, "roc_receiver_query(): operation failed");
+        return -1;
+    }
+
+    api::receiver_metrics_to_user(*recv_metrics, imp_recv_metrics, imp_port_metrics);
+
+    return 0;
+}
+
 int roc_receiver_close(roc_receiver* receiver) {
     if (!receiver) {
         roc_log(LogError, "roc_receiver_close(): invalid arguments: receiver is null");
@@ -9,6 +9,7 @@
 #include "roc/sender.h"
 
 #include "config_helpers.h"
+#include "metrics_helpers.h"
 
 #include "roc_core/log.h"
 #include "roc_core/scoped_ptr.h"
@@ -201,6 +202,29 @@ int roc_sender_write(roc_sender* sender, const roc_frame* frame) {
     return 0;
 }
 
+int roc_sender_query(roc_sender* sender, roc_sender_metrics* send_metrics) {
+    if (!sender) {
+        roc_log(LogError, "roc_sender_query(): invalid arguments: sender is null");
+        return -1;
+    }
+
+    peer::Sender* imp_sender = (peer::Sender*)sender;
+
+    if (!send_metrics) {
+        roc_log(LogError,
+                "roc_sender_query(): invalid arguments: sender metrics is null");
+        return -1;
+    }
+
+    pipeline::SenderMetrics imp_send_metrics;
+    peer::SenderPortMetrics imp_port_metrics;
+    imp_sender->get_metrics(imp_send_metrics, imp_port_metrics);
+
+    api::sender_metrics_to_user(*send_metrics, imp_send_metrics, imp_port_metrics);
+
+    return 0;
+}
+
 int roc_sender_close(roc_sender* sender) {
     if (!sender) {
         roc_log(LogError, "roc_sender_close(): invalid arguments: sender is null");
@@ -111,6 +111,15 @@ public:
         return repair_endp_[slot];
     }
 
+    void query(roc_receiver_metrics& recv_metrics,
+               roc_session_metrics* sess_metrics,
+               size_t& sess_metrics_size,
+               roc_slot slot = ROC_SLOT_DEFAULT) {
+        CHECK(roc_receiver_query(recv_, slot, &recv_metrics, sess_metrics,
+                                 &sess_metrics_size)
+              == 0);
+    }
+
     void receive() {
         float rx_buff[MaxBufSize];
 
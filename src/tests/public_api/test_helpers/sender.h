@@ -61,6 +61,10 @@ public:
         }
     }
 
+    void query(roc_sender_metrics& send_metrics) {
+        CHECK(roc_sender_query(sndr_, &send_metrics) == 0);
+    }
+
     void stop() {
         stopped_ = true;
     }
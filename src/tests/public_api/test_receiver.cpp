@@ -8,6 +8,12 @@
 
 #include <CppUTest/TestHarness.h>
 
+#include "test_helpers/context.h"
+#include "test_helpers/proxy.h"
+#include "test_helpers/receiver.h"
+#include "test_helpers/sender.h"
+
+#include "roc_core/macro_helpers.h"
 #include "roc_core/stddefs.h"
 
 #include "roc/receiver.h"
@@ -15,6 +21,14 @@
 namespace roc {
 namespace api {
 
+namespace {
+
+core::HeapAllocator allocator;
+packet::PacketFactory packet_factory(allocator, true);
+core::BufferFactory<uint8_t> byte_buffer_factory(allocator, test::MaxBufSize, true);
+
+} // namespace
+
 TEST_GROUP(receiver) {
     roc_receiver_config receiver_config;
 
@@ -411,6 +425,122 @@ TEST(receiver, reuseaddr_slots) {
     LONGS_EQUAL(0, roc_receiver_close(receiver));
 }
 
+TEST(receiver, query) {
+    roc_receiver* receiver = NULL;
+    CHECK(roc_receiver_open(context, &receiver_config, &receiver) == 0);
+    CHECK(receiver);
+
+    roc_endpoint* source_endpoint = NULL;
+    CHECK(roc_endpoint_allocate(&source_endpoint) == 0);
+    CHECK(roc_endpoint_set_uri(source_endpoint, "rtp://127.0.0.1:0") == 0);
+
+    CHECK(roc_receiver_bind(receiver, ROC_SLOT_DEFAULT, ROC_INTERFACE_AUDIO_SOURCE,
+                            source_endpoint)
+          == 0);
+
+    roc_receiver_metrics recv_metrics;
+    memset(&recv_metrics, 0xff, sizeof(recv_metrics));
+
+    roc_session_metrics sess_metrics[2];
+    size_t sess_metrics_size = ROC_ARRAY_SIZE(sess_metrics);
+
+    CHECK(roc_receiver_query(receiver, ROC_SLOT_DEFAULT, &recv_metrics, sess_metrics,
+                             &sess_metrics_size)
+          == 0);
+
+    LONGS_EQUAL(0, recv_metrics.num_sessions);
+    LONGS_EQUAL(0, sess_metrics_size);
+
+    // busy polling is disabled
+    LONGS_EQUAL(0, recv_metrics.busy_poll_packets);
+    LONGS_EQUAL(0, recv_metrics.busy_poll_spin_packets);
+    LONGS_EQUAL(0, recv_metrics.busy_poll_parked_packets);
+    LONGS_EQUAL(0, recv_metrics.busy_poll_spin_delay);
+    LONGS_EQUAL(0, recv_metrics.busy_poll_parked_delay);
+
+    sess_metrics_size = 0;
+
+    CHECK(roc_receiver_query(receiver, ROC_SLOT_DEFAULT, &recv_metrics, NULL,
+                             &sess_metrics_size)
+          == 0);
+
+    LONGS_EQUAL(0, sess_metrics_size);
+
+    CHECK(roc_endpoint_deallocate(source_endpoint) == 0);
+
+    LONGS_EQUAL(0, roc_receiver_close(receiver));
+}
+
+TEST(receiver, query_session) {
+    enum { Flags = test::FlagRS8M };
+
+    const float sample_step = 1. / 32768.;
+
+    roc_sender_config sender_conf;
+    memset(&sender_conf, 0, sizeof(sender_conf));
+    sender_conf.frame_sample_rate = test::SampleRate;
+    sender_conf.frame_channels = ROC_CHANNEL_SET_STEREO;
+    sender_conf.frame_encoding = ROC_FRAME_ENCODING_PCM_FLOAT;
+    sender_conf.clock_source = ROC_CLOCK_INTERNAL;
+    sender_conf.resampler_profile = ROC_RESAMPLER_PROFILE_DISABLE;
+    sender_conf.packet_length =
+        test::PacketSamples * 1000000000ul / (test::SampleRate * test::NumChans);
+    sender_conf.fec_encoding = ROC_FEC_ENCODING_RS8M;
+    sender_conf.fec_block_source_packets = test::SourcePackets;
+    sender_conf.fec_block_repair_packets = test::RepairPackets;
+
+    receiver_config.frame_sample_rate = test::SampleRate;
+    receiver_config.clock_source = ROC_CLOCK_INTERNAL;
+    receiver_config.resampler_profile = ROC_RESAMPLER_PROFILE_DISABLE;
+    receiver_config.target_latency = test::Latency * 1000000000ul / test::SampleRate;
+    receiver_config.no_playback_timeout =
+        test::Timeout * 1000000000ul / test::SampleRate;
+
+    test::Context test_context;
+
+    test::Receiver receiver(test_context, receiver_config, sample_step,
+                            test::FrameSamples);
+
+    receiver.bind(Flags);
+
+    // proxy drops one source packet of every block
+    test::Proxy proxy(receiver.source_endpoint(), receiver.repair_endpoint(),
+                      test::SourcePackets, test::RepairPackets, allocator, packet_factory,
+                      byte_buffer_factory);
+
+    test::Sender sender(test_context, sender_conf, sample_step, test::FrameSamples);
+
+    sender.connect(proxy.source_endpoint(), proxy.repair_endpoint(), Flags);
+
+    sender.start();
+    receiver.receive();
+
+    roc_receiver_metrics recv_metrics;
+    memset(&recv_metrics, 0, sizeof(recv_metrics));
+
+    roc_session_metrics sess_metrics[2];
+    memset(sess_metrics, 0, sizeof(sess_metrics));
+
+    size_t sess_metrics_size = ROC_ARRAY_SIZE(sess_metrics);
+
+    receiver.query(recv_metrics, sess_metrics, sess_metrics_size);
+
+    LONGS_EQUAL(1, recv_metrics.num_sessions);
+    LONGS_EQUAL(1, sess_metrics_size);
+
+    CHECK(sess_metrics[0].latency > 0);
+    CHECK(sess_metrics[0].target_latency > 0);
+    CHECK(sess_metrics[0].time_to_first_audio > 0);
+
+    CHECK(sess_metrics[0].packets_received > 0);
+    CHECK(sess_metrics[0].packets_lost > 0);
+    CHECK(sess_metrics[0].packets_recovered > 0);
+    CHECK(sess_metrics[0].packets_recovered <= sess_metrics[0].packets_lost);
+
+    sender.stop();
+    sender.join();
+}
+
 TEST(receiver, bad_args) {
     roc_receiver* receiver = NULL;
 
@@ -492,6 +622,33 @@ TEST(receiver, bad_args) {
 
         LONGS_EQUAL(0, roc_receiver_close(receiver));
     }
+    { // query
+        CHECK(roc_receiver_open(context, &receiver_config, &receiver) == 0);
+
+        roc_receiver_metrics recv_metrics;
+        roc_session_metrics sess_metrics;
+        size_t sess_metrics_size = 1;
+
+        CHECK(roc_receiver_query(NULL, ROC_SLOT_DEFAULT, &recv_metrics, &sess_metrics,
+                                 &sess_metrics_size)
+              == -1);
+        CHECK(roc_receiver_query(receiver, ROC_SLOT_DEFAULT, NULL, &sess_metrics,
+                                 &sess_metrics_size)
+              == -1);
+        CHECK(roc_receiver_query(receiver, ROC_SLOT_DEFAULT, &recv_metrics, NULL,
+                                 &sess_metrics_size)
+              == -1);
+        CHECK(roc_receiver_query(receiver, ROC_SLOT_DEFAULT, &recv_metrics,
+                                 &sess_metrics, NULL)
+              == -1);
+
+        // slot doesn't exist
+        CHECK(roc_receiver_query(receiver, ROC_SLOT_DEFAULT, &recv_metrics,
+                                 &sess_metrics, &sess_metrics_size)
+              == -1);
+
+        LONGS_EQUAL(0, roc_receiver_close(receiver));
+    }
 }
 
 TEST(receiver, bad_config) {
@@ -9,6 +9,7 @@
 #include <CppUTest/TestHarness.h>
 
 #include "roc_core/stddefs.h"
+#include "roc_fec/codec_map.h"
 
 #include "roc/sender.h"
 
@@ -362,6 +363,110 @@ TEST(sender, reuseaddr_slots) {
     LONGS_EQUAL(0, roc_sender_close(sender));
 }
 
+TEST(sender, query) {
+    roc_sender* sender = NULL;
+    CHECK(roc_sender_open(context, &sender_config, &sender) == 0);
+    CHECK(sender);
+
+    roc_sender_metrics send_metrics;
+    memset(&send_metrics, 0xff, sizeof(send_metrics));
+
+    CHECK(roc_sender_query(sender, &send_metrics) == 0);
+
+    LONGS_EQUAL(0, send_metrics.frames_processed);
+    LONGS_EQUAL(0, send_metrics.frame_deadline_misses);
+
+    LONGS_EQUAL(0, send_metrics.connected_ports);
+    LONGS_EQUAL(0, send_metrics.packets_refused);
+    LONGS_EQUAL(0, send_metrics.packets_unreachable);
+
+    LONGS_EQUAL(0, send_metrics.packets_paced);
+    LONGS_EQUAL(0, send_metrics.max_pacing_queue);
+    LONGS_EQUAL(0, send_metrics.max_pacing_deviation);
+
+    LONGS_EQUAL(0, send_metrics.latency);
+
+    LONGS_EQUAL(0, roc_sender_close(sender));
+}
+
+TEST(sender, query_fec_interleaving) {
+    if (!fec::CodecMap::instance().is_supported(packet::FEC_ReedSolomon_M8)) {
+        return;
+    }
+
+    enum { Span = 4, SourcePackets = 10, RepairPackets = 5 };
+
+    const unsigned long long PacketLength = 5000000; // 5ms
+
+    sender_config.fec_encoding = ROC_FEC_ENCODING_RS8M;
+    sender_config.fec_block_source_packets = SourcePackets;
+    sender_config.fec_block_repair_packets = RepairPackets;
+    sender_config.fec_interleaving_span = Span;
+    sender_config.packet_length = PacketLength;
+
+    roc_sender* sender = NULL;
+    CHECK(roc_sender_open(context, &sender_config, &sender) == 0);
+    CHECK(sender);
+
+    roc_sender_metrics send_metrics;
+    memset(&send_metrics, 0xff, sizeof(send_metrics));
+
+    // interleaver is created together with repair endpoint
+    CHECK(roc_sender_query(sender, &send_metrics) == 0);
+    LONGS_EQUAL(0, send_metrics.latency);
+
+    roc_endpoint* source_endpoint = NULL;
+    CHECK(roc_endpoint_allocate(&source_endpoint) == 0);
+    CHECK(roc_endpoint_set_uri(source_endpoint, "rtp+rs8m://127.0.0.1:111") == 0);
+
+    roc_endpoint* repair_endpoint = NULL;
+    CHECK(roc_endpoint_allocate(&repair_endpoint) == 0);
+    CHECK(roc_endpoint_set_uri(repair_endpoint, "rs8m://127.0.0.1:112") == 0);
+
+    CHECK(roc_sender_connect(sender, ROC_SLOT_DEFAULT, ROC_INTERFACE_AUDIO_SOURCE,
+                             source_endpoint)
+          == 0);
+    CHECK(roc_sender_connect(sender, ROC_SLOT_DEFAULT, ROC_INTERFACE_AUDIO_REPAIR,
+                             repair_endpoint)
+          == 0);
+
+    CHECK(roc_endpoint_deallocate(source_endpoint) == 0);
+    CHECK(roc_endpoint_deallocate(repair_endpoint) == 0);
+
+    memset(&send_metrics, 0xff, sizeof(send_metrics));
+
+    CHECK(roc_sender_query(sender, &send_metrics) == 0);
+    CHECK(Span * SourcePackets * PacketLength == send_metrics.latency);
+
+    LONGS_EQUAL(0, roc_sender_close(sender));
+}
+
+TEST(sender, query_connected) {
+    roc_sender* sender = NULL;
+    CHECK(roc_sender_open(context, &sender_config, &sender) == 0);
+    CHECK(sender);
+
+    roc_endpoint* source_endpoint = NULL;
+    CHECK(roc_endpoint_allocate(&source_endpoint) == 0);
+    CHECK(roc_endpoint_set_uri(source_endpoint, "rtp://127.0.0.1:111") == 0);
+
+    CHECK(roc_sender_connect(sender, 0, ROC_INTERFACE_AUDIO_SOURCE, source_endpoint)
+          == 0);
+    CHECK(roc_endpoint_deallocate(source_endpoint) == 0);
+
+    roc_sender_metrics send_metrics;
+    memset(&send_metrics, 0xff, sizeof(send_metrics));
+
+    // port is bound, but socket isn't connected until packets are sent
+    CHECK(roc_sender_query(sender, &send_metrics) == 0);
+
+    LONGS_EQUAL(0, send_metrics.connected_ports);
+    LONGS_EQUAL(0, send_metrics.packets_refused);
+    LONGS_EQUAL(0, send_metrics.packets_unreachable);
+
+    LONGS_EQUAL(0, roc_sender_close(sender));
+}
+
 TEST(sender, bad_args) {
     roc_sender* sender = NULL;
 
@@ -373,6 +478,16 @@ TEST(sender, bad_args) {
         roc_sender_config bad_config;
         memset(&bad_config, 0, sizeof(bad_config));
         CHECK(roc_sender_open(context, &bad_config, &sender) == -1);
+
+        bad_config = sender_config;
+        bad_config.fec_encoding = ROC_FEC_ENCODING_RS8M;
+        bad_config.fec_interleaving_span = 1000;
+        CHECK(roc_sender_open(context, &bad_config, &sender) == -1);
+
+        bad_config = sender_config;
+        bad_config.fec_encoding = ROC_FEC_ENCODING_RLC;
+        bad_config.fec_interleaving_span = 4;
+        CHECK(roc_sender_open(context, &bad_config, &sender) == -1);
     }
     { // close
         CHECK(roc_sender_close(NULL) == -1);
@@ -441,6 +556,16 @@ TEST(sender, bad_args) {
                                        ROC_INTERFACE_AUDIO_SOURCE, 2)
               == -1);
 
+        LONGS_EQUAL(0, roc_sender_close(sender));
+    }
+    { // query
+        CHECK(roc_sender_open(context, &sender_config, &sender) == 0);
+
+        roc_sender_metrics send_metrics;
+
+        CHECK(roc_sender_query(NULL, &send_metrics) == -1);
+        CHECK(roc_sender_query(sender, NULL) == -1);
+
         LONGS_EQUAL(0, roc_sender_close(sender));
     }
 }
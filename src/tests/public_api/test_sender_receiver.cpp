@@ -155,6 +155,73 @@ TEST(sender_receiver, rs8m_with_losses) {
     sender.join();
 }
 
+TEST(sender_receiver, rs8m_incremental_decoding_with_losses) {
+    if (!is_rs8m_supported()) {
+        return;
+    }
+
+    enum { Flags = test::FlagRS8M };
+
+    init_config(Flags);
+
+    receiver_conf.fec_incremental_decoding = 1;
+
+    test::Context context;
+
+    test::Receiver receiver(context, receiver_conf, sample_step, test::FrameSamples);
+
+    receiver.bind(Flags);
+
+    test::Proxy proxy(receiver.source_endpoint(), receiver.repair_endpoint(),
+                      test::SourcePackets, test::RepairPackets, allocator, packet_factory,
+                      byte_buffer_factory);
+
+    test::Sender sender(context, sender_conf, sample_step, test::FrameSamples);
+
+    sender.connect(proxy.source_endpoint(), proxy.repair_endpoint(), Flags);
+
+    sender.start();
+    receiver.receive();
+    sender.stop();
+    sender.join();
+}
+
+TEST(sender_receiver, rs8m_with_pacing) {
+    if (!is_rs8m_supported()) {
+        return;
+    }
+
+    enum { Flags = test::FlagRS8M };
+
+    init_config(Flags);
+
+    sender_conf.packet_pacing = 1;
+
+    test::Context context;
+
+    test::Receiver receiver(context, receiver_conf, sample_step, test::FrameSamples);
+
+    receiver.bind(Flags);
+
+    test::Sender sender(context, sender_conf, sample_step, test::FrameSamples);
+
+    sender.connect(receiver.source_endpoint(), receiver.repair_endpoint(), Flags);
+
+    sender.start();
+    receiver.receive();
+    sender.stop();
+    sender.join();
+
+    roc_sender_metrics send_metrics;
+    memset(&send_metrics, 0, sizeof(send_metrics));
+
+    sender.query(send_metrics);
+
+    // source and repair packets were spread over time by pacing queues
+    CHECK(send_metrics.packets_paced > 0);
+    CHECK(send_metrics.max_pacing_queue > 0);
+}
+
 TEST(sender_receiver, ldpc_without_losses) {
     if (!is_ldpc_supported()) {
         return;
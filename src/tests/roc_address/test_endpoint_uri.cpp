@@ -224,6 +224,32 @@ TEST(endpoint_uri, protocols) {
 
         STRCMP_EQUAL("ldpc://host:123", endpoint_uri_to_str(u).c_str());
     }
+    {
+        EndpointUri u(allocator);
+        CHECK(parse_endpoint_uri("rtp+rlc://host:123", EndpointUri::Subset_Full, u));
+        CHECK(u.verify(EndpointUri::Subset_Full));
+
+        LONGS_EQUAL(Proto_RTP_RLC_Source, u.proto());
+        STRCMP_EQUAL("host", u.host());
+        LONGS_EQUAL(123, u.port());
+        CHECK(!u.path());
+        CHECK(!u.encoded_query());
+
+        STRCMP_EQUAL("rtp+rlc://host:123", endpoint_uri_to_str(u).c_str());
+    }
+    {
+        EndpointUri u(allocator);
+        CHECK(parse_endpoint_uri("rlc://host:123", EndpointUri::Subset_Full, u));
+        CHECK(u.verify(EndpointUri::Subset_Full));
+
+        LONGS_EQUAL(Proto_RLC_Repair, u.proto());
+        STRCMP_EQUAL("host", u.host());
+        LONGS_EQUAL(123, u.port());
+        CHECK(!u.path());
+        CHECK(!u.encoded_query());
+
+        STRCMP_EQUAL("rlc://host:123", endpoint_uri_to_str(u).c_str());
+    }
     {
         EndpointUri u(allocator);
         CHECK(parse_endpoint_uri("rtcp://host:123", EndpointUri::Subset_Full, u));
@@ -363,6 +389,12 @@ TEST(endpoint_uri, omit_port) {
 
     CHECK(parse_endpoint_uri("ldpc://host:123", EndpointUri::Subset_Full, u));
     CHECK(!parse_endpoint_uri("ldpc://host", EndpointUri::Subset_Full, u));
+
+    CHECK(parse_endpoint_uri("rtp+rlc://host:123", EndpointUri::Subset_Full, u));
+    CHECK(!parse_endpoint_uri("rtp+rlc://host", EndpointUri::Subset_Full, u));
+
+    CHECK(parse_endpoint_uri("rlc://host:123", EndpointUri::Subset_Full, u));
+    CHECK(!parse_endpoint_uri("rlc://host", EndpointUri::Subset_Full, u));
 }
 
 TEST(endpoint_uri, zero_port) {
@@ -432,6 +464,14 @@ TEST(endpoint_uri, non_empty_path) {
     CHECK(parse_endpoint_uri("ldpc://host:123", EndpointUri::Subset_Full, u));
     CHECK(!parse_endpoint_uri("ldpc://host:123/path", EndpointUri::Subset_Full, u));
     CHECK(!parse_endpoint_uri("ldpc://host:123?query", EndpointUri::Subset_Full, u));
+
+    CHECK(parse_endpoint_uri("rtp+rlc://host:123", EndpointUri::Subset_Full, u));
+    CHECK(!parse_endpoint_uri("rtp+rlc://host:123/path", EndpointUri::Subset_Full, u));
+    CHECK(!parse_endpoint_uri("rtp+rlc://host:123?query", EndpointUri::Subset_Full, u));
+
+    CHECK(parse_endpoint_uri("rlc://host:123", EndpointUri::Subset_Full, u));
+    CHECK(!parse_endpoint_uri("rlc://host:123/path", EndpointUri::Subset_Full, u));
+    CHECK(!parse_endpoint_uri("rlc://host:123?query", EndpointUri::Subset_Full, u));
 }
 
 TEST(endpoint_uri, percent_encoding) {
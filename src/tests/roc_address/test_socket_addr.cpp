@@ -152,6 +152,32 @@ TEST(socket_addr, eq_ipv6) {
     CHECK(addr1 != addr4);
 }
 
+TEST(socket_addr, hash) {
+    SocketAddr addr1;
+    CHECK(addr1.set_host_port(Family_IPv4, "1.2.3.4", 123));
+
+    SocketAddr addr2;
+    CHECK(addr2.set_host_port(Family_IPv4, "1.2.3.4", 123));
+
+    SocketAddr addr3;
+    CHECK(addr3.set_host_port(Family_IPv4, "1.2.3.4", 456));
+
+    SocketAddr addr4;
+    CHECK(addr4.set_host_port(Family_IPv6, "2001:db1::1", 123));
+
+    SocketAddr addr5;
+    CHECK(addr5.set_host_port(Family_IPv6, "2001:db1::1", 123));
+
+    SocketAddr addr6;
+    CHECK(addr6.set_host_port(Family_IPv6, "2001:db2::1", 123));
+
+    CHECK(addr1.hash() == addr2.hash());
+    CHECK(addr1.hash() != addr3.hash());
+
+    CHECK(addr4.hash() == addr5.hash());
+    CHECK(addr4.hash() != addr6.hash());
+}
+
 TEST(socket_addr, multicast_ipv4) {
     {
         SocketAddr addr;
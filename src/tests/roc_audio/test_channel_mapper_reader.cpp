@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/channel_mapper_reader.h"
+#include "roc_core/buffer_factory.h"
+#include "roc_core/heap_allocator.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum {
+    SampleRate = 1000,
+    InChans = 0x2,
+    OutChans = 0x3,
+
+    // samples per channel in internal buffer
+    BatchSize = 10,
+
+    MaxBufSize = 1000
+};
+
+const core::nanoseconds_t FrameLength = BatchSize * core::Second / SampleRate;
+
+const double Epsilon = 0.000001;
+
+core::HeapAllocator allocator;
+core::BufferFactory<sample_t> buffer_factory(allocator, MaxBufSize, true);
+
+// Produces increasing samples and checks that frames fit internal buffer.
+class BatchReader : public IFrameReader {
+public:
+    BatchReader()
+        : n_reads_(0)
+        , n_samples_(0) {
+    }
+
+    virtual bool read(Frame& frame) {
+        CHECK(frame.num_samples() > 0);
+        CHECK(frame.num_samples() <= BatchSize);
+
+        for (size_t n = 0; n < frame.num_samples(); n++) {
+            frame.samples()[n] = sample_value(n_samples_++);
+        }
+
+        n_reads_++;
+        return true;
+    }
+
+    size_t num_reads() const {
+        return n_reads_;
+    }
+
+    static sample_t sample_value(size_t n) {
+        return sample_t(n + 1) * 0.001f;
+    }
+
+private:
+    size_t n_reads_;
+    size_t n_samples_;
+};
+
+} // namespace
+
+TEST_GROUP(channel_mapper_reader) {
+    SampleSpec in_spec;
+    SampleSpec out_spec;
+
+    void setup() {
+        in_spec = SampleSpec(SampleRate, InChans);
+        out_spec = SampleSpec(SampleRate, OutChans);
+    }
+};
+
+TEST(channel_mapper_reader, frame_smaller_than_batch) {
+    enum { NumSamples = BatchSize / 2 };
+
+    BatchReader batch_reader;
+    ChannelMapperReader mapper_reader(batch_reader, buffer_factory, FrameLength, in_spec,
+                                      out_spec);
+    CHECK(mapper_reader.valid());
+
+    sample_t samples[NumSamples * 2] = {};
+    Frame frame(samples, NumSamples * 2);
+
+    CHECK(mapper_reader.read(frame));
+
+    UNSIGNED_LONGS_EQUAL(1, batch_reader.num_reads());
+
+    for (size_t n = 0; n < NumSamples; n++) {
+        DOUBLES_EQUAL(0.0, samples[n * 2], Epsilon);
+        DOUBLES_EQUAL(BatchReader::sample_value(n), samples[n * 2 + 1], Epsilon);
+    }
+}
+
+TEST(channel_mapper_reader, frame_larger_than_batch) {
+    enum { NumSamples = BatchSize * 5 + BatchSize / 2 };
+
+    BatchReader batch_reader;
+    ChannelMapperReader mapper_reader(batch_reader, buffer_factory, FrameLength, in_spec,
+                                      out_spec);
+    CHECK(mapper_reader.valid());
+
+    sample_t samples[NumSamples * 2] = {};
+    Frame frame(samples, NumSamples * 2);
+
+    CHECK(mapper_reader.read(frame));
+
+    UNSIGNED_LONGS_EQUAL(6, batch_reader.num_reads());
+
+    for (size_t n = 0; n < NumSamples; n++) {
+        DOUBLES_EQUAL(0.0, samples[n * 2], Epsilon);
+        DOUBLES_EQUAL(BatchReader::sample_value(n), samples[n * 2 + 1], Epsilon);
+    }
+}
+
+} // namespace audio
+} // namespace roc
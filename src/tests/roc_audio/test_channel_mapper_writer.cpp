@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/channel_mapper_writer.h"
+#include "roc_core/buffer_factory.h"
+#include "roc_core/heap_allocator.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum {
+    SampleRate = 1000,
+    InChans = 0x2,
+    OutChans = 0x3,
+
+    // samples per channel in internal buffer
+    BatchSize = 10,
+
+    MaxSamples = 1000,
+    MaxBufSize = 1000
+};
+
+const core::nanoseconds_t FrameLength = BatchSize * core::Second / SampleRate;
+
+const double Epsilon = 0.000001;
+
+core::HeapAllocator allocator;
+core::BufferFactory<sample_t> buffer_factory(allocator, MaxBufSize, true);
+
+// Stores written samples and checks that frames fit internal buffer.
+class BatchWriter : public IFrameWriter {
+public:
+    BatchWriter()
+        : n_writes_(0)
+        , n_samples_(0) {
+    }
+
+    virtual void write(Frame& frame) {
+        CHECK(frame.num_samples() > 0);
+        CHECK(frame.num_samples() <= BatchSize * 2);
+        CHECK(n_samples_ + frame.num_samples() <= MaxSamples);
+
+        for (size_t n = 0; n < frame.num_samples(); n++) {
+            samples_[n_samples_++] = frame.samples()[n];
+        }
+
+        n_writes_++;
+    }
+
+    size_t num_writes() const {
+        return n_writes_;
+    }
+
+    size_t num_samples() const {
+        return n_samples_;
+    }
+
+    sample_t sample(size_t n) const {
+        CHECK(n < n_samples_);
+        return samples_[n];
+    }
+
+private:
+    size_t n_writes_;
+    size_t n_samples_;
+    sample_t samples_[MaxSamples];
+};
+
+sample_t sample_value(size_t n) {
+    return sample_t(n + 1) * 0.001f;
+}
+
+} // namespace
+
+TEST_GROUP(channel_mapper_writer) {
+    SampleSpec in_spec;
+    SampleSpec out_spec;
+
+    void setup() {
+        in_spec = SampleSpec(SampleRate, InChans);
+        out_spec = SampleSpec(SampleRate, OutChans);
+    }
+};
+
+TEST(channel_mapper_writer, frame_smaller_than_batch) {
+    enum { NumSamples = BatchSize / 2 };
+
+    BatchWriter batch_writer;
+    ChannelMapperWriter mapper_writer(batch_writer, buffer_factory, FrameLength, in_spec,
+                                      out_spec);
+    CHECK(mapper_writer.valid());
+
+    sample_t samples[NumSamples];
+    for (size_t n = 0; n < NumSamples; n++) {
+        samples[n] = sample_value(n);
+    }
+
+    Frame frame(samples, NumSamples);
+    mapper_writer.write(frame);
+
+    UNSIGNED_LONGS_EQUAL(1, batch_writer.num_writes());
+    UNSIGNED_LONGS_EQUAL(NumSamples * 2, batch_writer.num_samples());
+
+    for (size_t n = 0; n < NumSamples; n++) {
+        DOUBLES_EQUAL(0.0, batch_writer.sample(n * 2), Epsilon);
+        DOUBLES_EQUAL(sample_value(n), batch_writer.sample(n * 2 + 1), Epsilon);
+    }
+}
+
+TEST(channel_mapper_writer, frame_larger_than_batch) {
+    enum { NumSamples = BatchSize * 5 + BatchSize / 2 };
+
+    BatchWriter batch_writer;
+    ChannelMapperWriter mapper_writer(batch_writer, buffer_factory, FrameLength, in_spec,
+                                      out_spec);
+    CHECK(mapper_writer.valid());
+
+    sample_t samples[NumSamples];
+    for (size_t n = 0; n < NumSamples; n++) {
+        samples[n] = sample_value(n);
+    }
+
+    Frame frame(samples, NumSamples);
+    mapper_writer.write(frame);
+
+    UNSIGNED_LONGS_EQUAL(6, batch_writer.num_writes());
+    UNSIGNED_LONGS_EQUAL(NumSamples * 2, batch_writer.num_samples());
+
+    for (size_t n = 0; n < NumSamples; n++) {
+        DOUBLES_EQUAL(0.0, batch_writer.sample(n * 2), Epsilon);
+        DOUBLES_EQUAL(sample_value(n), batch_writer.sample(n * 2 + 1), Epsilon);
+    }
+}
+
+} // namespace audio
+} // namespace roc
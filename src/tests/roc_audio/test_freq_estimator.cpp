@@ -57,5 +57,27 @@ TEST(freq_estimator, small_queue_size) {
     } while (fe.freq_coeff() > 0.99f);
 }
 
+TEST(freq_estimator, change_target) {
+    FreqEstimator fe(fe_config, Target);
+
+    for (size_t n = 0; n < 1000; n++) {
+        fe.update(Target);
+    }
+
+    DOUBLES_EQUAL(1.0, (double)fe.freq_coeff(), Epsilon);
+
+    fe.set_target_latency(Target * 2);
+
+    do {
+        fe.update(Target);
+    } while (fe.freq_coeff() > 0.99f);
+
+    fe.set_target_latency(Target / 2);
+
+    do {
+        fe.update(Target);
+    } while (fe.freq_coeff() < 1.01f);
+}
+
 } // namespace audio
 } // namespace roc
@@ -0,0 +1,703 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "test_helpers/mock_reader.h"
+
+#include "roc_audio/depacketizer.h"
+#include "roc_audio/latency_monitor.h"
+#include "roc_audio/pcm_decoder.h"
+#include "roc_audio/pcm_encoder.h"
+#include "roc_audio/resampler_map.h"
+#include "roc_audio/resampler_reader.h"
+#include "roc_core/buffer_factory.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/scoped_ptr.h"
+#include "roc_packet/jitter_meter.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_packet/queue.h"
+#include "roc_packet/sorted_queue.h"
+#include "roc_rtp/composer.h"
+
+namespace roc {
+namespace audio {
+
+namespace {
+
+enum {
+    MaxBufSize = 4000,
+    SampleRate = 10000,
+    ChMask = 0x1,
+    SamplesPerPacket = 100,
+    ResamplerFrameSize = 128,
+    JitterPackets = 300
+};
+
+const SampleSpec SampleSpecs(SampleRate, ChMask);
+const PcmFormat PcmFmt(PcmEncoding_SInt16, PcmEndian_Big);
+
+// Duration of one sample, i.e. precision of target latency.
+const core::nanoseconds_t Tick = core::Second / SampleRate;
+
+const core::nanoseconds_t TargetLatency = 100 * core::Millisecond;
+const core::nanoseconds_t StartLatency = 20 * core::Millisecond;
+
+const core::nanoseconds_t MinTargetLatency = 20 * core::Millisecond;
+const core::nanoseconds_t MaxTargetLatency = 200 * core::Millisecond;
+
+const core::nanoseconds_t NsPerPacket = SamplesPerPacket * core::Second / SampleRate;
+const core::nanoseconds_t StartTime = 1000000 * core::Second;
+
+core::HeapAllocator allocator;
+core::BufferFactory<sample_t> sample_buffer_factory(allocator, MaxBufSize, true);
+core::BufferFactory<uint8_t> byte_buffer_factory(allocator, MaxBufSize, true);
+packet::PacketFactory packet_factory(allocator, true);
+
+rtp::Composer rtp_composer(NULL);
+
+packet::PacketPtr new_packet(packet::timestamp_t ts) {
+    PcmEncoder encoder(PcmFmt, SampleSpecs);
+
+    packet::PacketPtr pp = packet_factory.new_packet();
+    CHECK(pp);
+
+    core::Slice<uint8_t> bp = byte_buffer_factory.new_buffer();
+    CHECK(bp);
+
+    CHECK(rtp_composer.prepare(*pp, bp, encoder.encoded_byte_count(SamplesPerPacket)));
+
+    pp->set_data(bp);
+
+    pp->rtp()->timestamp = ts;
+    pp->rtp()->duration = SamplesPerPacket;
+
+    sample_t samples[SamplesPerPacket] = {};
+
+    encoder.begin(pp->rtp()->payload.data(), pp->rtp()->payload.size());
+    UNSIGNED_LONGS_EQUAL(SamplesPerPacket, encoder.write(samples, SamplesPerPacket));
+    encoder.end();
+
+    CHECK(rtp_composer.compose(*pp));
+
+    return pp;
+}
+
+// Fill queue with given amount of audio and start depacketizer, so that
+// latency monitor is able to measure latency.
+void start_playback(packet::SortedQueue& queue,
+                    Depacketizer& depacketizer,
+                    core::nanoseconds_t latency) {
+    const size_t n_packets =
+        (size_t)SampleSpecs.ns_2_rtp_timestamp(latency) / SamplesPerPacket + 1;
+
+    for (size_t n = 0; n < n_packets; n++) {
+        queue.write(new_packet(packet::timestamp_t(n * SamplesPerPacket)));
+    }
+
+    sample_t samples[1];
+    Frame frame(samples, 1);
+    CHECK(depacketizer.read(frame));
+    CHECK(depacketizer.started());
+}
+
+// Write packets to jitter meter, so that measured jitter converges to given
+// value. Every second packet is delayed by @p jitter.
+void write_jitter(packet::JitterMeter& meter,
+                  packet::seqnum_t& seqnum,
+                  core::nanoseconds_t jitter) {
+    for (size_t n = 0; n < JitterPackets; n++) {
+        packet::PacketPtr pp = packet_factory.new_packet();
+        CHECK(pp);
+
+        pp->add_flags(packet::Packet::FlagUDP | packet::Packet::FlagRTP
+                      | packet::Packet::FlagAudio);
+
+        pp->rtp()->source = 1;
+        pp->rtp()->seqnum = seqnum;
+        pp->rtp()->timestamp = packet::timestamp_t(seqnum * SamplesPerPacket);
+        pp->udp()->receive_timestamp =
+            StartTime + seqnum * NsPerPacket + (seqnum % 2 ? jitter : 0);
+
+        meter.write(pp);
+        seqnum++;
+    }
+}
+
+// Run one target latency update per call.
+void update(LatencyMonitor& monitor,
+            packet::timestamp_t& pos,
+            const LatencyMonitorConfig& config) {
+    CHECK(monitor.update(pos));
+    pos += (packet::timestamp_t)SampleSpecs.ns_2_rtp_timestamp(config.fe_update_interval);
+}
+
+// Maximum change of target latency per update allowed by scaling limits.
+core::nanoseconds_t scaling_step(const LatencyMonitorConfig& config) {
+    return (core::nanoseconds_t)((double)config.fe_update_interval
+                                 * (double)config.max_scaling_delta);
+}
+
+// Same, plus rounding of target latency to samples.
+core::nanoseconds_t max_step(const LatencyMonitorConfig& config) {
+    return scaling_step(config) + Tick;
+}
+
+} // namespace
+
+TEST_GROUP(latency_monitor) {
+    LatencyMonitorConfig config;
+    FreqEstimatorConfig fe_config;
+
+    core::ScopedPtr<IResampler> resampler;
+
+    void setup() {
+        config.min_latency = 0;
+        config.max_latency = 1 * core::Second;
+
+        resampler.reset(ResamplerMap::instance().new_resampler(
+                            ResamplerBackend_Builtin, allocator, sample_buffer_factory,
+                            ResamplerProfile_Low,
+                            SampleSpecs.samples_per_chan_2_ns(ResamplerFrameSize),
+                            SampleSpecs),
+                        allocator);
+        CHECK(resampler);
+        CHECK(resampler->valid());
+    }
+};
+
+TEST(latency_monitor, no_fast_start) {
+    packet::SortedQueue queue(0);
+    PcmDecoder decoder(PcmFmt, SampleSpecs);
+    Depacketizer depacketizer(queue, decoder, SampleSpecs, false);
+
+    test::MockReader frame_reader;
+    ResamplerReader resampler_reader(frame_reader, *resampler, SampleSpecs, SampleSpecs);
+    CHECK(resampler_reader.valid());
+
+    LatencyMonitor monitor(queue, depacketizer, &resampler_reader, NULL, NULL, config,
+                           TargetLatency, SampleSpecs, SampleSpecs, fe_config);
+    CHECK(monitor.valid());
+
+    LONGS_EQUAL(TargetLatency, monitor.target_latency());
+
+    start_playback(queue, depacketizer, TargetLatency);
+
+    packet::timestamp_t pos = 0;
+    for (size_t n = 0; n < 1000; n++) {
+        update(monitor, pos, config);
+        LONGS_EQUAL(TargetLatency, monitor.target_latency());
+    }
+}
+
+TEST(latency_monitor, fast_start_early_start) {
+    config.start_latency = StartLatency;
+
+    packet::SortedQueue queue(0);
+    PcmDecoder decoder(PcmFmt, SampleSpecs);
+    Depacketizer depacketizer(queue, decoder, SampleSpecs, false);
+
+    test::MockReader frame_reader;
+    ResamplerReader resampler_reader(frame_reader, *resampler, SampleSpecs, SampleSpecs);
+    CHECK(resampler_reader.valid());
+
+    LatencyMonitor monitor(queue, depacketizer, &resampler_reader, NULL, NULL, config,
+                           TargetLatency, SampleSpecs, SampleSpecs, fe_config);
+    CHECK(monitor.valid());
+
+    // target is start latency until playback starts
+    LONGS_EQUAL(StartLatency, monitor.target_latency());
+    LONGS_EQUAL(0, monitor.time_to_first_audio());
+
+    packet::timestamp_t pos = 0;
+    CHECK(monitor.update(pos));
+    LONGS_EQUAL(StartLatency, monitor.target_latency());
+
+    // playback starts with start latency buffered
+    start_playback(queue, depacketizer, StartLatency);
+
+    update(monitor, pos, config);
+
+    CHECK(monitor.time_to_first_audio() > 0);
+    CHECK(monitor.latency() >= StartLatency);
+    CHECK(monitor.target_latency() < TargetLatency);
+}
+
+TEST(latency_monitor, fast_start_ramp) {
+    config.start_latency = StartLatency;
+    config.start_ramp = 0;
+
+    packet::SortedQueue queue(0);
+    PcmDecoder decoder(PcmFmt, SampleSpecs);
+    Depacketizer depacketizer(queue, decoder, SampleSpecs, false);
+
+    test::MockReader frame_reader;
+    ResamplerReader resampler_reader(frame_reader, *resampler, SampleSpecs, SampleSpecs);
+    CHECK(resampler_reader.valid());
+
+    LatencyMonitor monitor(queue, depacketizer, &resampler_reader, NULL, NULL, config,
+                           TargetLatency, SampleSpecs, SampleSpecs, fe_config);
+    CHECK(monitor.valid());
+
+    start_playback(queue, depacketizer, StartLatency);
+
+    // with zero ramp duration, target grows as fast as scaling allows
+    const size_t min_updates =
+        size_t((TargetLatency - StartLatency) / scaling_step(config)) - 1;
+
+    packet::timestamp_t pos = 0;
+    core::nanoseconds_t prev_target = monitor.target_latency();
+    size_t n_updates = 0;
+
+    while (monitor.target_latency() < TargetLatency) {
+        update(monitor, pos, config);
+        n_updates++;
+
+        const core::nanoseconds_t target = monitor.target_latency();
+
+        CHECK(target >= prev_target);
+        CHECK(target - prev_target <= max_step(config));
+        CHECK(target <= TargetLatency);
+
+        prev_target = target;
+
+        CHECK(n_updates < min_updates * 10);
+    }
+
+    CHECK(n_updates >= min_updates);
+
+    // ramp is finished, target stays at session target
+    for (size_t n = 0; n < 1000; n++) {
+        update(monitor, pos, config);
+        LONGS_EQUAL(TargetLatency, monitor.target_latency());
+    }
+}
+
+TEST(latency_monitor, fast_start_slow_ramp) {
+    enum { NumUpdates = 8000 };
+
+    config.start_latency = StartLatency;
+    config.start_ramp = config.fe_update_interval * NumUpdates;
+
+    packet::SortedQueue queue(0);
+    PcmDecoder decoder(PcmFmt, SampleSpecs);
+    Depacketizer depacketizer(queue, decoder, SampleSpecs, false);
+
+    test::MockReader frame_reader;
+    ResamplerReader resampler_reader(frame_reader, *resampler, SampleSpecs, SampleSpecs);
+    CHECK(resampler_reader.valid());
+
+    LatencyMonitor monitor(queue, depacketizer, &resampler_reader, NULL, NULL, config,
+                           TargetLatency, SampleSpecs, SampleSpecs, fe_config);
+    CHECK(monitor.valid());
+
+    start_playback(queue, depacketizer, StartLatency);
+
+    // target grows linearly during start_ramp
+    packet::timestamp_t pos = 0;
+    for (size_t n = 1; n <= NumUpdates; n++) {
+        update(monitor, pos, config);
+
+        const core::nanoseconds_t expected = StartLatency
+            + (TargetLatency - StartLatency) * (core::nanoseconds_t)n / NumUpdates;
+
+        // allow rounding to samples
+        CHECK(monitor.target_latency() <= expected + Tick / 10);
+        CHECK(monitor.target_latency() >= expected - Tick * 2);
+    }
+
+    for (size_t n = 0; n < 10; n++) {
+        update(monitor, pos, config);
+        LONGS_EQUAL(TargetLatency, monitor.target_latency());
+    }
+}
+
+TEST(latency_monitor, fast_start_requires_resampler) {
+    config.start_latency = StartLatency;
+
+    packet::SortedQueue queue(0);
+    PcmDecoder decoder(PcmFmt, SampleSpecs);
+    Depacketizer depacketizer(queue, decoder, SampleSpecs, false);
+
+    LatencyMonitor monitor(queue, depacketizer, NULL, NULL, NULL, config, TargetLatency,
+                           SampleSpecs, SampleSpecs, fe_config);
+    CHECK(!monitor.valid());
+}
+
+TEST(latency_monitor, fast_start_invalid_config) {
+    packet::SortedQueue queue(0);
+    PcmDecoder decoder(PcmFmt, SampleSpecs);
+    Depacketizer depacketizer(queue, decoder, SampleSpecs, false);
+
+    test::MockReader frame_reader;
+    ResamplerReader resampler_reader(frame_reader, *resampler, SampleSpecs, SampleSpecs);
+    CHECK(resampler_reader.valid());
+
+    { // start latency above target latency
+        config.start_latency = TargetLatency + Tick;
+        config.start_ramp = core::Second;
+
+        LatencyMonitor monitor(queue, depacketizer, &resampler_reader, NULL, NULL,
+                               config, TargetLatency, SampleSpecs, SampleSpecs,
+                               fe_config);
+        CHECK(!monitor.valid());
+    }
+    { // negative start latency
+        config.start_latency = -StartLatency;
+        config.start_ramp = core::Second;
+
+        LatencyMonitor monitor(queue, depacketizer, &resampler_reader, NULL, NULL,
+                               config, TargetLatency, SampleSpecs, SampleSpecs,
+                               fe_config);
+        CHECK(!monitor.valid());
+    }
+    { // negative ramp
+        config.start_latency = StartLatency;
+        config.start_ramp = -core::Second;
+
+        LatencyMonitor monitor(queue, depacketizer, &resampler_reader, NULL, NULL,
+                               config, TargetLatency, SampleSpecs, SampleSpecs,
+                               fe_config);
+        CHECK(!monitor.valid());
+    }
+    { // start latency equal to target latency
+        config.start_latency = TargetLatency;
+        config.start_ramp = core::Second;
+
+        LatencyMonitor monitor(queue, depacketizer, &resampler_reader, NULL, NULL,
+                               config, TargetLatency, SampleSpecs, SampleSpecs,
+                               fe_config);
+        CHECK(monitor.valid());
+        LONGS_EQUAL(TargetLatency, monitor.target_latency());
+    }
+}
+
+TEST(latency_monitor, fast_start_below_min_latency) {
+    const core::nanoseconds_t MinLatency = 50 * core::Millisecond;
+
+    config.min_latency = MinLatency;
+    config.start_latency = StartLatency;
+
+    packet::SortedQueue queue(0);
+    PcmDecoder decoder(PcmFmt, SampleSpecs);
+    Depacketizer depacketizer(queue, decoder, SampleSpecs, false);
+
+    test::MockReader frame_reader;
+    ResamplerReader resampler_reader(frame_reader, *resampler, SampleSpecs, SampleSpecs);
+    CHECK(resampler_reader.valid());
+
+    LatencyMonitor monitor(queue, depacketizer, &resampler_reader, NULL, NULL, config,
+                           TargetLatency, SampleSpecs, SampleSpecs, fe_config);
+    CHECK(monitor.valid());
+
+    // start latency is clamped to min latency
+    LONGS_EQUAL(MinLatency, monitor.target_latency());
+
+    start_playback(queue, depacketizer, MinLatency);
+
+    packet::timestamp_t pos = 0;
+    for (size_t n = 0; n < 10; n++) {
+        update(monitor, pos, config);
+    }
+
+    CHECK(monitor.target_latency() >= MinLatency);
+    CHECK(monitor.target_latency() < TargetLatency);
+}
+
+TEST(latency_monitor, adaptive_clamp_to_max_target) {
+    config.adaptive_latency = true;
+    config.min_target_latency = MinTargetLatency;
+    config.max_target_latency = MaxTargetLatency;
+
+    packet::SortedQueue queue(0);
+    PcmDecoder decoder(PcmFmt, SampleSpecs);
+    Depacketizer depacketizer(queue, decoder, SampleSpecs, false);
+
+    packet::Queue jitter_queue;
+    packet::JitterMeter jitter_meter(jitter_queue, SampleSpecs);
+    packet::seqnum_t seqnum = 0;
+
+    test::MockReader frame_reader;
+    ResamplerReader resampler_reader(frame_reader, *resampler, SampleSpecs, SampleSpecs);
+    CHECK(resampler_reader.valid());
+
+    LatencyMonitor monitor(queue, depacketizer, &resampler_reader, &jitter_meter, NULL,
+                           config, TargetLatency, SampleSpecs, SampleSpecs, fe_config);
+    CHECK(monitor.valid());
+
+    start_playback(queue, depacketizer, TargetLatency);
+
+    // desired latency is far above max target
+    write_jitter(jitter_meter, seqnum, MaxTargetLatency);
+    CHECK(monitor.jitter() > MaxTargetLatency - Tick);
+
+    packet::timestamp_t pos = 0;
+    core::nanoseconds_t prev_target = monitor.target_latency();
+    size_t n_updates = 0;
+
+    while (monitor.target_latency() < MaxTargetLatency) {
+        update(monitor, pos, config);
+        CHECK(++n_updates < 100000);
+
+        const core::nanoseconds_t target = monitor.target_latency();
+
+        CHECK(target >= prev_target);
+        CHECK(target - prev_target <= max_step(config));
+
+        prev_target = target;
+    }
+
+    for (size_t n = 0; n < 1000; n++) {
+        update(monitor, pos, config);
+        LONGS_EQUAL(MaxTargetLatency, monitor.target_latency());
+    }
+}
+
+TEST(latency_monitor, adaptive_clamp_to_min_target) {
+    config.adaptive_latency = true;
+    config.min_target_latency = MinTargetLatency;
+    config.max_target_latency = MaxTargetLatency;
+
+    packet::SortedQueue queue(0);
+    PcmDecoder decoder(PcmFmt, SampleSpecs);
+    Depacketizer depacketizer(queue, decoder, SampleSpecs, false);
+
+    packet::Queue jitter_queue;
+    packet::JitterMeter jitter_meter(jitter_queue, SampleSpecs);
+    packet::seqnum_t seqnum = 0;
+
+    test::MockReader frame_reader;
+    ResamplerReader resampler_reader(frame_reader, *resampler, SampleSpecs, SampleSpecs);
+    CHECK(resampler_reader.valid());
+
+    LatencyMonitor monitor(queue, depacketizer, &resampler_reader, &jitter_meter, NULL,
+                           config, TargetLatency, SampleSpecs, SampleSpecs, fe_config);
+    CHECK(monitor.valid());
+
+    start_playback(queue, depacketizer, TargetLatency);
+
+    // no jitter, desired latency is below min target
+    write_jitter(jitter_meter, seqnum, 0);
+    LONGS_EQUAL(0, monitor.jitter());
+
+    packet::timestamp_t pos = 0;
+    core::nanoseconds_t prev_target = monitor.target_latency();
+    size_t n_updates = 0;
+
+    while (monitor.target_latency() > MinTargetLatency) {
+        update(monitor, pos, config);
+        CHECK(++n_updates < 100000);
+
+        const core::nanoseconds_t target = monitor.target_latency();
+
+        CHECK(target <= prev_target);
+        CHECK(prev_target - target <= max_step(config));
+
+        prev_target = target;
+    }
+
+    for (size_t n = 0; n < 1000; n++) {
+        update(monitor, pos, config);
+        LONGS_EQUAL(MinTargetLatency, monitor.target_latency());
+    }
+}
+
+TEST(latency_monitor, adaptive_clamp_to_min_latency) {
+    const core::nanoseconds_t MinLatency = 50 * core::Millisecond;
+
+    config.min_latency = MinLatency;
+    config.adaptive_latency = true;
+    config.min_target_latency = MinTargetLatency;
+    config.max_target_latency = MaxTargetLatency;
+
+    packet::SortedQueue queue(0);
+    PcmDecoder decoder(PcmFmt, SampleSpecs);
+    Depacketizer depacketizer(queue, decoder, SampleSpecs, false);
+
+    packet::Queue jitter_queue;
+    packet::JitterMeter jitter_meter(jitter_queue, SampleSpecs);
+    packet::seqnum_t seqnum = 0;
+
+    test::MockReader frame_reader;
+    ResamplerReader resampler_reader(frame_reader, *resampler, SampleSpecs, SampleSpecs);
+    CHECK(resampler_reader.valid());
+
+    LatencyMonitor monitor(queue, depacketizer, &resampler_reader, &jitter_meter, NULL,
+                           config, TargetLatency, SampleSpecs, SampleSpecs, fe_config);
+    CHECK(monitor.valid());
+
+    start_playback(queue, depacketizer, TargetLatency);
+
+    write_jitter(jitter_meter, seqnum, 0);
+
+    // adaptive range is limited by allowed latency range
+    packet::timestamp_t pos = 0;
+    for (size_t n = 0; n < 10000; n++) {
+        update(monitor, pos, config);
+        CHECK(monitor.target_latency() >= MinLatency);
+    }
+
+    LONGS_EQUAL(MinLatency, monitor.target_latency());
+}
+
+TEST(latency_monitor, adaptive_hysteresis) {
+    config.adaptive_latency = true;
+    config.min_target_latency = MinTargetLatency;
+    config.max_target_latency = MaxTargetLatency;
+
+    packet::SortedQueue queue(0);
+    PcmDecoder decoder(PcmFmt, SampleSpecs);
+    Depacketizer depacketizer(queue, decoder, SampleSpecs, false);
+
+    packet::Queue jitter_queue;
+    packet::JitterMeter jitter_meter(jitter_queue, SampleSpecs);
+    packet::seqnum_t seqnum = 0;
+
+    test::MockReader frame_reader;
+    ResamplerReader resampler_reader(frame_reader, *resampler, SampleSpecs, SampleSpecs);
+    CHECK(resampler_reader.valid());
+
+    LatencyMonitor monitor(queue, depacketizer, &resampler_reader, &jitter_meter, NULL,
+                           config, TargetLatency, SampleSpecs, SampleSpecs, fe_config);
+    CHECK(monitor.valid());
+
+    start_playback(queue, depacketizer, TargetLatency);
+
+    packet::timestamp_t pos = 0;
+
+    // desired latency is 2% below target, target is not decreased
+    write_jitter(jitter_meter, seqnum,
+                 (core::nanoseconds_t)(TargetLatency * 0.98 / config.jitter_factor));
+
+    for (size_t n = 0; n < 1000; n++) {
+        update(monitor, pos, config);
+        LONGS_EQUAL(TargetLatency, monitor.target_latency());
+    }
+
+    // desired latency is 10% below target, target is decreased to desired
+    const core::nanoseconds_t desired_latency = TargetLatency / 10 * 9;
+
+    write_jitter(jitter_meter, seqnum,
+                 (core::nanoseconds_t)(desired_latency / config.jitter_factor));
+
+    for (size_t n = 0; n < 1000; n++) {
+        update(monitor, pos, config);
+    }
+
+    // allow rounding to samples
+    CHECK(monitor.target_latency() <= desired_latency + Tick / 10);
+    CHECK(monitor.target_latency() >= desired_latency - Tick * 2);
+
+    // increase is not affected by hysteresis
+    const core::nanoseconds_t prev_target = monitor.target_latency();
+
+    write_jitter(jitter_meter, seqnum,
+                 (core::nanoseconds_t)((prev_target + Tick * 10) / config.jitter_factor));
+
+    for (size_t n = 0; n < 1000; n++) {
+        update(monitor, pos, config);
+    }
+
+    CHECK(monitor.target_latency() > prev_target);
+}
+
+TEST(latency_monitor, adaptive_step_limit) {
+    enum { NumUpdates = 100 };
+
+    config.adaptive_latency = true;
+    config.min_target_latency = MinTargetLatency;
+    config.max_target_latency = MaxTargetLatency;
+
+    packet::SortedQueue queue(0);
+    PcmDecoder decoder(PcmFmt, SampleSpecs);
+    Depacketizer depacketizer(queue, decoder, SampleSpecs, false);
+
+    packet::Queue jitter_queue;
+    packet::JitterMeter jitter_meter(jitter_queue, SampleSpecs);
+    packet::seqnum_t seqnum = 0;
+
+    test::MockReader frame_reader;
+    ResamplerReader resampler_reader(frame_reader, *resampler, SampleSpecs, SampleSpecs);
+    CHECK(resampler_reader.valid());
+
+    LatencyMonitor monitor(queue, depacketizer, &resampler_reader, &jitter_meter, NULL,
+                           config, TargetLatency, SampleSpecs, SampleSpecs, fe_config);
+    CHECK(monitor.valid());
+
+    start_playback(queue, depacketizer, TargetLatency);
+
+    // desired latency jumps to max target, target changes by at most
+    // fe_update_interval * max_scaling_delta per update
+    write_jitter(jitter_meter, seqnum, MaxTargetLatency);
+
+    packet::timestamp_t pos = 0;
+    for (size_t n = 0; n < NumUpdates; n++) {
+        update(monitor, pos, config);
+    }
+
+    const core::nanoseconds_t expected =
+        TargetLatency + scaling_step(config) * NumUpdates;
+
+    CHECK(monitor.target_latency() <= expected);
+    CHECK(monitor.target_latency() >= expected - Tick * 2);
+}
+
+TEST(latency_monitor, adaptive_invalid_config) {
+    packet::SortedQueue queue(0);
+    PcmDecoder decoder(PcmFmt, SampleSpecs);
+    Depacketizer depacketizer(queue, decoder, SampleSpecs, false);
+
+    packet::Queue jitter_queue;
+    packet::JitterMeter jitter_meter(jitter_queue, SampleSpecs);
+
+    test::MockReader frame_reader;
+    ResamplerReader resampler_reader(frame_reader, *resampler, SampleSpecs, SampleSpecs);
+    CHECK(resampler_reader.valid());
+
+    config.adaptive_latency = true;
+
+    { // adaptive latency requires resampler
+        config.min_target_latency = MinTargetLatency;
+        config.max_target_latency = MaxTargetLatency;
+
+        LatencyMonitor monitor(queue, depacketizer, NULL, &jitter_meter, NULL, config,
+                               TargetLatency, SampleSpecs, SampleSpecs, fe_config);
+        CHECK(!monitor.valid());
+    }
+    { // min target above max target
+        config.min_target_latency = MaxTargetLatency;
+        config.max_target_latency = MinTargetLatency;
+
+        LatencyMonitor monitor(queue, depacketizer, &resampler_reader, &jitter_meter,
+                               NULL, config, TargetLatency, SampleSpecs, SampleSpecs,
+                               fe_config);
+        CHECK(!monitor.valid());
+    }
+    { // zero min target
+        config.min_target_latency = 0;
+        config.max_target_latency = MaxTargetLatency;
+
+        LatencyMonitor monitor(queue, depacketizer, &resampler_reader, &jitter_meter,
+                               NULL, config, TargetLatency, SampleSpecs, SampleSpecs,
+                               fe_config);
+        CHECK(!monitor.valid());
+    }
+    { // zero jitter factor
+        config.min_target_latency = MinTargetLatency;
+        config.max_target_latency = MaxTargetLatency;
+        config.jitter_factor = 0;
+
+        LatencyMonitor monitor(queue, depacketizer, &resampler_reader, &jitter_meter,
+                               NULL, config, TargetLatency, SampleSpecs, SampleSpecs,
+                               fe_config);
+        CHECK(!monitor.valid());
+    }
+}
+
+} // namespace audio
+} // namespace roc
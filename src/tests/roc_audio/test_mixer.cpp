@@ -11,6 +11,7 @@
 #include "test_helpers/mock_reader.h"
 
 #include "roc_audio/mixer.h"
+#include "roc_audio/mixer_worker_pool.h"
 #include "roc_core/buffer_factory.h"
 #include "roc_core/heap_allocator.h"
 #include "roc_core/stddefs.h"
@@ -196,5 +197,102 @@ TEST(mixer, flags) {
     CHECK(reader2.num_unread() == 0);
 }
 
+TEST(mixer, parallel_many_readers) {
+    enum { NumReaders = 5, NumWorkers = 3 };
+
+    test::MockReader readers[NumReaders];
+
+    MixerWorkerPool worker_pool(allocator, NumWorkers);
+    CHECK(worker_pool.valid());
+
+    Mixer mixer(buffer_factory, MaxBufDuration, SampleSpecs, &worker_pool);
+    CHECK(mixer.valid());
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        mixer.add_input(readers[n]);
+    }
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        readers[n].add(BufSz, 0.01f);
+    }
+    expect_output(mixer, BufSz, 0.01f * NumReaders);
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        readers[n].add(MaxBufSz * 2, 0.02f);
+    }
+    expect_output(mixer, MaxBufSz * 2, 0.02f * NumReaders);
+
+    mixer.remove_input(readers[0]);
+
+    for (size_t n = 0; n < NumReaders; n++) {
+        readers[n].add(BufSz, 0.03f);
+    }
+    expect_output(mixer, BufSz, 0.03f * (NumReaders - 1));
+
+    CHECK(readers[0].num_unread() == BufSz);
+    for (size_t n = 1; n < NumReaders; n++) {
+        CHECK(readers[n].num_unread() == 0);
+    }
+}
+
+TEST(mixer, parallel_clamp) {
+    test::MockReader reader1;
+    test::MockReader reader2;
+    test::MockReader reader3;
+
+    MixerWorkerPool worker_pool(allocator, 2);
+    CHECK(worker_pool.valid());
+
+    Mixer mixer(buffer_factory, MaxBufDuration, SampleSpecs, &worker_pool);
+    CHECK(mixer.valid());
+
+    mixer.add_input(reader1);
+    mixer.add_input(reader2);
+    mixer.add_input(reader3);
+
+    // inputs are mixed in the order of addition, as in sequential mode
+    reader1.add(BufSz, 0.9f);
+    reader2.add(BufSz, 0.5f);
+    reader3.add(BufSz, -0.5f);
+
+    expect_output(mixer, BufSz, 0.5f);
+
+    CHECK(reader1.num_unread() == 0);
+    CHECK(reader2.num_unread() == 0);
+    CHECK(reader3.num_unread() == 0);
+}
+
+TEST(mixer, parallel_flags) {
+    enum { BigBatch = MaxBufSz * 2 };
+
+    test::MockReader reader1;
+    test::MockReader reader2;
+
+    MixerWorkerPool worker_pool(allocator, 1);
+    CHECK(worker_pool.valid());
+
+    Mixer mixer(buffer_factory, MaxBufDuration, SampleSpecs, &worker_pool);
+    CHECK(mixer.valid());
+
+    mixer.add_input(reader1);
+    mixer.add_input(reader2);
+
+    reader1.add(BigBatch, 0.1f, 0);
+    reader1.add(BigBatch, 0.1f, Frame::FlagNonblank);
+    reader1.add(BigBatch, 0.1f, 0);
+
+    reader2.add(BigBatch, 0.1f, Frame::FlagIncomplete);
+    reader2.add(BigBatch / 2, 0.1f, 0);
+    reader2.add(BigBatch / 2, 0.1f, Frame::FlagDrops);
+    reader2.add(BigBatch, 0.1f, 0);
+
+    expect_output(mixer, BigBatch, 0.2f, Frame::FlagIncomplete);
+    expect_output(mixer, BigBatch, 0.2f, Frame::FlagNonblank | Frame::FlagDrops);
+    expect_output(mixer, BigBatch, 0.2f, 0);
+
+    CHECK(reader1.num_unread() == 0);
+    CHECK(reader2.num_unread() == 0);
+}
+
 } // namespace audio
 } // namespace roc
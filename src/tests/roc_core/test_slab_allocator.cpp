@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/align_ops.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/slab_allocator.h"
+
+namespace roc {
+namespace core {
+
+TEST_GROUP(slab_allocator) {};
+
+TEST(slab_allocator, allocate_deallocate) {
+    HeapAllocator heap_allocator;
+
+    {
+        SlabAllocator allocator(heap_allocator, true);
+
+        LONGS_EQUAL(0, heap_allocator.num_allocations());
+
+        void* memory = allocator.allocate(100);
+        CHECK(memory);
+
+        CHECK(heap_allocator.num_allocations() > 0);
+
+        memset(memory, 0xff, 100);
+
+        allocator.deallocate(memory);
+    }
+
+    LONGS_EQUAL(0, heap_allocator.num_allocations());
+}
+
+TEST(slab_allocator, alignment) {
+    HeapAllocator heap_allocator;
+    SlabAllocator allocator(heap_allocator, true);
+
+    const size_t sizes[] = { 1, 7, 16, 100, 1000, 5000, 100000, 10000000 };
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(sizes); n++) {
+        void* memory = allocator.allocate(sizes[n]);
+        CHECK(memory);
+
+        LONGS_EQUAL(0, (size_t)memory % AlignOps::max_alignment());
+
+        memset(memory, 0xff, sizes[n]);
+
+        allocator.deallocate(memory);
+    }
+}
+
+TEST(slab_allocator, reuse) {
+    enum { NumObjects = 50 };
+
+    const size_t sizes[] = { 10, 40, 200, 3000, 70000 };
+
+    HeapAllocator heap_allocator;
+    SlabAllocator allocator(heap_allocator, false);
+
+    void* objects[NumObjects][ROC_ARRAY_SIZE(sizes)];
+
+    for (size_t n = 0; n < NumObjects; n++) {
+        for (size_t s = 0; s < ROC_ARRAY_SIZE(sizes); s++) {
+            objects[n][s] = allocator.allocate(sizes[s]);
+            CHECK(objects[n][s]);
+        }
+    }
+
+    for (size_t n = 0; n < NumObjects; n++) {
+        for (size_t s = 0; s < ROC_ARRAY_SIZE(sizes); s++) {
+            allocator.deallocate(objects[n][s]);
+        }
+    }
+
+    const size_t n_heap_allocations = heap_allocator.num_allocations();
+
+    for (int iter = 0; iter < 3; iter++) {
+        for (size_t n = 0; n < NumObjects; n++) {
+            for (size_t s = 0; s < ROC_ARRAY_SIZE(sizes); s++) {
+                objects[n][s] = allocator.allocate(sizes[s]);
+                CHECK(objects[n][s]);
+            }
+        }
+
+        LONGS_EQUAL(n_heap_allocations, heap_allocator.num_allocations());
+
+        for (size_t n = 0; n < NumObjects; n++) {
+            for (size_t s = 0; s < ROC_ARRAY_SIZE(sizes); s++) {
+                allocator.deallocate(objects[n][s]);
+            }
+        }
+
+        LONGS_EQUAL(n_heap_allocations, heap_allocator.num_allocations());
+    }
+}
+
+TEST(slab_allocator, large) {
+    HeapAllocator heap_allocator;
+    SlabAllocator allocator(heap_allocator, false);
+
+    void* memory = allocator.allocate(10000000);
+    CHECK(memory);
+
+    LONGS_EQUAL(1, allocator.num_large_allocations());
+    LONGS_EQUAL(1, heap_allocator.num_allocations());
+
+    allocator.deallocate(memory);
+
+    LONGS_EQUAL(0, allocator.num_large_allocations());
+    LONGS_EQUAL(0, heap_allocator.num_allocations());
+}
+
+} // namespace core
+} // namespace roc
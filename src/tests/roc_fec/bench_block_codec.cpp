@@ -0,0 +1,332 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "test_helpers/loss_pattern.h"
+
+#include "roc_core/array.h"
+#include "roc_core/buffer_factory.h"
+#include "roc_core/fast_random.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/macro_helpers.h"
+#include "roc_core/panic.h"
+#include "roc_core/scoped_ptr.h"
+#include "roc_fec/codec_map.h"
+#include "roc_packet/fec_scheme_to_str.h"
+
+namespace roc {
+namespace fec {
+namespace {
+
+// --------
+// Overview
+// --------
+//
+// These benchmarks measure raw IBlockEncoder and IBlockDecoder performance,
+// without packet composing, parsing, and queueing.
+//
+// Bench_BlockEncode   - begin(), set() for every packet, fill(), end()
+// Bench_BlockDecode   - begin(), set() for every received packet, repair() for
+//                       every lost source packet, end()
+//
+// Every supported scheme from CodecMap is combined with every block size and
+// payload size. Decoding is additionally combined with every loss type (see
+// test_helpers/loss_pattern.h). Blocks longer than maximum block length of
+// the scheme are skipped. Benchmark argument is an index in the table of such
+// combinations, which is printed as a label.
+//
+// --------------
+// Output columns
+// --------------
+//
+// (all time units are microseconds)
+//
+// Time           -  wall clock time of one block
+// CPU            -  CPU time of one block
+// Iterations     -  number of blocks
+// bytes_per_sec  -  source payload bytes per second
+//
+// lost           -  average number of lost packets per block
+// fail           -  percentage (0..1) of blocks where some lost source packets
+//                   could not be restored
+
+enum {
+    // maximum payload size
+    MaxPayloadSize = 1400,
+
+    // maximum number of benchmark cases
+    MaxCases = 512
+};
+
+struct BlockSize {
+    size_t sblen;
+    size_t rblen;
+};
+
+// LDPC-Staircase requires rblen >= N1 (7 by default)
+const BlockSize block_sizes[] = {
+    { 10, 8 },    { 20, 10 },   { 50, 25 },    { 100, 50 },
+    { 170, 85 },  { 500, 250 }, { 1000, 500 }, { 2000, 1000 },
+};
+
+const size_t payload_sizes[] = { 100, 500, MaxPayloadSize };
+
+const test::LossType loss_types[] = {
+    test::Loss_None,
+    test::Loss_Random,
+    test::Loss_Burst,
+    test::Loss_WorstCase,
+};
+
+core::HeapAllocator allocator;
+core::BufferFactory<uint8_t> buffer_factory(allocator, MaxPayloadSize, false);
+
+struct Case {
+    packet::FecScheme scheme;
+    size_t sblen;
+    size_t rblen;
+    size_t payload_size;
+    test::LossType loss;
+};
+
+struct CaseTable {
+    Case cases[MaxCases];
+    size_t n_cases;
+};
+
+CaseTable encode_cases;
+CaseTable decode_cases;
+
+size_t get_max_block_length(packet::FecScheme scheme) {
+    CodecConfig config;
+    config.scheme = scheme;
+
+    core::ScopedPtr<IBlockEncoder> encoder(
+        CodecMap::instance().new_encoder(config, buffer_factory, allocator), allocator);
+    roc_panic_if_not(encoder);
+
+    return encoder->max_block_length();
+}
+
+void make_cases(benchmark::internal::Benchmark* b, CaseTable& table, bool with_losses) {
+    table.n_cases = 0;
+
+    const size_t n_losses = with_losses ? ROC_ARRAY_SIZE(loss_types) : 1;
+
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes();
+         n_scheme++) {
+        const packet::FecScheme scheme = CodecMap::instance().nth_scheme(n_scheme);
+        const size_t max_blen = get_max_block_length(scheme);
+
+        for (size_t n_bs = 0; n_bs < ROC_ARRAY_SIZE(block_sizes); n_bs++) {
+            if (block_sizes[n_bs].sblen + block_sizes[n_bs].rblen > max_blen) {
+                continue;
+            }
+            for (size_t n_ps = 0; n_ps < ROC_ARRAY_SIZE(payload_sizes); n_ps++) {
+                for (size_t n_loss = 0; n_loss < n_losses; n_loss++) {
+                    roc_panic_if_not(table.n_cases < MaxCases);
+
+                    Case& c = table.cases[table.n_cases];
+                    c.scheme = scheme;
+                    c.sblen = block_sizes[n_bs].sblen;
+                    c.rblen = block_sizes[n_bs].rblen;
+                    c.payload_size = payload_sizes[n_ps];
+                    c.loss = with_losses ? loss_types[n_loss] : test::Loss_None;
+
+                    b->Arg((int)table.n_cases);
+                    table.n_cases++;
+                }
+            }
+        }
+    }
+}
+
+void make_encode_args(benchmark::internal::Benchmark* b) {
+    make_cases(b, encode_cases, false);
+}
+
+void make_decode_args(benchmark::internal::Benchmark* b) {
+    make_cases(b, decode_cases, true);
+}
+
+void set_label(benchmark::State& state, const Case& c) {
+    char label[128];
+    snprintf(label, sizeof(label), "%s sblen=%lu rblen=%lu payload=%lu loss=%s",
+             packet::fec_scheme_to_str(c.scheme), (unsigned long)c.sblen,
+             (unsigned long)c.rblen, (unsigned long)c.payload_size,
+             test::loss_type_to_str(c.loss));
+    state.SetLabel(label);
+}
+
+// Encoded block, shared by encoder and decoder benchmarks.
+class Block {
+public:
+    Block(const Case& c)
+        : case_(c)
+        , buffers_(allocator) {
+        roc_panic_if_not(buffers_.resize(c.sblen + c.rblen));
+
+        for (size_t i = 0; i < c.sblen + c.rblen; i++) {
+            buffers_[i] = buffer_factory.new_buffer();
+            roc_panic_if_not(buffers_[i]);
+            buffers_[i].reslice(0, c.payload_size);
+
+            // repair buffers are filled by encoder
+            for (size_t j = 0; j < c.payload_size; j++) {
+                buffers_[i].data()[j] =
+                    i < c.sblen ? (uint8_t)core::fast_random(0, 0xff) : 0;
+            }
+        }
+    }
+
+    bool encode(IBlockEncoder& encoder) {
+        if (!encoder.begin(case_.sblen, case_.rblen, case_.payload_size)) {
+            return false;
+        }
+
+        for (size_t i = 0; i < case_.sblen + case_.rblen; i++) {
+            encoder.set(i, buffers_[i]);
+        }
+
+        encoder.fill();
+        encoder.end();
+
+        return true;
+    }
+
+    // Returns number of lost source packets that were not restored.
+    size_t decode(IBlockDecoder& decoder, const test::LossPattern& losses, bool check) {
+        if (!decoder.begin(case_.sblen, case_.rblen, case_.payload_size)) {
+            return case_.sblen;
+        }
+
+        for (size_t i = 0; i < case_.sblen + case_.rblen; i++) {
+            if (!losses.is_lost(i)) {
+                decoder.set(i, buffers_[i]);
+            }
+        }
+
+        size_t n_failed = 0;
+
+        for (size_t i = 0; i < case_.sblen; i++) {
+            if (!losses.is_lost(i)) {
+                continue;
+            }
+
+            core::Slice<uint8_t> restored = decoder.repair(i);
+            if (!restored) {
+                n_failed++;
+                continue;
+            }
+
+            if (check) {
+                roc_panic_if_not(restored.size() == case_.payload_size);
+                roc_panic_if_not(
+                    memcmp(restored.data(), buffers_[i].data(), case_.payload_size) == 0);
+            }
+        }
+
+        decoder.end();
+
+        return n_failed;
+    }
+
+private:
+    const Case& case_;
+    core::Array<core::Slice<uint8_t> > buffers_;
+};
+
+void BM_BlockEncode(benchmark::State& state) {
+    const Case& c = encode_cases.cases[state.range(0)];
+
+    set_label(state, c);
+
+    CodecConfig config;
+    config.scheme = c.scheme;
+
+    core::ScopedPtr<IBlockEncoder> encoder(
+        CodecMap::instance().new_encoder(config, buffer_factory, allocator), allocator);
+    roc_panic_if_not(encoder);
+
+    Block block(c);
+
+    size_t n_blocks = 0;
+
+    while (state.KeepRunning()) {
+        if (!block.encode(*encoder)) {
+            state.SkipWithError("can't encode block");
+            break;
+        }
+        n_blocks++;
+    }
+
+    state.SetBytesProcessed(int64_t(n_blocks * c.sblen * c.payload_size));
+}
+
+void BM_BlockDecode(benchmark::State& state) {
+    const Case& c = decode_cases.cases[state.range(0)];
+
+    set_label(state, c);
+
+    CodecConfig config;
+    config.scheme = c.scheme;
+
+    core::ScopedPtr<IBlockEncoder> encoder(
+        CodecMap::instance().new_encoder(config, buffer_factory, allocator), allocator);
+    roc_panic_if_not(encoder);
+
+    core::ScopedPtr<IBlockDecoder> decoder(
+        CodecMap::instance().new_decoder(config, buffer_factory, allocator), allocator);
+    roc_panic_if_not(decoder);
+
+    Block block(c);
+
+    if (!block.encode(*encoder)) {
+        state.SkipWithError("can't encode block");
+        return;
+    }
+
+    test::LossPattern losses(allocator, c.loss, c.sblen, c.rblen);
+
+    // verify restored packets once, outside of measured loop
+    for (size_t n = 0; n < test::LossPattern::NumBlocks; n++) {
+        block.decode(*decoder, losses, true);
+        losses.next();
+    }
+
+    size_t n_blocks = 0;
+    size_t n_lost = 0;
+    size_t n_failed_blocks = 0;
+
+    while (state.KeepRunning()) {
+        if (block.decode(*decoder, losses, false) != 0) {
+            n_failed_blocks++;
+        }
+
+        n_lost += losses.n_lost();
+        n_blocks++;
+
+        losses.next();
+    }
+
+    state.SetBytesProcessed(int64_t(n_blocks * c.sblen * c.payload_size));
+
+    if (n_blocks != 0) {
+        state.counters["lost"] = double(n_lost) / n_blocks;
+        state.counters["fail"] = double(n_failed_blocks) / n_blocks;
+    }
+}
+
+BENCHMARK(BM_BlockEncode)->Apply(make_encode_args)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_BlockDecode)->Apply(make_decode_args)->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace fec
+} // namespace roc
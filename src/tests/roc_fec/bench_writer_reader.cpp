@@ -0,0 +1,402 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "test_helpers/loss_pattern.h"
+
+#include "roc_core/buffer_factory.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/macro_helpers.h"
+#include "roc_core/panic.h"
+#include "roc_core/scoped_ptr.h"
+#include "roc_fec/codec_map.h"
+#include "roc_fec/composer.h"
+#include "roc_fec/headers.h"
+#include "roc_fec/parser.h"
+#include "roc_fec/reader.h"
+#include "roc_fec/writer.h"
+#include "roc_packet/fec_scheme_to_str.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_packet/queue.h"
+#include "roc_rtp/composer.h"
+#include "roc_rtp/format_map.h"
+#include "roc_rtp/headers.h"
+#include "roc_rtp/parser.h"
+
+namespace roc {
+namespace fec {
+namespace {
+
+// --------
+// Overview
+// --------
+//
+// This benchmark measures fec::Writer and fec::Reader end to end: source
+// packets are composed and written to the writer, which produces repair
+// packets; some packets are dropped according to the loss pattern; the rest
+// are parsed again, as they would be on receiver, and read from the reader,
+// which restores lost packets. The first block is delivered without losses,
+// since the reader needs it to start.
+//
+// One iteration processes one block. Every supported scheme from CodecMap
+// is combined with every block size, payload size, and loss type (see
+// test_helpers/loss_pattern.h). Blocks longer than maximum block length of
+// the scheme are skipped. Benchmark argument is an index in the table of such
+// combinations, which is printed as a label.
+//
+// --------------
+// Output columns
+// --------------
+//
+// (all time units are microseconds)
+//
+// Time           -  wall clock time of one block
+// CPU            -  CPU time of one block
+// Iterations     -  number of blocks
+// bytes_per_sec  -  source payload bytes per second
+//
+// lost           -  percentage (0..1) of source packets lost in network
+// unrest         -  percentage (0..1) of source packets that weren't restored
+
+enum {
+    // maximum FEC payload size (RTP header and payload)
+    MaxPayloadSize = 1400,
+
+    // maximum packet size (FEC header or footer and FEC payload)
+    MaxPacketSize = 1500,
+
+    // maximum number of benchmark cases
+    MaxCases = 512
+};
+
+const unsigned SourceID = 555;
+const unsigned PayloadType = rtp::PayloadType_L16_Stereo;
+
+struct BlockSize {
+    size_t sblen;
+    size_t rblen;
+};
+
+// LDPC-Staircase requires rblen >= N1 (7 by default)
+const BlockSize block_sizes[] = {
+    { 10, 8 },    { 20, 10 },   { 50, 25 },    { 100, 50 },
+    { 170, 85 },  { 500, 250 }, { 1000, 500 }, { 2000, 1000 },
+};
+
+const size_t payload_sizes[] = { 100, 500, MaxPayloadSize };
+
+const test::LossType loss_types[] = {
+    test::Loss_None,
+    test::Loss_Random,
+    test::Loss_Burst,
+    test::Loss_WorstCase,
+};
+
+core::HeapAllocator allocator;
+core::BufferFactory<uint8_t> buffer_factory(allocator, MaxPacketSize, false);
+packet::PacketFactory packet_factory(allocator, false);
+
+rtp::FormatMap format_map;
+rtp::Parser rtp_parser(format_map, NULL);
+
+Parser<RS8M_PayloadID, Source, Footer> rs8m_source_parser(&rtp_parser);
+Parser<RS8M_PayloadID, Repair, Header> rs8m_repair_parser(NULL);
+Parser<LDPC_Source_PayloadID, Source, Footer> ldpc_source_parser(&rtp_parser);
+Parser<LDPC_Repair_PayloadID, Repair, Header> ldpc_repair_parser(NULL);
+
+rtp::Composer rtp_composer(NULL);
+Composer<RS8M_PayloadID, Source, Footer> rs8m_source_composer(&rtp_composer);
+Composer<RS8M_PayloadID, Repair, Header> rs8m_repair_composer(NULL);
+Composer<LDPC_Source_PayloadID, Source, Footer> ldpc_source_composer(&rtp_composer);
+Composer<LDPC_Repair_PayloadID, Repair, Header> ldpc_repair_composer(NULL);
+
+struct Case {
+    packet::FecScheme scheme;
+    size_t sblen;
+    size_t rblen;
+    size_t payload_size;
+    test::LossType loss;
+};
+
+Case cases[MaxCases];
+size_t n_cases;
+
+size_t get_max_block_length(packet::FecScheme scheme) {
+    CodecConfig config;
+    config.scheme = scheme;
+
+    core::ScopedPtr<IBlockEncoder> encoder(
+        CodecMap::instance().new_encoder(config, buffer_factory, allocator), allocator);
+    roc_panic_if_not(encoder);
+
+    return encoder->max_block_length();
+}
+
+void make_args(benchmark::internal::Benchmark* b) {
+    n_cases = 0;
+
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes();
+         n_scheme++) {
+        const packet::FecScheme scheme = CodecMap::instance().nth_scheme(n_scheme);
+        const size_t max_blen = get_max_block_length(scheme);
+
+        for (size_t n_bs = 0; n_bs < ROC_ARRAY_SIZE(block_sizes); n_bs++) {
+            if (block_sizes[n_bs].sblen + block_sizes[n_bs].rblen > max_blen) {
+                continue;
+            }
+            for (size_t n_ps = 0; n_ps < ROC_ARRAY_SIZE(payload_sizes); n_ps++) {
+                for (size_t n_loss = 0; n_loss < ROC_ARRAY_SIZE(loss_types); n_loss++) {
+                    roc_panic_if_not(n_cases < MaxCases);
+
+                    Case& c = cases[n_cases];
+                    c.scheme = scheme;
+                    c.sblen = block_sizes[n_bs].sblen;
+                    c.rblen = block_sizes[n_bs].rblen;
+                    c.payload_size = payload_sizes[n_ps];
+                    c.loss = loss_types[n_loss];
+
+                    b->Arg((int)n_cases);
+                    n_cases++;
+                }
+            }
+        }
+    }
+}
+
+struct SchemeComposers {
+    packet::IParser* source_parser;
+    packet::IParser* repair_parser;
+    packet::IComposer* source_composer;
+    packet::IComposer* repair_composer;
+};
+
+SchemeComposers get_composers(packet::FecScheme scheme) {
+    SchemeComposers sc;
+
+    switch (scheme) {
+    case packet::FEC_ReedSolomon_M8:
+        sc.source_parser = &rs8m_source_parser;
+        sc.repair_parser = &rs8m_repair_parser;
+        sc.source_composer = &rs8m_source_composer;
+        sc.repair_composer = &rs8m_repair_composer;
+        break;
+
+    case packet::FEC_LDPC_Staircase:
+        sc.source_parser = &ldpc_source_parser;
+        sc.repair_parser = &ldpc_repair_parser;
+        sc.source_composer = &ldpc_source_composer;
+        sc.repair_composer = &ldpc_repair_composer;
+        break;
+
+    default:
+        roc_panic("bench: unsupported fec scheme");
+    }
+
+    return sc;
+}
+
+// Drops packets according to loss pattern and parses the rest again,
+// as it would happen on receiver.
+class LossyNetwork : public packet::IWriter {
+public:
+    LossyNetwork(const SchemeComposers& sc, test::LossPattern& losses, size_t blen)
+        : sc_(sc)
+        , losses_(losses)
+        , blen_(blen)
+        , packet_num_(0)
+        , n_source_lost_(0)
+        , losses_enabled_(false) {
+    }
+
+    // Start dropping packets.
+    // Must be called at block boundary.
+    void enable_losses() {
+        roc_panic_if_not(packet_num_ == 0);
+        losses_enabled_ = true;
+    }
+
+    virtual void write(const packet::PacketPtr& pp) {
+        roc_panic_if_not(pp);
+
+        const bool lost = losses_enabled_ && losses_.is_lost(packet_num_);
+
+        if (++packet_num_ == blen_) {
+            packet_num_ = 0;
+            if (losses_enabled_) {
+                losses_.next();
+            }
+        }
+
+        if (pp->flags() & packet::Packet::FlagAudio) {
+            if (lost) {
+                n_source_lost_++;
+                return;
+            }
+            source_queue_.write(reparse_(*sc_.source_parser, pp));
+        } else {
+            if (lost) {
+                return;
+            }
+            repair_queue_.write(reparse_(*sc_.repair_parser, pp));
+        }
+    }
+
+    packet::IReader& source_reader() {
+        return source_queue_;
+    }
+
+    packet::IReader& repair_reader() {
+        return repair_queue_;
+    }
+
+    size_t n_source_lost() const {
+        return n_source_lost_;
+    }
+
+private:
+    packet::PacketPtr reparse_(packet::IParser& parser, const packet::PacketPtr& old_pp) {
+        packet::PacketPtr pp = packet_factory.new_packet();
+        roc_panic_if_not(pp);
+
+        roc_panic_if_not(parser.parse(*pp, old_pp->data()));
+        pp->set_data(old_pp->data());
+
+        return pp;
+    }
+
+    const SchemeComposers sc_;
+    test::LossPattern& losses_;
+    const size_t blen_;
+
+    size_t packet_num_;
+    size_t n_source_lost_;
+
+    bool losses_enabled_;
+
+    packet::Queue source_queue_;
+    packet::Queue repair_queue_;
+};
+
+packet::PacketPtr new_source_packet(packet::IComposer& composer,
+                                    size_t sn,
+                                    size_t fec_payload_size) {
+    const size_t rtp_payload_size = fec_payload_size - sizeof(rtp::Header);
+
+    packet::PacketPtr pp = packet_factory.new_packet();
+    roc_panic_if_not(pp);
+
+    core::Slice<uint8_t> bp = buffer_factory.new_buffer();
+    roc_panic_if_not(bp);
+
+    roc_panic_if_not(composer.prepare(*pp, bp, rtp_payload_size));
+    pp->set_data(bp);
+
+    pp->add_flags(packet::Packet::FlagAudio);
+
+    pp->rtp()->source = SourceID;
+    pp->rtp()->payload_type = PayloadType;
+    pp->rtp()->seqnum = packet::seqnum_t(sn);
+    pp->rtp()->timestamp = packet::timestamp_t(sn * 10);
+
+    memset(pp->rtp()->payload.data(), int(sn & 0xff), rtp_payload_size);
+
+    return pp;
+}
+
+void BM_WriterReader(benchmark::State& state) {
+    const Case& c = cases[state.range(0)];
+
+    char label[128];
+    snprintf(label, sizeof(label), "%s sblen=%lu rblen=%lu payload=%lu loss=%s",
+             packet::fec_scheme_to_str(c.scheme), (unsigned long)c.sblen,
+             (unsigned long)c.rblen, (unsigned long)c.payload_size,
+             test::loss_type_to_str(c.loss));
+    state.SetLabel(label);
+
+    CodecConfig codec_config;
+    codec_config.scheme = c.scheme;
+
+    WriterConfig writer_config;
+    writer_config.n_source_packets = c.sblen;
+    writer_config.n_repair_packets = c.rblen;
+
+    ReaderConfig reader_config;
+
+    core::ScopedPtr<IBlockEncoder> encoder(
+        CodecMap::instance().new_encoder(codec_config, buffer_factory, allocator),
+        allocator);
+    roc_panic_if_not(encoder);
+
+    core::ScopedPtr<IBlockDecoder> decoder(
+        CodecMap::instance().new_decoder(codec_config, buffer_factory, allocator),
+        allocator);
+    roc_panic_if_not(decoder);
+
+    const SchemeComposers sc = get_composers(c.scheme);
+
+    test::LossPattern losses(allocator, c.loss, c.sblen, c.rblen);
+    LossyNetwork network(sc, losses, c.sblen + c.rblen);
+
+    Writer writer(writer_config, c.scheme, *encoder, network, *sc.source_composer,
+                  *sc.repair_composer, packet_factory, buffer_factory, allocator);
+    roc_panic_if_not(writer.valid());
+
+    Reader reader(reader_config, c.scheme, *decoder, network.source_reader(),
+                  network.repair_reader(), rtp_parser, packet_factory, allocator);
+    roc_panic_if_not(reader.valid());
+
+    size_t sn = 0;
+
+    // reader starts only when it receives first packet of a block, so
+    // deliver one block without losses before measurements
+    for (size_t i = 0; i < c.sblen; i++) {
+        writer.write(new_source_packet(*sc.source_composer, sn++, c.payload_size));
+    }
+    while (packet::PacketPtr pp = reader.read()) {
+    }
+    roc_panic_if_not(reader.started());
+
+    network.enable_losses();
+
+    size_t n_blocks = 0;
+    size_t n_read = 0;
+
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < c.sblen; i++) {
+            writer.write(new_source_packet(*sc.source_composer, sn++, c.payload_size));
+        }
+
+        while (packet::PacketPtr pp = reader.read()) {
+            n_read++;
+        }
+
+        if (!writer.alive() || !reader.alive()) {
+            state.SkipWithError("writer or reader is dead");
+            break;
+        }
+
+        n_blocks++;
+    }
+
+    const size_t n_written = n_blocks * c.sblen;
+
+    state.SetBytesProcessed(int64_t(n_written * c.payload_size));
+
+    if (n_written != 0) {
+        state.counters["lost"] = double(network.n_source_lost()) / n_written;
+        state.counters["unrest"] =
+            n_read < n_written ? double(n_written - n_read) / n_written : 0.;
+    }
+}
+
+BENCHMARK(BM_WriterReader)->Apply(make_args)->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace fec
+} // namespace roc
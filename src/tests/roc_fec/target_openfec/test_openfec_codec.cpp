@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/array.h"
+#include "roc_core/buffer_factory.h"
+#include "roc_core/fast_random.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/macro_helpers.h"
+#include "roc_fec/openfec_decoder.h"
+#include "roc_fec/openfec_encoder.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+const size_t MaxPayloadSize = 1024;
+
+core::HeapAllocator allocator;
+core::BufferFactory<uint8_t> buffer_factory(allocator, MaxPayloadSize, true);
+
+const packet::FecScheme Schemes[] = {
+    packet::FEC_ReedSolomon_M8,
+    packet::FEC_LDPC_Staircase,
+};
+
+void make_block(core::Array<core::Slice<uint8_t> >& buffers,
+                size_t sblen,
+                size_t rblen,
+                size_t payload_size) {
+    CHECK(buffers.resize(sblen + rblen));
+
+    for (size_t i = 0; i < buffers.size(); i++) {
+        buffers[i] = buffer_factory.new_buffer();
+        CHECK(buffers[i]);
+        buffers[i].reslice(0, payload_size);
+
+        for (size_t n = 0; n < payload_size; n++) {
+            buffers[i].data()[n] = (i < sblen ? (uint8_t)core::fast_random(0, 0xff) : 0);
+        }
+    }
+}
+
+void encode_block(OpenfecEncoder& encoder,
+                  core::Array<core::Slice<uint8_t> >& buffers,
+                  size_t sblen,
+                  size_t payload_size) {
+    CHECK(encoder.begin(sblen, buffers.size() - sblen, payload_size));
+    for (size_t i = 0; i < buffers.size(); i++) {
+        encoder.set(i, buffers[i]);
+    }
+    encoder.fill();
+    encoder.end();
+}
+
+void check_repaired(OpenfecDecoder& decoder,
+                    const core::Array<core::Slice<uint8_t> >& buffers,
+                    size_t sblen,
+                    size_t payload_size) {
+    for (size_t i = 0; i < sblen; i++) {
+        core::Slice<uint8_t> buf = decoder.repair(i);
+        CHECK(buf);
+        LONGS_EQUAL(payload_size, buf.size());
+        CHECK(memcmp(buf.data(), buffers[i].data(), payload_size) == 0);
+    }
+}
+
+} // namespace
+
+// OpenFEC codecs are not registered in CodecMap, so they are constructed
+// directly here.
+TEST_GROUP(openfec_codec) {};
+
+TEST(openfec_codec, alternating_block_sizes) {
+    enum { NumIterations = 3 };
+
+    // more sizes than cached encoder sessions, to check eviction
+    const size_t block_sizes[][3] = {
+        // sblen, rblen, payload_size
+        { 20, 10, 251 }, { 20, 10, 250 }, { 30, 10, 251 },
+        { 20, 15, 251 }, { 10, 8, 100 },  { 20, 10, 251 },
+    };
+
+    for (size_t s = 0; s < ROC_ARRAY_SIZE(Schemes); s++) {
+        CodecConfig config;
+        config.scheme = Schemes[s];
+
+        OpenfecEncoder encoder(config, buffer_factory, allocator);
+        OpenfecDecoder decoder(config, buffer_factory, allocator);
+        CHECK(encoder.valid());
+        CHECK(decoder.valid());
+
+        for (size_t it = 0; it < NumIterations; it++) {
+            for (size_t b = 0; b < ROC_ARRAY_SIZE(block_sizes); b++) {
+                const size_t sblen = block_sizes[b][0];
+                const size_t rblen = block_sizes[b][1];
+                const size_t payload_size = block_sizes[b][2];
+
+                core::Array<core::Slice<uint8_t> > buffers(allocator);
+                make_block(buffers, sblen, rblen, payload_size);
+                encode_block(encoder, buffers, sblen, payload_size);
+
+                // cached session should produce same repair packets as new one
+                OpenfecEncoder fresh_encoder(config, buffer_factory, allocator);
+                CHECK(fresh_encoder.valid());
+
+                core::Array<core::Slice<uint8_t> > fresh_buffers(allocator);
+                make_block(fresh_buffers, sblen, rblen, payload_size);
+                for (size_t i = 0; i < sblen; i++) {
+                    memcpy(fresh_buffers[i].data(), buffers[i].data(), payload_size);
+                }
+                encode_block(fresh_encoder, fresh_buffers, sblen, payload_size);
+
+                for (size_t i = sblen; i < sblen + rblen; i++) {
+                    CHECK(memcmp(buffers[i].data(), fresh_buffers[i].data(),
+                                 payload_size)
+                          == 0);
+                }
+
+                // lose one source packet
+                CHECK(decoder.begin(sblen, rblen, payload_size));
+                for (size_t i = 0; i < sblen + rblen; i++) {
+                    if (i != (it + b) % sblen) {
+                        decoder.set(i, buffers[i]);
+                    }
+                }
+                check_repaired(decoder, buffers, sblen, payload_size);
+                decoder.end();
+            }
+        }
+    }
+}
+
+TEST(openfec_codec, block_without_losses) {
+    enum { SourcePackets = 20, RepairPackets = 10, PayloadSize = 251, NumBlocks = 5 };
+
+    for (size_t s = 0; s < ROC_ARRAY_SIZE(Schemes); s++) {
+        CodecConfig config;
+        config.scheme = Schemes[s];
+
+        OpenfecEncoder encoder(config, buffer_factory, allocator);
+        OpenfecDecoder decoder(config, buffer_factory, allocator);
+        CHECK(encoder.valid());
+        CHECK(decoder.valid());
+
+        for (size_t nb = 0; nb < NumBlocks; nb++) {
+            core::Array<core::Slice<uint8_t> > buffers(allocator);
+            make_block(buffers, SourcePackets, RepairPackets, PayloadSize);
+            encode_block(encoder, buffers, SourcePackets, PayloadSize);
+
+            // all source packets received, repair returns them as is
+            CHECK(decoder.begin(SourcePackets, RepairPackets, PayloadSize));
+            for (size_t i = 0; i < SourcePackets; i++) {
+                decoder.set(i, buffers[i]);
+            }
+            for (size_t i = 0; i < SourcePackets; i++) {
+                core::Slice<uint8_t> buf = decoder.repair(i);
+                CHECK(buf);
+                POINTERS_EQUAL(buffers[i].data(), buf.data());
+            }
+            decoder.end();
+
+            // block with losses after block without losses
+            CHECK(decoder.begin(SourcePackets, RepairPackets, PayloadSize));
+            for (size_t i = 0; i < SourcePackets + RepairPackets; i++) {
+                if (i != nb) {
+                    decoder.set(i, buffers[i]);
+                }
+            }
+            check_repaired(decoder, buffers, SourcePackets, PayloadSize);
+            decoder.end();
+        }
+    }
+}
+
+TEST(openfec_codec, repair_after_more_packets) {
+    enum { SourcePackets = 20, RepairPackets = 10, PayloadSize = 251, NumLost = 5 };
+
+    for (size_t s = 0; s < ROC_ARRAY_SIZE(Schemes); s++) {
+        CodecConfig config;
+        config.scheme = Schemes[s];
+
+        OpenfecEncoder encoder(config, buffer_factory, allocator);
+        OpenfecDecoder decoder(config, buffer_factory, allocator);
+        CHECK(encoder.valid());
+        CHECK(decoder.valid());
+
+        core::Array<core::Slice<uint8_t> > buffers(allocator);
+        make_block(buffers, SourcePackets, RepairPackets, PayloadSize);
+        encode_block(encoder, buffers, SourcePackets, PayloadSize);
+
+        CHECK(decoder.begin(SourcePackets, RepairPackets, PayloadSize));
+
+        // only source packets received, lost ones can't be repaired yet
+        for (size_t i = NumLost; i < SourcePackets; i++) {
+            decoder.set(i, buffers[i]);
+        }
+        CHECK(!decoder.repair(0));
+
+        // repair packets arrive after session was started
+        for (size_t i = SourcePackets; i < SourcePackets + RepairPackets; i++) {
+            decoder.set(i, buffers[i]);
+        }
+        check_repaired(decoder, buffers, SourcePackets, PayloadSize);
+
+        decoder.end();
+    }
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/array.h"
+#include "roc_core/buffer_factory.h"
+#include "roc_core/fast_random.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/scoped_ptr.h"
+#include "roc_fec/codec_map.h"
+#include "roc_fec/openfec_decoder.h"
+#include "roc_fec/openfec_encoder.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+const size_t MaxPayloadSize = 1024;
+
+core::HeapAllocator allocator;
+core::BufferFactory<uint8_t> buffer_factory(allocator, MaxPayloadSize, true);
+
+const packet::FecScheme Schemes[] = {
+    packet::FEC_ReedSolomon_M8,
+    packet::FEC_LDPC_Staircase,
+};
+
+class Block {
+public:
+    Block(size_t sblen, size_t rblen, size_t payload_size)
+        : sblen_(sblen)
+        , payload_size_(payload_size)
+        , buffers_(allocator) {
+        CHECK(buffers_.resize(sblen + rblen));
+
+        for (size_t i = 0; i < buffers_.size(); i++) {
+            buffers_[i] = buffer_factory.new_buffer();
+            CHECK(buffers_[i]);
+            buffers_[i].reslice(0, payload_size);
+
+            for (size_t n = 0; n < payload_size; n++) {
+                buffers_[i].data()[n] =
+                    (i < sblen ? (uint8_t)core::fast_random(0, 0xff) : 0);
+            }
+        }
+    }
+
+    void copy_source(const Block& other) {
+        for (size_t i = 0; i < sblen_; i++) {
+            memcpy(buffers_[i].data(), other.buffers_[i].data(), payload_size_);
+        }
+    }
+
+    void encode(IBlockEncoder& encoder) {
+        CHECK(encoder.begin(sblen_, buffers_.size() - sblen_, payload_size_));
+        for (size_t i = 0; i < buffers_.size(); i++) {
+            encoder.set(i, buffers_[i]);
+        }
+        encoder.fill();
+        encoder.end();
+    }
+
+    const core::Slice<uint8_t>& buffer(size_t i) const {
+        return buffers_[i];
+    }
+
+    size_t size() const {
+        return buffers_.size();
+    }
+
+private:
+    size_t sblen_;
+    size_t payload_size_;
+    core::Array<core::Slice<uint8_t> > buffers_;
+};
+
+} // namespace
+
+// Native codecs from CodecMap should produce the same repair packets as
+// OpenFEC and should be able to decode packets produced by OpenFEC.
+TEST_GROUP(openfec_compat) {};
+
+TEST(openfec_compat, same_repair_packets) {
+    enum { PayloadSize = 200 };
+
+    const size_t block_sizes[][2] = { { 10, 7 }, { 20, 10 }, { 10, 30 }, { 100, 50 } };
+
+    for (size_t s = 0; s < ROC_ARRAY_SIZE(Schemes); s++) {
+        CodecConfig config;
+        config.scheme = Schemes[s];
+
+        core::ScopedPtr<IBlockEncoder> native_encoder(
+            CodecMap::instance().new_encoder(config, buffer_factory, allocator),
+            allocator);
+        CHECK(native_encoder);
+
+        OpenfecEncoder openfec_encoder(config, buffer_factory, allocator);
+        CHECK(openfec_encoder.valid());
+
+        for (size_t b = 0; b < ROC_ARRAY_SIZE(block_sizes); b++) {
+            const size_t sblen = block_sizes[b][0];
+            const size_t rblen = block_sizes[b][1];
+
+            Block native_block(sblen, rblen, PayloadSize);
+            Block openfec_block(sblen, rblen, PayloadSize);
+            openfec_block.copy_source(native_block);
+
+            native_block.encode(*native_encoder);
+            openfec_block.encode(openfec_encoder);
+
+            for (size_t i = sblen; i < sblen + rblen; i++) {
+                if (memcmp(native_block.buffer(i).data(),
+                           openfec_block.buffer(i).data(), PayloadSize)
+                    != 0) {
+                    FAIL("repair packets differ from openfec");
+                }
+            }
+        }
+    }
+}
+
+TEST(openfec_compat, decode_openfec_packets) {
+    enum { SourcePackets = 20, RepairPackets = 10, PayloadSize = 200, NumLost = 4 };
+
+    for (size_t s = 0; s < ROC_ARRAY_SIZE(Schemes); s++) {
+        CodecConfig config;
+        config.scheme = Schemes[s];
+
+        OpenfecEncoder openfec_encoder(config, buffer_factory, allocator);
+        CHECK(openfec_encoder.valid());
+
+        core::ScopedPtr<IBlockDecoder> native_decoder(
+            CodecMap::instance().new_decoder(config, buffer_factory, allocator),
+            allocator);
+        CHECK(native_decoder);
+
+        Block block(SourcePackets, RepairPackets, PayloadSize);
+        block.encode(openfec_encoder);
+
+        // lose every fifth source packet
+        CHECK(native_decoder->begin(SourcePackets, RepairPackets, PayloadSize));
+        for (size_t i = 0; i < block.size(); i++) {
+            if (i >= SourcePackets || i % 5 != 0) {
+                native_decoder->set(i, block.buffer(i));
+            }
+        }
+
+        for (size_t i = 0; i < SourcePackets; i++) {
+            core::Slice<uint8_t> buf = native_decoder->repair(i);
+            CHECK(buf);
+            CHECK(memcmp(buf.data(), block.buffer(i).data(), PayloadSize) == 0);
+        }
+
+        native_decoder->end();
+    }
+}
+
+} // namespace fec
+} // namespace roc
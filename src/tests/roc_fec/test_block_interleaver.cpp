@@ -0,0 +1,400 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_allocator.h"
+#include "roc_fec/block_interleaver.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_packet/queue.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+enum { NumSourcePackets = 6, NumRepairPackets = 4 };
+
+enum { BlockLength = NumSourcePackets + NumRepairPackets };
+
+core::HeapAllocator allocator;
+packet::PacketFactory packet_factory(allocator, true);
+
+packet::PacketPtr
+new_packet(size_t sbn, size_t esi, size_t sblen = NumSourcePackets,
+           size_t blen = BlockLength) {
+    packet::PacketPtr pp = packet_factory.new_packet();
+    CHECK(pp);
+
+    pp->add_flags(packet::Packet::FlagFEC
+                  | (esi < sblen ? packet::Packet::FlagAudio
+                                 : packet::Packet::FlagRepair));
+
+    pp->fec()->source_block_number = (packet::blknum_t)sbn;
+    pp->fec()->encoding_symbol_id = esi;
+    pp->fec()->source_block_length = sblen;
+    pp->fec()->block_length = blen;
+
+    return pp;
+}
+
+void write_block(BlockInterleaver& interleaver, size_t sbn) {
+    for (size_t esi = 0; esi < BlockLength; esi++) {
+        interleaver.write(new_packet(sbn, esi));
+    }
+}
+
+void check_packet(const packet::PacketPtr& pp, size_t sbn, size_t esi) {
+    CHECK(pp);
+    CHECK(pp->fec());
+
+    UNSIGNED_LONGS_EQUAL(sbn, pp->fec()->source_block_number);
+    UNSIGNED_LONGS_EQUAL(esi, pp->fec()->encoding_symbol_id);
+}
+
+// Check that group of blocks starting from first_sbn was written column by column.
+void check_group(packet::Queue& queue, size_t first_sbn, size_t span) {
+    for (size_t esi = 0; esi < BlockLength; esi++) {
+        for (size_t n = 0; n < span; n++) {
+            check_packet(queue.read(), first_sbn + n, esi);
+        }
+    }
+}
+
+} // namespace
+
+TEST_GROUP(block_interleaver) {
+    BlockInterleaverConfig make_config(size_t span) {
+        BlockInterleaverConfig config;
+        config.enabled = true;
+        config.span = span;
+        return config;
+    }
+};
+
+TEST(block_interleaver, write_group) {
+    enum { Span = 3 };
+
+    packet::Queue queue;
+    BlockInterleaver interleaver(make_config(Span), queue, allocator);
+    CHECK(interleaver.valid());
+
+    UNSIGNED_LONGS_EQUAL(Span, interleaver.span());
+
+    for (size_t sbn = 0; sbn < Span; sbn++) {
+        for (size_t esi = 0; esi < BlockLength; esi++) {
+            UNSIGNED_LONGS_EQUAL(0, queue.size());
+            interleaver.write(new_packet(sbn, esi));
+        }
+    }
+
+    UNSIGNED_LONGS_EQUAL(Span * BlockLength, queue.size());
+    check_group(queue, 0, Span);
+    UNSIGNED_LONGS_EQUAL(0, queue.size());
+}
+
+TEST(block_interleaver, write_many_groups) {
+    enum { Span = 4, NumGroups = 5 };
+
+    packet::Queue queue;
+    BlockInterleaver interleaver(make_config(Span), queue, allocator);
+    CHECK(interleaver.valid());
+
+    for (size_t n_group = 0; n_group < NumGroups; n_group++) {
+        for (size_t n = 0; n < Span; n++) {
+            UNSIGNED_LONGS_EQUAL(0, queue.size());
+            write_block(interleaver, n_group * Span + n);
+        }
+
+        UNSIGNED_LONGS_EQUAL(Span * BlockLength, queue.size());
+        check_group(queue, n_group * Span, Span);
+    }
+}
+
+TEST(block_interleaver, sbn_overflow) {
+    enum { Span = 4, NumGroups = 3 };
+
+    const size_t first_sbn = packet::blknum_t(-1) - Span;
+
+    packet::Queue queue;
+    BlockInterleaver interleaver(make_config(Span), queue, allocator);
+    CHECK(interleaver.valid());
+
+    for (size_t n_group = 0; n_group < NumGroups; n_group++) {
+        for (size_t n = 0; n < Span; n++) {
+            write_block(interleaver, packet::blknum_t(first_sbn + n_group * Span + n));
+        }
+
+        UNSIGNED_LONGS_EQUAL(Span * BlockLength, queue.size());
+
+        for (size_t esi = 0; esi < BlockLength; esi++) {
+            for (size_t n = 0; n < Span; n++) {
+                check_packet(queue.read(),
+                             packet::blknum_t(first_sbn + n_group * Span + n), esi);
+            }
+        }
+    }
+}
+
+TEST(block_interleaver, repair_packets_after_next_block) {
+    enum { Span = 3, NumBlocks = Span * 3 };
+
+    packet::Queue queue;
+    BlockInterleaver interleaver(make_config(Span), queue, allocator);
+    CHECK(interleaver.valid());
+
+    // like fec::Writer in async mode, repair packets of every block are
+    // written after source packets of the next block
+    for (size_t sbn = 0; sbn <= NumBlocks; sbn++) {
+        if (sbn < NumBlocks) {
+            for (size_t esi = 0; esi < NumSourcePackets; esi++) {
+                interleaver.write(new_packet(sbn, esi));
+            }
+        }
+        if (sbn > 0) {
+            for (size_t esi = NumSourcePackets; esi < BlockLength; esi++) {
+                interleaver.write(new_packet(sbn - 1, esi));
+            }
+        }
+
+        if (sbn % Span == 0 && sbn != 0) {
+            // group is complete, source packets of next group are still buffered
+            UNSIGNED_LONGS_EQUAL(Span * BlockLength, queue.size());
+            check_group(queue, sbn - Span, Span);
+        }
+
+        UNSIGNED_LONGS_EQUAL(0, queue.size());
+    }
+}
+
+TEST(block_interleaver, burst_losses) {
+    enum { Span = 4, NumGroups = 3, BurstLen = Span * 3 };
+
+    packet::Queue queue;
+    BlockInterleaver interleaver(make_config(Span), queue, allocator);
+    CHECK(interleaver.valid());
+
+    for (size_t sbn = 0; sbn < Span * NumGroups; sbn++) {
+        write_block(interleaver, sbn);
+    }
+
+    const size_t n_packets = queue.size();
+    UNSIGNED_LONGS_EQUAL(Span * NumGroups * BlockLength, n_packets);
+
+    packet::PacketPtr packets[Span * NumGroups * BlockLength];
+    for (size_t n = 0; n < n_packets; n++) {
+        packets[n] = queue.read();
+        CHECK(packets[n]);
+    }
+
+    // burst at every possible position, including group boundaries
+    for (size_t start = 0; start + BurstLen <= n_packets; start++) {
+        size_t n_lost[Span * NumGroups] = {};
+
+        for (size_t n = start; n < start + BurstLen; n++) {
+            n_lost[packets[n]->fec()->source_block_number]++;
+        }
+
+        for (size_t sbn = 0; sbn < Span * NumGroups; sbn++) {
+            CHECK(n_lost[sbn] <= BurstLen / Span);
+        }
+    }
+}
+
+TEST(block_interleaver, pass_through) {
+    enum { Span = 2 };
+
+    packet::Queue queue;
+    BlockInterleaver interleaver(make_config(Span), queue, allocator);
+    CHECK(interleaver.valid());
+
+    write_block(interleaver, 0);
+    UNSIGNED_LONGS_EQUAL(0, queue.size());
+
+    { // non-fec packet
+        packet::PacketPtr pp = packet_factory.new_packet();
+        CHECK(pp);
+        pp->add_flags(packet::Packet::FlagRTP);
+
+        interleaver.write(pp);
+        UNSIGNED_LONGS_EQUAL(1, queue.size());
+        CHECK(queue.read() == pp);
+    }
+
+    { // invalid esi
+        packet::PacketPtr pp = new_packet(1, BlockLength);
+
+        interleaver.write(pp);
+        UNSIGNED_LONGS_EQUAL(1, queue.size());
+        CHECK(queue.read() == pp);
+    }
+
+    { // duplicate packet
+        packet::PacketPtr pp = new_packet(0, 1);
+
+        interleaver.write(pp);
+        UNSIGNED_LONGS_EQUAL(1, queue.size());
+        CHECK(queue.read() == pp);
+    }
+
+    write_block(interleaver, 1);
+    UNSIGNED_LONGS_EQUAL(Span * BlockLength, queue.size());
+    check_group(queue, 0, Span);
+
+    { // packet from block which was already sent
+        packet::PacketPtr pp = new_packet(1, 3);
+
+        interleaver.write(pp);
+        UNSIGNED_LONGS_EQUAL(1, queue.size());
+        CHECK(queue.read() == pp);
+    }
+}
+
+TEST(block_interleaver, incomplete_group) {
+    enum { Span = 3 };
+
+    packet::Queue queue;
+    BlockInterleaver interleaver(make_config(Span), queue, allocator);
+    CHECK(interleaver.valid());
+
+    // blocks 0 and 1 are complete, block 2 lacks one packet
+    write_block(interleaver, 0);
+    write_block(interleaver, 1);
+    for (size_t esi = 1; esi < BlockLength; esi++) {
+        interleaver.write(new_packet(2, esi));
+    }
+
+    // next group is buffered
+    write_block(interleaver, 3);
+    write_block(interleaver, 4);
+    write_block(interleaver, 5);
+    UNSIGNED_LONGS_EQUAL(0, queue.size());
+
+    // block from group after next pushes out current group
+    interleaver.write(new_packet(6, 0));
+    UNSIGNED_LONGS_EQUAL(Span * BlockLength * 2 - 1, queue.size());
+
+    for (size_t esi = 0; esi < BlockLength; esi++) {
+        for (size_t n = 0; n < Span; n++) {
+            if (n == 2 && esi == 0) {
+                continue;
+            }
+            check_packet(queue.read(), n, esi);
+        }
+    }
+
+    // next group became current one and was complete
+    check_group(queue, 3, Span);
+    UNSIGNED_LONGS_EQUAL(0, queue.size());
+
+    interleaver.flush();
+    UNSIGNED_LONGS_EQUAL(1, queue.size());
+    check_packet(queue.read(), 6, 0);
+}
+
+TEST(block_interleaver, sbn_jump) {
+    enum { Span = 2 };
+
+    packet::Queue queue;
+    BlockInterleaver interleaver(make_config(Span), queue, allocator);
+    CHECK(interleaver.valid());
+
+    write_block(interleaver, 0);
+    UNSIGNED_LONGS_EQUAL(0, queue.size());
+
+    // buffered block is sent, interleaving restarts from new block
+    write_block(interleaver, 1000);
+    UNSIGNED_LONGS_EQUAL(BlockLength, queue.size());
+    for (size_t esi = 0; esi < BlockLength; esi++) {
+        check_packet(queue.read(), 0, esi);
+    }
+
+    write_block(interleaver, 1001);
+    UNSIGNED_LONGS_EQUAL(Span * BlockLength, queue.size());
+    check_group(queue, 1000, Span);
+}
+
+TEST(block_interleaver, block_length_change) {
+    enum { Span = 2, NewBlockLength = BlockLength + 2 };
+
+    packet::Queue queue;
+    BlockInterleaver interleaver(make_config(Span), queue, allocator);
+    CHECK(interleaver.valid());
+
+    write_block(interleaver, 0);
+    UNSIGNED_LONGS_EQUAL(0, queue.size());
+
+    // longer block, buffered packets are sent
+    for (size_t esi = 0; esi < NewBlockLength; esi++) {
+        interleaver.write(new_packet(1, esi, NumSourcePackets, NewBlockLength));
+    }
+    UNSIGNED_LONGS_EQUAL(BlockLength, queue.size());
+    for (size_t esi = 0; esi < BlockLength; esi++) {
+        check_packet(queue.read(), 0, esi);
+    }
+
+    // shorter block, group is complete
+    write_block(interleaver, 2);
+    UNSIGNED_LONGS_EQUAL(NewBlockLength + BlockLength, queue.size());
+
+    for (size_t esi = 0; esi < NewBlockLength; esi++) {
+        check_packet(queue.read(), 1, esi);
+        if (esi < BlockLength) {
+            check_packet(queue.read(), 2, esi);
+        }
+    }
+}
+
+TEST(block_interleaver, flush) {
+    enum { Span = 4 };
+
+    packet::Queue queue;
+    BlockInterleaver interleaver(make_config(Span), queue, allocator);
+    CHECK(interleaver.valid());
+
+    write_block(interleaver, 0);
+    write_block(interleaver, 1);
+    UNSIGNED_LONGS_EQUAL(0, queue.size());
+
+    interleaver.flush();
+    UNSIGNED_LONGS_EQUAL(BlockLength * 2, queue.size());
+    check_group(queue, 0, 2);
+
+    interleaver.flush();
+    UNSIGNED_LONGS_EQUAL(0, queue.size());
+}
+
+TEST(block_interleaver, max_delay) {
+    packet::Queue queue;
+    BlockInterleaver interleaver(make_config(5), queue, allocator);
+    CHECK(interleaver.valid());
+
+    UNSIGNED_LONGS_EQUAL(5 * NumSourcePackets, interleaver.max_delay(NumSourcePackets));
+}
+
+TEST(block_interleaver, invalid_span) {
+    packet::Queue queue;
+
+    {
+        BlockInterleaver interleaver(make_config(0), queue, allocator);
+        CHECK(!interleaver.valid());
+    }
+    {
+        BlockInterleaver interleaver(make_config(BlockInterleaver::MaxSpan + 1), queue,
+                                     allocator);
+        CHECK(!interleaver.valid());
+    }
+    {
+        BlockInterleaver interleaver(make_config(BlockInterleaver::MaxSpan), queue,
+                                     allocator);
+        CHECK(interleaver.valid());
+    }
+}
+
+} // namespace fec
+} // namespace roc
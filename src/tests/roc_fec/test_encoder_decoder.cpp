@@ -9,6 +9,7 @@
 #include <CppUTest/TestHarness.h>
 
 #include "roc_core/array.h"
+#include "roc_core/macro_helpers.h"
 #include "roc_core/buffer_factory.h"
 #include "roc_core/fast_random.h"
 #include "roc_core/heap_allocator.h"
@@ -221,6 +222,73 @@ TEST(encoder_decoder, full_repair_payload_sizes) {
     }
 }
 
+TEST(encoder_decoder, varying_block_sizes) {
+    enum { NumIterations = 3 };
+
+    const size_t block_sizes[][3] = {
+        // n_source, n_repair, payload_size
+        { 20, 10, 251 }, { 20, 10, 250 }, { 30, 10, 251 },
+        { 20, 15, 251 }, { 10, 8, 100 },  { 20, 10, 251 },
+    };
+
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
+        CodecConfig config;
+        config.scheme = CodecMap::instance().nth_scheme(n_scheme);
+
+        Codec code(config);
+
+        for (size_t test_num = 0; test_num < NumIterations; ++test_num) {
+            for (size_t n = 0; n < ROC_ARRAY_SIZE(block_sizes); n++) {
+                const size_t n_source = block_sizes[n][0];
+                const size_t n_repair = block_sizes[n][1];
+                const size_t p_size = block_sizes[n][2];
+
+                code.encode(n_source, n_repair, p_size);
+
+                CHECK(code.decoder().begin(n_source, n_repair, p_size));
+
+                for (size_t i = 0; i < n_source + n_repair; ++i) {
+                    if (i == n % n_source) {
+                        continue;
+                    }
+                    code.decoder().set(i, code.get_buffer(i));
+                }
+                CHECK(code.decode(n_source, p_size));
+
+                code.decoder().end();
+            }
+        }
+    }
+}
+
+TEST(encoder_decoder, repair_after_more_packets) {
+    enum { NumSourcePackets = 20, NumRepairPackets = 10, PayloadSize = 251 };
+
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
+        CodecConfig config;
+        config.scheme = CodecMap::instance().nth_scheme(n_scheme);
+
+        Codec code(config);
+        code.encode(NumSourcePackets, NumRepairPackets, PayloadSize);
+
+        CHECK(code.decoder().begin(NumSourcePackets, NumRepairPackets, PayloadSize));
+
+        // not enough packets
+        for (size_t i = 1; i < NumSourcePackets; ++i) {
+            code.decoder().set(i, code.get_buffer(i));
+        }
+        CHECK(!code.decoder().repair(0));
+
+        // add repair packets after failed repair
+        for (size_t i = NumSourcePackets; i < NumSourcePackets + NumRepairPackets; ++i) {
+            code.decoder().set(i, code.get_buffer(i));
+        }
+        CHECK(code.decode(NumSourcePackets, PayloadSize));
+
+        code.decoder().end();
+    }
+}
+
 TEST(encoder_decoder, max_source_block) {
     for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); ++n_scheme) {
         CodecConfig config;
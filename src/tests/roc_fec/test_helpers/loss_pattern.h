@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef ROC_FEC_TEST_HELPERS_LOSS_PATTERN_H_
+#define ROC_FEC_TEST_HELPERS_LOSS_PATTERN_H_
+
+#include "roc_core/array.h"
+#include "roc_core/fast_random.h"
+#include "roc_core/iallocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
+
+namespace roc {
+namespace fec {
+namespace test {
+
+// Type of losses within a block.
+enum LossType {
+    // no losses
+    Loss_None,
+
+    // every packet is lost independently, with probability chosen so that
+    // on average half of repair packets is needed
+    Loss_Random,
+
+    // contiguous run of packets covering half of repair packets is lost,
+    // starting at random position
+    Loss_Burst,
+
+    // first rblen source packets are lost, so that decoder has to use
+    // every repair packet to restore the maximum possible number of packets
+    Loss_WorstCase
+};
+
+inline const char* loss_type_to_str(LossType type) {
+    switch (type) {
+    case Loss_None:
+        return "none";
+    case Loss_Random:
+        return "random";
+    case Loss_Burst:
+        return "burst";
+    case Loss_WorstCase:
+        return "worst";
+    }
+    return "<invalid>";
+}
+
+// Generates set of lost packets for every block.
+// Indices [0; sblen) refer to source packets, [sblen; sblen+rblen) to repair.
+// Losses for a number of blocks are generated in advance, so that switching
+// to next block is cheap and doesn't affect measurements.
+class LossPattern : public core::NonCopyable<> {
+public:
+    enum { NumBlocks = 64 };
+
+    LossPattern(core::IAllocator& allocator, LossType type, size_t sblen, size_t rblen)
+        : type_(type)
+        , sblen_(sblen)
+        , rblen_(rblen)
+        , lost_(allocator)
+        , n_lost_(allocator)
+        , block_(0) {
+        roc_panic_if_not(sblen > 0);
+        roc_panic_if_not(lost_.resize((sblen + rblen) * NumBlocks));
+        roc_panic_if_not(n_lost_.resize(NumBlocks));
+
+        for (size_t n = 0; n < NumBlocks; n++) {
+            generate_(n);
+        }
+    }
+
+    // Switch to next block.
+    void next() {
+        block_ = (block_ + 1) % NumBlocks;
+    }
+
+    // Check if packet with given index is lost in current block.
+    bool is_lost(size_t index) const {
+        roc_panic_if_not(index < sblen_ + rblen_);
+        return lost_[block_ * (sblen_ + rblen_) + index];
+    }
+
+    // Get number of lost packets in current block.
+    size_t n_lost() const {
+        return n_lost_[block_];
+    }
+
+private:
+    void generate_(size_t block) {
+        const size_t blen = sblen_ + rblen_;
+
+        bool* lost = &lost_[block * blen];
+        size_t& n_lost = n_lost_[block];
+
+        for (size_t i = 0; i < blen; i++) {
+            lost[i] = false;
+        }
+        n_lost = 0;
+
+        switch (type_) {
+        case Loss_None:
+            break;
+
+        case Loss_Random: {
+            // P = rblen / blen / 2, in units of 1/65536
+            const uint32_t threshold = uint32_t(rblen_ * 65536 / blen / 2);
+            for (size_t i = 0; i < blen; i++) {
+                if (core::fast_random(0, 65535) < threshold) {
+                    lost[i] = true;
+                    n_lost++;
+                }
+            }
+        } break;
+
+        case Loss_Burst: {
+            const size_t burst_len = rblen_ / 2 > 0 ? rblen_ / 2 : 1;
+            const size_t start = core::fast_random(0, uint32_t(blen - burst_len));
+            for (size_t i = start; i < start + burst_len; i++) {
+                lost[i] = true;
+                n_lost++;
+            }
+        } break;
+
+        case Loss_WorstCase: {
+            for (size_t i = 0; i < rblen_ && i < sblen_; i++) {
+                lost[i] = true;
+                n_lost++;
+            }
+        } break;
+        }
+    }
+
+    const LossType type_;
+    const size_t sblen_;
+    const size_t rblen_;
+
+    core::Array<bool> lost_;
+    core::Array<size_t> n_lost_;
+
+    size_t block_;
+};
+
+} // namespace test
+} // namespace fec
+} // namespace roc
+
+#endif // ROC_FEC_TEST_HELPERS_LOSS_PATTERN_H_
@@ -0,0 +1,399 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/array.h"
+#include "roc_core/buffer_factory.h"
+#include "roc_core/fast_random.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_fec/gf256.h"
+#include "roc_fec/ldpc_decoder.h"
+#include "roc_fec/ldpc_encoder.h"
+#include "roc_fec/ldpc_matrix.h"
+#include "roc_fec/ldpc_matrix_cache.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+const size_t MaxPayloadSize = 1024;
+
+core::HeapAllocator allocator;
+core::BufferFactory<uint8_t> buffer_factory(allocator, MaxPayloadSize, true);
+
+core::Slice<uint8_t> make_buffer(size_t size) {
+    core::Slice<uint8_t> buf = buffer_factory.new_buffer();
+    CHECK(buf);
+    buf.reslice(0, size);
+    for (size_t n = 0; n < size; n++) {
+        buf.data()[n] = (uint8_t)core::fast_random(0, 0xff);
+    }
+    return buf;
+}
+
+bool has_entry(const LdpcMatrix& matrix, size_t row, size_t col) {
+    for (size_t n = 0; n < matrix.row_size(row); n++) {
+        if (matrix.row(row)[n] == col) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+TEST_GROUP(ldpc) {
+    CodecConfig config;
+
+    void setup() {
+        config.scheme = packet::FEC_LDPC_Staircase;
+    }
+
+    void encode(LdpcEncoder & encoder, core::Array<core::Slice<uint8_t> > & buffers,
+                size_t sblen, size_t rblen, size_t payload_size) {
+        CHECK(buffers.resize(sblen + rblen));
+        CHECK(encoder.begin(sblen, rblen, payload_size));
+
+        for (size_t i = 0; i < sblen + rblen; i++) {
+            buffers[i] = make_buffer(payload_size);
+            encoder.set(i, buffers[i]);
+        }
+
+        encoder.fill();
+        encoder.end();
+    }
+
+    void check_repaired(LdpcDecoder & decoder,
+                        core::Array<core::Slice<uint8_t> > & buffers, size_t sblen,
+                        size_t payload_size) {
+        for (size_t i = 0; i < sblen; i++) {
+            core::Slice<uint8_t> buf = decoder.repair(i);
+            CHECK(buf);
+            LONGS_EQUAL(payload_size, buf.size());
+            CHECK(memcmp(buf.data(), buffers[i].data(), payload_size) == 0);
+        }
+    }
+};
+
+TEST(ldpc, gf256_add) {
+    enum { MaxSize = 300, MaxOffset = 4 };
+
+    Gf256& gf = Gf256::instance();
+
+    uint8_t src[MaxSize + MaxOffset];
+    uint8_t dst[MaxSize + MaxOffset];
+    uint8_t expected[MaxSize + MaxOffset];
+
+    for (size_t size = 0; size <= MaxSize; size++) {
+        for (size_t off = 0; off < MaxOffset; off++) {
+            for (size_t n = 0; n < MaxSize + MaxOffset; n++) {
+                src[n] = (uint8_t)core::fast_random(0, 0xff);
+                dst[n] = expected[n] = (uint8_t)core::fast_random(0, 0xff);
+            }
+            for (size_t n = 0; n < size; n++) {
+                expected[off + n] ^= src[off + n];
+            }
+
+            gf.add(dst + off, src + off, size);
+
+            if (memcmp(dst, expected, sizeof(dst)) != 0) {
+                FAIL("add result differs from scalar xor");
+            }
+        }
+    }
+}
+
+TEST(ldpc, matrix_structure) {
+    enum { NumSource = 30, NumRepair = 15, N1 = 7 };
+
+    LdpcMatrix matrix(allocator);
+    CHECK(matrix.generate(NumSource, NumRepair, 1297501556, N1));
+
+    LONGS_EQUAL(NumSource, matrix.num_source());
+    LONGS_EQUAL(NumRepair, matrix.num_repair());
+
+    // at least N1 "1s" in every source column
+    for (size_t c = 0; c < NumSource; c++) {
+        CHECK(matrix.col_size(c) >= N1);
+    }
+
+    // staircase in repair columns
+    for (size_t r = 0; r < NumRepair; r++) {
+        for (size_t c = NumSource; c < NumSource + NumRepair; c++) {
+            const bool expected = (c == NumSource + r || c + 1 == NumSource + r);
+            CHECK(has_entry(matrix, r, c) == expected);
+        }
+    }
+
+    // rows and columns are consistent
+    size_t n_row_entries = 0, n_col_entries = 0;
+    for (size_t r = 0; r < NumRepair; r++) {
+        n_row_entries += matrix.row_size(r);
+    }
+    for (size_t c = 0; c < NumSource + NumRepair; c++) {
+        n_col_entries += matrix.col_size(c);
+        for (size_t n = 0; n < matrix.col_size(c); n++) {
+            CHECK(has_entry(matrix, matrix.col(c)[n], c));
+        }
+    }
+    LONGS_EQUAL(n_row_entries, n_col_entries);
+}
+
+TEST(ldpc, matrix_low_rate) {
+    // code rate below 2/(2+N1), rows get extra "1s"
+    enum { NumSource = 4, NumRepair = 40, N1 = 3 };
+
+    LdpcMatrix matrix(allocator);
+    CHECK(matrix.generate(NumSource, NumRepair, 1, N1));
+
+    for (size_t r = 0; r < NumRepair; r++) {
+        size_t n_source_cols = 0;
+        for (size_t n = 0; n < matrix.row_size(r); n++) {
+            if (matrix.row(r)[n] < NumSource) {
+                n_source_cols++;
+            }
+        }
+        CHECK(n_source_cols >= 2);
+    }
+}
+
+TEST(ldpc, matrix_deterministic) {
+    LdpcMatrix matrix1(allocator);
+    LdpcMatrix matrix2(allocator);
+
+    CHECK(matrix1.generate(20, 10, 12345, 7));
+    CHECK(matrix2.generate(20, 10, 12345, 7));
+
+    for (size_t r = 0; r < 10; r++) {
+        LONGS_EQUAL(matrix1.row_size(r), matrix2.row_size(r));
+        for (size_t n = 0; n < matrix1.row_size(r); n++) {
+            LONGS_EQUAL(matrix1.row(r)[n], matrix2.row(r)[n]);
+        }
+    }
+}
+
+TEST(ldpc, matrix_cache) {
+    LdpcMatrixCache cache(12345, 7, allocator);
+
+    const LdpcMatrix* matrix = cache.get(20, 10);
+    CHECK(matrix);
+    LONGS_EQUAL(20, matrix->num_source());
+    LONGS_EQUAL(10, matrix->num_repair());
+    LONGS_EQUAL(1, cache.num_generated());
+
+    LdpcMatrix expected(allocator);
+    CHECK(expected.generate(20, 10, 12345, 7));
+
+    for (size_t r = 0; r < 10; r++) {
+        LONGS_EQUAL(expected.row_size(r), matrix->row_size(r));
+        for (size_t n = 0; n < expected.row_size(r); n++) {
+            LONGS_EQUAL(expected.row(r)[n], matrix->row(r)[n]);
+        }
+    }
+
+    // alternating between cached sizes doesn't generate matrices
+    for (size_t n = 0; n < 10; n++) {
+        CHECK(cache.get(20, (n % 2) ? 10 : 15));
+    }
+    LONGS_EQUAL(2, cache.num_generated());
+
+    POINTERS_EQUAL(matrix, cache.get(20, 10));
+    LONGS_EQUAL(2, cache.num_generated());
+
+    // older matrices are evicted
+    CHECK(cache.get(30, 10));
+    CHECK(cache.get(40, 10));
+    CHECK(cache.get(50, 10));
+    LONGS_EQUAL(5, cache.num_generated());
+
+    CHECK(cache.get(20, 10));
+    LONGS_EQUAL(6, cache.num_generated());
+}
+
+TEST(ldpc, alternating_block_sizes) {
+    enum { PayloadSize = 64, NumIterations = 3, NumSizes = 6 };
+
+    const size_t sizes[NumSizes][2] = { { 20, 10 }, { 20, 15 }, { 40, 10 },
+                                        { 20, 10 }, { 10, 20 }, { 30, 8 } };
+
+    LdpcEncoder encoder(config, buffer_factory, allocator);
+    LdpcDecoder decoder(config, buffer_factory, allocator);
+
+    for (size_t it = 0; it < NumIterations; it++) {
+        for (size_t ns = 0; ns < NumSizes; ns++) {
+            const size_t sblen = sizes[ns][0];
+            const size_t rblen = sizes[ns][1];
+
+            core::Array<core::Slice<uint8_t> > buffers(allocator);
+            encode(encoder, buffers, sblen, rblen, PayloadSize);
+
+            // lose one source packet
+            const size_t lost = (it + ns) % sblen;
+
+            CHECK(decoder.begin(sblen, rblen, PayloadSize));
+
+            for (size_t i = 0; i < sblen + rblen; i++) {
+                if (i != lost) {
+                    decoder.set(i, buffers[i]);
+                }
+            }
+
+            check_repaired(decoder, buffers, sblen, PayloadSize);
+            decoder.end();
+        }
+    }
+}
+
+TEST(ldpc, repair_single_loss) {
+    enum { SourcePackets = 20, RepairPackets = 10, PayloadSize = 251 };
+
+    LdpcEncoder encoder(config, buffer_factory, allocator);
+    LdpcDecoder decoder(config, buffer_factory, allocator);
+    CHECK(encoder.valid());
+    CHECK(decoder.valid());
+
+    core::Array<core::Slice<uint8_t> > buffers(allocator);
+    encode(encoder, buffers, SourcePackets, RepairPackets, PayloadSize);
+
+    for (size_t lost = 0; lost < SourcePackets; lost++) {
+        CHECK(decoder.begin(SourcePackets, RepairPackets, PayloadSize));
+
+        for (size_t i = 0; i < SourcePackets + RepairPackets; i++) {
+            if (i != lost) {
+                decoder.set(i, buffers[i]);
+            }
+        }
+
+        check_repaired(decoder, buffers, SourcePackets, PayloadSize);
+        decoder.end();
+    }
+}
+
+TEST(ldpc, repair_from_repair_packets) {
+    enum { SourcePackets = 10, RepairPackets = 30, PayloadSize = 100 };
+
+    LdpcEncoder encoder(config, buffer_factory, allocator);
+    LdpcDecoder decoder(config, buffer_factory, allocator);
+
+    core::Array<core::Slice<uint8_t> > buffers(allocator);
+    encode(encoder, buffers, SourcePackets, RepairPackets, PayloadSize);
+
+    CHECK(decoder.begin(SourcePackets, RepairPackets, PayloadSize));
+
+    for (size_t i = SourcePackets; i < SourcePackets + RepairPackets; i++) {
+        decoder.set(i, buffers[i]);
+    }
+
+    check_repaired(decoder, buffers, SourcePackets, PayloadSize);
+    decoder.end();
+}
+
+TEST(ldpc, random_losses) {
+    enum {
+        SourcePackets = 100,
+        RepairPackets = 50,
+        PayloadSize = 64,
+        NumIterations = 50,
+        NumLost = 30
+    };
+
+    LdpcEncoder encoder(config, buffer_factory, allocator);
+    LdpcDecoder decoder(config, buffer_factory, allocator);
+
+    core::Array<core::Slice<uint8_t> > buffers(allocator);
+
+    size_t n_fails = 0;
+
+    for (size_t iter = 0; iter < NumIterations; iter++) {
+        encode(encoder, buffers, SourcePackets, RepairPackets, PayloadSize);
+
+        bool lost[SourcePackets + RepairPackets] = {};
+        for (size_t n = 0; n < NumLost;) {
+            const size_t i = core::fast_random(0, SourcePackets + RepairPackets - 1);
+            if (!lost[i]) {
+                lost[i] = true;
+                n++;
+            }
+        }
+
+        CHECK(decoder.begin(SourcePackets, RepairPackets, PayloadSize));
+
+        for (size_t i = 0; i < SourcePackets + RepairPackets; i++) {
+            if (!lost[i]) {
+                decoder.set(i, buffers[i]);
+            }
+        }
+
+        for (size_t i = 0; i < SourcePackets; i++) {
+            core::Slice<uint8_t> buf = decoder.repair(i);
+            if (!buf) {
+                n_fails++;
+                break;
+            }
+            // repaired packets are never wrong
+            CHECK(memcmp(buf.data(), buffers[i].data(), PayloadSize) == 0);
+        }
+
+        decoder.end();
+    }
+
+    CHECK(n_fails < NumIterations / 10);
+}
+
+TEST(ldpc, not_enough_packets) {
+    enum { SourcePackets = 20, RepairPackets = 10, PayloadSize = 100 };
+
+    LdpcEncoder encoder(config, buffer_factory, allocator);
+    LdpcDecoder decoder(config, buffer_factory, allocator);
+
+    core::Array<core::Slice<uint8_t> > buffers(allocator);
+    encode(encoder, buffers, SourcePackets, RepairPackets, PayloadSize);
+
+    CHECK(decoder.begin(SourcePackets, RepairPackets, PayloadSize));
+
+    for (size_t i = 0; i < SourcePackets + RepairPackets; i++) {
+        if (i >= 12) {
+            decoder.set(i, buffers[i]);
+        }
+    }
+
+    CHECK(!decoder.repair(0));
+    CHECK(decoder.repair(12));
+
+    // set more packets after failed attempt
+    for (size_t i = 1; i < 12; i++) {
+        decoder.set(i, buffers[i]);
+    }
+
+    check_repaired(decoder, buffers, SourcePackets, PayloadSize);
+    decoder.end();
+}
+
+TEST(ldpc, invalid_params) {
+    LdpcEncoder encoder(config, buffer_factory, allocator);
+    LdpcDecoder decoder(config, buffer_factory, allocator);
+
+    // less repair packets than N1
+    CHECK(!encoder.begin(20, 6, 100));
+    CHECK(!decoder.begin(20, 6, 100));
+
+    CHECK(!encoder.begin(0, 10, 100));
+    CHECK(!decoder.begin(0, 10, 100));
+
+    config.ldpc_prng_seed = 0;
+
+    LdpcEncoder bad_encoder(config, buffer_factory, allocator);
+    LdpcDecoder bad_decoder(config, buffer_factory, allocator);
+    CHECK(!bad_encoder.valid());
+    CHECK(!bad_decoder.valid());
+}
+
+} // namespace fec
+} // namespace roc
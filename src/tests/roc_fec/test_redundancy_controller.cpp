@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_fec/redundancy_controller.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+enum { NumSourcePackets = 20, NumRepairPackets = 10 };
+
+RedundancyConfig make_config() {
+    RedundancyConfig config;
+    config.enabled = true;
+    config.min_repair_packets = 2;
+    config.max_repair_packets = 40;
+    config.loss_margin = 2.0f;
+    config.loss_rise_factor = 0.5f;
+    config.loss_fall_factor = 0.1f;
+    return config;
+}
+
+} // namespace
+
+TEST_GROUP(redundancy_controller) {};
+
+TEST(redundancy_controller, initial_clamping) {
+    RedundancyConfig config = make_config();
+
+    {
+        RedundancyController controller(config, NumSourcePackets, NumRepairPackets);
+        CHECK(controller.valid());
+
+        UNSIGNED_LONGS_EQUAL(NumRepairPackets, controller.n_repair_packets());
+    }
+    {
+        RedundancyController controller(config, NumSourcePackets, 0);
+        CHECK(controller.valid());
+
+        UNSIGNED_LONGS_EQUAL(config.min_repair_packets, controller.n_repair_packets());
+    }
+    {
+        RedundancyController controller(config, NumSourcePackets, 100);
+        CHECK(controller.valid());
+
+        UNSIGNED_LONGS_EQUAL(config.max_repair_packets, controller.n_repair_packets());
+    }
+}
+
+TEST(redundancy_controller, no_losses) {
+    RedundancyConfig config = make_config();
+
+    RedundancyController controller(config, NumSourcePackets, NumRepairPackets);
+    CHECK(controller.valid());
+
+    CHECK(controller.update(0));
+    UNSIGNED_LONGS_EQUAL(config.min_repair_packets, controller.n_repair_packets());
+
+    for (size_t n = 0; n < 100; n++) {
+        CHECK(!controller.update(0));
+        UNSIGNED_LONGS_EQUAL(config.min_repair_packets, controller.n_repair_packets());
+    }
+
+    DOUBLES_EQUAL(0, controller.loss_rate(), 1e-6);
+}
+
+TEST(redundancy_controller, losses_increase_redundancy) {
+    RedundancyConfig config = make_config();
+
+    RedundancyController controller(config, NumSourcePackets, 0);
+    CHECK(controller.valid());
+
+    size_t prev_n_repair = controller.n_repair_packets();
+
+    for (size_t n = 0; n < 20; n++) {
+        controller.update(0.1f);
+
+        CHECK(controller.n_repair_packets() >= prev_n_repair);
+        prev_n_repair = controller.n_repair_packets();
+    }
+
+    DOUBLES_EQUAL(0.1, controller.loss_rate(), 1e-3);
+
+    // 2 + round(2 * 0.1 * 20 / 0.9)
+    UNSIGNED_LONGS_EQUAL(6, controller.n_repair_packets());
+}
+
+TEST(redundancy_controller, fast_rise_slow_fall) {
+    RedundancyConfig config = make_config();
+
+    RedundancyController controller(config, NumSourcePackets, 0);
+    CHECK(controller.valid());
+
+    // single report of a loss burst raises redundancy immediately
+    CHECK(controller.update(0.2f));
+    CHECK(controller.n_repair_packets() > config.min_repair_packets);
+
+    const size_t burst_n_repair = controller.n_repair_packets();
+
+    // single good report doesn't drop it back
+    controller.update(0);
+    CHECK(controller.n_repair_packets() > config.min_repair_packets);
+    CHECK(controller.n_repair_packets() <= burst_n_repair);
+
+    // eventually redundancy returns to minimum
+    for (size_t n = 0; n < 100; n++) {
+        controller.update(0);
+    }
+    UNSIGNED_LONGS_EQUAL(config.min_repair_packets, controller.n_repair_packets());
+}
+
+TEST(redundancy_controller, max_repair_packets) {
+    RedundancyConfig config = make_config();
+    config.max_repair_packets = 8;
+
+    RedundancyController controller(config, NumSourcePackets, 0);
+    CHECK(controller.valid());
+
+    for (size_t n = 0; n < 20; n++) {
+        controller.update(0.4f);
+        CHECK(controller.n_repair_packets() <= config.max_repair_packets);
+    }
+    UNSIGNED_LONGS_EQUAL(config.max_repair_packets, controller.n_repair_packets());
+
+    // out of range values are clamped
+    controller.update(1.0f);
+    UNSIGNED_LONGS_EQUAL(config.max_repair_packets, controller.n_repair_packets());
+
+    controller.update(-1.0f);
+    CHECK(controller.loss_rate() >= 0);
+}
+
+TEST(redundancy_controller, report_counters) {
+    RedundancyConfig config = make_config();
+    config.loss_rise_factor = 1;
+    config.loss_fall_factor = 1;
+
+    RedundancyController controller(config, NumSourcePackets, 0);
+    CHECK(controller.valid());
+
+    // first report, only fraction can be used
+    controller.update(0.5f, 1000, 5000);
+    DOUBLES_EQUAL(0.5, controller.loss_rate(), 1e-6);
+
+    // 10 of 100 packets lost, fraction is ignored
+    controller.update(0, 1010, 5100);
+    DOUBLES_EQUAL(0.1, controller.loss_rate(), 1e-6);
+
+    // previous report was lost, counters cover both intervals
+    controller.update(0, 1040, 5300);
+    DOUBLES_EQUAL(0.15, controller.loss_rate(), 1e-6);
+
+    // nothing received since previous report
+    CHECK(!controller.update(0, 1040, 5300));
+    DOUBLES_EQUAL(0.15, controller.loss_rate(), 1e-6);
+
+    // no losses
+    controller.update(0.2f, 1040, 5400);
+    DOUBLES_EQUAL(0, controller.loss_rate(), 1e-6);
+}
+
+TEST(redundancy_controller, report_counters_wrap) {
+    RedundancyConfig config = make_config();
+    config.loss_rise_factor = 1;
+    config.loss_fall_factor = 1;
+
+    RedundancyController controller(config, NumSourcePackets, 0);
+    CHECK(controller.valid());
+
+    controller.update(0, 0, 0xFFFFFFF0u);
+    DOUBLES_EQUAL(0, controller.loss_rate(), 1e-6);
+
+    controller.update(0, 20, 0xFFFFFFF0u + 200);
+    DOUBLES_EQUAL(0.1, controller.loss_rate(), 1e-6);
+}
+
+TEST(redundancy_controller, report_counters_backwards) {
+    RedundancyConfig config = make_config();
+    config.loss_rise_factor = 1;
+    config.loss_fall_factor = 1;
+
+    RedundancyController controller(config, NumSourcePackets, 0);
+    CHECK(controller.valid());
+
+    controller.update(0, 100, 5000);
+
+    // receiver restarted, fraction is used
+    controller.update(0.25f, 10, 200);
+    DOUBLES_EQUAL(0.25, controller.loss_rate(), 1e-6);
+
+    // counters are tracked again from restarted receiver
+    controller.update(0.25f, 20, 300);
+    DOUBLES_EQUAL(0.1, controller.loss_rate(), 1e-6);
+
+    // duplicates made cumulative loss decrease, fraction is used
+    controller.update(0, 15, 400);
+    DOUBLES_EQUAL(0, controller.loss_rate(), 1e-6);
+}
+
+TEST(redundancy_controller, invalid_config) {
+    {
+        RedundancyConfig config = make_config();
+
+        RedundancyController controller(config, 0, NumRepairPackets);
+        CHECK(!controller.valid());
+    }
+    {
+        RedundancyConfig config = make_config();
+        config.min_repair_packets = 10;
+        config.max_repair_packets = 5;
+
+        RedundancyController controller(config, NumSourcePackets, NumRepairPackets);
+        CHECK(!controller.valid());
+    }
+    {
+        RedundancyConfig config = make_config();
+        config.loss_rise_factor = 0;
+
+        RedundancyController controller(config, NumSourcePackets, NumRepairPackets);
+        CHECK(!controller.valid());
+    }
+    {
+        RedundancyConfig config = make_config();
+        config.loss_fall_factor = 2;
+
+        RedundancyController controller(config, NumSourcePackets, NumRepairPackets);
+        CHECK(!controller.valid());
+    }
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,425 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "test_helpers/packet_dispatcher.h"
+
+#include "roc_core/buffer_factory.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_fec/composer.h"
+#include "roc_fec/headers.h"
+#include "roc_fec/parser.h"
+#include "roc_fec/rlc_coefficients.h"
+#include "roc_fec/rlc_reader.h"
+#include "roc_fec/rlc_writer.h"
+#include "roc_fec/tinymt32.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_rtp/composer.h"
+#include "roc_rtp/format_map.h"
+#include "roc_rtp/headers.h"
+#include "roc_rtp/parser.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+// one repair packet per every two source packets
+const size_t WindowLength = 10;
+const size_t NumRepairPackets = 5;
+
+const size_t NumPackets = 60;
+
+const unsigned SourceID = 555;
+const unsigned PayloadType = rtp::PayloadType_L16_Stereo;
+
+const size_t FECPayloadSize = 193;
+
+const size_t MaxBuffSize = 500;
+
+core::HeapAllocator allocator;
+core::BufferFactory<uint8_t> buffer_factory(allocator, MaxBuffSize, true);
+packet::PacketFactory packet_factory(allocator, true);
+
+rtp::FormatMap format_map;
+rtp::Parser rtp_parser(format_map, NULL);
+
+Parser<RLC_Source_PayloadID, Source, Footer> source_parser(&rtp_parser);
+Parser<RLC_Repair_PayloadID, Repair, Header> repair_parser(NULL);
+
+rtp::Composer rtp_composer(NULL);
+Composer<RLC_Source_PayloadID, Source, Footer> source_composer(&rtp_composer);
+Composer<RLC_Repair_PayloadID, Repair, Header> repair_composer(NULL);
+
+// Position of source packet in the output of writer.
+size_t source_index(size_t n) {
+    return n + n * NumRepairPackets / WindowLength;
+}
+
+// Position of repair packet emitted after given source packet.
+size_t repair_index(size_t n) {
+    return source_index(n) + 1;
+}
+
+packet::PacketPtr new_packet(size_t sn) {
+    const size_t rtp_payload_size = FECPayloadSize - sizeof(rtp::Header);
+
+    packet::PacketPtr pp = packet_factory.new_packet();
+    CHECK(pp);
+
+    core::Slice<uint8_t> bp = buffer_factory.new_buffer();
+    CHECK(bp);
+
+    CHECK(source_composer.prepare(*pp, bp, rtp_payload_size));
+
+    pp->set_data(bp);
+    pp->add_flags(packet::Packet::FlagAudio);
+
+    pp->rtp()->source = SourceID;
+    pp->rtp()->payload_type = PayloadType;
+    pp->rtp()->seqnum = packet::seqnum_t(sn);
+    pp->rtp()->timestamp = packet::timestamp_t(sn * 10);
+
+    for (size_t i = 0; i < rtp_payload_size; i++) {
+        pp->rtp()->payload.data()[i] = uint8_t(sn * 7 + i);
+    }
+
+    return pp;
+}
+
+void check_packet(const packet::PacketPtr& pp, size_t sn, bool restored) {
+    const size_t rtp_payload_size = FECPayloadSize - sizeof(rtp::Header);
+
+    CHECK(pp);
+    CHECK(pp->rtp());
+
+    UNSIGNED_LONGS_EQUAL(SourceID, pp->rtp()->source);
+    UNSIGNED_LONGS_EQUAL(sn, pp->rtp()->seqnum);
+    UNSIGNED_LONGS_EQUAL(packet::timestamp_t(sn * 10), pp->rtp()->timestamp);
+    UNSIGNED_LONGS_EQUAL(rtp_payload_size, pp->rtp()->payload.size());
+
+    for (size_t i = 0; i < rtp_payload_size; i++) {
+        UNSIGNED_LONGS_EQUAL(uint8_t(sn * 7 + i), pp->rtp()->payload.data()[i]);
+    }
+
+    CHECK(((pp->flags() & packet::Packet::FlagRestored) != 0) == restored);
+}
+
+} // namespace
+
+TEST_GROUP(rlc) {
+    WriterConfig writer_config;
+
+    void setup() {
+        writer_config.n_source_packets = WindowLength;
+        writer_config.n_repair_packets = NumRepairPackets;
+    }
+};
+
+TEST(rlc, tinymt32) {
+    // first outputs for seed 1, from the reference implementation in RFC 8680
+    const uint32_t expected[] = { 2545341989u, 981918433u, 3715302833u, 2387538352u,
+                                  3591001365u };
+
+    Tinymt32 rand(1);
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(expected); n++) {
+        UNSIGNED_LONGS_EQUAL(expected[n], rand.next());
+    }
+}
+
+TEST(rlc, coefficients) {
+    uint8_t coefs1[RlcMaxWindowLength];
+    uint8_t coefs2[RlcMaxWindowLength];
+    uint8_t coefs3[RlcMaxWindowLength];
+
+    rlc_coefficients(123, coefs1, RlcMaxWindowLength);
+    rlc_coefficients(123, coefs2, RlcMaxWindowLength);
+    rlc_coefficients(124, coefs3, RlcMaxWindowLength);
+
+    size_t n_diff = 0;
+
+    for (size_t n = 0; n < RlcMaxWindowLength; n++) {
+        CHECK(coefs1[n] != 0);
+        UNSIGNED_LONGS_EQUAL(coefs1[n], coefs2[n]);
+        if (coefs1[n] != coefs3[n]) {
+            n_diff++;
+        }
+    }
+
+    CHECK(n_diff > 0);
+}
+
+TEST(rlc, composer_parser) {
+    { // source
+        packet::PacketPtr p1 = new_packet(0);
+        p1->fec()->encoding_symbol_id = 0xaabbccdd;
+        CHECK(source_composer.compose(*p1));
+
+        const uint8_t* footer = p1->data().data_end() - sizeof(RLC_Source_PayloadID);
+        UNSIGNED_LONGS_EQUAL(0xaa, footer[0]);
+        UNSIGNED_LONGS_EQUAL(0xdd, footer[3]);
+
+        packet::PacketPtr p2 = packet_factory.new_packet();
+        CHECK(source_parser.parse(*p2, p1->data()));
+
+        UNSIGNED_LONGS_EQUAL(packet::FEC_RLC, p2->fec()->fec_scheme);
+        UNSIGNED_LONGS_EQUAL(0xaabbccdd, p2->fec()->encoding_symbol_id);
+        UNSIGNED_LONGS_EQUAL(0, p2->fec()->source_block_number);
+        UNSIGNED_LONGS_EQUAL(0, p2->fec()->source_block_length);
+    }
+    { // repair
+        packet::PacketPtr p1 = packet_factory.new_packet();
+        core::Slice<uint8_t> bp = buffer_factory.new_buffer();
+        CHECK(repair_composer.prepare(*p1, bp, 10));
+        p1->set_data(bp);
+
+        p1->fec()->encoding_symbol_id = 0x11223344;
+        p1->fec()->source_block_number = 0x5566;
+        p1->fec()->source_block_length = 0x789;
+        CHECK(repair_composer.compose(*p1));
+
+        const uint8_t* header = p1->data().data();
+        UNSIGNED_LONGS_EQUAL(0x55, header[0]);
+        UNSIGNED_LONGS_EQUAL(0x66, header[1]);
+        UNSIGNED_LONGS_EQUAL(0xf7, header[2]);
+        UNSIGNED_LONGS_EQUAL(0x89, header[3]);
+        UNSIGNED_LONGS_EQUAL(0x11, header[4]);
+        UNSIGNED_LONGS_EQUAL(0x44, header[7]);
+
+        packet::PacketPtr p2 = packet_factory.new_packet();
+        CHECK(repair_parser.parse(*p2, p1->data()));
+
+        UNSIGNED_LONGS_EQUAL(packet::FEC_RLC, p2->fec()->fec_scheme);
+        UNSIGNED_LONGS_EQUAL(0x11223344, p2->fec()->encoding_symbol_id);
+        UNSIGNED_LONGS_EQUAL(0x5566, p2->fec()->source_block_number);
+        UNSIGNED_LONGS_EQUAL(0x789, p2->fec()->source_block_length);
+        UNSIGNED_LONGS_EQUAL(10, p2->fec()->payload.size());
+    }
+}
+
+TEST(rlc, no_losses) {
+    test::PacketDispatcher dispatcher(source_parser, repair_parser, packet_factory,
+                                      NumPackets * 2, 0);
+
+    RlcWriter writer(writer_config, packet::FEC_RLC, dispatcher, source_composer,
+                     repair_composer, packet_factory, buffer_factory, allocator);
+
+    RlcReader reader(packet::FEC_RLC, dispatcher.source_reader(),
+                     dispatcher.repair_reader(), rtp_parser, packet_factory,
+                     buffer_factory, allocator);
+
+    CHECK(writer.valid());
+    CHECK(reader.valid());
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        writer.write(new_packet(n));
+    }
+    dispatcher.push_stocks();
+
+    UNSIGNED_LONGS_EQUAL(NumPackets, dispatcher.source_size());
+    UNSIGNED_LONGS_EQUAL(NumPackets * NumRepairPackets / WindowLength,
+                         dispatcher.repair_size());
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        check_packet(reader.read(), n, false);
+    }
+
+    CHECK(!reader.read());
+    UNSIGNED_LONGS_EQUAL(0, reader.n_restored_packets());
+}
+
+TEST(rlc, scattered_losses) {
+    const size_t lost[] = { 7, 15, 16, 31, 44, 45, 46, 58 };
+
+    test::PacketDispatcher dispatcher(source_parser, repair_parser, packet_factory,
+                                      NumPackets * 2, 0);
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(lost); n++) {
+        dispatcher.lose(source_index(lost[n]));
+    }
+
+    RlcWriter writer(writer_config, packet::FEC_RLC, dispatcher, source_composer,
+                     repair_composer, packet_factory, buffer_factory, allocator);
+
+    RlcReader reader(packet::FEC_RLC, dispatcher.source_reader(),
+                     dispatcher.repair_reader(), rtp_parser, packet_factory,
+                     buffer_factory, allocator);
+
+    CHECK(writer.valid());
+    CHECK(reader.valid());
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        writer.write(new_packet(n));
+    }
+    dispatcher.push_stocks();
+
+    UNSIGNED_LONGS_EQUAL(NumPackets - ROC_ARRAY_SIZE(lost), dispatcher.source_size());
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        bool restored = false;
+        for (size_t i = 0; i < ROC_ARRAY_SIZE(lost); i++) {
+            if (lost[i] == n) {
+                restored = true;
+            }
+        }
+        check_packet(reader.read(), n, restored);
+    }
+
+    UNSIGNED_LONGS_EQUAL(ROC_ARRAY_SIZE(lost), reader.n_restored_packets());
+}
+
+TEST(rlc, repair_before_block_end) {
+    // block codes need the whole block to repair a loss,
+    // sliding window needs only repair packets following the loss
+    test::PacketDispatcher dispatcher(source_parser, repair_parser, packet_factory,
+                                      NumPackets * 2, 0);
+
+    dispatcher.lose(source_index(3));
+
+    RlcWriter writer(writer_config, packet::FEC_RLC, dispatcher, source_composer,
+                     repair_composer, packet_factory, buffer_factory, allocator);
+
+    RlcReader reader(packet::FEC_RLC, dispatcher.source_reader(),
+                     dispatcher.repair_reader(), rtp_parser, packet_factory,
+                     buffer_factory, allocator);
+
+    CHECK(writer.valid());
+    CHECK(reader.valid());
+
+    for (size_t n = 0; n < 4; n++) {
+        writer.write(new_packet(n));
+    }
+    dispatcher.push_stocks();
+
+    for (size_t n = 0; n < 3; n++) {
+        check_packet(reader.read(), n, false);
+    }
+
+    check_packet(reader.read(), 3, true);
+    CHECK(!reader.read());
+}
+
+TEST(rlc, burst_loss) {
+    test::PacketDispatcher dispatcher(source_parser, repair_parser, packet_factory,
+                                      NumPackets * 2, 0);
+
+    // lose as many source packets as there are repair packets per window
+    for (size_t n = 20; n < 20 + NumRepairPackets; n++) {
+        dispatcher.lose(source_index(n));
+    }
+
+    RlcWriter writer(writer_config, packet::FEC_RLC, dispatcher, source_composer,
+                     repair_composer, packet_factory, buffer_factory, allocator);
+
+    RlcReader reader(packet::FEC_RLC, dispatcher.source_reader(),
+                     dispatcher.repair_reader(), rtp_parser, packet_factory,
+                     buffer_factory, allocator);
+
+    CHECK(writer.valid());
+    CHECK(reader.valid());
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        writer.write(new_packet(n));
+    }
+    dispatcher.push_stocks();
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        check_packet(reader.read(), n, n >= 20 && n < 20 + NumRepairPackets);
+    }
+
+    UNSIGNED_LONGS_EQUAL(NumRepairPackets, reader.n_restored_packets());
+}
+
+TEST(rlc, unrecoverable_loss) {
+    test::PacketDispatcher dispatcher(source_parser, repair_parser, packet_factory,
+                                      NumPackets * 2, 0);
+
+    // lose source packet and all repair packets covering it
+    dispatcher.lose(source_index(30));
+    for (size_t n = 31; n < 30 + WindowLength; n += 2) {
+        dispatcher.lose(repair_index(n));
+    }
+
+    RlcWriter writer(writer_config, packet::FEC_RLC, dispatcher, source_composer,
+                     repair_composer, packet_factory, buffer_factory, allocator);
+
+    RlcReader reader(packet::FEC_RLC, dispatcher.source_reader(),
+                     dispatcher.repair_reader(), rtp_parser, packet_factory,
+                     buffer_factory, allocator);
+
+    CHECK(writer.valid());
+    CHECK(reader.valid());
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        writer.write(new_packet(n));
+    }
+    dispatcher.push_stocks();
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        if (n == 30) {
+            continue;
+        }
+        check_packet(reader.read(), n, false);
+    }
+
+    CHECK(!reader.read());
+    UNSIGNED_LONGS_EQUAL(0, reader.n_restored_packets());
+}
+
+TEST(rlc, late_repair_packets) {
+    test::PacketDispatcher dispatcher(source_parser, repair_parser, packet_factory,
+                                      NumPackets * 2, 0);
+
+    dispatcher.lose(source_index(NumPackets - 3));
+
+    RlcWriter writer(writer_config, packet::FEC_RLC, dispatcher, source_composer,
+                     repair_composer, packet_factory, buffer_factory, allocator);
+
+    RlcReader reader(packet::FEC_RLC, dispatcher.source_reader(),
+                     dispatcher.repair_reader(), rtp_parser, packet_factory,
+                     buffer_factory, allocator);
+
+    CHECK(writer.valid());
+    CHECK(reader.valid());
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        writer.write(new_packet(n));
+    }
+
+    // deliver source packets only, reader should wait for lost packet
+    // until following source packet is available
+    dispatcher.push_source_stock(NumPackets - 3);
+
+    for (size_t n = 0; n < NumPackets - 3; n++) {
+        check_packet(reader.read(), n, false);
+    }
+    CHECK(!reader.read());
+
+    dispatcher.push_stocks();
+
+    for (size_t n = NumPackets - 3; n < NumPackets; n++) {
+        check_packet(reader.read(), n, n == NumPackets - 3);
+    }
+}
+
+TEST(rlc, window_too_long) {
+    test::PacketDispatcher dispatcher(source_parser, repair_parser, packet_factory,
+                                      NumPackets * 2, 0);
+
+    writer_config.n_source_packets = RlcMaxWindowLength + 1;
+
+    RlcWriter writer(writer_config, packet::FEC_RLC, dispatcher, source_composer,
+                     repair_composer, packet_factory, buffer_factory, allocator);
+
+    CHECK(!writer.valid());
+}
+
+} // namespace fec
+} // namespace roc
@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/array.h"
+#include "roc_core/buffer_factory.h"
+#include "roc_core/fast_random.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_fec/gf256.h"
+#include "roc_fec/rs8m_decoder.h"
+#include "roc_fec/rs8m_encoder.h"
+#include "roc_fec/rs8m_matrix.h"
+
+namespace roc {
+namespace fec {
+
+namespace {
+
+const size_t MaxPayloadSize = 1024;
+
+core::HeapAllocator allocator;
+core::BufferFactory<uint8_t> buffer_factory(allocator, MaxPayloadSize, true);
+
+core::Slice<uint8_t> make_buffer(size_t size) {
+    core::Slice<uint8_t> buf = buffer_factory.new_buffer();
+    CHECK(buf);
+    buf.reslice(0, size);
+    for (size_t n = 0; n < size; n++) {
+        buf.data()[n] = (uint8_t)core::fast_random(0, 0xff);
+    }
+    return buf;
+}
+
+uint8_t slow_mul(uint8_t a, uint8_t b) {
+    unsigned res = 0, x = a;
+    for (; b != 0; b >>= 1) {
+        if (b & 1) {
+            res ^= x;
+        }
+        x <<= 1;
+        if (x & 0x100) {
+            x ^= 0x11d;
+        }
+    }
+    return (uint8_t)res;
+}
+
+} // namespace
+
+TEST_GROUP(rs8m) {
+    CodecConfig config;
+
+    void setup() {
+        config.scheme = packet::FEC_ReedSolomon_M8;
+    }
+
+    void encode(Rs8mEncoder & encoder, core::Array<core::Slice<uint8_t> > & buffers,
+                size_t sblen, size_t rblen, size_t payload_size) {
+        CHECK(buffers.resize(sblen + rblen));
+        CHECK(encoder.begin(sblen, rblen, payload_size));
+
+        for (size_t i = 0; i < sblen + rblen; i++) {
+            buffers[i] = make_buffer(payload_size);
+            encoder.set(i, buffers[i]);
+        }
+
+        encoder.fill();
+        encoder.end();
+    }
+};
+
+TEST(rs8m, gf256_arithmetic) {
+    Gf256& gf = Gf256::instance();
+
+    for (unsigned a = 0; a < 256; a++) {
+        for (unsigned b = 0; b < 256; b++) {
+            LONGS_EQUAL(slow_mul((uint8_t)a, (uint8_t)b), gf.mul((uint8_t)a, (uint8_t)b));
+        }
+        if (a != 0) {
+            LONGS_EQUAL(1, gf.mul((uint8_t)a, gf.inv((uint8_t)a)));
+        }
+    }
+
+    LONGS_EQUAL(1, gf.exp(0));
+    LONGS_EQUAL(2, gf.exp(1));
+    LONGS_EQUAL(0x1d, gf.exp(8));
+    LONGS_EQUAL(1, gf.exp(255));
+}
+
+TEST(rs8m, gf256_mul_add) {
+    enum { MaxSize = 300, MaxOffset = 4 };
+
+    Gf256& gf = Gf256::instance();
+
+    uint8_t src[MaxSize + MaxOffset];
+    uint8_t dst[MaxSize + MaxOffset];
+    uint8_t expected[MaxSize + MaxOffset];
+
+    for (size_t size = 0; size <= MaxSize; size++) {
+        for (size_t off = 0; off < MaxOffset; off++) {
+            const uint8_t coef = (uint8_t)core::fast_random(0, 0xff);
+
+            for (size_t n = 0; n < MaxSize + MaxOffset; n++) {
+                src[n] = (uint8_t)core::fast_random(0, 0xff);
+                dst[n] = expected[n] = (uint8_t)core::fast_random(0, 0xff);
+            }
+            for (size_t n = 0; n < size; n++) {
+                expected[off + n] ^= slow_mul(coef, src[off + n]);
+            }
+
+            gf.mul_add(dst + off, src + off, coef, size);
+
+            if (memcmp(dst, expected, sizeof(dst)) != 0) {
+                FAIL("mul_add result differs from scalar multiplication");
+            }
+        }
+    }
+}
+
+TEST(rs8m, generator_matrix) {
+    Rs8mMatrix matrix(allocator);
+    core::Array<uint8_t> result(allocator);
+
+    // top rows form identity matrix
+    CHECK(matrix.build_generator(10, 0, 10, result));
+    for (size_t r = 0; r < 10; r++) {
+        for (size_t c = 0; c < 10; c++) {
+            LONGS_EQUAL(r == c ? 1 : 0, result[r * 10 + c]);
+        }
+    }
+
+    // with single source symbol, repair symbols are copies of it
+    CHECK(matrix.build_generator(1, 1, 5, result));
+    for (size_t r = 0; r < 5; r++) {
+        LONGS_EQUAL(1, result[r]);
+    }
+
+    // [1 2] * inverse([1 0] [1 1])
+    CHECK(matrix.build_generator(2, 2, 1, result));
+    LONGS_EQUAL(3, result[0]);
+    LONGS_EQUAL(2, result[1]);
+}
+
+TEST(rs8m, decoding_matrix) {
+    enum { K = 20, N = 40 };
+
+    Gf256& gf = Gf256::instance();
+
+    Rs8mMatrix matrix(allocator);
+
+    core::Array<uint8_t> generator(allocator);
+    CHECK(matrix.build_generator(K, 0, N, generator));
+
+    for (size_t iter = 0; iter < 10; iter++) {
+        uint8_t indices[K];
+        bool used[N] = {};
+        for (size_t n = 0; n < K;) {
+            const size_t idx = core::fast_random(0, N - 1);
+            if (!used[idx]) {
+                used[idx] = true;
+                indices[n++] = (uint8_t)idx;
+            }
+        }
+
+        core::Array<uint8_t> decoder(allocator);
+        CHECK(matrix.build_decoder(K, indices, decoder));
+
+        // decoder * selected generator rows = identity
+        for (size_t r = 0; r < K; r++) {
+            for (size_t c = 0; c < K; c++) {
+                uint8_t sum = 0;
+                for (size_t t = 0; t < K; t++) {
+                    sum ^= gf.mul(decoder[r * K + t], generator[indices[t] * K + c]);
+                }
+                LONGS_EQUAL(r == c ? 1 : 0, sum);
+            }
+        }
+    }
+}
+
+TEST(rs8m, repair_all_loss_patterns) {
+    enum { SourcePackets = 6, RepairPackets = 4, PayloadSize = 97 };
+
+    Rs8mEncoder encoder(config, buffer_factory, allocator);
+    Rs8mDecoder decoder(config, buffer_factory, allocator);
+    CHECK(encoder.valid());
+    CHECK(decoder.valid());
+
+    core::Array<core::Slice<uint8_t> > buffers(allocator);
+    encode(encoder, buffers, SourcePackets, RepairPackets, PayloadSize);
+
+    const size_t n_packets = SourcePackets + RepairPackets;
+
+    // every combination of at most RepairPackets losses is repairable
+    for (unsigned mask = 0; mask < (1u << n_packets); mask++) {
+        size_t n_lost = 0;
+        for (size_t i = 0; i < n_packets; i++) {
+            if (mask & (1u << i)) {
+                n_lost++;
+            }
+        }
+        if (n_lost > RepairPackets) {
+            continue;
+        }
+
+        CHECK(decoder.begin(SourcePackets, RepairPackets, PayloadSize));
+
+        for (size_t i = 0; i < n_packets; i++) {
+            if (!(mask & (1u << i))) {
+                decoder.set(i, buffers[i]);
+            }
+        }
+
+        for (size_t i = 0; i < SourcePackets; i++) {
+            core::Slice<uint8_t> buf = decoder.repair(i);
+            CHECK(buf);
+            LONGS_EQUAL(PayloadSize, buf.size());
+            CHECK(memcmp(buf.data(), buffers[i].data(), PayloadSize) == 0);
+        }
+
+        decoder.end();
+    }
+}
+
+TEST(rs8m, not_enough_packets) {
+    enum { SourcePackets = 10, RepairPackets = 5, PayloadSize = 100 };
+
+    Rs8mEncoder encoder(config, buffer_factory, allocator);
+    Rs8mDecoder decoder(config, buffer_factory, allocator);
+
+    core::Array<core::Slice<uint8_t> > buffers(allocator);
+    encode(encoder, buffers, SourcePackets, RepairPackets, PayloadSize);
+
+    CHECK(decoder.begin(SourcePackets, RepairPackets, PayloadSize));
+
+    for (size_t i = 0; i < SourcePackets + RepairPackets; i++) {
+        if (i % 2 == 0) {
+            decoder.set(i, buffers[i]);
+        }
+    }
+
+    CHECK(decoder.repair(0));
+    CHECK(!decoder.repair(1));
+
+    // set more packets after failed attempt
+    for (size_t i = 0; i < SourcePackets + RepairPackets; i++) {
+        if (i % 2 != 0 && i >= SourcePackets) {
+            decoder.set(i, buffers[i]);
+        }
+    }
+
+    for (size_t i = 0; i < SourcePackets; i++) {
+        core::Slice<uint8_t> buf = decoder.repair(i);
+        CHECK(buf);
+        CHECK(memcmp(buf.data(), buffers[i].data(), PayloadSize) == 0);
+    }
+
+    decoder.end();
+}
+
+TEST(rs8m, max_block) {
+    enum { PayloadSize = 64 };
+
+    Rs8mEncoder encoder(config, buffer_factory, allocator);
+    Rs8mDecoder decoder(config, buffer_factory, allocator);
+
+    LONGS_EQUAL(255, encoder.max_block_length());
+    LONGS_EQUAL(255, decoder.max_block_length());
+
+    CHECK(!encoder.begin(200, 56, PayloadSize));
+    CHECK(!decoder.begin(200, 56, PayloadSize));
+
+    core::Array<core::Slice<uint8_t> > buffers(allocator);
+    encode(encoder, buffers, 200, 55, PayloadSize);
+
+    CHECK(decoder.begin(200, 55, PayloadSize));
+
+    // lose first 55 source packets
+    for (size_t i = 55; i < 255; i++) {
+        decoder.set(i, buffers[i]);
+    }
+
+    for (size_t i = 0; i < 200; i++) {
+        core::Slice<uint8_t> buf = decoder.repair(i);
+        CHECK(buf);
+        CHECK(memcmp(buf.data(), buffers[i].data(), PayloadSize) == 0);
+    }
+
+    decoder.end();
+}
+
+TEST(rs8m, alternating_block_sizes) {
+    enum { PayloadSize = 64, NumIterations = 3, NumSizes = 6 };
+
+    // more sizes than cached generator matrices, to check eviction
+    const size_t sizes[NumSizes][2] = { { 10, 2 }, { 10, 5 }, { 20, 4 },
+                                        { 10, 2 }, { 5, 5 },  { 30, 1 } };
+
+    Rs8mEncoder encoder(config, buffer_factory, allocator);
+    Rs8mDecoder decoder(config, buffer_factory, allocator);
+
+    for (size_t it = 0; it < NumIterations; it++) {
+        for (size_t ns = 0; ns < NumSizes; ns++) {
+            const size_t sblen = sizes[ns][0];
+            const size_t rblen = sizes[ns][1];
+
+            core::Array<core::Slice<uint8_t> > buffers(allocator);
+            encode(encoder, buffers, sblen, rblen, PayloadSize);
+
+            // repair packets should be the same as from fresh encoder
+            Rs8mEncoder fresh_encoder(config, buffer_factory, allocator);
+
+            core::Array<core::Slice<uint8_t> > fresh_buffers(allocator);
+            CHECK(fresh_buffers.resize(sblen + rblen));
+            CHECK(fresh_encoder.begin(sblen, rblen, PayloadSize));
+
+            for (size_t i = 0; i < sblen + rblen; i++) {
+                fresh_buffers[i] = make_buffer(PayloadSize);
+                if (i < sblen) {
+                    memcpy(fresh_buffers[i].data(), buffers[i].data(), PayloadSize);
+                }
+                fresh_encoder.set(i, fresh_buffers[i]);
+            }
+
+            fresh_encoder.fill();
+            fresh_encoder.end();
+
+            for (size_t i = sblen; i < sblen + rblen; i++) {
+                CHECK(memcmp(buffers[i].data(), fresh_buffers[i].data(), PayloadSize)
+                      == 0);
+            }
+
+            // lose first rblen source packets
+            CHECK(decoder.begin(sblen, rblen, PayloadSize));
+
+            for (size_t i = rblen; i < sblen + rblen; i++) {
+                decoder.set(i, buffers[i]);
+            }
+
+            for (size_t i = 0; i < sblen; i++) {
+                core::Slice<uint8_t> buf = decoder.repair(i);
+                CHECK(buf);
+                CHECK(memcmp(buf.data(), buffers[i].data(), PayloadSize) == 0);
+            }
+
+            decoder.end();
+        }
+    }
+}
+
+} // namespace fec
+} // namespace roc
@@ -14,6 +14,8 @@
 #include "roc_core/buffer_factory.h"
 #include "roc_core/heap_allocator.h"
 #include "roc_core/scoped_ptr.h"
+#include "roc_core/time.h"
+#include "roc_fec/block_interleaver.h"
 #include "roc_fec/codec_map.h"
 #include "roc_fec/composer.h"
 #include "roc_fec/headers.h"
@@ -61,6 +63,49 @@ Composer<RS8M_PayloadID, Repair, Header> rs8m_repair_composer(NULL);
 Composer<LDPC_Source_PayloadID, Source, Footer> ldpc_source_composer(&rtp_composer);
 Composer<LDPC_Repair_PayloadID, Repair, Header> ldpc_repair_composer(NULL);
 
+// Drops packets with given positions in written sequence.
+class BurstLossWriter : public packet::IWriter {
+public:
+    BurstLossWriter(packet::IWriter& writer, size_t begin, size_t end)
+        : writer_(writer)
+        , begin_(begin)
+        , end_(end)
+        , pos_(0) {
+    }
+
+    virtual void write(const packet::PacketPtr& pp) {
+        if (pos_ < begin_ || pos_ >= end_) {
+            writer_.write(pp);
+        }
+        pos_++;
+    }
+
+private:
+    packet::IWriter& writer_;
+    const size_t begin_;
+    const size_t end_;
+    size_t pos_;
+};
+
+// Adds flag to every packet before passing it further, like sender
+// endpoint does.
+class FlagWriter : public packet::IWriter {
+public:
+    FlagWriter(packet::IWriter& writer, unsigned flags)
+        : writer_(writer)
+        , flags_(flags) {
+    }
+
+    virtual void write(const packet::PacketPtr& pp) {
+        pp->add_flags(flags_);
+        writer_.write(pp);
+    }
+
+private:
+    packet::IWriter& writer_;
+    const unsigned flags_;
+};
+
 } // namespace
 
 TEST_GROUP(writer_reader) {
@@ -306,7 +351,11 @@ TEST(writer_reader, 1_loss) {
     }
 }
 
-TEST(writer_reader, lost_first_packet_in_first_block) {
+TEST(writer_reader, incremental_decoding) {
+    enum { NumBlocks = 3 };
+
+    reader_config.incremental_decoding = true;
+
     for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
         codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
 
@@ -336,37 +385,41 @@ TEST(writer_reader, lost_first_packet_in_first_block) {
         CHECK(writer.valid());
         CHECK(reader.valid());
 
-        // Sending first block except first packet.
-        fill_all_packets(0);
-        dispatcher.lose(0);
-        for (size_t i = 0; i < NumSourcePackets; ++i) {
-            writer.write(source_packets[i]);
-        }
+        for (size_t n_block = 0; n_block < NumBlocks; n_block++) {
+            const size_t lost_packet = 11 + n_block;
 
-        // Sending second block lossless.
-        dispatcher.clear_losses();
-        fill_all_packets(NumSourcePackets);
-        for (size_t i = 0; i < NumSourcePackets; ++i) {
-            writer.write(source_packets[i]);
-        }
-        dispatcher.push_stocks();
+            fill_all_packets(n_block * NumSourcePackets);
 
-        // Receive every sent packet except the first one.
-        for (size_t i = 1; i < NumSourcePackets * 2; ++i) {
-            packet::PacketPtr p = reader.read();
-            if (i < NumSourcePackets) {
-                CHECK(!reader.started());
-            } else {
-                CHECK(reader.started());
+            dispatcher.reset();
+            dispatcher.lose(lost_packet);
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                writer.write(source_packets[i]);
+            }
+            dispatcher.push_stocks();
+
+            LONGS_EQUAL(NumSourcePackets - 1, dispatcher.source_size());
+            LONGS_EQUAL(NumRepairPackets, dispatcher.repair_size());
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                packet::PacketPtr p = reader.read();
+                CHECK(p);
+                check_audio_packet(p, n_block * NumSourcePackets + i);
+                check_restored(p, i == lost_packet);
+
+                // lost packet is restored when the block is received,
+                // before reader reaches it
+                LONGS_EQUAL(n_block + 1, reader.n_restored_packets());
             }
-            check_audio_packet(p, i);
-            check_restored(p, false);
         }
-        CHECK(dispatcher.source_size() == 0);
+
+        CHECK(reader.alive());
     }
 }
 
-TEST(writer_reader, lost_one_source_and_all_repair_packets) {
+TEST(writer_reader, incremental_decoding_not_enough_packets) {
+    reader_config.incremental_decoding = true;
+
     for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
         codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
 
@@ -396,49 +449,53 @@ TEST(writer_reader, lost_one_source_and_all_repair_packets) {
         CHECK(writer.valid());
         CHECK(reader.valid());
 
-        // Send first block without one source and all repair packets.
-        dispatcher.lose(3);
-        for (size_t i = 0; i < NumRepairPackets; ++i) {
-            dispatcher.lose(NumSourcePackets + i);
-        }
         fill_all_packets(0);
-        for (size_t i = 0; i < NumSourcePackets; ++i) {
-            writer.write(source_packets[i]);
-        }
-        dispatcher.push_stocks();
 
-        // Send second block without one source packet.
-        dispatcher.clear_losses();
         dispatcher.lose(5);
-        fill_all_packets(NumSourcePackets);
+
         for (size_t i = 0; i < NumSourcePackets; ++i) {
             writer.write(source_packets[i]);
         }
+
+        // deliver source packets before loss and all repair packets
+        dispatcher.push_source_stock(5);
+        dispatcher.push_repair_stock(NumRepairPackets);
+
+        for (size_t i = 0; i < 5; ++i) {
+            packet::PacketPtr p = reader.read();
+            CHECK(p);
+            check_audio_packet(p, i);
+            check_restored(p, false);
+        }
+
+        // decoder has not enough packets yet
+        CHECK(!reader.read());
+        CHECK(reader.alive());
+        LONGS_EQUAL(0, reader.n_restored_packets());
+
+        // deliver remaining source packets, they're passed to the
+        // already started decoder
         dispatcher.push_stocks();
 
-        // Receive packets.
-        for (size_t i = 0; i < NumSourcePackets * 2; ++i) {
-            if (i == 3) {
-                // nop
-            } else if (i == NumSourcePackets + 5) {
-                packet::PacketPtr p = reader.read();
-                CHECK(p);
-                check_audio_packet(p, i);
-                check_restored(p, true);
-            } else {
-                packet::PacketPtr p = reader.read();
-                CHECK(p);
-                check_audio_packet(p, i);
-                check_restored(p, false);
-            }
+        for (size_t i = 5; i < NumSourcePackets; ++i) {
+            packet::PacketPtr p = reader.read();
+            CHECK(p);
+            check_audio_packet(p, i);
+            check_restored(p, i == 5);
         }
 
-        CHECK(dispatcher.source_size() == 0);
+        LONGS_EQUAL(1, reader.n_restored_packets());
     }
 }
 
-TEST(writer_reader, multiple_blocks_1_loss) {
-    enum { NumBlocks = 40 };
+TEST(writer_reader, incremental_decoding_late_packet) {
+    // 1. Delay a source packet, so that reader skips it.
+    // 2. Deliver the rest of the block except a lost packet, so that decoder
+    //    restores lost packet and also the skipped one.
+    // 3. Deliver the delayed packet, reader should pass it to decoder.
+    enum { DelayedPacket = 3, LostPacket = 15 };
+
+    reader_config.incremental_decoding = true;
 
     for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
         codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
@@ -469,52 +526,59 @@ TEST(writer_reader, multiple_blocks_1_loss) {
         CHECK(writer.valid());
         CHECK(reader.valid());
 
-        for (size_t block_num = 0; block_num < NumBlocks; ++block_num) {
-            size_t lost_sq = size_t(-1);
-            if (block_num != 5 && block_num != 21 && block_num != 22) {
-                lost_sq = (block_num + 1) % (NumSourcePackets + NumRepairPackets);
-                dispatcher.lose(lost_sq);
-            }
+        fill_all_packets(0);
 
-            fill_all_packets(NumSourcePackets * block_num);
+        dispatcher.delay(DelayedPacket);
+        dispatcher.lose(LostPacket);
 
-            for (size_t i = 0; i < NumSourcePackets; ++i) {
-                writer.write(source_packets[i]);
-            }
-            dispatcher.push_stocks();
+        for (size_t i = 0; i < NumSourcePackets; ++i) {
+            writer.write(source_packets[i]);
+        }
 
-            if (lost_sq == size_t(-1)) {
-                CHECK(dispatcher.source_size() == NumSourcePackets);
-                CHECK(dispatcher.repair_size() == NumRepairPackets);
-            } else if (lost_sq < NumSourcePackets) {
-                CHECK(dispatcher.source_size() == NumSourcePackets - 1);
-                CHECK(dispatcher.repair_size() == NumRepairPackets);
-            } else {
-                CHECK(dispatcher.source_size() == NumSourcePackets);
-                CHECK(dispatcher.repair_size() == NumRepairPackets - 1);
+        // deliver source packets up to 10, except delayed one
+        dispatcher.push_source_stock(10 - 1);
+
+        for (size_t i = 0; i < 10; ++i) {
+            if (i == DelayedPacket) {
+                continue;
             }
+            packet::PacketPtr p = reader.read();
+            CHECK(p);
+            check_audio_packet(p, i);
+            check_restored(p, false);
+        }
 
-            for (size_t i = 0; i < NumSourcePackets; ++i) {
-                packet::PacketPtr p = reader.read();
-                CHECK(p);
+        // deliver the rest of the block, decoder restores lost packet and
+        // delayed packet, but reader has already skipped the latter
+        dispatcher.push_stocks();
 
-                check_audio_packet(p, NumSourcePackets * block_num + i);
+        {
+            packet::PacketPtr p = reader.read();
+            CHECK(p);
+            check_audio_packet(p, 10);
+            check_restored(p, false);
+        }
 
-                if (lost_sq == size_t(-1)) {
-                    check_restored(p, false);
-                } else {
-                    check_restored(p,
-                                   i == lost_sq % (NumSourcePackets + NumRepairPackets));
-                }
-            }
+        // deliver delayed packet after it was restored by decoder
+        dispatcher.push_delayed(DelayedPacket);
 
-            dispatcher.reset();
+        for (size_t i = 11; i < NumSourcePackets; ++i) {
+            packet::PacketPtr p = reader.read();
+            CHECK(p);
+            check_audio_packet(p, i);
+            check_restored(p, i == LostPacket);
         }
+
+        CHECK(reader.alive());
+        LONGS_EQUAL(1, reader.n_restored_packets());
+        LONGS_EQUAL(0, dispatcher.source_size());
     }
 }
 
-TEST(writer_reader, multiple_blocks_in_queue) {
-    enum { NumBlocks = 3 };
+TEST(writer_reader, async_encoding) {
+    enum { NumBlocks = 5 };
+
+    writer_config.async_encoding = true;
 
     for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
         codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
@@ -545,33 +609,43 @@ TEST(writer_reader, multiple_blocks_in_queue) {
         CHECK(writer.valid());
         CHECK(reader.valid());
 
-        for (size_t block_num = 0; block_num < NumBlocks; ++block_num) {
-            fill_all_packets(NumSourcePackets * block_num);
+        for (size_t n_block = 0; n_block < NumBlocks; n_block++) {
+            const size_t lost_packet = 3 + n_block;
+
+            fill_all_packets(n_block * NumSourcePackets);
+
+            dispatcher.reset();
+            dispatcher.lose(lost_packet);
 
             for (size_t i = 0; i < NumSourcePackets; ++i) {
                 writer.write(source_packets[i]);
             }
-        }
-        dispatcher.push_stocks();
 
-        CHECK(dispatcher.source_size() == NumSourcePackets * NumBlocks);
-        CHECK(dispatcher.repair_size() == NumRepairPackets * NumBlocks);
+            // source packets are written immediately
+            LONGS_EQUAL(NumSourcePackets - 1, dispatcher.source_size());
+
+            writer.flush();
+            CHECK(writer.alive());
+
+            LONGS_EQUAL(NumRepairPackets, dispatcher.repair_size());
+
+            dispatcher.push_stocks();
 
-        for (size_t block_num = 0; block_num < NumBlocks; ++block_num) {
             for (size_t i = 0; i < NumSourcePackets; ++i) {
                 packet::PacketPtr p = reader.read();
                 CHECK(p);
-                check_audio_packet(p, NumSourcePackets * block_num + i);
-                check_restored(p, false);
+                check_audio_packet(p, n_block * NumSourcePackets + i);
+                check_restored(p, i == lost_packet);
             }
-
-            dispatcher.reset();
         }
     }
 }
 
-TEST(writer_reader, interleaved_packets) {
-    enum { NumPackets = NumSourcePackets * 30 };
+TEST(writer_reader, async_encoding_max_blocks) {
+    enum { NumBlocks = 10, MaxAsyncBlocks = 2 };
+
+    writer_config.async_encoding = true;
+    writer_config.max_async_blocks = MaxAsyncBlocks;
 
     for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
         codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
@@ -591,11 +665,7 @@ TEST(writer_reader, interleaved_packets) {
                                           packet_factory, NumSourcePackets,
                                           NumRepairPackets);
 
-        packet::Interleaver intrlvr(dispatcher, allocator, 10);
-
-        CHECK(intrlvr.valid());
-
-        Writer writer(writer_config, codec_config.scheme, *encoder, intrlvr,
+        Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
                       source_composer(), repair_composer(), packet_factory,
                       buffer_factory, allocator);
 
@@ -606,17 +676,29 @@ TEST(writer_reader, interleaved_packets) {
         CHECK(writer.valid());
         CHECK(reader.valid());
 
-        packet::PacketPtr many_packets[NumPackets];
+        for (size_t n_block = 0; n_block < NumBlocks; n_block++) {
+            fill_all_packets(n_block * NumSourcePackets);
 
-        for (size_t i = 0; i < NumPackets; ++i) {
-            many_packets[i] = fill_one_packet(i);
-            writer.write(many_packets[i]);
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                writer.write(source_packets[i]);
+            }
+
+            LONGS_EQUAL((n_block + 1) * NumSourcePackets, dispatcher.source_size());
+
+            // no more than MaxAsyncBlocks blocks may be pending
+            CHECK(dispatcher.repair_size() <= (n_block + 1) * NumRepairPackets);
+            CHECK(dispatcher.repair_size() + MaxAsyncBlocks * NumRepairPackets
+                  >= (n_block + 1) * NumRepairPackets);
         }
-        dispatcher.push_stocks();
 
-        intrlvr.flush();
+        writer.flush();
+        CHECK(writer.alive());
 
-        for (size_t i = 0; i < NumPackets; ++i) {
+        LONGS_EQUAL(NumBlocks * NumRepairPackets, dispatcher.repair_size());
+
+        dispatcher.push_stocks();
+
+        for (size_t i = 0; i < NumBlocks * NumSourcePackets; ++i) {
             packet::PacketPtr p = reader.read();
             CHECK(p);
             check_audio_packet(p, i);
@@ -625,6 +707,839 @@ TEST(writer_reader, interleaved_packets) {
     }
 }
 
+TEST(writer_reader, async_encoding_refresh) {
+    enum { NumBlocks = 3, MaxWaitMs = 10000 };
+
+    writer_config.async_encoding = true;
+
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
+        codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
+
+        core::ScopedPtr<IBlockEncoder> encoder(
+            CodecMap::instance().new_encoder(codec_config, buffer_factory, allocator),
+            allocator);
+        CHECK(encoder);
+
+        test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
+                                          packet_factory, NumSourcePackets,
+                                          NumRepairPackets);
+
+        Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
+                      source_composer(), repair_composer(), packet_factory,
+                      buffer_factory, allocator);
+        CHECK(writer.valid());
+
+        CHECK(!writer.has_pending_blocks());
+
+        for (size_t n_block = 0; n_block < NumBlocks; n_block++) {
+            fill_all_packets(n_block * NumSourcePackets);
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                writer.write(source_packets[i]);
+            }
+
+            // repair packets are written by refresh() without further writes
+            for (size_t n_wait = 0; writer.has_pending_blocks(); n_wait++) {
+                CHECK(n_wait < MaxWaitMs);
+
+                writer.refresh();
+                if (writer.has_pending_blocks()) {
+                    core::sleep_for(core::ClockMonotonic, core::Millisecond);
+                }
+            }
+
+            CHECK(writer.alive());
+
+            LONGS_EQUAL((n_block + 1) * NumSourcePackets, dispatcher.source_size());
+            LONGS_EQUAL((n_block + 1) * NumRepairPackets, dispatcher.repair_size());
+        }
+
+        // nothing left to flush
+        writer.flush();
+        LONGS_EQUAL(NumBlocks * NumRepairPackets, dispatcher.repair_size());
+    }
+}
+
+TEST(writer_reader, async_encoding_invalid_max_blocks) {
+    writer_config.async_encoding = true;
+
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
+        codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
+
+        core::ScopedPtr<IBlockEncoder> encoder(
+            CodecMap::instance().new_encoder(codec_config, buffer_factory, allocator),
+            allocator);
+        CHECK(encoder);
+
+        test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
+                                          packet_factory, NumSourcePackets,
+                                          NumRepairPackets);
+
+        {
+            writer_config.max_async_blocks = 0;
+
+            Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
+                          source_composer(), repair_composer(), packet_factory,
+                          buffer_factory, allocator);
+            CHECK(!writer.valid());
+        }
+        {
+            writer_config.max_async_blocks = Writer::MaxAsyncBlocks + 1;
+
+            Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
+                          source_composer(), repair_composer(), packet_factory,
+                          buffer_factory, allocator);
+            CHECK(!writer.valid());
+        }
+    }
+}
+
+TEST(writer_reader, recycle_repair_packets) {
+    enum { NumBlocks = 3 };
+
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
+        codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
+
+        core::ScopedPtr<IBlockEncoder> encoder(
+            CodecMap::instance().new_encoder(codec_config, buffer_factory, allocator),
+            allocator);
+        CHECK(encoder);
+
+        packet::Queue queue;
+
+        Writer writer(writer_config, codec_config.scheme, *encoder, queue,
+                      source_composer(), repair_composer(), packet_factory,
+                      buffer_factory, allocator);
+        CHECK(writer.valid());
+
+        packet::blknum_t first_sbn = 0;
+
+        for (size_t n_block = 0; n_block < NumBlocks; n_block++) {
+            fill_all_packets(n_block * NumSourcePackets);
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                writer.write(source_packets[i]);
+            }
+            CHECK(writer.alive());
+
+            LONGS_EQUAL(NumSourcePackets + NumRepairPackets, queue.size());
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                packet::PacketPtr p = queue.read();
+                CHECK(p);
+                CHECK(p == source_packets[i]);
+            }
+
+            for (size_t i = 0; i < NumRepairPackets; ++i) {
+                packet::PacketPtr p = queue.read();
+                CHECK(p);
+                CHECK(p->flags() & packet::Packet::FlagRepair);
+                CHECK(p->flags() & packet::Packet::FlagComposed);
+
+                if (n_block == 0) {
+                    first_sbn = p->fec()->source_block_number;
+                }
+
+                UNSIGNED_LONGS_EQUAL(packet::blknum_t(first_sbn + n_block),
+                                     p->fec()->source_block_number);
+                UNSIGNED_LONGS_EQUAL(NumSourcePackets + i, p->fec()->encoding_symbol_id);
+                UNSIGNED_LONGS_EQUAL(FECPayloadSize, p->fec()->payload.size());
+            }
+
+            // packets and buffers released in previous block are reused
+            // instead of allocating new ones
+            UNSIGNED_LONGS_EQUAL(NumRepairPackets, writer.n_allocated_packets());
+            UNSIGNED_LONGS_EQUAL(NumRepairPackets, writer.n_allocated_buffers());
+        }
+    }
+}
+
+TEST(writer_reader, recycle_repair_packets_block_interleaved) {
+    enum { Span = 2, NumBlocks = Span * 10 };
+
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
+        codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
+
+        for (int async = 0; async <= 1; async++) {
+            core::ScopedPtr<IBlockEncoder> encoder(
+                CodecMap::instance().new_encoder(codec_config, buffer_factory, allocator),
+                allocator);
+            CHECK(encoder);
+
+            packet::Queue queue;
+
+            BlockInterleaverConfig interleaver_config;
+            interleaver_config.enabled = true;
+            interleaver_config.span = Span;
+
+            BlockInterleaver intrlvr(interleaver_config, queue, allocator);
+            CHECK(intrlvr.valid());
+
+            writer_config.async_encoding = async;
+            writer_config.n_held_blocks = intrlvr.max_blocks();
+
+            Writer writer(writer_config, codec_config.scheme, *encoder, intrlvr,
+                          source_composer(), repair_composer(), packet_factory,
+                          buffer_factory, allocator);
+            CHECK(writer.valid());
+
+            // blocks being filled or encoded, plus blocks held by interleaver
+            const size_t n_slot_blocks =
+                (async ? writer_config.max_async_blocks + 1 : 1) + Span * 2;
+
+            size_t n_packets = 0;
+
+            for (size_t n_block = 0; n_block < NumBlocks; n_block++) {
+                fill_all_packets(n_block * NumSourcePackets);
+
+                for (size_t i = 0; i < NumSourcePackets; ++i) {
+                    writer.write(source_packets[i]);
+                }
+                writer.flush();
+                CHECK(writer.alive());
+
+                // release packets sent by interleaver
+                while (packet::PacketPtr p = queue.read()) {
+                    n_packets++;
+                }
+
+                if (n_block >= n_slot_blocks) {
+                    // repair packets held by interleaver get their own slots,
+                    // so packets released by interleaver are reused
+                    UNSIGNED_LONGS_EQUAL(NumRepairPackets * n_slot_blocks,
+                                         writer.n_allocated_packets());
+                    UNSIGNED_LONGS_EQUAL(NumRepairPackets * n_slot_blocks,
+                                         writer.n_allocated_buffers());
+                }
+            }
+
+            intrlvr.flush();
+
+            while (packet::PacketPtr p = queue.read()) {
+                n_packets++;
+            }
+
+            UNSIGNED_LONGS_EQUAL((NumSourcePackets + NumRepairPackets) * NumBlocks,
+                                 n_packets);
+        }
+    }
+}
+
+TEST(writer_reader, recycle_repair_packets_in_use) {
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
+        codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
+
+        core::ScopedPtr<IBlockEncoder> encoder(
+            CodecMap::instance().new_encoder(codec_config, buffer_factory, allocator),
+            allocator);
+        CHECK(encoder);
+
+        packet::Queue queue;
+
+        Writer writer(writer_config, codec_config.scheme, *encoder, queue,
+                      source_composer(), repair_composer(), packet_factory,
+                      buffer_factory, allocator);
+        CHECK(writer.valid());
+
+        packet::PacketPtr held_packets[NumRepairPackets];
+        core::Slice<uint8_t> held_buffers[NumRepairPackets];
+        uint8_t held_payloads[NumRepairPackets][FECPayloadSize];
+
+        fill_all_packets(0);
+
+        for (size_t i = 0; i < NumSourcePackets; ++i) {
+            writer.write(source_packets[i]);
+        }
+
+        for (size_t i = 0; i < NumSourcePackets; ++i) {
+            CHECK(queue.read());
+        }
+
+        for (size_t i = 0; i < NumRepairPackets; ++i) {
+            packet::PacketPtr p = queue.read();
+            CHECK(p);
+
+            memcpy(held_payloads[i], p->fec()->payload.data(), FECPayloadSize);
+
+            // hold either packet or only its buffer
+            if (i % 2 == 0) {
+                held_packets[i] = p;
+            } else {
+                held_buffers[i] = p->data();
+            }
+        }
+
+        fill_all_packets(NumSourcePackets);
+
+        for (size_t i = 0; i < NumSourcePackets; ++i) {
+            writer.write(source_packets[i]);
+        }
+        CHECK(writer.alive());
+
+        for (size_t i = 0; i < NumSourcePackets; ++i) {
+            CHECK(queue.read());
+        }
+
+        for (size_t i = 0; i < NumRepairPackets; ++i) {
+            packet::PacketPtr p = queue.read();
+            CHECK(p);
+
+            if (i % 2 == 0) {
+                CHECK(p != held_packets[i]);
+                CHECK(memcmp(held_payloads[i], held_packets[i]->fec()->payload.data(),
+                             FECPayloadSize)
+                      == 0);
+            } else {
+                CHECK(p->data().data() != held_buffers[i].data());
+                CHECK(memcmp(held_payloads[i],
+                             held_buffers[i].data() + held_buffers[i].size()
+                                 - FECPayloadSize,
+                             FECPayloadSize)
+                      == 0);
+            }
+        }
+
+        // new packets are allocated instead of held packets,
+        // new buffers are allocated instead of held packets and buffers
+        UNSIGNED_LONGS_EQUAL(NumRepairPackets + NumRepairPackets / 2,
+                             writer.n_allocated_packets());
+        UNSIGNED_LONGS_EQUAL(NumRepairPackets * 2, writer.n_allocated_buffers());
+    }
+}
+
+TEST(writer_reader, recycle_repair_packets_losses) {
+    enum { NumBlocks = 5 };
+
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
+        codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
+
+        core::ScopedPtr<IBlockEncoder> encoder(
+            CodecMap::instance().new_encoder(codec_config, buffer_factory, allocator),
+            allocator);
+
+        core::ScopedPtr<IBlockDecoder> decoder(
+            CodecMap::instance().new_decoder(codec_config, buffer_factory, allocator),
+            allocator);
+
+        CHECK(encoder);
+        CHECK(decoder);
+
+        test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
+                                          packet_factory, NumSourcePackets,
+                                          NumRepairPackets);
+
+        Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
+                      source_composer(), repair_composer(), packet_factory,
+                      buffer_factory, allocator);
+
+        Reader reader(reader_config, codec_config.scheme, *decoder,
+                      dispatcher.source_reader(), dispatcher.repair_reader(), rtp_parser,
+                      packet_factory, allocator);
+
+        CHECK(writer.valid());
+        CHECK(reader.valid());
+
+        for (size_t n_block = 0; n_block < NumBlocks; n_block++) {
+            const size_t lost_packet = 1 + n_block;
+
+            fill_all_packets(n_block * NumSourcePackets);
+
+            dispatcher.reset();
+            dispatcher.lose(lost_packet);
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                writer.write(source_packets[i]);
+            }
+            CHECK(writer.alive());
+
+            dispatcher.push_stocks();
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                packet::PacketPtr p = reader.read();
+                CHECK(p);
+                check_audio_packet(p, n_block * NumSourcePackets + i);
+                check_restored(p, i == lost_packet);
+            }
+
+            // release repair packets, so that writer can reuse them
+            while (dispatcher.repair_reader().read()) {
+            }
+        }
+    }
+}
+
+TEST(writer_reader, lost_first_packet_in_first_block) {
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
+        codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
+
+        core::ScopedPtr<IBlockEncoder> encoder(
+            CodecMap::instance().new_encoder(codec_config, buffer_factory, allocator),
+            allocator);
+
+        core::ScopedPtr<IBlockDecoder> decoder(
+            CodecMap::instance().new_decoder(codec_config, buffer_factory, allocator),
+            allocator);
+
+        CHECK(encoder);
+        CHECK(decoder);
+
+        test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
+                                          packet_factory, NumSourcePackets,
+                                          NumRepairPackets);
+
+        Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
+                      source_composer(), repair_composer(), packet_factory,
+                      buffer_factory, allocator);
+
+        Reader reader(reader_config, codec_config.scheme, *decoder,
+                      dispatcher.source_reader(), dispatcher.repair_reader(), rtp_parser,
+                      packet_factory, allocator);
+
+        CHECK(writer.valid());
+        CHECK(reader.valid());
+
+        // Sending first block except first packet.
+        fill_all_packets(0);
+        dispatcher.lose(0);
+        for (size_t i = 0; i < NumSourcePackets; ++i) {
+            writer.write(source_packets[i]);
+        }
+
+        // Sending second block lossless.
+        dispatcher.clear_losses();
+        fill_all_packets(NumSourcePackets);
+        for (size_t i = 0; i < NumSourcePackets; ++i) {
+            writer.write(source_packets[i]);
+        }
+        dispatcher.push_stocks();
+
+        // Receive every sent packet except the first one.
+        for (size_t i = 1; i < NumSourcePackets * 2; ++i) {
+            packet::PacketPtr p = reader.read();
+            if (i < NumSourcePackets) {
+                CHECK(!reader.started());
+            } else {
+                CHECK(reader.started());
+            }
+            check_audio_packet(p, i);
+            check_restored(p, false);
+        }
+        CHECK(dispatcher.source_size() == 0);
+    }
+}
+
+TEST(writer_reader, lost_one_source_and_all_repair_packets) {
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
+        codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
+
+        core::ScopedPtr<IBlockEncoder> encoder(
+            CodecMap::instance().new_encoder(codec_config, buffer_factory, allocator),
+            allocator);
+
+        core::ScopedPtr<IBlockDecoder> decoder(
+            CodecMap::instance().new_decoder(codec_config, buffer_factory, allocator),
+            allocator);
+
+        CHECK(encoder);
+        CHECK(decoder);
+
+        test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
+                                          packet_factory, NumSourcePackets,
+                                          NumRepairPackets);
+
+        Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
+                      source_composer(), repair_composer(), packet_factory,
+                      buffer_factory, allocator);
+
+        Reader reader(reader_config, codec_config.scheme, *decoder,
+                      dispatcher.source_reader(), dispatcher.repair_reader(), rtp_parser,
+                      packet_factory, allocator);
+
+        CHECK(writer.valid());
+        CHECK(reader.valid());
+
+        // Send first block without one source and all repair packets.
+        dispatcher.lose(3);
+        for (size_t i = 0; i < NumRepairPackets; ++i) {
+            dispatcher.lose(NumSourcePackets + i);
+        }
+        fill_all_packets(0);
+        for (size_t i = 0; i < NumSourcePackets; ++i) {
+            writer.write(source_packets[i]);
+        }
+        dispatcher.push_stocks();
+
+        // Send second block without one source packet.
+        dispatcher.clear_losses();
+        dispatcher.lose(5);
+        fill_all_packets(NumSourcePackets);
+        for (size_t i = 0; i < NumSourcePackets; ++i) {
+            writer.write(source_packets[i]);
+        }
+        dispatcher.push_stocks();
+
+        // Receive packets.
+        for (size_t i = 0; i < NumSourcePackets * 2; ++i) {
+            if (i == 3) {
+                // nop
+            } else if (i == NumSourcePackets + 5) {
+                packet::PacketPtr p = reader.read();
+                CHECK(p);
+                check_audio_packet(p, i);
+                check_restored(p, true);
+            } else {
+                packet::PacketPtr p = reader.read();
+                CHECK(p);
+                check_audio_packet(p, i);
+                check_restored(p, false);
+            }
+        }
+
+        CHECK(dispatcher.source_size() == 0);
+    }
+}
+
+TEST(writer_reader, multiple_blocks_1_loss) {
+    enum { NumBlocks = 40 };
+
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
+        codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
+
+        core::ScopedPtr<IBlockEncoder> encoder(
+            CodecMap::instance().new_encoder(codec_config, buffer_factory, allocator),
+            allocator);
+
+        core::ScopedPtr<IBlockDecoder> decoder(
+            CodecMap::instance().new_decoder(codec_config, buffer_factory, allocator),
+            allocator);
+
+        CHECK(encoder);
+        CHECK(decoder);
+
+        test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
+                                          packet_factory, NumSourcePackets,
+                                          NumRepairPackets);
+
+        Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
+                      source_composer(), repair_composer(), packet_factory,
+                      buffer_factory, allocator);
+
+        Reader reader(reader_config, codec_config.scheme, *decoder,
+                      dispatcher.source_reader(), dispatcher.repair_reader(), rtp_parser,
+                      packet_factory, allocator);
+
+        CHECK(writer.valid());
+        CHECK(reader.valid());
+
+        for (size_t block_num = 0; block_num < NumBlocks; ++block_num) {
+            size_t lost_sq = size_t(-1);
+            if (block_num != 5 && block_num != 21 && block_num != 22) {
+                lost_sq = (block_num + 1) % (NumSourcePackets + NumRepairPackets);
+                dispatcher.lose(lost_sq);
+            }
+
+            fill_all_packets(NumSourcePackets * block_num);
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                writer.write(source_packets[i]);
+            }
+            dispatcher.push_stocks();
+
+            if (lost_sq == size_t(-1)) {
+                CHECK(dispatcher.source_size() == NumSourcePackets);
+                CHECK(dispatcher.repair_size() == NumRepairPackets);
+            } else if (lost_sq < NumSourcePackets) {
+                CHECK(dispatcher.source_size() == NumSourcePackets - 1);
+                CHECK(dispatcher.repair_size() == NumRepairPackets);
+            } else {
+                CHECK(dispatcher.source_size() == NumSourcePackets);
+                CHECK(dispatcher.repair_size() == NumRepairPackets - 1);
+            }
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                packet::PacketPtr p = reader.read();
+                CHECK(p);
+
+                check_audio_packet(p, NumSourcePackets * block_num + i);
+
+                if (lost_sq == size_t(-1)) {
+                    check_restored(p, false);
+                } else {
+                    check_restored(p,
+                                   i == lost_sq % (NumSourcePackets + NumRepairPackets));
+                }
+            }
+
+            dispatcher.reset();
+        }
+    }
+}
+
+TEST(writer_reader, multiple_blocks_in_queue) {
+    enum { NumBlocks = 3 };
+
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
+        codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
+
+        core::ScopedPtr<IBlockEncoder> encoder(
+            CodecMap::instance().new_encoder(codec_config, buffer_factory, allocator),
+            allocator);
+
+        core::ScopedPtr<IBlockDecoder> decoder(
+            CodecMap::instance().new_decoder(codec_config, buffer_factory, allocator),
+            allocator);
+
+        CHECK(encoder);
+        CHECK(decoder);
+
+        test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
+                                          packet_factory, NumSourcePackets,
+                                          NumRepairPackets);
+
+        Writer writer(writer_config, codec_config.scheme, *encoder, dispatcher,
+                      source_composer(), repair_composer(), packet_factory,
+                      buffer_factory, allocator);
+
+        Reader reader(reader_config, codec_config.scheme, *decoder,
+                      dispatcher.source_reader(), dispatcher.repair_reader(), rtp_parser,
+                      packet_factory, allocator);
+
+        CHECK(writer.valid());
+        CHECK(reader.valid());
+
+        for (size_t block_num = 0; block_num < NumBlocks; ++block_num) {
+            fill_all_packets(NumSourcePackets * block_num);
+
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                writer.write(source_packets[i]);
+            }
+        }
+        dispatcher.push_stocks();
+
+        CHECK(dispatcher.source_size() == NumSourcePackets * NumBlocks);
+        CHECK(dispatcher.repair_size() == NumRepairPackets * NumBlocks);
+
+        for (size_t block_num = 0; block_num < NumBlocks; ++block_num) {
+            for (size_t i = 0; i < NumSourcePackets; ++i) {
+                packet::PacketPtr p = reader.read();
+                CHECK(p);
+                check_audio_packet(p, NumSourcePackets * block_num + i);
+                check_restored(p, false);
+            }
+
+            dispatcher.reset();
+        }
+    }
+}
+
+TEST(writer_reader, interleaved_packets) {
+    enum { NumPackets = NumSourcePackets * 30 };
+
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
+        codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
+
+        core::ScopedPtr<IBlockEncoder> encoder(
+            CodecMap::instance().new_encoder(codec_config, buffer_factory, allocator),
+            allocator);
+
+        core::ScopedPtr<IBlockDecoder> decoder(
+            CodecMap::instance().new_decoder(codec_config, buffer_factory, allocator),
+            allocator);
+
+        CHECK(encoder);
+        CHECK(decoder);
+
+        test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
+                                          packet_factory, NumSourcePackets,
+                                          NumRepairPackets);
+
+        packet::Interleaver intrlvr(dispatcher, allocator, 10);
+
+        CHECK(intrlvr.valid());
+
+        Writer writer(writer_config, codec_config.scheme, *encoder, intrlvr,
+                      source_composer(), repair_composer(), packet_factory,
+                      buffer_factory, allocator);
+
+        Reader reader(reader_config, codec_config.scheme, *decoder,
+                      dispatcher.source_reader(), dispatcher.repair_reader(), rtp_parser,
+                      packet_factory, allocator);
+
+        CHECK(writer.valid());
+        CHECK(reader.valid());
+
+        packet::PacketPtr many_packets[NumPackets];
+
+        for (size_t i = 0; i < NumPackets; ++i) {
+            many_packets[i] = fill_one_packet(i);
+            writer.write(many_packets[i]);
+        }
+        dispatcher.push_stocks();
+
+        intrlvr.flush();
+
+        for (size_t i = 0; i < NumPackets; ++i) {
+            packet::PacketPtr p = reader.read();
+            CHECK(p);
+            check_audio_packet(p, i);
+            check_restored(p, false);
+        }
+    }
+}
+
+TEST(writer_reader, block_interleaved_burst_losses) {
+    enum {
+        Span = 4,
+        NumPackets = NumSourcePackets * Span * 3,
+        // longer than block redundancy, but shorter than group redundancy
+        BurstBegin = (NumSourcePackets + NumRepairPackets) * Span + 7,
+        BurstEnd = BurstBegin + NumRepairPackets * Span / 2
+    };
+
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
+        codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
+
+        core::ScopedPtr<IBlockEncoder> encoder(
+            CodecMap::instance().new_encoder(codec_config, buffer_factory, allocator),
+            allocator);
+
+        core::ScopedPtr<IBlockDecoder> decoder(
+            CodecMap::instance().new_decoder(codec_config, buffer_factory, allocator),
+            allocator);
+
+        CHECK(encoder);
+        CHECK(decoder);
+
+        test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
+                                          packet_factory, NumSourcePackets,
+                                          NumRepairPackets);
+
+        BurstLossWriter loss_writer(dispatcher, BurstBegin, BurstEnd);
+
+        BlockInterleaverConfig interleaver_config;
+        interleaver_config.enabled = true;
+        interleaver_config.span = Span;
+
+        BlockInterleaver intrlvr(interleaver_config, loss_writer, allocator);
+
+        CHECK(intrlvr.valid());
+
+        Writer writer(writer_config, codec_config.scheme, *encoder, intrlvr,
+                      source_composer(), repair_composer(), packet_factory,
+                      buffer_factory, allocator);
+
+        Reader reader(reader_config, codec_config.scheme, *decoder,
+                      dispatcher.source_reader(), dispatcher.repair_reader(), rtp_parser,
+                      packet_factory, allocator);
+
+        CHECK(writer.valid());
+        CHECK(reader.valid());
+
+        packet::PacketPtr many_packets[NumPackets];
+
+        for (size_t i = 0; i < NumPackets; ++i) {
+            many_packets[i] = fill_one_packet(i);
+            writer.write(many_packets[i]);
+        }
+
+        // all groups are complete and were sent without flush
+        dispatcher.push_stocks();
+
+        UNSIGNED_LONGS_EQUAL(NumPackets + NumRepairPackets * Span * 3
+                                 - (BurstEnd - BurstBegin),
+                             dispatcher.source_size() + dispatcher.repair_size());
+
+        size_t n_restored = 0;
+
+        for (size_t i = 0; i < NumPackets; ++i) {
+            packet::PacketPtr p = reader.read();
+            CHECK(p);
+            check_audio_packet(p, i);
+            if (p->flags() & packet::Packet::FlagRestored) {
+                n_restored++;
+            }
+        }
+
+        CHECK(n_restored > 0);
+        CHECK(reader.alive());
+    }
+}
+
+TEST(writer_reader, async_encoding_block_interleaved) {
+    enum { Span = 2, NumPackets = NumSourcePackets * Span * 10 };
+
+    // more blocks may be encoded than the interleaver holds, so source
+    // packets may be sent while their block is still being encoded
+    writer_config.async_encoding = true;
+    writer_config.max_async_blocks = Writer::MaxAsyncBlocks;
+
+    for (size_t n_scheme = 0; n_scheme < CodecMap::instance().num_schemes(); n_scheme++) {
+        codec_config.scheme = CodecMap::instance().nth_scheme(n_scheme);
+
+        core::ScopedPtr<IBlockEncoder> encoder(
+            CodecMap::instance().new_encoder(codec_config, buffer_factory, allocator),
+            allocator);
+
+        core::ScopedPtr<IBlockDecoder> decoder(
+            CodecMap::instance().new_decoder(codec_config, buffer_factory, allocator),
+            allocator);
+
+        CHECK(encoder);
+        CHECK(decoder);
+
+        test::PacketDispatcher dispatcher(source_parser(), repair_parser(),
+                                          packet_factory, NumSourcePackets,
+                                          NumRepairPackets);
+
+        // packets are modified after interleaver while worker thread may
+        // still be encoding their block
+        FlagWriter flag_writer(dispatcher, packet::Packet::FlagUDP);
+
+        BlockInterleaverConfig interleaver_config;
+        interleaver_config.enabled = true;
+        interleaver_config.span = Span;
+
+        BlockInterleaver intrlvr(interleaver_config, flag_writer, allocator);
+
+        CHECK(intrlvr.valid());
+
+        Writer writer(writer_config, codec_config.scheme, *encoder, intrlvr,
+                      source_composer(), repair_composer(), packet_factory,
+                      buffer_factory, allocator);
+
+        Reader reader(reader_config, codec_config.scheme, *decoder,
+                      dispatcher.source_reader(), dispatcher.repair_reader(), rtp_parser,
+                      packet_factory, allocator);
+
+        CHECK(writer.valid());
+        CHECK(reader.valid());
+
+        packet::PacketPtr many_packets[NumPackets];
+
+        for (size_t i = 0; i < NumPackets; ++i) {
+            many_packets[i] = fill_one_packet(i);
+            writer.write(many_packets[i]);
+        }
+
+        writer.flush();
+        CHECK(writer.alive());
+
+        dispatcher.push_stocks();
+
+        UNSIGNED_LONGS_EQUAL(NumPackets, dispatcher.source_size());
+        UNSIGNED_LONGS_EQUAL(NumRepairPackets * Span * 10, dispatcher.repair_size());
+
+        for (size_t i = 0; i < NumPackets; ++i) {
+            packet::PacketPtr p = reader.read();
+            CHECK(p);
+            check_audio_packet(p, i);
+            check_restored(p, false);
+        }
+
+        CHECK(reader.alive());
+    }
+}
+
 TEST(writer_reader, delayed_packets) {
     // 1. Deliver first half of block.
     // 2. Read first half of block.
@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <time.h>
+
+#include "roc_address/socket_addr.h"
+#include "roc_core/buffer_factory.h"
+#include "roc_core/cond.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/mutex.h"
+#include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_netio/network_loop.h"
+#include "roc_packet/packet_factory.h"
+
+namespace roc {
+namespace netio {
+namespace {
+
+// --------
+// Overview
+// --------
+//
+// This benchmark measures how many packets per second a pair of network loops
+// can move over loopback. One loop owns N sender ports, another loop owns N
+// receiver ports, and every sender port sends to its own receiver port.
+//
+// Each iteration writes a batch of packets to every sender port and waits until
+// the batch is delivered to the receiver ports' packet writer. Packets that were
+// not delivered within ReceiveTimeout are considered lost.
+//
+// Arguments are the number of port pairs and the packet size in bytes.
+//
+// --------------
+// Output columns
+// --------------
+//
+// (all time units are microseconds)
+//
+// Time           -  wall clock time of one batch
+// CPU            -  CPU time of one batch in benchmark thread
+// Iterations     -  number of batches
+// items_per_sec  -  delivered packets per second
+// bytes_per_sec  -  delivered payload bytes per second
+//
+// cpu_pkt        -  CPU time of the whole process (all network threads included)
+//                   per one delivered packet
+//
+// lat_avg        -  average delay between write() to sender port and write()
+//                   to receiver packet writer
+// lat_p50        -  50% percentile of the above
+// lat_p90        -  90% percentile of the above
+// lat_p99        -  99% percentile of the above
+//
+// lost           -  number of packets not delivered within timeout
+
+enum {
+    // maximum number of sender/receiver port pairs
+    MaxPorts = 8,
+
+    // packets written to every sender port per iteration
+    BatchSize = 32,
+
+    // maximum packet size
+    MaxPacketSize = 1500,
+
+    // latency histogram bucket width, in microseconds
+    BucketWidth = 2,
+
+    // number of latency histogram buckets
+    NumBuckets = 5000
+};
+
+// how long to wait for batch delivery before considering packets lost
+const core::nanoseconds_t ReceiveTimeout = 50 * core::Millisecond;
+
+core::HeapAllocator allocator;
+core::BufferFactory<uint8_t> buffer_factory(allocator, MaxPacketSize, false);
+packet::PacketFactory packet_factory(allocator, false);
+
+class LatencyHistogram {
+public:
+    LatencyHistogram()
+        : total_(0)
+        , count_(0) {
+        memset(buckets_, 0, sizeof(buckets_));
+    }
+
+    void add(core::nanoseconds_t t) {
+        if (t < 0) {
+            t = 0;
+        }
+
+        size_t n = size_t(t / (core::Microsecond * BucketWidth));
+        if (n >= NumBuckets) {
+            n = NumBuckets - 1;
+        }
+
+        buckets_[n]++;
+
+        total_ += t;
+        count_++;
+    }
+
+    double avg() const {
+        if (count_ == 0) {
+            return 0;
+        }
+        return double(total_) / count_ / 1000;
+    }
+
+    double percentile(double p) const {
+        if (count_ == 0) {
+            return 0;
+        }
+
+        size_t sum = 0;
+        for (size_t n = 0; n < NumBuckets; n++) {
+            sum += buckets_[n];
+            if (double(sum) / count_ >= p) {
+                return double(BucketWidth * (n + 1));
+            }
+        }
+
+        return double(BucketWidth * NumBuckets);
+    }
+
+private:
+    core::nanoseconds_t total_;
+    size_t count_;
+
+    size_t buckets_[NumBuckets];
+};
+
+// Packet writer shared by all receiver ports.
+// Invoked on receiver network loop thread.
+class ReceiverWriter : public packet::IWriter {
+public:
+    ReceiverWriter()
+        : cond_(mutex_)
+        , n_received_(0)
+        , n_bytes_(0)
+        , wait_target_(0) {
+    }
+
+    virtual void write(const packet::PacketPtr& pp) {
+        const core::nanoseconds_t now = core::timestamp(core::ClockMonotonic);
+
+        core::Mutex::Lock lock(mutex_);
+
+        core::nanoseconds_t sent = 0;
+        if (pp->data().size() >= sizeof(sent)) {
+            memcpy(&sent, pp->data().data(), sizeof(sent));
+        }
+
+        latency_.add(now - sent);
+
+        n_received_++;
+        n_bytes_ += pp->data().size();
+
+        if (wait_target_ != 0 && n_received_ >= wait_target_) {
+            wait_target_ = 0;
+            cond_.signal();
+        }
+    }
+
+    // Wait until total number of received packets reaches given value.
+    bool wait(size_t n_packets, core::nanoseconds_t timeout) {
+        core::Mutex::Lock lock(mutex_);
+
+        while (n_received_ < n_packets) {
+            wait_target_ = n_packets;
+            if (!cond_.timed_wait(timeout)) {
+                wait_target_ = 0;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    size_t n_received() const {
+        core::Mutex::Lock lock(mutex_);
+        return n_received_;
+    }
+
+    void export_counters(benchmark::State& state, size_t n_sent, clock_t cpu_time) {
+        core::Mutex::Lock lock(mutex_);
+
+        state.SetItemsProcessed(int64_t(n_received_));
+        state.SetBytesProcessed(int64_t(n_bytes_));
+
+        if (n_received_ != 0) {
+            state.counters["cpu_pkt"] =
+                double(cpu_time) / CLOCKS_PER_SEC * 1e6 / n_received_;
+        }
+
+        state.counters["lat_avg"] = latency_.avg();
+        state.counters["lat_p50"] = latency_.percentile(0.50);
+        state.counters["lat_p90"] = latency_.percentile(0.90);
+        state.counters["lat_p99"] = latency_.percentile(0.99);
+
+        state.counters["lost"] = double(n_sent - n_received_);
+    }
+
+private:
+    core::Mutex mutex_;
+    core::Cond cond_;
+
+    LatencyHistogram latency_;
+
+    size_t n_received_;
+    size_t n_bytes_;
+    size_t wait_target_;
+};
+
+UdpSenderConfig make_sender_config() {
+    UdpSenderConfig config;
+    roc_panic_if_not(
+        config.bind_address.set_host_port(address::Family_IPv4, "127.0.0.1", 0));
+    return config;
+}
+
+UdpReceiverConfig make_receiver_config() {
+    UdpReceiverConfig config;
+    roc_panic_if_not(
+        config.bind_address.set_host_port(address::Family_IPv4, "127.0.0.1", 0));
+    return config;
+}
+
+packet::IWriter* add_udp_sender(NetworkLoop& net_loop, UdpSenderConfig& config) {
+    NetworkLoop::Tasks::AddUdpSenderPort task(config);
+    roc_panic_if_not(net_loop.schedule_and_wait(task));
+    roc_panic_if_not(task.success());
+    return task.get_writer();
+}
+
+void add_udp_receiver(NetworkLoop& net_loop,
+                      UdpReceiverConfig& config,
+                      packet::IWriter& writer) {
+    NetworkLoop::Tasks::AddUdpReceiverPort task(config, writer);
+    roc_panic_if_not(net_loop.schedule_and_wait(task));
+    roc_panic_if_not(task.success());
+}
+
+packet::PacketPtr new_packet(const UdpSenderConfig& tx_config,
+                             const UdpReceiverConfig& rx_config,
+                             size_t packet_size) {
+    packet::PacketPtr pp = packet_factory.new_packet();
+    roc_panic_if_not(pp);
+
+    core::Slice<uint8_t> buf = buffer_factory.new_buffer();
+    roc_panic_if_not(buf);
+    buf.reslice(0, packet_size);
+
+    memset(buf.data(), 0, packet_size);
+
+    const core::nanoseconds_t now = core::timestamp(core::ClockMonotonic);
+    memcpy(buf.data(), &now, sizeof(now));
+
+    pp->add_flags(packet::Packet::FlagUDP);
+
+    pp->udp()->src_addr = tx_config.bind_address;
+    pp->udp()->dst_addr = rx_config.bind_address;
+
+    pp->set_data(buf);
+
+    return pp;
+}
+
+void BM_UdpLoopback(benchmark::State& state) {
+    const size_t n_ports = (size_t)state.range(0);
+    const size_t packet_size = (size_t)state.range(1);
+
+    roc_panic_if_not(n_ports > 0 && n_ports <= MaxPorts);
+    roc_panic_if_not(packet_size >= sizeof(core::nanoseconds_t)
+                     && packet_size <= MaxPacketSize);
+
+    ReceiverWriter rx_writer;
+
+    NetworkLoop tx_loop(packet_factory, buffer_factory, allocator);
+    roc_panic_if_not(tx_loop.valid());
+
+    NetworkLoop rx_loop(packet_factory, buffer_factory, allocator);
+    roc_panic_if_not(rx_loop.valid());
+
+    UdpSenderConfig tx_configs[MaxPorts];
+    UdpReceiverConfig rx_configs[MaxPorts];
+    packet::IWriter* tx_writers[MaxPorts] = {};
+
+    for (size_t p = 0; p < n_ports; p++) {
+        tx_configs[p] = make_sender_config();
+        tx_writers[p] = add_udp_sender(tx_loop, tx_configs[p]);
+
+        rx_configs[p] = make_receiver_config();
+        add_udp_receiver(rx_loop, rx_configs[p], rx_writer);
+    }
+
+    size_t n_sent = 0;
+    size_t n_lost = 0;
+
+    const clock_t cpu_start = clock();
+
+    while (state.KeepRunning()) {
+        for (size_t n = 0; n < BatchSize; n++) {
+            for (size_t p = 0; p < n_ports; p++) {
+                tx_writers[p]->write(new_packet(tx_configs[p], rx_configs[p], packet_size));
+                n_sent++;
+            }
+        }
+
+        if (!rx_writer.wait(n_sent - n_lost, ReceiveTimeout)) {
+            n_lost = n_sent - rx_writer.n_received();
+        }
+    }
+
+    const clock_t cpu_time = clock() - cpu_start;
+
+    rx_writer.export_counters(state, n_sent, cpu_time);
+}
+
+void make_args(benchmark::internal::Benchmark* b) {
+    const int packet_sizes[] = { 64, 256, 512, 1024, MaxPacketSize };
+
+    for (int n_ports = 1; n_ports <= MaxPorts; n_ports *= 2) {
+        for (size_t n = 0; n < ROC_ARRAY_SIZE(packet_sizes); n++) {
+            b->ArgPair(n_ports, packet_sizes[n]);
+        }
+    }
+}
+
+BENCHMARK(BM_UdpLoopback)
+    ->Apply(make_args)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace netio
+} // namespace roc
@@ -11,6 +11,7 @@
 #include "roc_address/socket_addr.h"
 #include "roc_core/buffer_factory.h"
 #include "roc_core/heap_allocator.h"
+#include "roc_core/time.h"
 #include "roc_netio/network_loop.h"
 #include "roc_packet/concurrent_queue.h"
 #include "roc_packet/packet_factory.h"
@@ -58,6 +59,34 @@ NetworkLoop::PortHandle add_udp_receiver(NetworkLoop& net_loop,
     return task.get_handle();
 }
 
+void remove_port(NetworkLoop& net_loop, NetworkLoop::PortHandle handle) {
+    NetworkLoop::Tasks::RemovePort task(handle);
+    CHECK(net_loop.schedule_and_wait(task));
+    CHECK(task.success());
+}
+
+UdpSenderConnectStats query_udp_sender(NetworkLoop& net_loop,
+                                       NetworkLoop::PortHandle handle) {
+    NetworkLoop::Tasks::QueryUdpSenderPort task(handle);
+    CHECK(net_loop.schedule_and_wait(task));
+    CHECK(task.success());
+    return task.get_connect_stats();
+}
+
+UdpReceiverBusyPollStats query_udp_receiver(NetworkLoop& net_loop,
+                                            NetworkLoop::PortHandle handle) {
+    NetworkLoop::Tasks::QueryUdpReceiverPort task(handle);
+    CHECK(net_loop.schedule_and_wait(task));
+    CHECK(task.success());
+    return task.get_busy_poll_stats();
+}
+
+void disable_udp_sender_connect(NetworkLoop& net_loop, NetworkLoop::PortHandle handle) {
+    NetworkLoop::Tasks::DisableUdpSenderConnect task(handle);
+    CHECK(net_loop.schedule_and_wait(task));
+    CHECK(task.success());
+}
+
 core::Slice<uint8_t> new_buffer(int value) {
     core::Slice<uint8_t> buf = buffer_factory.new_buffer();
     CHECK(buf);
@@ -96,6 +125,9 @@ void check_packet(const packet::PacketPtr& pp,
     CHECK(pp->udp()->src_addr == tx_config.bind_address);
     CHECK(pp->udp()->dst_addr == rx_config.bind_address);
 
+    CHECK(pp->udp()->receive_timestamp > 0);
+    CHECK(pp->udp()->receive_timestamp <= core::timestamp(core::ClockUnix));
+
     core::Slice<uint8_t> expected = new_buffer(value);
 
     UNSIGNED_LONGS_EQUAL(expected.size(), pp->data().size());
@@ -185,6 +217,86 @@ TEST(udp_io, one_sender_one_receiver_separate_loops) {
     }
 }
 
+TEST(udp_io, one_sender_one_receiver_busy_polling) {
+    enum { MaxWaitMs = 5000 };
+
+    packet::ConcurrentQueue rx_queue;
+
+    UdpSenderConfig tx_config = make_sender_config();
+    UdpReceiverConfig rx_config = make_receiver_config();
+    rx_config.busy_polling = true;
+
+    NetworkLoop tx_loop(packet_factory, buffer_factory, allocator);
+    CHECK(tx_loop.valid());
+
+    packet::IWriter* tx_writer = NULL;
+    CHECK(add_udp_sender(tx_loop, tx_config, &tx_writer));
+    CHECK(tx_writer);
+
+    NetworkLoop rx_loop(packet_factory, buffer_factory, allocator);
+    CHECK(rx_loop.valid());
+    NetworkLoop::PortHandle rx_handle = add_udp_receiver(rx_loop, rx_config, rx_queue);
+    CHECK(rx_handle);
+
+    for (int i = 0; i < NumIterations; i++) {
+        for (int p = 0; p < NumPackets; p++) {
+            tx_writer->write(new_packet(tx_config, rx_config, p));
+        }
+        for (int p = 0; p < NumPackets; p++) {
+            check_packet(rx_queue.read(), tx_config, rx_config, p);
+        }
+    }
+
+    // statistics are published right after packet is delivered
+    for (int n_wait = 0;; n_wait++) {
+        CHECK(n_wait < MaxWaitMs);
+
+        UdpReceiverBusyPollStats stats = query_udp_receiver(rx_loop, rx_handle);
+        if (stats.n_packets == NumIterations * NumPackets) {
+            CHECK(stats.n_spin_packets + stats.n_parked_packets <= stats.n_packets);
+            break;
+        }
+
+        core::sleep_for(core::ClockMonotonic, core::Millisecond);
+    }
+}
+
+TEST(udp_io, one_sender_one_receiver_pacing) {
+    packet::ConcurrentQueue rx_queue;
+
+    UdpSenderConfig tx_config = make_sender_config();
+    tx_config.pacing_interval = core::Millisecond;
+
+    UdpReceiverConfig rx_config = make_receiver_config();
+
+    NetworkLoop tx_loop(packet_factory, buffer_factory, allocator);
+    CHECK(tx_loop.valid());
+
+    packet::IWriter* tx_writer = NULL;
+    CHECK(add_udp_sender(tx_loop, tx_config, &tx_writer));
+    CHECK(tx_writer);
+
+    NetworkLoop rx_loop(packet_factory, buffer_factory, allocator);
+    CHECK(rx_loop.valid());
+    CHECK(add_udp_receiver(rx_loop, rx_config, rx_queue));
+
+    for (int i = 0; i < NumIterations; i++) {
+        const core::nanoseconds_t start = core::timestamp(core::ClockMonotonic);
+
+        for (int p = 0; p < NumPackets; p++) {
+            tx_writer->write(new_packet(tx_config, rx_config, p));
+        }
+        for (int p = 0; p < NumPackets; p++) {
+            check_packet(rx_queue.read(), tx_config, rx_config, p);
+        }
+
+        // burst should be spread over at least (NumPackets - 1) intervals,
+        // minus slack for timer resolution
+        CHECK(core::timestamp(core::ClockMonotonic) - start
+              >= (NumPackets - 1) * (tx_config.pacing_interval - core::Millisecond / 2));
+    }
+}
+
 TEST(udp_io, one_sender_many_receivers) {
     packet::ConcurrentQueue rx_queue1;
     packet::ConcurrentQueue rx_queue2;
@@ -226,6 +338,175 @@ TEST(udp_io, one_sender_many_receivers) {
     }
 }
 
+TEST(udp_io, one_sender_destination_change) {
+    packet::ConcurrentQueue rx_queue1;
+    packet::ConcurrentQueue rx_queue2;
+
+    UdpSenderConfig tx_config = make_sender_config();
+    UdpReceiverConfig rx_config1 = make_receiver_config();
+    UdpReceiverConfig rx_config2 = make_receiver_config();
+
+    NetworkLoop tx_loop(packet_factory, buffer_factory, allocator);
+    CHECK(tx_loop.valid());
+
+    packet::IWriter* tx_writer = NULL;
+    NetworkLoop::PortHandle tx_handle = add_udp_sender(tx_loop, tx_config, &tx_writer);
+    CHECK(tx_handle);
+    CHECK(tx_writer);
+
+    NetworkLoop rx_loop(packet_factory, buffer_factory, allocator);
+    CHECK(rx_loop.valid());
+    CHECK(add_udp_receiver(rx_loop, rx_config1, rx_queue1));
+    CHECK(add_udp_receiver(rx_loop, rx_config2, rx_queue2));
+
+    {
+        UdpSenderConnectStats stats = query_udp_sender(tx_loop, tx_handle);
+        CHECK(!stats.connected);
+        UNSIGNED_LONGS_EQUAL(0, stats.n_connects);
+    }
+
+    // sender connects socket after a few packets to the same address
+    for (int i = 0; i < NumIterations; i++) {
+        for (int p = 0; p < NumPackets; p++) {
+            tx_writer->write(new_packet(tx_config, rx_config1, p));
+        }
+        for (int p = 0; p < NumPackets; p++) {
+            check_packet(rx_queue1.read(), tx_config, rx_config1, p);
+        }
+    }
+
+    {
+        UdpSenderConnectStats stats = query_udp_sender(tx_loop, tx_handle);
+#if UV_VERSION_HEX >= 0x011b00
+        CHECK(stats.connected);
+        UNSIGNED_LONGS_EQUAL(1, stats.n_connects);
+#else
+        CHECK(!stats.connected);
+        UNSIGNED_LONGS_EQUAL(0, stats.n_connects);
+#endif
+        UNSIGNED_LONGS_EQUAL(0, stats.n_disconnects);
+        UNSIGNED_LONGS_EQUAL(0, stats.n_refused);
+        UNSIGNED_LONGS_EQUAL(0, stats.n_unreachable);
+    }
+
+    // sender disconnects socket when destination changes
+    for (int i = 0; i < NumIterations; i++) {
+        for (int p = 0; p < NumPackets; p++) {
+            tx_writer->write(new_packet(tx_config, rx_config2, p * 10));
+            tx_writer->write(new_packet(tx_config, rx_config1, p * 20));
+        }
+        for (int p = 0; p < NumPackets; p++) {
+            check_packet(rx_queue2.read(), tx_config, rx_config2, p * 10);
+            check_packet(rx_queue1.read(), tx_config, rx_config1, p * 20);
+        }
+    }
+
+    {
+        UdpSenderConnectStats stats = query_udp_sender(tx_loop, tx_handle);
+        CHECK(!stats.connected);
+#if UV_VERSION_HEX >= 0x011b00
+        UNSIGNED_LONGS_EQUAL(1, stats.n_connects);
+        UNSIGNED_LONGS_EQUAL(1, stats.n_disconnects);
+#else
+        UNSIGNED_LONGS_EQUAL(0, stats.n_connects);
+        UNSIGNED_LONGS_EQUAL(0, stats.n_disconnects);
+#endif
+        UNSIGNED_LONGS_EQUAL(0, stats.n_refused);
+        UNSIGNED_LONGS_EQUAL(0, stats.n_unreachable);
+    }
+}
+
+TEST(udp_io, one_sender_connect_disabled) {
+    enum { NumSourcePackets = 20, NumRepairPackets = 10 };
+
+    packet::ConcurrentQueue rx_queue1;
+    packet::ConcurrentQueue rx_queue2;
+
+    UdpSenderConfig tx_config = make_sender_config();
+    UdpReceiverConfig rx_config1 = make_receiver_config();
+    UdpReceiverConfig rx_config2 = make_receiver_config();
+
+    NetworkLoop tx_loop(packet_factory, buffer_factory, allocator);
+    CHECK(tx_loop.valid());
+
+    packet::IWriter* tx_writer = NULL;
+    NetworkLoop::PortHandle tx_handle = add_udp_sender(tx_loop, tx_config, &tx_writer);
+    CHECK(tx_handle);
+    CHECK(tx_writer);
+
+    NetworkLoop rx_loop(packet_factory, buffer_factory, allocator);
+    CHECK(rx_loop.valid());
+    CHECK(add_udp_receiver(rx_loop, rx_config1, rx_queue1));
+    CHECK(add_udp_receiver(rx_loop, rx_config2, rx_queue2));
+
+    // port is shared by source and repair interfaces
+    disable_udp_sender_connect(tx_loop, tx_handle);
+
+    // each block of source packets is followed by repair packets sent to
+    // another port; socket is never connected to any of them
+    for (int i = 0; i < NumIterations; i++) {
+        for (int p = 0; p < NumSourcePackets; p++) {
+            tx_writer->write(new_packet(tx_config, rx_config1, p));
+        }
+        for (int p = 0; p < NumRepairPackets; p++) {
+            tx_writer->write(new_packet(tx_config, rx_config2, p * 10));
+        }
+        for (int p = 0; p < NumSourcePackets; p++) {
+            check_packet(rx_queue1.read(), tx_config, rx_config1, p);
+        }
+        for (int p = 0; p < NumRepairPackets; p++) {
+            check_packet(rx_queue2.read(), tx_config, rx_config2, p * 10);
+        }
+    }
+
+    UdpSenderConnectStats stats = query_udp_sender(tx_loop, tx_handle);
+    CHECK(!stats.connected);
+    UNSIGNED_LONGS_EQUAL(0, stats.n_connects);
+    UNSIGNED_LONGS_EQUAL(0, stats.n_disconnects);
+}
+
+#if UV_VERSION_HEX >= 0x011b00
+TEST(udp_io, one_sender_destination_refused) {
+    enum { MaxWaitMs = 5000 };
+
+    packet::ConcurrentQueue rx_queue;
+
+    UdpSenderConfig tx_config = make_sender_config();
+    UdpReceiverConfig rx_config = make_receiver_config();
+
+    NetworkLoop tx_loop(packet_factory, buffer_factory, allocator);
+    CHECK(tx_loop.valid());
+
+    packet::IWriter* tx_writer = NULL;
+    NetworkLoop::PortHandle tx_handle = add_udp_sender(tx_loop, tx_config, &tx_writer);
+    CHECK(tx_handle);
+    CHECK(tx_writer);
+
+    // bind receiver to get a free port, then close it
+    NetworkLoop rx_loop(packet_factory, buffer_factory, allocator);
+    CHECK(rx_loop.valid());
+    remove_port(rx_loop, add_udp_receiver(rx_loop, rx_config, rx_queue));
+
+    // connected socket gets errors reported by remote peer
+    for (int n_wait = 0;; n_wait++) {
+        CHECK(n_wait < MaxWaitMs);
+
+        tx_writer->write(new_packet(tx_config, rx_config, n_wait));
+
+        UdpSenderConnectStats stats = query_udp_sender(tx_loop, tx_handle);
+        if (stats.n_refused != 0) {
+            CHECK(stats.connected);
+            UNSIGNED_LONGS_EQUAL(0, stats.n_unreachable);
+            break;
+        }
+
+        core::sleep_for(core::ClockMonotonic, core::Millisecond);
+    }
+
+    CHECK(!rx_queue.read());
+}
+#endif // UV_VERSION_HEX >= 0x011b00
+
 TEST(udp_io, many_senders_one_receiver) {
     packet::ConcurrentQueue rx_queue;
 
@@ -0,0 +1,334 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "roc_address/socket_addr_to_str.h"
+#include "roc_core/buffer_factory.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/temp_file.h"
+#include "roc_packet/trace_reader.h"
+#include "roc_packet/trace_writer.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { MaxBufSize = 70000, NumRecords = 20 };
+
+core::HeapAllocator allocator;
+core::BufferFactory<uint8_t> buffer_factory(allocator, MaxBufSize, true);
+
+core::Slice<uint8_t> new_datagram(size_t size, uint8_t value) {
+    core::Slice<uint8_t> buf = buffer_factory.new_buffer();
+    CHECK(buf);
+
+    buf.reslice(0, size);
+    for (size_t n = 0; n < size; n++) {
+        buf.data()[n] = uint8_t(value + n);
+    }
+
+    return buf;
+}
+
+address::SocketAddr new_addr(address::AddrFamily family, const char* host, int port) {
+    address::SocketAddr addr;
+    CHECK(addr.set_host_port(family, host, port));
+    return addr;
+}
+
+void check_record(const TraceRecord& record,
+                  core::nanoseconds_t timestamp,
+                  address::Interface iface,
+                  const address::SocketAddr& addr,
+                  size_t size,
+                  uint8_t value) {
+    CHECK(record.timestamp == timestamp);
+    LONGS_EQUAL(iface, record.iface);
+    STRCMP_EQUAL(address::socket_addr_to_str(addr).c_str(),
+                 address::socket_addr_to_str(record.src_addr).c_str());
+
+    LONGS_EQUAL(size, record.size);
+    CHECK(record.data);
+    for (size_t n = 0; n < size; n++) {
+        LONGS_EQUAL(uint8_t(value + n), record.data[n]);
+    }
+}
+
+size_t record_size(size_t n) {
+    return (n * 37) % 300 + 1;
+}
+
+} // namespace
+
+TEST_GROUP(trace) {};
+
+TEST(trace, write_read) {
+    core::TempFile file("test.trace");
+
+    const address::SocketAddr addr4 = new_addr(address::Family_IPv4, "10.0.0.1", 1234);
+    const address::SocketAddr addr6 = new_addr(address::Family_IPv6, "2001:db8::1", 4321);
+
+    {
+        TraceWriter writer;
+        CHECK(writer.open(file.path()));
+
+        for (size_t n = 0; n < NumRecords; n++) {
+            CHECK(writer.write(core::Second + (core::nanoseconds_t)n * core::Millisecond,
+                               n % 2 ? address::Iface_AudioRepair
+                                     : address::Iface_AudioSource,
+                               n % 3 ? addr4 : addr6,
+                               new_datagram(record_size(n), (uint8_t)n)));
+        }
+
+        LONGS_EQUAL(NumRecords, writer.num_records());
+        CHECK(writer.close());
+    }
+
+    TraceReader reader;
+    CHECK(reader.open(file.path()));
+
+    for (int pass = 0; pass < 2; pass++) {
+        TraceRecord record;
+
+        for (size_t n = 0; n < NumRecords; n++) {
+            CHECK(reader.read(record));
+
+            check_record(
+                record, core::Second + (core::nanoseconds_t)n * core::Millisecond,
+                n % 2 ? address::Iface_AudioRepair : address::Iface_AudioSource,
+                n % 3 ? addr4 : addr6, record_size(n), (uint8_t)n);
+        }
+
+        CHECK(!reader.read(record));
+
+        reader.rewind();
+    }
+}
+
+TEST(trace, append) {
+    core::TempFile file("test.trace");
+
+    const address::SocketAddr addr = new_addr(address::Family_IPv4, "127.0.0.1", 1);
+
+    for (size_t n = 0; n < NumRecords; n++) {
+        TraceWriter writer;
+        CHECK(writer.open(file.path()));
+        CHECK(writer.write(core::Second * (core::nanoseconds_t)(n + 1),
+                           address::Iface_AudioSource, addr,
+                           new_datagram(record_size(n), (uint8_t)n)));
+    }
+
+    TraceReader reader;
+    CHECK(reader.open(file.path()));
+
+    TraceRecord record;
+
+    for (size_t n = 0; n < NumRecords; n++) {
+        CHECK(reader.read(record));
+        check_record(record, core::Second * (core::nanoseconds_t)(n + 1),
+                     address::Iface_AudioSource, addr, record_size(n), (uint8_t)n);
+    }
+
+    CHECK(!reader.read(record));
+}
+
+TEST(trace, large_datagram) {
+    core::TempFile file("test.trace");
+
+    const address::SocketAddr addr = new_addr(address::Family_IPv4, "127.0.0.1", 1);
+
+    {
+        TraceWriter writer;
+        CHECK(writer.open(file.path()));
+
+        // Larger than writer buffer, written bypassing it.
+        for (size_t n = 0; n < 40; n++) {
+            CHECK(writer.write(core::Second, address::Iface_AudioSource, addr,
+                               new_datagram(MaxBufSize, (uint8_t)n)));
+        }
+    }
+
+    TraceReader reader;
+    CHECK(reader.open(file.path()));
+
+    TraceRecord record;
+
+    for (size_t n = 0; n < 40; n++) {
+        CHECK(reader.read(record));
+        check_record(record, core::Second, address::Iface_AudioSource, addr, MaxBufSize,
+                     (uint8_t)n);
+    }
+
+    CHECK(!reader.read(record));
+}
+
+TEST(trace, truncated) {
+    core::TempFile file("test.trace");
+
+    const address::SocketAddr addr = new_addr(address::Family_IPv4, "127.0.0.1", 1);
+
+    {
+        TraceWriter writer;
+        CHECK(writer.open(file.path()));
+
+        for (size_t n = 0; n < 3; n++) {
+            CHECK(writer.write(core::Second, address::Iface_AudioSource, addr,
+                               new_datagram(100, (uint8_t)n)));
+        }
+    }
+
+    const size_t full_size = sizeof(TraceFileHeader) + trace_record_size(100) * 3;
+
+    // Cut last record in the middle.
+    CHECK(truncate(file.path(), (off_t)(full_size - 50)) == 0);
+
+    TraceReader reader;
+    CHECK(reader.open(file.path()));
+
+    TraceRecord record;
+
+    for (size_t n = 0; n < 2; n++) {
+        CHECK(reader.read(record));
+        check_record(record, core::Second, address::Iface_AudioSource, addr, 100,
+                     (uint8_t)n);
+    }
+
+    CHECK(!reader.read(record));
+}
+
+TEST(trace, append_truncated) {
+    core::TempFile file("test.trace");
+
+    const address::SocketAddr addr = new_addr(address::Family_IPv4, "127.0.0.1", 1);
+
+    {
+        TraceWriter writer;
+        CHECK(writer.open(file.path()));
+
+        for (size_t n = 0; n < 3; n++) {
+            CHECK(writer.write(core::Second, address::Iface_AudioSource, addr,
+                               new_datagram(100, (uint8_t)n)));
+        }
+    }
+
+    const size_t full_size = sizeof(TraceFileHeader) + trace_record_size(100) * 3;
+
+    // Cut last record in the middle.
+    CHECK(truncate(file.path(), (off_t)(full_size - 50)) == 0);
+
+    {
+        TraceWriter writer;
+        CHECK(writer.open(file.path()));
+
+        for (size_t n = 3; n < 5; n++) {
+            CHECK(writer.write(core::Second, address::Iface_AudioSource, addr,
+                               new_datagram(100, (uint8_t)n)));
+        }
+    }
+
+    TraceReader reader;
+    CHECK(reader.open(file.path()));
+
+    TraceRecord record;
+
+    // Incomplete record is replaced by appended records.
+    for (size_t n = 0; n < 5; n++) {
+        if (n == 2) {
+            continue;
+        }
+        CHECK(reader.read(record));
+        check_record(record, core::Second, address::Iface_AudioSource, addr, 100,
+                     (uint8_t)n);
+    }
+
+    CHECK(!reader.read(record));
+}
+
+TEST(trace, append_truncated_padding) {
+    enum { DatagramSize = 101 };
+
+    core::TempFile file("test.trace");
+
+    const address::SocketAddr addr = new_addr(address::Family_IPv4, "127.0.0.1", 1);
+
+    CHECK(trace_record_size(DatagramSize) > sizeof(TraceRecordHeader) + DatagramSize);
+
+    {
+        TraceWriter writer;
+        CHECK(writer.open(file.path()));
+
+        for (size_t n = 0; n < 3; n++) {
+            CHECK(writer.write(core::Second, address::Iface_AudioSource, addr,
+                               new_datagram(DatagramSize, (uint8_t)n)));
+        }
+    }
+
+    const size_t full_size =
+        sizeof(TraceFileHeader) + trace_record_size(DatagramSize) * 3;
+
+    // Cut only padding of last record.
+    CHECK(truncate(file.path(), (off_t)(full_size - 1)) == 0);
+
+    {
+        TraceWriter writer;
+        CHECK(writer.open(file.path()));
+
+        for (size_t n = 3; n < 5; n++) {
+            CHECK(writer.write(core::Second, address::Iface_AudioSource, addr,
+                               new_datagram(DatagramSize, (uint8_t)n)));
+        }
+    }
+
+    TraceReader reader;
+    CHECK(reader.open(file.path()));
+
+    TraceRecord record;
+
+    // Record without padding is kept, padding is restored.
+    for (size_t n = 0; n < 5; n++) {
+        CHECK(reader.read(record));
+        check_record(record, core::Second, address::Iface_AudioSource, addr,
+                     DatagramSize, (uint8_t)n);
+    }
+
+    CHECK(!reader.read(record));
+}
+
+TEST(trace, bad_file) {
+    core::TempFile file("test.trace");
+
+    {
+        const int fd = open(file.path(), O_WRONLY);
+        CHECK(fd != -1);
+        const char garbage[] = "not a packet trace file";
+        CHECK(write(fd, garbage, sizeof(garbage)) == (ssize_t)sizeof(garbage));
+        CHECK(close(fd) == 0);
+    }
+
+    TraceReader reader;
+    CHECK(!reader.open(file.path()));
+
+    // Lowest free descriptor is the same if writer closed its descriptor.
+    const int free_fd = dup(0);
+    CHECK(free_fd != -1);
+    CHECK(close(free_fd) == 0);
+
+    TraceWriter writer;
+    CHECK(!writer.open(file.path()));
+
+    CHECK(dup(0) == free_fd);
+    CHECK(close(free_fd) == 0);
+}
+
+} // namespace packet
+} // namespace roc
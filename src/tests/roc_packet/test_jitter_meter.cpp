@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_allocator.h"
+#include "roc_packet/jitter_meter.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_packet/queue.h"
+#include "roc_pipeline/config.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { SampleRate = 1000, NumSamples = 10, NumPackets = 500 };
+
+const core::nanoseconds_t NsPerPacket = NumSamples * core::Second / SampleRate;
+const core::nanoseconds_t StartTime = 1000000 * core::Second;
+
+const audio::SampleSpec SampleSpecs =
+    audio::SampleSpec(SampleRate, pipeline::DefaultChannelMask);
+
+core::HeapAllocator allocator;
+PacketFactory packet_factory(allocator, true);
+
+PacketPtr new_packet(source_t src, seqnum_t sn, core::nanoseconds_t receive_ts) {
+    PacketPtr packet = packet_factory.new_packet();
+    CHECK(packet);
+
+    packet->add_flags(Packet::FlagUDP | Packet::FlagRTP | Packet::FlagAudio);
+    packet->udp()->receive_timestamp = receive_ts;
+    packet->rtp()->source = src;
+    packet->rtp()->seqnum = sn;
+    packet->rtp()->timestamp = timestamp_t(sn * NumSamples);
+
+    return packet;
+}
+
+} // namespace
+
+TEST_GROUP(jitter_meter) {};
+
+TEST(jitter_meter, no_packets) {
+    Queue queue;
+    JitterMeter meter(queue, SampleSpecs);
+
+    LONGS_EQUAL(0, meter.jitter());
+    LONGS_EQUAL(0, meter.n_packets());
+}
+
+TEST(jitter_meter, passthrough) {
+    Queue queue;
+    JitterMeter meter(queue, SampleSpecs);
+
+    for (seqnum_t n = 0; n < NumPackets; n++) {
+        PacketPtr packet = new_packet(1, n, StartTime + n * NsPerPacket);
+        meter.write(packet);
+        CHECK(queue.read() == packet);
+    }
+
+    LONGS_EQUAL(NumPackets, meter.n_packets());
+}
+
+TEST(jitter_meter, constant_delay) {
+    Queue queue;
+    JitterMeter meter(queue, SampleSpecs);
+
+    for (seqnum_t n = 0; n < NumPackets; n++) {
+        meter.write(new_packet(1, n, StartTime + n * NsPerPacket));
+    }
+
+    LONGS_EQUAL(0, meter.jitter());
+}
+
+TEST(jitter_meter, alternating_delay) {
+    enum { Delta = 2 * core::Millisecond };
+
+    Queue queue;
+    JitterMeter meter(queue, SampleSpecs);
+
+    for (seqnum_t n = 0; n < NumPackets; n++) {
+        const core::nanoseconds_t delay = (n % 2) ? Delta : 0;
+        meter.write(new_packet(1, n, StartTime + n * NsPerPacket + delay));
+    }
+
+    // every transit time difference is Delta, so jitter converges to Delta
+    CHECK(meter.jitter() > Delta - core::Microsecond);
+    CHECK(meter.jitter() <= Delta);
+}
+
+TEST(jitter_meter, no_timestamp) {
+    Queue queue;
+    JitterMeter meter(queue, SampleSpecs);
+
+    for (seqnum_t n = 0; n < NumPackets; n++) {
+        PacketPtr packet = new_packet(1, n, 0);
+        meter.write(packet);
+        CHECK(queue.read() == packet);
+    }
+
+    LONGS_EQUAL(0, meter.n_packets());
+    LONGS_EQUAL(0, meter.jitter());
+}
+
+TEST(jitter_meter, loss_burst) {
+    enum { BurstLen = 5 };
+
+    Queue queue;
+    JitterMeter meter(queue, SampleSpecs);
+
+    for (seqnum_t n = 0; n < NumPackets; n++) {
+        meter.write(new_packet(1, n, StartTime + n * NsPerPacket));
+    }
+
+    LONGS_EQUAL(0, meter.loss_burst());
+
+    // skip BurstLen packets
+    for (seqnum_t n = NumPackets + BurstLen; n < NumPackets * 2; n++) {
+        meter.write(new_packet(1, n, StartTime + n * NsPerPacket));
+
+        if (n == NumPackets + BurstLen) {
+            CHECK(meter.loss_burst() > (BurstLen - 1) * NsPerPacket);
+            CHECK(meter.loss_burst() <= BurstLen * NsPerPacket);
+        }
+    }
+
+    // burst decays slowly
+    CHECK(meter.loss_burst() > 0);
+    CHECK(meter.loss_burst() < BurstLen * NsPerPacket);
+}
+
+TEST(jitter_meter, lost_packets) {
+    enum { NumLost = 7, Reordered = 3 };
+
+    Queue queue;
+    JitterMeter meter(queue, SampleSpecs);
+
+    for (seqnum_t n = 0; n < NumPackets; n++) {
+        if (n % 50 == 10 && n / 50 < NumLost) {
+            continue;
+        }
+        meter.write(new_packet(1, n, 0));
+    }
+
+    LONGS_EQUAL(NumPackets - NumLost, meter.n_received_packets());
+    LONGS_EQUAL(NumLost, meter.n_lost_packets());
+
+    // late arrival of lost packets is not a loss
+    for (size_t n = 0; n < Reordered; n++) {
+        meter.write(new_packet(1, seqnum_t(n * 50 + 10), 0));
+    }
+
+    LONGS_EQUAL(NumLost - Reordered, meter.n_lost_packets());
+
+    // losses are kept when source changes
+    meter.write(new_packet(2, 1000, 0));
+    meter.write(new_packet(2, 1002, 0));
+
+    LONGS_EQUAL(NumLost - Reordered + 1, meter.n_lost_packets());
+}
+
+TEST(jitter_meter, lost_packets_wrap) {
+    Queue queue;
+    JitterMeter meter(queue, SampleSpecs);
+
+    seqnum_t sn = seqnum_t(-NumPackets / 2);
+
+    for (size_t n = 0; n < NumPackets; n++) {
+        if (n != NumPackets / 2) {
+            meter.write(new_packet(1, sn, 0));
+        }
+        sn++;
+    }
+
+    LONGS_EQUAL(1, meter.n_lost_packets());
+}
+
+TEST(jitter_meter, source_change) {
+    enum { Delta = 2 * core::Millisecond };
+
+    Queue queue;
+    JitterMeter meter(queue, SampleSpecs);
+
+    for (seqnum_t n = 0; n < NumPackets; n++) {
+        const core::nanoseconds_t delay = (n % 2) ? Delta : 0;
+        meter.write(new_packet(1, n, StartTime + n * NsPerPacket + delay));
+    }
+
+    CHECK(meter.jitter() > 0);
+
+    meter.write(new_packet(2, 0, StartTime));
+
+    LONGS_EQUAL(0, meter.jitter());
+    LONGS_EQUAL(1, meter.n_packets());
+}
+
+} // namespace packet
+} // namespace roc
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_core/heap_allocator.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_packet/queue.h"
+#include "roc_packet/queueing_delay_meter.h"
+
+namespace roc {
+namespace packet {
+
+namespace {
+
+enum { NumPackets = 10 };
+
+const core::nanoseconds_t Delay = 10 * core::Second;
+
+core::HeapAllocator allocator;
+PacketFactory packet_factory(allocator, true);
+
+PacketPtr new_packet(core::nanoseconds_t receive_ts) {
+    PacketPtr packet = packet_factory.new_packet();
+    CHECK(packet);
+
+    packet->add_flags(Packet::FlagUDP);
+    packet->udp()->receive_timestamp = receive_ts;
+
+    return packet;
+}
+
+} // namespace
+
+TEST_GROUP(queueing_delay_meter) {};
+
+TEST(queueing_delay_meter, empty) {
+    Queue queue;
+    QueueingDelayMeter meter(queue);
+
+    CHECK(!meter.read());
+    LONGS_EQUAL(0, meter.queueing_delay());
+}
+
+TEST(queueing_delay_meter, delay) {
+    Queue queue;
+    QueueingDelayMeter meter(queue);
+
+    for (int n = 0; n < NumPackets; n++) {
+        PacketPtr packet = new_packet(core::timestamp(core::ClockUnix) - Delay);
+        queue.write(packet);
+        CHECK(meter.read() == packet);
+
+        CHECK(meter.last_queueing_delay() >= Delay);
+        CHECK(meter.last_queueing_delay() < Delay + core::Second);
+
+        CHECK(meter.queueing_delay() >= Delay);
+        CHECK(meter.queueing_delay() < Delay + core::Second);
+    }
+}
+
+TEST(queueing_delay_meter, no_timestamp) {
+    Queue queue;
+    QueueingDelayMeter meter(queue);
+
+    for (int n = 0; n < NumPackets; n++) {
+        PacketPtr packet = new_packet(0);
+        queue.write(packet);
+        CHECK(meter.read() == packet);
+    }
+
+    LONGS_EQUAL(0, meter.queueing_delay());
+    LONGS_EQUAL(0, meter.last_queueing_delay());
+}
+
+} // namespace packet
+} // namespace roc
@@ -9,6 +9,7 @@
 #include <CppUTest/TestHarness.h>
 
 #include "roc_core/heap_allocator.h"
+#include "roc_core/time.h"
 #include "roc_fec/codec_map.h"
 #include "roc_peer/context.h"
 #include "roc_peer/receiver.h"
@@ -26,6 +27,14 @@ void parse_uri(address::EndpointUri& uri, const char* str) {
     CHECK(address::parse_endpoint_uri(str, address::EndpointUri::Subset_Full, uri));
 }
 
+void query_port_metrics(Receiver& receiver, ReceiverPortMetrics& port_metrics) {
+    pipeline::ReceiverMetrics recv_metrics;
+    size_t sess_metrics_size = 0;
+
+    CHECK(receiver.get_metrics(DefaultSlot, recv_metrics, port_metrics, NULL,
+                               &sess_metrics_size, NULL));
+}
+
 } // namespace
 
 TEST_GROUP(receiver) {
@@ -196,5 +205,73 @@ TEST(receiver, endpoints_fec) {
     }
 }
 
+TEST(receiver, busy_polling_metrics) {
+    enum { NumPackets = 10, PacketSize = 100, MaxWaitMs = 5000 };
+
+    Context context(context_config, allocator);
+    CHECK(context.valid());
+
+    Receiver receiver(context, receiver_config);
+    CHECK(receiver.valid());
+
+    address::EndpointUri source_endp(allocator);
+    parse_uri(source_endp, "rtp://127.0.0.1:0");
+
+    CHECK(receiver.set_busy_polling(DefaultSlot, address::Iface_AudioSource,
+                                    core::Millisecond, 0));
+    CHECK(receiver.bind(DefaultSlot, address::Iface_AudioSource, source_endp));
+
+    ReceiverPortMetrics port_metrics;
+    query_port_metrics(receiver, port_metrics);
+
+    UNSIGNED_LONGS_EQUAL(0, port_metrics.busy_poll_packets);
+
+    netio::UdpSenderConfig tx_config;
+    CHECK(tx_config.bind_address.set_host_port(address::Family_IPv4, "127.0.0.1", 0));
+
+    netio::NetworkLoop::Tasks::AddUdpSenderPort tx_task(tx_config);
+    CHECK(context.network_loop().schedule_and_wait(tx_task));
+
+    address::SocketAddr rx_address;
+    CHECK(rx_address.set_host_port(address::Family_IPv4, "127.0.0.1",
+                                   source_endp.port()));
+
+    // packets are counted by busy polling thread even if pipeline drops them
+    for (int n = 0; n < NumPackets; n++) {
+        packet::PacketPtr pp = context.packet_factory().new_packet();
+        CHECK(pp);
+
+        pp->add_flags(packet::Packet::FlagUDP);
+        pp->udp()->src_addr = tx_config.bind_address;
+        pp->udp()->dst_addr = rx_address;
+
+        core::Slice<uint8_t> buffer = context.byte_buffer_factory().new_buffer();
+        CHECK(buffer);
+        buffer.reslice(0, PacketSize);
+        memset(buffer.data(), 0, PacketSize);
+
+        pp->set_data(buffer);
+
+        tx_task.get_writer()->write(pp);
+    }
+
+    for (int n_wait = 0;; n_wait++) {
+        CHECK(n_wait < MaxWaitMs);
+
+        query_port_metrics(receiver, port_metrics);
+        if (port_metrics.busy_poll_packets == NumPackets) {
+            break;
+        }
+
+        core::sleep_for(core::ClockMonotonic, core::Millisecond);
+    }
+
+    CHECK(port_metrics.busy_poll_spin_packets + port_metrics.busy_poll_parked_packets
+          <= port_metrics.busy_poll_packets);
+
+    netio::NetworkLoop::Tasks::RemovePort remove_task(tx_task.get_handle());
+    CHECK(context.network_loop().schedule_and_wait(remove_task));
+}
+
 } // namespace peer
 } // namespace roc
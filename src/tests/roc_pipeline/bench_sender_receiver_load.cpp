@@ -0,0 +1,528 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "roc_address/socket_addr.h"
+#include "roc_core/buffer_factory.h"
+#include "roc_core/fast_random.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/noncopyable.h"
+#include "roc_core/optional.h"
+#include "roc_core/panic.h"
+#include "roc_core/stddefs.h"
+#include "roc_core/time.h"
+#include "roc_fec/codec_map.h"
+#include "roc_packet/iwriter.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_pipeline/receiver_source.h"
+#include "roc_pipeline/sender_sink.h"
+#include "roc_rtp/format_map.h"
+
+namespace roc {
+namespace pipeline {
+namespace {
+
+// --------
+// Overview
+// --------
+//
+// This benchmark measures how much CPU time sender and receiver pipelines need
+// per stream, to estimate how many streams one CPU core can handle.
+//
+// N SenderSink instances are connected to one ReceiverSource via in-memory
+// links, without sockets and network threads. Every sender becomes a separate
+// session on receiver. Timing is disabled, so pipelines run faster than real
+// time: each iteration writes one frame to every sender and then reads one
+// mixed frame from receiver, on the same thread.
+//
+// Links may drop and reorder packets to emulate network imperfections.
+// Packets are delivered right after they were produced, so there is no jitter.
+//
+// ---------
+// Scenarios
+// ---------
+//
+// Bare             - no FEC, no resampling
+// FEC              - Reed-Solomon FEC
+// Resampler_Low    - resampling on receiver, low quality profile
+// Resampler_Medium - resampling on receiver, medium quality profile
+// Resampler_High   - resampling on receiver, high quality profile
+// Loss             - no FEC, with packet losses and reordering
+// FEC_Loss         - Reed-Solomon FEC, with packet losses and reordering
+// Full             - FEC, medium resampling, packet losses and reordering
+//
+// Benchmark argument is the number of streams.
+//
+// --------------
+// Output columns
+// --------------
+//
+// Time, CPU    - time to send and receive one frame of all streams
+// Iterations   - number of frames
+//
+// send_us      - sender time per stream per second of audio, microseconds
+// recv_us      - receiver time per stream per second of audio, microseconds
+// max_streams  - how many streams (sender and receiver) fit into one core
+// max_sess     - how many receiver sessions fit into one core
+//
+// All pipelines run on the benchmark thread, so measured wall clock time
+// approximates CPU time when the machine is otherwise idle.
+
+enum {
+    SampleRate = 44100,
+    OutputSampleRate = 48000,
+    ChMask = 0x3,
+    NumCh = 2,
+
+    MaxBufSize = 8192,
+    MaxStreams = 64,
+
+    SourcePackets = 20,
+    RepairPackets = 10,
+
+    NumIterations = 3000
+};
+
+const core::nanoseconds_t PacketLength = 5 * core::Millisecond;
+const core::nanoseconds_t FrameLength = 10 * core::Millisecond;
+const core::nanoseconds_t Latency = 100 * core::Millisecond;
+
+// number of frames to run before measurement, until all sessions are started
+const size_t NumWarmupFrames = size_t(Latency / FrameLength) * 4;
+
+// packet losses and reordering in lossy scenarios, in percents
+const int LossPercent = 2;
+const int ReorderPercent = 5;
+
+struct Scenario {
+    packet::FecScheme fec_scheme;
+    bool resampling;
+    audio::ResamplerProfile resampler_profile;
+    int loss_percent;
+    int reorder_percent;
+
+    Scenario()
+        : fec_scheme(packet::FEC_None)
+        , resampling(false)
+        , resampler_profile(audio::ResamplerProfile_Medium)
+        , loss_percent(0)
+        , reorder_percent(0) {
+    }
+};
+
+core::HeapAllocator allocator;
+core::BufferFactory<audio::sample_t> sample_buffer_factory(allocator, MaxBufSize, false);
+core::BufferFactory<uint8_t> byte_buffer_factory(allocator, MaxBufSize, false);
+packet::PacketFactory packet_factory(allocator, false);
+rtp::FormatMap format_map;
+
+address::SocketAddr make_address(int port) {
+    address::SocketAddr addr;
+    roc_panic_if_not(addr.set_host_port(address::Family_IPv4, "127.0.0.1", port));
+    return addr;
+}
+
+// In-memory link from a sender to receiver.
+// Assigns unique source address to packets, so that every sender gets its
+// own session on receiver, and drops and reorders packets.
+class Link : public packet::IWriter, public core::NonCopyable<> {
+public:
+    Link(const address::SocketAddr& src_addr,
+         packet::IWriter& source_writer,
+         packet::IWriter* repair_writer,
+         const Scenario& scenario)
+        : src_addr_(src_addr)
+        , source_writer_(source_writer)
+        , repair_writer_(repair_writer)
+        , loss_percent_(scenario.loss_percent)
+        , reorder_percent_(scenario.reorder_percent)
+        , delayed_repair_(false) {
+    }
+
+    virtual void write(const packet::PacketPtr& pp) {
+        if (loss_percent_ != 0 && (int)core::fast_random(0, 99) < loss_percent_) {
+            return;
+        }
+
+        const bool repair = (pp->flags() & packet::Packet::FlagRepair);
+
+        packet::PacketPtr copy = copy_packet_(pp);
+
+        if (!delayed_ && reorder_percent_ != 0
+            && (int)core::fast_random(0, 99) < reorder_percent_) {
+            // deliver after next packet
+            delayed_ = copy;
+            delayed_repair_ = repair;
+            return;
+        }
+
+        deliver_(copy, repair);
+
+        if (delayed_) {
+            deliver_(delayed_, delayed_repair_);
+            delayed_ = NULL;
+        }
+    }
+
+private:
+    packet::PacketPtr copy_packet_(const packet::PacketPtr& pa) {
+        packet::PacketPtr pb = packet_factory.new_packet();
+        roc_panic_if_not(pb);
+
+        pb->add_flags(packet::Packet::FlagUDP);
+        *pb->udp() = *pa->udp();
+        pb->udp()->src_addr = src_addr_;
+
+        pb->set_data(pa->data());
+
+        return pb;
+    }
+
+    void deliver_(const packet::PacketPtr& pp, bool repair) {
+        if (repair) {
+            roc_panic_if_not(repair_writer_);
+            repair_writer_->write(pp);
+        } else {
+            source_writer_.write(pp);
+        }
+    }
+
+    const address::SocketAddr src_addr_;
+
+    packet::IWriter& source_writer_;
+    packet::IWriter* repair_writer_;
+
+    const int loss_percent_;
+    const int reorder_percent_;
+
+    packet::PacketPtr delayed_;
+    bool delayed_repair_;
+};
+
+SenderConfig make_sender_config(const Scenario& scenario) {
+    SenderConfig config;
+
+    config.input_sample_spec = audio::SampleSpec(SampleRate, ChMask);
+    config.packet_length = PacketLength;
+    config.internal_frame_length = FrameLength;
+
+    config.fec_encoder.scheme = scenario.fec_scheme;
+    config.fec_writer.n_source_packets = SourcePackets;
+    config.fec_writer.n_repair_packets = RepairPackets;
+
+    config.timing = false;
+
+    return config;
+}
+
+ReceiverConfig make_receiver_config(const Scenario& scenario) {
+    ReceiverConfig config;
+
+    config.common.output_sample_spec = audio::SampleSpec(
+        scenario.resampling ? OutputSampleRate : SampleRate, ChMask);
+    config.common.internal_frame_length = FrameLength;
+
+    config.common.resampling = scenario.resampling;
+    config.common.timing = false;
+
+    config.default_session.target_latency = Latency;
+    config.default_session.resampler_profile = scenario.resampler_profile;
+
+    return config;
+}
+
+address::Protocol select_source_proto(const Scenario& scenario) {
+    if (scenario.fec_scheme == packet::FEC_ReedSolomon_M8) {
+        return address::Proto_RTP_RS8M_Source;
+    }
+    if (scenario.fec_scheme == packet::FEC_LDPC_Staircase) {
+        return address::Proto_RTP_LDPC_Source;
+    }
+    return address::Proto_RTP;
+}
+
+address::Protocol select_repair_proto(const Scenario& scenario) {
+    if (scenario.fec_scheme == packet::FEC_ReedSolomon_M8) {
+        return address::Proto_RS8M_Repair;
+    }
+    if (scenario.fec_scheme == packet::FEC_LDPC_Staircase) {
+        return address::Proto_LDPC_Repair;
+    }
+    return address::Proto_None;
+}
+
+void run_scenario(benchmark::State& state, const Scenario& scenario) {
+    const size_t num_streams = (size_t)state.range(0);
+
+    roc_panic_if_not(num_streams > 0 && num_streams <= MaxStreams);
+
+    if (scenario.fec_scheme != packet::FEC_None
+        && !fec::CodecMap::instance().is_supported(scenario.fec_scheme)) {
+        state.SkipWithError("fec scheme not supported");
+        return;
+    }
+
+    const address::Protocol source_proto = select_source_proto(scenario);
+    const address::Protocol repair_proto = select_repair_proto(scenario);
+
+    ReceiverSource receiver(make_receiver_config(scenario), format_map, packet_factory,
+                            byte_buffer_factory, sample_buffer_factory, allocator);
+    roc_panic_if_not(receiver.valid());
+
+    ReceiverSlot* receiver_slot = receiver.create_slot();
+    roc_panic_if_not(receiver_slot);
+
+    ReceiverEndpoint* receiver_source_endpoint =
+        receiver_slot->create_endpoint(address::Iface_AudioSource, source_proto);
+    roc_panic_if_not(receiver_source_endpoint);
+
+    ReceiverEndpoint* receiver_repair_endpoint = NULL;
+    if (repair_proto != address::Proto_None) {
+        receiver_repair_endpoint =
+            receiver_slot->create_endpoint(address::Iface_AudioRepair, repair_proto);
+        roc_panic_if_not(receiver_repair_endpoint);
+    }
+
+    core::Optional<Link> links[MaxStreams];
+    core::Optional<SenderSink> senders[MaxStreams];
+
+    for (size_t n = 0; n < num_streams; n++) {
+        links[n].reset(new (links[n]) Link(
+            make_address(10000 + (int)n), receiver_source_endpoint->writer(),
+            receiver_repair_endpoint ? &receiver_repair_endpoint->writer() : NULL,
+            scenario));
+
+        senders[n].reset(new (senders[n])
+                             SenderSink(make_sender_config(scenario), format_map,
+                                        packet_factory, byte_buffer_factory,
+                                        sample_buffer_factory, allocator));
+        roc_panic_if_not(senders[n]->valid());
+
+        SenderSlot* sender_slot = senders[n]->create_slot();
+        roc_panic_if_not(sender_slot);
+
+        SenderEndpoint* source_endpoint =
+            sender_slot->create_endpoint(address::Iface_AudioSource, source_proto);
+        roc_panic_if_not(source_endpoint);
+        source_endpoint->set_destination_writer(*links[n]);
+        source_endpoint->set_destination_address(make_address(1));
+
+        if (repair_proto != address::Proto_None) {
+            SenderEndpoint* repair_endpoint =
+                sender_slot->create_endpoint(address::Iface_AudioRepair, repair_proto);
+            roc_panic_if_not(repair_endpoint);
+            repair_endpoint->set_destination_writer(*links[n]);
+            repair_endpoint->set_destination_address(make_address(2));
+        }
+    }
+
+    const size_t send_frame_size =
+        (size_t)(FrameLength * SampleRate / core::Second) * NumCh;
+    const size_t recv_frame_size =
+        receiver.sample_spec().ns_2_samples_overall(FrameLength);
+
+    core::Slice<audio::sample_t> send_buf = sample_buffer_factory.new_buffer();
+    core::Slice<audio::sample_t> recv_buf = sample_buffer_factory.new_buffer();
+
+    roc_panic_if_not(send_buf && send_frame_size <= send_buf.capacity());
+    roc_panic_if_not(recv_buf && recv_frame_size <= recv_buf.capacity());
+
+    send_buf.reslice(0, send_frame_size);
+    recv_buf.reslice(0, recv_frame_size);
+
+    for (size_t n = 0; n < send_frame_size; n++) {
+        send_buf.data()[n] = (audio::sample_t)(n % 100) / 100 - 0.5f;
+    }
+
+    for (size_t nf = 0; nf < NumWarmupFrames; nf++) {
+        for (size_t n = 0; n < num_streams; n++) {
+            audio::Frame send_frame(send_buf.data(), send_buf.size());
+            senders[n]->write(send_frame);
+        }
+
+        audio::Frame recv_frame(recv_buf.data(), recv_buf.size());
+        roc_panic_if_not(receiver.read(recv_frame));
+    }
+
+    roc_panic_if_not(receiver.num_sessions() == num_streams);
+
+    core::nanoseconds_t send_time = 0;
+    core::nanoseconds_t recv_time = 0;
+    size_t num_frames = 0;
+
+    while (state.KeepRunning()) {
+        const core::nanoseconds_t send_start = core::timestamp(core::ClockMonotonic);
+
+        for (size_t n = 0; n < num_streams; n++) {
+            audio::Frame send_frame(send_buf.data(), send_buf.size());
+            senders[n]->write(send_frame);
+        }
+
+        const core::nanoseconds_t recv_start = core::timestamp(core::ClockMonotonic);
+
+        audio::Frame recv_frame(recv_buf.data(), recv_buf.size());
+        roc_panic_if_not(receiver.read(recv_frame));
+
+        const core::nanoseconds_t recv_end = core::timestamp(core::ClockMonotonic);
+
+        send_time += recv_start - send_start;
+        recv_time += recv_end - recv_start;
+        num_frames++;
+    }
+
+    if (num_frames == 0 || send_time == 0 || recv_time == 0) {
+        return;
+    }
+
+    // total duration of audio passed through every stream
+    const double audio_sec = double(num_frames) * FrameLength / core::Second;
+
+    state.counters["send_us"] =
+        double(send_time) / core::Microsecond / num_streams / audio_sec;
+    state.counters["recv_us"] =
+        double(recv_time) / core::Microsecond / num_streams / audio_sec;
+
+    state.counters["max_streams"] =
+        audio_sec * core::Second * num_streams / double(send_time + recv_time);
+    state.counters["max_sess"] =
+        audio_sec * core::Second * num_streams / double(recv_time);
+}
+
+void BM_SenderReceiverLoad_Bare(benchmark::State& state) {
+    Scenario scenario;
+
+    run_scenario(state, scenario);
+}
+
+BENCHMARK(BM_SenderReceiverLoad_Bare)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(32)
+    ->Iterations(NumIterations)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_SenderReceiverLoad_FEC(benchmark::State& state) {
+    Scenario scenario;
+    scenario.fec_scheme = packet::FEC_ReedSolomon_M8;
+
+    run_scenario(state, scenario);
+}
+
+BENCHMARK(BM_SenderReceiverLoad_FEC)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(32)
+    ->Iterations(NumIterations)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_SenderReceiverLoad_Resampler_Low(benchmark::State& state) {
+    Scenario scenario;
+    scenario.resampling = true;
+    scenario.resampler_profile = audio::ResamplerProfile_Low;
+
+    run_scenario(state, scenario);
+}
+
+BENCHMARK(BM_SenderReceiverLoad_Resampler_Low)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(32)
+    ->Iterations(NumIterations)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_SenderReceiverLoad_Resampler_Medium(benchmark::State& state) {
+    Scenario scenario;
+    scenario.resampling = true;
+    scenario.resampler_profile = audio::ResamplerProfile_Medium;
+
+    run_scenario(state, scenario);
+}
+
+BENCHMARK(BM_SenderReceiverLoad_Resampler_Medium)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(32)
+    ->Iterations(NumIterations)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_SenderReceiverLoad_Resampler_High(benchmark::State& state) {
+    Scenario scenario;
+    scenario.resampling = true;
+    scenario.resampler_profile = audio::ResamplerProfile_High;
+
+    run_scenario(state, scenario);
+}
+
+BENCHMARK(BM_SenderReceiverLoad_Resampler_High)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(32)
+    ->Iterations(NumIterations)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_SenderReceiverLoad_Loss(benchmark::State& state) {
+    Scenario scenario;
+    scenario.loss_percent = LossPercent;
+    scenario.reorder_percent = ReorderPercent;
+
+    run_scenario(state, scenario);
+}
+
+BENCHMARK(BM_SenderReceiverLoad_Loss)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(32)
+    ->Iterations(NumIterations)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_SenderReceiverLoad_FEC_Loss(benchmark::State& state) {
+    Scenario scenario;
+    scenario.fec_scheme = packet::FEC_ReedSolomon_M8;
+    scenario.loss_percent = LossPercent;
+    scenario.reorder_percent = ReorderPercent;
+
+    run_scenario(state, scenario);
+}
+
+BENCHMARK(BM_SenderReceiverLoad_FEC_Loss)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(32)
+    ->Iterations(NumIterations)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_SenderReceiverLoad_Full(benchmark::State& state) {
+    Scenario scenario;
+    scenario.fec_scheme = packet::FEC_ReedSolomon_M8;
+    scenario.resampling = true;
+    scenario.resampler_profile = audio::ResamplerProfile_Medium;
+    scenario.loss_percent = LossPercent;
+    scenario.reorder_percent = ReorderPercent;
+
+    run_scenario(state, scenario);
+}
+
+BENCHMARK(BM_SenderReceiverLoad_Full)
+    ->Arg(1)
+    ->Arg(8)
+    ->Arg(32)
+    ->Iterations(NumIterations)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+} // namespace pipeline
+} // namespace roc
@@ -61,6 +61,15 @@ public:
         }
     }
 
+    void skip_samples(size_t num_samples) {
+        core::Slice<audio::sample_t> samples = buffer_factory_.new_buffer();
+        CHECK(samples);
+        samples.reslice(0, num_samples);
+
+        audio::Frame frame(samples.data(), samples.size());
+        CHECK(source_.read(frame));
+    }
+
     void set_offset(size_t offset) {
         offset_ = uint8_t(offset);
     }
@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "roc_audio/resampler_map.h"
+#include "roc_core/array.h"
+#include "roc_core/buffer_factory.h"
+#include "roc_core/fast_random.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_pipeline/converter_sink.h"
+#include "roc_pipeline/parallel_converter.h"
+
+namespace roc {
+namespace pipeline {
+
+namespace {
+
+enum { MaxBufSize = 8000, SamplesPerFrame = 441, NumWorkers = 3 };
+
+const core::nanoseconds_t FrameLength = 10 * core::Millisecond;
+const core::nanoseconds_t ChunkLength = 50 * core::Millisecond;
+
+core::HeapAllocator allocator;
+core::BufferFactory<audio::sample_t> sample_buffer_factory(allocator, MaxBufSize, true);
+
+class SampleCollector : public audio::IFrameWriter {
+public:
+    SampleCollector()
+        : samples_(allocator) {
+    }
+
+    virtual void write(audio::Frame& frame) {
+        const size_t pos = samples_.size();
+        CHECK(samples_.grow_exp(pos + frame.num_samples()));
+        CHECK(samples_.resize(pos + frame.num_samples()));
+        memcpy(samples_.data() + pos, frame.samples(),
+               frame.num_samples() * sizeof(audio::sample_t));
+    }
+
+    const core::Array<audio::sample_t>& samples() const {
+        return samples_;
+    }
+
+private:
+    core::Array<audio::sample_t> samples_;
+};
+
+void generate_input(core::Array<audio::sample_t>& input, size_t size) {
+    CHECK(input.resize(size));
+    for (size_t n = 0; n < size; n++) {
+        input[n] = float(core::fast_random(0, 2000)) / 1000.f - 1.f;
+    }
+}
+
+void write_input(sndio::ISink& sink,
+                 core::Array<audio::sample_t>& input,
+                 size_t frame_size) {
+    for (size_t pos = 0; pos < input.size(); pos += frame_size) {
+        audio::Frame frame(input.data() + pos, frame_size);
+        sink.write(frame);
+    }
+}
+
+void check_equal(const SampleCollector& expected, const SampleCollector& actual) {
+    LONGS_EQUAL(expected.samples().size(), actual.samples().size());
+
+    for (size_t n = 0; n < expected.samples().size(); n++) {
+        if (expected.samples()[n] != actual.samples()[n]) {
+            FAIL("output of parallel converter differs from sequential converter");
+        }
+    }
+}
+
+bool is_backend_supported(audio::ResamplerBackend backend) {
+    for (size_t n = 0; n < audio::ResamplerMap::instance().num_backends(); n++) {
+        if (audio::ResamplerMap::instance().nth_backend(n) == backend) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+TEST_GROUP(parallel_converter) {
+    ConverterConfig config;
+    ParallelConverterConfig parallel_config;
+
+    void setup() {
+        config.input_sample_spec = audio::SampleSpec(44100, 0x3);
+        config.output_sample_spec = audio::SampleSpec(44100, 0x3);
+
+        config.internal_frame_length = FrameLength;
+
+        config.resampler_backend = audio::ResamplerBackend_Builtin;
+        config.resampling = true;
+        config.poisoning = true;
+
+        parallel_config.num_workers = NumWorkers;
+        parallel_config.chunk_length = ChunkLength;
+    }
+
+    void check_conversion(size_t num_frames) {
+        const size_t frame_size =
+            config.input_sample_spec.ns_2_samples_overall(config.internal_frame_length);
+
+        core::Array<audio::sample_t> input(allocator);
+        generate_input(input, num_frames * frame_size);
+
+        SampleCollector expected;
+        {
+            ConverterSink converter(config, &expected, sample_buffer_factory, allocator);
+            CHECK(converter.valid());
+
+            core::Array<audio::sample_t> input_copy(allocator);
+            CHECK(input_copy.resize(input.size()));
+            memcpy(input_copy.data(), input.data(),
+                   input.size() * sizeof(audio::sample_t));
+
+            write_input(converter, input_copy, frame_size);
+        }
+
+        SampleCollector actual;
+        {
+            ParallelConverter converter(config, parallel_config, &actual,
+                                        sample_buffer_factory, allocator);
+            CHECK(converter.valid());
+            LONGS_EQUAL(NumWorkers, converter.num_workers());
+
+            write_input(converter, input, frame_size);
+            CHECK(converter.flush());
+        }
+
+        check_equal(expected, actual);
+    }
+};
+
+TEST(parallel_converter, no_resampling) {
+    const size_t num_frames[] = { 1, 4, 5, 9, 20, 57, 100 };
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(num_frames); n++) {
+        check_conversion(num_frames[n]);
+    }
+}
+
+TEST(parallel_converter, channel_mapping) {
+    config.output_sample_spec = audio::SampleSpec(44100, 0x1);
+
+    const size_t num_frames[] = { 1, 9, 57, 100 };
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(num_frames); n++) {
+        check_conversion(num_frames[n]);
+    }
+}
+
+TEST(parallel_converter, downsampling) {
+    config.input_sample_spec = audio::SampleSpec(88200, 0x3);
+
+    const size_t num_frames[] = { 1, 4, 5, 9, 20, 57, 100 };
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(num_frames); n++) {
+        check_conversion(num_frames[n]);
+    }
+}
+
+TEST(parallel_converter, upsampling) {
+    config.input_sample_spec = audio::SampleSpec(22050, 0x3);
+
+    const size_t num_frames[] = { 1, 4, 5, 9, 20, 57, 100 };
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(num_frames); n++) {
+        check_conversion(num_frames[n]);
+    }
+}
+
+TEST(parallel_converter, non_integer_ratio) {
+    config.input_sample_spec = audio::SampleSpec(48000, 0x3);
+    config.output_sample_spec = audio::SampleSpec(32000, 0x3);
+
+    const size_t num_frames[] = { 1, 9, 57, 100 };
+
+    for (size_t n = 0; n < ROC_ARRAY_SIZE(num_frames); n++) {
+        check_conversion(num_frames[n]);
+    }
+}
+
+TEST(parallel_converter, speex_resampling) {
+    if (!is_backend_supported(audio::ResamplerBackend_Speex)) {
+        return;
+    }
+
+    config.resampler_backend = audio::ResamplerBackend_Speex;
+
+    const size_t rates[][2] = {
+        { 44100, 44100 },
+        { 88200, 44100 },
+        { 48000, 32000 },
+        // speex returns to the same phase after a few frames, unlike builtin
+        { 44100, 48000 },
+    };
+
+    const size_t num_frames[] = { 1, 9, 57, 100 };
+
+    for (size_t r = 0; r < ROC_ARRAY_SIZE(rates); r++) {
+        config.input_sample_spec = audio::SampleSpec(rates[r][0], 0x3);
+        config.output_sample_spec = audio::SampleSpec(rates[r][1], 0x3);
+
+        for (size_t n = 0; n < ROC_ARRAY_SIZE(num_frames); n++) {
+            check_conversion(num_frames[n]);
+        }
+    }
+}
+
+TEST(parallel_converter, period_too_long) {
+    // Builtin resampler returns to the same phase only after hours of input.
+    config.input_sample_spec = audio::SampleSpec(44100, 0x3);
+    config.output_sample_spec = audio::SampleSpec(48000, 0x3);
+
+    ParallelConverter converter(config, parallel_config, NULL, sample_buffer_factory,
+                                allocator);
+    CHECK(!converter.valid());
+}
+
+TEST(parallel_converter, no_workers) {
+    parallel_config.num_workers = 0;
+
+    ParallelConverter converter(config, parallel_config, NULL, sample_buffer_factory,
+                                allocator);
+    CHECK(!converter.valid());
+}
+
+} // namespace pipeline
+} // namespace roc
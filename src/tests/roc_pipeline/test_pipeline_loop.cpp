@@ -54,6 +54,7 @@ public:
         , frame_allow_counter_(999999)
         , task_allow_counter_(999999)
         , time_(StartTime)
+        , frame_processing_time_(0)
         , exp_frame_val_(0)
         , exp_frame_sz_(0)
         , exp_sched_deadline_(-1)
@@ -68,6 +69,11 @@ public:
         time_ = t;
     }
 
+    void set_frame_processing_time(core::nanoseconds_t t) {
+        core::Mutex::Lock lock(mutex_);
+        frame_processing_time_ = t;
+    }
+
     void block_frames() {
         core::Mutex::Lock lock(mutex_);
         frame_allow_counter_ = 0;
@@ -201,6 +207,7 @@ private:
             roc_panic_if(std::abs(frame.samples()[n] - exp_frame_val_) > Epsilon);
         }
         n_processed_frames_++;
+        time_ += frame_processing_time_;
         return true;
     }
 
@@ -254,6 +261,7 @@ private:
     int task_allow_counter_;
 
     core::nanoseconds_t time_;
+    core::nanoseconds_t frame_processing_time_;
 
     audio::sample_t exp_frame_val_;
     size_t exp_frame_sz_;
@@ -2198,5 +2206,41 @@ TEST(task_pipeline, schedule_and_wait_until_process_frame_called) {
     UNSIGNED_LONGS_EQUAL(1, pipeline.num_sched_cancellations());
 }
 
+TEST(task_pipeline, frame_deadline_misses) {
+    enum { NumIters = 2 };
+
+    for (int iter = 0; iter < NumIters; iter++) {
+        config.enable_precise_task_scheduling = (iter == 0);
+
+        TestPipeline pipeline(config);
+
+        pipeline.set_time(StartTime);
+
+        audio::Frame frame(samples, FrameSize);
+        fill_frame(frame, 0.1f, 0, FrameSize);
+        pipeline.expect_frame(0.1f, FrameSize);
+
+        UNSIGNED_LONGS_EQUAL(0, pipeline.get_stats().frames_processed);
+        UNSIGNED_LONGS_EQUAL(0, pipeline.get_stats().frame_deadline_misses);
+
+        // frame is processed faster than real time
+        pipeline.set_frame_processing_time(FrameProcessingTime);
+        CHECK(pipeline.process_subframes_and_tasks(frame));
+
+        UNSIGNED_LONGS_EQUAL(1, pipeline.get_stats().frames_processed);
+        UNSIGNED_LONGS_EQUAL(0, pipeline.get_stats().frame_deadline_misses);
+
+        // frame is processed slower than real time
+        pipeline.set_frame_processing_time(FrameSize * core::Microsecond * 2);
+        CHECK(pipeline.process_subframes_and_tasks(frame));
+
+        UNSIGNED_LONGS_EQUAL(2, pipeline.get_stats().frames_processed);
+        UNSIGNED_LONGS_EQUAL(1, pipeline.get_stats().frame_deadline_misses);
+
+        UNSIGNED_LONGS_EQUAL(2, pipeline.num_processed_frames());
+        UNSIGNED_LONGS_EQUAL(0, pipeline.num_processed_tasks());
+    }
+}
+
 } // namespace pipeline
 } // namespace roc
@@ -75,6 +75,12 @@ create_endpoint(ReceiverSlot* slot, address::Interface iface, address::Protocol
     return &endpoint->writer();
 }
 
+void copy_sess_metrics(const ReceiverSessionMetrics& sess_metrics,
+                       size_t sess_index,
+                       void* sess_metrics_arg) {
+    ((ReceiverSessionMetrics*)sess_metrics_arg)[sess_index] = sess_metrics;
+}
+
 } // namespace
 
 TEST_GROUP(receiver_source) {
@@ -282,6 +288,198 @@ TEST(receiver_source, initial_latency_timeout) {
     UNSIGNED_LONGS_EQUAL(0, receiver.num_sessions());
 }
 
+TEST(receiver_source, fast_start) {
+    enum { StartLatency = Latency / 2, MaxPackets = ManyPackets * 50 };
+
+    config.common.resampling = true;
+
+    config.default_session.latency_monitor.start_latency =
+        StartLatency * core::Second / SampleRate;
+    config.default_session.latency_monitor.start_ramp = 0;
+
+    ReceiverSource receiver(config, format_map, packet_factory, byte_buffer_factory,
+                            sample_buffer_factory, allocator);
+
+    CHECK(receiver.valid());
+
+    ReceiverSlot* slot = create_slot(receiver);
+    CHECK(slot);
+
+    packet::IWriter* endpoint1_writer =
+        create_endpoint(slot, address::Iface_AudioSource, proto1);
+    CHECK(endpoint1_writer);
+
+    test::FrameReader frame_reader(receiver, sample_buffer_factory);
+
+    test::PacketWriter packet_writer(allocator, *endpoint1_writer, rtp_composer,
+                                     format_map, packet_factory, byte_buffer_factory,
+                                     PayloadType, src1, dst1);
+
+    ReceiverSessionMetrics metrics;
+    size_t metrics_size = 1;
+
+    // playback doesn't start until start latency is buffered
+    for (size_t np = 0; np < StartLatency / SamplesPerPacket - 1; np++) {
+        packet_writer.write_packets(1, SamplesPerPacket, SampleSpecs);
+
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.skip_zeros(SamplesPerFrame * NumCh);
+        }
+
+        UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+
+        slot->get_metrics(copy_sess_metrics, &metrics_size, &metrics);
+        UNSIGNED_LONGS_EQUAL(1, metrics_size);
+        LONGS_EQUAL(0, metrics.time_to_first_audio);
+    }
+
+    // playback starts with start latency, before target latency is buffered;
+    // resampler may need a few more packets to request input
+    size_t n_packets = StartLatency / SamplesPerPacket - 1;
+
+    while (metrics.time_to_first_audio == 0) {
+        packet_writer.write_packets(1, SamplesPerPacket, SampleSpecs);
+        n_packets++;
+
+        CHECK(n_packets < Latency / SamplesPerPacket);
+
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.skip_samples(SamplesPerFrame * NumCh);
+        }
+
+        UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+
+        slot->get_metrics(copy_sess_metrics, &metrics_size, &metrics);
+        UNSIGNED_LONGS_EQUAL(1, metrics_size);
+    }
+
+    CHECK(metrics.target_latency >= config.default_session.latency_monitor.start_latency);
+    CHECK(metrics.target_latency < config.default_session.target_latency);
+
+    // target latency then grows up to session target latency, rounded to samples
+    const core::nanoseconds_t final_target = SampleSpecs.rtp_timestamp_2_ns(
+        SampleSpecs.ns_2_rtp_timestamp(config.default_session.target_latency));
+
+    core::nanoseconds_t prev_target = metrics.target_latency;
+
+    for (size_t np = 0; np < MaxPackets; np++) {
+        packet_writer.write_packets(1, SamplesPerPacket, SampleSpecs);
+
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.skip_samples(SamplesPerFrame * NumCh);
+        }
+
+        UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+
+        slot->get_metrics(copy_sess_metrics, &metrics_size, &metrics);
+        UNSIGNED_LONGS_EQUAL(1, metrics_size);
+        CHECK(metrics.target_latency >= prev_target);
+        CHECK(metrics.target_latency <= final_target);
+
+        prev_target = metrics.target_latency;
+
+        if (metrics.target_latency == final_target) {
+            break;
+        }
+    }
+
+    LONGS_EQUAL(final_target, metrics.target_latency);
+}
+
+TEST(receiver_source, fast_start_below_min_latency) {
+    config.common.resampling = true;
+
+    config.default_session.latency_monitor.min_latency =
+        Latency / 2 * core::Second / SampleRate;
+    config.default_session.latency_monitor.start_latency =
+        Latency / 4 * core::Second / SampleRate;
+
+    ReceiverSource receiver(config, format_map, packet_factory, byte_buffer_factory,
+                            sample_buffer_factory, allocator);
+
+    CHECK(receiver.valid());
+
+    ReceiverSlot* slot = create_slot(receiver);
+    CHECK(slot);
+
+    packet::IWriter* endpoint1_writer =
+        create_endpoint(slot, address::Iface_AudioSource, proto1);
+    CHECK(endpoint1_writer);
+
+    test::FrameReader frame_reader(receiver, sample_buffer_factory);
+
+    test::PacketWriter packet_writer(allocator, *endpoint1_writer, rtp_composer,
+                                     format_map, packet_factory, byte_buffer_factory,
+                                     PayloadType, src1, dst1);
+
+    packet_writer.write_packets(1, SamplesPerPacket, SampleSpecs);
+    frame_reader.skip_zeros(SamplesPerFrame * NumCh);
+
+    // start latency is clamped to min latency, session is created
+    UNSIGNED_LONGS_EQUAL(1, receiver.num_sessions());
+
+    ReceiverSessionMetrics metrics;
+    size_t metrics_size = 1;
+
+    slot->get_metrics(copy_sess_metrics, &metrics_size, &metrics);
+    UNSIGNED_LONGS_EQUAL(1, metrics_size);
+    DOUBLES_EQUAL((double)config.default_session.latency_monitor.min_latency,
+                  (double)metrics.target_latency, (double)core::Second / SampleRate);
+}
+
+TEST(receiver_source, fast_start_invalid_config) {
+    { // fast start requires resampling
+        ReceiverConfig bad_config = config;
+        bad_config.common.resampling = false;
+        bad_config.default_session.latency_monitor.start_latency =
+            config.default_session.target_latency / 2;
+
+        ReceiverSource receiver(bad_config, format_map, packet_factory,
+                                byte_buffer_factory, sample_buffer_factory, allocator);
+        CHECK(receiver.valid());
+
+        ReceiverSlot* slot = create_slot(receiver);
+        packet::IWriter* endpoint_writer =
+            create_endpoint(slot, address::Iface_AudioSource, proto1);
+
+        test::PacketWriter packet_writer(allocator, *endpoint_writer, rtp_composer,
+                                         format_map, packet_factory, byte_buffer_factory,
+                                         PayloadType, src1, dst1);
+
+        packet_writer.write_packets(1, SamplesPerPacket, SampleSpecs);
+
+        test::FrameReader frame_reader(receiver, sample_buffer_factory);
+        frame_reader.skip_zeros(SamplesPerFrame * NumCh);
+
+        UNSIGNED_LONGS_EQUAL(0, receiver.num_sessions());
+    }
+    { // start latency above target latency
+        ReceiverConfig bad_config = config;
+        bad_config.common.resampling = true;
+        bad_config.default_session.latency_monitor.start_latency =
+            config.default_session.target_latency * 2;
+
+        ReceiverSource receiver(bad_config, format_map, packet_factory,
+                                byte_buffer_factory, sample_buffer_factory, allocator);
+        CHECK(receiver.valid());
+
+        ReceiverSlot* slot = create_slot(receiver);
+        packet::IWriter* endpoint_writer =
+            create_endpoint(slot, address::Iface_AudioSource, proto1);
+
+        test::PacketWriter packet_writer(allocator, *endpoint_writer, rtp_composer,
+                                         format_map, packet_factory, byte_buffer_factory,
+                                         PayloadType, src1, dst1);
+
+        packet_writer.write_packets(1, SamplesPerPacket, SampleSpecs);
+
+        test::FrameReader frame_reader(receiver, sample_buffer_factory);
+        frame_reader.skip_zeros(SamplesPerFrame * NumCh);
+
+        UNSIGNED_LONGS_EQUAL(0, receiver.num_sessions());
+    }
+}
+
 TEST(receiver_source, timeout) {
     ReceiverSource receiver(config, format_map, packet_factory, byte_buffer_factory,
                             sample_buffer_factory, allocator);
@@ -583,6 +781,48 @@ TEST(receiver_source, two_sessions_same_address_different_streams) {
     }
 }
 
+TEST(receiver_source, two_sessions_prewarmed) {
+    config.common.prewarmed_sessions = 4;
+
+    ReceiverSource receiver(config, format_map, packet_factory, byte_buffer_factory,
+                            sample_buffer_factory, allocator);
+
+    CHECK(receiver.valid());
+
+    ReceiverSlot* slot = create_slot(receiver);
+    CHECK(slot);
+
+    packet::IWriter* endpoint1_writer =
+        create_endpoint(slot, address::Iface_AudioSource, proto1);
+    CHECK(endpoint1_writer);
+
+    test::FrameReader frame_reader(receiver, sample_buffer_factory);
+
+    test::PacketWriter packet_writer1(allocator, *endpoint1_writer, rtp_composer,
+                                      format_map, packet_factory, byte_buffer_factory,
+                                      PayloadType, src1, dst1);
+
+    test::PacketWriter packet_writer2(allocator, *endpoint1_writer, rtp_composer,
+                                      format_map, packet_factory, byte_buffer_factory,
+                                      PayloadType, src2, dst1);
+
+    for (size_t np = 0; np < Latency / SamplesPerPacket; np++) {
+        packet_writer1.write_packets(1, SamplesPerPacket, SampleSpecs);
+        packet_writer2.write_packets(1, SamplesPerPacket, SampleSpecs);
+    }
+
+    for (size_t np = 0; np < ManyPackets; np++) {
+        for (size_t nf = 0; nf < FramesPerPacket; nf++) {
+            frame_reader.read_samples(SamplesPerFrame * NumCh, 2);
+
+            UNSIGNED_LONGS_EQUAL(2, receiver.num_sessions());
+        }
+
+        packet_writer1.write_packets(1, SamplesPerPacket, SampleSpecs);
+        packet_writer2.write_packets(1, SamplesPerPacket, SampleSpecs);
+    }
+}
+
 TEST(receiver_source, seqnum_overflow) {
     ReceiverSource receiver(config, format_map, packet_factory, byte_buffer_factory,
                             sample_buffer_factory, allocator);
@@ -12,6 +12,7 @@
 
 #include "roc_core/buffer_factory.h"
 #include "roc_core/heap_allocator.h"
+#include "roc_fec/codec_map.h"
 #include "roc_packet/packet_factory.h"
 #include "roc_pipeline/sender_loop.h"
 #include "roc_rtp/format_map.h"
@@ -134,5 +135,56 @@ TEST(sender_loop, endpoints_async) {
     scheduler.wait_done();
 }
 
+TEST(sender_loop, metrics_fec_interleaving_latency) {
+    if (!fec::CodecMap::instance().is_supported(packet::FEC_ReedSolomon_M8)) {
+        return;
+    }
+
+    enum { Span = 3, SourcePackets = 10, RepairPackets = 5 };
+
+    config.fec_encoder.scheme = packet::FEC_ReedSolomon_M8;
+    config.fec_writer.n_source_packets = SourcePackets;
+    config.fec_writer.n_repair_packets = RepairPackets;
+    config.fec_interleaver.enabled = true;
+    config.fec_interleaver.span = Span;
+    config.packet_length = 5 * core::Millisecond;
+
+    SenderLoop sender(scheduler, config, format_map, packet_factory, byte_buffer_factory,
+                      sample_buffer_factory, allocator);
+    CHECK(sender.valid());
+
+    LONGS_EQUAL(0, sender.get_metrics().latency);
+
+    SenderLoop::SlotHandle slot = NULL;
+
+    {
+        SenderLoop::Tasks::CreateSlot task;
+        CHECK(sender.schedule_and_wait(task));
+        CHECK(task.success());
+
+        slot = task.get_handle();
+    }
+
+    {
+        SenderLoop::Tasks::CreateEndpoint task(slot, address::Iface_AudioSource,
+                                               address::Proto_RTP_RS8M_Source);
+        CHECK(sender.schedule_and_wait(task));
+        CHECK(task.success());
+    }
+
+    // interleaver is created when both endpoints are present
+    LONGS_EQUAL(0, sender.get_metrics().latency);
+
+    {
+        SenderLoop::Tasks::CreateEndpoint task(slot, address::Iface_AudioRepair,
+                                               address::Proto_RS8M_Repair);
+        CHECK(sender.schedule_and_wait(task));
+        CHECK(task.success());
+    }
+
+    CHECK(Span * SourcePackets * config.packet_length == sender.get_metrics().latency);
+    CHECK(sender.get_metrics().latency == sender.sink().latency());
+}
+
 } // namespace pipeline
 } // namespace roc
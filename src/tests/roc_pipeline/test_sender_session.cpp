@@ -0,0 +1,384 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <CppUTest/TestHarness.h>
+
+#include "test_helpers/utils.h"
+
+#include "roc_core/buffer_factory.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/time.h"
+#include "roc_fec/codec_map.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_packet/queue.h"
+#include "roc_pipeline/receiver_session.h"
+#include "roc_pipeline/sender_endpoint.h"
+#include "roc_pipeline/sender_session.h"
+#include "roc_rtcp/composer.h"
+#include "roc_rtcp/session.h"
+#include "roc_rtcp/traverser.h"
+#include "roc_rtp/format_map.h"
+
+namespace roc {
+namespace pipeline {
+
+namespace {
+
+rtp::PayloadType PayloadType = rtp::PayloadType_L16_Stereo;
+
+enum {
+    MaxBufSize = 1000,
+
+    SampleRate = 44100,
+    ChMask = 0x3,
+    NumCh = 2,
+
+    SamplesPerFrame = 20,
+    SamplesPerPacket = 100,
+    FramesPerPacket = SamplesPerPacket / SamplesPerFrame,
+
+    SourcePackets = 20,
+    RepairPackets = 2,
+
+    NumBlocks = 3
+};
+
+const core::nanoseconds_t MaxBufDuration =
+    MaxBufSize * core::Second / core::nanoseconds_t(SampleRate * NumCh);
+
+core::HeapAllocator allocator;
+core::BufferFactory<audio::sample_t> sample_buffer_factory(allocator, MaxBufSize, true);
+core::BufferFactory<uint8_t> byte_buffer_factory(allocator, MaxBufSize, true);
+packet::PacketFactory packet_factory(allocator, true);
+
+rtp::FormatMap format_map;
+
+// Receiver side of RTCP session, reports losses counted by receiver session.
+class ReceiverHooks : public rtcp::IReceiverHooks {
+public:
+    ReceiverHooks(ReceiverSession& session)
+        : session_(session) {
+    }
+
+    virtual void on_update_source(packet::source_t, const char*) {
+    }
+
+    virtual void on_remove_source(packet::source_t) {
+    }
+
+    virtual size_t on_get_num_sources() {
+        return 1;
+    }
+
+    virtual rtcp::ReceptionMetrics on_get_reception_metrics(size_t source_index) {
+        CHECK(source_index == 0);
+        return session_.get_reception_metrics();
+    }
+
+    virtual void on_add_sending_metrics(const rtcp::SendingMetrics&) {
+    }
+
+    virtual void on_add_link_metrics(const rtcp::LinkMetrics&) {
+    }
+
+private:
+    ReceiverSession& session_;
+};
+
+void write_frames(audio::IFrameWriter& writer, size_t n_frames) {
+    for (size_t nf = 0; nf < n_frames; nf++) {
+        core::Slice<audio::sample_t> samples = sample_buffer_factory.new_buffer();
+        CHECK(samples);
+        samples.reslice(0, SamplesPerFrame * NumCh);
+
+        for (size_t n = 0; n < samples.size(); n++) {
+            samples.data()[n] = 0.1f;
+        }
+
+        audio::Frame frame(samples.data(), samples.size());
+        writer.write(frame);
+    }
+}
+
+// Deliver n_packets audio packets to receiver session, dropping every n-th.
+void deliver_packets(ReceiverSession& session,
+                     const address::SocketAddr& src_addr,
+                     size_t n_packets,
+                     size_t drop_every) {
+    for (size_t np = 0; np < n_packets; np++) {
+        // first and last packets are never dropped, they define seqnum range
+        if (np % drop_every == 1) {
+            continue;
+        }
+
+        const packet::seqnum_t seqnum = packet::seqnum_t(np);
+
+        packet::PacketPtr pp = packet_factory.new_packet();
+        CHECK(pp);
+
+        pp->add_flags(packet::Packet::FlagUDP | packet::Packet::FlagRTP
+                      | packet::Packet::FlagAudio);
+
+        pp->udp()->src_addr = src_addr;
+
+        pp->rtp()->source = 555;
+        pp->rtp()->seqnum = seqnum;
+        pp->rtp()->timestamp = packet::timestamp_t(seqnum * SamplesPerPacket);
+        pp->rtp()->payload_type = PayloadType;
+
+        CHECK(session.handle(pp));
+    }
+}
+
+} // namespace
+
+TEST_GROUP(sender_session) {
+    SenderConfig sender_config;
+    ReceiverConfig receiver_config;
+
+    void setup() {
+        sender_config.input_sample_spec = audio::SampleSpec(SampleRate, ChMask);
+        sender_config.packet_length = SamplesPerPacket * core::Second / SampleRate;
+        sender_config.internal_frame_length = MaxBufDuration;
+
+        sender_config.payload_type = PayloadType;
+
+        sender_config.fec_encoder.scheme = packet::FEC_ReedSolomon_M8;
+        sender_config.fec_writer.n_source_packets = SourcePackets;
+        sender_config.fec_writer.n_repair_packets = RepairPackets;
+
+        sender_config.fec_redundancy.enabled = true;
+        sender_config.fec_redundancy.min_repair_packets = RepairPackets;
+        sender_config.fec_redundancy.max_repair_packets = SourcePackets;
+
+        sender_config.interleaving = false;
+        sender_config.timing = false;
+        sender_config.poisoning = true;
+
+        receiver_config.common.output_sample_spec = audio::SampleSpec(SampleRate, ChMask);
+        receiver_config.common.internal_frame_length = MaxBufDuration;
+
+        receiver_config.default_session.payload_type = PayloadType;
+    }
+
+    // Read repair packets of NumBlocks blocks and check their block length.
+    void check_repair_blocks(packet::Queue& repair_queue, size_t n_repair) {
+        for (size_t nb = 0; nb < NumBlocks; nb++) {
+            for (size_t np = 0; np < n_repair; np++) {
+                packet::PacketPtr pp = repair_queue.read();
+                CHECK(pp);
+                CHECK(pp->fec());
+
+                UNSIGNED_LONGS_EQUAL(SourcePackets, pp->fec()->source_block_length);
+                UNSIGNED_LONGS_EQUAL(SourcePackets + n_repair, pp->fec()->block_length);
+            }
+        }
+        CHECK(!repair_queue.read());
+    }
+};
+
+TEST(sender_session, fec_redundancy_from_reception_reports) {
+    if (!fec::CodecMap::instance().is_supported(packet::FEC_ReedSolomon_M8)) {
+        return;
+    }
+
+    packet::Queue source_queue, repair_queue, control_queue;
+
+    SenderEndpoint source_endpoint(address::Proto_RTP_RS8M_Source, packet_factory,
+                                   allocator);
+    SenderEndpoint repair_endpoint(address::Proto_RS8M_Repair, packet_factory,
+                                   allocator);
+    SenderEndpoint control_endpoint(address::Proto_RTCP, packet_factory, allocator);
+
+    CHECK(source_endpoint.valid());
+    CHECK(repair_endpoint.valid());
+    CHECK(control_endpoint.valid());
+
+    source_endpoint.set_destination_writer(source_queue);
+    repair_endpoint.set_destination_writer(repair_queue);
+    control_endpoint.set_destination_writer(control_queue);
+
+    SenderSession sender_session(sender_config, format_map, packet_factory,
+                                 byte_buffer_factory, sample_buffer_factory, allocator);
+
+    CHECK(sender_session.create_transport_pipeline(&source_endpoint, &repair_endpoint));
+    CHECK(sender_session.create_control_pipeline(&control_endpoint));
+    CHECK(sender_session.writer());
+
+    const address::SocketAddr src_addr = test::new_address(123);
+
+    core::SharedPtr<ReceiverSession> receiver_session = new (allocator)
+        ReceiverSession(receiver_config.default_session, receiver_config.common,
+                        src_addr, format_map, packet_factory, byte_buffer_factory,
+                        sample_buffer_factory, allocator);
+    CHECK(receiver_session);
+    CHECK(receiver_session->valid());
+
+    ReceiverHooks receiver_hooks(*receiver_session);
+
+    rtcp::Composer receiver_composer;
+    packet::Queue receiver_control_queue;
+
+    rtcp::Session receiver_rtcp(&receiver_hooks, NULL, &receiver_control_queue,
+                                receiver_composer, packet_factory,
+                                byte_buffer_factory);
+    CHECK(receiver_rtcp.valid());
+
+    // no losses, redundancy stays at minimum
+    write_frames(*sender_session.writer(),
+                 SourcePackets * FramesPerPacket * NumBlocks);
+    check_repair_blocks(repair_queue, RepairPackets);
+
+    // receiver loses every 4th packet and reports it
+    deliver_packets(*receiver_session, src_addr, SourcePackets * 4, 4);
+
+    receiver_rtcp.generate_packets();
+
+    packet::PacketPtr report = receiver_control_queue.read();
+    CHECK(report);
+    CHECK(report->rtcp());
+    CHECK(!receiver_control_queue.read());
+
+    {
+        rtcp::Traverser traverser(report->rtcp()->data);
+        CHECK(traverser.parse());
+
+        rtcp::Traverser::Iterator iter = traverser.iter();
+        CHECK(iter.next() == rtcp::Traverser::Iterator::RR);
+        CHECK(iter.get_rr().num_blocks() == 1);
+
+        const rtcp::header::ReceptionReportBlock& blk = iter.get_rr().get_block(0);
+        UNSIGNED_LONGS_EQUAL(555, blk.ssrc());
+        DOUBLES_EQUAL(0.25, blk.fract_loss(), 1. / 256);
+        LONGS_EQUAL(SourcePackets, blk.cumloss());
+        UNSIGNED_LONGS_EQUAL(SourcePackets * 4 - 1, blk.last_seqnum());
+    }
+
+    // deliver report to control endpoint as network would do it
+    {
+        packet::PacketPtr pp = packet_factory.new_packet();
+        CHECK(pp);
+
+        pp->add_flags(packet::Packet::FlagUDP);
+        pp->udp()->src_addr = src_addr;
+        pp->set_data(report->data());
+
+        control_endpoint.inbound_writer().write(pp);
+    }
+
+    sender_session.update();
+
+    // redundancy is increased starting from next block
+    size_t n_repair = 0;
+    {
+        write_frames(*sender_session.writer(), SourcePackets * FramesPerPacket);
+
+        packet::PacketPtr pp = repair_queue.read();
+        CHECK(pp);
+        CHECK(pp->fec());
+
+        n_repair = pp->fec()->block_length - pp->fec()->source_block_length;
+        CHECK(n_repair > RepairPackets);
+
+        for (size_t np = 1; np < n_repair; np++) {
+            CHECK(repair_queue.read());
+        }
+        CHECK(!repair_queue.read());
+    }
+
+    write_frames(*sender_session.writer(),
+                 SourcePackets * FramesPerPacket * NumBlocks);
+    check_repair_blocks(repair_queue, n_repair);
+}
+
+TEST(sender_session, fec_async_flush) {
+    if (!fec::CodecMap::instance().is_supported(packet::FEC_ReedSolomon_M8)) {
+        return;
+    }
+
+    sender_config.fec_redundancy.enabled = false;
+    sender_config.fec_writer.async_encoding = true;
+
+    packet::Queue source_queue, repair_queue;
+
+    SenderEndpoint source_endpoint(address::Proto_RTP_RS8M_Source, packet_factory,
+                                   allocator);
+    SenderEndpoint repair_endpoint(address::Proto_RS8M_Repair, packet_factory,
+                                   allocator);
+
+    source_endpoint.set_destination_writer(source_queue);
+    repair_endpoint.set_destination_writer(repair_queue);
+
+    SenderSession sender_session(sender_config, format_map, packet_factory,
+                                 byte_buffer_factory, sample_buffer_factory, allocator);
+
+    CHECK(sender_session.create_transport_pipeline(&source_endpoint, &repair_endpoint));
+
+    write_frames(*sender_session.writer(),
+                 SourcePackets * FramesPerPacket * NumBlocks);
+
+    // source packets are written immediately
+    UNSIGNED_LONGS_EQUAL(SourcePackets * NumBlocks, source_queue.size());
+
+    // repair packets of all blocks are written when stream stops
+    sender_session.flush();
+
+    check_repair_blocks(repair_queue, RepairPackets);
+}
+
+TEST(sender_session, fec_async_update) {
+    enum { MaxWaitMs = 10000 };
+
+    if (!fec::CodecMap::instance().is_supported(packet::FEC_ReedSolomon_M8)) {
+        return;
+    }
+
+    sender_config.fec_redundancy.enabled = false;
+    sender_config.fec_writer.async_encoding = true;
+
+    packet::Queue source_queue, repair_queue;
+
+    SenderEndpoint source_endpoint(address::Proto_RTP_RS8M_Source, packet_factory,
+                                   allocator);
+    SenderEndpoint repair_endpoint(address::Proto_RS8M_Repair, packet_factory,
+                                   allocator);
+
+    source_endpoint.set_destination_writer(source_queue);
+    repair_endpoint.set_destination_writer(repair_queue);
+
+    SenderSession sender_session(sender_config, format_map, packet_factory,
+                                 byte_buffer_factory, sample_buffer_factory, allocator);
+
+    CHECK(sender_session.create_transport_pipeline(&source_endpoint, &repair_endpoint));
+
+    CHECK(sender_session.get_update_deadline() == 0);
+
+    write_frames(*sender_session.writer(),
+                 SourcePackets * FramesPerPacket * NumBlocks);
+
+    // repair packets are written by update() without further writes
+    for (size_t n_wait = 0; repair_queue.size() < RepairPackets * NumBlocks;
+         n_wait++) {
+        CHECK(n_wait < MaxWaitMs);
+
+        // pending blocks request update as soon as possible
+        CHECK(sender_session.get_update_deadline() != 0);
+        CHECK(sender_session.get_update_deadline()
+              <= core::timestamp(core::ClockMonotonic));
+
+        sender_session.update();
+        core::sleep_for(core::ClockMonotonic, core::Millisecond);
+    }
+
+    CHECK(sender_session.get_update_deadline() == 0);
+
+    check_repair_blocks(repair_queue, RepairPackets);
+}
+
+} // namespace pipeline
+} // namespace roc
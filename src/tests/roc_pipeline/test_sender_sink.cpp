@@ -190,5 +190,79 @@ TEST(sender_sink, frame_size_large) {
     CHECK(!queue.read());
 }
 
+TEST(sender_sink, shared_encoding) {
+    enum { NumSlots = 3 };
+
+    config.shared_encoding = true;
+
+    packet::Queue queues[NumSlots];
+    address::SocketAddr dst_addrs[NumSlots];
+
+    SenderSink sender(config, format_map, packet_factory, byte_buffer_factory,
+                      sample_buffer_factory, allocator);
+    CHECK(sender.valid());
+
+    for (size_t ns = 0; ns < NumSlots; ns++) {
+        dst_addrs[ns] = test::new_address(123 + (int)ns);
+
+        SenderSlot* slot = sender.create_slot();
+        CHECK(slot);
+
+        SenderEndpoint* source_endpoint =
+            slot->create_endpoint(address::Iface_AudioSource, source_proto);
+        CHECK(source_endpoint);
+
+        source_endpoint->set_destination_writer(queues[ns]);
+        source_endpoint->set_destination_address(dst_addrs[ns]);
+
+        CHECK(slot->is_ready());
+    }
+
+    test::FrameWriter frame_writer(sender, sample_buffer_factory);
+
+    for (size_t nf = 0; nf < ManyFrames; nf++) {
+        frame_writer.write_samples(SamplesPerFrame * NumCh);
+    }
+
+    packet::Queue checked_queues[NumSlots];
+
+    for (size_t np = 0; np < ManyFrames / FramesPerPacket; np++) {
+        packet::PacketPtr first_pp;
+
+        for (size_t ns = 0; ns < NumSlots; ns++) {
+            packet::PacketPtr pp = queues[ns].read();
+            CHECK(pp);
+
+            CHECK(pp->udp());
+            CHECK(pp->udp()->dst_addr == dst_addrs[ns]);
+
+            if (!first_pp) {
+                first_pp = pp;
+            } else {
+                // each destination gets its own packet, sharing the same buffer
+                CHECK(pp != first_pp);
+                POINTERS_EQUAL(first_pp->data().data(), pp->data().data());
+                LONGS_EQUAL(first_pp->data().size(), pp->data().size());
+            }
+
+            checked_queues[ns].write(pp);
+        }
+    }
+
+    for (size_t ns = 0; ns < NumSlots; ns++) {
+        CHECK(!queues[ns].read());
+
+        test::PacketReader packet_reader(allocator, checked_queues[ns], rtp_parser,
+                                         format_map, packet_factory, PayloadType,
+                                         dst_addrs[ns]);
+
+        for (size_t np = 0; np < ManyFrames / FramesPerPacket; np++) {
+            packet_reader.read_packet(SamplesPerPacket, SampleSpecs);
+        }
+
+        CHECK(!checked_queues[ns].read());
+    }
+}
+
 } // namespace pipeline
 } // namespace roc
@@ -71,7 +71,10 @@ enum {
     FlagReedSolomon = (1 << 4),
 
     // enable LDPC-Staircase FEC scheme on sender
-    FlagLDPC = (1 << 5)
+    FlagLDPC = (1 << 5),
+
+    // enable incremental FEC decoding on receiver
+    FlagIncremental = (1 << 6)
 };
 
 core::HeapAllocator allocator;
@@ -106,7 +109,7 @@ SenderConfig sender_config(int flags) {
     return config;
 }
 
-ReceiverConfig receiver_config() {
+ReceiverConfig receiver_config(int flags) {
     ReceiverConfig config;
 
     config.common.output_sample_spec = audio::SampleSpec(SampleRate, ChMask);
@@ -120,6 +123,8 @@ ReceiverConfig receiver_config() {
     config.default_session.watchdog.no_playback_timeout =
         Timeout * core::Second / SampleRate;
 
+    config.default_session.fec_reader.incremental_decoding = (flags & FlagIncremental);
+
     return config;
 }
 
@@ -211,7 +216,7 @@ void send_receive(int flags, size_t num_sessions) {
         sender_repair_endpoint->set_destination_address(receiver_repair_addr);
     }
 
-    ReceiverSource receiver(receiver_config(), format_map, packet_factory,
+    ReceiverSource receiver(receiver_config(flags), format_map, packet_factory,
                             byte_buffer_factory, sample_buffer_factory, allocator);
 
     CHECK(receiver.valid());
@@ -299,6 +304,15 @@ TEST(sender_sink_receiver_source, fec_loss) {
     }
 }
 
+TEST(sender_sink_receiver_source, fec_incremental_loss) {
+    if (is_fec_supported(FlagReedSolomon)) {
+        send_receive(FlagReedSolomon | FlagLosses | FlagIncremental, 1);
+    }
+    if (is_fec_supported(FlagLDPC)) {
+        send_receive(FlagLDPC | FlagLosses | FlagIncremental, 1);
+    }
+}
+
 TEST(sender_sink_receiver_source, fec_drop_source) {
     if (is_fec_supported(FlagReedSolomon)) {
         send_receive(FlagReedSolomon | FlagDropSource, 0);
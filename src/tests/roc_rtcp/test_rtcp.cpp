@@ -41,6 +41,37 @@ core::Slice<uint8_t> new_buffer(const uint8_t* data, size_t datasz) {
 
 TEST_GROUP(rtcp) {};
 
+TEST(rtcp, reception_block_losses) {
+    header::ReceptionReportBlock blk;
+
+    blk.set_fract_loss(1, 8);
+    blk.set_cumloss(12);
+    DOUBLES_EQUAL(0.125, blk.fract_loss(), 1e-8);
+    CHECK_EQUAL(12, blk.cumloss());
+
+    blk.set_fract_loss(2, 32);
+    DOUBLES_EQUAL(0.0625, blk.fract_loss(), 1e-8);
+    CHECK_EQUAL(12, blk.cumloss());
+
+    blk.set_fract_loss(10, 10);
+    DOUBLES_EQUAL(255. / 256., blk.fract_loss(), 1e-8);
+    CHECK_EQUAL(12, blk.cumloss());
+
+    blk.set_cumloss(-5);
+    CHECK_EQUAL(-5, blk.cumloss());
+    DOUBLES_EQUAL(255. / 256., blk.fract_loss(), 1e-8);
+
+    blk.set_cumloss(1 << 24);
+    CHECK_EQUAL(0x7FFFFF, blk.cumloss());
+
+    blk.set_cumloss(-(1 << 24));
+    CHECK_EQUAL(-0x800000, blk.cumloss());
+
+    blk.set_fract_loss(0, 10);
+    DOUBLES_EQUAL(0, blk.fract_loss(), 1e-8);
+    CHECK_EQUAL(-0x800000, blk.cumloss());
+}
+
 TEST(rtcp, loopback_sr_sdes) {
     core::Slice<uint8_t> buff = new_buffer(NULL, 0).subslice(0, 0);
     Builder builder(buff);
@@ -14,6 +14,7 @@
 #include "roc_core/parse_duration.h"
 #include "roc_core/scoped_ptr.h"
 #include "roc_pipeline/converter_sink.h"
+#include "roc_pipeline/parallel_converter.h"
 #include "roc_sndio/backend_dispatcher.h"
 #include "roc_sndio/backend_map.h"
 #include "roc_sndio/print_supported.h"
@@ -171,6 +172,27 @@ int main(int argc, char** argv) {
         break;
     }
 
+    pipeline::ParallelConverterConfig parallel_config;
+
+    if (args.workers_given) {
+        if (args.workers_arg < 0) {
+            roc_log(LogError, "invalid --workers: should be >= 0");
+            return 1;
+        }
+        parallel_config.num_workers = (size_t)args.workers_arg;
+    }
+
+    if (args.chunk_length_given) {
+        if (!core::parse_duration(args.chunk_length_arg, parallel_config.chunk_length)) {
+            roc_log(LogError, "invalid --chunk-length: bad format");
+            return 1;
+        }
+        if (parallel_config.chunk_length <= 0) {
+            roc_log(LogError, "invalid --chunk-length: should be > 0");
+            return 1;
+        }
+    }
+
     converter_config.resampling = !args.no_resampling_flag;
     converter_config.poisoning = args.poisoning_flag;
     converter_config.profiling = args.profiling_flag;
@@ -217,14 +239,36 @@ int main(int argc, char** argv) {
         output_writer = output_sink.get();
     }
 
-    pipeline::ConverterSink converter(converter_config, output_writer, buffer_factory,
-                                      allocator);
-    if (!converter.valid()) {
-        roc_log(LogError, "can't create converter pipeline");
-        return 1;
+    core::ScopedPtr<pipeline::ParallelConverter> parallel_converter;
+    if (parallel_config.num_workers != 0) {
+        parallel_converter.reset(new (allocator) pipeline::ParallelConverter(
+                                     converter_config, parallel_config, output_writer,
+                                     buffer_factory, allocator),
+                                 allocator);
+        if (!parallel_converter || !parallel_converter->valid()) {
+            roc_log(LogInfo,
+                    "can't create parallel converter pipeline,"
+                    " falling back to sequential conversion");
+            parallel_converter.reset();
+        }
+    }
+
+    core::ScopedPtr<pipeline::ConverterSink> converter;
+    if (!parallel_converter) {
+        converter.reset(new (allocator) pipeline::ConverterSink(
+                            converter_config, output_writer, buffer_factory, allocator),
+                        allocator);
+        if (!converter || !converter->valid()) {
+            roc_log(LogError, "can't create converter pipeline");
+            return 1;
+        }
     }
 
-    sndio::Pump pump(buffer_factory, *input_source, NULL, converter,
+    sndio::ISink* converter_sink = parallel_converter
+        ? static_cast<sndio::ISink*>(parallel_converter.get())
+        : static_cast<sndio::ISink*>(converter.get());
+
+    sndio::Pump pump(buffer_factory, *input_source, NULL, *converter_sink,
                      converter_config.internal_frame_length,
                      converter_config.input_sample_spec, sndio::Pump::ModePermanent);
     if (!pump.valid()) {
@@ -232,7 +276,11 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    const bool ok = pump.run();
+    bool ok = pump.run();
+
+    if (parallel_converter) {
+        ok = parallel_converter->flush() && ok;
+    }
 
     return ok ? 0 : 1;
 }
@@ -154,6 +154,70 @@ int main(int argc, char** argv) {
             * pipeline::DefaultMaxLatencyFactor;
     }
 
+    if (args.adapt_latency_flag) {
+        receiver_config.default_session.latency_monitor.adaptive_latency = true;
+    }
+
+    if (args.adapt_min_latency_given) {
+        if (!core::parse_duration(
+                args.adapt_min_latency_arg,
+                receiver_config.default_session.latency_monitor.min_target_latency)) {
+            roc_log(LogError, "invalid --adapt-min-latency");
+            return 1;
+        }
+    }
+
+    if (args.adapt_max_latency_given) {
+        if (!core::parse_duration(
+                args.adapt_max_latency_arg,
+                receiver_config.default_session.latency_monitor.max_target_latency)) {
+            roc_log(LogError, "invalid --adapt-max-latency");
+            return 1;
+        }
+    }
+
+    if (args.fast_start_given) {
+        if (!core::parse_duration(
+                args.fast_start_arg,
+                receiver_config.default_session.latency_monitor.start_latency)) {
+            roc_log(LogError, "invalid --fast-start");
+            return 1;
+        }
+        if (receiver_config.default_session.latency_monitor.start_latency <= 0
+            || receiver_config.default_session.latency_monitor.start_latency
+                > receiver_config.default_session.target_latency) {
+            roc_log(LogError,
+                    "invalid --fast-start: should be > 0 and <= --sess-latency");
+            return 1;
+        }
+    }
+
+    if (args.fast_start_ramp_given) {
+        if (!core::parse_duration(
+                args.fast_start_ramp_arg,
+                receiver_config.default_session.latency_monitor.start_ramp)) {
+            roc_log(LogError, "invalid --fast-start-ramp");
+            return 1;
+        }
+    }
+
+    if (args.fec_interleaving_latency_given) {
+        if (!core::parse_duration(
+                args.fec_interleaving_latency_arg,
+                receiver_config.default_session.fec_interleaving_latency)) {
+            roc_log(LogError, "invalid --fec-interleaving-latency");
+            return 1;
+        }
+        if (receiver_config.default_session.fec_interleaving_latency <= 0
+            || receiver_config.default_session.fec_interleaving_latency
+                >= receiver_config.default_session.target_latency) {
+            roc_log(LogError,
+                    "invalid --fec-interleaving-latency:"
+                    " should be > 0 and < --sess-latency");
+            return 1;
+        }
+    }
+
     if (args.np_timeout_given) {
         if (!core::parse_duration(
                 args.np_timeout_arg,
@@ -183,6 +247,16 @@ int main(int argc, char** argv) {
 
     receiver_config.common.resampling = !args.no_resampling_flag;
 
+    if (args.adapt_latency_flag && args.no_resampling_flag) {
+        roc_log(LogError, "--adapt-latency can't be used with --no-resampling");
+        return 1;
+    }
+
+    if (args.fast_start_given && args.no_resampling_flag) {
+        roc_log(LogError, "--fast-start can't be used with --no-resampling");
+        return 1;
+    }
+
     switch (args.resampler_backend_arg) {
     case resampler_backend_arg_default:
         receiver_config.default_session.resampler_backend =
@@ -217,10 +291,33 @@ int main(int argc, char** argv) {
         break;
     }
 
+    receiver_config.default_session.fec_reader.incremental_decoding =
+        args.fec_incremental_flag;
+
     receiver_config.common.poisoning = args.poisoning_flag;
     receiver_config.common.profiling = args.profiling_flag;
     receiver_config.common.beeping = args.beeping_flag;
 
+    if (args.sess_workers_given) {
+        if (args.sess_workers_arg < 0) {
+            roc_log(LogError, "invalid --sess-workers: should be >= 0");
+            return 1;
+        }
+        receiver_config.common.session_workers = (size_t)args.sess_workers_arg;
+    }
+
+    if (args.sess_prewarm_given) {
+        if (args.sess_prewarm_arg < 0) {
+            roc_log(LogError, "invalid --sess-prewarm: should be >= 0");
+            return 1;
+        }
+        receiver_config.common.prewarmed_sessions = (size_t)args.sess_prewarm_arg;
+    }
+
+    if (args.packet_trace_given) {
+        receiver_config.common.packet_trace_path = args.packet_trace_arg;
+    }
+
     sndio::Config io_config;
     io_config.frame_length = receiver_config.common.internal_frame_length;
     io_config.sample_spec.set_channel_mask(
@@ -394,6 +491,24 @@ int main(int argc, char** argv) {
         return 1;
     }
 
+    core::nanoseconds_t busy_poll_spin =
+        netio::UdpReceiverConfig().busy_polling_spin_duration;
+    core::nanoseconds_t so_busy_poll = 0;
+
+    if (args.busy_poll_spin_given) {
+        if (!core::parse_duration(args.busy_poll_spin_arg, busy_poll_spin)) {
+            roc_log(LogError, "invalid --busy-poll-spin");
+            return 1;
+        }
+    }
+
+    if (args.so_busy_poll_given) {
+        if (!core::parse_duration(args.so_busy_poll_arg, so_busy_poll)) {
+            roc_log(LogError, "invalid --so-busy-poll");
+            return 1;
+        }
+    }
+
     for (size_t slot = 0; slot < (size_t)args.source_given; slot++) {
         address::EndpointUri endpoint(context.allocator());
 
@@ -419,6 +534,14 @@ int main(int argc, char** argv) {
             }
         }
 
+        if (args.busy_poll_given) {
+            if (!receiver.set_busy_polling(slot, address::Iface_AudioSource,
+                                           busy_poll_spin, so_busy_poll)) {
+                roc_log(LogError, "can't enable busy polling for --source endpoint");
+                return 1;
+            }
+        }
+
         if (!receiver.bind(slot, address::Iface_AudioSource, endpoint)) {
             roc_log(LogError, "can't bind --source endpoint: %s", args.source_arg[slot]);
             return 1;
@@ -450,6 +573,14 @@ int main(int argc, char** argv) {
             }
         }
 
+        if (args.busy_poll_given) {
+            if (!receiver.set_busy_polling(slot, address::Iface_AudioRepair,
+                                           busy_poll_spin, so_busy_poll)) {
+                roc_log(LogError, "can't enable busy polling for --repair endpoint");
+                return 1;
+            }
+        }
+
         if (!receiver.bind(slot, address::Iface_AudioRepair, endpoint)) {
             roc_log(LogError, "can't bind --repair port: %s", args.repair_arg[slot]);
             return 1;
@@ -482,6 +613,14 @@ int main(int argc, char** argv) {
             }
         }
 
+        if (args.busy_poll_given) {
+            if (!receiver.set_busy_polling(slot, address::Iface_AudioControl,
+                                           busy_poll_spin, so_busy_poll)) {
+                roc_log(LogError, "can't enable busy polling for --control endpoint");
+                return 1;
+            }
+        }
+
         if (!receiver.bind(slot, address::Iface_AudioControl, endpoint)) {
             roc_log(LogError, "can't bind --control endpoint: %s",
                     args.control_arg[slot]);
@@ -501,5 +640,27 @@ int main(int argc, char** argv) {
 
     const bool ok = pump.run();
 
+    if (args.busy_poll_given) {
+        for (size_t slot = 0; slot < (size_t)args.source_given; slot++) {
+            pipeline::ReceiverMetrics recv_metrics;
+            peer::ReceiverPortMetrics port_metrics;
+            size_t sess_metrics_size = 0;
+
+            if (!receiver.get_metrics(slot, recv_metrics, port_metrics, NULL,
+                                      &sess_metrics_size, NULL)) {
+                continue;
+            }
+
+            roc_log(LogInfo,
+                    "busy polling of slot %lu: packets=%lu spinning=%lu parked=%lu"
+                    " spin_delay=%.3fms parked_delay=%.3fms",
+                    (unsigned long)slot, (unsigned long)port_metrics.busy_poll_packets,
+                    (unsigned long)port_metrics.busy_poll_spin_packets,
+                    (unsigned long)port_metrics.busy_poll_parked_packets,
+                    (double)port_metrics.busy_poll_spin_delay / core::Millisecond,
+                    (double)port_metrics.busy_poll_parked_delay / core::Millisecond);
+        }
+    }
+
     return ok ? 0 : 1;
 }
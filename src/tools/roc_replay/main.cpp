@@ -0,0 +1,414 @@
+/*
+ * Copyright (c) 2023 Roc Streaming authors
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <string.h>
+
+#include "roc_address/endpoint_uri.h"
+#include "roc_address/io_uri.h"
+#include "roc_audio/resampler_profile.h"
+#include "roc_core/buffer_factory.h"
+#include "roc_core/crash_handler.h"
+#include "roc_core/heap_allocator.h"
+#include "roc_core/log.h"
+#include "roc_core/parse_duration.h"
+#include "roc_core/scoped_ptr.h"
+#include "roc_core/time.h"
+#include "roc_packet/packet_factory.h"
+#include "roc_packet/trace_reader.h"
+#include "roc_pipeline/receiver_source.h"
+#include "roc_rtp/format_map.h"
+#include "roc_sndio/backend_dispatcher.h"
+#include "roc_sndio/backend_map.h"
+#include "roc_sndio/print_supported.h"
+
+#include "roc_replay/cmdline.h"
+
+using namespace roc;
+
+namespace {
+
+enum { MaxPacketSize = 2048, MaxFrameSize = 4096 };
+
+bool create_endpoint(pipeline::ReceiverSlot& slot,
+                     address::Interface iface,
+                     const char* uri_str,
+                     const char* option,
+                     core::IAllocator& allocator,
+                     pipeline::ReceiverEndpoint*& endpoint) {
+    address::EndpointUri uri(allocator);
+
+    if (!address::parse_endpoint_uri(uri_str, address::EndpointUri::Subset_Full, uri)) {
+        roc_log(LogError, "can't parse --%s endpoint: %s", option, uri_str);
+        return false;
+    }
+
+    endpoint = slot.create_endpoint(iface, uri.proto());
+    if (!endpoint) {
+        roc_log(LogError, "can't create --%s endpoint: %s", option, uri_str);
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    core::HeapAllocator::enable_panic_on_leak();
+
+    core::CrashHandler crash_handler;
+
+    gengetopt_args_info args;
+
+    const int code = cmdline_parser(argc, argv, &args);
+    if (code != 0) {
+        return code;
+    }
+
+    core::ScopedPtr<gengetopt_args_info, core::CustomAllocation> args_holder(
+        &args, &cmdline_parser_free);
+
+    core::Logger::instance().set_verbosity(args.verbose_given);
+
+    switch (args.color_arg) {
+    case color_arg_auto:
+        core::Logger::instance().set_colors(core::ColorsAuto);
+        break;
+
+    case color_arg_always:
+        core::Logger::instance().set_colors(core::ColorsEnabled);
+        break;
+
+    case color_arg_never:
+        core::Logger::instance().set_colors(core::ColorsDisabled);
+        break;
+
+    default:
+        break;
+    }
+
+    core::HeapAllocator allocator;
+    sndio::BackendDispatcher backend_dispatcher;
+
+    if (args.list_supported_given) {
+        if (!sndio::print_supported(backend_dispatcher, allocator)) {
+            return 1;
+        }
+        return 0;
+    }
+
+    if (!args.source_given) {
+        roc_log(LogError, "--source endpoint should be specified");
+        return 1;
+    }
+
+    pipeline::ReceiverConfig receiver_config;
+
+    if (args.frame_length_given) {
+        if (!core::parse_duration(args.frame_length_arg,
+                                  receiver_config.common.internal_frame_length)) {
+            roc_log(LogError, "invalid --frame-length: bad format");
+            return 1;
+        }
+        if (receiver_config.common.output_sample_spec.ns_2_samples_overall(
+                receiver_config.common.internal_frame_length)
+            <= 0) {
+            roc_log(LogError, "invalid --frame-length: should be > 0");
+            return 1;
+        }
+    }
+
+    sndio::BackendMap::instance().set_frame_size(
+        receiver_config.common.internal_frame_length,
+        receiver_config.common.output_sample_spec);
+
+    if (args.sess_latency_given) {
+        if (!core::parse_duration(args.sess_latency_arg,
+                                  receiver_config.default_session.target_latency)) {
+            roc_log(LogError, "invalid --sess-latency");
+            return 1;
+        }
+    }
+
+    if (args.min_latency_given) {
+        if (!core::parse_duration(
+                args.min_latency_arg,
+                receiver_config.default_session.latency_monitor.min_latency)) {
+            roc_log(LogError, "invalid --min-latency");
+            return 1;
+        }
+    } else {
+        receiver_config.default_session.latency_monitor.min_latency =
+            receiver_config.default_session.target_latency
+            * pipeline::DefaultMinLatencyFactor;
+    }
+
+    if (args.max_latency_given) {
+        if (!core::parse_duration(
+                args.max_latency_arg,
+                receiver_config.default_session.latency_monitor.max_latency)) {
+            roc_log(LogError, "invalid --max-latency");
+            return 1;
+        }
+    } else {
+        receiver_config.default_session.latency_monitor.max_latency =
+            receiver_config.default_session.target_latency
+            * pipeline::DefaultMaxLatencyFactor;
+    }
+
+    receiver_config.common.resampling = !args.no_resampling_flag;
+
+    switch (args.resampler_backend_arg) {
+    case resampler_backend_arg_default:
+        receiver_config.default_session.resampler_backend =
+            audio::ResamplerBackend_Default;
+        break;
+    case resampler_backend_arg_builtin:
+        receiver_config.default_session.resampler_backend =
+            audio::ResamplerBackend_Builtin;
+        break;
+    case resampler_backend_arg_speex:
+        receiver_config.default_session.resampler_backend = audio::ResamplerBackend_Speex;
+        break;
+    default:
+        break;
+    }
+
+    switch (args.resampler_profile_arg) {
+    case resampler_profile_arg_low:
+        receiver_config.default_session.resampler_profile = audio::ResamplerProfile_Low;
+        break;
+
+    case resampler_profile_arg_medium:
+        receiver_config.default_session.resampler_profile =
+            audio::ResamplerProfile_Medium;
+        break;
+
+    case resampler_profile_arg_high:
+        receiver_config.default_session.resampler_profile = audio::ResamplerProfile_High;
+        break;
+
+    default:
+        break;
+    }
+
+    receiver_config.common.poisoning = args.poisoning_flag;
+
+    // Packets are delivered to the pipeline by this tool, so the pipeline
+    // itself should never wait for the clock.
+    receiver_config.common.timing = false;
+
+    if (args.rate_given) {
+        if (args.rate_arg <= 0) {
+            roc_log(LogError, "invalid --rate: should be > 0");
+            return 1;
+        }
+        receiver_config.common.output_sample_spec.set_sample_rate(
+            (size_t)args.rate_arg);
+    }
+
+    sndio::Config io_config;
+    io_config.frame_length = receiver_config.common.internal_frame_length;
+    io_config.sample_spec = receiver_config.common.output_sample_spec;
+
+    address::IoUri output_uri(allocator);
+    if (args.output_given) {
+        if (!address::parse_io_uri(args.output_arg, output_uri)) {
+            roc_log(LogError, "invalid --output file or device URI");
+            return 1;
+        }
+    }
+
+    if (!args.output_format_given && output_uri.is_special_file()) {
+        roc_log(LogError, "--output-format should be specified if --output is \"-\"");
+        return 1;
+    }
+
+    core::ScopedPtr<sndio::ISink> output_sink;
+    if (args.output_given) {
+        output_sink.reset(backend_dispatcher.open_sink(output_uri, args.output_format_arg,
+                                                       io_config, allocator),
+                          allocator);
+        if (!output_sink) {
+            roc_log(LogError, "can't open output file or device: uri=%s format=%s",
+                    args.output_arg, args.output_format_arg);
+            return 1;
+        }
+        if (output_sink->has_clock() && args.fast_flag) {
+            roc_log(LogError, "--fast can't be used with output device that has clock");
+            return 1;
+        }
+        receiver_config.common.output_sample_spec.set_sample_rate(
+            output_sink->sample_spec().sample_rate());
+    }
+
+    packet::TraceReader trace_reader;
+    if (!trace_reader.open(args.input_arg)) {
+        roc_log(LogError, "can't open --input trace: %s", args.input_arg);
+        return 1;
+    }
+
+    rtp::FormatMap format_map;
+    packet::PacketFactory packet_factory(allocator, args.poisoning_flag);
+    core::BufferFactory<uint8_t> byte_buffer_factory(allocator, MaxPacketSize,
+                                                     args.poisoning_flag);
+    core::BufferFactory<audio::sample_t> sample_buffer_factory(
+        allocator, MaxFrameSize / sizeof(audio::sample_t), args.poisoning_flag);
+
+    pipeline::ReceiverSource receiver(receiver_config, format_map, packet_factory,
+                                      byte_buffer_factory, sample_buffer_factory,
+                                      allocator);
+    if (!receiver.valid()) {
+        roc_log(LogError, "can't create receiver pipeline");
+        return 1;
+    }
+
+    pipeline::ReceiverSlot* slot = receiver.create_slot();
+    if (!slot) {
+        roc_log(LogError, "can't create receiver slot");
+        return 1;
+    }
+
+    pipeline::ReceiverEndpoint* endpoints[address::Iface_Max];
+    memset(endpoints, 0, sizeof(endpoints));
+
+    if (!create_endpoint(*slot, address::Iface_AudioSource, args.source_arg, "source",
+                         allocator, endpoints[address::Iface_AudioSource])) {
+        return 1;
+    }
+    if (args.repair_given
+        && !create_endpoint(*slot, address::Iface_AudioRepair, args.repair_arg,
+                            "repair", allocator, endpoints[address::Iface_AudioRepair])) {
+        return 1;
+    }
+    if (args.control_given
+        && !create_endpoint(*slot, address::Iface_AudioControl, args.control_arg,
+                            "control", allocator,
+                            endpoints[address::Iface_AudioControl])) {
+        return 1;
+    }
+
+    core::Slice<audio::sample_t> frame_buf = sample_buffer_factory.new_buffer();
+    if (!frame_buf) {
+        roc_log(LogError, "can't allocate frame buffer");
+        return 1;
+    }
+    frame_buf.reslice(0,
+                      receiver_config.common.output_sample_spec.ns_2_samples_overall(
+                          receiver_config.common.internal_frame_length));
+
+    const core::nanoseconds_t frame_length = receiver_config.common.internal_frame_length;
+
+    // When there are no more packets, continue reading frames for this
+    // duration to play out audio buffered in sessions.
+    const core::nanoseconds_t drain_length =
+        receiver_config.default_session.latency_monitor.max_latency + frame_length;
+
+    // Pacing is needed only if there is no output device that paces us.
+    const bool paced = !args.fast_flag && !(output_sink && output_sink->has_clock());
+
+    const core::nanoseconds_t start_time = core::timestamp(core::ClockMonotonic);
+    const core::nanoseconds_t unix_start_time = core::timestamp(core::ClockUnix);
+
+    packet::TraceRecord record;
+    bool has_record = trace_reader.read(record);
+
+    const core::nanoseconds_t first_timestamp = has_record ? record.timestamp : 0;
+
+    core::nanoseconds_t replay_pos = 0;
+    core::nanoseconds_t drain_pos = 0;
+
+    size_t n_packets = 0;
+    size_t n_skipped = 0;
+    size_t n_frames = 0;
+    size_t max_sessions = 0;
+
+    bool ok = true;
+
+    roc_log(LogInfo, "replaying %s: mode=%s", args.input_arg, paced ? "paced" : "fast");
+
+    while (has_record || drain_pos < drain_length) {
+        replay_pos += frame_length;
+
+        // Deliver all packets received before the end of current frame.
+        while (has_record && record.timestamp - first_timestamp < replay_pos) {
+            pipeline::ReceiverEndpoint* endpoint = NULL;
+            if ((size_t)record.iface < address::Iface_Max) {
+                endpoint = endpoints[record.iface];
+            }
+
+            if (endpoint && record.size <= MaxPacketSize) {
+                core::Slice<uint8_t> buf = byte_buffer_factory.new_buffer();
+                packet::PacketPtr pp = packet_factory.new_packet();
+
+                if (!buf || !pp) {
+                    roc_log(LogError, "can't allocate packet");
+                    ok = false;
+                    break;
+                }
+
+                memcpy(buf.data(), record.data, record.size);
+                buf.reslice(0, record.size);
+
+                pp->add_flags(packet::Packet::FlagUDP);
+                pp->udp()->src_addr = record.src_addr;
+                pp->udp()->receive_timestamp =
+                    unix_start_time + (record.timestamp - first_timestamp);
+                pp->set_data(buf);
+
+                endpoint->writer().write(pp);
+                n_packets++;
+            } else {
+                n_skipped++;
+            }
+
+            has_record = trace_reader.read(record);
+        }
+
+        if (!ok) {
+            break;
+        }
+
+        if (paced) {
+            core::sleep_until(core::ClockMonotonic, start_time + replay_pos);
+        }
+
+        audio::Frame frame(frame_buf.data(), frame_buf.size());
+
+        if (!receiver.read(frame)) {
+            roc_log(LogError, "can't read frame from receiver pipeline");
+            ok = false;
+            break;
+        }
+
+        if (output_sink) {
+            output_sink->write(frame);
+        }
+
+        n_frames++;
+
+        if (max_sessions < receiver.num_sessions()) {
+            max_sessions = receiver.num_sessions();
+        }
+
+        if (!has_record) {
+            drain_pos += frame_length;
+        }
+    }
+
+    roc_log(LogInfo,
+            "replay finished: n_packets=%lu n_skipped=%lu n_frames=%lu max_sessions=%lu"
+            " trace_duration=%.3fms replay_duration=%.3fms",
+            (unsigned long)n_packets, (unsigned long)n_skipped, (unsigned long)n_frames,
+            (unsigned long)max_sessions,
+            (double)(replay_pos - drain_pos) / core::Millisecond,
+            (double)(core::timestamp(core::ClockMonotonic) - start_time)
+                / core::Millisecond);
+
+    return ok ? 0 : 1;
+}
@@ -16,6 +16,7 @@
 #include "roc_core/log.h"
 #include "roc_core/parse_duration.h"
 #include "roc_core/scoped_ptr.h"
+#include "roc_fec/block_interleaver.h"
 #include "roc_netio/network_loop.h"
 #include "roc_peer/context.h"
 #include "roc_peer/sender.h"
@@ -164,6 +165,33 @@ int main(int argc, char** argv) {
         sender_config.fec_writer.n_repair_packets = (size_t)args.nbrpr_arg;
     }
 
+    if (args.fec_async_given) {
+        if (sender_config.fec_encoder.scheme == packet::FEC_None) {
+            roc_log(LogError, "--fec-async can't be used when fec is disabled");
+            return 1;
+        }
+        sender_config.fec_writer.async_encoding = true;
+    }
+
+    if (args.fec_interleaving_given) {
+        if (sender_config.fec_encoder.scheme == packet::FEC_None) {
+            roc_log(LogError, "--fec-interleaving can't be used when fec is disabled");
+            return 1;
+        }
+        if (sender_config.fec_encoder.scheme == packet::FEC_RLC) {
+            roc_log(LogError, "--fec-interleaving can't be used with rlc");
+            return 1;
+        }
+        if (args.fec_interleaving_arg <= 0
+            || args.fec_interleaving_arg > fec::BlockInterleaver::MaxSpan) {
+            roc_log(LogError, "invalid --fec-interleaving: should be > 0 and <= %d",
+                    (int)fec::BlockInterleaver::MaxSpan);
+            return 1;
+        }
+        sender_config.fec_interleaver.enabled = true;
+        sender_config.fec_interleaver.span = (size_t)args.fec_interleaving_arg;
+    }
+
     sender_config.resampling = !args.no_resampling_flag;
 
     switch (args.resampler_backend_arg) {
@@ -198,6 +226,8 @@ int main(int argc, char** argv) {
     }
 
     sender_config.interleaving = args.interleaving_flag;
+    sender_config.pacing = args.pacing_flag;
+    sender_config.shared_encoding = args.encode_once_flag;
     sender_config.poisoning = args.poisoning_flag;
     sender_config.profiling = args.profiling_flag;
 
@@ -361,6 +391,17 @@ int main(int argc, char** argv) {
         }
     }
 
+    if (sender_config.fec_interleaver.enabled) {
+        pipeline::SenderMetrics send_metrics;
+        peer::SenderPortMetrics port_metrics;
+        sender.get_metrics(send_metrics, port_metrics);
+
+        roc_log(LogInfo,
+                "fec interleaving adds %.3fms of latency,"
+                " pass it to receiver via --fec-interleaving-latency",
+                (double)send_metrics.latency / core::Millisecond);
+    }
+
     sndio::Pump pump(context.sample_buffer_factory(), *input_source, NULL, sender.sink(),
                      sender_config.internal_frame_length, sender_config.input_sample_spec,
                      sndio::Pump::ModePermanent);